@@ -235,6 +235,29 @@ void ShenandoahBarrierSetAssembler::resolve_forward_pointer_not_null(MacroAssemb
   }
 }
 
+// Jumps to L_not_marked unless the mark bitmap keeps the non-null obj alive for a weak or
+// phantom access. Objects allocated after mark start have no mark bit and take the jump.
+void ShenandoahBarrierSetAssembler::test_marked(MacroAssembler* masm, Register obj, Register tmp1, Register tmp2,
+                                                DecoratorSet decorators, Label& L_not_marked) {
+  assert_different_registers(obj, tmp1, tmp2);
+  const int shift = ShenandoahHeap::mark_bit_map_index_shift();
+
+  __ mov(tmp2, ShenandoahHeap::mark_bit_map_biased_addr());
+  __ lsr(tmp1, obj, shift + LogBitsPerWord);
+  __ ldr(tmp2, Address(tmp2, tmp1, Address::lsl(LogBytesPerWord)));
+  __ lsr(tmp1, obj, shift);
+  __ lsrv(tmp2, tmp2, tmp1);
+  if (ShenandoahBarrierSet::is_weak_access(decorators)) {
+    // Weak references need the strong mark.
+    __ tbz(tmp2, 0, L_not_marked);
+  } else {
+    // Phantom references accept the weak mark too, which is the next bit.
+    assert(ShenandoahBarrierSet::is_phantom_access(decorators), "only remaining strength");
+    __ tst(tmp2, 3);
+    __ br(Assembler::EQ, L_not_marked);
+  }
+}
+
 void ShenandoahBarrierSetAssembler::load_reference_barrier(MacroAssembler* masm, Register dst, Address load_addr, DecoratorSet decorators) {
   assert(ShenandoahLoadRefBarrier, "Should be enabled");
   assert(dst != rscratch2, "need rscratch2");
@@ -245,8 +268,9 @@ void ShenandoahBarrierSetAssembler::load_reference_barrier(MacroAssembler* masm,
   bool is_phantom = ShenandoahBarrierSet::is_phantom_access(decorators);
   bool is_native  = ShenandoahBarrierSet::is_native_access(decorators);
   bool is_narrow  = UseCompressedOops && !is_native;
+  bool mark_test  = !is_strong && ShenandoahWeakBarrierMarkTest;
 
-  Label heap_stable, not_cset;
+  Label heap_stable, not_cset, slow_path;
   __ enter(/*strip_ret_addr*/true);
   Address gc_state(rthread, in_bytes(ShenandoahThreadLocalData::gc_state_offset()));
   __ ldrb(rscratch2, gc_state);
@@ -274,14 +298,21 @@ void ShenandoahBarrierSetAssembler::load_reference_barrier(MacroAssembler* masm,
   __ lea(r1, load_addr);
   __ mov(r0, dst);
 
+  if (mark_test) {
+    // Live referents outside of the cset are returned as they are, and so are nulls.
+    __ cbz(r0, not_cset);
+    test_marked(masm, r0, rscratch1, rscratch2, decorators, slow_path);
+  }
+
   // Test for in-cset
-  if (is_strong) {
+  if (is_strong || mark_test) {
     __ mov(rscratch2, ShenandoahHeap::in_cset_fast_test_addr());
     __ lsr(rscratch1, r0, ShenandoahHeapRegion::region_size_bytes_shift_jint());
     __ ldrb(rscratch2, Address(rscratch2, rscratch1));
     __ tbz(rscratch2, 0, not_cset);
   }
 
+  __ bind(slow_path);
   __ push_call_clobbered_registers();
   if (is_strong) {
     if (is_narrow) {
@@ -391,7 +422,9 @@ void ShenandoahBarrierSetAssembler::store_check(MacroAssembler* masm, Register o
 
   assert(CardTable::dirty_card_val() == 0, "must be");
 
-  __ load_byte_map_base(rscratch1);
+  // The card table base is loaded from the thread, because the collector
+  // exchanges the read and write card tables at a safepoint.
+  __ ldr(rscratch1, Address(rthread, in_bytes(ShenandoahThreadLocalData::card_table_offset())));
 
   if (UseCondCardMark) {
     Label L_already_dirty;
@@ -404,6 +437,20 @@ void ShenandoahBarrierSetAssembler::store_check(MacroAssembler* masm, Register o
   }
 }
 
+// Jumps to L_skip unless the uncompressed oop in val is a young reference. The content
+// of register val is destroyed afterwards.
+void ShenandoahBarrierSetAssembler::store_check_filter(MacroAssembler* masm, Register val, Register tmp, Label& L_skip) {
+  assert(ShenandoahCardBarrierYoungFilter, "Did you mean to enable ShenandoahCardBarrierYoungFilter?");
+  assert_different_registers(val, tmp);
+
+  __ cbz(val, L_skip);
+  __ lsr(val, val, ShenandoahHeapRegion::region_size_bytes_shift_jint());
+  __ mov(tmp, ShenandoahHeap::affiliations_biased_addr());
+  __ ldrb(tmp, Address(tmp, val));
+  __ cmpw(tmp, (u1) ShenandoahAffiliation::YOUNG_GENERATION);
+  __ br(Assembler::NE, L_skip);
+}
+
 void ShenandoahBarrierSetAssembler::store_at(MacroAssembler* masm, DecoratorSet decorators, BasicType type,
                                              Address dst, Register val, Register tmp1, Register tmp2, Register tmp3) {
   bool on_oop = is_reference_type(type);
@@ -433,15 +480,21 @@ void ShenandoahBarrierSetAssembler::store_at(MacroAssembler* masm, DecoratorSet
     BarrierSetAssembler::store_at(masm, decorators, type, Address(tmp3, 0), noreg, noreg, noreg, noreg);
   } else {
     iu_barrier(masm, val, tmp1);
-    // G1 barrier needs uncompressed oop for region cross check.
+    // The card barrier filter needs the uncompressed oop.
+    bool filter = ShenandoahCardBarrier && ShenandoahCardBarrierYoungFilter;
     Register new_val = val;
-    if (UseCompressedOops) {
-      new_val = rscratch2;
+    if (filter) {
+      new_val = tmp2;
       __ mov(new_val, val);
     }
     BarrierSetAssembler::store_at(masm, decorators, type, Address(tmp3, 0), val, noreg, noreg, noreg);
     if (ShenandoahCardBarrier) {
+      Label L_skip;
+      if (filter) {
+        store_check_filter(masm, new_val, tmp1, L_skip);
+      }
       store_check(masm, r3);
+      __ bind(L_skip);
     }
   }
 
@@ -647,7 +700,7 @@ void ShenandoahBarrierSetAssembler::gen_write_ref_array_post_barrier(MacroAssemb
   // number of bytes to copy
   __ sub(count, end, start);
 
-  __ load_byte_map_base(scratch);
+  __ ldr(scratch, Address(rthread, in_bytes(ShenandoahThreadLocalData::card_table_offset())));
   __ add(start, start, scratch);
   __ bind(L_loop);
   __ strb(zr, Address(start, count));
@@ -693,6 +746,9 @@ void ShenandoahBarrierSetAssembler::gen_load_reference_barrier_stub(LIR_Assemble
   bool is_weak    = ShenandoahBarrierSet::is_weak_access(decorators);
   bool is_phantom = ShenandoahBarrierSet::is_phantom_access(decorators);
   bool is_native  = ShenandoahBarrierSet::is_native_access(decorators);
+  bool mark_test  = !is_strong && ShenandoahWeakBarrierMarkTest;
+  // Methods without floating point code can use the stubs that preserve only the GPRs.
+  bool save_fpu_registers = ce->compilation()->has_fpu_code();
 
   Register obj = stub->obj()->as_register();
   Register res = stub->result()->as_register();
@@ -706,7 +762,14 @@ void ShenandoahBarrierSetAssembler::gen_load_reference_barrier_stub(LIR_Assemble
     __ mov(res, obj);
   }
 
-  if (is_strong) {
+  Label slow_path;
+  if (mark_test) {
+    // Live referents outside of the collection set need no runtime call.
+    __ cbz(res, *stub->continuation());
+    test_marked(ce->masm(), res, tmp1, tmp2, decorators, slow_path);
+  }
+
+  if (is_strong || mark_test) {
     // Check for object in cset.
     __ mov(tmp2, ShenandoahHeap::in_cset_fast_test_addr());
     __ lsr(tmp1, res, ShenandoahHeapRegion::region_size_bytes_shift_jint());
@@ -714,19 +777,21 @@ void ShenandoahBarrierSetAssembler::gen_load_reference_barrier_stub(LIR_Assemble
     __ cbz(tmp2, *stub->continuation());
   }
 
+  __ bind(slow_path);
+
   ce->store_parameter(res, 0);
   ce->store_parameter(addr, 1);
   if (is_strong) {
     if (is_native) {
-      __ far_call(RuntimeAddress(bs->load_reference_barrier_strong_native_rt_code_blob()->code_begin()));
+      __ far_call(RuntimeAddress(bs->load_reference_barrier_strong_native_rt_code_blob(save_fpu_registers)->code_begin()));
     } else {
-      __ far_call(RuntimeAddress(bs->load_reference_barrier_strong_rt_code_blob()->code_begin()));
+      __ far_call(RuntimeAddress(bs->load_reference_barrier_strong_rt_code_blob(save_fpu_registers)->code_begin()));
     }
   } else if (is_weak) {
-    __ far_call(RuntimeAddress(bs->load_reference_barrier_weak_rt_code_blob()->code_begin()));
+    __ far_call(RuntimeAddress(bs->load_reference_barrier_weak_rt_code_blob(save_fpu_registers)->code_begin()));
   } else {
     assert(is_phantom, "only remaining strength");
-    __ far_call(RuntimeAddress(bs->load_reference_barrier_phantom_rt_code_blob()->code_begin()));
+    __ far_call(RuntimeAddress(bs->load_reference_barrier_phantom_rt_code_blob(save_fpu_registers)->code_begin()));
   }
 
   __ b(*stub->continuation());
@@ -780,11 +845,16 @@ void ShenandoahBarrierSetAssembler::generate_c1_pre_barrier_runtime_stub(StubAss
   __ epilogue();
 }
 
-void ShenandoahBarrierSetAssembler::generate_c1_load_reference_barrier_runtime_stub(StubAssembler* sasm, DecoratorSet decorators) {
+void ShenandoahBarrierSetAssembler::generate_c1_load_reference_barrier_runtime_stub(StubAssembler* sasm, DecoratorSet decorators,
+                                                                                    bool save_fpu_registers) {
   __ prologue("shenandoah_load_reference_barrier", false);
   // arg0 : object to be resolved
 
-  __ push_call_clobbered_registers();
+  if (save_fpu_registers) {
+    __ push_call_clobbered_registers();
+  } else {
+    __ push(MacroAssembler::call_clobbered_gp_registers(), sp);
+  }
   __ load_parameter(0, r0);
   __ load_parameter(1, r1);
 
@@ -816,7 +886,11 @@ void ShenandoahBarrierSetAssembler::generate_c1_load_reference_barrier_runtime_s
   }
   __ blr(lr);
   __ mov(rscratch1, r0);
-  __ pop_call_clobbered_registers();
+  if (save_fpu_registers) {
+    __ pop_call_clobbered_registers();
+  } else {
+    __ pop(MacroAssembler::call_clobbered_gp_registers(), sp);
+  }
   __ mov(r0, rscratch1);
 
   __ epilogue();
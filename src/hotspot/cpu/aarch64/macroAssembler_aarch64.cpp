@@ -1197,6 +1197,118 @@ void MacroAssembler::lookup_interface_method(Register recv_klass,
   }
 }
 
+// Look up the method for a megamorphic invokeinterface call.
+//
+// Checks that recv_klass implements resolved_klass (REFC) and fetches the
+// method at itable_index in the itable of holder_klass (DECC), scanning the
+// itable offset table only once for both. The holder offset is picked up on
+// the way while looking for resolved_klass, and only if the holder comes
+// after resolved_klass is the rest of the table scanned again.
+//
+// Clobbers recv_klass, temp_reg, temp_reg2 and rscratch1.
+void MacroAssembler::lookup_interface_method_stub(Register recv_klass,
+                                                  Register holder_klass,
+                                                  Register resolved_klass,
+                                                  Register method_result,
+                                                  Register temp_reg,
+                                                  Register temp_reg2,
+                                                  int itable_index,
+                                                  Label& L_no_such_interface) {
+  assert_different_registers(recv_klass, holder_klass, resolved_klass, method_result,
+                             temp_reg, temp_reg2, rscratch1);
+  // method_result holds the itable klass while scanning
+  Register temp_itbl_klass = method_result;
+  Register scan_temp = temp_reg;
+  Register holder_offset = temp_reg2;
+
+  int vtable_base = in_bytes(Klass::vtable_start_offset());
+  int itentry_off = in_bytes(itableMethodEntry::method_offset());
+  int scan_step   = itableOffsetEntry::size() * wordSize;
+  int vte_size    = vtableEntry::size_in_bytes();
+  int ioffset     = in_bytes(itableOffsetEntry::interface_offset());
+  int ooffset     = in_bytes(itableOffsetEntry::offset_offset());
+  assert(vte_size == wordSize, "else adjust the scaling in the code below");
+
+  Label L_loop_search_resolved_entry, L_resolved_found, L_holder_found, L_search_holder,
+        L_loop_search_resolved, L_ready;
+
+  // temp_itbl_klass = recv_klass.itable[0]
+  // scan_temp = &recv_klass.itable[0] + step
+  ldrw(scan_temp, Address(recv_klass, Klass::vtable_length_offset()));
+  add(scan_temp, recv_klass, scan_temp, LSL, 3);
+  add(scan_temp, scan_temp, vtable_base + ioffset);
+  ldr(temp_itbl_klass, Address(post(scan_temp, scan_step)));
+  mov(holder_offset, zr);
+
+  // Initial checks:
+  //   - if (holder_klass != resolved_klass), go to "search for resolved"
+  //   - if (itable[0] == 0), no such interface
+  //   - if (itable[0] == holder_klass), shortcut to "holder found"
+  cmp(holder_klass, resolved_klass);
+  br(Assembler::NE, L_loop_search_resolved_entry);
+  cbz(temp_itbl_klass, L_no_such_interface);
+  cmp(holder_klass, temp_itbl_klass);
+  br(Assembler::EQ, L_holder_found);
+
+  // Loop: Look for holder_klass record in itable
+  //   do {
+  //     tmp = itable[index];
+  //     index += step;
+  //     if (tmp == holder_klass) {
+  //       goto L_holder_found; // Found!
+  //     }
+  //   } while (tmp != 0);
+  //   goto L_no_such_interface // Not found.
+  bind(L_search_holder);
+    ldr(temp_itbl_klass, Address(post(scan_temp, scan_step)));
+    cmp(holder_klass, temp_itbl_klass);
+    br(Assembler::EQ, L_holder_found);
+    cbnz(temp_itbl_klass, L_search_holder);
+
+  b(L_no_such_interface);
+
+  // Loop: Look for resolved_class record in itable
+  //   do {
+  //     tmp = itable[index];
+  //     index += step;
+  //     if (tmp == holder_klass) {
+  //        // Also check if we have met a holder klass
+  //        holder_tmp = itable[index-step-ioffset];
+  //     }
+  //     if (tmp == resolved_klass) {
+  //        goto L_resolved_found;  // Found!
+  //     }
+  //   } while (tmp != 0);
+  //   goto L_no_such_interface // Not found.
+  //
+  bind(L_loop_search_resolved);
+    ldr(temp_itbl_klass, Address(post(scan_temp, scan_step)));
+    bind(L_loop_search_resolved_entry);
+    // The null terminator is a complete entry, so its offset can be read too
+    ldrw(rscratch1, Address(scan_temp, ooffset - ioffset - scan_step));
+    cmp(holder_klass, temp_itbl_klass);
+    csel(holder_offset, rscratch1, holder_offset, Assembler::EQ);
+    cmp(resolved_klass, temp_itbl_klass);
+    br(Assembler::EQ, L_resolved_found);
+    cbnz(temp_itbl_klass, L_loop_search_resolved);
+
+  b(L_no_such_interface);
+
+  // See if we already have a holder klass. If not, go and scan for it.
+  bind(L_resolved_found);
+  cbz(holder_offset, L_search_holder);
+  b(L_ready);
+
+  bind(L_holder_found);
+  ldrw(holder_offset, Address(scan_temp, ooffset - ioffset - scan_step));
+
+  // Finally, holder_offset contains holder_klass vtable offset
+  bind(L_ready);
+  assert(itableMethodEntry::size() * wordSize == wordSize, "adjust the scaling in the code below");
+  add(recv_klass, recv_klass, itable_index * wordSize + itentry_off);
+  ldr(method_result, Address(recv_klass, holder_offset, Address::uxtw(0)));
+}
+
 // virtual method calling
 void MacroAssembler::lookup_virtual_method(Register recv_klass,
                                            RegisterOrConstant vtable_index,
@@ -5225,6 +5337,65 @@ address MacroAssembler::arrays_equals(Register a1, Register a2, Register tmp3,
   return pc();
 }
 
+// Compute the polynomial hash h = 31 * h + ary[i] of cnt elements of type
+// eltype, as used by String.hashCode and Arrays.hashCode, starting from the
+// initial value in result. Blocks of 16 elements are hashed by the
+// large_arrays_hashcode stub, the remainder by the scalar loop below.
+// Clobbers ary, cnt, v0-v7 and, for large arrays, rscratch1 and lr.
+address MacroAssembler::arrays_hashcode(Register ary, Register cnt, Register result,
+                                        Register tmp1, Register tmp2, BasicType eltype) {
+  assert_different_registers(ary, cnt, result, tmp1, tmp2, rscratch1);
+  assert(ary == r1 && cnt == r2 && result == r0, "registers must match the stub");
+
+  const int block = StubRoutines::aarch64::large_arrays_hashcode_block;
+  Label TAIL, LOOP, DONE;
+
+  BLOCK_COMMENT("arrays_hashcode {");
+
+  cmpw(cnt, (u1)block);
+  br(LT, TAIL);
+  RuntimeAddress stub = RuntimeAddress(StubRoutines::aarch64::large_arrays_hashcode(eltype));
+  assert(stub.target() != nullptr, "large_arrays_hashcode stub has not been generated");
+  address tpc = trampoline_call(stub);
+  if (tpc == nullptr) {
+    DEBUG_ONLY(reset_labels(TAIL, LOOP, DONE));
+    postcond(pc() == badAddress);
+    return nullptr;
+  }
+
+  bind(TAIL);
+  cbzw(cnt, DONE);
+  movw(tmp2, 31);
+  bind(LOOP);
+  switch (eltype) {
+  case T_BOOLEAN:
+    ldrb(tmp1, Address(post(ary, 1)));
+    break;
+  case T_BYTE:
+    ldrsbw(tmp1, Address(post(ary, 1)));
+    break;
+  case T_CHAR:
+    ldrh(tmp1, Address(post(ary, 2)));
+    break;
+  case T_SHORT:
+    ldrshw(tmp1, Address(post(ary, 2)));
+    break;
+  case T_INT:
+    ldrw(tmp1, Address(post(ary, 4)));
+    break;
+  default:
+    ShouldNotReachHere();
+  }
+  maddw(result, result, tmp2, tmp1);
+  subsw(cnt, cnt, 1);
+  br(NE, LOOP);
+  bind(DONE);
+
+  BLOCK_COMMENT("} arrays_hashcode");
+  postcond(pc() != badAddress);
+  return pc();
+}
+
 // Compare Strings
 
 // For Strings we're passed the address of the first characters in a1
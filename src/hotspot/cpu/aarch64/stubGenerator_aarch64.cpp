@@ -5298,6 +5298,112 @@ class StubGenerator: public StubCodeGenerator {
     return entry;
   }
 
+  // ary = r1 - array address
+  // cnt = r2 - number of elements left to hash, at least
+  //            StubRoutines::aarch64::large_arrays_hashcode_block
+  // result = r0 - hash accumulated so far, returns the hash of the elements
+  //               consumed by the stub
+  // On exit ary points past the consumed elements and cnt holds the number of
+  // elements that are left for the scalar tail (less than one block).
+  // Clobbers: v0-v7, rscratch1
+  address generate_large_arrays_hashcode(BasicType eltype) {
+    const Register ary = r1, cnt = r2, result = r0, tmp = rscratch1;
+    const FloatRegister vpow = v4, vld = v5, vcoef = v6, vpow4 = v7;
+    const FloatRegister vacc[] = { v0, v1, v2, v3 };
+    const int block = StubRoutines::aarch64::large_arrays_hashcode_block;
+    assert(block == 4 * 4, "four accumulators of four int lanes");
+
+    Label LOOP;
+
+    __ align(CodeEntryAlignment);
+
+    const char* name;
+    switch (eltype) {
+    case T_BOOLEAN: name = "large_arrays_hashcode_boolean"; break;
+    case T_BYTE:    name = "large_arrays_hashcode_byte";    break;
+    case T_CHAR:    name = "large_arrays_hashcode_char";    break;
+    case T_SHORT:   name = "large_arrays_hashcode_short";   break;
+    case T_INT:     name = "large_arrays_hashcode_int";     break;
+    default:
+      ShouldNotReachHere();
+      name = nullptr;
+    }
+
+    StubCodeMark mark(this, "StubRoutines", name);
+
+    address entry = __ pc();
+    __ enter();
+
+    // Lane j of accumulator q collects the elements at index 4 * q + j of
+    // every block, each block multiplying the previous sum by 31^16. The
+    // incoming hash sits in the lane of the last element of the block so
+    // that it ends up scaled by 31^n just like in the scalar loop.
+    for (int q = 0; q < 4; q++) {
+      __ eor(vacc[q], __ T16B, vacc[q], vacc[q]);
+    }
+    __ mov(vacc[3], __ S, 3, result);
+    __ movw(tmp, 0x50a9de01);                       // 31^16 mod 2^32
+    __ dup(vpow, __ T4S, tmp);
+
+    __ bind(LOOP);
+    for (int q = 0; q < 4; q++) {
+      switch (eltype) {
+      case T_BOOLEAN:
+        __ ldrs(vld, __ post(ary, 4));
+        __ uxtl(vld, __ T8H, vld, __ T8B);
+        __ uxtl(vld, __ T4S, vld, __ T4H);
+        break;
+      case T_BYTE:
+        __ ldrs(vld, __ post(ary, 4));
+        __ sxtl(vld, __ T8H, vld, __ T8B);
+        __ sxtl(vld, __ T4S, vld, __ T4H);
+        break;
+      case T_CHAR:
+        __ ldrd(vld, __ post(ary, 8));
+        __ uxtl(vld, __ T4S, vld, __ T4H);
+        break;
+      case T_SHORT:
+        __ ldrd(vld, __ post(ary, 8));
+        __ sxtl(vld, __ T4S, vld, __ T4H);
+        break;
+      case T_INT:
+        __ ld1(vld, __ T4S, __ post(ary, 16));
+        break;
+      default:
+        ShouldNotReachHere();
+      }
+      __ mulv(vacc[q], __ T4S, vacc[q], vpow);
+      __ addv(vacc[q], __ T4S, vacc[q], vld);
+    }
+    __ subw(cnt, cnt, block);
+    __ cmpw(cnt, (u1)block);
+    __ br(__ GE, LOOP);
+
+    // Scale lane j of accumulator q by 31^(15 - 4 * q - j) and sum all lanes.
+    __ movw(tmp, 31 * 31 * 31);
+    __ mov(vcoef, __ S, 0, tmp);
+    __ movw(tmp, 31 * 31);
+    __ mov(vcoef, __ S, 1, tmp);
+    __ movw(tmp, 31);
+    __ mov(vcoef, __ S, 2, tmp);
+    __ movw(tmp, 1);
+    __ mov(vcoef, __ S, 3, tmp);
+    __ movw(tmp, 31 * 31 * 31 * 31);
+    __ dup(vpow4, __ T4S, tmp);
+
+    __ mulv(vld, __ T4S, vacc[3], vcoef);
+    for (int q = 2; q >= 0; q--) {
+      __ mulv(vcoef, __ T4S, vcoef, vpow4);
+      __ mlav(vld, __ T4S, vacc[q], vcoef);
+    }
+    __ addv(vld, __ T4S, vld);
+    __ umov(result, vld, __ S, 0);
+
+    __ leave();
+    __ ret(lr);
+    return entry;
+  }
+
   address generate_dsin_dcos(bool isCos) {
     __ align(CodeEntryAlignment);
     StubCodeMark mark(this, "StubRoutines", isCos ? "libmDcos" : "libmDsin");
@@ -8389,6 +8495,14 @@ class StubGenerator: public StubCodeGenerator {
       StubRoutines::aarch64::_large_array_equals = generate_large_array_equals();
     }
 
+    if (UseVectorizedHashCodeIntrinsic) {
+      StubRoutines::aarch64::_large_arrays_hashcode_boolean = generate_large_arrays_hashcode(T_BOOLEAN);
+      StubRoutines::aarch64::_large_arrays_hashcode_byte    = generate_large_arrays_hashcode(T_BYTE);
+      StubRoutines::aarch64::_large_arrays_hashcode_char    = generate_large_arrays_hashcode(T_CHAR);
+      StubRoutines::aarch64::_large_arrays_hashcode_short   = generate_large_arrays_hashcode(T_SHORT);
+      StubRoutines::aarch64::_large_arrays_hashcode_int     = generate_large_arrays_hashcode(T_INT);
+    }
+
     // byte_array_inflate stub for large arrays.
     StubRoutines::aarch64::_large_byte_array_inflate = generate_large_byte_array_inflate();
 
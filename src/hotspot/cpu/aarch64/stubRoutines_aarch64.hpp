@@ -38,7 +38,7 @@ enum platform_dependent_constants {
   // simply increase sizes if too small (assembler will crash if too small)
   _initial_stubs_code_size      = 10000,
   _continuation_stubs_code_size =  2000,
-  _compiler_stubs_code_size     = 30000 ZGC_ONLY(+10000),
+  _compiler_stubs_code_size     = 31000 ZGC_ONLY(+10000),
   _final_stubs_code_size        = 20000 ZGC_ONLY(+100000)
 };
 
@@ -62,6 +62,11 @@ class aarch64 {
   static address _zero_blocks;
 
   static address _large_array_equals;
+  static address _large_arrays_hashcode_boolean;
+  static address _large_arrays_hashcode_byte;
+  static address _large_arrays_hashcode_char;
+  static address _large_arrays_hashcode_short;
+  static address _large_arrays_hashcode_int;
   static address _compare_long_string_LL;
   static address _compare_long_string_LU;
   static address _compare_long_string_UL;
@@ -147,6 +152,27 @@ class aarch64 {
       return _large_array_equals;
   }
 
+  // Number of elements that the large_arrays_hashcode stubs hash per iteration
+  static const int large_arrays_hashcode_block = 16;
+
+  static address large_arrays_hashcode(BasicType eltype) {
+    switch (eltype) {
+    case T_BOOLEAN:
+      return _large_arrays_hashcode_boolean;
+    case T_BYTE:
+      return _large_arrays_hashcode_byte;
+    case T_CHAR:
+      return _large_arrays_hashcode_char;
+    case T_SHORT:
+      return _large_arrays_hashcode_short;
+    case T_INT:
+      return _large_arrays_hashcode_int;
+    default:
+      ShouldNotReachHere();
+    }
+    return nullptr;
+  }
+
   static address compare_long_string_LL() {
       return _compare_long_string_LL;
   }
@@ -516,6 +516,10 @@ void VM_Version::initialize() {
     UseMontgomerySquareIntrinsic = true;
   }
 
+  if (FLAG_IS_DEFAULT(UseVectorizedHashCodeIntrinsic)) {
+    UseVectorizedHashCodeIntrinsic = true;
+  }
+
   if (UseSVE > 0) {
     if (FLAG_IS_DEFAULT(MaxVectorSize)) {
       MaxVectorSize = _initial_sve_vector_length;
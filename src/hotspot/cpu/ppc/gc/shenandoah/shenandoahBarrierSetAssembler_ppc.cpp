@@ -599,8 +599,6 @@ void ShenandoahBarrierSetAssembler::load_at(
 void ShenandoahBarrierSetAssembler::store_check(MacroAssembler* masm, Register base, RegisterOrConstant ind_or_offs, Register tmp) {
   assert(ShenandoahCardBarrier, "Did you mean to enable ShenandoahCardBarrier?");
 
-  ShenandoahBarrierSet* ctbs = ShenandoahBarrierSet::barrier_set();
-  CardTable* ct = ctbs->card_table();
   assert_different_registers(base, tmp, R0);
 
   if (ind_or_offs.is_constant()) {
@@ -609,7 +607,9 @@ void ShenandoahBarrierSetAssembler::store_check(MacroAssembler* masm, Register b
     __ add(base, ind_or_offs.as_register(), base);
   }
 
-  __ load_const_optimized(tmp, (address)ct->byte_map_base(), R0);
+  // The card table base is loaded from the thread, because the collector
+  // exchanges the read and write card tables at a safepoint.
+  __ ld(tmp, in_bytes(ShenandoahThreadLocalData::card_table_offset()), R16_thread);
   __ srdi(base, base, CardTable::card_shift());
   __ li(R0, CardTable::dirty_card_val());
   __ stbx(R0, tmp, base);
@@ -795,8 +795,6 @@ void ShenandoahBarrierSetAssembler::gen_write_ref_array_post_barrier(MacroAssemb
                                                                      Register addr, Register count, Register preserve) {
   assert(ShenandoahCardBarrier, "Did you mean to enable ShenandoahCardBarrier?");
 
-  ShenandoahBarrierSet* bs = ShenandoahBarrierSet::barrier_set();
-  CardTable* ct = bs->card_table();
   assert_different_registers(addr, count, R0);
 
   Label L_skip_loop, L_store_loop;
@@ -812,7 +810,8 @@ void ShenandoahBarrierSetAssembler::gen_write_ref_array_post_barrier(MacroAssemb
   __ srdi(addr, addr, CardTable::card_shift());
   __ srdi(count, count, CardTable::card_shift());
   __ subf(count, addr, count);
-  __ add_const_optimized(addr, addr, (address)ct->byte_map_base(), R0);
+  __ ld(R0, in_bytes(ShenandoahThreadLocalData::card_table_offset()), R16_thread);
+  __ add(addr, addr, R0);
   __ addi(count, count, 1);
   __ li(R0, 0);
   __ mtctr(count);
@@ -894,6 +893,8 @@ void ShenandoahBarrierSetAssembler::gen_load_reference_barrier_stub(LIR_Assemble
   bool is_strong  = ShenandoahBarrierSet::is_strong_access(decorators);
   bool is_weak    = ShenandoahBarrierSet::is_weak_access(decorators);
   bool is_phantom = ShenandoahBarrierSet::is_phantom_access(decorators);
+  // Methods without floating point code can use the stubs that preserve only the GPRs.
+  bool save_fpu_registers = ce->compilation()->has_fpu_code();
   bool is_native  = ShenandoahBarrierSet::is_native_access(decorators);
 
   if (is_strong) {
@@ -910,15 +911,15 @@ void ShenandoahBarrierSetAssembler::gen_load_reference_barrier_stub(LIR_Assemble
 
   if (is_strong) {
     if (is_native) {
-      blob_addr = bs->load_reference_barrier_strong_native_rt_code_blob()->code_begin();
+      blob_addr = bs->load_reference_barrier_strong_native_rt_code_blob(save_fpu_registers)->code_begin();
     } else {
-      blob_addr = bs->load_reference_barrier_strong_rt_code_blob()->code_begin();
+      blob_addr = bs->load_reference_barrier_strong_rt_code_blob(save_fpu_registers)->code_begin();
     }
   } else if (is_weak) {
-    blob_addr = bs->load_reference_barrier_weak_rt_code_blob()->code_begin();
+    blob_addr = bs->load_reference_barrier_weak_rt_code_blob(save_fpu_registers)->code_begin();
   } else {
     assert(is_phantom, "only remaining strength");
-    blob_addr = bs->load_reference_barrier_phantom_rt_code_blob()->code_begin();
+    blob_addr = bs->load_reference_barrier_phantom_rt_code_blob(save_fpu_registers)->code_begin();
   }
 
   assert(blob_addr != nullptr, "code blob cannot be found");
@@ -1006,16 +1007,18 @@ void ShenandoahBarrierSetAssembler::generate_c1_pre_barrier_runtime_stub(StubAss
 }
 
 void ShenandoahBarrierSetAssembler::generate_c1_load_reference_barrier_runtime_stub(StubAssembler *sasm,
-                                                                                    DecoratorSet decorators) {
+                                                                                    DecoratorSet decorators,
+                                                                                    bool save_fpu_registers) {
   __ block_comment("generate_c1_load_reference_barrier_runtime_stub (shenandoahgc) {");
 
   // Argument passing via the stack.
   const int caller_stack_slots = 1;
 
-  // Save to-be-preserved registers.
+  // Save to-be-preserved registers.  The save area keeps its size if the floating point
+  // registers are skipped, so the argument slot stays where the caller put it.
   const int nbytes_save = (MacroAssembler::num_volatile_regs - 1 // 'R3_ARG1' is skipped
                            + caller_stack_slots) * BytesPerWord;
-  __ save_volatile_gprs(R1_SP, -nbytes_save, true, false);
+  __ save_volatile_gprs(R1_SP, -nbytes_save, save_fpu_registers, false);
 
   // Load arguments from stack.
   // No load required, as assured by assertions in 'ShenandoahBarrierSetAssembler::gen_load_reference_barrier_stub'.
@@ -1066,7 +1069,7 @@ void ShenandoahBarrierSetAssembler::generate_c1_load_reference_barrier_runtime_s
   // Restore to-be-preserved registers.
   __ pop_frame();
   __ restore_LR_CR(R11_tmp);
-  __ restore_volatile_gprs(R1_SP, -nbytes_save, true, false); // Skip 'R3_RET' register.
+  __ restore_volatile_gprs(R1_SP, -nbytes_save, save_fpu_registers, false); // Skip 'R3_RET' register.
 
   __ blr();
   __ block_comment("} generate_c1_load_reference_barrier_runtime_stub (shenandoahgc)");
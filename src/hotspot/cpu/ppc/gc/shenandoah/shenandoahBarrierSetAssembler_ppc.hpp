@@ -80,7 +80,7 @@ public:
 
   void generate_c1_pre_barrier_runtime_stub(StubAssembler* sasm);
 
-  void generate_c1_load_reference_barrier_runtime_stub(StubAssembler* sasm, DecoratorSet decorators);
+  void generate_c1_load_reference_barrier_runtime_stub(StubAssembler* sasm, DecoratorSet decorators, bool save_fpu_registers);
 
 #endif
 
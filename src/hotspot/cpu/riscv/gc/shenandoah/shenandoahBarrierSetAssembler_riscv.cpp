@@ -576,6 +576,8 @@ void ShenandoahBarrierSetAssembler::gen_load_reference_barrier_stub(LIR_Assemble
   bool is_strong  = ShenandoahBarrierSet::is_strong_access(decorators);
   bool is_weak    = ShenandoahBarrierSet::is_weak_access(decorators);
   bool is_phantom = ShenandoahBarrierSet::is_phantom_access(decorators);
+  // Methods without floating point code can use the stubs that preserve only the GPRs.
+  bool save_fpu_registers = ce->compilation()->has_fpu_code();
   bool is_native  = ShenandoahBarrierSet::is_native_access(decorators);
 
   Register obj = stub->obj()->as_register();
@@ -605,15 +607,15 @@ void ShenandoahBarrierSetAssembler::gen_load_reference_barrier_stub(LIR_Assemble
 
   if (is_strong) {
     if (is_native) {
-      __ far_call(RuntimeAddress(bs->load_reference_barrier_strong_native_rt_code_blob()->code_begin()));
+      __ far_call(RuntimeAddress(bs->load_reference_barrier_strong_native_rt_code_blob(save_fpu_registers)->code_begin()));
     } else {
-      __ far_call(RuntimeAddress(bs->load_reference_barrier_strong_rt_code_blob()->code_begin()));
+      __ far_call(RuntimeAddress(bs->load_reference_barrier_strong_rt_code_blob(save_fpu_registers)->code_begin()));
     }
   } else if (is_weak) {
-    __ far_call(RuntimeAddress(bs->load_reference_barrier_weak_rt_code_blob()->code_begin()));
+    __ far_call(RuntimeAddress(bs->load_reference_barrier_weak_rt_code_blob(save_fpu_registers)->code_begin()));
   } else {
     assert(is_phantom, "only remaining strength");
-    __ far_call(RuntimeAddress(bs->load_reference_barrier_phantom_rt_code_blob()->code_begin()));
+    __ far_call(RuntimeAddress(bs->load_reference_barrier_phantom_rt_code_blob(save_fpu_registers)->code_begin()));
   }
 
   __ j(*stub->continuation());
@@ -669,11 +671,17 @@ void ShenandoahBarrierSetAssembler::generate_c1_pre_barrier_runtime_stub(StubAss
 }
 
 void ShenandoahBarrierSetAssembler::generate_c1_load_reference_barrier_runtime_stub(StubAssembler* sasm,
-                                                                                    DecoratorSet decorators) {
+                                                                                    DecoratorSet decorators,
+                                                                                    bool save_fpu_registers) {
   __ prologue("shenandoah_load_reference_barrier", false);
   // arg0 : object to be resolved
 
-  __ push_call_clobbered_registers();
+  const RegSet gp_regs = RegSet::of(x7) + RegSet::range(x10, x17) + RegSet::range(x28, x31);
+  if (save_fpu_registers) {
+    __ push_call_clobbered_registers();
+  } else {
+    __ push_reg(gp_regs, sp);
+  }
   __ load_parameter(0, x10);
   __ load_parameter(1, x11);
 
@@ -706,7 +714,11 @@ void ShenandoahBarrierSetAssembler::generate_c1_load_reference_barrier_runtime_s
   }
   __ call(target);
   __ mv(t0, x10);
-  __ pop_call_clobbered_registers();
+  if (save_fpu_registers) {
+    __ pop_call_clobbered_registers();
+  } else {
+    __ pop_reg(gp_regs, sp);
+  }
   __ mv(x10, t0);
 
   __ epilogue();
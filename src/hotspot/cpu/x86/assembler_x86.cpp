@@ -13445,6 +13445,11 @@ void Assembler::notq(Register dst) {
   emit_int16((unsigned char)0xF7, (0xD0 | encode));
 }
 
+void Assembler::btq(Register src, Register bit) {
+  int encode = prefixq_and_encode(bit->encoding(), src->encoding());
+  emit_int24(0x0F, (unsigned char)0xA3, (0xC0 | encode));
+}
+
 void Assembler::btsq(Address dst, int imm8) {
   assert(isByte(imm8), "not a byte");
   InstructionMark im(this);
@@ -1716,6 +1716,7 @@ private:
 #ifdef _LP64
   void notq(Register dst);
 
+  void btq(Register src, Register bit);
   void btsq(Address dst, int imm8);
   void btrq(Address dst, int imm8);
 #endif
@@ -133,7 +133,8 @@ LIR_Opr ShenandoahBarrierSetC1::atomic_xchg_at_resolved(LIRAccess& access, LIRIt
                   result /* pre_val */);
     }
     if (ShenandoahCardBarrier) {
-      post_barrier(access, access.resolved_addr(), result);
+      // The result is the previous value, the card barrier cannot filter on it.
+      post_barrier(access, access.resolved_addr(), LIR_OprFact::illegalOpr);
     }
   }
 
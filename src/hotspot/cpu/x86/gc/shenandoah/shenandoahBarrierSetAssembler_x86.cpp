@@ -371,6 +371,37 @@ void ShenandoahBarrierSetAssembler::satb_write_barrier_pre(MacroAssembler* masm,
   __ bind(done);
 }
 
+#ifdef _LP64
+// Jumps to L_not_marked unless the mark bitmap keeps the non-null obj alive for a weak or
+// phantom access. Objects allocated after mark start have no mark bit and take the jump.
+void ShenandoahBarrierSetAssembler::test_marked(MacroAssembler* masm, Register obj, Register tmp1, Register tmp2,
+                                                DecoratorSet decorators, Label& L_not_marked) {
+  assert_different_registers(obj, tmp1, tmp2);
+  const int shift = ShenandoahHeap::mark_bit_map_index_shift();
+
+  __ movptr(tmp1, obj);
+  __ shrptr(tmp1, shift + LogBitsPerWord);
+  __ movptr(tmp2, (intptr_t) ShenandoahHeap::mark_bit_map_biased_addr());
+  __ movptr(tmp1, Address(tmp2, tmp1, Address::times_8));
+  __ movptr(tmp2, obj);
+  __ shrptr(tmp2, shift);
+  __ btq(tmp1, tmp2);
+  if (ShenandoahBarrierSet::is_weak_access(decorators)) {
+    // Weak references need the strong mark.
+    __ jcc(Assembler::carryClear, L_not_marked);
+  } else {
+    // Phantom references accept the weak mark too, which is the next bit.
+    assert(ShenandoahBarrierSet::is_phantom_access(decorators), "only remaining strength");
+    Label L_marked;
+    __ jcc(Assembler::carrySet, L_marked);
+    __ addptr(tmp2, 1);
+    __ btq(tmp1, tmp2);
+    __ jcc(Assembler::carryClear, L_not_marked);
+    __ bind(L_marked);
+  }
+}
+#endif
+
 void ShenandoahBarrierSetAssembler::load_reference_barrier(MacroAssembler* masm, Register dst, Address src, DecoratorSet decorators) {
   assert(ShenandoahLoadRefBarrier, "Should be enabled");
 
@@ -379,8 +410,10 @@ void ShenandoahBarrierSetAssembler::load_reference_barrier(MacroAssembler* masm,
   bool is_phantom = ShenandoahBarrierSet::is_phantom_access(decorators);
   bool is_native  = ShenandoahBarrierSet::is_native_access(decorators);
   bool is_narrow  = UseCompressedOops && !is_native;
+  bool mark_test  = LP64_ONLY(!is_strong && ShenandoahWeakBarrierMarkTest) NOT_LP64(false);
+  bool cset_test  = is_strong || mark_test;
 
-  Label heap_stable, not_cset;
+  Label heap_stable, not_cset, slow_path;
 
   __ block_comment("load_reference_barrier { ");
 
@@ -405,7 +438,7 @@ void ShenandoahBarrierSetAssembler::load_reference_barrier(MacroAssembler* masm,
   __ jcc(Assembler::zero, heap_stable);
 
   Register tmp1 = noreg, tmp2 = noreg;
-  if (is_strong) {
+  if (cset_test) {
     // Test for object in cset
     // Allocate temporary registers
     for (int i = 0; i < 8; i++) {
@@ -427,6 +460,15 @@ void ShenandoahBarrierSetAssembler::load_reference_barrier(MacroAssembler* masm,
     __ push(tmp1);
     __ push(tmp2);
 
+#ifdef _LP64
+    if (mark_test) {
+      // Live referents outside of the cset are returned as they are, and so are nulls.
+      __ testptr(dst, dst);
+      __ jcc(Assembler::zero, not_cset);
+      test_marked(masm, dst, tmp1, tmp2, decorators, slow_path);
+    }
+#endif
+
     // Optimized cset-test
     __ movptr(tmp1, dst);
     __ shrptr(tmp1, ShenandoahHeapRegion::region_size_bytes_shift_jint());
@@ -436,6 +478,7 @@ void ShenandoahBarrierSetAssembler::load_reference_barrier(MacroAssembler* masm,
     __ jcc(Assembler::zero, not_cset);
   }
 
+  __ bind(slow_path);
   save_machine_state(masm, /* handle_gpr = */ false, /* handle_fp = */ true);
 
   // The rest is saved with the optimized path
@@ -514,7 +557,7 @@ void ShenandoahBarrierSetAssembler::load_reference_barrier(MacroAssembler* masm,
 
   __ bind(not_cset);
 
-  if  (is_strong) {
+  if (cset_test) {
     __ pop(tmp2);
     __ pop(tmp1);
   }
@@ -651,30 +694,21 @@ void ShenandoahBarrierSetAssembler::store_check(MacroAssembler* masm, Register o
   // Does a store check for the oop in register obj. The content of
   // register obj is destroyed afterwards.
 
-  ShenandoahBarrierSet* ctbs = ShenandoahBarrierSet::barrier_set();
-  CardTable* ct = ctbs->card_table();
-
   __ shrptr(obj, CardTable::card_shift());
 
-  Address card_addr;
+  // The card table base is loaded from the thread, because the collector
+  // exchanges the read and write card tables at a safepoint.
+#ifdef _LP64
+  Register thread = r15_thread;
+#else
+  // store_at has already clobbered rcx with the current thread.
+  Register thread = rcx;
+  assert_different_registers(obj, thread);
+  __ get_thread(thread);
+#endif
+  __ addptr(obj, Address(thread, in_bytes(ShenandoahThreadLocalData::card_table_offset())));
 
-  // The calculation for byte_map_base is as follows:
-  // byte_map_base = _byte_map - (uintptr_t(low_bound) >> card_shift);
-  // So this essentially converts an address to a displacement and it will
-  // never need to be relocated. On 64-bit however the value may be too
-  // large for a 32-bit displacement.
-  intptr_t byte_map_base = (intptr_t)ct->byte_map_base();
-  if (__ is_simm32(byte_map_base)) {
-    card_addr = Address(noreg, obj, Address::times_1, byte_map_base);
-  } else {
-    // By doing it as an ExternalAddress 'byte_map_base' could be converted to a rip-relative
-    // displacement and done in a single instruction given favorable mapping and a
-    // smarter version of as_Address. However, 'ExternalAddress' generates a relocation
-    // entry and that entry is not properly handled by the relocation code.
-    AddressLiteral cardtable((address)byte_map_base, relocInfo::none);
-    Address index(noreg, obj, Address::times_1);
-    card_addr = __ as_Address(ArrayAddress(cardtable, index), rscratch1);
-  }
+  Address card_addr(obj, 0);
 
   int dirty = CardTable::dirty_card_val();
   if (UseCondCardMark) {
@@ -688,6 +722,20 @@ void ShenandoahBarrierSetAssembler::store_check(MacroAssembler* masm, Register o
   }
 }
 
+// Jumps to L_skip unless the uncompressed oop in val is a young reference. The content
+// of register val is destroyed afterwards.
+void ShenandoahBarrierSetAssembler::store_check_filter(MacroAssembler* masm, Register val, Register tmp, Label& L_skip) {
+  assert(ShenandoahCardBarrierYoungFilter, "Did you mean to enable ShenandoahCardBarrierYoungFilter?");
+  assert_different_registers(val, tmp);
+
+  __ testptr(val, val);
+  __ jcc(Assembler::zero, L_skip);
+  __ shrptr(val, ShenandoahHeapRegion::region_size_bytes_shift_jint());
+  __ movptr(tmp, (intptr_t) ShenandoahHeap::affiliations_biased_addr());
+  __ cmpb(Address(tmp, val, Address::times_1), ShenandoahAffiliation::YOUNG_GENERATION);
+  __ jcc(Assembler::notEqual, L_skip);
+}
+
 void ShenandoahBarrierSetAssembler::store_at(MacroAssembler* masm, DecoratorSet decorators, BasicType type,
               Address dst, Register val, Register tmp1, Register tmp2, Register tmp3) {
 
@@ -729,9 +777,19 @@ void ShenandoahBarrierSetAssembler::store_at(MacroAssembler* masm, DecoratorSet
       BarrierSetAssembler::store_at(masm, decorators, type, Address(tmp1, 0), val, noreg, noreg, noreg);
     } else {
       iu_barrier(masm, val, tmp3);
+      bool filter = ShenandoahCardBarrier && ShenandoahCardBarrierYoungFilter;
+      if (filter) {
+        // The store encodes val in place, keep the uncompressed oop for the filter.
+        __ movptr(tmp2, val);
+      }
       BarrierSetAssembler::store_at(masm, decorators, type, Address(tmp1, 0), val, noreg, noreg, noreg);
       if (ShenandoahCardBarrier) {
+        Label L_skip;
+        if (filter) {
+          store_check_filter(masm, tmp2, tmp3, L_skip);
+        }
         store_check(masm, tmp1);
+        __ bind(L_skip);
       }
     }
     NOT_LP64(imasm->restore_bcp());
@@ -943,10 +1001,6 @@ void ShenandoahBarrierSetAssembler::gen_write_ref_array_post_barrier(MacroAssemb
                                                                      Register tmp) {
   assert(ShenandoahCardBarrier, "Did you mean to enable ShenandoahCardBarrier?");
 
-  ShenandoahBarrierSet* bs = ShenandoahBarrierSet::barrier_set();
-  CardTable* ct = bs->card_table();
-  intptr_t disp = (intptr_t) ct->byte_map_base();
-
   Label L_loop, L_done;
   const Register end = count;
   assert_different_registers(addr, end);
@@ -962,8 +1016,7 @@ void ShenandoahBarrierSetAssembler::gen_write_ref_array_post_barrier(MacroAssemb
   __ shrptr(end, CardTable::card_shift());
   __ subptr(end, addr); // end --> cards count
 
-  __ mov64(tmp, disp);
-  __ addptr(addr, tmp);
+  __ addptr(addr, Address(r15_thread, in_bytes(ShenandoahThreadLocalData::card_table_offset())));
 
   __ BIND(L_loop);
   __ movb(Address(addr, count, Address::times_1), 0);
@@ -975,8 +1028,11 @@ void ShenandoahBarrierSetAssembler::gen_write_ref_array_post_barrier(MacroAssemb
   __ shrptr(end,  CardTable::card_shift());
   __ subptr(end, addr); // end --> count
 
+  __ get_thread(tmp);
+  __ addptr(addr, Address(tmp, in_bytes(ShenandoahThreadLocalData::card_table_offset())));
+
   __ BIND(L_loop);
-  Address cardtable(addr, count, Address::times_1, disp);
+  Address cardtable(addr, count, Address::times_1, 0);
   __ movb(cardtable, 0);
   __ decrement(count);
   __ jccb(Assembler::greaterEqual, L_loop);
@@ -1024,6 +1080,9 @@ void ShenandoahBarrierSetAssembler::gen_load_reference_barrier_stub(LIR_Assemble
   bool is_weak    = ShenandoahBarrierSet::is_weak_access(decorators);
   bool is_phantom = ShenandoahBarrierSet::is_phantom_access(decorators);
   bool is_native  = ShenandoahBarrierSet::is_native_access(decorators);
+  bool mark_test  = LP64_ONLY(!is_strong && ShenandoahWeakBarrierMarkTest) NOT_LP64(false);
+  // Methods without floating point code can use the stubs that preserve only the GPRs.
+  bool save_fpu_registers = ce->compilation()->has_fpu_code();
 
   Register obj = stub->obj()->as_register();
   Register res = stub->result()->as_register();
@@ -1040,7 +1099,16 @@ void ShenandoahBarrierSetAssembler::gen_load_reference_barrier_stub(LIR_Assemble
     __ mov(res, obj);
   }
 
-  if (is_strong) {
+#ifdef _LP64
+  if (mark_test) {
+    // Live referents outside of the collection set need no runtime call.
+    __ testptr(res, res);
+    __ jcc(Assembler::zero, *stub->continuation());
+    test_marked(ce->masm(), res, tmp1, tmp2, decorators, slow_path);
+  }
+#endif
+
+  if (is_strong || mark_test) {
     // Check for object being in the collection set.
     __ mov(tmp1, res);
     __ shrptr(tmp1, ShenandoahHeapRegion::region_size_bytes_shift_jint());
@@ -1062,15 +1130,15 @@ void ShenandoahBarrierSetAssembler::gen_load_reference_barrier_stub(LIR_Assemble
   ce->store_parameter(addr, 1);
   if (is_strong) {
     if (is_native) {
-      __ call(RuntimeAddress(bs->load_reference_barrier_strong_native_rt_code_blob()->code_begin()));
+      __ call(RuntimeAddress(bs->load_reference_barrier_strong_native_rt_code_blob(save_fpu_registers)->code_begin()));
     } else {
-      __ call(RuntimeAddress(bs->load_reference_barrier_strong_rt_code_blob()->code_begin()));
+      __ call(RuntimeAddress(bs->load_reference_barrier_strong_rt_code_blob(save_fpu_registers)->code_begin()));
     }
   } else if (is_weak) {
-    __ call(RuntimeAddress(bs->load_reference_barrier_weak_rt_code_blob()->code_begin()));
+    __ call(RuntimeAddress(bs->load_reference_barrier_weak_rt_code_blob(save_fpu_registers)->code_begin()));
   } else {
     assert(is_phantom, "only remaining strength");
-    __ call(RuntimeAddress(bs->load_reference_barrier_phantom_rt_code_blob()->code_begin()));
+    __ call(RuntimeAddress(bs->load_reference_barrier_phantom_rt_code_blob(save_fpu_registers)->code_begin()));
   }
   __ jmp(*stub->continuation());
 }
@@ -1135,11 +1203,12 @@ void ShenandoahBarrierSetAssembler::generate_c1_pre_barrier_runtime_stub(StubAss
   __ epilogue();
 }
 
-void ShenandoahBarrierSetAssembler::generate_c1_load_reference_barrier_runtime_stub(StubAssembler* sasm, DecoratorSet decorators) {
+void ShenandoahBarrierSetAssembler::generate_c1_load_reference_barrier_runtime_stub(StubAssembler* sasm, DecoratorSet decorators,
+                                                                                    bool save_fpu_registers) {
   __ prologue("shenandoah_load_reference_barrier", false);
   // arg0 : object to be resolved
 
-  __ save_live_registers_no_oop_map(true);
+  __ save_live_registers_no_oop_map(save_fpu_registers);
 
   bool is_strong  = ShenandoahBarrierSet::is_strong_access(decorators);
   bool is_weak    = ShenandoahBarrierSet::is_weak_access(decorators);
@@ -1184,7 +1253,7 @@ void ShenandoahBarrierSetAssembler::generate_c1_load_reference_barrier_runtime_s
   }
 #endif
 
-  __ restore_live_registers_except_rax(true);
+  __ restore_live_registers_except_rax(save_fpu_registers);
 
   __ epilogue();
 }
@@ -58,8 +58,13 @@ private:
                                     bool expand_call);
 
   void iu_barrier_impl(MacroAssembler* masm, Register dst, Register tmp);
+#ifdef _LP64
+  void test_marked(MacroAssembler* masm, Register obj, Register tmp1, Register tmp2,
+                   DecoratorSet decorators, Label& L_not_marked);
+#endif
 
   void store_check(MacroAssembler* masm, Register obj);
+  void store_check_filter(MacroAssembler* masm, Register val, Register tmp, Label& L_skip);
 
   void gen_write_ref_array_post_barrier(MacroAssembler* masm, DecoratorSet decorators,
                                         Register addr, Register count,
@@ -71,7 +76,7 @@ public:
   void gen_pre_barrier_stub(LIR_Assembler* ce, ShenandoahPreBarrierStub* stub);
   void gen_load_reference_barrier_stub(LIR_Assembler* ce, ShenandoahLoadReferenceBarrierStub* stub);
   void generate_c1_pre_barrier_runtime_stub(StubAssembler* sasm);
-  void generate_c1_load_reference_barrier_runtime_stub(StubAssembler* sasm, DecoratorSet decorators);
+  void generate_c1_load_reference_barrier_runtime_stub(StubAssembler* sasm, DecoratorSet decorators, bool save_fpu_registers);
 #endif
 
   void load_reference_barrier(MacroAssembler* masm, Register dst, Address src, DecoratorSet decorators);
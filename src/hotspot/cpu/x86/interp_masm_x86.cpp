@@ -1521,6 +1521,21 @@ void InterpreterMacroAssembler::increment_mdp_data_at(Address data,
     jcc(Assembler::negative, L);
     addptr(data, DataLayout::counter_increment);
     bind(L);
+  } else if (LP64_ONLY(ProfileInterpreterSampleRate > 1) NOT_LP64(false)) {
+#ifdef _LP64
+    // Only every ProfileInterpreterSampleRate-th update on this thread is
+    // recorded, weighted accordingly, so threads seldom write the shared counters.
+    Label L;
+    Address countdown(r15_thread, JavaThread::profile_sample_countdown_offset());
+    decrementl(countdown);
+    jccb(Assembler::notZero, L);
+    movl(countdown, ProfileInterpreterSampleRate);
+    addptr(data, ProfileInterpreterSampleRate);
+    // If the increment causes the counter to overflow, saturate.
+    jccb(Assembler::carryClear, L);
+    movptr(data, -1);
+    bind(L);
+#endif // _LP64
   } else {
     assert(DataLayout::counter_increment == 1,
            "flow-free idiom only works with 1");
@@ -1871,6 +1871,14 @@ void os::pd_realign_memory(char *addr, size_t bytes, size_t alignment_hint) {
 void os::pd_free_memory(char *addr, size_t bytes, size_t alignment_hint) {
 }
 
+bool os::pd_free_memory_lazily(char *addr, size_t bytes) {
+  return false;
+}
+
+size_t os::pd_request_huge_pages(char *addr, size_t bytes) {
+  return 0;
+}
+
 void os::numa_make_global(char *addr, size_t bytes) {
 }
 
@@ -1573,6 +1573,14 @@ void os::pd_free_memory(char *addr, size_t bytes, size_t alignment_hint) {
   ::madvise(addr, bytes, MADV_DONTNEED);
 }
 
+bool os::pd_free_memory_lazily(char *addr, size_t bytes) {
+  return ::madvise(addr, bytes, MADV_FREE) == 0;
+}
+
+size_t os::pd_request_huge_pages(char *addr, size_t bytes) {
+  return 0;
+}
+
 void os::numa_make_global(char *addr, size_t bytes) {
 }
 
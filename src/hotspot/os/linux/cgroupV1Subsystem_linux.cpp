@@ -214,6 +214,12 @@ jlong CgroupV1Subsystem::memory_max_usage_in_bytes() {
   return memmaxusage;
 }
 
+jlong CgroupV1Subsystem::memory_stall_time_us() {
+  // Pressure stall information is only accounted per cgroup in v2.
+  log_trace(os, container)("Memory Stall Time is not supported.");
+  return OSCONTAINER_ERROR; // not supported
+}
+
 
 jlong CgroupV1Subsystem::kernel_memory_usage_in_bytes() {
   GET_CONTAINER_INFO(jlong, _memory->controller(), "/memory.kmem.usage_in_bytes",
@@ -139,6 +139,22 @@ jlong CgroupV2Subsystem::memory_max_usage_in_bytes() {
   return OSCONTAINER_ERROR; // not supported
 }
 
+/* memory_stall_time_us
+ *
+ * Return the total time some tasks of this cgroup were stalled waiting
+ * for memory, from the pressure stall information in memory.pressure.
+ *
+ * return:
+ *    stall time in microseconds or
+ *    OSCONTAINER_ERROR for not supported
+ */
+jlong CgroupV2Subsystem::memory_stall_time_us() {
+  GET_CONTAINER_INFO_LINE(jlong, _unified, "/memory.pressure", "some",
+                          "Memory Stall Time is: " JLONG_FORMAT,
+                          "%*s %*s %*s total=" JLONG_FORMAT, stall_us);
+  return stall_us;
+}
+
 char* CgroupV2Subsystem::mem_soft_limit_val() {
   GET_CONTAINER_INFO_CPTR(cptr, _unified, "/memory.low",
                          "Memory Soft Limit is: %s", "%1023s", mem_soft_limit_str, 1024);
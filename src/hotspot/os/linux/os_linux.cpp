@@ -2875,6 +2875,25 @@ void os::pd_free_memory(char *addr, size_t bytes, size_t alignment_hint) {
   }
 }
 
+bool os::pd_free_memory_lazily(char *addr, size_t bytes) {
+#ifdef MADV_FREE
+  // MADV_FREE is only supported since Linux 4.5, older kernels fail with EINVAL.
+  return ::madvise(addr, bytes, MADV_FREE) == 0;
+#else
+  return false;
+#endif
+}
+
+size_t os::pd_request_huge_pages(char *addr, size_t bytes) {
+  // Works in THP mode "madvise" as well as "always". Memory committed later
+  // with mmap(MAP_FIXED) is a new mapping, and needs to be advised again.
+  const size_t thp_size = HugePages::thp_pagesize();
+  if (!HugePages::supports_thp() || thp_size <= vm_page_size()) {
+    return 0;
+  }
+  return ::madvise(addr, bytes, MADV_HUGEPAGE) == 0 ? thp_size : 0;
+}
+
 void os::numa_make_global(char *addr, size_t bytes) {
   Linux::numa_interleave_memory(addr, bytes);
 }
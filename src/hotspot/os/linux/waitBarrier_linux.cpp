@@ -23,8 +23,10 @@
  */
 
 #include "precompiled.hpp"
+#include "runtime/globals.hpp"
 #include "runtime/orderAccess.hpp"
 #include "runtime/os.hpp"
+#include "runtime/thread.hpp"
 #include "waitBarrier_linux.hpp"
 #include <sys/syscall.h>
 #include <linux/futex.h>
@@ -49,31 +51,54 @@ static int futex(volatile int *addr, int futex_op, int op_arg) {
   return syscall(SYS_futex, addr, futex_op, op_arg, nullptr, nullptr, 0);
 }
 
+static void futex_wake(volatile int* addr, int count) {
+  int s = futex(addr, FUTEX_WAKE_PRIVATE, count /* wake a max of this many threads */);
+  guarantee_with_errno(s > -1, "futex FUTEX_WAKE failed");
+}
+
+int LinuxWaitBarrier::cell_index() {
+  uintptr_t hash = p2i(Thread::current_or_null());
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  if (UseNUMA) {
+    int node = os::numa_get_group_id();
+    return (node * CellsPerNode + (int)(hash % CellsPerNode)) % CellCount;
+  }
+  return (int)(hash % CellCount);
+}
+
 void LinuxWaitBarrier::arm(int barrier_tag) {
-  assert(_futex_barrier == 0, "Should not be already armed: "
-         "_futex_barrier=%d", _futex_barrier);
-  _futex_barrier = barrier_tag;
+  for (int i = 0; i < CellCount; i++) {
+    assert(_cells[i]._futex_barrier == 0, "Should not be already armed: "
+           "_futex_barrier=%d", _cells[i]._futex_barrier);
+    _cells[i]._futex_barrier = barrier_tag;
+  }
   OrderAccess::fence();
 }
 
 void LinuxWaitBarrier::disarm() {
-  assert(_futex_barrier != 0, "Should be armed/non-zero.");
-  _futex_barrier = 0;
-  int s = futex(&_futex_barrier,
-                FUTEX_WAKE_PRIVATE,
-                INT_MAX /* wake a max of this many threads */);
-  guarantee_with_errno(s > -1, "futex FUTEX_WAKE failed");
+  for (int i = 0; i < CellCount; i++) {
+    assert(_cells[i]._futex_barrier != 0, "Should be armed/non-zero.");
+    _cells[i]._futex_barrier = 0;
+  }
+  // Every waiter that is woken wakes WakeFanOut more waiters of its cell (see
+  // wait()), so waking WakeFanOut per cell here eventually wakes all of them:
+  // no new waiter can enqueue once its cell has been disarmed.
+  for (int i = 0; i < CellCount; i++) {
+    futex_wake(&_cells[i]._futex_barrier, WakeFanOut);
+  }
 }
 
 void LinuxWaitBarrier::wait(int barrier_tag) {
   assert(barrier_tag != 0, "Trying to wait on disarmed value");
+  volatile int* futex_barrier = &_cells[cell_index()]._futex_barrier;
   if (barrier_tag == 0 ||
-      barrier_tag != _futex_barrier) {
+      barrier_tag != *futex_barrier) {
     OrderAccess::fence();
     return;
   }
   do {
-    int s = futex(&_futex_barrier,
+    int s = futex(futex_barrier,
                   FUTEX_WAIT_PRIVATE,
                   barrier_tag /* should be this tag */);
     guarantee_with_errno((s == 0) ||
@@ -83,5 +108,8 @@ void LinuxWaitBarrier::wait(int barrier_tag) {
     // Return value 0: woken up, but re-check in case of spurious wakeup.
     // Error EINTR: woken by signal, so re-check and re-wait if necessary.
     // Error EAGAIN: we are already disarmed and so will pass the check.
-  } while (barrier_tag == _futex_barrier);
+  } while (barrier_tag == *futex_barrier);
+
+  // Pass the wakeup on to the rest of this cell.
+  futex_wake(futex_barrier, WakeFanOut);
 }
@@ -26,18 +26,39 @@
 #define OS_LINUX_WAITBARRIER_LINUX_HPP
 
 #include "memory/allocation.hpp"
+#include "memory/padded.hpp"
 #include "utilities/globalDefinitions.hpp"
 
+// Waiters are spread over several futex words, each on its own cache line,
+// grouped by NUMA node when UseNUMA is on. Disarming wakes a few waiters in
+// each cell, and every woken waiter wakes a few more of its cell. This keeps
+// the disarming thread from waking thousands of threads by itself, staggers
+// the wakeups, and keeps the futex words from bouncing between sockets.
 class LinuxWaitBarrier : public CHeapObj<mtInternal> {
-  volatile int _futex_barrier;
+  static const int CellCount     = 16;
+  static const int CellsPerNode  = 4;
+  static const int WakeFanOut    = 2;
+
+  struct Cell {
+    volatile int _futex_barrier;
+    DEFINE_PAD_MINUS_SIZE(0, DEFAULT_CACHE_LINE_SIZE, sizeof(int));
+  };
+
+  Cell _cells[CellCount];
+
+  static int cell_index();
 
   NONCOPYABLE(LinuxWaitBarrier);
 
  public:
-  LinuxWaitBarrier() : _futex_barrier(0) {};
+  LinuxWaitBarrier() {
+    for (int i = 0; i < CellCount; i++) {
+      _cells[i]._futex_barrier = 0;
+    }
+  };
   ~LinuxWaitBarrier() {};
 
-  const char* description() { return "futex"; }
+  const char* description() { return "futex cells"; }
 
   void arm(int barrier_tag);
   void disarm();
@@ -3785,6 +3785,8 @@ bool os::unguard_memory(char* addr, size_t bytes) {
 
 void os::pd_realign_memory(char *addr, size_t bytes, size_t alignment_hint) { }
 void os::pd_free_memory(char *addr, size_t bytes, size_t alignment_hint) { }
+bool os::pd_free_memory_lazily(char *addr, size_t bytes)               { return false; }
+size_t os::pd_request_huge_pages(char *addr, size_t bytes)             { return 0; }
 void os::numa_make_global(char *addr, size_t bytes)    { }
 void os::numa_make_local(char *addr, size_t bytes, int lgrp_hint)    { }
 bool os::numa_topology_changed()                       { return false; }
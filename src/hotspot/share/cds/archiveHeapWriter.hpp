@@ -64,12 +64,15 @@ class ArchiveHeapWriter : AllStatic {
     int _field_offset;
   };
 
+public:
   // The minimum region size of all collectors that are supported by CDS in
   // ArchiveHeapLoader::can_map() mode. Currently only G1 is supported. G1's region size
   // depends on -Xmx, but can never be smaller than 1 * M.
   // (TODO: Perhaps change to 256K to be compatible with Shenandoah)
   static constexpr int MIN_GC_REGION_ALIGNMENT = 1 * M;
 
+private:
+
   // "source" vs "buffered" vs "requested"
   //
   // [1] HeapShared::archive_objects() identifies all of the oops that need to be stored
@@ -95,6 +95,10 @@
            "(2) always map at preferred address, and if unsuccessful, "     \
            "do not map the archive")                                        \
            range(0, 2)                                                      \
+                                                                            \
+  product(bool, ArchiveParallelRelocation, true, DIAGNOSTIC,                \
+          "Use the GC worker threads to relocate pointers in the CDS "      \
+          "archive when it is not mapped at the requested address")         \
 // end of CDS_FLAGS
 
 DECLARE_FLAGS(CDS_FLAGS)
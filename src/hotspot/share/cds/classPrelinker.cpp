@@ -31,6 +31,7 @@
 #include "oops/constantPool.inline.hpp"
 #include "oops/instanceKlass.hpp"
 #include "oops/klass.inline.hpp"
+#include "oops/objArrayKlass.hpp"
 #include "runtime/handles.inline.hpp"
 
 ClassPrelinker::ClassesTable* ClassPrelinker::_processed_classes = nullptr;
@@ -86,6 +87,25 @@ bool ClassPrelinker::can_archive_resolved_klass(InstanceKlass* cp_holder, Klass*
   assert(!is_in_archivebuilder_buffer(cp_holder), "sanity");
   assert(!is_in_archivebuilder_buffer(resolved_klass), "sanity");
 
+  if (resolved_klass->is_typeArray_klass()) {
+    // Primitive array classes are the same for all loaders.
+    return true;
+  }
+
+  if (resolved_klass->is_objArray_klass()) {
+    // An array class is resolved by resolving its bottom class, so it is as safe to
+    // archive as the bottom class is. Only do this for the static archive, which
+    // contains all array classes that exist at dump time.
+    if (!DumpSharedSpaces) {
+      return false;
+    }
+    Klass* bottom = ObjArrayKlass::cast(resolved_klass)->bottom_klass();
+    if (bottom->is_typeArray_klass()) {
+      return true;
+    }
+    resolved_klass = bottom;
+  }
+
   if (resolved_klass->is_instance_klass()) {
     InstanceKlass* ik = InstanceKlass::cast(resolved_klass);
     if (is_vm_class(ik)) { // These are safe to resolve. See is_vm_class declaration.
@@ -106,8 +126,6 @@ bool ClassPrelinker::can_archive_resolved_klass(InstanceKlass* cp_holder, Klass*
       // ik is defined in this loader, so it's safe to archive the resolved klass reference.
       return true;
     }
-
-    // TODO -- allow objArray classes, too
   }
 
   return false;
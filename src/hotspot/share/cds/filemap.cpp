@@ -42,6 +42,8 @@
 #include "classfile/systemDictionaryShared.hpp"
 #include "classfile/vmClasses.hpp"
 #include "classfile/vmSymbols.hpp"
+#include "gc/shared/collectedHeap.hpp"
+#include "gc/shared/workerThread.hpp"
 #include "jvm.h"
 #include "logging/log.hpp"
 #include "logging/logStream.hpp"
@@ -57,6 +59,7 @@
 #include "oops/oop.inline.hpp"
 #include "prims/jvmtiExport.hpp"
 #include "runtime/arguments.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/globals_extension.hpp"
 #include "runtime/java.hpp"
 #include "runtime/mutexLocker.hpp"
@@ -1858,6 +1861,32 @@ char* FileMapInfo::map_bitmap_region() {
   return bitmap_base;
 }
 
+// Relocates the marked pointers stripe by stripe, so the work can be spread over worker threads.
+class SharedDataRelocationTask : public WorkerTask {
+  // Bits of the relocation bitmap claimed at a time: 512KB of archive on 64-bit.
+  static const size_t stripe_bits = 64 * K;
+
+  BitMapView* const _ptrmap;
+  SharedDataRelocator* const _patcher;
+  volatile size_t _next;
+
+public:
+  SharedDataRelocationTask(BitMapView* ptrmap, SharedDataRelocator* patcher) :
+    WorkerTask("CDS Relocation"), _ptrmap(ptrmap), _patcher(patcher), _next(0) {}
+
+  static uint stripes(BitMapView* ptrmap) {
+    return (uint)MIN2(align_up(ptrmap->size(), stripe_bits) / stripe_bits, (size_t)max_juint);
+  }
+
+  void work(uint worker_id) {
+    const size_t size = _ptrmap->size();
+    for (size_t beg = Atomic::fetch_then_add(&_next, stripe_bits); beg < size;
+         beg = Atomic::fetch_then_add(&_next, stripe_bits)) {
+      _ptrmap->iterate(_patcher, beg, MIN2(beg + stripe_bits, size));
+    }
+  }
+};
+
 // This is called when we cannot map the archive at the requested[ base address (usually 0x800000000).
 // We relocate all pointers in the 2 core regions (ro, rw).
 bool FileMapInfo::relocate_pointers_in_core_regions(intx addr_delta) {
@@ -1890,7 +1919,23 @@ bool FileMapInfo::relocate_pointers_in_core_regions(intx addr_delta) {
 
     SharedDataRelocator patcher((address*)patch_base, (address*)patch_end, valid_old_base, valid_old_end,
                                 valid_new_base, valid_new_end, addr_delta);
-    ptrmap.iterate(&patcher);
+
+    // The heap is already initialized, so its worker threads can share the patching.
+    jlong start = os::javaTimeNanos();
+    WorkerThreads* workers = ArchiveParallelRelocation ? Universe::heap()->safepoint_workers() : nullptr;
+    uint num_workers = 1;
+    if (workers != nullptr && workers->created_workers() > 0) {
+      num_workers = MIN2(workers->max_workers(), SharedDataRelocationTask::stripes(&ptrmap));
+    }
+    if (num_workers > 1) {
+      SharedDataRelocationTask task(&ptrmap, &patcher);
+      workers->run_task(&task, num_workers);
+    } else {
+      ptrmap.iterate(&patcher);
+    }
+    log_info(cds, reloc)("Relocated %s archive pointers in %.3f ms with %u thread(s)",
+                         is_static() ? "static" : "dynamic",
+                         (double)(os::javaTimeNanos() - start) / NANOSECS_PER_MILLISEC, num_workers);
 
     // The MetaspaceShared::bm region will be unmapped in MetaspaceShared::initialize_shared_spaces().
 
@@ -63,6 +63,7 @@
 #include "memory/classLoaderMetaspace.hpp"
 #include "memory/metadataFactory.hpp"
 #include "memory/metaspace.hpp"
+#include "memory/metaspace/metaspaceArenaGrowthPolicy.hpp"
 #include "memory/resourceArea.hpp"
 #include "memory/universe.hpp"
 #include "oops/access.inline.hpp"
@@ -820,8 +821,12 @@ ClassLoaderMetaspace* ClassLoaderData::metaspace_non_null() {
         metaspace = new ClassLoaderMetaspace(_metaspace_lock, Metaspace::ClassMirrorHolderMetaspaceType);
       } else if (class_loader()->is_a(vmClasses::reflect_DelegatingClassLoader_klass())) {
         metaspace = new ClassLoaderMetaspace(_metaspace_lock, Metaspace::ReflectionMetaspaceType);
-      } else {
+      } else if (is_builtin_class_loader_data()) {
         metaspace = new ClassLoaderMetaspace(_metaspace_lock, Metaspace::StandardMetaspaceType);
+      } else {
+        // Size the arenas after earlier loaders of the same class.
+        const unsigned size_hint_key = metaspace::ArenaSizeHints::key_for(class_loader_klass()->name());
+        metaspace = new ClassLoaderMetaspace(_metaspace_lock, Metaspace::StandardMetaspaceType, size_hint_key);
       }
       // Ensure _metaspace is stable, since it is examined without a lock
       Atomic::release_store(&_metaspace, metaspace);
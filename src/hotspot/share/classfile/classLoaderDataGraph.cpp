@@ -463,8 +463,8 @@ void ClassLoaderDataGraph::clean_module_and_package_info() {
   }
 }
 
-void ClassLoaderDataGraph::purge(bool at_safepoint) {
-  ClassUnloadingContext::context()->purge_class_loader_data();
+void ClassLoaderDataGraph::purge(bool at_safepoint, WorkerThreads* workers) {
+  ClassUnloadingContext::context()->purge_class_loader_data(workers);
 
   bool classes_unloaded = ClassUnloadingContext::context()->has_unloaded_classes();
 
@@ -30,6 +30,8 @@
 #include "utilities/growableArray.hpp"
 #include "utilities/macros.hpp"
 
+class WorkerThreads;
+
 // GC root for walking class loader data created
 
 class ClassLoaderDataGraph : public AllStatic {
@@ -62,7 +64,8 @@ class ClassLoaderDataGraph : public AllStatic {
   static ClassLoaderData* find_or_create(Handle class_loader);
   static ClassLoaderData* add(Handle class_loader, bool has_class_mirror_holder);
   static void clean_module_and_package_info();
-  static void purge(bool at_safepoint);
+  // If workers is not null, the unloaded class loader data may be deleted in parallel.
+  static void purge(bool at_safepoint, WorkerThreads* workers = nullptr);
   static void clear_claimed_marks();
   static void clear_claimed_marks(int claim);
   static void verify_claimed_marks_cleared(int claim);
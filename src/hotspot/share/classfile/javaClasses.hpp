@@ -156,8 +156,16 @@ class java_lang_String : AllStatic {
   // hash P(31) from Kernighan & Ritchie
   //
   // For this reason, THIS ALGORITHM MUST MATCH String.hashCode().
+  //
+  // Four elements are folded in per step, using precomputed powers of 31, so the
+  // multiplications are independent of each other. Arithmetic is modulo 2^32, so
+  // the result is the same as for the one-element-at-a-time loop.
   static unsigned int hash_code(const jchar* s, int len) {
     unsigned int h = 0;
+    for (; len >= 4; len -= 4, s += 4) {
+      h = 923521 * h + 29791 * (unsigned int) s[0] + 961 * (unsigned int) s[1] +
+          31 * (unsigned int) s[2] + (unsigned int) s[3];
+    }
     while (len-- > 0) {
       h = 31*h + (unsigned int) *s;
       s++;
@@ -167,6 +175,10 @@ class java_lang_String : AllStatic {
 
   static unsigned int hash_code(const jbyte* s, int len) {
     unsigned int h = 0;
+    for (; len >= 4; len -= 4, s += 4) {
+      h = 923521 * h + 29791 * (((unsigned int) s[0]) & 0xFF) + 961 * (((unsigned int) s[1]) & 0xFF) +
+          31 * (((unsigned int) s[2]) & 0xFF) + (((unsigned int) s[3]) & 0xFF);
+    }
     while (len-- > 0) {
       h = 31*h + (((unsigned int) *s) & 0xFF);
       s++;
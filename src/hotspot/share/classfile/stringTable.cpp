@@ -110,6 +110,8 @@ typedef ConcurrentHashTable<StringTableConfig, mtSymbol> StringTableHash;
 static StringTableHash* _local_table = nullptr;
 
 volatile bool StringTable::_has_work = false;
+volatile bool StringTable::_parallel_cleanup_requested = false;
+bool StringTable::_parallel_cleanup_enabled = false;
 volatile bool StringTable::_needs_rehashing = false;
 OopStorage*   StringTable::_oop_storage;
 
@@ -492,9 +494,18 @@ void StringTable::gc_notification(size_t num_dead) {
   if ((dead_factor > load_factor) ||
       (load_factor > PREF_AVG_LIST_LEN) ||
       (dead_factor > CLEAN_DEAD_HIGH_WATER_MARK)) {
-    log_debug(stringtable)("Concurrent work triggered, live factor: %g dead factor: %g",
-                           load_factor, dead_factor);
-    trigger_concurrent_work();
+    // Growing is left to the service thread, and so is cleaning if the previous
+    // request has not been picked up by a parallel cleanup yet.
+    if (_parallel_cleanup_enabled && load_factor <= PREF_AVG_LIST_LEN &&
+        !Atomic::load(&_parallel_cleanup_requested)) {
+      log_debug(stringtable)("Parallel cleanup requested, live factor: %g dead factor: %g",
+                             load_factor, dead_factor);
+      Atomic::release_store(&_parallel_cleanup_requested, true);
+    } else {
+      log_debug(stringtable)("Concurrent work triggered, live factor: %g dead factor: %g",
+                             load_factor, dead_factor);
+      trigger_concurrent_work();
+    }
   }
 }
 
@@ -514,6 +525,74 @@ void StringTable::do_concurrent_work(JavaThread* jt) {
   Atomic::release_store(&_has_work, false);
 }
 
+// Parallel cleanup
+class StringTableParallelCleanup : public CHeapObj<mtSymbol> {
+ public:
+  StringTableHash::BulkDeleteTask _bdt;
+  volatile size_t _count;
+  volatile size_t _item;
+  volatile bool _exhausted;  // All buckets have been claimed.
+  StringTableParallelCleanup() :
+    _bdt(_local_table, true /* is_mt */), _count(0), _item(0), _exhausted(false) {}
+};
+
+static StringTableParallelCleanup* _parallel_cleanup = nullptr;
+
+void StringTable::enable_parallel_cleanup() {
+  _parallel_cleanup_enabled = true;
+}
+
+bool StringTable::start_parallel_cleanup(Thread* thread) {
+  assert(_parallel_cleanup == nullptr, "Only one parallel cleanup at a time");
+  if (!Atomic::load_acquire(&_parallel_cleanup_requested)) {
+    return false;
+  }
+  Atomic::store(&_parallel_cleanup_requested, false);
+  if (has_work()) {
+    // The service thread got there first.
+    return false;
+  }
+  StringTableParallelCleanup* cleanup = new StringTableParallelCleanup();
+  if (!cleanup->_bdt.prepare(thread)) {
+    delete cleanup;
+    return false;
+  }
+  log_trace(stringtable)("Started parallel cleanup");
+  _parallel_cleanup = cleanup;
+  return true;
+}
+
+bool StringTable::do_parallel_cleanup(Thread* thread) {
+  StringTableDeleteCheck stdc;
+  StringTableDoDelete stdd;
+  NativeHeapTrimmer::SuspendMark sm("stringtable");
+  bool more = _parallel_cleanup->_bdt.do_task(thread, stdc, stdd);
+  Atomic::add(&_parallel_cleanup->_count, (size_t)stdc._count);
+  Atomic::add(&_parallel_cleanup->_item, (size_t)stdc._item);
+  if (!more) {
+    Atomic::store(&_parallel_cleanup->_exhausted, true);
+  }
+  return more;
+}
+
+void StringTable::finish_parallel_cleanup(Thread* thread) {
+  StringTableParallelCleanup* cleanup = _parallel_cleanup;
+  cleanup->_bdt.done(thread);
+  _parallel_cleanup = nullptr;
+  log_debug(stringtable)("Cleaned " SIZE_FORMAT " of " SIZE_FORMAT " in parallel",
+                         cleanup->_count, cleanup->_item);
+  if (!cleanup->_exhausted) {
+    // Interrupted, pick up the rest next time.
+    Atomic::release_store(&_parallel_cleanup_requested, true);
+  }
+  delete cleanup;
+
+  if (!has_work() && should_grow()) {
+    log_debug(stringtable)("Concurrent work triggered, live factor: %g", get_load_factor());
+    trigger_concurrent_work();
+  }
+}
+
 // Rehash
 bool StringTable::do_rehash() {
   if (!_local_table->is_safepoint_safe()) {
@@ -49,6 +49,10 @@ class StringTable : public CHeapObj<mtSymbol>{
 
   static volatile bool _has_work;
 
+  // Set if dead entries are left to the next parallel cleanup, see start_parallel_cleanup().
+  static volatile bool _parallel_cleanup_requested;
+  static bool _parallel_cleanup_enabled;
+
   // Set if one bucket is out of balance due to hash algorithm deficiency
   static volatile bool _needs_rehashing;
 
@@ -86,6 +90,18 @@ class StringTable : public CHeapObj<mtSymbol>{
   static void do_concurrent_work(JavaThread* jt);
   static bool has_work();
 
+  // Parallel cleanup of dead entries by GC worker threads, in place of the
+  // service thread. Once enabled, GC notifications that only call for
+  // cleaning are left to the next parallel cleanup. The coordinating thread
+  // calls start_parallel_cleanup(), and if that returns true, any number of
+  // threads call do_parallel_cleanup() until it returns false, after which
+  // the coordinating thread calls finish_parallel_cleanup(). The latter
+  // triggers the service thread if the table should grow.
+  static void enable_parallel_cleanup();
+  static bool start_parallel_cleanup(Thread* thread);
+  static bool do_parallel_cleanup(Thread* thread);
+  static void finish_parallel_cleanup(Thread* thread);
+
   // Probing
   static oop lookup(Symbol* symbol);
   static oop lookup(const jchar* chars, int length);
@@ -99,6 +99,14 @@ static volatile bool _lookup_shared_first = false;
 // "_lookup_shared_first" can get highly contended with many cores if multiple threads
 // are updating "lookup success history" in a global shared variable. If built-in TLS is available, use it.
 static THREAD_LOCAL bool _lookup_shared_first = false;
+
+// A small direct-mapped cache of symbols this thread looked up recently, indexed by hash.
+// Only permanent and shared symbols are cached: they are never freed, so an entry can be
+// validated by comparing contents, and the lookup does not need to adjust its refcount.
+// These are the bulk of the names and signatures looked up while parsing JDK classes.
+static const uint SymbolCacheSize = 64;
+static THREAD_LOCAL Symbol* _symbol_cache[SymbolCacheSize];
+#define USE_SYMBOL_CACHE
 #endif
 
 // Static arena for symbols that are not deallocated
@@ -318,6 +326,13 @@ Symbol* SymbolTable::lookup_shared(const char* name,
 
 Symbol* SymbolTable::lookup_common(const char* name,
                             int len, unsigned int hash) {
+#ifdef USE_SYMBOL_CACHE
+  Symbol** const slot = &_symbol_cache[hash & (SymbolCacheSize - 1)];
+  Symbol* const cached = *slot;
+  if (cached != nullptr && cached->equals(name, len)) {
+    return cached;
+  }
+#endif
   Symbol* sym;
   if (_lookup_shared_first) {
     sym = lookup_shared(name, len, hash);
@@ -334,6 +349,11 @@ Symbol* SymbolTable::lookup_common(const char* name,
       }
     }
   }
+#ifdef USE_SYMBOL_CACHE
+  if (sym != nullptr && (sym->is_permanent() || sym->is_shared())) {
+    *slot = sym;
+  }
+#endif
   return sym;
 }
 
@@ -791,6 +811,65 @@ void SymbolTable::do_concurrent_work(JavaThread* jt) {
   _has_work = false;
 }
 
+// Parallel cleanup
+class SymbolTableParallelCleanup : public CHeapObj<mtSymbol> {
+ public:
+  SymbolTableHash::BulkDeleteTask _bdt;
+  volatile size_t _deleted;
+  volatile size_t _processed;
+  volatile bool _exhausted;  // All buckets have been claimed.
+  SymbolTableParallelCleanup() :
+    _bdt(_local_table, true /* is_mt */), _deleted(0), _processed(0), _exhausted(false) {}
+};
+
+static SymbolTableParallelCleanup* _parallel_cleanup = nullptr;
+
+bool SymbolTable::start_parallel_cleanup(Thread* thread) {
+  assert(_parallel_cleanup == nullptr, "Only one parallel cleanup at a time");
+  if (_has_work || !has_items_to_clean() || should_grow()) {
+    return false;
+  }
+  SymbolTableParallelCleanup* cleanup = new SymbolTableParallelCleanup();
+  if (!cleanup->_bdt.prepare(thread)) {
+    delete cleanup;
+    return false;
+  }
+  log_trace(symboltable)("Started parallel cleanup");
+  _parallel_cleanup = cleanup;
+  return true;
+}
+
+bool SymbolTable::do_parallel_cleanup(Thread* thread) {
+  SymbolTableDeleteCheck stdc;
+  SymbolTableDoDelete stdd;
+  NativeHeapTrimmer::SuspendMark sm("symboltable");
+  bool more = _parallel_cleanup->_bdt.do_task(thread, stdc, stdd);
+  Atomic::add(&_parallel_cleanup->_deleted, stdd._deleted);
+  Atomic::add(&_parallel_cleanup->_processed, stdc._processed);
+  if (!more) {
+    Atomic::store(&_parallel_cleanup->_exhausted, true);
+  }
+  return more;
+}
+
+void SymbolTable::finish_parallel_cleanup(Thread* thread) {
+  SymbolTableParallelCleanup* cleanup = _parallel_cleanup;
+  if (cleanup->_exhausted) {
+    reset_has_items_to_clean();
+  }
+  cleanup->_bdt.done(thread);
+  _parallel_cleanup = nullptr;
+  Atomic::add(&_symbols_counted, cleanup->_processed);
+  log_debug(symboltable)("Cleaned " SIZE_FORMAT " of " SIZE_FORMAT " in parallel",
+                         cleanup->_deleted, cleanup->_processed);
+  delete cleanup;
+
+  if (!_has_work && should_grow()) {
+    log_debug(symboltable)("Concurrent work triggered, load factor: %f", get_load_factor());
+    trigger_cleanup();
+  }
+}
+
 // Rehash
 bool SymbolTable::do_rehash() {
   if (!_local_table->is_safepoint_safe()) {
@@ -117,6 +117,13 @@ public:
   static bool has_work() { return _has_work; }
   static void trigger_cleanup();
 
+  // Parallel cleanup of dead entries by GC worker threads, see the
+  // StringTable counterparts. Starts only if there are items to clean and
+  // the table does not need to grow, which is left to the service thread.
+  static bool start_parallel_cleanup(Thread* thread);
+  static bool do_parallel_cleanup(Thread* thread);
+  static void finish_parallel_cleanup(Thread* thread);
+
   // Probing
   // Needed for preloading classes in signatures when compiling.
   // Returns the symbol is already present in symbol table, otherwise
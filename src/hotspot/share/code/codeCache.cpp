@@ -451,6 +451,9 @@ void CodeCache::add_heap(ReservedSpace rs, const char* name, CodeBlobType code_b
   // Create CodeHeap
   CodeHeap* heap = new CodeHeap(name, code_blob_type);
   add_heap(heap);
+  if (NonProfiledCodeHeapHugePages && code_blob_type == CodeBlobType::MethodNonProfiled) {
+    heap->set_huge_pages();
+  }
 
   // Reserve Space
   size_t size_initial = MIN2((size_t)InitialCodeCacheSize, rs.size());
@@ -1362,15 +1365,19 @@ void CodeCache::mark_for_deoptimization(DeoptimizationScope* deopt_scope, Method
   }
 }
 
-void CodeCache::make_marked_nmethods_deoptimized() {
+// Returns the number of compiled methods that were made not entrant.
+int CodeCache::make_marked_nmethods_deoptimized() {
+  int count = 0;
   RelaxedCompiledMethodIterator iter(RelaxedCompiledMethodIterator::only_not_unloading);
   while(iter.next()) {
     CompiledMethod* nm = iter.method();
     if (nm->is_marked_for_deoptimization() && !nm->has_been_deoptimized() && nm->can_be_deoptimized()) {
       nm->make_not_entrant();
       nm->make_deoptimized();
+      count++;
     }
   }
+  return count;
 }
 
 // Marks compiled methods dependent on dependee.
@@ -1723,6 +1730,9 @@ void CodeCache::print_summary(outputStream* st, bool detailed) {
                    p2i(heap->low_boundary()),
                    p2i(heap->high()),
                    p2i(heap->high_boundary()));
+      if (heap->huge_page_size() > 0) {
+        st->print_cr(" transparent huge pages requested, page size=" SIZE_FORMAT "Kb", heap->huge_page_size()/K);
+      }
 
       full_count += get_codemem_full_count(heap->code_blob_type());
     }
@@ -1799,6 +1809,40 @@ void CodeCache::write_perf_map() {
 }
 #endif // LINUX
 
+// Write a CompileCommandFile that scales down the compile thresholds of all
+// methods with C2 code. It does not carry profiles: a next run that reads it
+// still profiles these methods, but gets them to C2 much sooner.
+void CodeCache::write_hot_methods(const char* path) {
+  MutexLocker mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
+
+  fileStream fs(path, "w");
+  if (!fs.is_open()) {
+    log_warning(codecache)("Failed to create %s for hot methods", path);
+    return;
+  }
+
+  int count = 0;
+  NMethodIterator iter(NMethodIterator::only_not_unloading);
+  while (iter.next()) {
+    nmethod* nm = iter.method();
+    if (!nm->is_in_use() || nm->is_osr_method() ||
+        nm->comp_level() != CompLevel_full_optimization) {
+      continue;
+    }
+    Method* m = nm->method();
+    if (m->method_holder()->is_hidden()) {
+      // Hidden class names differ between runs.
+      continue;
+    }
+    ResourceMark rm;
+    fs.print_cr("CompileThresholdScaling %s.%s%s %f",
+                m->klass_name()->as_C_string(), m->name()->as_C_string(),
+                m->signature()->as_C_string(), HotMethodsThresholdScaling);
+    count++;
+  }
+  log_info(codecache)("Wrote %d hot methods to %s", count, path);
+}
+
 //---<  BEGIN  >--- CodeHeap State Analytics.
 
 void CodeCache::aggregate(outputStream *out, size_t granularity) {
@@ -230,6 +230,7 @@ class CodeCache : AllStatic {
   static void print_summary(outputStream* st, bool detailed = true); // Prints a summary of the code cache usage
   static void log_state(outputStream* st);
   LINUX_ONLY(static void write_perf_map();)
+  static void write_hot_methods(const char* path);
   static const char* get_code_heap_name(CodeBlobType code_blob_type)  { return (heap_available(code_blob_type) ? get_code_heap(code_blob_type)->name() : "Unused"); }
   static void report_codemem_full(CodeBlobType code_blob_type, bool print);
 
@@ -305,7 +306,7 @@ class CodeCache : AllStatic {
  public:
   static void mark_all_nmethods_for_deoptimization(DeoptimizationScope* deopt_scope);
   static void mark_for_deoptimization(DeoptimizationScope* deopt_scope, Method* dependee);
-  static void make_marked_nmethods_deoptimized();
+  static int make_marked_nmethods_deoptimized();
 
   // Marks dependents during classloading
   static void mark_dependents_on(DeoptimizationScope* deopt_scope, InstanceKlass* dependee);
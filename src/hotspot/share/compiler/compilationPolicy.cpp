@@ -41,6 +41,7 @@
 #include "runtime/handles.inline.hpp"
 #include "runtime/safepoint.hpp"
 #include "runtime/safepointVerifiers.hpp"
+#include "runtime/timer.hpp"
 #ifdef COMPILER1
 #include "c1/c1_Compiler.hpp"
 #endif
@@ -237,6 +238,7 @@ public:
     case CompLevel_limited_profile:
       return b >= Tier3BackEdgeThreshold * scale;
     case CompLevel_full_profile:
+      scale *= CompilationPolicy::recompilation_backoff(method);
       return b >= Tier4BackEdgeThreshold * scale;
     default:
       return true;
@@ -276,6 +278,7 @@ public:
       return (i >= Tier3InvocationThreshold * scale) ||
              (i >= Tier3MinInvocationThreshold * scale && i + b >= Tier3CompileThreshold * scale);
     case CompLevel_full_profile:
+      scale *= CompilationPolicy::recompilation_backoff(method);
       return (i >= Tier4InvocationThreshold * scale) ||
              (i >= Tier4MinInvocationThreshold * scale && i + b >= Tier4CompileThreshold * scale);
     default:
@@ -323,6 +326,23 @@ double CompilationPolicy::threshold_scale(CompLevel level, int feedback_k) {
   return 1;
 }
 
+// Every deoptimization of a method's compiled code, whether from an uncommon trap or
+// from invalidated dependencies, doubles its tier 4 thresholds, up to
+// Tier4RecompilationBackoff times. After a mass invalidation this spreads the
+// recompilation of the affected methods out instead of flooding the C2 queue, and
+// methods that keep getting invalidated settle in profiled code.
+double CompilationPolicy::recompilation_backoff(const methodHandle& method) {
+  if (Tier4RecompilationBackoff == 0) {
+    return 1;
+  }
+  MethodData* mdo = method->method_data();
+  if (mdo == nullptr) {
+    return 1;
+  }
+  uint shift = MIN2(mdo->decompile_count(), (uint)Tier4RecompilationBackoff);
+  return (double)((jlong)1 << shift);
+}
+
 void CompilationPolicy::print_counters(const char* prefix, const Method* m) {
   int invocation_count = m->invocation_count();
   int backedge_count = m->backedge_count();
@@ -621,9 +641,11 @@ void CompilationPolicy::handle_counter_overflow(const methodHandle& method) {
 CompileTask* CompilationPolicy::select_task(CompileQueue* compile_queue) {
   CompileTask *max_blocking_task = nullptr;
   CompileTask *max_task = nullptr;
+  CompileTask *starved_task = nullptr;
   Method* max_method = nullptr;
 
   jlong t = nanos_to_millis(os::javaTimeNanos());
+  const jlong now = os::elapsed_counter();
   // Iterate through the queue and find a method with a maximum rate.
   for (CompileTask* task = compile_queue->first(); task != nullptr;) {
     CompileTask* next_task = task->next();
@@ -658,9 +680,21 @@ CompileTask* CompilationPolicy::select_task(CompileQueue* compile_queue) {
       }
     }
 
+    // Hot methods keep arriving during warm-up, don't let them starve the others.
+    if (TieredCompileTaskMaxWait > 0 &&
+        TimeHelper::counter_to_millis(now - task->time_queued()) > TieredCompileTaskMaxWait &&
+        (starved_task == nullptr || task->time_queued() < starved_task->time_queued())) {
+      starved_task = task;
+    }
+
     task = next_task;
   }
 
+  if (starved_task != nullptr) {
+    max_task = starved_task;
+    max_method = max_task->method();
+  }
+
   if (max_blocking_task != nullptr) {
     // In blocking compilation mode, the CompileBroker will make
     // compilations submitted by a JVMCI compiler thread non-blocking. These
@@ -839,7 +873,12 @@ void CompilationPolicy::update_rate(jlong t, const methodHandle& method) {
     if (delta_t >= TieredRateUpdateMinTime && delta_e > 0) {
       method->set_prev_time(t);
       method->set_prev_event_count(event_count);
-      method->set_rate((float)delta_e / (float)delta_t); // Rate is events per millisecond
+      float rate = (float)delta_e / (float)delta_t; // Rate is events per millisecond
+      if (TieredRateDecayPercentage > 0) {
+        float k = TieredRateDecayPercentage / 100.0f;
+        rate = k * method->rate() + (1.0f - k) * rate;
+      }
+      method->set_rate(rate);
     } else {
       if (delta_t > TieredRateUpdateMaxTime && delta_e == 0) {
         // If nothing happened for 25ms, zero the rate. Don't modify prev values.
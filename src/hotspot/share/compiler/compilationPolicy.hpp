@@ -210,6 +210,8 @@ class CompilationPolicy : AllStatic {
   inline static void update_rate(jlong t, const methodHandle& method);
   // Compute threshold scaling coefficient
   inline static double threshold_scale(CompLevel level, int feedback_k);
+  // Scale the tier 4 thresholds of a method whose compiled code was deoptimized before
+  static double recompilation_backoff(const methodHandle& method);
   // If a method is old enough and is still in the interpreter we would want to
   // start profiling without waiting for the compiled method to arrive. This function
   // determines whether we should do that.
@@ -1009,19 +1009,28 @@ void CompileBroker::init_compiler_threads() {
 #endif // defined(ASSERT) && COMPILER2_OR_JVMCI
 }
 
+// The compiler thread counts are sized for the processors available at startup.
+// When the container CPU quota has since been lowered, add no more threads than
+// the same share of the processors available now.
+static int fit_to_processors(int count, int active_cpus) {
+  int initial_cpus = os::initial_active_processor_count();
+  return (active_cpus < initial_cpus) ? MAX2(1, count * active_cpus / initial_cpus) : count;
+}
+
 void CompileBroker::possibly_add_compiler_threads(JavaThread* THREAD) {
 
   julong free_memory = os::free_memory();
   // If SegmentedCodeCache is off, both values refer to the single heap (with type CodeBlobType::All).
   size_t available_cc_np  = CodeCache::unallocated_capacity(CodeBlobType::MethodNonProfiled),
          available_cc_p   = CodeCache::unallocated_capacity(CodeBlobType::MethodProfiled);
+  int active_cpus = os::active_processor_count();
 
   // Only do attempt to start additional threads if the lock is free.
   if (!CompileThread_lock->try_lock()) return;
 
   if (_c2_compile_queue != nullptr) {
     int old_c2_count = _compilers[1]->num_compiler_threads();
-    int new_c2_count = MIN4(_c2_count,
+    int new_c2_count = MIN4(fit_to_processors(_c2_count, active_cpus),
         _c2_compile_queue->size() / 2,
         (int)(free_memory / (200*M)),
         (int)(available_cc_np / (128*K)));
@@ -1079,7 +1088,7 @@ void CompileBroker::possibly_add_compiler_threads(JavaThread* THREAD) {
 
   if (_c1_compile_queue != nullptr) {
     int old_c1_count = _compilers[0]->num_compiler_threads();
-    int new_c1_count = MIN4(_c1_count,
+    int new_c1_count = MIN4(fit_to_processors(_c1_count, active_cpus),
         _c1_compile_queue->size() / 4,
         (int)(free_memory / (100*M)),
         (int)(available_cc_p / (128*K)));
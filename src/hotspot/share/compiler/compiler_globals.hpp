@@ -212,6 +212,12 @@
           "Back edge threshold at which tier 4 OSR compilation is invoked") \
           range(0, max_jint)                                                \
                                                                             \
+  product(intx, Tier4RecompilationBackoff, 0, EXPERIMENTAL,                 \
+          "Double the tier 4 thresholds of a method for each time its "     \
+          "compiled code was deoptimized, up to this many times. "          \
+          "0 disables the backoff")                                         \
+          range(0, 16)                                                      \
+                                                                            \
   product(intx, Tier0Delay, 20, DIAGNOSTIC,                                 \
           "If C2 queue size grows over this amount per compiler thread "    \
           "do not start profiling in the interpreter")                      \
@@ -248,6 +254,18 @@
           "given timeout in milliseconds")                                  \
           range(0, max_intx)                                                \
                                                                             \
+  product(intx, TieredCompileTaskMaxWait, 1000,                             \
+          "Select the oldest compile task that has been waiting for "       \
+          "longer than the given time in milliseconds before the one "      \
+          "with the highest rate. 0 disables")                              \
+          range(0, max_intx)                                                \
+                                                                            \
+  product(intx, TieredRateDecayPercentage, 0,                               \
+          "Percentage of the previous event rate of a method kept in a "    \
+          "new rate sample, so that the rate decays instead of only "       \
+          "reflecting the last interval")                                   \
+          range(0, 99)                                                      \
+                                                                            \
   product(intx, TieredStopAtLevel, 4,                                       \
           "Stop at given compilation level")                                \
           range(0, 4)                                                       \
@@ -299,6 +317,15 @@
   product(ccstr, CompileCommandFile, nullptr,                               \
           "Read compiler commands from this file [.hotspot_compiler]")      \
                                                                             \
+  product(ccstr, DumpHotMethodsAtExit, nullptr,                             \
+          "At exit, write a CompileCommandFile that lowers the compile "    \
+          "thresholds of methods that have C2 code, so that a next run "    \
+          "using the file compiles them early")                             \
+                                                                            \
+  product(double, HotMethodsThresholdScaling, 0.01,                         \
+          "CompileThresholdScaling written by DumpHotMethodsAtExit")        \
+          range(0.0001, 1.0)                                                \
+                                                                            \
   product(ccstr, CompilerDirectivesFile, nullptr, DIAGNOSTIC,               \
           "Read compiler directives from this file")                        \
                                                                             \
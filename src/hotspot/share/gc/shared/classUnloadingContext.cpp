@@ -27,6 +27,8 @@
 #include "classfile/classLoaderData.inline.hpp"
 #include "code/nmethod.hpp"
 #include "gc/shared/classUnloadingContext.hpp"
+#include "gc/shared/workerThread.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "utilities/growableArray.hpp"
 
@@ -75,7 +77,47 @@ void ClassUnloadingContext::register_unloading_class_loader_data(ClassLoaderData
   _cld_head = cld;
 }
 
-void ClassUnloadingContext::purge_class_loader_data() {
+// Deletes class loader data collected from the unloading list. Each deletion releases the
+// metaspace arenas of the class loader data to the ChunkManager, its C heap structures and
+// its handles, all of which are safe to do concurrently for distinct class loader data.
+class ClassUnloadingContext::PurgeClassLoaderDataTask : public WorkerTask {
+  GrowableArrayCHeap<ClassLoaderData*, mtGC>* _clds;
+  volatile int _claimed;
+
+public:
+  PurgeClassLoaderDataTask(GrowableArrayCHeap<ClassLoaderData*, mtGC>* clds) :
+    WorkerTask("Purge Class Loader Data"),
+    _clds(clds),
+    _claimed(0) {}
+
+  void work(uint worker_id) {
+    for (int i = Atomic::fetch_then_add(&_claimed, 1);
+         i < _clds->length();
+         i = Atomic::fetch_then_add(&_claimed, 1)) {
+      delete _clds->at(i);
+    }
+  }
+};
+
+void ClassUnloadingContext::purge_class_loader_data(WorkerThreads* workers) {
+  // Below this many class loader data per worker, starting the workers costs more than
+  // the deletion itself.
+  const int clds_per_worker = 16;
+
+  if (workers != nullptr && workers->active_workers() > 1) {
+    GrowableArrayCHeap<ClassLoaderData*, mtGC> clds;
+    for (ClassLoaderData* cld = _cld_head; cld != nullptr; cld = cld->unloading_next()) {
+      assert(cld->is_unloading(), "invariant");
+      clds.append(cld);
+    }
+    uint num_workers = MIN2(workers->active_workers(), (uint)(clds.length() / clds_per_worker));
+    if (num_workers > 1) {
+      PurgeClassLoaderDataTask task(&clds);
+      workers->run_task(&task, num_workers);
+      return;
+    }
+  }
+
   for (ClassLoaderData* cld = _cld_head; cld != nullptr;) {
     assert(cld->is_unloading(), "invariant");
 
@@ -31,6 +31,7 @@
 class ClassLoaderData;
 class Klass;
 class nmethod;
+class WorkerThreads;
 
 class ClassUnloadingContext : public CHeapObj<mtGC> {
   static ClassUnloadingContext* _context;
@@ -45,6 +46,8 @@ class ClassUnloadingContext : public CHeapObj<mtGC> {
   bool _unregister_nmethods_during_purge;
   bool _lock_codeblob_free_separately;
 
+  class PurgeClassLoaderDataTask;
+
 public:
   static ClassUnloadingContext* context() { assert(_context != nullptr, "context not set"); return _context; }
 
@@ -64,7 +67,9 @@ public:
   bool has_unloaded_classes() const;
 
   void register_unloading_class_loader_data(ClassLoaderData* cld);
-  void purge_class_loader_data();
+  // Deletes the unloading class loader data. If workers is not null, and there is
+  // enough class loader data to share, the deletion is spread over the workers.
+  void purge_class_loader_data(WorkerThreads* workers = nullptr);
 
   void classes_unloading_do(void f(Klass* const));
 
@@ -163,6 +163,11 @@ class CollectedHeap : public CHeapObj<mtGC> {
   virtual HeapWord* mem_allocate(size_t size,
                                  bool* gc_overhead_limit_was_exceeded) = 0;
 
+  // Returns true if the memory at mem, which the calling thread has just obtained
+  // from mem_allocate(), is known to be zeroed already, so that initializing the
+  // object does not need to clear it.
+  virtual bool is_zeroed_allocation(HeapWord* mem) const { return false; }
+
   // Filler object utilities.
   static inline size_t filler_array_hdr_size();
   static inline size_t filler_array_min_size();
@@ -284,6 +289,9 @@ class CollectedHeap : public CHeapObj<mtGC> {
 
   oop obj_allocate(Klass* klass, size_t size, TRAPS);
   virtual oop array_allocate(Klass* klass, size_t size, int length, bool do_zero, TRAPS);
+  // Allocates up to count zeroed arrays back to back in the current TLAB of the thread,
+  // see MemAllocator::allocate_in_tlab(). The length must have been checked.
+  size_t array_allocate_in_tlab(Klass* klass, size_t size, int length, oop* results, size_t count, Thread* thread);
   oop class_allocate(Klass* klass, size_t size, TRAPS);
 
   // Utilities for turning raw memory into filler objects.
@@ -350,6 +358,13 @@ class CollectedHeap : public CHeapObj<mtGC> {
     return 0;
   }
 
+  // Adjusts the desired size of the next TLAB of the given thread, which is
+  // based on the allocation history of the thread, to the current state of
+  // the heap, e.g. the phase of a concurrent collection. Sizes are in words.
+  virtual size_t adjust_tlab_size(Thread* thr, size_t desired_size) const {
+    return desired_size;
+  }
+
   // If a GC uses a stack watermark barrier, the stack processing is lazy, concurrent,
   // incremental and cooperative. In order for that to work well, mechanisms that stop
   // another thread might want to ensure its roots are in a sane state.
@@ -466,6 +481,10 @@ class CollectedHeap : public CHeapObj<mtGC> {
 
   virtual void print_on_error(outputStream* st) const;
 
+  // Print a class histogram of live objects that the heap recorded earlier, without
+  // inspecting the heap now. Returns false if the heap has none.
+  virtual bool print_class_histogram_snapshot(outputStream* st) const { return false; }
+
   // Used to print information about locations in the hs_err file.
   virtual bool print_location(outputStream* st, void* addr) const = 0;
 
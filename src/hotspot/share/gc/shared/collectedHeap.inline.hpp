@@ -41,6 +41,12 @@ inline oop CollectedHeap::array_allocate(Klass* klass, size_t size, int length,
   return allocator.allocate();
 }
 
+inline size_t CollectedHeap::array_allocate_in_tlab(Klass* klass, size_t size, int length,
+                                                    oop* results, size_t count, Thread* thread) {
+  ObjArrayAllocator allocator(klass, size, length, true /* do_zero */, thread);
+  return allocator.allocate_in_tlab(results, count);
+}
+
 inline oop CollectedHeap::class_allocate(Klass* klass, size_t size, TRAPS) {
   ClassAllocator allocator(klass, size, THREAD);
   return allocator.allocate();
@@ -244,6 +244,7 @@ HeapWord* MemAllocator::mem_allocate_outside_tlab(Allocation& allocation) const
 
   size_t size_in_bytes = _word_size * HeapWordSize;
   _thread->incr_allocated_bytes(size_in_bytes);
+  _mem_zeroed = Universe::heap()->is_zeroed_allocation(mem);
 
   return mem;
 }
@@ -376,12 +377,33 @@ oop MemAllocator::allocate() const {
   return obj;
 }
 
+size_t MemAllocator::allocate_in_tlab(oop* results, size_t count) const {
+  assert(!Universe::heap()->is_gc_active(), "Allocation during gc not allowed");
+  if (!UseTLAB || DTraceAllocProbes || JvmtiExport::should_post_vm_object_alloc()) {
+    return 0;
+  }
+
+  size_t allocated = 0;
+  HeapWord* mem = _thread->tlab().allocate_bulk(_word_size, count, &allocated);
+  if (mem == nullptr) {
+    return 0;
+  }
+  for (size_t i = 0; i < allocated; i++) {
+    results[i] = initialize(mem + i * _word_size);
+  }
+  // The only notification the regular path makes for an allocation in the current TLAB.
+  LowMemoryDetector::detect_low_memory_for_collected_pools();
+  return allocated;
+}
+
 void MemAllocator::mem_clear(HeapWord* mem) const {
   assert(mem != nullptr, "cannot initialize null object");
   const size_t hs = oopDesc::header_size();
   assert(_word_size >= hs, "unexpected object size");
   oopDesc::set_klass_gap(mem, 0);
-  Copy::fill_to_aligned_words(mem + hs, _word_size - hs);
+  if (!_mem_zeroed) {
+    Copy::fill_to_aligned_words(mem + hs, _word_size - hs);
+  }
 }
 
 oop MemAllocator::finish(HeapWord* mem) const {
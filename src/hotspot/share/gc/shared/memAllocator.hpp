@@ -42,6 +42,9 @@ protected:
   Klass* const         _klass;
   const size_t         _word_size;
 
+  // Set when the heap reports that the memory allocated outside a TLAB is already zeroed.
+  mutable bool         _mem_zeroed;
+
   // Allocate from the current thread's TLAB, without taking a new TLAB (no safepoint).
  HeapWord* mem_allocate_inside_tlab_fast() const;
 
@@ -60,7 +63,8 @@ protected:
   MemAllocator(Klass* klass, size_t word_size, Thread* thread)
     : _thread(thread),
       _klass(klass),
-      _word_size(word_size)
+      _word_size(word_size),
+      _mem_zeroed(false)
   { }
 
   // Initialization provided by subclasses.
@@ -81,6 +85,12 @@ protected:
 public:
   // Allocate and fully construct the object, and perform various instrumentation. Could safepoint.
   oop allocate() const;
+
+  // Allocate and fully construct up to count objects back to back in the current TLAB, with a
+  // single bounds check. Never safepoints, so the caller must publish the objects before it
+  // can. Allocates nothing if instrumentation wants to see every allocation. Returns the
+  // number of objects stored in results.
+  size_t allocate_in_tlab(oop* results, size_t count) const;
 };
 
 class ObjAllocator: public MemAllocator {
@@ -25,6 +25,7 @@
 #include "precompiled.hpp"
 #include "gc/shared/oopStorage.inline.hpp"
 #include "gc/shared/oopStorageParState.inline.hpp"
+#include "gc/shared/oopStorageSet.hpp"
 #include "logging/log.hpp"
 #include "logging/logStream.hpp"
 #include "memory/allocation.inline.hpp"
@@ -222,7 +223,10 @@ OopStorage::Block::Block(const OopStorage* owner, void* memory) :
   _active_index(0),
   _allocation_list_entry(),
   _deferred_updates_next(nullptr),
-  _release_refcount(0)
+  _release_refcount(0),
+  _change_count(0),
+  _settled_count(0),
+  _settled_epoch(0)
 {
   STATIC_ASSERT(_data_pos == 0);
   STATIC_ASSERT(section_size * section_count == ARRAY_SIZE(_data));
@@ -328,6 +332,7 @@ oop* OopStorage::Block::allocate() {
   unsigned index = count_trailing_zeros(~allocated);
   // Use atomic update because release may change bitmask.
   atomic_add_allocated(bitmask_for_index(index));
+  note_change();
   return get_pointer(index);
 }
 
@@ -336,6 +341,7 @@ uintx OopStorage::Block::allocate_all() {
   assert(new_allocated != 0, "attempt to allocate from full block");
   // Use atomic update because release may change bitmask.
   atomic_add_allocated(new_allocated);
+  note_change();
   return new_allocated;
 }
 
@@ -386,6 +392,33 @@ OopStorage::Block::block_for_ptr(const OopStorage* owner, const oop* ptr) {
   return nullptr;
 }
 
+// Like block_for_ptr(), but accepts any of the weak storages as the owner.
+OopStorage::Block*
+OopStorage::Block::block_for_weak_ptr(const oop* ptr) {
+  oop* section_start = align_down(const_cast<oop*>(ptr), block_alignment);
+  oop* section = section_start - (section_size * (section_count - 1));
+  for (unsigned i = 0; i < section_count; ++i, section += section_size) {
+    Block* candidate = reinterpret_cast<Block*>(section);
+    intptr_t owner_addr = SafeFetchN(&candidate->_owner_address, 0);
+    if (owner_addr == 0) {
+      continue;
+    }
+    for (OopStorage* storage : OopStorageSet::Range<OopStorageSet::WeakId>()) {
+      if (owner_addr == reinterpret_cast<intptr_t>(storage)) {
+        return candidate;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void OopStorage::note_weak_store(const oop* ptr) {
+  Block* block = Block::block_for_weak_ptr(ptr);
+  if (block != nullptr) {
+    block->note_change();
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 // Allocation
 //
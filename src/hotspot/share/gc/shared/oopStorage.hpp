@@ -210,6 +210,13 @@ public:
   // request.
   static bool has_cleanup_work_and_reset();
 
+  // Notes a store into an entry of one of the weak storages, so that the
+  // containing block is no longer considered settled by a later
+  // ParState::oops_do_settling().  ptr need not be an allocated entry;
+  // does nothing if ptr is not in any weak storage.  All weak storages
+  // must have been created.
+  static void note_weak_store(const oop* ptr);
+
   // Debugging and logging support.
   const char* name() const;
   void print_on(outputStream* st) const PRODUCT_RETURN;
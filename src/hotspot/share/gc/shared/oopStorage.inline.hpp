@@ -144,6 +144,11 @@ class OopStorage::Block /* No base class, to avoid messing up alignment. */ {
   Block* volatile _deferred_updates_next;
   volatile uintx _release_refcount;
 
+  // Settled block summary, see ParState::oops_do_settling().
+  volatile uintx _change_count;   // Bumped by allocations and noted stores.
+  volatile uintx _settled_count;  // _change_count + 1 when settled.
+  volatile uintx _settled_epoch;  // Epoch of the GC iteration that settled the block.
+
   Block(const OopStorage* owner, void* memory);
   ~Block();
 
@@ -186,10 +191,18 @@ public:
 
   // Returns null if ptr is not in a block or not allocated in that block.
   static Block* block_for_ptr(const OopStorage* owner, const oop* ptr);
+  // Returns null if ptr is not in a block of one of the weak storages.
+  static Block* block_for_weak_ptr(const oop* ptr);
 
   oop* allocate();
   uintx allocate_all();
   static Block* new_block(const OopStorage* owner);
+
+  uintx change_count() const;
+  void note_change();
+  bool is_settled(uintx change_count, uintx epoch) const;
+  void set_settled(uintx change_count, uintx epoch);
+  void clear_settled();
   static void delete_block(const Block& block);
 
   void release_entries(uintx releasing, OopStorage* owner);
@@ -346,6 +359,27 @@ inline bool OopStorage::Block::iterate(F f) {
   return iterate_impl(f, this);
 }
 
+inline uintx OopStorage::Block::change_count() const {
+  return Atomic::load_acquire(&_change_count);
+}
+
+inline void OopStorage::Block::note_change() {
+  Atomic::inc(&_change_count);
+}
+
+inline bool OopStorage::Block::is_settled(uintx change_count, uintx epoch) const {
+  return Atomic::load(&_settled_epoch) == epoch && Atomic::load(&_settled_count) == change_count + 1;
+}
+
+inline void OopStorage::Block::set_settled(uintx change_count, uintx epoch) {
+  Atomic::store(&_settled_epoch, epoch);
+  Atomic::store(&_settled_count, change_count + 1);
+}
+
+inline void OopStorage::Block::clear_settled() {
+  Atomic::store(&_settled_count, uintx(0));
+}
+
 template<typename F>
 inline bool OopStorage::Block::iterate(F f) const {
   return iterate_impl(f, this);
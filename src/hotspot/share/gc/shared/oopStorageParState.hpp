@@ -85,16 +85,17 @@
 //   concurrent ParState, empty block deletion for the associated storage
 //   is inhibited for the life of the ParState.
 //
-// template<typename F> void iterate(F f)
+// template<typename F> size_t iterate(F f)
 //   Repeatedly claims a block from the associated storage that has
 //   not been processed by this iteration (possibly by other threads),
 //   and applies f to each entry in the claimed block. Assume p is of
 //   type const oop* or oop*, according to is_const. Then f(p) must be
 //   a valid expression whose value is ignored.  Concurrent uses must
 //   be prepared for an entry's value to change at any time, due to
-//   mutator activity.
+//   mutator activity.  Returns the number of blocks claimed by the
+//   calling thread.
 //
-// template<typename Closure> void oops_do(Closure* cl)
+// template<typename Closure> size_t oops_do(Closure* cl)
 //   Wrapper around iterate, providing an adaptation layer allowing
 //   the use of OopClosures and similar objects for iteration.  Assume
 //   p is of type const oop* or oop*, according to is_const.  Then
@@ -102,6 +103,20 @@
 //   Concurrent uses must be prepared for the entry's value to change
 //   at any time, due to mutator activity.
 //
+// template<typename Closure, typename SettledFn>
+// size_t oops_do_settling(Closure* cl, SettledFn settled, uintx epoch, bool skip_settled)
+//   Like oops_do, but also maintains a per-block summary.  After cl
+//   has been applied to an entry p, settled(p) is evaluated; if it is
+//   true for every entry of a block, the block is recorded as settled
+//   in the given epoch.  A settled block stays settled until an entry
+//   is allocated in it, or until OopStorage::note_weak_store() is
+//   called for one of its entries.  If skip_settled is true, blocks
+//   settled in the same epoch are not visited at all.  Returns the
+//   number of skipped blocks.  The caller is responsible for choosing
+//   settled and epoch such that skipping a settled block is never
+//   observable, e.g. a new epoch whenever the meaning of settled(p)
+//   changes.
+//
 // Optional operations, provided only if !concurrent && !is_const.
 // These are not provided when is_const, because the storage object
 // may be modified by the iteration infrastructure, even if the
@@ -156,7 +171,10 @@ public:
 
   const OopStorage* storage() const { return _storage; }
 
-  template<bool is_const, typename F> void iterate(F f);
+  // Returns the number of blocks claimed by the calling thread.
+  template<bool is_const, typename F> size_t iterate(F f);
+  template<typename F, typename SettledFn>
+  size_t iterate_settling(F f, SettledFn settled, uintx epoch, bool skip_settled);
 
   static uint default_estimated_thread_count(bool concurrent);
 
@@ -178,8 +196,10 @@ public:
   {}
 
   const OopStorage* storage() const { return _basic_state.storage(); }
-  template<typename F> void iterate(F f);
-  template<typename Closure> void oops_do(Closure* cl);
+  template<typename F> size_t iterate(F f);
+  template<typename Closure> size_t oops_do(Closure* cl);
+  template<typename Closure, typename SettledFn>
+  size_t oops_do_settling(Closure* cl, SettledFn settled, uintx epoch, bool skip_settled);
 
   size_t num_dead() const { return _basic_state.num_dead(); }
   void increment_num_dead(size_t num_dead) { _basic_state.increment_num_dead(num_dead); }
@@ -197,8 +217,8 @@ public:
   {}
 
   const OopStorage* storage() const { return _basic_state.storage(); }
-  template<typename F> void iterate(F f);
-  template<typename Closure> void oops_do(Closure* cl);
+  template<typename F> size_t iterate(F f);
+  template<typename Closure> size_t oops_do(Closure* cl);
   template<typename Closure> void weak_oops_do(Closure* cl);
   template<typename IsAliveClosure, typename Closure>
   void weak_oops_do(IsAliveClosure* is_alive, Closure* cl);
@@ -50,7 +50,7 @@ struct OopStorage::BasicParState::IterationData {
 };
 
 template<bool is_const, typename F>
-inline void OopStorage::BasicParState::iterate(F f) {
+inline size_t OopStorage::BasicParState::iterate(F f) {
   // Wrap f in ATF so we can use Block::iterate.
   AlwaysTrueFn<F> atf_f(f);
   IterationData data = {};      // zero initialize.
@@ -64,28 +64,72 @@ inline void OopStorage::BasicParState::iterate(F f) {
       block->iterate(atf_f);
     } while (++i < data._segment_end);
   }
+  return data._processed;
+}
+
+template<typename F, typename SettledFn>
+inline size_t OopStorage::BasicParState::iterate_settling(F f, SettledFn settled,
+                                                          uintx epoch, bool skip_settled) {
+  size_t skipped = 0;
+  IterationData data = {};      // zero initialize.
+  while (claim_next_segment(&data)) {
+    assert(data._segment_start < data._segment_end, "invariant");
+    assert(data._segment_end <= _block_count, "invariant");
+    size_t i = data._segment_start;
+    do {
+      Block* block = _active_array->at(i);
+      // Sample the change count before looking at the entries. A store noted
+      // after this point makes the summary recorded below stale.
+      uintx changes = block->change_count();
+      if (skip_settled && block->is_settled(changes, epoch)) {
+        skipped++;
+        continue;
+      }
+      bool all_settled = true;
+      block->iterate([&](oop* p) {
+        f(p);
+        all_settled = all_settled && settled(p);
+        return true;
+      });
+      if (all_settled) {
+        block->set_settled(changes, epoch);
+      } else {
+        // The iteration itself may have unsettled the block, e.g. by clearing an entry.
+        block->clear_settled();
+      }
+    } while (++i < data._segment_end);
+  }
+  return skipped;
 }
 
 template<bool concurrent, bool is_const>
 template<typename F>
-inline void OopStorage::ParState<concurrent, is_const>::iterate(F f) {
-  _basic_state.template iterate<is_const>(f);
+inline size_t OopStorage::ParState<concurrent, is_const>::iterate(F f) {
+  return _basic_state.template iterate<is_const>(f);
 }
 
 template<bool concurrent, bool is_const>
 template<typename Closure>
-inline void OopStorage::ParState<concurrent, is_const>::oops_do(Closure* cl) {
-  this->iterate(oop_fn(cl));
+inline size_t OopStorage::ParState<concurrent, is_const>::oops_do(Closure* cl) {
+  return this->iterate(oop_fn(cl));
+}
+
+template<bool concurrent, bool is_const>
+template<typename Closure, typename SettledFn>
+inline size_t OopStorage::ParState<concurrent, is_const>::oops_do_settling(Closure* cl, SettledFn settled,
+                                                                           uintx epoch, bool skip_settled) {
+  STATIC_ASSERT(!is_const);
+  return _basic_state.iterate_settling(oop_fn(cl), settled, epoch, skip_settled);
 }
 
 template<typename F>
-inline void OopStorage::ParState<false, false>::iterate(F f) {
-  _basic_state.template iterate<false>(f);
+inline size_t OopStorage::ParState<false, false>::iterate(F f) {
+  return _basic_state.template iterate<false>(f);
 }
 
 template<typename Closure>
-inline void OopStorage::ParState<false, false>::oops_do(Closure* cl) {
-  this->iterate(oop_fn(cl));
+inline size_t OopStorage::ParState<false, false>::oops_do(Closure* cl) {
+  return this->iterate(oop_fn(cl));
 }
 
 template<typename Closure>
@@ -70,6 +70,11 @@ public:
   template<typename Closure>
   void oops_do(Closure* cl);
 
+  // See OopStorage::ParState::oops_do_settling().  Returns the number of
+  // skipped blocks, over all weak storages.
+  template<typename Closure, typename SettledFn>
+  size_t oops_do_settling(Closure* cl, SettledFn settled, uintx epoch, bool skip_settled);
+
   void report_num_dead();
 };
 
@@ -84,6 +84,25 @@ void OopStorageSetWeakParState<concurrent, is_const>::oops_do(Closure* cl) {
   }
 }
 
+template <bool concurrent, bool is_const>
+template <typename Closure, typename SettledFn>
+size_t OopStorageSetWeakParState<concurrent, is_const>::oops_do_settling(Closure* cl, SettledFn settled,
+                                                                         uintx epoch, bool skip_settled) {
+  size_t skipped = 0;
+  for (auto id : EnumRange<OopStorageSet::WeakId>()) {
+    auto state = this->par_state(id);
+    if (state->storage()->should_report_num_dead()) {
+      // Settled blocks hold no null entries, so skipping them keeps the count exact.
+      DeadCounterClosure<Closure> counting_cl(cl);
+      skipped += state->oops_do_settling(&counting_cl, settled, epoch, skip_settled);
+      state->increment_num_dead(counting_cl.num_dead());
+    } else {
+      skipped += state->oops_do_settling(cl, settled, epoch, skip_settled);
+    }
+  }
+  return skipped;
+}
+
 template <bool concurrent, bool is_const>
 void OopStorageSetWeakParState<concurrent, is_const>::report_num_dead() {
   for (auto id : EnumRange<OopStorageSet::WeakId>()) {
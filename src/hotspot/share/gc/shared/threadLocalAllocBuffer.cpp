@@ -27,12 +27,15 @@
 #include "gc/shared/collectedHeap.hpp"
 #include "gc/shared/threadLocalAllocBuffer.inline.hpp"
 #include "gc/shared/tlab_globals.hpp"
+#include "jfr/jfrEvents.hpp"
+#include "jfr/support/jfrThreadId.hpp"
 #include "logging/log.hpp"
 #include "memory/resourceArea.hpp"
 #include "memory/universe.hpp"
 #include "oops/oop.inline.hpp"
 #include "runtime/atomic.hpp"
 #include "runtime/javaThread.hpp"
+#include "runtime/os.hpp"
 #include "runtime/perfData.hpp"
 #include "runtime/threadSMR.hpp"
 #include "utilities/copy.hpp"
@@ -56,6 +59,7 @@ ThreadLocalAllocBuffer::ThreadLocalAllocBuffer() :
   _gc_waste(0),
   _slow_allocations(0),
   _allocated_size(0),
+  _statistics_start(0),
   _allocation_fraction(TLABAllocationWeight) {
 
   // do nothing. TLABs must be inited by initialize() calls
@@ -113,6 +117,18 @@ void ThreadLocalAllocBuffer::accumulate_and_reset_statistics(ThreadLocalAllocSta
 
   stats->update_slow_allocations(_slow_allocations);
 
+  EventTLABRefills event;
+  if (event.should_commit()) {
+    jlong period = os::javaTimeNanos() - _statistics_start;
+    event.set_thread(JFR_JVM_THREAD_ID(thr));
+    event.set_refills(_number_of_refills);
+    event.set_period(period);
+    event.set_refillRate(period > 0 ? (float)(_number_of_refills * (double)NANOSECS_PER_SEC / period) : 0.0f);
+    event.set_allocated(_allocated_size * HeapWordSize);
+    event.set_desiredSize(desired_size() * HeapWordSize);
+    event.commit();
+  }
+
   reset_statistics();
 }
 
@@ -178,6 +194,7 @@ void ThreadLocalAllocBuffer::reset_statistics() {
   _gc_waste          = 0;
   _slow_allocations  = 0;
   _allocated_size    = 0;
+  _statistics_start  = os::javaTimeNanos();
 }
 
 void ThreadLocalAllocBuffer::fill(HeapWord* start,
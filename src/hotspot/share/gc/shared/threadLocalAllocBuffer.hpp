@@ -67,6 +67,7 @@ private:
   unsigned  _gc_waste;
   unsigned  _slow_allocations;
   size_t    _allocated_size;
+  jlong     _statistics_start;                   // time of the last reset_statistics(), in nanos
 
   AdaptiveWeightedAverage _allocation_fraction;  // fraction of eden allocated in tlabs
 
@@ -133,6 +134,12 @@ public:
   // Allocate size HeapWords. The memory is NOT initialized to zero.
   inline HeapWord* allocate(size_t size);
 
+  // Allocate up to count back to back blocks of size HeapWords, with a single
+  // bounds check. Returns the first block and sets *allocated to the number of
+  // blocks, or returns null if not even one fits. The memory is NOT initialized
+  // to zero.
+  inline HeapWord* allocate_bulk(size_t size, size_t count, size_t* allocated);
+
   // Reserve space at the end of TLAB
   static size_t end_reserve();
   static size_t alignment_reserve()              { return align_object_size(end_reserve()); }
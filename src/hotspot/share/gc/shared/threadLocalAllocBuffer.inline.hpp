@@ -57,12 +57,35 @@ inline HeapWord* ThreadLocalAllocBuffer::allocate(size_t size) {
   return nullptr;
 }
 
+inline HeapWord* ThreadLocalAllocBuffer::allocate_bulk(size_t size, size_t count, size_t* allocated) {
+  assert(size > 0, "must be");
+  invariants();
+  HeapWord* obj = top();
+  size_t n = MIN2(count, pointer_delta(end(), obj) / size);
+  if (n == 0) {
+    return nullptr;
+  }
+#ifdef ASSERT
+  // Same mangling as allocate(), for each block.
+  size_t hdr_size = oopDesc::header_size();
+  for (size_t i = 0; i < n; i++) {
+    Copy::fill_to_words(obj + i * size + hdr_size, size - hdr_size, badHeapWordVal);
+  }
+#endif // ASSERT
+  set_top(obj + n * size);
+
+  invariants();
+  *allocated = n;
+  return obj;
+}
+
 inline size_t ThreadLocalAllocBuffer::compute_size(size_t obj_size) {
   // Compute the size for the new TLAB.
   // The "last" tlab may be smaller to reduce fragmentation.
   // unsafe_max_tlab_alloc is just a hint.
   const size_t available_size = Universe::heap()->unsafe_max_tlab_alloc(thread()) / HeapWordSize;
-  size_t new_tlab_size = MIN3(available_size, desired_size() + align_object_size(obj_size), max_size());
+  const size_t desired = Universe::heap()->adjust_tlab_size(thread(), desired_size());
+  size_t new_tlab_size = MIN3(available_size, desired + align_object_size(obj_size), max_size());
 
   // Make sure there's enough room for object and filler int[].
   if (new_tlab_size < compute_min_size(obj_size)) {
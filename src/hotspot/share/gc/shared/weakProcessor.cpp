@@ -82,12 +82,17 @@ uint WeakProcessor::ergo_workers(uint max_workers) {
   // One thread per ReferencesPerThread references (or fraction thereof)
   // in the various OopStorage objects, bounded by max_threads.
   size_t ref_count = 0;
+  size_t block_count = 0;
   for (OopStorage* storage : OopStorageSet::Range<OopStorageSet::WeakId>()) {
     ref_count += storage->allocation_count();
+    block_count += storage->block_count();
   }
 
   // +1 to (approx) round up the ref per thread division.
   size_t nworkers = 1 + (ref_count / ReferencesPerThread);
+  // Workers claim whole blocks, from any of the storages, so more workers
+  // than blocks can't all get work.
+  nworkers = MIN2(nworkers, MAX2(block_count, static_cast<size_t>(1)));
   nworkers = MIN2(nworkers, static_cast<size_t>(max_workers));
   return static_cast<uint>(nworkers);
 }
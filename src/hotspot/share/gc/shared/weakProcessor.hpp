@@ -70,7 +70,8 @@ public:
                            uint indent_log);
 
   // Uses the total number of weak references and ReferencesPerThread to
-  // determine the number of threads to use, limited by max_workers.
+  // determine the number of threads to use, limited by max_workers and by
+  // the total number of blocks, the unit of parallel work.
   static uint ergo_workers(uint max_workers);
 
   class Task;
@@ -91,6 +92,9 @@ class WeakProcessor::Task {
 
   void initialize();
 
+  template<typename IsAlive, typename KeepAlive>
+  void work_on(OopStorageSet::WeakId id, uint worker_id, IsAlive* is_alive, KeepAlive* keep_alive);
+
 public:
   Task(uint nworkers);          // No time tracking.
   Task(WeakProcessorTimes* times, uint nworkers);
@@ -83,17 +83,38 @@ void WeakProcessor::Task::work(uint worker_id,
          "worker_id (%u) exceeds task's configured workers (%u)",
          worker_id, _nworkers);
 
-  for (auto id : EnumRange<OopStorageSet::WeakId>()) {
-    CountingClosure<IsAlive, KeepAlive> cl(is_alive, keep_alive);
-    WeakProcessorParTimeTracker pt(_times, id, worker_id);
-    StorageState* cur_state = _storage_states.par_state(id);
-    assert(cur_state->storage() == OopStorageSet::storage(id), "invariant");
-    cur_state->oops_do(&cl);
-    cur_state->increment_num_dead(cl.dead());
-    if (_times != nullptr) {
-      _times->record_worker_items(worker_id, id, cl.new_dead(), cl.total());
+  // Spread the workers over the storages, rather than having all of them
+  // start on the first one.  A worker done with its own storage moves on to
+  // the others, claiming blocks left there, so no worker idles while any
+  // storage still has unclaimed blocks.
+  EnumRange<OopStorageSet::WeakId> range;
+  size_t start = (static_cast<size_t>(worker_id) * range.size()) / _nworkers;
+  for (auto id : range) {
+    if (range.index(id) >= start) {
+      work_on(id, worker_id, is_alive, keep_alive);
     }
   }
+  for (auto id : range) {
+    if (range.index(id) < start) {
+      work_on(id, worker_id, is_alive, keep_alive);
+    }
+  }
+}
+
+template<typename IsAlive, typename KeepAlive>
+void WeakProcessor::Task::work_on(OopStorageSet::WeakId id,
+                                  uint worker_id,
+                                  IsAlive* is_alive,
+                                  KeepAlive* keep_alive) {
+  CountingClosure<IsAlive, KeepAlive> cl(is_alive, keep_alive);
+  WeakProcessorParTimeTracker pt(_times, id, worker_id);
+  StorageState* cur_state = _storage_states.par_state(id);
+  assert(cur_state->storage() == OopStorageSet::storage(id), "invariant");
+  size_t num_blocks = cur_state->oops_do(&cl);
+  cur_state->increment_num_dead(cl.dead());
+  if (_times != nullptr) {
+    _times->record_worker_items(worker_id, id, cl.new_dead(), cl.total(), num_blocks);
+  }
 }
 
 class WeakProcessor::WeakOopsDoTask : public WorkerTask {
@@ -56,6 +56,7 @@ WeakProcessorTimes::WeakProcessorTimes(uint max_threads) :
     *wpt = new WorkerDataArray<double>(nullptr, description, _max_threads);
     (*wpt)->create_thread_work_items("Dead", DeadItems);
     (*wpt)->create_thread_work_items("Total", TotalItems);
+    (*wpt)->create_thread_work_items("Blocks", BlockItems);
     wpt++;
   }
   assert(size_t(wpt - _worker_data) == ARRAY_SIZE(_worker_data), "invariant");
@@ -121,10 +122,12 @@ void WeakProcessorTimes::record_worker_time_sec(uint worker_id,
 void WeakProcessorTimes::record_worker_items(uint worker_id,
                                              OopStorageSet::WeakId id,
                                              size_t num_dead,
-                                             size_t num_total) {
+                                             size_t num_total,
+                                             size_t num_blocks) {
   WorkerDataArray<double>* data = worker_data(id);
   data->set_or_add_thread_work_item(worker_id, num_dead, DeadItems);
   data->set_or_add_thread_work_item(worker_id, num_total, TotalItems);
+  data->set_or_add_thread_work_item(worker_id, num_blocks, BlockItems);
 }
 
 static double elapsed_time_sec(Ticks start_time, Ticks end_time) {
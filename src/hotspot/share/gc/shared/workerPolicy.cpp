@@ -179,3 +179,15 @@ uint WorkerPolicy::calc_active_conc_workers(uintx total_workers,
     return no_of_gc_threads;
   }
 }
+
+uint WorkerPolicy::fit_to_active_processors(uint workers) {
+  if (!UseDynamicNumberOfGCThreads) {
+    return workers;
+  }
+  uint initial_cpus = (uint) os::initial_active_processor_count();
+  uint active_cpus = (uint) os::active_processor_count();
+  if (active_cpus >= initial_cpus) {
+    return workers;
+  }
+  return MAX2(1u, workers * active_cpus / initial_cpus);
+}
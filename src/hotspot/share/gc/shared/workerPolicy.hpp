@@ -73,6 +73,11 @@ public:
                                        uintx active_workers,
                                        uintx application_workers);
 
+  // Scale a worker count sized for the processors available at startup
+  // down to the processors available now, e.g. after the container CPU
+  // quota was lowered. Returns the count unchanged otherwise.
+  static uint fit_to_active_processors(uint workers);
+
 };
 
 #endif // SHARE_GC_SHARED_WORKERPOLICY_HPP
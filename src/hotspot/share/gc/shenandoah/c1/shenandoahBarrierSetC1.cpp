@@ -56,7 +56,11 @@ ShenandoahBarrierSetC1::ShenandoahBarrierSetC1() :
   _load_reference_barrier_strong_rt_code_blob(nullptr),
   _load_reference_barrier_strong_native_rt_code_blob(nullptr),
   _load_reference_barrier_weak_rt_code_blob(nullptr),
-  _load_reference_barrier_phantom_rt_code_blob(nullptr) {}
+  _load_reference_barrier_phantom_rt_code_blob(nullptr),
+  _load_reference_barrier_strong_nofpu_rt_code_blob(nullptr),
+  _load_reference_barrier_strong_native_nofpu_rt_code_blob(nullptr),
+  _load_reference_barrier_weak_nofpu_rt_code_blob(nullptr),
+  _load_reference_barrier_phantom_nofpu_rt_code_blob(nullptr) {}
 
 void ShenandoahBarrierSetC1::pre_barrier(LIRGenerator* gen, CodeEmitInfo* info, DecoratorSet decorators, LIR_Opr addr_opr, LIR_Opr pre_val) {
   // First we test whether marking is in progress.
@@ -265,13 +269,15 @@ class C1ShenandoahPreBarrierCodeGenClosure : public StubAssemblerCodeGenClosure
 class C1ShenandoahLoadReferenceBarrierCodeGenClosure : public StubAssemblerCodeGenClosure {
 private:
   const DecoratorSet _decorators;
+  const bool _save_fpu_registers;
 
 public:
-  C1ShenandoahLoadReferenceBarrierCodeGenClosure(DecoratorSet decorators) : _decorators(decorators) {}
+  C1ShenandoahLoadReferenceBarrierCodeGenClosure(DecoratorSet decorators, bool save_fpu_registers) :
+    _decorators(decorators), _save_fpu_registers(save_fpu_registers) {}
 
   virtual OopMapSet* generate_code(StubAssembler* sasm) {
     ShenandoahBarrierSetAssembler* bs = (ShenandoahBarrierSetAssembler*)BarrierSet::barrier_set()->barrier_set_assembler();
-    bs->generate_c1_load_reference_barrier_runtime_stub(sasm, _decorators);
+    bs->generate_c1_load_reference_barrier_runtime_stub(sasm, _decorators, _save_fpu_registers);
     return nullptr;
   }
 };
@@ -282,25 +288,45 @@ void ShenandoahBarrierSetC1::generate_c1_runtime_stubs(BufferBlob* buffer_blob)
                                                               "shenandoah_pre_barrier_slow",
                                                               false, &pre_code_gen_cl);
   if (ShenandoahLoadRefBarrier) {
-    C1ShenandoahLoadReferenceBarrierCodeGenClosure lrb_strong_code_gen_cl(ON_STRONG_OOP_REF);
+    C1ShenandoahLoadReferenceBarrierCodeGenClosure lrb_strong_code_gen_cl(ON_STRONG_OOP_REF, true);
     _load_reference_barrier_strong_rt_code_blob = Runtime1::generate_blob(buffer_blob, -1,
                                                                   "shenandoah_load_reference_barrier_strong_slow",
                                                                   false, &lrb_strong_code_gen_cl);
 
-    C1ShenandoahLoadReferenceBarrierCodeGenClosure lrb_strong_native_code_gen_cl(ON_STRONG_OOP_REF | IN_NATIVE);
+    C1ShenandoahLoadReferenceBarrierCodeGenClosure lrb_strong_native_code_gen_cl(ON_STRONG_OOP_REF | IN_NATIVE, true);
     _load_reference_barrier_strong_native_rt_code_blob = Runtime1::generate_blob(buffer_blob, -1,
                                                                           "shenandoah_load_reference_barrier_strong_native_slow",
                                                                           false, &lrb_strong_native_code_gen_cl);
 
-    C1ShenandoahLoadReferenceBarrierCodeGenClosure lrb_weak_code_gen_cl(ON_WEAK_OOP_REF);
+    C1ShenandoahLoadReferenceBarrierCodeGenClosure lrb_weak_code_gen_cl(ON_WEAK_OOP_REF, true);
     _load_reference_barrier_weak_rt_code_blob = Runtime1::generate_blob(buffer_blob, -1,
                                                                           "shenandoah_load_reference_barrier_weak_slow",
                                                                           false, &lrb_weak_code_gen_cl);
 
-    C1ShenandoahLoadReferenceBarrierCodeGenClosure lrb_phantom_code_gen_cl(ON_PHANTOM_OOP_REF | IN_NATIVE);
+    C1ShenandoahLoadReferenceBarrierCodeGenClosure lrb_phantom_code_gen_cl(ON_PHANTOM_OOP_REF | IN_NATIVE, true);
     _load_reference_barrier_phantom_rt_code_blob = Runtime1::generate_blob(buffer_blob, -1,
                                                                            "shenandoah_load_reference_barrier_phantom_slow",
                                                                            false, &lrb_phantom_code_gen_cl);
+
+    C1ShenandoahLoadReferenceBarrierCodeGenClosure lrb_strong_nofpu_code_gen_cl(ON_STRONG_OOP_REF, false);
+    _load_reference_barrier_strong_nofpu_rt_code_blob = Runtime1::generate_blob(buffer_blob, -1,
+                                                                                "shenandoah_load_reference_barrier_strong_nofpu_slow",
+                                                                                false, &lrb_strong_nofpu_code_gen_cl);
+
+    C1ShenandoahLoadReferenceBarrierCodeGenClosure lrb_strong_native_nofpu_code_gen_cl(ON_STRONG_OOP_REF | IN_NATIVE, false);
+    _load_reference_barrier_strong_native_nofpu_rt_code_blob = Runtime1::generate_blob(buffer_blob, -1,
+                                                                                       "shenandoah_load_reference_barrier_strong_native_nofpu_slow",
+                                                                                       false, &lrb_strong_native_nofpu_code_gen_cl);
+
+    C1ShenandoahLoadReferenceBarrierCodeGenClosure lrb_weak_nofpu_code_gen_cl(ON_WEAK_OOP_REF, false);
+    _load_reference_barrier_weak_nofpu_rt_code_blob = Runtime1::generate_blob(buffer_blob, -1,
+                                                                              "shenandoah_load_reference_barrier_weak_nofpu_slow",
+                                                                              false, &lrb_weak_nofpu_code_gen_cl);
+
+    C1ShenandoahLoadReferenceBarrierCodeGenClosure lrb_phantom_nofpu_code_gen_cl(ON_PHANTOM_OOP_REF | IN_NATIVE, false);
+    _load_reference_barrier_phantom_nofpu_rt_code_blob = Runtime1::generate_blob(buffer_blob, -1,
+                                                                                 "shenandoah_load_reference_barrier_phantom_nofpu_slow",
+                                                                                 false, &lrb_phantom_nofpu_code_gen_cl);
   }
 }
 
@@ -314,10 +340,31 @@ void ShenandoahBarrierSetC1::post_barrier(LIRAccess& access, LIR_Opr addr, LIR_O
     return;
   }
 
-  BarrierSet* bs = BarrierSet::barrier_set();
-  ShenandoahBarrierSet* ctbs = barrier_set_cast<ShenandoahBarrierSet>(bs);
-  CardTable* ct = ctbs->card_table();
-  LIR_Const* card_table_base = new LIR_Const(ct->byte_map_base());
+  // Only old-to-young pointers need a card. An invalid new_val means the stored value is not known.
+  LabelObj* L_skip = nullptr;
+  if (ShenandoahCardBarrierYoungFilter && new_val->is_valid()) {
+    if (new_val->is_constant()) {
+      if (new_val->as_jobject() == nullptr) {
+        return;
+      }
+    } else {
+      assert(new_val->is_register(), "must be a register at this point");
+      L_skip = new LabelObj();
+      __ cmp(lir_cond_equal, new_val, LIR_OprFact::oopConst(nullptr));
+      __ branch(lir_cond_equal, L_skip->label());
+
+      LIR_Opr val_region = gen->new_pointer_register();
+      __ move(new_val, val_region);
+      __ unsigned_shift_right(val_region, ShenandoahHeapRegion::region_size_bytes_shift_jint(), val_region);
+      LIR_Opr affiliations = gen->new_pointer_register();
+      __ move(LIR_OprFact::intptrConst(ShenandoahHeap::affiliations_biased_addr()), affiliations);
+      LIR_Opr affiliation = gen->new_register(T_INT);
+      __ move(new LIR_Address(val_region, affiliations, T_BYTE), affiliation);
+      __ cmp(lir_cond_notEqual, affiliation, LIR_OprFact::intConst(ShenandoahAffiliation::YOUNG_GENERATION));
+      __ branch(lir_cond_notEqual, L_skip->label());
+    }
+  }
+
   if (addr->is_address()) {
     LIR_Address* address = addr->as_address_ptr();
     // ptr cannot be an object because we use this barrier for array card marks
@@ -341,12 +388,17 @@ void ShenandoahBarrierSetC1::post_barrier(LIRAccess& access, LIR_Opr addr, LIR_O
     __ unsigned_shift_right(addr, CardTable::card_shift(), tmp);
   }
 
-  LIR_Address* card_addr;
-  if (gen->can_inline_as_constant(card_table_base)) {
-    card_addr = new LIR_Address(tmp, card_table_base->as_jint(), T_BYTE);
-  } else {
-    card_addr = new LIR_Address(tmp, gen->load_constant(card_table_base), T_BYTE);
-  }
+  // The card table base is loaded from the thread, because the collector
+  // exchanges the read and write card tables at a safepoint.
+  LIR_Opr thrd = gen->getThreadPointer();
+  LIR_Address* card_table_addr =
+    new LIR_Address(thrd,
+                    in_bytes(ShenandoahThreadLocalData::card_table_offset()),
+                    T_ADDRESS);
+  LIR_Opr card_table_base = gen->new_pointer_register();
+  __ load(card_table_addr, card_table_base);
+
+  LIR_Address* card_addr = new LIR_Address(tmp, card_table_base, T_BYTE);
 
   LIR_Opr dirty = LIR_OprFact::intConst(CardTable::dirty_card_val());
   if (UseCondCardMark) {
@@ -361,4 +413,8 @@ void ShenandoahBarrierSetC1::post_barrier(LIRAccess& access, LIR_Opr addr, LIR_O
   } else {
     __ move(dirty, card_addr);
   }
+
+  if (L_skip != nullptr) {
+    __ branch_destination(L_skip->label());
+  }
 }
@@ -197,6 +197,13 @@ private:
   CodeBlob* _load_reference_barrier_weak_rt_code_blob;
   CodeBlob* _load_reference_barrier_phantom_rt_code_blob;
 
+  // Variants of the above that preserve only the general purpose registers,
+  // for the methods that do not use the FPU.
+  CodeBlob* _load_reference_barrier_strong_nofpu_rt_code_blob;
+  CodeBlob* _load_reference_barrier_strong_native_nofpu_rt_code_blob;
+  CodeBlob* _load_reference_barrier_weak_nofpu_rt_code_blob;
+  CodeBlob* _load_reference_barrier_phantom_nofpu_rt_code_blob;
+
   void pre_barrier(LIRGenerator* gen, CodeEmitInfo* info, DecoratorSet decorators, LIR_Opr addr_opr, LIR_Opr pre_val);
 
   LIR_Opr load_reference_barrier(LIRGenerator* gen, LIR_Opr obj, LIR_Opr addr, DecoratorSet decorators);
@@ -214,24 +221,32 @@ public:
     return _pre_barrier_c1_runtime_code_blob;
   }
 
-  CodeBlob* load_reference_barrier_strong_rt_code_blob() {
-    assert(_load_reference_barrier_strong_rt_code_blob != nullptr, "");
-    return _load_reference_barrier_strong_rt_code_blob;
+  CodeBlob* load_reference_barrier_strong_rt_code_blob(bool save_fpu_registers = true) {
+    CodeBlob* blob = save_fpu_registers ? _load_reference_barrier_strong_rt_code_blob
+                                        : _load_reference_barrier_strong_nofpu_rt_code_blob;
+    assert(blob != nullptr, "");
+    return blob;
   }
 
-  CodeBlob* load_reference_barrier_strong_native_rt_code_blob() {
-    assert(_load_reference_barrier_strong_native_rt_code_blob != nullptr, "");
-    return _load_reference_barrier_strong_native_rt_code_blob;
+  CodeBlob* load_reference_barrier_strong_native_rt_code_blob(bool save_fpu_registers = true) {
+    CodeBlob* blob = save_fpu_registers ? _load_reference_barrier_strong_native_rt_code_blob
+                                        : _load_reference_barrier_strong_native_nofpu_rt_code_blob;
+    assert(blob != nullptr, "");
+    return blob;
   }
 
-  CodeBlob* load_reference_barrier_weak_rt_code_blob() {
-    assert(_load_reference_barrier_weak_rt_code_blob != nullptr, "");
-    return _load_reference_barrier_weak_rt_code_blob;
+  CodeBlob* load_reference_barrier_weak_rt_code_blob(bool save_fpu_registers = true) {
+    CodeBlob* blob = save_fpu_registers ? _load_reference_barrier_weak_rt_code_blob
+                                        : _load_reference_barrier_weak_nofpu_rt_code_blob;
+    assert(blob != nullptr, "");
+    return blob;
   }
 
-  CodeBlob* load_reference_barrier_phantom_rt_code_blob() {
-    assert(_load_reference_barrier_phantom_rt_code_blob != nullptr, "");
-    return _load_reference_barrier_phantom_rt_code_blob;
+  CodeBlob* load_reference_barrier_phantom_rt_code_blob(bool save_fpu_registers = true) {
+    CodeBlob* blob = save_fpu_registers ? _load_reference_barrier_phantom_rt_code_blob
+                                        : _load_reference_barrier_phantom_nofpu_rt_code_blob;
+    assert(blob != nullptr, "");
+    return blob;
   }
 
 protected:
@@ -29,6 +29,7 @@
 #include "gc/shenandoah/shenandoahBarrierSet.hpp"
 #include "gc/shenandoah/shenandoahForwarding.hpp"
 #include "gc/shenandoah/shenandoahHeap.hpp"
+#include "gc/shenandoah/shenandoahHeapRegion.hpp"
 #include "gc/shenandoah/shenandoahRuntime.hpp"
 #include "gc/shenandoah/shenandoahThreadLocalData.hpp"
 #include "gc/shenandoah/c2/shenandoahBarrierSetC2.hpp"
@@ -99,6 +100,42 @@ Node* ShenandoahBarrierSetC2::shenandoah_iu_barrier(GraphKit* kit, Node* obj) co
 
 #define __ kit->
 
+// Checks the uses of a freshly allocated object built so far. If it was never stored anywhere
+// nor passed as an argument, no call and no other thread can have written to its fields.
+bool ShenandoahBarrierSetC2::allocation_may_escape(Node* obj) {
+  ResourceMark rm;
+  Unique_Node_List wq;
+  wq.push(obj);
+  for (uint next = 0; next < wq.size(); next++) {
+    Node* n = wq.at(next);
+    for (DUIterator_Fast imax, i = n->fast_outs(imax); i < imax; i++) {
+      Node* u = n->fast_out(i);
+      if (u->is_AddP() || u->is_ConstraintCast() || u->is_EncodeP() || u->is_DecodeN()) {
+        wq.push(u);
+      } else if (u->is_Load() || u->is_Cmp()) {
+        // Reading the object or comparing it does not publish it
+      } else if (u->is_Mem()) {
+        // A store or an atomic through the object is fine, storing the object itself is not
+        if (!n->is_AddP() || u->in(MemNode::Address) != n || u->in(MemNode::ValueIn) == n) {
+          return true;
+        }
+      } else if (u->is_Call()) {
+        CallNode* call = u->as_Call();
+        uint max = call->tf()->domain()->cnt();
+        for (uint j = TypeFunc::Parms; j < max; j++) {
+          if (call->in(j) == n) {
+            return true;
+          }
+        }
+        // Only referenced by debug info
+      } else if (!u->is_SafePoint()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 bool ShenandoahBarrierSetC2::satb_can_remove_pre_barrier(GraphKit* kit, PhaseValues* phase, Node* adr,
                                                          BasicType bt, uint adr_idx) const {
   intptr_t offset = 0;
@@ -116,6 +153,8 @@ bool ShenandoahBarrierSetC2::satb_can_remove_pre_barrier(GraphKit* kit, PhaseVal
   intptr_t size_in_bytes = type2aelembytes(bt);
 
   Node* mem = __ memory(adr_idx); // start searching here...
+  bool checked_escape = false;
+  bool escapes = true;
 
   for (int cnt = 0; cnt < 50; cnt++) {
 
@@ -174,6 +213,21 @@ bool ShenandoahBarrierSetC2::satb_can_remove_pre_barrier(GraphKit* kit, PhaseVal
           return true;
         }
       }
+    } else if (mem->is_Proj() && mem->in(0)->is_Call()) {
+      // Marking may start during the call, but the field only needs a pre-barrier if it
+      // could hold something else than the initial null. Nobody but us can write to an
+      // object that was not published, so look past the call.
+      if (!checked_escape) {
+        escapes = allocation_may_escape(base);
+        checked_escape = true;
+      }
+      if (!escapes) {
+        mem = mem->in(0)->in(TypeFunc::Memory);
+        continue;
+      }
+    } else if (mem->is_MergeMem()) {
+      mem = mem->as_MergeMem()->memory_at(adr_idx);
+      continue;
     }
 
     // Unless there is an explicit 'continue', we must bail out here,
@@ -452,17 +506,6 @@ void ShenandoahBarrierSetC2::insert_pre_barrier(GraphKit* kit, Node* base_oop, N
   kit->final_sync(ideal);
 }
 
-Node* ShenandoahBarrierSetC2::byte_map_base_node(GraphKit* kit) const {
-  BarrierSet* bs = BarrierSet::barrier_set();
-  ShenandoahBarrierSet* ctbs = barrier_set_cast<ShenandoahBarrierSet>(bs);
-  CardTable::CardValue* card_table_base = ctbs->card_table()->byte_map_base();
-  if (card_table_base != nullptr) {
-    return kit->makecon(TypeRawPtr::make((address)card_table_base));
-  } else {
-    return kit->null();
-  }
-}
-
 void ShenandoahBarrierSetC2::post_barrier(GraphKit* kit,
                                           Node* ctl,
                                           Node* oop_store,
@@ -500,14 +543,31 @@ void ShenandoahBarrierSetC2::post_barrier(GraphKit* kit,
 
   IdealKit ideal(kit, true);
 
+  // Only old-to-young pointers need a card. Storing null or an old reference never creates one.
+  bool filter = ShenandoahCardBarrierYoungFilter && val != nullptr;
+  if (filter) {
+    __ if_then(val, BoolTest::ne, kit->null());
+    Node* val_region = __ URShiftX(__ CastPX(__ ctrl(), val), __ ConI(ShenandoahHeapRegion::region_size_bytes_shift_jint()));
+    Node* affiliations = __ makecon(TypeRawPtr::make(ShenandoahHeap::affiliations_biased_addr()));
+    Node* affiliation_adr = __ AddP(__ top(), affiliations, val_region);
+    Node* affiliation = __ load(__ ctrl(), affiliation_adr, TypeInt::BYTE, T_BYTE, Compile::AliasIdxRaw);
+    __ if_then(affiliation, BoolTest::eq, __ ConI(ShenandoahAffiliation::YOUNG_GENERATION));
+  }
+
   // Convert the pointer to an int prior to doing math on it
   Node* cast = __ CastPX(__ ctrl(), adr);
 
   // Divide by card size
   Node* card_offset = __ URShiftX( cast, __ ConI(CardTable::card_shift()) );
 
+  // The card table base is loaded from the thread, because the collector
+  // exchanges the read and write card tables at a safepoint.
+  Node* tls = __ thread(); // ThreadLocalStorage
+  Node* card_table_adr = __ AddP(__ top(), tls, __ ConX(in_bytes(ShenandoahThreadLocalData::card_table_offset())));
+  Node* card_table = __ load(__ ctrl(), card_table_adr, TypeRawPtr::NOTNULL, T_ADDRESS, Compile::AliasIdxRaw);
+
   // Combine card table base and card offset
-  Node* card_adr = __ AddP(__ top(), byte_map_base_node(kit), card_offset );
+  Node* card_adr = __ AddP(__ top(), card_table, card_offset );
 
   // Get the alias_index for raw card-mark memory
   int adr_type = Compile::AliasIdxRaw;
@@ -532,6 +592,11 @@ void ShenandoahBarrierSetC2::post_barrier(GraphKit* kit,
     __ end_if();
   }
 
+  if (filter) {
+    __ end_if(); // affiliation == YOUNG_GENERATION
+    __ end_if(); // val != nullptr
+  }
+
   // Final sync IdealKit and GraphKit.
   kit->final_sync(ideal);
 }
@@ -578,6 +643,32 @@ const TypeFunc* ShenandoahBarrierSetC2::shenandoah_load_reference_barrier_Type()
   return TypeFunc::make(domain, range);
 }
 
+// Array stores need the card of the element. Stores into an instance may mark the card of the
+// object header instead, like field stores do. Unsafe and VarHandle accesses do not know their
+// shape, but C2 often does: a non-null instance base gets the field treatment, an array base the
+// element one, and any base that may be an array falls back to the precise mark of the address.
+bool ShenandoahBarrierSetC2::use_precise_card_mark(const C2Access& access) {
+  DecoratorSet decorators = access.decorators();
+  if ((decorators & IS_ARRAY) != 0) {
+    return true;
+  }
+  if ((decorators & ON_UNKNOWN_OOP_REF) == 0) {
+    return false;
+  }
+  Node* base = access.base();
+  const TypeOopPtr* btype = base != nullptr ? base->bottom_type()->isa_oopptr() : nullptr;
+  if (btype == nullptr || btype->maybe_null()) {
+    return true;
+  }
+  // Object, Cloneable and Serializable may still be arrays.
+  const TypeInstPtr* itype = btype->isa_instptr();
+  if (itype == nullptr) {
+    return true;
+  }
+  ciInstanceKlass* klass = itype->instance_klass();
+  return !klass->is_loaded() || klass->is_interface() || klass->is_java_lang_Object();
+}
+
 Node* ShenandoahBarrierSetC2::store_at_resolved(C2Access& access, C2AccessValue& val) const {
   DecoratorSet decorators = access.decorators();
 
@@ -603,11 +694,8 @@ Node* ShenandoahBarrierSetC2::store_at_resolved(C2Access& access, C2AccessValue&
     Node* result = BarrierSetC2::store_at_resolved(access, val);
 
     if (ShenandoahCardBarrier) {
-      const bool anonymous = (decorators & ON_UNKNOWN_OOP_REF) != 0;
-      const bool is_array = (decorators & IS_ARRAY) != 0;
-      const bool use_precise = is_array || anonymous;
       post_barrier(kit, kit->control(), access.raw_access(), access.base(),
-                   adr, adr_idx, val.node(), access.type(), use_precise);
+                   adr, adr_idx, val.node(), access.type(), use_precise_card_mark(access));
     }
     return result;
   } else {
@@ -736,7 +824,7 @@ Node* ShenandoahBarrierSetC2::atomic_cmpxchg_val_at_resolved(C2AtomicParseAccess
     load_store = kit->gvn().transform(new ShenandoahLoadReferenceBarrierNode(nullptr, load_store, access.decorators()));
     if (ShenandoahCardBarrier) {
       post_barrier(kit, kit->control(), access.raw_access(), access.base(),
-                   access.addr().node(), access.alias_idx(), new_val, T_OBJECT, true);
+                   access.addr().node(), access.alias_idx(), new_val, T_OBJECT, use_precise_card_mark(access));
     }
     return load_store;
   }
@@ -795,7 +883,7 @@ Node* ShenandoahBarrierSetC2::atomic_cmpxchg_bool_at_resolved(C2AtomicParseAcces
     pin_atomic_op(access);
     if (ShenandoahCardBarrier) {
       post_barrier(kit, kit->control(), access.raw_access(), access.base(),
-                   access.addr().node(), access.alias_idx(), new_val, T_OBJECT, true);
+                   access.addr().node(), access.alias_idx(), new_val, T_OBJECT, use_precise_card_mark(access));
     }
     return load_store;
   }
@@ -815,7 +903,7 @@ Node* ShenandoahBarrierSetC2::atomic_xchg_at_resolved(C2AtomicParseAccess& acces
                                  result /* pre_val */, T_OBJECT);
     if (ShenandoahCardBarrier) {
       post_barrier(kit, kit->control(), access.raw_access(), access.base(),
-                   access.addr().node(), access.alias_idx(), val, T_OBJECT, true);
+                   access.addr().node(), access.alias_idx(), val, T_OBJECT, use_precise_card_mark(access));
     }
   }
   return result;
@@ -1024,10 +1112,12 @@ void ShenandoahBarrierSetC2::eliminate_gc_barrier(PhaseMacroExpand* macro, Node*
     Node* addp = shift->unique_out();
     for (DUIterator_Last jmin, j = addp->last_outs(jmin); j >= jmin; --j) {
       Node* mem = addp->last_out(j);
-      if (UseCondCardMark && mem->is_Load()) {
+      if (mem->is_Load()) {
         assert(mem->Opcode() == Op_LoadB, "unexpected code shape");
-        // The load is checking if the card has been written so
-        // replace it with zero to fold the test.
+        // The load is either checking if the card has been written, or
+        // the affiliation of a stored value that did not escape. Replace
+        // it with zero to fold the test, the card mark is going away.
+        assert(UseCondCardMark || ShenandoahCardBarrierYoungFilter, "unexpected load");
         macro->replace_node(mem, macro->intcon(0));
         continue;
       }
@@ -1245,6 +1335,22 @@ bool ShenandoahBarrierSetC2::has_only_shenandoah_wb_pre_uses(Node* n) {
   return n->outcnt() > 0;
 }
 
+// Instances of a class whose fields are all primitive and trusted final never change after
+// construction, so the from-space and to-space copies of such an object always hold the same
+// field values. Only the identity of the copies differs.
+bool ShenandoahBarrierSetC2::is_immutable_primitive_klass(ciInstanceKlass* ik) {
+  if (!ik->is_loaded() || ik->is_interface()) {
+    return false;
+  }
+  for (int i = 0; i < ik->nof_nonstatic_fields(); i++) {
+    ciField* field = ik->nonstatic_field_at(i);
+    if (is_reference_type(field->layout_type()) || !field->is_final() || !field->is_constant()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool ShenandoahBarrierSetC2::final_graph_reshaping(Compile* compile, Node* n, uint opcode, Unique_Node_List& dead_nodes) const {
   switch (opcode) {
     case Op_CallLeaf:
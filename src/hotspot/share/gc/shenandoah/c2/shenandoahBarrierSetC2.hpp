@@ -75,8 +75,6 @@ private:
 
   Node* shenandoah_iu_barrier(GraphKit* kit, Node* obj) const;
 
-  Node* byte_map_base_node(GraphKit* kit) const;
-
   void post_barrier(GraphKit* kit,
                     Node* ctl,
                     Node* store,
@@ -91,6 +89,8 @@ private:
                           Node* pre_val, bool need_mem_bar) const;
 
   static bool clone_needs_barrier(Node* src, PhaseGVN& gvn);
+  static bool allocation_may_escape(Node* obj);
+  static bool use_precise_card_mark(const C2Access& access);
 
 protected:
   virtual Node* load_at_resolved(C2Access& access, const Type* val_type) const;
@@ -109,6 +109,7 @@ public:
   static bool is_shenandoah_marking_if(PhaseValues* phase, Node* n);
   static bool is_shenandoah_state_load(Node* n);
   static bool has_only_shenandoah_wb_pre_uses(Node* n);
+  static bool is_immutable_primitive_klass(ciInstanceKlass* ik);
 
   ShenandoahBarrierSetC2State* state() const;
 
@@ -39,14 +39,64 @@
 #include "opto/block.hpp"
 #include "opto/callnode.hpp"
 #include "opto/castnode.hpp"
+#include "opto/convertnode.hpp"
 #include "opto/movenode.hpp"
 #include "opto/phaseX.hpp"
 #include "opto/rootnode.hpp"
 #include "opto/runtime.hpp"
 #include "opto/subnode.hpp"
 
+// The barrier only matters for the identity of the object if its value is used for nothing
+// but reading immutable primitive fields: the from-space copy holds the same values. The
+// from-space copy cannot be reclaimed under the reads either: the value is not in an oop map
+// in between, and regions are only recycled after the roots have been updated at a safepoint.
+bool ShenandoahBarrierC2Support::only_immutable_field_loads(ShenandoahLoadReferenceBarrierNode* lrb, PhaseIterGVN& igvn) {
+  if (!ShenandoahBarrierSet::is_strong_access(lrb->decorators()) || lrb->outcnt() == 0) {
+    return false;
+  }
+  const TypeInstPtr* t = igvn.type(lrb)->isa_instptr();
+  if (t == nullptr || !ShenandoahBarrierSetC2::is_immutable_primitive_klass(t->instance_klass())) {
+    return false;
+  }
+  ciInstanceKlass* ik = t->instance_klass();
+  for (DUIterator_Fast imax, i = lrb->fast_outs(imax); i < imax; i++) {
+    Node* addp = lrb->fast_out(i);
+    if (!addp->is_AddP() ||
+        addp->in(AddPNode::Base) != lrb ||
+        addp->in(AddPNode::Address) != lrb ||
+        !addp->in(AddPNode::Offset)->is_Con()) {
+      return false;
+    }
+    intptr_t offset = addp->in(AddPNode::Offset)->find_intptr_t_con(-1);
+    if (offset < instanceOopDesc::base_offset_in_bytes() ||
+        ik->get_field_by_offset((int)offset, false) == nullptr) {
+      return false;
+    }
+    for (DUIterator_Fast jmax, j = addp->fast_outs(jmax); j < jmax; j++) {
+      Node* u = addp->fast_out(j);
+      if (!u->is_Load() || u->in(MemNode::Address) != addp) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void ShenandoahBarrierC2Support::elide_immutable_load_barriers(PhaseIterGVN& igvn) {
+  ShenandoahBarrierSetC2State* state = ShenandoahBarrierSetC2::bsc2()->state();
+  for (int i = state->load_reference_barriers_count() - 1; i >= 0; i--) {
+    ShenandoahLoadReferenceBarrierNode* lrb = state->load_reference_barrier(i);
+    if (only_immutable_field_loads(lrb, igvn)) {
+      igvn.replace_node(lrb, lrb->in(ShenandoahLoadReferenceBarrierNode::ValueIn));
+    }
+  }
+}
+
 bool ShenandoahBarrierC2Support::expand(Compile* C, PhaseIterGVN& igvn) {
   ShenandoahBarrierSetC2State* state = ShenandoahBarrierSetC2::bsc2()->state();
+  if (ShenandoahElideImmutableLoadBarriers) {
+    elide_immutable_load_barriers(igvn);
+  }
   if ((state->iu_barriers_count() +
        state->load_reference_barriers_count()) > 0) {
     assert(C->post_loop_opts_phase(), "no loop opts allowed");
@@ -300,6 +350,10 @@ void ShenandoahBarrierC2Support::verify(RootNode* root) {
                    adr_type->is_instptr()->instance_klass()->is_subtype_of(Compile::current()->env()->Reference_klass()) &&
                    adr_type->is_instptr()->offset() == java_lang_ref_Reference::referent_offset()) {
           if (trace) {tty->print_cr("Reference.get()");}
+        } else if (ShenandoahElideImmutableLoadBarriers &&
+                   adr_type->isa_instptr() &&
+                   ShenandoahBarrierSetC2::is_immutable_primitive_klass(adr_type->is_instptr()->instance_klass())) {
+          if (trace) {tty->print_cr("Immutable field load");}
         } else if (!verify_helper(n->in(MemNode::Address), phis, visited, ShenandoahLoad, trace, barriers_used)) {
           report_verify_failure("Shenandoah verification: Load should have barriers", n);
         }
@@ -971,6 +1025,62 @@ void ShenandoahBarrierC2Support::test_in_cset(Node*& ctrl, Node*& not_cset_ctrl,
   phase->register_new_node(cset_bool,      old_ctrl);
 }
 
+// Routes the non-null val to marked_ctrl when its strong mark bit is already set. Objects
+// allocated after mark start have no mark bit and stay on ctrl.
+void ShenandoahBarrierC2Support::test_marked(Node*& ctrl, Node*& marked_ctrl, Node* val, Node* raw_mem, PhaseIdealLoop* phase) {
+  Node* old_ctrl = ctrl;
+  PhaseIterGVN& igvn = phase->igvn();
+  const int shift = ShenandoahHeap::mark_bit_map_index_shift();
+
+  // Same raw pointer math as test_in_cset: word = map[obj >> (shift + LogBitsPerWord)].
+  Node* raw_val        = new CastP2XNode(old_ctrl, val);
+  Node* word_idx       = new URShiftXNode(raw_val, igvn.intcon(shift + LogBitsPerWord));
+  Node* word_offset    = new LShiftXNode(word_idx, igvn.intcon(LogBytesPerWord));
+  Node* map_addr_ptr   = igvn.makecon(TypeRawPtr::make(ShenandoahHeap::mark_bit_map_biased_addr()));
+  Node* map_addr       = new CastP2XNode(old_ctrl, map_addr_ptr);
+  Node* word_load_addr = new AddXNode(map_addr, word_offset);
+  Node* word_load_ptr  = new CastX2PNode(word_load_addr);
+
+  Node* word_load      = new LoadXNode(old_ctrl, raw_mem, word_load_ptr,
+                                       DEBUG_ONLY(phase->C->get_adr_type(Compile::AliasIdxRaw)) NOT_DEBUG(nullptr),
+                                       TypeX_X, MemNode::unordered);
+
+  // Shifts only use the low bits of the count, which is just the bit index within the word.
+  Node* bit_idx        = new URShiftXNode(raw_val, igvn.intcon(shift));
+  Node* bit_count      = LP64_ONLY(new ConvL2INode(bit_idx)) NOT_LP64(bit_idx);
+  Node* bit_mask       = new LShiftXNode(igvn.MakeConX(1), bit_count);
+  Node* mark_bit       = new AndXNode(word_load, bit_mask);
+  Node* mark_cmp       = new CmpXNode(mark_bit, igvn.MakeConX(0));
+  Node* mark_bool      = new BoolNode(mark_cmp, BoolTest::ne);
+
+  IfNode* mark_iff     = new IfNode(old_ctrl, mark_bool, PROB_FAIR, COUNT_UNKNOWN);
+  marked_ctrl          = new IfTrueNode(mark_iff);
+  ctrl                 = new IfFalseNode(mark_iff);
+
+  IdealLoopTree *loop = phase->get_loop(old_ctrl);
+  phase->register_control(mark_iff,    loop, old_ctrl);
+  phase->register_control(ctrl,        loop, mark_iff);
+  phase->register_control(marked_ctrl, loop, mark_iff);
+
+  phase->set_ctrl(map_addr_ptr, phase->C->root());
+
+  phase->register_new_node(raw_val,        old_ctrl);
+  phase->register_new_node(word_idx,       old_ctrl);
+  phase->register_new_node(word_offset,    old_ctrl);
+  phase->register_new_node(map_addr,       old_ctrl);
+  phase->register_new_node(word_load_addr, old_ctrl);
+  phase->register_new_node(word_load_ptr,  old_ctrl);
+  phase->register_new_node(word_load,      old_ctrl);
+  phase->register_new_node(bit_idx,        old_ctrl);
+#ifdef _LP64
+  phase->register_new_node(bit_count,      old_ctrl);
+#endif
+  phase->register_new_node(bit_mask,       old_ctrl);
+  phase->register_new_node(mark_bit,       old_ctrl);
+  phase->register_new_node(mark_cmp,       old_ctrl);
+  phase->register_new_node(mark_bool,      old_ctrl);
+}
+
 void ShenandoahBarrierC2Support::call_lrb_stub(Node*& ctrl, Node*& val, Node* load_addr,
                                                DecoratorSet decorators, PhaseIdealLoop* phase) {
   IdealLoopTree*loop = phase->get_loop(ctrl);
@@ -1481,7 +1591,7 @@ void ShenandoahBarrierC2Support::pin_and_expand(PhaseIdealLoop* phase) {
     Node* region = new RegionNode(PATH_LIMIT);
     Node* phi = PhiNode::make(region, raw_mem, Type::MEMORY, TypeRawPtr::BOTTOM);
 
-    enum { _fast_path = 1, _slow_path, _null_path, PATH_LIMIT2 };
+    enum { _fast_path = 1, _slow_path, _marked_path, _null_path, PATH_LIMIT2 };
     Node* region2 = new RegionNode(PATH_LIMIT2);
     Node* phi2 = PhiNode::make(region2, raw_mem, Type::MEMORY, TypeRawPtr::BOTTOM);
 
@@ -1502,6 +1612,14 @@ void ShenandoahBarrierC2Support::pin_and_expand(PhaseIdealLoop* phase) {
       phi2->del_req(_null_path);
     }
 
+    // Already marked path: the value is either scanned or queued already, enqueueing it
+    // again would only add to the work final mark has to drain.
+    Node* marked_ctrl = nullptr;
+    test_marked(ctrl, marked_ctrl, pre_val, raw_mem, phase);
+    if (reg2_ctrl == nullptr) reg2_ctrl = marked_ctrl->in(0);
+    region2->init_req(_marked_path, marked_ctrl);
+    phi2->init_req(_marked_path, raw_mem);
+
     const int index_offset = in_bytes(ShenandoahThreadLocalData::satb_mark_queue_index_offset());
     const int buffer_offset = in_bytes(ShenandoahThreadLocalData::satb_mark_queue_buffer_offset());
     Node* thread = new ThreadLocalNode();
@@ -1786,6 +1904,29 @@ void ShenandoahBarrierC2Support::merge_back_to_back_tests(Node* n, PhaseIdealLoo
   }
 }
 
+bool ShenandoahBarrierC2Support::eliminate_dominated_test(IfNode* iff, PhaseIdealLoop* phase) {
+  assert(is_heap_stable_test(iff), "no other tests");
+  // Look for the closest dominating heap stable test. Only a safepoint can change the gc state,
+  // so if there is none on any path from that test, this test takes the same branch.
+  Node* c = iff->in(0);
+  while (c != phase->C->start()) {
+    if (c->is_SafePoint() && !c->is_CallLeaf()) {
+      return false;
+    }
+    if (c->is_IfProj() && c->in(0)->is_If() && is_heap_stable_test(c->in(0))) {
+      break;
+    }
+    c = phase->idom(c);
+  }
+  if (c == phase->C->start() || has_safepoint_between(iff->in(0), c, phase)) {
+    return false;
+  }
+  Node* con = phase->igvn().intcon(c->Opcode() == Op_IfTrue ? 1 : 0);
+  phase->igvn().replace_input_of(iff, 1, con);
+  phase->C->set_major_progress();
+  return true;
+}
+
 IfNode* ShenandoahBarrierC2Support::find_unswitching_candidate(const IdealLoopTree* loop, PhaseIdealLoop* phase) {
   // Find first invariant test that doesn't exit the loop
   LoopNode *head = loop->_head->as_Loop();
@@ -1855,6 +1996,9 @@ void ShenandoahBarrierC2Support::optimize_after_expansion(VectorSet &visited, No
   for (uint i = 0; i < heap_stable_tests.size(); i++) {
     Node* n = heap_stable_tests.at(i);
     assert(is_heap_stable_test(n), "only evacuation test");
+    if (ShenandoahElideDominatedBarrierTests && eliminate_dominated_test(n->as_If(), phase)) {
+      continue;
+    }
     merge_back_to_back_tests(n, phase);
   }
 
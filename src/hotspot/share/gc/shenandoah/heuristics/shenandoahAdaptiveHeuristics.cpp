@@ -34,10 +34,10 @@
 #include "gc/shenandoah/shenandoahFreeSet.hpp"
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahHeapRegion.inline.hpp"
+#include "gc/shenandoah/shenandoahPhaseTimings.hpp"
 #include "logging/log.hpp"
 #include "logging/logTag.hpp"
 #include "runtime/globals_extension.hpp"
-#include "utilities/quickSort.hpp"
 
 // These constants are used to adjust the margin of error for the moving
 // average of the allocation rate and cycle time. The units are standard
@@ -65,7 +65,11 @@ ShenandoahAdaptiveHeuristics::ShenandoahAdaptiveHeuristics(ShenandoahSpaceInfo*
   _margin_of_error_sd(ShenandoahAdaptiveInitialConfidence),
   _spike_threshold_sd(ShenandoahAdaptiveInitialSpikeThreshold),
   _last_trigger(OTHER),
-  _available(Moving_Average_Samples, ShenandoahAdaptiveDecayFactor) { }
+  _available(Moving_Average_Samples, ShenandoahAdaptiveDecayFactor),
+  _mark_cost(1.0 - 1.0 / Moving_Average_Samples),
+  _evac_cost(1.0 - 1.0 / Moving_Average_Samples),
+  _update_refs_cost(1.0 - 1.0 / Moving_Average_Samples),
+  _other_time(Moving_Average_Samples, ShenandoahAdaptiveDecayFactor) { }
 
 ShenandoahAdaptiveHeuristics::~ShenandoahAdaptiveHeuristics() {}
 
@@ -96,15 +100,22 @@ void ShenandoahAdaptiveHeuristics::choose_collection_set_from_regiondata(Shenand
   size_t free_target = (capacity * ShenandoahMinFreeThreshold) / 100 + max_cset;
   size_t min_garbage = (free_target > actual_free) ? (free_target - actual_free) : 0;
 
+  // Once min_garbage is met, also stop adding regions before the evacuation and reference updates are
+  // predicted to take longer than the mutators need to deplete the free memory.
+  size_t time_cset = max_cset_for_free(actual_free, _allocation_rate.upper_bound(_margin_of_error_sd));
+
   log_info(gc, ergo)("Adaptive CSet Selection. Target Free: " SIZE_FORMAT "%s, Actual Free: "
                      SIZE_FORMAT "%s, Max Evacuation: " SIZE_FORMAT "%s, Min Garbage: " SIZE_FORMAT "%s",
                      byte_size_in_proper_unit(free_target), proper_unit_for_byte_size(free_target),
                      byte_size_in_proper_unit(actual_free), proper_unit_for_byte_size(actual_free),
                      byte_size_in_proper_unit(max_cset),    proper_unit_for_byte_size(max_cset),
                      byte_size_in_proper_unit(min_garbage), proper_unit_for_byte_size(min_garbage));
+  if (time_cset < max_cset) {
+    log_info(gc, ergo)("Predicted Evacuation Limit: " PROPERFMT, PROPERFMTARGS(time_cset));
+  }
 
   // Better select garbage-first regions
-  QuickSort::sort<RegionData>(data, (int)size, compare_by_garbage, false);
+  sort_by_garbage(data, size);
 
   size_t cur_cset = 0;
   size_t cur_garbage = 0;
@@ -119,6 +130,10 @@ void ShenandoahAdaptiveHeuristics::choose_collection_set_from_regiondata(Shenand
       break;
     }
 
+    if ((new_cset > time_cset) && (new_garbage >= min_garbage)) {
+      break;
+    }
+
     if ((new_garbage < min_garbage) || (r->garbage() > garbage_threshold)) {
       cset->add_region(r);
       cur_cset = new_cset;
@@ -134,6 +149,7 @@ void ShenandoahAdaptiveHeuristics::record_cycle_start() {
 
 void ShenandoahAdaptiveHeuristics::record_success_concurrent() {
   ShenandoahHeuristics::record_success_concurrent();
+  train_phase_models();
 
   size_t available = _space_info->available();
 
@@ -216,6 +232,11 @@ bool ShenandoahAdaptiveHeuristics::should_start_gc() {
 
   // Track allocation rate even if we decide to start a cycle for other reasons.
   double rate = _allocation_rate.sample(allocated);
+  if (consume_allocation_spike() && (rate == 0.0)) {
+    // TLAB refills accelerated before the next sample is due. Check the rate for a spike now,
+    // without letting such a short interval into the average.
+    rate = _allocation_rate.peek(allocated);
+  }
   _last_trigger = OTHER;
 
   size_t min_threshold = min_free_threshold();
@@ -277,7 +298,7 @@ bool ShenandoahAdaptiveHeuristics::should_start_gc() {
   allocation_headroom -= MIN2(allocation_headroom, spike_headroom);
   allocation_headroom -= MIN2(allocation_headroom, penalties);
 
-  double avg_cycle_time = _gc_cycle_time_history->davg() + (_margin_of_error_sd * _gc_cycle_time_history->dsd());
+  double avg_cycle_time = predict_cycle_time();
   double avg_alloc_rate = _allocation_rate.upper_bound(_margin_of_error_sd);
   log_debug(gc)("%s: average GC time: %.2f ms, allocation rate: %.0f %s/s",
                 _space_info->name(),
@@ -338,6 +359,75 @@ void ShenandoahAdaptiveHeuristics::adjust_spike_threshold(double amount) {
   log_debug(gc, ergo)("Spike threshold now: %.2f", _spike_threshold_sd);
 }
 
+void ShenandoahAdaptiveHeuristics::train_phase_models() {
+  typedef ShenandoahPhaseTimings P;
+  const P* timings = ShenandoahHeap::heap()->phase_timings();
+  const double mark = timings->cycle_time(P::init_mark_gross) +
+                      timings->cycle_time(P::init_scan_rset) +
+                      timings->cycle_time(P::conc_mark_roots) +
+                      timings->cycle_time(P::conc_mark) +
+                      timings->cycle_time(P::final_mark_gross);
+  const double evac = timings->cycle_time(P::conc_evac);
+  const double update_refs = timings->cycle_time(P::init_update_refs_gross) +
+                             timings->cycle_time(P::conc_update_refs) +
+                             timings->cycle_time(P::conc_update_thread_roots) +
+                             timings->cycle_time(P::final_update_refs_gross);
+  const double other = MAX2(elapsed_cycle_time() - mark - evac - update_refs, 0.0);
+
+  _mark_cost.add(double(_live_at_final_mark), mark);
+  _other_time.add(other);
+  if (_cset_live_at_final_mark > 0) {
+    // Abbreviated cycles neither evacuate nor update references, and teach nothing about either.
+    _evac_cost.add(double(_cset_live_at_final_mark), evac);
+    _update_refs_cost.add(double(_used_at_final_mark), update_refs);
+  }
+
+  log_debug(gc, ergo)("%s phases: mark %.2f ms (" PROPERFMT " live), evacuation %.2f ms (" PROPERFMT " live), "
+                      "update refs %.2f ms (" PROPERFMT " used), other %.2f ms",
+                      _space_info->name(),
+                      mark * 1000, PROPERFMTARGS(_live_at_final_mark),
+                      evac * 1000, PROPERFMTARGS(_cset_live_at_final_mark),
+                      update_refs * 1000, PROPERFMTARGS(_used_at_final_mark),
+                      other * 1000);
+}
+
+bool ShenandoahAdaptiveHeuristics::is_phase_model_trained() const {
+  return ShenandoahAdaptivePredictPhases && (_gc_times_learned >= ShenandoahLearningSteps) &&
+         _mark_cost.is_trained() && _evac_cost.is_trained() && _update_refs_cost.is_trained();
+}
+
+double ShenandoahAdaptiveHeuristics::predict_evac_and_update_refs(size_t cset_live) const {
+  const double time = _evac_cost.predict(double(cset_live)) + _update_refs_cost.predict(double(_space_info->used()));
+  const double sd = _evac_cost.sd() + _update_refs_cost.sd();
+  return (time + _margin_of_error_sd * sd) * prediction_factor();
+}
+
+double ShenandoahAdaptiveHeuristics::predict_cycle_time() const {
+  if (!is_phase_model_trained()) {
+    return _gc_cycle_time_history->davg() + (_margin_of_error_sd * _gc_cycle_time_history->dsd());
+  }
+  // Until marking completes, assume the next cycle finds as much live data, and chooses as large a
+  // collection set, as the previous one.
+  const double mark = _mark_cost.predict(double(_live_at_final_mark)) + _margin_of_error_sd * _mark_cost.sd();
+  const double other = _other_time.davg() + _margin_of_error_sd * _other_time.dsd();
+  return (mark + other) * prediction_factor() + predict_evac_and_update_refs(_cset_live_at_final_mark);
+}
+
+size_t ShenandoahAdaptiveHeuristics::max_cset_for_free(size_t free, double alloc_rate) const {
+  if (!is_phase_model_trained() || (alloc_rate <= 0)) {
+    return SIZE_MAX;
+  }
+  // Marking is complete, the evacuation and reference updates remain.
+  const double time_to_deplete = free / alloc_rate / prediction_factor();
+  const double margin = _margin_of_error_sd * (_evac_cost.sd() + _update_refs_cost.sd());
+  const double time_for_evac = time_to_deplete - margin - _update_refs_cost.predict(double(_space_info->used()));
+  if (time_for_evac <= 0) {
+    return 0;
+  }
+  const double work = _evac_cost.max_work(time_for_evac);
+  return (work >= double(SIZE_MAX)) ? SIZE_MAX : size_t(work);
+}
+
 size_t ShenandoahAdaptiveHeuristics::min_free_threshold() {
   // Note that soft_max_capacity() / 100 * min_free_threshold is smaller than max_capacity() / 100 * min_free_threshold.
   // We want to behave conservatively here, so use max_capacity().  By returning a larger value, we cause the GC to
@@ -345,8 +435,62 @@ size_t ShenandoahAdaptiveHeuristics::min_free_threshold() {
   return _space_info->max_capacity() / 100 * ShenandoahMinFreeThreshold;
 }
 
+ShenandoahPhaseCostModel::ShenandoahPhaseCostModel(double decay) :
+  _decay(decay),
+  _samples(0),
+  _weight(0),
+  _mean_work(0),
+  _mean_time(0),
+  _work_work(0),
+  _work_time(0),
+  _time_time(0) {
+}
+
+void ShenandoahPhaseCostModel::add(double work, double time) {
+  // Weighted incremental update of the means and the sums of squared deviations,
+  // with the weight of the older samples decaying at each new one.
+  _weight = _weight * _decay + 1;
+  const double d_work = work - _mean_work;
+  const double d_time = time - _mean_time;
+  _mean_work += d_work / _weight;
+  _mean_time += d_time / _weight;
+  _work_work = _work_work * _decay + d_work * (work - _mean_work);
+  _work_time = _work_time * _decay + d_work * (time - _mean_time);
+  _time_time = _time_time * _decay + d_time * (time - _mean_time);
+  _samples++;
+}
+
+double ShenandoahPhaseCostModel::slope() const {
+  // Phases do not get faster with more work: a negative slope is noise, and the average is a better guess.
+  // So is any slope fitted to work that barely varied.
+  if ((_samples < 2) || (_work_work <= (_mean_work * _mean_work * _weight) * 1e-6)) {
+    return 0.0;
+  }
+  return MAX2(_work_time / _work_work, 0.0);
+}
+
+double ShenandoahPhaseCostModel::predict(double work) const {
+  return MAX2(_mean_time + slope() * (work - _mean_work), 0.0);
+}
+
+double ShenandoahPhaseCostModel::sd() const {
+  if (_weight <= 0) {
+    return 0.0;
+  }
+  const double residual = _time_time - slope() * _work_time;
+  return sqrt(MAX2(residual, 0.0) / _weight);
+}
+
+double ShenandoahPhaseCostModel::max_work(double time) const {
+  const double s = slope();
+  if (s <= 0) {
+    return (_mean_time <= time) ? DBL_MAX : 0.0;
+  }
+  return MAX2(_mean_work + (time - _mean_time) / s, 0.0);
+}
+
 ShenandoahAllocationRate::ShenandoahAllocationRate() :
-  _last_sample_time(os::elapsedTime()),
+  _last_sample_time(ShenandoahHeuristics::now()),
   _last_sample_value(0),
   _interval_sec(1.0 / ShenandoahAdaptiveSampleFrequencyHz),
   _rate(int(ShenandoahAdaptiveSampleSizeSeconds * ShenandoahAdaptiveSampleFrequencyHz), ShenandoahAdaptiveDecayFactor),
@@ -354,7 +498,7 @@ ShenandoahAllocationRate::ShenandoahAllocationRate() :
 }
 
 double ShenandoahAllocationRate::sample(size_t allocated) {
-  double now = os::elapsedTime();
+  double now = ShenandoahHeuristics::now();
   double rate = 0.0;
   if (now - _last_sample_time > _interval_sec) {
     if (allocated >= _last_sample_value) {
@@ -369,6 +513,10 @@ double ShenandoahAllocationRate::sample(size_t allocated) {
   return rate;
 }
 
+double ShenandoahAllocationRate::peek(size_t allocated) const {
+  return instantaneous_rate(ShenandoahHeuristics::now(), allocated);
+}
+
 double ShenandoahAllocationRate::upper_bound(double sds) const {
   // Here we are using the standard deviation of the computed running
   // average, rather than the standard deviation of the samples that went
@@ -378,7 +526,7 @@ double ShenandoahAllocationRate::upper_bound(double sds) const {
 }
 
 void ShenandoahAllocationRate::allocation_counter_reset() {
-  _last_sample_time = os::elapsedTime();
+  _last_sample_time = ShenandoahHeuristics::now();
   _last_sample_value = 0;
 }
 
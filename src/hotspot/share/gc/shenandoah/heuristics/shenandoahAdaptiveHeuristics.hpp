@@ -41,6 +41,9 @@ class ShenandoahAllocationRate : public CHeapObj<mtGC> {
 
   double sample(size_t allocated);
 
+  // The rate since the last sample, which is not recorded.
+  double peek(size_t allocated) const;
+
   double upper_bound(double sds) const;
   bool is_spiking(double rate, double threshold) const;
  private:
@@ -54,6 +57,45 @@ class ShenandoahAllocationRate : public CHeapObj<mtGC> {
   TruncatedSeq _rate_avg;
 };
 
+/*
+ * Online linear model of the duration of a cycle phase as a function of the
+ * work it is given (live data to mark, live data to evacuate, used memory to
+ * update). The constant and proportional costs are fitted by least squares
+ * over exponentially decaying samples. While the samples cannot tell them
+ * apart, for example because the work barely changed, the model predicts
+ * their average duration.
+ */
+class ShenandoahPhaseCostModel {
+ public:
+  explicit ShenandoahPhaseCostModel(double decay);
+
+  void add(double work, double time);
+
+  bool is_trained() const { return _samples > 0; }
+
+  // Predicted duration, in seconds, of the phase for the given work.
+  double predict(double work) const;
+
+  // Standard deviation of the samples around the model.
+  double sd() const;
+
+  // The largest work which the phase is predicted to complete within the given time.
+  double max_work(double time) const;
+
+ private:
+  double slope() const;
+
+  const double _decay;
+  uint _samples;
+  double _weight;
+  double _mean_work;
+  double _mean_time;
+  // Decayed sums of squared deviations from the means.
+  double _work_work;
+  double _work_time;
+  double _time_time;
+};
+
 /*
  * The adaptive heuristic tracks the allocation behavior and average cycle
  * time of the application. It attempts to start a cycle with enough time
@@ -142,7 +184,35 @@ protected:
   // source of feedback to adjust trigger parameters.
   TruncatedSeq _available;
 
+  // Per-phase cost models, fitted at the end of each successful concurrent cycle: marking against
+  // the live data, evacuation against the collection set live data, reference updates against the
+  // used memory. The balance of the cycle is learned as a plain duration.
+  ShenandoahPhaseCostModel _mark_cost;
+  ShenandoahPhaseCostModel _evac_cost;
+  ShenandoahPhaseCostModel _update_refs_cost;
+  TruncatedSeq _other_time;
+
   size_t min_free_threshold();
+
+  // True once the phase models have learned enough cycles to predict with.
+  bool is_phase_model_trained() const;
+
+  // Scales the predictions of the phase models. Subclasses may make them more conservative.
+  virtual double prediction_factor() const { return 1.0; }
+
+  // Predicted duration, at the current margin of error, of the evacuation and reference updates
+  // of a collection set with the given live data.
+  double predict_evac_and_update_refs(size_t cset_live) const;
+
+  // Predicted duration, at the current margin of error, of the next cycle: the phase models if
+  // trained, otherwise the history of cycle times.
+  double predict_cycle_time() const;
+
+  // The largest collection set live data that the mutators, allocating at the given rate, are
+  // predicted to let the cycle evacuate before they deplete the given free memory.
+  size_t max_cset_for_free(size_t free, double alloc_rate) const;
+
+  void train_phase_models();
 };
 
 #endif // SHARE_GC_SHENANDOAH_HEURISTICS_SHENANDOAHADAPTIVEHEURISTICS_HPP
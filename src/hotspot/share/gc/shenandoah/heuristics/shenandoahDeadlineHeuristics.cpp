@@ -0,0 +1,97 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+
+#include "gc/shenandoah/heuristics/shenandoahDeadlineHeuristics.hpp"
+#include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahPacer.hpp"
+#include "logging/log.hpp"
+#include "logging/logTag.hpp"
+
+// Bounds on the factor that scales all predicted times. The upper bound keeps a run of bad
+// cycles from turning the heuristic into a back-to-back collector for good.
+const double ShenandoahDeadlineHeuristics::MIN_SLO_FACTOR = 1.0;
+const double ShenandoahDeadlineHeuristics::MAX_SLO_FACTOR = 8.0;
+
+ShenandoahDeadlineHeuristics::ShenandoahDeadlineHeuristics(ShenandoahSpaceInfo* space_info) :
+  ShenandoahAdaptiveHeuristics(space_info),
+  _slo_factor(MIN_SLO_FACTOR),
+  _stall_start(0.0) { }
+
+ShenandoahDeadlineHeuristics::~ShenandoahDeadlineHeuristics() {}
+
+void ShenandoahDeadlineHeuristics::record_success_concurrent() {
+  ShenandoahAdaptiveHeuristics::record_success_concurrent();
+
+  ShenandoahHeap* heap = ShenandoahHeap::heap();
+  size_t pacing_p99 = 0;
+  if (ShenandoahPacing) {
+    pacing_p99 = heap->pacer()->take_delay_percentile(99);
+  }
+  if (pacing_p99 > ShenandoahDeadlinePacingTargetMs) {
+    // The cycle did not keep up with the mutators: start the next sooner, and keep its collection set smaller.
+    adjust_slo_factor(1.25);
+  } else {
+    adjust_slo_factor(0.97);
+  }
+
+  log_debug(gc, ergo)("%s: pacing p99 " SIZE_FORMAT " ms, prediction factor %.2f",
+                      _space_info->name(), pacing_p99, _slo_factor);
+}
+
+void ShenandoahDeadlineHeuristics::record_allocation_failure_gc() {
+  ShenandoahAdaptiveHeuristics::record_allocation_failure_gc();
+  _stall_start = ShenandoahHeuristics::now();
+}
+
+void ShenandoahDeadlineHeuristics::record_success_degenerated() {
+  ShenandoahAdaptiveHeuristics::record_success_degenerated();
+  record_stall();
+}
+
+void ShenandoahDeadlineHeuristics::record_success_full() {
+  ShenandoahAdaptiveHeuristics::record_success_full();
+  record_stall();
+}
+
+void ShenandoahDeadlineHeuristics::record_stall() {
+  // Allocations stalled for the whole degenerated or full cycle (if it was started by an allocation failure),
+  // which is a larger miss than any pacing delay.
+  double stall_ms = 0;
+  if (_stall_start > 0) {
+    stall_ms = (ShenandoahHeuristics::now() - _stall_start) * 1000;
+    _stall_start = 0;
+  }
+  adjust_slo_factor((stall_ms > ShenandoahDeadlineStallBudgetMs) ? 2.0 : 1.25);
+  if (ShenandoahPacing) {
+    ShenandoahHeap::heap()->pacer()->take_delay_percentile(99);
+  }
+  log_info(gc, ergo)("%s: allocations stalled for %.2f ms, prediction factor now %.2f",
+                     _space_info->name(), stall_ms, _slo_factor);
+}
+
+void ShenandoahDeadlineHeuristics::adjust_slo_factor(double factor) {
+  _slo_factor = MAX2(MIN2(_slo_factor * factor, MAX_SLO_FACTOR), MIN_SLO_FACTOR);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_GC_SHENANDOAH_HEURISTICS_SHENANDOAHDEADLINEHEURISTICS_HPP
+#define SHARE_GC_SHENANDOAH_HEURISTICS_SHENANDOAHDEADLINEHEURISTICS_HPP
+
+#include "gc/shenandoah/heuristics/shenandoahAdaptiveHeuristics.hpp"
+
+/*
+ * The deadline heuristic triggers and sizes collection sets as the adaptive
+ * heuristic does, from the per-phase cycle time predictions, but scales those
+ * predictions to meet latency objectives. The scale is raised whenever the
+ * 99th percentile of pacing delays of a cycle exceeds
+ * ShenandoahDeadlinePacingTargetMs, or whenever a cycle degenerates (more so
+ * if it stalled allocations for longer than ShenandoahDeadlineStallBudgetMs),
+ * and decays slowly otherwise.
+ */
+class ShenandoahDeadlineHeuristics : public ShenandoahAdaptiveHeuristics {
+public:
+  ShenandoahDeadlineHeuristics(ShenandoahSpaceInfo* space_info);
+
+  virtual ~ShenandoahDeadlineHeuristics();
+
+  virtual void record_success_concurrent();
+  virtual void record_success_degenerated();
+  virtual void record_success_full();
+  virtual void record_allocation_failure_gc();
+
+  virtual const char* name()     { return "Deadline"; }
+  virtual bool is_diagnostic()   { return false; }
+  virtual bool is_experimental() { return true; }
+
+protected:
+  virtual double prediction_factor() const { return _slo_factor; }
+
+private:
+  const static double MIN_SLO_FACTOR;
+  const static double MAX_SLO_FACTOR;
+
+  // Multiplies all predicted times. Raised when a cycle misses the latency objectives.
+  double _slo_factor;
+
+  // Time at which allocations started to stall for the current degenerated or full cycle.
+  double _stall_start;
+
+  void adjust_slo_factor(double factor);
+  void record_stall();
+};
+
+#endif // SHARE_GC_SHENANDOAH_HEURISTICS_SHENANDOAHDEADLINEHEURISTICS_HPP
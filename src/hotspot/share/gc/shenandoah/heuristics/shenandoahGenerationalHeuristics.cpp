@@ -58,6 +58,7 @@ void ShenandoahGenerationalHeuristics::choose_collection_set(ShenandoahCollectio
   size_t preselected_candidates = 0;
 
   size_t total_garbage = 0;
+  size_t live_data = 0;
 
   size_t immediate_garbage = 0;
   size_t immediate_regions = 0;
@@ -81,6 +82,7 @@ void ShenandoahGenerationalHeuristics::choose_collection_set(ShenandoahCollectio
     }
     size_t garbage = region->garbage();
     total_garbage += garbage;
+    live_data += region->get_live_data_bytes();
     if (region->is_empty()) {
       free_regions++;
       free += region_size_bytes;
@@ -137,7 +139,7 @@ void ShenandoahGenerationalHeuristics::choose_collection_set(ShenandoahCollectio
         immediate_regions++;
         immediate_garbage += garbage;
       } else {
-        if (region->is_young() && region->age() >= tenuring_threshold) {
+        if (region->is_young() && region->age() >= tenuring_threshold && heap->should_promote_humongous(region)) {
           oop obj = cast_to_oop(region->bottom());
           size_t humongous_regions = ShenandoahHeapRegion::required_regions(obj->size() * HeapWordSize);
           humongous_regions_promoted += humongous_regions;
@@ -175,8 +177,11 @@ void ShenandoahGenerationalHeuristics::choose_collection_set(ShenandoahCollectio
     }
 
     // Call the subclasses to add young-gen regions into the collection set.
+    cand_idx = filter_hot_candidates(candidates, cand_idx);
     choose_collection_set_from_regiondata(collection_set, candidates, cand_idx, immediate_garbage + free);
   }
+  decay_access_samples();
+  record_final_mark(live_data, collection_set);
 
   if (collection_set->has_old_regions()) {
     heap->shenandoah_policy()->record_mixed_cycle();
@@ -30,7 +30,6 @@
 #include "gc/shenandoah/shenandoahGenerationalHeap.hpp"
 #include "gc/shenandoah/shenandoahHeapRegion.inline.hpp"
 
-#include "utilities/quickSort.hpp"
 
 ShenandoahGlobalHeuristics::ShenandoahGlobalHeuristics(ShenandoahGlobalGeneration* generation)
         : ShenandoahGenerationalHeuristics(generation) {
@@ -65,7 +64,7 @@ void ShenandoahGlobalHeuristics::choose_collection_set_from_regiondata(Shenandoa
 
 
   // Better select garbage-first regions
-  QuickSort::sort<RegionData>(data, (int) size, compare_by_garbage, false);
+  sort_by_garbage(data, size);
 
   size_t cur_young_garbage = add_preselected_regions_to_collection_set(cset, data, size);
 
@@ -26,7 +26,9 @@
 #include "precompiled.hpp"
 #include "gc/shared/gcCause.hpp"
 #include "gc/shenandoah/shenandoahCollectorPolicy.hpp"
+#include "gc/shenandoah/shenandoahGeneration.hpp"
 #include "gc/shenandoah/shenandoahHeapRegion.inline.hpp"
+#include "gc/shenandoah/shenandoahHeuristicsTrace.hpp"
 #include "gc/shenandoah/shenandoahMarkingContext.inline.hpp"
 #include "gc/shenandoah/heuristics/shenandoahHeuristics.hpp"
 #include "logging/log.hpp"
@@ -34,6 +36,8 @@
 #include "runtime/globals_extension.hpp"
 #include "utilities/quickSort.hpp"
 
+double ShenandoahHeuristics::_replay_time = -1.0;
+
 // sort by decreasing garbage (so most garbage comes first)
 int ShenandoahHeuristics::compare_by_garbage(RegionData a, RegionData b) {
   if (a._u._garbage > b._u._garbage)
@@ -46,13 +50,20 @@ int ShenandoahHeuristics::compare_by_garbage(RegionData a, RegionData b) {
 ShenandoahHeuristics::ShenandoahHeuristics(ShenandoahSpaceInfo* space_info) :
   _space_info(space_info),
   _region_data(nullptr),
+  _presorted(nullptr),
+  _presort_rank(nullptr),
+  _presorted_count(0),
   _guaranteed_gc_interval(0),
-  _cycle_start(os::elapsedTime()),
+  _cycle_start(now()),
   _last_cycle_end(0),
   _gc_times_learned(0),
   _gc_time_penalties(0),
   _gc_cycle_time_history(new TruncatedSeq(Moving_Average_Samples, ShenandoahAdaptiveDecayFactor)),
-  _metaspace_oom()
+  _live_at_final_mark(0),
+  _cset_live_at_final_mark(0),
+  _used_at_final_mark(0),
+  _metaspace_oom(),
+  _allocation_spike()
 {
   size_t num_regions = ShenandoahHeap::heap()->num_regions();
   assert(num_regions > 0, "Sanity");
@@ -62,6 +73,142 @@ ShenandoahHeuristics::ShenandoahHeuristics(ShenandoahSpaceInfo* space_info) :
 
 ShenandoahHeuristics::~ShenandoahHeuristics() {
   FREE_C_HEAP_ARRAY(RegionGarbage, _region_data);
+  FREE_C_HEAP_ARRAY(RegionData, _presorted);
+  FREE_C_HEAP_ARRAY(uint, _presort_rank);
+}
+
+void ShenandoahHeuristics::presort_candidates(ShenandoahGeneration* generation) {
+  ShenandoahHeap* heap = ShenandoahHeap::heap();
+  size_t num_regions = heap->num_regions();
+  if (_presorted == nullptr) {
+    _presorted = NEW_C_HEAP_ARRAY(RegionData, num_regions, mtGC);
+    _presort_rank = NEW_C_HEAP_ARRAY(uint, num_regions, mtGC);
+    memset(_presort_rank, 0, num_regions * sizeof(uint));
+  }
+
+  // Forget the order left over by a cycle that did not reach final mark.
+  for (size_t j = 0; j < _presorted_count; j++) {
+    _presort_rank[_presorted[j]._region->index()] = 0;
+  }
+
+  ShenandoahMarkingContext* const ctx = heap->marking_context();
+  size_t count = 0;
+  for (size_t i = 0; i < num_regions; i++) {
+    ShenandoahHeapRegion* region = heap->get_region(i);
+    if (!generation->contains(region) || !(region->is_regular() || region->is_regular_pinned())) {
+      continue;
+    }
+    // Final mark counts everything allocated above TAMS as live, so the garbage it finds is
+    // what lies below TAMS and was not marked.
+    size_t below_tams = pointer_delta(ctx->top_at_mark_start(region), region->bottom()) * HeapWordSize;
+    size_t live = region->get_live_data_bytes();
+    _presorted[count]._region = region;
+    _presorted[count]._u._garbage = (below_tams > live) ? (below_tams - live) : 0;
+    count++;
+  }
+  QuickSort::sort<RegionData>(_presorted, (int)count, compare_by_garbage, false);
+  for (size_t j = 0; j < count; j++) {
+    _presort_rank[_presorted[j]._region->index()] = (uint)(j + 1);
+  }
+  _presorted_count = count;
+}
+
+void ShenandoahHeuristics::sort_by_garbage(RegionData* data, size_t size) {
+  const size_t presorted = _presorted_count;
+  if (presorted == 0) {
+    QuickSort::sort<RegionData>(data, (int)size, compare_by_garbage, false);
+    return;
+  }
+
+  // Move the candidates whose garbage changed to the front, and flag the others in the ranks.
+  const uint present = 1u << 31;
+  size_t changed = 0;
+  for (size_t i = 0; i < size; i++) {
+    size_t index = data[i]._region->index();
+    uint rank = _presort_rank[index];
+    if (rank != 0 && _presorted[rank - 1]._u._garbage == data[i]._u._garbage) {
+      _presort_rank[index] = rank | present;
+    } else {
+      data[changed++] = data[i];
+    }
+  }
+  QuickSort::sort<RegionData>(data, (int)changed, compare_by_garbage, false);
+
+  // The flagged candidates are still sorted in the presorted order. The order is used up.
+  size_t unchanged = 0;
+  for (size_t j = 0; j < presorted; j++) {
+    size_t index = _presorted[j]._region->index();
+    if ((_presort_rank[index] & present) != 0) {
+      _presorted[unchanged++] = _presorted[j];
+    }
+    _presort_rank[index] = 0;
+  }
+  _presorted_count = 0;
+  assert(changed + unchanged == size, "Every candidate is either changed or presorted");
+
+  log_debug(gc, ergo)("Presorted " SIZE_FORMAT " of " SIZE_FORMAT " collection set candidates", unchanged, size);
+
+  // Merge both sorted runs from the back, the changed candidates are already at the front.
+  size_t i = changed;
+  size_t j = unchanged;
+  size_t k = size;
+  while (j > 0) {
+    if (i > 0 && data[i - 1]._u._garbage < _presorted[j - 1]._u._garbage) {
+      data[--k] = data[--i];
+    } else {
+      data[--k] = _presorted[--j];
+    }
+  }
+}
+
+size_t ShenandoahHeuristics::filter_hot_candidates(RegionData* data, size_t size) {
+  if (ShenandoahRegionAccessSampleRate == 0) {
+    return size;
+  }
+
+  ShenandoahHeap* heap = ShenandoahHeap::heap();
+  size_t total_samples = 0;
+  size_t sampled_regions = 0;
+  for (size_t i = 0; i < heap->num_regions(); i++) {
+    uint samples = heap->get_region(i)->access_samples();
+    if (samples > 0) {
+      total_samples += samples;
+      sampled_regions++;
+    }
+  }
+  if (sampled_regions == 0) {
+    return size;
+  }
+
+  const size_t hot_factor = 4;
+  const size_t hot_samples = hot_factor * total_samples / sampled_regions;
+  const size_t garbage_threshold = ShenandoahHeapRegion::region_size_bytes() * ShenandoahHotRegionGarbageThreshold / 100;
+  size_t kept = 0;
+  for (size_t i = 0; i < size; i++) {
+    ShenandoahHeapRegion* region = data[i]._region;
+    if (region->access_samples() > hot_samples && data[i]._u._garbage < garbage_threshold) {
+      log_trace(gc, ergo)("Region " SIZE_FORMAT " is hot (%u access samples), not a collection set candidate",
+                          region->index(), region->access_samples());
+      continue;
+    }
+    data[kept++] = data[i];
+  }
+
+  if (kept < size) {
+    log_debug(gc, ergo)("Skipped " SIZE_FORMAT " hot collection set candidates, more than " SIZE_FORMAT
+                        " access samples per region", size - kept, hot_samples);
+  }
+  return kept;
+}
+
+void ShenandoahHeuristics::decay_access_samples() {
+  if (ShenandoahRegionAccessSampleRate == 0) {
+    return;
+  }
+  ShenandoahHeap* heap = ShenandoahHeap::heap();
+  for (size_t i = 0; i < heap->num_regions(); i++) {
+    heap->get_region(i)->decay_access_samples();
+  }
 }
 
 void ShenandoahHeuristics::choose_collection_set(ShenandoahCollectionSet* collection_set) {
@@ -81,6 +228,7 @@ void ShenandoahHeuristics::choose_collection_set(ShenandoahCollectionSet* collec
   size_t cand_idx = 0;
 
   size_t total_garbage = 0;
+  size_t live_data = 0;
 
   size_t immediate_garbage = 0;
   size_t immediate_regions = 0;
@@ -95,6 +243,7 @@ void ShenandoahHeuristics::choose_collection_set(ShenandoahCollectionSet* collec
 
     size_t garbage = region->garbage();
     total_garbage += garbage;
+    live_data += region->get_live_data_bytes();
 
     if (region->is_empty()) {
       free_regions++;
@@ -111,6 +260,11 @@ void ShenandoahHeuristics::choose_collection_set(ShenandoahCollectionSet* collec
         candidates[cand_idx]._u._garbage = garbage;
         cand_idx++;
       }
+    } else if (ShenandoahEvacuatePinnedRegions && region->is_regular_pinned()) {
+      // Pinned objects stay in place, but everything else can be evacuated.
+      candidates[cand_idx]._region = region;
+      candidates[cand_idx]._u._garbage = garbage;
+      cand_idx++;
     } else if (region->is_humongous_start()) {
       // Reclaim humongous regions here, and count them as the immediate garbage
 #ifdef ASSERT
@@ -145,8 +299,11 @@ void ShenandoahHeuristics::choose_collection_set(ShenandoahCollectionSet* collec
   size_t immediate_percent = (total_garbage == 0) ? 0 : (immediate_garbage * 100 / total_garbage);
 
   if (immediate_percent <= ShenandoahImmediateThreshold) {
+    cand_idx = filter_hot_candidates(candidates, cand_idx);
     choose_collection_set_from_regiondata(collection_set, candidates, cand_idx, immediate_garbage + free);
   }
+  decay_access_samples();
+  record_final_mark(live_data, collection_set);
 
   size_t cset_percent = (total_garbage == 0) ? 0 : (collection_set->garbage() * 100 / total_garbage);
   size_t collectable_garbage = collection_set->garbage() + immediate_garbage;
@@ -171,12 +328,20 @@ void ShenandoahHeuristics::choose_collection_set(ShenandoahCollectionSet* collec
                      collection_set->count());
 }
 
+void ShenandoahHeuristics::record_final_mark(size_t live, ShenandoahCollectionSet* collection_set) {
+  _live_at_final_mark = live;
+  _cset_live_at_final_mark = collection_set->live();
+  _used_at_final_mark = _space_info->used();
+}
+
 void ShenandoahHeuristics::record_cycle_start() {
-  _cycle_start = os::elapsedTime();
+  _cycle_start = now();
+  ShenandoahHeuristicsTrace::record_event(_space_info, ShenandoahHeuristicsTrace::CYCLE_START);
 }
 
 void ShenandoahHeuristics::record_cycle_end() {
-  _last_cycle_end = os::elapsedTime();
+  _last_cycle_end = now();
+  ShenandoahHeuristicsTrace::record_event(_space_info, ShenandoahHeuristicsTrace::CYCLE_END);
 }
 
 bool ShenandoahHeuristics::should_start_gc() {
@@ -188,7 +353,7 @@ bool ShenandoahHeuristics::should_start_gc() {
   }
 
   if (_guaranteed_gc_interval > 0) {
-    double last_time_ms = (os::elapsedTime() - _last_cycle_end) * 1000;
+    double last_time_ms = (now() - _last_cycle_end) * 1000;
     if (last_time_ms > _guaranteed_gc_interval) {
       log_info(gc)("Trigger (%s): Time since last GC (%.0f ms) is larger than guaranteed interval (" UINTX_FORMAT " ms)",
                    _space_info->name(), last_time_ms, _guaranteed_gc_interval);
@@ -196,9 +361,28 @@ bool ShenandoahHeuristics::should_start_gc() {
     }
   }
 
+  if (ShenandoahHeap::heap()->soft_max_controller()->check_memory_pressure(ShenandoahHeap::heap())) {
+    log_info(gc)("Trigger (%s): Memory pressure, shed memory down to the lowered soft max heap size",
+                 _space_info->name());
+    return true;
+  }
+
   return false;
 }
 
+bool ShenandoahHeuristics::evaluate_trigger() {
+  ShenandoahHeuristicsTrace* const trace = ShenandoahHeuristicsTrace::trace();
+  if (trace == nullptr) {
+    return should_start_gc();
+  }
+
+  // Capture the inputs before asking, should_start_gc() consumes the spike flag
+  ShenandoahTriggerInputs inputs(_space_info, has_metaspace_oom(), _allocation_spike.is_set());
+  bool decision = should_start_gc();
+  trace->write_trigger(_space_info->name(), now(), inputs, decision);
+  return decision;
+}
+
 bool ShenandoahHeuristics::should_degenerate_cycle() {
   return ShenandoahHeap::heap()->shenandoah_policy()->consecutive_degenerated_gc_count() <= ShenandoahFullGCThreshold;
 }
@@ -225,21 +409,26 @@ void ShenandoahHeuristics::record_success_concurrent() {
   _gc_times_learned++;
 
   adjust_penalty(Concurrent_Adjust);
+  ShenandoahHeuristicsTrace::record_event(_space_info, ShenandoahHeuristicsTrace::CYCLE_CONCURRENT);
 }
 
 void ShenandoahHeuristics::record_success_degenerated() {
   adjust_penalty(Degenerated_Penalty);
+  ShenandoahHeuristicsTrace::record_event(_space_info, ShenandoahHeuristicsTrace::CYCLE_DEGENERATED);
 }
 
 void ShenandoahHeuristics::record_success_full() {
   adjust_penalty(Full_Penalty);
+  ShenandoahHeuristicsTrace::record_event(_space_info, ShenandoahHeuristicsTrace::CYCLE_FULL);
 }
 
 void ShenandoahHeuristics::record_allocation_failure_gc() {
-  // Do nothing.
+  ShenandoahHeuristicsTrace::record_event(_space_info, ShenandoahHeuristicsTrace::ALLOCATION_FAILURE);
 }
 
 void ShenandoahHeuristics::record_requested_gc() {
+  ShenandoahHeuristicsTrace::record_event(_space_info, ShenandoahHeuristicsTrace::REQUESTED_GC);
+
   // Assume users call System.gc() when external state changes significantly,
   // which forces us to re-learn the GC timings and allocation rates.
   _gc_times_learned = 0;
@@ -260,5 +449,9 @@ void ShenandoahHeuristics::initialize() {
 }
 
 double ShenandoahHeuristics::elapsed_cycle_time() const {
-  return os::elapsedTime() - _cycle_start;
+  return now() - _cycle_start;
+}
+
+double ShenandoahHeuristics::now() {
+  return (_replay_time >= 0.0) ? _replay_time : os::elapsedTime();
 }
@@ -57,6 +57,7 @@
   } while (0)
 
 class ShenandoahCollectionSet;
+class ShenandoahGeneration;
 class ShenandoahHeapRegion;
 
 /*
@@ -77,6 +78,7 @@ protected:
     union {
       size_t _garbage;          // Not used by old-gen heuristics.
       size_t _live_data;        // Only used for old-gen heuristics, which prioritizes retention of _live_data over garbage reclaim
+      size_t _cost;             // Only used for old-gen heuristics, once mixed collection candidates have been chosen
     } _u;
   } RegionData;
 
@@ -97,6 +99,13 @@ protected:
   // have negligible cost unless proven otherwise.
   RegionData* _region_data;
 
+  // With ShenandoahPresortCollectionSet, the candidate regions ordered by decreasing garbage when
+  // concurrent marking completed, and the rank + 1 of each region in that order (0 when absent).
+  // Allocated on first use.
+  RegionData* _presorted;
+  uint* _presort_rank;
+  size_t _presorted_count;
+
   size_t _guaranteed_gc_interval;
 
   double _cycle_start;
@@ -106,11 +115,36 @@ protected:
   intx _gc_time_penalties;
   TruncatedSeq* _gc_cycle_time_history;
 
+  // What the most recent mark found when the collection set was chosen: the live data in the space,
+  // the live data in the collection set, and the used memory in the space.
+  size_t _live_at_final_mark;
+  size_t _cset_live_at_final_mark;
+  size_t _used_at_final_mark;
+
   // There may be many threads that contend to set this flag
   ShenandoahSharedFlag _metaspace_oom;
 
+  // Set when TLAB refills accelerated since the allocation rate was last sampled
+  ShenandoahSharedFlag _allocation_spike;
+
+  // When not negative, the time reported by now() in place of the elapsed time of the VM
+  static double _replay_time;
+
   static int compare_by_garbage(RegionData a, RegionData b);
 
+  // Sorts the candidates by decreasing garbage. The candidates whose garbage did not change since
+  // presort_candidates() keep their presorted order, so that only the others are sorted in the pause.
+  void sort_by_garbage(RegionData* data, size_t size);
+
+  // With ShenandoahRegionAccessSampleRate, drops the candidates that mutators access much more often than
+  // the average sampled region, unless ShenandoahHotRegionGarbageThreshold of them is garbage: evacuating
+  // them costs the mutators load reference barrier slow paths for little reclaimed memory. Returns the
+  // number of remaining candidates, which stay in their original order.
+  size_t filter_hot_candidates(RegionData* data, size_t size);
+
+  // Halves the access samples of all regions, once they were used to choose a collection set.
+  static void decay_access_samples();
+
   // TODO: We need to enhance this API to give visibility to accompanying old-gen evacuation effort.
   // In the case that the old-gen evacuation effort is small or zero, the young-gen heuristics
   // should feel free to dedicate increased efforts to young-gen evacuation.
@@ -121,6 +155,8 @@ protected:
 
   void adjust_penalty(intx step);
 
+  void record_final_mark(size_t live, ShenandoahCollectionSet* collection_set);
+
 public:
   ShenandoahHeuristics(ShenandoahSpaceInfo* space_info);
   virtual ~ShenandoahHeuristics();
@@ -129,6 +165,9 @@ public:
   void clear_metaspace_oom()      { _metaspace_oom.unset(); }
   bool has_metaspace_oom() const  { return _metaspace_oom.is_set(); }
 
+  void record_allocation_spike()    { _allocation_spike.set(); }
+  bool consume_allocation_spike()   { return _allocation_spike.try_unset(); }
+
   void set_guaranteed_gc_interval(size_t guaranteed_gc_interval) {
     _guaranteed_gc_interval = guaranteed_gc_interval;
   }
@@ -139,6 +178,11 @@ public:
 
   virtual bool should_start_gc();
 
+  // Asks should_start_gc() and records its inputs and the decision when
+  // -XX:ShenandoahHeuristicsTraceFile is set. The threads that poll the
+  // heuristics use this rather than calling should_start_gc() directly.
+  bool evaluate_trigger();
+
   virtual bool should_degenerate_cycle();
 
   virtual void record_success_concurrent();
@@ -153,6 +197,10 @@ public:
 
   virtual void choose_collection_set(ShenandoahCollectionSet* collection_set);
 
+  // Orders the regular regions of the generation by the garbage they will have at final mark, unless
+  // the rest of the marking finds more live objects in them. Runs concurrently, after marking.
+  void presort_candidates(ShenandoahGeneration* generation);
+
   virtual bool can_unload_classes();
 
   // This indicates whether or not the current cycle should unload classes.
@@ -165,6 +213,12 @@ public:
   virtual void initialize();
 
   double elapsed_cycle_time() const;
+
+  // The clock of the heuristics. This is the elapsed time of the VM, unless a
+  // recorded trace is being replayed, in which case it is the recorded time.
+  static double now();
+  static void set_replay_time(double time) { _replay_time = time; }
+  static void clear_replay_time()          { _replay_time = -1.0; }
 };
 
 #endif // SHARE_GC_SHENANDOAH_HEURISTICS_SHENANDOAHHEURISTICS_HPP
@@ -31,7 +31,10 @@
 #include "gc/shenandoah/shenandoahOldGeneration.hpp"
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahHeapRegion.inline.hpp"
+#include "gc/shenandoah/shenandoahMmuTracker.hpp"
+#include "gc/shenandoah/shenandoahScanRemembered.inline.hpp"
 #include "logging/log.hpp"
+#include "memory/resourceArea.hpp"
 #include "utilities/quickSort.hpp"
 
 uint ShenandoahOldHeuristics::NOT_FOUND = -1U;
@@ -45,6 +48,17 @@ int ShenandoahOldHeuristics::compare_by_live(RegionData a, RegionData b) {
   else return 0;
 }
 
+// sort by increasing cost (so cheapest evacuation comes first)
+int ShenandoahOldHeuristics::compare_by_cost(RegionData a, RegionData b) {
+  if (a._u._cost < b._u._cost) {
+    return -1;
+  } else if (a._u._cost > b._u._cost) {
+    return 1;
+  } else {
+    return 0;
+  }
+}
+
 // sort by increasing index
 int ShenandoahOldHeuristics::compare_by_index(RegionData a, RegionData b) {
   if (a._region->index() < b._region->index()) {
@@ -66,10 +80,13 @@ ShenandoahOldHeuristics::ShenandoahOldHeuristics(ShenandoahOldGeneration* genera
   _next_old_collection_candidate(0),
   _last_old_region(0),
   _live_bytes_in_unprocessed_candidates(0),
+  _mixed_cost_scale(1.0),
   _old_generation(generation),
   _cannot_expand_trigger(false),
   _fragmentation_trigger(false),
   _growth_trigger(false),
+  _humongous_trigger(false),
+  _humongous_defrag_regions(0),
   _fragmentation_density(0.0),
   _fragmentation_first_old_region(0),
   _fragmentation_last_old_region(0)
@@ -117,6 +134,17 @@ bool ShenandoahOldHeuristics::prime_collection_set(ShenandoahCollectionSet* coll
                byte_size_in_proper_unit(old_evacuation_budget), proper_unit_for_byte_size(old_evacuation_budget),
                unprocessed_old_collection_candidates());
 
+  // While the collector has been using more CPU than ShenandoahMixedTargetGCU, also bound the evacuation cost
+  // of the old regions we take, so that mixed collections back off instead of overrunning their targets.
+  bool limit_cost = false;
+  size_t cost_budget = 0;
+  size_t cost_spent = 0;
+  if (ShenandoahOldEvacCostModel) {
+    adjust_mixed_cost_scale();
+    limit_cost = _mixed_cost_scale < 1.0;
+    cost_budget = (size_t) (old_evacuation_budget * _mixed_cost_scale);
+  }
+
   size_t lost_evacuation_capacity = 0;
 
   // The number of old-gen regions that were selected as candidates for collection at the end of the most recent old-gen
@@ -137,6 +165,16 @@ bool ShenandoahOldHeuristics::prime_collection_set(ShenandoahCollectionSet* coll
     size_t live_data_for_evacuation = r->get_live_data_bytes();
     size_t lost_available = r->free();
 
+    if (limit_cost) {
+      // Candidates are ordered by increasing cost, so no region after this one fits either. Always take at
+      // least one region, so that mixed collections keep making progress.
+      const size_t cost = evacuation_cost(r, live_data_for_evacuation);
+      if ((included_old_regions > 0) && (cost_spent + cost > cost_budget)) {
+        break;
+      }
+      cost_spent += cost;
+    }
+
     if ((lost_available > 0) && (excess_fragmented_available > 0)) {
       if (lost_available < excess_fragmented_available) {
         excess_fragmented_available -= lost_available;
@@ -297,7 +335,7 @@ void ShenandoahOldHeuristics::slide_pinned_regions_to_front() {
     if (skipped._region->is_pinned()) {
       RegionData& available_slot = _region_data[write_index];
       available_slot._region = skipped._region;
-      available_slot._u._live_data = skipped._u._live_data;
+      available_slot._u = skipped._u;
       --write_index;
     }
   }
@@ -412,6 +450,10 @@ void ShenandoahOldHeuristics::prepare_for_old_collections() {
     unfragmented += region_free;
   }
 
+  if (ShenandoahOldEvacCostModel) {
+    rank_candidates_by_cost();
+  }
+
   // defrag_count represents regions that are placed into the old collection set in order to defragment the memory
   // that we try to "reserve" for humongous allocations.
   size_t defrag_count = 0;
@@ -433,6 +475,16 @@ void ShenandoahOldHeuristics::prepare_for_old_collections() {
     QuickSort::sort<RegionData>(candidates + _last_old_collection_candidate, cand_idx - _last_old_collection_candidate,
                                 compare_by_index, false);
 
+    // A recent humongous allocation failed for want of contiguous free regions, rather than for want of free
+    // regions. Start by clearing the cheapest run of regions of that length.
+    if (_humongous_defrag_regions > 0) {
+      defrag_count += select_humongous_defrag_window(cand_idx, candidates_garbage, unfragmented);
+      total_uncollected_old_regions = _last_old_region - _last_old_collection_candidate;
+    }
+  }
+  _humongous_defrag_regions = 0;
+
+  if (cand_idx > _last_old_collection_candidate) {
     const size_t first_unselected_old_region = candidates[_last_old_collection_candidate]._region->index();
     const size_t last_unselected_old_region = candidates[cand_idx - 1]._region->index();
     size_t span_of_uncollected_regions = 1 + last_unselected_old_region - first_unselected_old_region;
@@ -484,6 +536,131 @@ void ShenandoahOldHeuristics::prepare_for_old_collections() {
   }
 }
 
+size_t ShenandoahOldHeuristics::select_humongous_defrag_window(size_t cand_idx, size_t& candidates_garbage,
+                                                               size_t& unfragmented) {
+  ShenandoahHeap* heap = ShenandoahHeap::heap();
+  const size_t num_regions = heap->num_regions();
+  const size_t window = _humongous_defrag_regions;
+  if (window > num_regions) {
+    return 0;
+  }
+
+  // The cost of clearing each region: free regions and regions which are already candidates cost nothing,
+  // uncollected old regions cost their live data. Anything else (young, humongous or pinned) cannot be
+  // cleared by old evacuations, and blocks any window that contains it.
+  ResourceMark rm;
+  const size_t BLOCKED = SIZE_MAX;
+  size_t* const cost = NEW_RESOURCE_ARRAY(size_t, num_regions);
+  for (size_t i = 0; i < num_regions; i++) {
+    ShenandoahHeapRegion* r = heap->get_region(i);
+    cost[i] = (r->is_empty() || r->is_trash()) ? 0 : BLOCKED;
+  }
+  RegionData* const candidates = _region_data;
+  for (size_t i = 0; i < cand_idx; i++) {
+    ShenandoahHeapRegion* r = candidates[i]._region;
+    if (r->is_pinned()) {
+      continue;
+    }
+    cost[r->index()] = (i < _last_old_collection_candidate) ? 0 : r->get_live_data_bytes();
+  }
+
+  // Slide the window over the heap, and keep the cheapest position with no blocked region in it.
+  size_t best_start = num_regions;
+  size_t best_cost = BLOCKED;
+  size_t window_cost = 0;
+  size_t blocked = 0;
+  for (size_t i = 0; i < num_regions; i++) {
+    if (cost[i] == BLOCKED) {
+      blocked++;
+    } else {
+      window_cost += cost[i];
+    }
+    if (i >= window) {
+      const size_t leaving = cost[i - window];
+      if (leaving == BLOCKED) {
+        blocked--;
+      } else {
+        window_cost -= leaving;
+      }
+    }
+    if ((i + 1 >= window) && (blocked == 0) && (window_cost < best_cost)) {
+      best_cost = window_cost;
+      best_start = i + 1 - window;
+    }
+  }
+
+  if (best_start == num_regions) {
+    log_info(gc)("No run of " SIZE_FORMAT " regions can be cleared for humongous allocations", window);
+    return 0;
+  }
+  const size_t best_end = best_start + window;
+
+  // The uncollected candidates are sorted by index, so those within the window are adjacent. Move them to
+  // the front of the uncollected candidates, and restore the index order of the rest.
+  size_t added = 0;
+  for (size_t i = _last_old_collection_candidate; i < cand_idx; i++) {
+    const size_t index = candidates[i]._region->index();
+    if ((index >= best_start) && (index < best_end)) {
+      RegionData tmp = candidates[i];
+      candidates[i] = candidates[_last_old_collection_candidate + added];
+      candidates[_last_old_collection_candidate + added] = tmp;
+      added++;
+    }
+  }
+  for (size_t i = 0; i < added; i++) {
+    ShenandoahHeapRegion* r = candidates[_last_old_collection_candidate]._region;
+    candidates_garbage += r->garbage();
+    unfragmented += r->free();
+    _last_old_collection_candidate++;
+  }
+  QuickSort::sort<RegionData>(candidates + _last_old_collection_candidate, cand_idx - _last_old_collection_candidate,
+                              compare_by_index, false);
+
+  log_info(gc)("Old regions selected to clear regions [" SIZE_FORMAT ", " SIZE_FORMAT ") for humongous allocations: "
+               SIZE_FORMAT ", evacuating " PROPERFMT, best_start, best_end, added, PROPERFMTARGS(best_cost));
+  return added;
+}
+
+size_t ShenandoahOldHeuristics::evacuation_cost(ShenandoahHeapRegion* r, size_t live_bytes) const {
+  RememberedScanner* const scanner = _old_generation->card_scan();
+  if (scanner == nullptr) {
+    return live_bytes;
+  }
+  size_t dirty_cards = 0;
+  const size_t first_card = scanner->card_index_for_addr(r->bottom());
+  const size_t cards = align_up(pointer_delta(r->top(), r->bottom()), CardTable::card_size_in_words()) / CardTable::card_size_in_words();
+  for (size_t i = first_card; i < first_card + cards; i++) {
+    if (scanner->is_write_card_dirty(i)) {
+      dirty_cards++;
+    }
+  }
+  return live_bytes + dirty_cards * CardTable::card_size();
+}
+
+void ShenandoahOldHeuristics::rank_candidates_by_cost() {
+  // Candidates below the live threshold were sorted by live data. Cheap regions are not only those with
+  // little live data: copying a region full of pointers into young also leaves its copies for the next
+  // remembered set scans. A pinned region cannot be evacuated until it is unpinned, so try it last.
+  RegionData* const candidates = _region_data;
+  for (uint i = 0; i < _last_old_collection_candidate; i++) {
+    ShenandoahHeapRegion* const r = candidates[i]._region;
+    candidates[i]._u._cost = r->is_pinned() ? SIZE_MAX : evacuation_cost(r, candidates[i]._u._live_data);
+  }
+  QuickSort::sort<RegionData>(candidates, _last_old_collection_candidate, compare_by_cost, false);
+}
+
+void ShenandoahOldHeuristics::adjust_mixed_cost_scale() {
+  // Back off multiplicatively while the collector uses more than its share of the CPU, and recover additively.
+  const double min_scale = 1.0 / 16;
+  const double gcu = _heap->mmu_tracker()->gc_utilization();
+  if (gcu * 100 > ShenandoahMixedTargetGCU) {
+    _mixed_cost_scale = MAX2(_mixed_cost_scale / 2, min_scale);
+  } else {
+    _mixed_cost_scale = MIN2(_mixed_cost_scale + 1.0 / 8, 1.0);
+  }
+  log_debug(gc, ergo)("Mixed collection cost scale: %.3f, GCU: %.1f%%", _mixed_cost_scale, gcu * 100);
+}
+
 size_t ShenandoahOldHeuristics::unprocessed_old_collection_candidates_live_memory() const {
   return _live_bytes_in_unprocessed_candidates;
 }
@@ -552,6 +729,15 @@ void ShenandoahOldHeuristics::clear_triggers() {
   _cannot_expand_trigger = false;
   _fragmentation_trigger = false;
   _growth_trigger = false;
+  _humongous_trigger = false;
+}
+
+void ShenandoahOldHeuristics::trigger_humongous_fragmentation(size_t regions) {
+  shenandoah_assert_heaplocked();
+  if (ShenandoahOldHumongousDefrag) {
+    _humongous_trigger = true;
+    _humongous_defrag_regions = MAX2(_humongous_defrag_regions, regions);
+  }
 }
 
 void ShenandoahOldHeuristics::trigger_collection_if_fragmented(size_t first_old_region, size_t last_old_region, size_t old_region_count, size_t num_regions) {
@@ -651,6 +837,12 @@ bool ShenandoahOldHeuristics::should_start_gc() {
     return true;
   }
 
+  if (_humongous_trigger) {
+    log_info(gc)("Trigger (OLD): Humongous allocation of " SIZE_FORMAT " regions found no contiguous free regions",
+                 _humongous_defrag_regions);
+    return true;
+  }
+
   if (_growth_trigger) {
     // Growth may be falsely triggered during mixed evacuations, before the mixed-evacuation candidates have been
     // evacuated.  Before acting on a false trigger, we check to confirm the trigger condition is still satisfied.
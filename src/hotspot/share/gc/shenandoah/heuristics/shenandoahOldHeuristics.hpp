@@ -89,6 +89,11 @@ private:
   // How much live data must be evacuated from within the unprocessed mixed evacuation candidates?
   size_t _live_bytes_in_unprocessed_candidates;
 
+  // Fraction of the old evacuation budget, in units of evacuation cost, that the next mixed collection may
+  // spend. Halved after a cycle whose GC utilization exceeded ShenandoahMixedTargetGCU, and restored gradually
+  // otherwise. At 1.0, only the memory available for old evacuations limits a mixed collection.
+  double _mixed_cost_scale;
+
   // Keep a pointer to our generation that we can use without down casting a protected member from the base class.
   ShenandoahOldGeneration* _old_generation;
 
@@ -97,6 +102,11 @@ private:
   bool _cannot_expand_trigger;
   bool _fragmentation_trigger;
   bool _growth_trigger;
+  bool _humongous_trigger;
+
+  // Length, in regions, of the longest humongous allocation that found enough free regions, but no contiguous
+  // run of them, since old candidates were last chosen. The next old mark tries to clear a run this long.
+  size_t _humongous_defrag_regions;
 
   // Motivation for a fragmentation_trigger
   double _fragmentation_density;
@@ -113,6 +123,18 @@ private:
 
   static int compare_by_index(RegionData a, RegionData b);
 
+  static int compare_by_cost(RegionData a, RegionData b);
+
+  // Estimated work to evacuate this region, in bytes: the live data to copy, plus the dirty cards below top,
+  // whose copies will be dirty as well and must be rescanned by the next remembered set scan.
+  size_t evacuation_cost(ShenandoahHeapRegion* r, size_t live_bytes) const;
+
+  // Order the mixed collection candidates by increasing evacuation cost, with pinned regions last.
+  void rank_candidates_by_cost();
+
+  // Update _mixed_cost_scale from the GC utilization of the most recent cycle.
+  void adjust_mixed_cost_scale();
+
   inline void trigger_old_is_fragmented(double density, size_t first_old_index, size_t last_old_index) {
     _fragmentation_trigger = true;
     _fragmentation_density = density;
@@ -121,6 +143,11 @@ private:
   }
   inline void trigger_old_has_grown() { _growth_trigger = true; }
 
+  // Add to the mixed collection candidates the uncollected old regions within the cheapest window of
+  // _humongous_defrag_regions regions that holds nothing else but free regions and candidates. Returns
+  // the number of regions added. Expects the uncollected candidates to be sorted by index.
+  size_t select_humongous_defrag_window(size_t cand_idx, size_t& candidates_garbage, size_t& unfragmented);
+
   void trigger_collection_if_fragmented(size_t first_old_region, size_t last_old_region, size_t old_region_count, size_t num_regions);
   void trigger_collection_if_overgrown();
 
@@ -175,6 +202,9 @@ public:
 
   void trigger_cannot_expand() { _cannot_expand_trigger = true; };
 
+  // A humongous allocation of this many regions failed, although there were enough free regions.
+  void trigger_humongous_fragmentation(size_t regions);
+
   inline void get_fragmentation_trigger_reason_for_log_message(double &density, size_t &first_index, size_t &last_index) {
     density = _fragmentation_density;
     first_index = _fragmentation_first_old_region;
@@ -32,7 +32,6 @@
 #include "gc/shenandoah/shenandoahOldGeneration.hpp"
 #include "gc/shenandoah/shenandoahYoungGeneration.hpp"
 
-#include "utilities/quickSort.hpp"
 
 ShenandoahYoungHeuristics::ShenandoahYoungHeuristics(ShenandoahYoungGeneration* generation)
         : ShenandoahGenerationalHeuristics(generation) {
@@ -65,7 +64,7 @@ void ShenandoahYoungHeuristics::choose_collection_set_from_regiondata(Shenandoah
   // to exclude one of the regions because it might require evacuation of too much live data.
 
   // Better select garbage-first regions
-  QuickSort::sort<RegionData>(data, (int) size, compare_by_garbage, false);
+  sort_by_garbage(data, size);
 
   size_t cur_young_garbage = add_preselected_regions_to_collection_set(cset, data, size);
 
@@ -62,4 +62,5 @@ void ShenandoahGenerationalMode::initialize_flags() const {
   SHENANDOAH_CHECK_FLAG_SET(ShenandoahCASBarrier);
   SHENANDOAH_CHECK_FLAG_SET(ShenandoahCloneBarrier);
   SHENANDOAH_CHECK_FLAG_SET(ShenandoahCardBarrier);
+  SHENANDOAH_CHECK_FLAG_UNSET(ShenandoahEvacuatePinnedRegions);
 }
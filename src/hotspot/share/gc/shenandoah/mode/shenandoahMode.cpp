@@ -27,6 +27,7 @@
 #include "gc/shenandoah/heuristics/shenandoahAdaptiveHeuristics.hpp"
 #include "gc/shenandoah/heuristics/shenandoahAggressiveHeuristics.hpp"
 #include "gc/shenandoah/heuristics/shenandoahCompactHeuristics.hpp"
+#include "gc/shenandoah/heuristics/shenandoahDeadlineHeuristics.hpp"
 #include "gc/shenandoah/heuristics/shenandoahSpaceInfo.hpp"
 #include "gc/shenandoah/heuristics/shenandoahStaticHeuristics.hpp"
 #include "gc/shenandoah/mode/shenandoahMode.hpp"
@@ -44,6 +45,8 @@ ShenandoahHeuristics* ShenandoahMode::initialize_heuristics(ShenandoahSpaceInfo*
     return new ShenandoahAdaptiveHeuristics(space_info);
   } else if (strcmp(ShenandoahGCHeuristics, "compact") == 0) {
     return new ShenandoahCompactHeuristics(space_info);
+  } else if (strcmp(ShenandoahGCHeuristics, "deadline") == 0) {
+    return new ShenandoahDeadlineHeuristics(space_info);
   } else {
     vm_exit_during_initialization("Unknown -XX:ShenandoahGCHeuristics option");
   }
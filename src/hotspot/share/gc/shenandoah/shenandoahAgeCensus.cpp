@@ -27,6 +27,7 @@
 #include "gc/shenandoah/mode/shenandoahGenerationalMode.hpp"
 #include "gc/shenandoah/shenandoahAgeCensus.hpp"
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "memory/padded.inline.hpp"
 
 ShenandoahAgeCensus::ShenandoahAgeCensus() {
   assert(ShenandoahHeap::heap()->mode()->is_generational(), "Only in generational mode");
@@ -40,6 +41,10 @@ ShenandoahAgeCensus::ShenandoahAgeCensus() {
   _global_age_table = NEW_C_HEAP_ARRAY(AgeTable*, MAX_SNAPSHOTS, mtGC);
   CENSUS_NOISE(_global_noise = NEW_C_HEAP_ARRAY(ShenandoahNoiseStats, MAX_SNAPSHOTS, mtGC);)
   _tenuring_threshold = NEW_C_HEAP_ARRAY(uint, MAX_SNAPSHOTS, mtGC);
+  _global_samples = NEW_C_HEAP_ARRAY(size_t, MAX_SNAPSHOTS * MAX_COHORTS, mtGC);
+  for (int i = 0; i < MAX_SNAPSHOTS * MAX_COHORTS; i++) {
+    _global_samples[i] = 0;
+  }
 
   for (int i = 0; i < MAX_SNAPSHOTS; i++) {
     // Note that we don't now get perfdata from age_table
@@ -59,11 +64,23 @@ ShenandoahAgeCensus::ShenandoahAgeCensus() {
   } else {
     _local_age_table = nullptr;
   }
+  _local_sample_state = nullptr;
+  if (_local_age_table != nullptr && ShenandoahGenerationalCensusSampleRate > 1) {
+    size_t max_workers = ShenandoahHeap::heap()->max_workers();
+    _local_sample_state = PaddedArray<SampleState, mtGC>::create_unfreeable((uint) max_workers);
+    for (uint i = 0; i < max_workers; i++) {
+      clear_sample_state(i);
+    }
+  }
   _epoch = MAX_SNAPSHOTS - 1;  // see update_epoch()
 }
 
 CENSUS_NOISE(void ShenandoahAgeCensus::add(uint obj_age, uint region_age, uint region_youth, size_t size, uint worker_id) {)
 NO_CENSUS_NOISE(void ShenandoahAgeCensus::add(uint obj_age, uint region_age, size_t size, uint worker_id) {)
+  if (is_sampling()) {
+    // Extrapolate from the sampled object to those passed over since the last sample.
+    size *= ShenandoahGenerationalCensusSampleRate;
+  }
   if (obj_age <= markWord::max_age) {
     assert(obj_age < MAX_COHORTS && region_age < MAX_COHORTS, "Should have been tenured");
 #ifdef SHENANDOAH_CENSUS_NOISE
@@ -88,6 +105,9 @@ NO_CENSUS_NOISE(void ShenandoahAgeCensus::add(uint obj_age, uint region_age, siz
     uint age = MIN2(obj_age + region_age, (uint)(MAX_COHORTS - 1));  // clamp
 #endif  // SHENANDOAH_CENSUS_NOISE
     get_local_age_table(worker_id)->add(age, size);
+    if (is_sampling()) {
+      _local_sample_state[worker_id]._samples[age]++;
+    }
   } else {
     // update skipped statistics
     CENSUS_NOISE(add_skipped(size, worker_id);)
@@ -120,6 +140,18 @@ void ShenandoahAgeCensus::prepare_for_census_update() {
   }
   _global_age_table[_epoch]->clear();
   CENSUS_NOISE(_global_noise[_epoch].clear();)
+  for (uint c = 0; c < MAX_COHORTS; c++) {
+    _global_samples[_epoch * MAX_COHORTS + c] = 0;
+  }
+}
+
+void ShenandoahAgeCensus::clear_sample_state(uint worker_id) {
+  SampleState* const state = &_local_sample_state[worker_id];
+  // Stagger the workers, so that those that visit similar object graphs do not sample in lockstep.
+  state->_countdown = worker_id % ShenandoahGenerationalCensusSampleRate;
+  for (uint c = 0; c < MAX_COHORTS; c++) {
+    state->_samples[c] = 0;
+  }
 }
 
 // Update the census data from appropriate sources,
@@ -144,6 +176,12 @@ void ShenandoahAgeCensus::update_census(size_t age0_pop, AgeTable* pv1, AgeTable
       // Merge noise stats
       CENSUS_NOISE(_global_noise[_epoch].merge(_local_noise[i]);)
       CENSUS_NOISE(_local_noise[i].clear();)
+      if (is_sampling()) {
+        for (uint c = 0; c < MAX_COHORTS; c++) {
+          _global_samples[_epoch * MAX_COHORTS + c] += _local_sample_state[i]._samples[c];
+        }
+        clear_sample_state(i);
+      }
     }
   } else {
     // census during evac
@@ -168,6 +206,9 @@ void ShenandoahAgeCensus::reset_global() {
     _global_age_table[i]->clear();
     CENSUS_NOISE(_global_noise[i].clear();)
   }
+  for (uint i = 0; i < MAX_SNAPSHOTS * MAX_COHORTS; i++) {
+    _global_samples[i] = 0;
+  }
   _epoch = MAX_SNAPSHOTS;
   assert(_epoch < MAX_SNAPSHOTS, "Error");
 }
@@ -182,6 +223,9 @@ void ShenandoahAgeCensus::reset_local() {
   for (uint i = 0; i < max_workers; i++) {
     _local_age_table[i]->clear();
     CENSUS_NOISE(_local_noise[i].clear();)
+    if (is_sampling()) {
+      clear_sample_state(i);
+    }
   }
 }
 
@@ -295,7 +339,7 @@ uint ShenandoahAgeCensus::compute_tenuring_threshold() {
     // Cohort of current age i
     const size_t cur_pop = cur_pv->sizes[i];
     const size_t prev_pop = prev_pv->sizes[i-1];
-    const double mr = mortality_rate(prev_pop, cur_pop);
+    const double mr = is_sampling() ? sampled_mortality_rate(i, prev_pop, cur_pop) : mortality_rate(prev_pop, cur_pop);
     if (prev_pop > ShenandoahGenerationalTenuringCohortPopulationThreshold &&
         mr > ShenandoahGenerationalTenuringMortalityRateThreshold) {
       // This is the oldest cohort that has high mortality.
@@ -335,6 +379,29 @@ double ShenandoahAgeCensus::mortality_rate(size_t prev_pop, size_t cur_pop) {
   return 1.0 - (((double)cur_pop)/((double)prev_pop));
 }
 
+double ShenandoahAgeCensus::sampled_mortality_rate(uint cohort, size_t prev_pop, size_t cur_pop) {
+  assert(cohort > 0 && cohort < MAX_COHORTS, "Cohort of current age must have a predecessor");
+  const double mr = mortality_rate(prev_pop, cur_pop);
+  const uint cur_epoch = _epoch;
+  const uint prev_epoch = cur_epoch > 0 ? cur_epoch - 1 : markWord::max_age;
+  const size_t cur_samples = _global_samples[cur_epoch * MAX_COHORTS + cohort];
+  const size_t prev_samples = _global_samples[prev_epoch * MAX_COHORTS + cohort - 1];
+  if (cur_samples == 0 || prev_samples == 0) {
+    // Either nothing survived, or the previous population was not sampled (it consists only of the
+    // age 0 volume measured exactly above TAMS): there is nothing to widen.
+    return mr;
+  }
+  // The relative standard error of a population counted from k samples is about 1/sqrt(k), so that of
+  // the survival ratio cur/prev is about sqrt(1/k_cur + 1/k_prev). Take the survival ratio at the lower
+  // end of a ~95% confidence interval: a cohort is treated as long-lived only if it is, with confidence,
+  // rather than tenured early because of sampling noise.
+  const double z = 2.0;
+  const double rel_error = sqrt(1.0 / (double) cur_samples + 1.0 / (double) prev_samples);
+  const double survival = 1.0 - mr;
+  const double low_survival = survival * MAX2(0.0, 1.0 - z * rel_error);
+  return 1.0 - low_survival;
+}
+
 void ShenandoahAgeCensus::print() {
   // Print the population vector for the current epoch, and
   // for the previous epoch, as well as the computed mortality
@@ -365,6 +432,9 @@ void ShenandoahAgeCensus::print() {
     }
   }
   CENSUS_NOISE(_global_noise[cur_epoch].print(total);)
+  if (is_sampling()) {
+    log_info(gc, age)("Census sampled 1 in " UINTX_FORMAT " objects", ShenandoahGenerationalCensusSampleRate);
+  }
 }
 
 #ifdef SHENANDOAH_CENSUS_NOISE
@@ -26,6 +26,8 @@
 #define SHARE_GC_SHENANDOAH_SHENANDOAHAGECENSUS_HPP
 
 #include "gc/shared/ageTable.hpp"
+#include "gc/shared/gc_globals.hpp"
+#include "memory/padded.hpp"
 
 #ifndef PRODUCT
 // Enable noise instrumentation
@@ -98,6 +100,16 @@ class ShenandoahAgeCensus: public CHeapObj<mtGC> {
   AgeTable** _global_age_table;      // Global age table used for adapting tenuring threshold, one per snapshot
   AgeTable** _local_age_table;       // Local scratch age tables to track object ages, one per worker
 
+  // With ShenandoahGenerationalCensusSampleRate > 1, the census counts one in that many marked objects.
+  // Each worker passes over objects independently, and records how many objects it sampled per cohort,
+  // from which the confidence in the extrapolated populations is derived.
+  struct SampleState {
+    uint   _countdown;                      // Objects to pass over before the next sample
+    size_t _samples[AgeTable::table_size];  // Objects sampled, per cohort
+  };
+  PaddedEnd<SampleState>* _local_sample_state; // One per worker, only for a sampling census during marking
+  size_t* _global_samples;                     // Objects sampled, per cohort, per snapshot
+
 #ifdef SHENANDOAH_CENSUS_NOISE
   ShenandoahNoiseStats* _global_noise; // Noise stats, one per snapshot
   ShenandoahNoiseStats* _local_noise;  // Local scratch table for noise stats, one per worker
@@ -119,6 +131,15 @@ class ShenandoahAgeCensus: public CHeapObj<mtGC> {
   // previous and current epochs
   double mortality_rate(size_t prev_pop, size_t cur_pop);
 
+  // Upper end of the confidence interval of the mortality rate of the cohort
+  // now of age cohort, when its populations were extrapolated from samples
+  double sampled_mortality_rate(uint cohort, size_t prev_pop, size_t cur_pop);
+
+  bool is_sampling() const { return _local_sample_state != nullptr; }
+
+  // Clear the samples of worker_id, and restart its countdown
+  void clear_sample_state(uint worker_id);
+
   // Update to a new epoch, creating a slot for new census.
   void prepare_for_census_update();
 
@@ -172,6 +193,21 @@ class ShenandoahAgeCensus: public CHeapObj<mtGC> {
     return (AgeTable*) _local_age_table[worker_id];
   }
 
+  // Return true if the census should count the next object visited by
+  // worker_id, false if the object is passed over by a sampling census.
+  bool should_sample(uint worker_id) {
+    if (!is_sampling()) {
+      return true;
+    }
+    SampleState* const state = &_local_sample_state[worker_id];
+    if (state->_countdown > 0) {
+      state->_countdown--;
+      return false;
+    }
+    state->_countdown = (uint) (ShenandoahGenerationalCensusSampleRate - 1);
+    return true;
+  }
+
   // Update the local age table for worker_id by size for
   // given obj_age, region_age, and region_youth
   CENSUS_NOISE(void add(uint obj_age, uint region_age, uint region_youth, size_t size, uint worker_id);)
@@ -83,6 +83,9 @@ private:
   // True if this request is trying to copy any object from young to old (promote).
   bool _is_promotion;
 
+  // True if the memory that satisfied this request is known to be zeroed.
+  bool _is_zeroed;
+
 #ifdef ASSERT
   // Check that this is set before being read.
   bool _actual_size_set;
@@ -90,7 +93,7 @@ private:
 
   ShenandoahAllocRequest(size_t _min_size, size_t _requested_size, Type _alloc_type, ShenandoahAffiliation affiliation, bool is_promotion = false) :
           _min_size(_min_size), _requested_size(_requested_size),
-          _actual_size(0), _waste(0), _alloc_type(_alloc_type), _affiliation(affiliation), _is_promotion(is_promotion)
+          _actual_size(0), _waste(0), _alloc_type(_alloc_type), _affiliation(affiliation), _is_promotion(is_promotion), _is_zeroed(false)
 #ifdef ASSERT
           , _actual_size_set(false)
 #endif
@@ -223,6 +226,14 @@ public:
   bool is_promotion() const {
     return _is_promotion;
   }
+
+  bool is_zeroed() const {
+    return _is_zeroed;
+  }
+
+  void set_zeroed(bool zeroed) {
+    _is_zeroed = zeroed;
+  }
 };
 
 #endif // SHARE_GC_SHENANDOAH_SHENANDOAHALLOCREQUEST_HPP
@@ -0,0 +1,59 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+
+#include "gc/shenandoah/shenandoahAllocationSpikeDetector.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/os.hpp"
+
+ShenandoahAllocationSpikeDetector::ShenandoahAllocationSpikeDetector() :
+  _wakeup_lock(Mutex::nosafepoint - 2, "ShenandoahAllocSpike_lock", true),
+  _spike(),
+  _refills(0),
+  _batch_start(os::javaTimeNanos()),
+  _batch_duration_avg(0) {
+}
+
+void ShenandoahAllocationSpikeDetector::complete_batch() {
+  // Batches complete one refill apart, so there is only ever one thread here unless refills are
+  // extremely fast, in which case a lost update of the average does not matter.
+  const jlong now = os::javaTimeNanos();
+  const jlong duration = now - Atomic::xchg(&_batch_start, now);
+  const jlong avg = Atomic::load(&_batch_duration_avg);
+  Atomic::store(&_batch_duration_avg, (avg == 0) ? duration : (3 * avg + duration) / 4);
+
+  if ((avg > 0) && (duration * (jlong) ShenandoahAllocSpikeAcceleration < avg) && _spike.try_set()) {
+    MonitorLocker ml(&_wakeup_lock, Mutex::_no_safepoint_check_flag);
+    ml.notify_all();
+  }
+}
+
+bool ShenandoahAllocationSpikeDetector::sleep(uint ms) {
+  MonitorLocker ml(&_wakeup_lock, Mutex::_no_safepoint_check_flag);
+  if (!_spike.is_set()) {
+    ml.wait(ms);
+  }
+  return _spike.try_unset();
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_GC_SHENANDOAH_SHENANDOAHALLOCATIONSPIKEDETECTOR_HPP
+#define SHARE_GC_SHENANDOAH_SHENANDOAHALLOCATIONSPIKEDETECTOR_HPP
+
+#include "gc/shared/gc_globals.hpp"
+#include "gc/shenandoah/shenandoahPadding.hpp"
+#include "gc/shenandoah/shenandoahSharedVariables.hpp"
+#include "memory/allocation.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/mutex.hpp"
+
+/*
+ * The heuristics sample the allocation rate at ShenandoahAdaptiveSampleFrequencyHz,
+ * from the thread that decides when to start cycles, and that thread sleeps between
+ * decisions. This detector lets the allocation path wake it up early: mutators count
+ * their TLAB refills, and the thread completing a batch of ShenandoahAllocSpikeRefills
+ * refills compares the time the batch took with the average. If refills arrived
+ * ShenandoahAllocSpikeAcceleration times faster than usual, the sleeping thread wakes up.
+ */
+class ShenandoahAllocationSpikeDetector {
+private:
+  Monitor _wakeup_lock;
+  ShenandoahSharedFlag _spike;
+
+  shenandoah_padding(0);
+  volatile size_t _refills;
+  shenandoah_padding(1);
+
+  // Start time of the current batch, and decaying average duration of batches, in nanoseconds.
+  volatile jlong _batch_start;
+  volatile jlong _batch_duration_avg;
+
+  void complete_batch();
+
+public:
+  ShenandoahAllocationSpikeDetector();
+
+  void record_refill() {
+    if (ShenandoahAllocSpikeRefills > 0 &&
+        Atomic::add(&_refills, (size_t) 1, memory_order_relaxed) % ShenandoahAllocSpikeRefills == 0) {
+      complete_batch();
+    }
+  }
+
+  // Sleep for up to the given time. Returns true if woken up early because refills accelerated.
+  bool sleep(uint ms);
+};
+
+#endif // SHARE_GC_SHENANDOAH_SHENANDOAHALLOCATIONSPIKEDETECTOR_HPP
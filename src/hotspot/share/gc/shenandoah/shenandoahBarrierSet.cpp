@@ -106,6 +106,9 @@ void ShenandoahBarrierSet::on_thread_attach(Thread *thread) {
   queue.set_active(_satb_mark_queue_set.is_active());
   if (thread->is_Java_thread()) {
     ShenandoahThreadLocalData::set_gc_state(thread, _heap->gc_state());
+    if (ShenandoahCardBarrier) {
+      ShenandoahThreadLocalData::set_card_table(thread, _card_table->write_byte_map_base());
+    }
     ShenandoahThreadLocalData::initialize_gclab(thread);
 
     BarrierSetNMethod* bs_nm = barrier_set_nmethod();
@@ -138,7 +138,15 @@ private:
   template <class T, bool HAS_FWD, bool EVAC, bool ENQUEUE>
   inline void arraycopy_work(T* src, size_t count);
 
+  // Elements are checked against the collection set this many at a time
+  static const size_t ARRAYCOPY_CSET_SCAN_GROUP = 16;
+  template <class T>
+  inline T* arraycopy_find_cset_group(T* start, T* end) const;
+
   inline bool need_bulk_update(HeapWord* dst);
+
+  // Counts the region of load_addr for one in ShenandoahRegionAccessSampleRate calls of this thread
+  inline void sample_access(void* load_addr);
 public:
   // Callbacks for runtime accesses.
   template <DecoratorSet decorators, typename BarrierSetT = ShenandoahBarrierSet>
@@ -149,6 +157,10 @@ public:
     template <typename T>
     static void oop_store_common(T* addr, oop value);
 
+    // Unsettles the weak OopStorage block containing addr, see ShenandoahSettledWeakRoots.
+    template <typename T>
+    static void note_weak_root_store(T* addr);
+
   public:
     // Heap oop accesses. These accessors get resolved when
     // IN_HEAP is set (e.g. when using the HeapAccess API), it is
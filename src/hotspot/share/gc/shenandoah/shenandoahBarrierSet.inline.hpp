@@ -30,6 +30,7 @@
 
 #include "gc/shared/accessBarrierSupport.inline.hpp"
 #include "gc/shared/cardTable.hpp"
+#include "gc/shared/oopStorage.hpp"
 #include "gc/shenandoah/shenandoahAsserts.hpp"
 #include "gc/shenandoah/shenandoahCollectionSet.inline.hpp"
 #include "gc/shenandoah/shenandoahEvacOOMHandler.inline.hpp"
@@ -64,6 +65,10 @@ inline oop ShenandoahBarrierSet::load_reference_barrier_mutator(oop obj, T* load
   assert(ShenandoahLoadRefBarrier, "should be enabled");
   shenandoah_assert_in_cset(load_addr, obj);
 
+  if (ShenandoahRegionAccessSampleRate > 0) {
+    sample_access(load_addr);
+  }
+
   oop fwd = resolve_forwarded_not_null_mutator(obj);
   if (obj == fwd) {
     assert(_heap->is_evacuation_in_progress(),
@@ -81,6 +86,14 @@ inline oop ShenandoahBarrierSet::load_reference_barrier_mutator(oop obj, T* load
   return fwd;
 }
 
+inline void ShenandoahBarrierSet::sample_access(void* load_addr) {
+  if (load_addr != nullptr &&
+      ShenandoahThreadLocalData::should_sample_access(Thread::current()) &&
+      _heap->is_in(load_addr)) {
+    _heap->heap_region_containing(load_addr)->record_access_sample();
+  }
+}
+
 inline oop ShenandoahBarrierSet::load_reference_barrier(oop obj) {
   if (!ShenandoahLoadRefBarrier) {
     return obj;
@@ -268,10 +281,21 @@ inline void ShenandoahBarrierSet::AccessBarrier<decorators, BarrierSetT>::oop_st
   Raw::oop_store(addr, value);
 }
 
+template <DecoratorSet decorators, typename BarrierSetT>
+template <typename T>
+inline void ShenandoahBarrierSet::AccessBarrier<decorators, BarrierSetT>::note_weak_root_store(T* addr) {
+  // Must follow the store: weak root processing samples the block before reading its entries.
+  if ((decorators & (ON_WEAK_OOP_REF | ON_PHANTOM_OOP_REF)) != 0 &&
+      ShenandoahHeap::heap()->notes_weak_root_stores()) {
+    OopStorage::note_weak_store(reinterpret_cast<oop*>(addr));
+  }
+}
+
 template <DecoratorSet decorators, typename BarrierSetT>
 template <typename T>
 inline void ShenandoahBarrierSet::AccessBarrier<decorators, BarrierSetT>::oop_store_not_in_heap(T* addr, oop value) {
   oop_store_common(addr, value);
+  note_weak_root_store(addr);
 }
 
 template <DecoratorSet decorators, typename BarrierSetT>
@@ -297,7 +321,9 @@ template <typename T>
 inline oop ShenandoahBarrierSet::AccessBarrier<decorators, BarrierSetT>::oop_atomic_cmpxchg_not_in_heap(T* addr, oop compare_value, oop new_value) {
   assert((decorators & (AS_NO_KEEPALIVE | ON_UNKNOWN_OOP_REF)) == 0, "must be absent");
   ShenandoahBarrierSet* bs = ShenandoahBarrierSet::barrier_set();
-  return bs->oop_cmpxchg(decorators, addr, compare_value, new_value);
+  oop result = bs->oop_cmpxchg(decorators, addr, compare_value, new_value);
+  note_weak_root_store(addr);
+  return result;
 }
 
 template <DecoratorSet decorators, typename BarrierSetT>
@@ -330,7 +356,9 @@ template <typename T>
 inline oop ShenandoahBarrierSet::AccessBarrier<decorators, BarrierSetT>::oop_atomic_xchg_not_in_heap(T* addr, oop new_value) {
   assert((decorators & (AS_NO_KEEPALIVE | ON_UNKNOWN_OOP_REF)) == 0, "must be absent");
   ShenandoahBarrierSet* bs = ShenandoahBarrierSet::barrier_set();
-  return bs->oop_xchg(decorators, addr, new_value);
+  oop result = bs->oop_xchg(decorators, addr, new_value);
+  note_weak_root_store(addr);
+  return result;
 }
 
 template <DecoratorSet decorators, typename BarrierSetT>
@@ -384,6 +412,22 @@ bool ShenandoahBarrierSet::AccessBarrier<decorators, BarrierSetT>::oop_arraycopy
   return result;
 }
 
+// Returns the first group of elements in [start, end) that has a referent in the collection set,
+// or the trailing partial group. Each group is tested with a single batch lookup in the map.
+template <class T>
+T* ShenandoahBarrierSet::arraycopy_find_cset_group(T* start, T* end) const {
+  STATIC_ASSERT(ARRAYCOPY_CSET_SCAN_GROUP <= ShenandoahCollectionSet::MAX_MASK_REFS);
+  const ShenandoahCollectionSet* const cset = _heap->collection_set();
+  T* p = start;
+  while (pointer_delta(end, p, sizeof(T)) >= ARRAYCOPY_CSET_SCAN_GROUP) {
+    if (cset->in_cset_mask(p, ARRAYCOPY_CSET_SCAN_GROUP) != 0) {
+      return p;
+    }
+    p += ARRAYCOPY_CSET_SCAN_GROUP;
+  }
+  return p;
+}
+
 template <class T, bool HAS_FWD, bool EVAC, bool ENQUEUE>
 void ShenandoahBarrierSet::arraycopy_work(T* src, size_t count) {
   // We allow forwarding in young generation and marking in old generation
@@ -395,24 +439,47 @@ void ShenandoahBarrierSet::arraycopy_work(T* src, size_t count) {
   ShenandoahMarkingContext* ctx = _heap->marking_context();
   const ShenandoahCollectionSet* const cset = _heap->collection_set();
   T* end = src + count;
-  for (T* elem_ptr = src; elem_ptr < end; elem_ptr++) {
-    T o = RawAccess<>::oop_load(elem_ptr);
-    if (!CompressedOops::is_null(o)) {
-      oop obj = CompressedOops::decode_not_null(o);
-      if (HAS_FWD && cset->is_in(obj)) {
-        oop fwd = resolve_forwarded_not_null(obj);
-        if (EVAC && obj == fwd) {
-          fwd = _heap->evacuate_object(obj, thread);
+  T* elem_ptr = src;
+  // The SATB index is kept in a local and written back once, so enqueueing is a
+  // plain store until the buffer fills up.
+  size_t satb_index = ENQUEUE ? queue.index() : 0;
+  assert(!ENQUEUE || queue.is_active(), "SATB queue must be active while marking");
+  while (elem_ptr < end) {
+    T* group_end = end;
+    if (HAS_FWD && !ENQUEUE) {
+      // Only the elements that point into the collection set need work
+      elem_ptr = arraycopy_find_cset_group(elem_ptr, end);
+      group_end = MIN2(elem_ptr + ARRAYCOPY_CSET_SCAN_GROUP, end);
+    }
+    for (; elem_ptr < group_end; elem_ptr++) {
+      T o = RawAccess<>::oop_load(elem_ptr);
+      if (!CompressedOops::is_null(o)) {
+        oop obj = CompressedOops::decode_not_null(o);
+        if (HAS_FWD && cset->is_in(obj)) {
+          oop fwd = resolve_forwarded_not_null(obj);
+          if (EVAC && obj == fwd) {
+            fwd = _heap->evacuate_object(obj, thread);
+          }
+          shenandoah_assert_forwarded_except(elem_ptr, obj, _heap->cancelled_gc());
+          ShenandoahHeap::atomic_update_oop(fwd, elem_ptr, o);
+          obj = fwd;
+        }
+        if (ENQUEUE && !ctx->is_marked_strong_or_old(obj)) {
+          if (satb_index > 0) {
+            queue.buffer()[--satb_index] = cast_from_oop<void*>(obj);
+          } else {
+            // No buffer or a full one, let the queue set hand out a new buffer
+            queue.set_index(satb_index);
+            _satb_mark_queue_set.enqueue_known_active(queue, obj);
+            satb_index = queue.index();
+          }
         }
-        shenandoah_assert_forwarded_except(elem_ptr, obj, _heap->cancelled_gc());
-        ShenandoahHeap::atomic_update_oop(fwd, elem_ptr, o);
-        obj = fwd;
-      }
-      if (ENQUEUE && !ctx->is_marked_strong_or_old(obj)) {
-        _satb_mark_queue_set.enqueue_known_active(queue, obj);
       }
     }
   }
+  if (ENQUEUE) {
+    queue.set_index(satb_index);
+  }
 }
 
 template <class T>
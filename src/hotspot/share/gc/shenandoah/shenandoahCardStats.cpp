@@ -27,6 +27,19 @@
 
 #include "gc/shenandoah/shenandoahCardStats.hpp"
 #include "logging/log.hpp"
+#include "runtime/os.hpp"
+
+ShenandoahCardScanCounter::ShenandoahCardScanCounter(size_t cards, ShenandoahCardScanTotals* worker_totals) :
+  _worker_totals(worker_totals),
+  _start(os::elapsed_counter()) {
+  _local.clear();
+  _local._cards = cards;
+}
+
+ShenandoahCardScanCounter::~ShenandoahCardScanCounter() {
+  _local._ticks = os::elapsed_counter() - _start;
+  _worker_totals->add(_local);
+}
 
 #ifndef PRODUCT
 void ShenandoahCardStats::log() const {
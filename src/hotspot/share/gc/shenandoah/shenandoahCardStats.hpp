@@ -129,4 +129,49 @@ public:
   void log() const PRODUCT_RETURN;
 };
 
+// Totals of one worker for one remembered set scan. Unlike the distributions kept by
+// ShenandoahCardStats, these are maintained in product builds: they cost a few additions
+// per run of cards, and are published once per scan.
+struct ShenandoahCardScanTotals {
+  size_t _cards;          // cards examined
+  size_t _dirty_cards;    // of which dirty
+  size_t _objects;        // objects scanned on dirty cards
+  jlong  _ticks;          // time spent examining the cards
+
+  void clear() {
+    _cards = 0;
+    _dirty_cards = 0;
+    _objects = 0;
+    _ticks = 0;
+  }
+
+  void add(const ShenandoahCardScanTotals& other) {
+    _cards += other._cards;
+    _dirty_cards += other._dirty_cards;
+    _objects += other._objects;
+    _ticks += other._ticks;
+  }
+};
+
+// Counts the work of one invocation of process_clusters on the stack, and adds it to
+// the totals of the worker when it goes out of scope.
+class ShenandoahCardScanCounter : public StackObj {
+private:
+  ShenandoahCardScanTotals* const _worker_totals;
+  ShenandoahCardScanTotals _local;
+  const jlong _start;
+
+public:
+  ShenandoahCardScanCounter(size_t cards, ShenandoahCardScanTotals* worker_totals);
+  ~ShenandoahCardScanCounter();
+
+  inline void record_dirty_run(size_t len) {
+    _local._dirty_cards += len;
+  }
+
+  inline void record_scan_obj_cnt(size_t i) {
+    _local._objects += i;
+  }
+};
+
 #endif // SHARE_GC_SHENANDOAH_SHENANDOAHCARDSTATS_HPP
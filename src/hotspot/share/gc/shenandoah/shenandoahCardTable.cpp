@@ -25,6 +25,7 @@
 #include "precompiled.hpp"
 #include "gc/shenandoah/shenandoahCardTable.hpp"
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahHugePages.hpp"
 #include "gc/shenandoah/shenandoahUtils.hpp"
 #include "runtime/init.hpp"
 #include "services/memTracker.hpp"
@@ -77,10 +78,8 @@ void ShenandoahCardTable::initialize() {
                   p2i(&_read_byte_map[0]), p2i(&_read_byte_map[last_valid_index()]));
   log_trace(gc, barrier)("    _read_byte_map_base: " INTPTR_FORMAT, p2i(_read_byte_map_base));
 
-  // TODO: As currently implemented, we do not swap pointers between _read_byte_map and _write_byte_map
-  // because the mutator write barrier hard codes the address of the _write_byte_map_base.  Instead,
-  // the current implementation simply copies contents of _write_byte_map onto _read_byte_map and cleans
-  // the entirety of _write_byte_map at the init_mark safepoint.
+  // The mutator write barrier loads _write_byte_map_base from ShenandoahThreadLocalData, so the
+  // pointers to _read_byte_map and _write_byte_map may be swapped at the init_mark safepoint.
   //
   // Alternatively, we may switch to a SATB-based write barrier and replace the direct card-marking
   // remembered set with something entirely different.
@@ -96,6 +95,8 @@ void ShenandoahCardTable::initialize(const ReservedSpace& card_table) {
   }
   os::commit_memory_or_exit(card_table.base(), _byte_map_size, card_table.alignment(), false,
                             "Cannot commit memory for card table");
+  // Card tables are scanned with the heap during the remembered set scan
+  ShenandoahHugePages::advise(card_table.base(), _byte_map_size);
 }
 
 bool ShenandoahCardTable::is_in_young(const void* obj) const {
@@ -126,9 +127,8 @@ void ShenandoahCardTable::clear_read_table() {
   }
 }
 
-// TODO: This service is not currently used because the mutator write barrier implementation hard codes the
-// location of the _write_byte_may_base.  If we change the mutator's write barrier implementation, then we
-// may use this service to exchange the roles of the read-card-table and write-card-table.
+// Exchange the roles of the read-card-table and write-card-table. The caller publishes the new
+// _write_byte_map_base to the thread-local data of all mutators before they resume.
 void ShenandoahCardTable::swap_card_tables() {
   shenandoah_assert_safepoint();
 
@@ -36,7 +36,9 @@ class ShenandoahCardTable: public CardTable {
 protected:
   // We maintain two copies of the card table to facilitate concurrent remembered set scanning
   // and concurrent clearing of stale remembered set information.  During the init_mark safepoint,
-  // we copy the contents of _write_byte_map to _read_byte_map and clear _write_byte_map.
+  // we exchange _write_byte_map and _read_byte_map (see swap_card_tables()), after the read table
+  // has been cleaned during concurrent reset.  Unless ShenandoahSwapCardTables is disabled, in which
+  // case we copy the contents of _write_byte_map to _read_byte_map and clear _write_byte_map.
   //
   // Concurrent remembered set scanning reads from _read_byte_map while concurrent mutator write
   // barriers are overwriting cards of the _write_byte_map with DIRTY codes.  Concurrent remembered
@@ -46,10 +48,9 @@ protected:
   // During a concurrent update-references phase, we scan the _write_byte_map concurrently to find
   // all old-gen references that may need to be updated.
   //
-  // In a future implementation, we may swap the values of _read_byte_map and _write_byte_map during
-  // the init-mark safepoint to avoid the need for bulk STW copying and initialization.  Doing so
-  // requires a change to the implementation of mutator write barriers as the address of the card
-  // table is currently in-lined and hard-coded.
+  // Mutator write barriers do not in-line the address of the card table.  They load the biased
+  // base of the current write table from ShenandoahThreadLocalData, which is updated for all
+  // Java threads whenever the tables are swapped.
   CardValue* _read_byte_map;
   CardValue* _write_byte_map;
   CardValue* _read_byte_map_base;
@@ -66,6 +67,8 @@ public:
 
   size_t last_valid_index();
 
+  size_t byte_map_size() const { return _byte_map_size; }
+
   void clear_read_table();
 
   // Exchange the roles of the read and write card tables.
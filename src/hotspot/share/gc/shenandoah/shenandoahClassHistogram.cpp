@@ -0,0 +1,174 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+
+#include "gc/shenandoah/shenandoahClassHistogram.hpp"
+
+#if INCLUDE_SERVICES
+
+#include "gc/shared/gcId.hpp"
+#include "logging/log.hpp"
+#include "memory/heapInspection.hpp"
+#include "memory/resourceArea.hpp"
+#include "runtime/mutex.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/os.hpp"
+#include "utilities/ostream.hpp"
+
+class ShenandoahClassHistogram::WorkerTable : public CHeapObj<mtGC> {
+public:
+  KlassInfoTable _table;
+  WorkerTable() : _table(false /* add_all_classes */) {}
+};
+
+class ShenandoahClassHistogramClosure : public KlassInfoClosure {
+private:
+  KlassInfoHisto* const _histo;
+
+public:
+  ShenandoahClassHistogramClosure(KlassInfoHisto* histo) : _histo(histo) {}
+
+  void do_cinfo(KlassInfoEntry* cie) {
+    _histo->add(cie);
+  }
+};
+
+ShenandoahClassHistogram::ShenandoahClassHistogram(uint max_workers) :
+  _max_workers(max_workers),
+  _tables(nullptr),
+  _lock(new Mutex(Mutex::nosafepoint, "ShenandoahClassHistogram_lock")),
+  _snapshot(nullptr),
+  _snapshot_time_ms(0),
+  _snapshot_gc_id(0) {
+}
+
+ShenandoahClassHistogram::~ShenandoahClassHistogram() {
+  delete_tables();
+  os::free(_snapshot);
+  delete _lock;
+}
+
+void ShenandoahClassHistogram::delete_tables() {
+  if (_tables != nullptr) {
+    for (uint i = 0; i < _max_workers; i++) {
+      delete _tables[i];
+    }
+    FREE_C_HEAP_ARRAY(WorkerTable*, _tables);
+    _tables = nullptr;
+  }
+}
+
+void ShenandoahClassHistogram::prepare() {
+  delete_tables();
+  WorkerTable** tables = NEW_C_HEAP_ARRAY(WorkerTable*, _max_workers, mtGC);
+  for (uint i = 0; i < _max_workers; i++) {
+    tables[i] = new WorkerTable();
+    if (tables[i]->_table.allocation_failed()) {
+      log_info(gc)("Out of C-heap, class histogram is not recorded");
+      for (uint j = 0; j <= i; j++) {
+        delete tables[j];
+      }
+      FREE_C_HEAP_ARRAY(WorkerTable*, tables);
+      return;
+    }
+  }
+  _tables = tables;
+}
+
+void ShenandoahClassHistogram::record(uint worker_id, oop obj) {
+  if (_tables != nullptr) {
+    assert(worker_id < _max_workers, "worker_id (%u) out of range (%u)", worker_id, _max_workers);
+    // Entries that cannot be allocated are just not counted: the histogram is a diagnostic.
+    _tables[worker_id]->_table.record_instance(obj);
+  }
+}
+
+void ShenandoahClassHistogram::abandon() {
+  delete_tables();
+}
+
+void ShenandoahClassHistogram::finish() {
+  if (_tables == nullptr) {
+    return;
+  }
+
+  KlassInfoTable* merged = &_tables[0]->_table;
+  bool complete = true;
+  for (uint i = 1; i < _max_workers; i++) {
+    complete &= merged->merge(&_tables[i]->_table);
+  }
+
+  char* snapshot;
+  {
+    ResourceMark rm;
+    stringStream ss;
+    if (!complete) {
+      ss.print_cr("WARNING: Ran out of C-heap; undercounted instances in data below");
+    }
+    KlassInfoHisto histo(merged);
+    ShenandoahClassHistogramClosure cl(&histo);
+    merged->iterate(&cl);
+    histo.sort();
+    histo.print_histo_on(&ss);
+    snapshot = ss.as_string(true /* c_heap */);
+  }
+  delete_tables();
+
+  char* old_snapshot;
+  {
+    MutexLocker ml(_lock, Mutex::_no_safepoint_check_flag);
+    old_snapshot = _snapshot;
+    _snapshot = snapshot;
+    _snapshot_time_ms = os::javaTimeMillis();
+    _snapshot_gc_id = GCId::current();
+  }
+  os::free(old_snapshot);
+}
+
+bool ShenandoahClassHistogram::print_on(outputStream* st) const {
+  char* snapshot;
+  jlong time_ms;
+  uint gc_id;
+  {
+    MutexLocker ml(_lock, Mutex::_no_safepoint_check_flag);
+    if (_snapshot == nullptr) {
+      return false;
+    }
+    snapshot = os::strdup(_snapshot, mtGC);
+    time_ms = _snapshot_time_ms;
+    gc_id = _snapshot_gc_id;
+  }
+  if (snapshot == nullptr) {
+    st->print_cr("ERROR: Ran out of C-heap; histogram not printed");
+    return true;
+  }
+  st->print_cr("Live objects at the end of marking in GC(%u), " JLONG_FORMAT "ms ago:",
+               gc_id, os::javaTimeMillis() - time_ms);
+  st->print_raw(snapshot);
+  os::free(snapshot);
+  return true;
+}
+
+#endif // INCLUDE_SERVICES
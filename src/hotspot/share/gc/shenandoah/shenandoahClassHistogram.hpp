@@ -0,0 +1,79 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_GC_SHENANDOAH_SHENANDOAHCLASSHISTOGRAM_HPP
+#define SHARE_GC_SHENANDOAH_SHENANDOAHCLASSHISTOGRAM_HPP
+
+#include "memory/allocation.hpp"
+#include "oops/oopsHierarchy.hpp"
+#include "utilities/macros.hpp"
+
+#if INCLUDE_SERVICES
+
+class Mutex;
+class outputStream;
+
+// Class histogram of the live objects, computed as a side product of global marking. Each
+// marking worker records the objects it counts liveness for in its own table, and the tables
+// are merged and formatted by the control thread after final mark, while the classes of the
+// recorded objects are still guaranteed to be loaded. The last histogram is kept as text, and
+// can be printed at any later time without a pause. See ShenandoahMarkingClassHistogram.
+class ShenandoahClassHistogram : public CHeapObj<mtGC> {
+private:
+  class WorkerTable;
+
+  const uint    _max_workers;
+  WorkerTable** _tables;
+
+  Mutex*        _lock;
+  char*         _snapshot;
+  jlong         _snapshot_time_ms;
+  uint          _snapshot_gc_id;
+
+  void delete_tables();
+
+public:
+  ShenandoahClassHistogram(uint max_workers);
+  ~ShenandoahClassHistogram();
+
+  // Start recording for an upcoming global marking. Called by the control thread before
+  // marking starts.
+  void prepare();
+
+  bool is_recording() const { return _tables != nullptr; }
+  void record(uint worker_id, oop obj);
+
+  // Marking has completed. Merge and format what the workers recorded.
+  void finish();
+
+  // Marking did not complete, drop what the workers recorded.
+  void abandon();
+
+  // Prints the last histogram, returns false if there is none yet.
+  bool print_on(outputStream* st) const;
+};
+
+#endif // INCLUDE_SERVICES
+
+#endif // SHARE_GC_SHENANDOAH_SHENANDOAHCLASSHISTOGRAM_HPP
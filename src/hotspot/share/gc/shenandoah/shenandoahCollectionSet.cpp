@@ -47,6 +47,7 @@ ShenandoahCollectionSet::ShenandoahCollectionSet(ShenandoahHeap* heap, ReservedS
   _used(0),
   _live(0),
   _region_count(0),
+  _pinned_region_count(0),
   _old_garbage(0),
   _preselected_regions(nullptr),
   _current_index(0) {
@@ -107,6 +108,9 @@ void ShenandoahCollectionSet::add_region(ShenandoahHeapRegion* r) {
   }
 
   _region_count++;
+  if (r->is_pinned()) {
+    _pinned_region_count++;
+  }
   _has_old_regions |= r->is_old();
   _garbage += garbage;
   _used += r->used();
@@ -132,6 +136,7 @@ void ShenandoahCollectionSet::clear() {
   _live = 0;
 
   _region_count = 0;
+  _pinned_region_count = 0;
   _current_index = 0;
 
   _young_bytes_to_evacuate = 0;
@@ -57,6 +57,7 @@ private:
   size_t                _used;
   size_t                _live;
   size_t                _region_count;
+  size_t                _pinned_region_count;
 
   size_t                _young_bytes_to_evacuate;
   size_t                _young_bytes_to_promote;
@@ -91,6 +92,8 @@ public:
   ShenandoahHeapRegion* next();
 
   size_t count()  const { return _region_count; }
+  // Pinned regions are not reclaimed when evacuation completes, see ShenandoahEvacuatePinnedRegions.
+  size_t pinned_count() const { return _pinned_region_count; }
   bool is_empty() const { return _region_count == 0; }
 
   void clear_current_index() {
@@ -102,6 +105,14 @@ public:
   inline bool is_in(oop obj)                 const;
   inline bool is_in_loc(void* loc)           const;
 
+  // Tests up to MAX_MASK_REFS consecutive references at refs, oops or narrowOops, and returns a
+  // mask with bit i set when refs[i] points into the collection set. Each reference is shifted
+  // and looked up in the biased map without a branch, so that the compiler can turn the loop
+  // into gathers. Nulls are never in the collection set.
+  static const uint MAX_MASK_REFS = BitsPerByte * sizeof(uint);
+  template <class T>
+  inline uint in_cset_mask(const T* refs, uint count) const;
+
   void print_on(outputStream* out) const;
 
   // It is not known how many of these bytes will be promoted.
@@ -31,6 +31,8 @@
 #include "gc/shenandoah/shenandoahHeap.hpp"
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahHeapRegion.hpp"
+#include "oops/access.inline.hpp"
+#include "oops/compressedOops.inline.hpp"
 
 bool ShenandoahCollectionSet::is_in(size_t region_idx) const {
   assert(region_idx < _heap->num_regions(), "Sanity");
@@ -54,6 +56,19 @@ bool ShenandoahCollectionSet::is_in_loc(void* p) const {
   return _biased_cset_map[index] == 1;
 }
 
+template <class T>
+uint ShenandoahCollectionSet::in_cset_mask(const T* refs, uint count) const {
+  assert(count <= MAX_MASK_REFS, "Mask has room for " UINT32_FORMAT " references", MAX_MASK_REFS);
+  uint mask = 0;
+  for (uint i = 0; i < count; i++) {
+    T o = RawAccess<>::oop_load(const_cast<T*>(refs + i));
+    uintx index = cast_from_oop<uintx>(CompressedOops::decode(o)) >> _region_size_bytes_shift;
+    // Map entries are 0 or 1, and nulls index the committed zero page of the biased map
+    mask |= ((uint)(uint8_t)_biased_cset_map[index]) << i;
+  }
+  return mask;
+}
+
 size_t ShenandoahCollectionSet::get_old_bytes_reserved_for_evacuation() {
   return _old_bytes_to_evacuate;
 }
@@ -25,10 +25,13 @@
 
 #include "precompiled.hpp"
 
+#include "classfile/stringTable.hpp"
+#include "classfile/symbolTable.hpp"
 #include "gc/shared/barrierSetNMethod.hpp"
 #include "gc/shared/collectorCounters.hpp"
 #include "gc/shared/continuationGCSupport.inline.hpp"
 #include "gc/shenandoah/shenandoahBreakpoint.hpp"
+#include "gc/shenandoah/shenandoahClassHistogram.hpp"
 #include "gc/shenandoah/shenandoahCollectorPolicy.hpp"
 #include "gc/shenandoah/shenandoahConcurrentGC.hpp"
 #include "gc/shenandoah/shenandoahFreeSet.hpp"
@@ -110,6 +113,12 @@ bool ShenandoahConcurrentGC::collect(GCCause::Cause cause) {
   // Reset for upcoming marking
   entry_reset();
 
+#if INCLUDE_SERVICES
+  if (ShenandoahMarkingClassHistogram && _generation->is_global()) {
+    heap->class_histogram()->prepare();
+  }
+#endif
+
   // Start initial mark under STW
   vmop_entry_init_mark();
 
@@ -165,6 +174,13 @@ bool ShenandoahConcurrentGC::collect(GCCause::Cause cause) {
     return false;
   }
 
+#if INCLUDE_SERVICES
+  if (ShenandoahMarkingClassHistogram) {
+    // Before concurrent class unloading, although only the classes of dead objects get unloaded.
+    heap->class_histogram()->finish();
+  }
+#endif
+
   // Concurrent stack processing
   if (heap->is_evacuation_in_progress()) {
     entry_thread_roots();
@@ -213,8 +229,13 @@ bool ShenandoahConcurrentGC::collect(GCCause::Cause cause) {
   }
 
   if (heap->has_forwarded_objects()) {
-    // Perform update-refs phase.
-    vmop_entry_init_updaterefs();
+    // Perform update-refs phase. Evacuating a small collection set takes little time, so the
+    // pause that starts update-refs would be a large part of the cost: use a handshake instead.
+    if (!ShenandoahVerify && heap->collection_set()->count() <= ShenandoahFuseUpdateRefsCSetRegions) {
+      entry_concurrent_init_updaterefs();
+    } else {
+      vmop_entry_init_updaterefs();
+    }
     entry_updaterefs();
     if (check_cancellation_and_abort(ShenandoahDegenPoint::_degenerated_updaterefs)) {
       return false;
@@ -228,6 +249,10 @@ bool ShenandoahConcurrentGC::collect(GCCause::Cause cause) {
 
     vmop_entry_final_updaterefs();
 
+    // The collection set is trash now. Allocating threads recycle trash regions themselves when they
+    // allocate in them, so there is no need for the stalled ones to wait until the cleanup is done.
+    heap->control_thread()->notify_alloc_stall_waiters();
+
     // Update references freed up collection set, kick the cleanup to reclaim the space.
     entry_cleanup_complete();
   } else {
@@ -239,6 +264,19 @@ bool ShenandoahConcurrentGC::collect(GCCause::Cause cause) {
     _abbreviated = true;
   }
 
+  // Clear the mark bitmaps now, while the heuristics wait for the next cycle, rather than in
+  // the concurrent reset of the next cycle, when allocations may already run short of memory.
+  // Generational mode keeps the marks of old regions, so it only does this after young cycles.
+  if (ShenandoahResetAfterCollect && !heap->cancelled_gc() &&
+      (!heap->mode()->is_generational() || _generation->is_young())) {
+    entry_reset_after_collect();
+  }
+
+  // Memory is reclaimed, metadata of unloaded classes can be freed now.
+  if (heap->has_deferred_class_unloading_purge()) {
+    entry_class_unloading_purge();
+  }
+
   // We defer generation resizing actions until after cset regions have been recycled.  We do this even following an
   // abbreviated cycle.
   if (heap->mode()->is_generational()) {
@@ -477,7 +515,7 @@ void ShenandoahConcurrentGC::entry_class_unloading() {
   EventMark em("%s", msg);
 
   ShenandoahWorkerScope scope(heap->workers(),
-                              ShenandoahWorkerPolicy::calc_workers_for_conc_root_processing(),
+                              ShenandoahWorkerPolicy::calc_workers_for_conc_class_unloading(),
                               "concurrent class unloading");
 
   heap->try_inject_alloc_failure();
@@ -542,6 +580,18 @@ void ShenandoahConcurrentGC::entry_update_thread_roots() {
   op_update_thread_roots();
 }
 
+void ShenandoahConcurrentGC::entry_concurrent_init_updaterefs() {
+  ShenandoahHeap* const heap = ShenandoahHeap::heap();
+  TraceCollectorStats tcs(heap->monitoring_support()->concurrent_collection_counters());
+  static const char* msg = "Concurrent init update references";
+  ShenandoahConcurrentPhase gc_phase(msg, ShenandoahPhaseTimings::conc_init_update_refs);
+  EventMark em("%s", msg);
+
+  // No workers used in this phase, no setup required
+  heap->try_inject_alloc_failure();
+  op_concurrent_init_updaterefs();
+}
+
 void ShenandoahConcurrentGC::entry_updaterefs() {
   ShenandoahHeap* const heap = ShenandoahHeap::heap();
   TraceCollectorStats tcs(heap->monitoring_support()->concurrent_collection_counters());
@@ -569,12 +619,45 @@ void ShenandoahConcurrentGC::entry_cleanup_complete() {
   op_cleanup_complete();
 }
 
+void ShenandoahConcurrentGC::entry_reset_after_collect() {
+  ShenandoahHeap* const heap = ShenandoahHeap::heap();
+  TraceCollectorStats tcs(heap->monitoring_support()->concurrent_collection_counters());
+  static const char* msg = "Concurrent reset after collect";
+  ShenandoahConcurrentPhase gc_phase(msg, ShenandoahPhaseTimings::conc_reset_after_collect);
+  EventMark em("%s", msg);
+
+  ShenandoahWorkerScope scope(heap->workers(),
+                              ShenandoahWorkerPolicy::calc_workers_for_conc_reset(),
+                              msg);
+
+  heap->try_inject_alloc_failure();
+  op_reset_after_collect();
+}
+
+void ShenandoahConcurrentGC::entry_class_unloading_purge() {
+  ShenandoahHeap* const heap = ShenandoahHeap::heap();
+  TraceCollectorStats tcs(heap->monitoring_support()->concurrent_collection_counters());
+  static const char* msg = "Concurrent metadata purge";
+  ShenandoahConcurrentPhase gc_phase(msg, ShenandoahPhaseTimings::conc_class_unload_deferred_purge);
+  EventMark em("%s", msg);
+
+  // Workers, if used, only delete class loader data, and do not need the concurrent
+  // phase worker setup.
+  heap->do_deferred_class_unloading_purge();
+}
+
 void ShenandoahConcurrentGC::op_reset() {
   ShenandoahHeap* const heap = ShenandoahHeap::heap();
   if (ShenandoahPacing) {
     heap->pacer()->setup_for_reset();
   }
   _generation->prepare_gc();
+
+  if (heap->mode()->is_generational() && ShenandoahSwapCardTables) {
+    // The read card table is not used again before it becomes the write table at the next
+    // remembered set swap, so it is cleaned here rather than under the init-mark pause.
+    _generation->clean_read_card_table();
+  }
 }
 
 class ShenandoahInitMarkUpdateRegionStateClosure : public ShenandoahHeapRegionClosure {
@@ -614,12 +697,13 @@ void ShenandoahConcurrentGC::op_init_mark() {
   assert(!_generation->is_mark_complete(), "should not be complete");
   assert(!heap->has_forwarded_objects(), "No forwarded objects on this path");
 
+  heap->set_ref_summary_exact(false);
 
   if (heap->mode()->is_generational()) {
     if (_generation->is_young() || (_generation->is_global() && ShenandoahVerify)) {
-      // The current implementation of swap_remembered_set() copies the write-card-table
-      // to the read-card-table. The remembered sets are also swapped for GLOBAL collections
-      // so that the verifier works with the correct copy of the card table when verifying.
+      // swap_remembered_set() makes the write-card-table the read-card-table. The remembered
+      // sets are also swapped for GLOBAL collections so that the verifier works with the
+      // correct copy of the card table when verifying.
       // TODO: This path should not really depend on ShenandoahVerify.
       ShenandoahGCPhase phase(ShenandoahPhaseTimings::init_swap_rset);
       _generation->swap_remembered_set();
@@ -689,6 +773,10 @@ void ShenandoahConcurrentGC::op_mark_roots() {
 
 void ShenandoahConcurrentGC::op_mark() {
   _mark.concurrent_mark();
+  if (ShenandoahPresortCollectionSet && !_generation->is_old() && !ShenandoahHeap::heap()->cancelled_gc()) {
+    // Sort the candidates while the mutators run, final mark only sorts those that changed since.
+    _generation->heuristics()->presort_candidates(_generation);
+  }
 }
 
 void ShenandoahConcurrentGC::op_final_mark() {
@@ -773,6 +861,10 @@ void ShenandoahConcurrentGC::op_final_mark() {
         // root evacuation has completed (see op_strong_roots).
         ShenandoahCodeRoots::arm_nmethods_for_evac();
         ShenandoahStackWatermark::change_epoch_id();
+
+        if (UseTLAB && ShenandoahPrefilledGCLABSize > 0) {
+          heap->prefill_mutator_gclabs();
+        }
       }
 
       if (ShenandoahPacing) {
@@ -933,13 +1025,24 @@ private:
   ShenandoahConcurrentNMethodIterator        _nmethod_itr;
   ShenandoahPhaseTimings::Phase              _phase;
 
+  // Settled weak root blocks, see ShenandoahSettledWeakRoots. Blocks only settle on old
+  // referents outside the collection set, which young cycles without old regions in the
+  // collection set neither clear nor update, so those cycles can skip them.
+  const bool                                 _settle;
+  const bool                                 _skip_settled;
+  volatile size_t                            _skipped;
+
 public:
   ShenandoahConcurrentWeakRootsEvacUpdateTask(ShenandoahPhaseTimings::Phase phase) :
     WorkerTask("Shenandoah Evacuate/Update Concurrent Weak Roots"),
     _vm_roots(phase),
     _cld_roots(phase, ShenandoahHeap::heap()->workers()->active_workers(), false /*heap iteration*/),
     _nmethod_itr(ShenandoahCodeRoots::table()),
-    _phase(phase) {
+    _phase(phase),
+    _settle(ShenandoahHeap::heap()->notes_weak_root_stores()),
+    _skip_settled(_settle && ShenandoahHeap::heap()->active_generation()->is_young() &&
+                  !ShenandoahHeap::heap()->collection_set()->has_old_regions()),
+    _skipped(0) {
     if (ShenandoahHeap::heap()->unload_classes()) {
       MutexLocker mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
       _nmethod_itr.nmethods_do_begin();
@@ -953,6 +1056,9 @@ public:
     }
     // Notify runtime data structures of potentially dead oops
     _vm_roots.report_num_dead();
+    if (_skip_settled) {
+      log_debug(gc)("Skipped " SIZE_FORMAT " settled weak root blocks", _skipped);
+    }
   }
 
   void work(uint worker_id) {
@@ -963,7 +1069,17 @@ public:
       // jni_roots and weak_roots are OopStorage backed roots, concurrent iteration
       // may race against OopStorage::release() calls.
       ShenandoahEvacUpdateCleanupOopStorageRootsClosure cl;
-      _vm_roots.oops_do(&cl, worker_id);
+      if (_settle) {
+        ShenandoahHeap* const heap = ShenandoahHeap::heap();
+        auto settled = [&](oop* p) {
+          const oop obj = RawAccess<>::oop_load(p);
+          return !CompressedOops::is_null(obj) && heap->is_in_old(obj) && !heap->in_collection_set(obj);
+        };
+        size_t skipped = _vm_roots.oops_do_settling(&cl, settled, heap->settled_weak_roots_epoch(), _skip_settled, worker_id);
+        Atomic::add(&_skipped, skipped);
+      } else {
+        _vm_roots.oops_do(&cl, worker_id);
+      }
     }
 
     // If we are going to perform concurrent class unloading later on, we need to
@@ -990,6 +1106,47 @@ public:
   }
 };
 
+// Deletes the dead entries of the string and symbol tables with the GC workers, in place of
+// the service thread. Growing the tables is still left to the service thread.
+class ShenandoahConcurrentTableCleanupTask : public WorkerTask {
+private:
+  const bool _strings;
+  const bool _symbols;
+
+public:
+  ShenandoahConcurrentTableCleanupTask() :
+    WorkerTask("Shenandoah Concurrent Table Cleanup"),
+    _strings(StringTable::start_parallel_cleanup(Thread::current())),
+    _symbols(SymbolTable::start_parallel_cleanup(Thread::current())) {
+  }
+
+  ~ShenandoahConcurrentTableCleanupTask() {
+    if (_strings) {
+      StringTable::finish_parallel_cleanup(Thread::current());
+    }
+    if (_symbols) {
+      SymbolTable::finish_parallel_cleanup(Thread::current());
+    }
+  }
+
+  bool has_work() const {
+    return _strings || _symbols;
+  }
+
+  void work(uint worker_id) {
+    ShenandoahConcurrentWorkerSession worker_session(worker_id);
+    ShenandoahSuspendibleThreadSetJoiner sts_join;
+    ShenandoahHeap* const heap = ShenandoahHeap::heap();
+    Thread* const thread = Thread::current();
+    if (_strings) {
+      while (!heap->check_cancelled_gc_and_yield() && StringTable::do_parallel_cleanup(thread));
+    }
+    if (_symbols) {
+      while (!heap->check_cancelled_gc_and_yield() && SymbolTable::do_parallel_cleanup(thread));
+    }
+  }
+};
+
 void ShenandoahConcurrentGC::op_weak_roots() {
   ShenandoahHeap* const heap = ShenandoahHeap::heap();
   assert(heap->is_concurrent_weak_root_in_progress(), "Only during this phase");
@@ -1006,6 +1163,14 @@ void ShenandoahConcurrentGC::op_weak_roots() {
     ShenandoahTimingsTracker t(ShenandoahPhaseTimings::conc_weak_roots_rendezvous);
     heap->rendezvous_threads();
   }
+
+  if (ShenandoahParallelTableCleanup) {
+    ShenandoahTimingsTracker t(ShenandoahPhaseTimings::conc_weak_roots_tables);
+    ShenandoahConcurrentTableCleanupTask task;
+    if (task.has_work()) {
+      heap->workers()->run_task(&task);
+    }
+  }
 }
 
 void ShenandoahConcurrentGC::op_class_unloading() {
@@ -1018,17 +1183,26 @@ void ShenandoahConcurrentGC::op_class_unloading() {
 
 class ShenandoahEvacUpdateCodeCacheClosure : public NMethodClosure {
 private:
+  ShenandoahHeap* const                     _heap;
   BarrierSetNMethod* const                  _bs;
   ShenandoahEvacuateUpdateMetadataClosure   _cl;
 
 public:
   ShenandoahEvacUpdateCodeCacheClosure() :
+    _heap(ShenandoahHeap::heap()),
     _bs(BarrierSet::barrier_set()->barrier_set_nmethod()),
     _cl() {
   }
 
   void do_nmethod(nmethod* n) {
     ShenandoahNMethod* data = ShenandoahNMethod::gc_data(n);
+    // Most nmethods have no oops into the collection set: nothing to evacuate or patch, just
+    // disarm them. Racing entry barriers only ever replace cset oops with to-space copies.
+    // nmethods cannot be re-registered while the iteration is in progress.
+    if (!data->has_cset_oops(_heap)) {
+      _bs->disarm(n);
+      return;
+    }
     ShenandoahReentrantLocker locker(data->lock());
     // Setup EvacOOM scope below reentrant lock to avoid deadlock with
     // nmethod_entry_barrier
@@ -1123,6 +1297,14 @@ void ShenandoahConcurrentGC::op_init_updaterefs() {
   }
 }
 
+void ShenandoahConcurrentGC::op_concurrent_init_updaterefs() {
+  ShenandoahHeap* const heap = ShenandoahHeap::heap();
+  heap->concurrent_prepare_update_heap_references();
+  if (ShenandoahPacing) {
+    heap->pacer()->setup_for_updaterefs();
+  }
+}
+
 void ShenandoahConcurrentGC::op_updaterefs() {
   ShenandoahHeap::heap()->update_heap_references(true /*concurrent*/);
 }
@@ -1149,7 +1331,7 @@ void ShenandoahUpdateThreadClosure::do_thread(Thread* thread) {
 
 void ShenandoahConcurrentGC::op_update_thread_roots() {
   ShenandoahUpdateThreadClosure cl;
-  Handshake::execute(&cl);
+  ShenandoahHandshake::execute(&cl);
 }
 
 void ShenandoahConcurrentGC::op_final_updaterefs() {
@@ -1231,11 +1413,25 @@ void ShenandoahConcurrentGC::op_final_roots() {
 }
 
 void ShenandoahConcurrentGC::op_cleanup_complete() {
-  ShenandoahHeap::heap()->free_set()->recycle_trash();
+  ShenandoahHeap* const heap = ShenandoahHeap::heap();
+  heap->free_set()->recycle_trash();
+  heap->control_thread()->notify_alloc_stall_waiters();
+}
+
+void ShenandoahConcurrentGC::op_reset_after_collect() {
+  // Regions keep track of how much of their bitmap is dirty, so the concurrent reset of the
+  // next cycle only has to clear what gets marked in between.
+  _generation->reset_mark_bitmap();
 }
 
 bool ShenandoahConcurrentGC::check_cancellation_and_abort(ShenandoahDegenPoint point) {
   if (ShenandoahHeap::heap()->cancelled_gc()) {
+#if INCLUDE_SERVICES
+    if (ShenandoahMarkingClassHistogram) {
+      // The degenerated cycle marks on its own terms, what was recorded so far is incomplete.
+      ShenandoahHeap::heap()->class_histogram()->abandon();
+    }
+#endif
     _degen_point = point;
     return true;
   }
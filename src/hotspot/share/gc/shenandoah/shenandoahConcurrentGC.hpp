@@ -102,10 +102,13 @@ protected:
 
 private:
   void entry_evacuate();
+  void entry_concurrent_init_updaterefs();
   void entry_update_thread_roots();
   void entry_updaterefs();
 
   void entry_cleanup_complete();
+  void entry_reset_after_collect();
+  void entry_class_unloading_purge();
 
   // Actual work for the phases
   void op_reset();
@@ -120,12 +123,14 @@ private:
   void op_cleanup_early();
   void op_evacuate();
   void op_init_updaterefs();
+  void op_concurrent_init_updaterefs();
   void op_updaterefs();
   void op_update_thread_roots();
   void op_final_updaterefs();
   void op_final_roots();
 
   void op_cleanup_complete();
+  void op_reset_after_collect();
 
 protected:
   virtual void op_final_mark();
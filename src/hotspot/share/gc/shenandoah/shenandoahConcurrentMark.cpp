@@ -44,6 +44,7 @@
 #include "gc/shenandoah/shenandoahScanRemembered.inline.hpp"
 #include "memory/iterator.inline.hpp"
 #include "memory/resourceArea.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/continuation.hpp"
 #include "runtime/threads.hpp"
 
@@ -72,6 +73,29 @@ public:
   }
 };
 
+// Young workers trace a bounded share of the old marking work queued for the interrupted
+// old cycle, so that old marking converges no matter how often young cycles interrupt it.
+class ShenandoahMarkOldIncrementTask : public WorkerTask {
+private:
+  ShenandoahConcurrentMark* const _cm;
+  const size_t                    _budget;
+  volatile size_t                 _done;
+
+public:
+  ShenandoahMarkOldIncrementTask(ShenandoahConcurrentMark* cm, size_t budget) :
+    WorkerTask("Shenandoah Concurrent Mark Old Increment"), _cm(cm), _budget(budget), _done(0) {
+  }
+
+  void work(uint worker_id) {
+    ShenandoahConcurrentWorkerSession worker_session(worker_id);
+    ShenandoahSuspendibleThreadSetJoiner stsj;
+    size_t done = _cm->mark_old_tasks(worker_id, _budget);
+    Atomic::add(&_done, done, memory_order_relaxed);
+  }
+
+  size_t done() const { return Atomic::load(&_done); }
+};
+
 class ShenandoahSATBAndRemarkThreadsClosure : public ThreadClosure {
 private:
   SATBMarkQueueSet& _satb_qset;
@@ -119,7 +143,7 @@ public:
       ShenandoahObjToScanQueue* old_q = _cm->get_old_queue(worker_id);
 
       ShenandoahSATBBufferClosure<GENERATION> cl(q, old_q);
-      SATBMarkQueueSet& satb_mq_set = ShenandoahBarrierSet::satb_mark_queue_set();
+      ShenandoahSATBMarkQueueSet& satb_mq_set = ShenandoahBarrierSet::satb_mark_queue_set();
       while (satb_mq_set.apply_closure_to_completed_buffer(&cl)) {}
       assert(!heap->has_forwarded_objects(), "Not expected");
 
@@ -219,6 +243,33 @@ void ShenandoahConcurrentMark::mark_concurrent_roots() {
   }
 }
 
+// Queues the unmarked stack roots of a thread, so that the next round of concurrent
+// marking traces them instead of the final mark pause.
+class ShenandoahEnqueueUnmarkedRootsClosure : public OopClosure {
+private:
+  SATBMarkQueueSet& _qset;
+  SATBMarkQueue& _queue;
+  ShenandoahMarkingContext* const _ctx;
+
+  template <class T>
+  inline void do_oop_work(T* p) {
+    T o = RawAccess<>::oop_load(p);
+    if (!CompressedOops::is_null(o)) {
+      oop obj = CompressedOops::decode_not_null(o);
+      if (!_ctx->is_marked_strong(obj)) {
+        _qset.enqueue_known_active(_queue, obj);
+      }
+    }
+  }
+
+public:
+  ShenandoahEnqueueUnmarkedRootsClosure(SATBMarkQueueSet& qset, SATBMarkQueue& queue) :
+    _qset(qset), _queue(queue), _ctx(ShenandoahHeap::heap()->marking_context()) {}
+
+  void do_oop(narrowOop* p) { do_oop_work(p); }
+  void do_oop(oop* p)       { do_oop_work(p); }
+};
+
 class ShenandoahFlushSATBHandshakeClosure : public HandshakeClosure {
 private:
   SATBMarkQueueSet& _qset;
@@ -228,7 +279,15 @@ public:
     _qset(qset) {}
 
   void do_thread(Thread* thread) {
-    _qset.flush_queue(ShenandoahThreadLocalData::satb_mark_queue(thread));
+    SATBMarkQueue& queue = ShenandoahThreadLocalData::satb_mark_queue(thread);
+    if (ShenandoahIUBarrier) {
+      // Incremental update does not trace the values mutators leave in their frames, final
+      // mark rescans every stack for them. Tracing them now leaves that rescan mostly marked.
+      ResourceMark rm;
+      ShenandoahEnqueueUnmarkedRootsClosure cl(_qset, queue);
+      thread->oops_do(&cl, nullptr);
+    }
+    _qset.flush_queue(queue);
   }
 };
 
@@ -276,16 +335,33 @@ void ShenandoahConcurrentMark::concurrent_mark() {
       break;
     }
 
+    if (flushes + 1 == ShenandoahMaxSATBBufferFlushes) {
+      // No concurrent marking would follow this flush. Final mark flushes every thread's
+      // buffer anyway, in the same visit that remarks the thread, so skip the handshake.
+      break;
+    }
+
     size_t before = qset.completed_buffers_num();
-    Handshake::execute(&flush_satb);
+    ShenandoahHandshake::execute(&flush_satb);
     size_t after = qset.completed_buffers_num();
 
-    if (before == after) {
-      // No more retries needed, break out.
+    if (after - before <= ShenandoahSATBQuiescentBuffers) {
+      // Mutators are quiescent enough: the few buffers left over are cheaper to drain at
+      // final mark than with another round of concurrent marking and handshakes.
       break;
     }
   }
-  assert(task_queues()->is_empty() || heap->cancelled_gc(), "Should be empty when not cancelled");
+  if (gen_type == YOUNG && ShenandoahOldMarkTasksPerYoungCycle > 0 && old_task_queues() != nullptr &&
+      heap->is_concurrent_old_mark_in_progress() && !heap->cancelled_gc()) {
+    ShenandoahMarkOldIncrementTask task(this, MAX2<size_t>(1, ShenandoahOldMarkTasksPerYoungCycle / nworkers));
+    workers->run_task(&task);
+    log_debug(gc)("Young cycle traced " SIZE_FORMAT " old marking tasks, " UINT32_FORMAT " left queued",
+                  task.done(), old_task_queues()->tasks());
+  }
+
+  // Threads that assist marking can leave tasks behind, final mark finishes them.
+  assert(task_queues()->is_empty() || heap->cancelled_gc() || heap->mark_assist_queues() > 0,
+         "Should be empty when not cancelled");
 }
 
 void ShenandoahConcurrentMark::finish_mark() {
@@ -295,6 +371,7 @@ void ShenandoahConcurrentMark::finish_mark() {
   assert(task_queues()->is_empty(), "Should be empty");
   TASKQUEUE_STATS_ONLY(task_queues()->print_taskqueue_stats());
   TASKQUEUE_STATS_ONLY(task_queues()->reset_taskqueue_stats());
+  task_queues()->release_overflow_segments();
 
   _generation->set_concurrent_mark_in_progress(false);
   _generation->set_mark_complete();
@@ -27,6 +27,7 @@
 #include "gc/shenandoah/shenandoahCollectorPolicy.hpp"
 #include "gc/shenandoah/shenandoahConcurrentGC.hpp"
 #include "gc/shenandoah/shenandoahControlThread.hpp"
+#include "gc/shenandoah/shenandoahCycleHistory.hpp"
 #include "gc/shenandoah/shenandoahDegeneratedGC.hpp"
 #include "gc/shenandoah/shenandoahFreeSet.hpp"
 #include "gc/shenandoah/shenandoahFullGC.hpp"
@@ -35,6 +36,7 @@
 #include "gc/shenandoah/shenandoahMonitoringSupport.hpp"
 #include "gc/shenandoah/shenandoahPacer.inline.hpp"
 #include "gc/shenandoah/shenandoahUtils.hpp"
+#include "gc/shenandoah/shenandoahWorkerPolicy.hpp"
 #include "gc/shenandoah/heuristics/shenandoahHeuristics.hpp"
 #include "gc/shenandoah/mode/shenandoahMode.hpp"
 #include "logging/log.hpp"
@@ -117,7 +119,7 @@ void ShenandoahControlThread::run_service() {
       }
     } else {
       // Potential normal cycle: ask heuristics if it wants to act
-      if (heuristics->should_start_gc()) {
+      if (heuristics->evaluate_trigger()) {
         mode = default_mode;
         cause = default_cause;
       }
@@ -224,12 +226,19 @@ void ShenandoahControlThread::run_service() {
         }
       }
 
+      // Learn per-worker throughput from the phases of this cycle
+      ShenandoahWorkerPolicy::record_cycle(heap->phase_timings());
+      heap->cycle_history()->record_cycle(heap->phase_timings());
+
       // Commit statistics to globals
       heap->phase_timings()->flush_cycle_to_global();
 
       // Print Metaspace change following GC (if logging is enabled).
       MetaspaceUtils::print_metaspace_change(meta_sizes);
 
+      // Pick the soft max heap size for the next cycles, to be applied on the next iteration
+      heap->soft_max_controller()->adjust(heap);
+
       // GC is over, we are at idle now
       if (ShenandoahPacing) {
         heap->pacer()->setup_for_idle();
@@ -261,6 +270,16 @@ void ShenandoahControlThread::run_service() {
       last_shrink_time = current;
     }
 
+    // Commit regions ahead of the allocators, so that they do not take the page faults after an uncommit.
+    if (ShenandoahPrecommitRegions > 0 && !is_alloc_failure_gc()) {
+      heap->free_set()->maintain_committed_regions(ShenandoahPrecommitRegions);
+    }
+
+    // Replenish the pool of zeroed regions while there is no allocation failure to handle.
+    if (ShenandoahZeroedRegionPool > 0 && !is_alloc_failure_gc()) {
+      heap->free_set()->maintain_zeroed_regions(ShenandoahZeroedRegionPool);
+    }
+
     // Wait before performing the next action. If allocation happened during this wait,
     // we exit sooner, to let heuristics re-evaluate new conditions. If we are at idle,
     // back off exponentially.
@@ -270,7 +289,10 @@ void ShenandoahControlThread::run_service() {
       sleep = MIN2<int>(ShenandoahControlIntervalMax, MAX2(1, sleep * 2));
       last_sleep_adjust_time = current;
     }
-    os::naked_short_sleep(sleep);
+    if (heap->alloc_spike_detector()->sleep(sleep)) {
+      heuristics->record_allocation_spike();
+      sleep = ShenandoahControlIntervalMin;
+    }
   }
 
   // Wait for the actual stop(), can't leave run_service() earlier.
@@ -25,8 +25,9 @@
 
 #include "gc/shared/gc_globals.hpp"
 #include "gc/shenandoah/shenandoahController.hpp"
-#include "gc/shenandoah/shenandoahHeap.hpp"
+#include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahHeapRegion.inline.hpp"
+#include "jfr/jfrEvents.hpp"
 
 void ShenandoahController::pacing_notify_alloc(size_t words) {
   assert(ShenandoahPacing, "should only call when pacing is enabled");
@@ -59,6 +60,11 @@ void ShenandoahController::handle_alloc_failure(ShenandoahAllocRequest& req, boo
   assert(current()->is_Java_thread(), "expect Java thread here");
   bool is_humongous = req.size() > ShenandoahHeapRegion::humongous_threshold_words();
 
+  if (block && stall_for_concurrent_cycle(req)) {
+    // The concurrent cycle reclaimed its collection set in time, let the allocation retry.
+    return;
+  }
+
   if (try_set_alloc_failure_gc(is_humongous)) {
     // Only report the first allocation failure
     log_info(gc)("Failed to allocate %s, " SIZE_FORMAT "%s",
@@ -71,13 +77,59 @@ void ShenandoahController::handle_alloc_failure(ShenandoahAllocRequest& req, boo
 
 
   if (block) {
-    MonitorLocker ml(&_alloc_failure_waiters_lock);
-    while (is_alloc_failure_gc()) {
-      ml.wait();
+    EventShenandoahAllocationFailureStall event;
+    {
+      MonitorLocker ml(&_alloc_failure_waiters_lock);
+      while (is_alloc_failure_gc()) {
+        ml.wait();
+      }
+    }
+    if (event.should_commit()) {
+      event.set_size(req.size() * HeapWordSize);
+      event.set_allocationType(req.type_string());
+      event.commit();
     }
   }
 }
 
+// Once evacuation has started, the cycle reclaims the collection set as soon as it completes
+// update refs, and GC workers evacuate from their own reserve. Stopping the allocating thread
+// for a short while can then avoid the degenerated cycle the allocation failure would cause.
+bool ShenandoahController::stall_for_concurrent_cycle(ShenandoahAllocRequest& req) {
+  ShenandoahHeap* heap = ShenandoahHeap::heap();
+  if (ShenandoahAllocStallDuringEvacMs == 0 || is_alloc_failure_gc() || heap->cancelled_gc() ||
+      !(heap->is_evacuation_in_progress() || heap->is_update_refs_in_progress())) {
+    return false;
+  }
+
+  EventShenandoahAllocationStall event;
+  const jlong start = os::javaTimeNanos();
+  const jlong deadline = start + (jlong) ShenandoahAllocStallDuringEvacMs * NANOSECS_PER_MILLISEC;
+  {
+    MonitorLocker ml(&_alloc_stall_waiters_lock);
+    jlong now = start;
+    while ((heap->is_evacuation_in_progress() || heap->is_update_refs_in_progress()) &&
+           !heap->cancelled_gc() && now < deadline) {
+      ml.wait(MAX2<jlong>(1, (deadline - now) / NANOSECS_PER_MILLISEC));
+      now = os::javaTimeNanos();
+    }
+  }
+
+  bool reclaimed = !heap->is_evacuation_in_progress() && !heap->is_update_refs_in_progress() &&
+                   !heap->cancelled_gc();
+  log_debug(gc, alloc)("Stalled allocation of " PROPERFMT " for %.3fms, collection set %s",
+                       PROPERFMTARGS(req.size() * HeapWordSize),
+                       (double) (os::javaTimeNanos() - start) / NANOSECS_PER_MILLISEC,
+                       reclaimed ? "reclaimed" : "not reclaimed in time");
+  if (event.should_commit()) {
+    event.set_size(req.size() * HeapWordSize);
+    event.set_allocationType(req.type_string());
+    event.set_reclaimed(reclaimed);
+    event.commit();
+  }
+  return reclaimed;
+}
+
 void ShenandoahController::handle_alloc_failure_evac(size_t words) {
   ShenandoahHeap* heap = ShenandoahHeap::heap();
   bool is_humongous = (words > ShenandoahHeapRegion::region_size_words());
@@ -99,6 +151,11 @@ void ShenandoahController::notify_alloc_failure_waiters() {
   ml.notify_all();
 }
 
+void ShenandoahController::notify_alloc_stall_waiters() {
+  MonitorLocker ml(&_alloc_stall_waiters_lock);
+  ml.notify_all();
+}
+
 bool ShenandoahController::try_set_alloc_failure_gc(bool is_humongous) {
   if (is_humongous) {
     _humongous_alloc_failure_gc.try_set();
@@ -54,13 +54,21 @@ protected:
   Monitor _alloc_failure_waiters_lock;
   Monitor _gc_waiters_lock;
 
+  // Mutators whose allocations failed during evacuation or update refs wait here for the
+  // concurrent cycle to reclaim the collection set, see ShenandoahAllocStallDuringEvacMs.
+  Monitor _alloc_stall_waiters_lock;
+
+private:
+  bool stall_for_concurrent_cycle(ShenandoahAllocRequest& req);
+
 public:
   ShenandoahController():
     ConcurrentGCThread(),
     _allocs_seen(0),
     _gc_id(0),
     _alloc_failure_waiters_lock(Mutex::safepoint-2, "ShenandoahAllocFailureGC_lock", true),
-    _gc_waiters_lock(Mutex::safepoint-2, "ShenandoahRequestedGC_lock", true)
+    _gc_waiters_lock(Mutex::safepoint-2, "ShenandoahRequestedGC_lock", true),
+    _alloc_stall_waiters_lock(Mutex::safepoint-2, "ShenandoahAllocStall_lock", true)
   { }
 
   // Request a collection cycle. This handles "explicit" gc requests
@@ -81,6 +89,9 @@ public:
   // Notify threads waiting for GC to complete.
   void notify_alloc_failure_waiters();
 
+  // Notify mutators stalled for the concurrent cycle that the collection set is reclaimed.
+  void notify_alloc_stall_waiters();
+
   // True if allocation failure flag has been set.
   bool is_alloc_failure_gc();
 
@@ -0,0 +1,189 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#include "precompiled.hpp"
+
+#include "gc/shenandoah/shenandoahCollectionSet.hpp"
+#include "gc/shenandoah/shenandoahCycleHistory.hpp"
+#include "gc/shenandoah/shenandoahFreeSet.hpp"
+#include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "memory/resourceArea.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/os.hpp"
+#include "utilities/ostream.hpp"
+
+// Pauses as the application sees them, including the safepoint overhead
+static const ShenandoahPhaseTimings::Phase pause_phases[] = {
+  ShenandoahPhaseTimings::init_mark_gross,
+  ShenandoahPhaseTimings::final_mark_gross,
+  ShenandoahPhaseTimings::final_roots_gross,
+  ShenandoahPhaseTimings::init_update_refs_gross,
+  ShenandoahPhaseTimings::final_update_refs_gross,
+  ShenandoahPhaseTimings::degen_gc_gross,
+  ShenandoahPhaseTimings::full_gc_gross
+};
+
+const char* ShenandoahCycleHistory::Record::kind() const {
+  if (_phase_times[ShenandoahPhaseTimings::full_gc_gross] > 0) {
+    return "Full";
+  }
+  if (_phase_times[ShenandoahPhaseTimings::degen_gc_gross] > 0) {
+    return "Degenerated";
+  }
+  return "Concurrent";
+}
+
+ShenandoahCycleHistory::ShenandoahCycleHistory() :
+  _lock(Mutex::nosafepoint - 2, "ShenandoahCycleHistory_lock", true),
+  _capacity(ShenandoahCycleHistorySize),
+  _records(NEW_C_HEAP_ARRAY(Record, ShenandoahCycleHistorySize, mtGC)),
+  _recorded(0),
+  _last_end_time(os::elapsedTime()),
+  _cset_regions(0),
+  _cset_used(0),
+  _cset_live(0),
+  _cset_garbage(0) {
+}
+
+ShenandoahCycleHistory::~ShenandoahCycleHistory() {
+  FREE_C_HEAP_ARRAY(Record, _records);
+}
+
+void ShenandoahCycleHistory::record_collection_set(const ShenandoahCollectionSet* cset) {
+  _cset_regions = cset->count();
+  _cset_used = cset->used();
+  _cset_live = cset->live();
+  _cset_garbage = cset->garbage();
+}
+
+void ShenandoahCycleHistory::record_cycle(const ShenandoahPhaseTimings* timings) {
+  Record r;
+  r._end_time = os::elapsedTime();
+  r._interval = r._end_time - _last_end_time;
+  _last_end_time = r._end_time;
+
+  r._pause_time = 0;
+  for (uint i = 0; i < sizeof(pause_phases) / sizeof(pause_phases[0]); i++) {
+    r._pause_time += timings->cycle_time(pause_phases[i]);
+  }
+  for (uint i = 0; i < ShenandoahPhaseTimings::_num_phases; i++) {
+    r._phase_times[i] = timings->cycle_time(ShenandoahPhaseTimings::Phase(i));
+  }
+
+  r._cset_regions = _cset_regions;
+  r._cset_used = _cset_used;
+  r._cset_live = _cset_live;
+  r._cset_garbage = _cset_garbage;
+  _cset_regions = _cset_used = _cset_live = _cset_garbage = 0;
+
+  {
+    ShenandoahHeap* heap = ShenandoahHeap::heap();
+    ShenandoahHeapLocker locker(heap->lock());
+    ShenandoahFreeSet* free_set = heap->free_set();
+    r._mutator_capacity = free_set->capacity();
+    r._mutator_available = free_set->available();
+    r._collector_available = free_set->collector_available();
+    r._old_collector_available = free_set->old_collector_available();
+  }
+
+  MutexLocker ml(&_lock, Mutex::_no_safepoint_check_flag);
+  r._cycle = ++_recorded;
+  _records[(r._cycle - 1) % _capacity] = r;
+}
+
+void ShenandoahCycleHistory::print_on(outputStream* out, size_t cycles, bool json) {
+  ResourceMark rm;
+  Record* records = NEW_RESOURCE_ARRAY(Record, _capacity);
+  size_t count;
+  size_t recorded;
+  {
+    // Copy out, so that the control thread does not wait for the output.
+    MutexLocker ml(&_lock, Mutex::_no_safepoint_check_flag);
+    recorded = _recorded;
+    count = MIN3(cycles, _capacity, recorded);
+    for (size_t i = 0; i < count; i++) {
+      records[i] = _records[(recorded - count + i) % _capacity];
+    }
+  }
+
+  if (json) {
+    out->print("{\"recorded\": " SIZE_FORMAT ", \"cycles\": [", recorded);
+    for (size_t i = 0; i < count; i++) {
+      if (i > 0) {
+        out->print(", ");
+      }
+      print_record_json_on(out, &records[i]);
+    }
+    out->print_cr("]}");
+  } else {
+    out->print_cr("Shenandoah cycles, last " SIZE_FORMAT " of " SIZE_FORMAT ":", count, recorded);
+    for (size_t i = 0; i < count; i++) {
+      print_record_on(out, &records[i]);
+    }
+  }
+}
+
+void ShenandoahCycleHistory::print_record_on(outputStream* out, const Record* r) {
+  double utilization = (r->_interval > 0) ? 100.0 * (1.0 - r->_pause_time / r->_interval) : 100.0;
+  out->cr();
+  out->print_cr("Cycle " SIZE_FORMAT ": %s, ended at %.3fs", r->_cycle, r->kind(), r->_end_time);
+  out->print_cr("  Pauses: %.3f ms, mutator utilization since previous cycle: %.2f%%",
+                r->_pause_time * 1000.0, utilization);
+  out->print_cr("  Collection set: " SIZE_FORMAT " regions, used " PROPERFMT ", live " PROPERFMT ", garbage " PROPERFMT,
+                r->_cset_regions, PROPERFMTARGS(r->_cset_used), PROPERFMTARGS(r->_cset_live),
+                PROPERFMTARGS(r->_cset_garbage));
+  out->print_cr("  Free set: mutator " PROPERFMT " of " PROPERFMT ", collector " PROPERFMT ", old collector " PROPERFMT,
+                PROPERFMTARGS(r->_mutator_available), PROPERFMTARGS(r->_mutator_capacity),
+                PROPERFMTARGS(r->_collector_available), PROPERFMTARGS(r->_old_collector_available));
+  for (uint i = 0; i < ShenandoahPhaseTimings::_num_phases; i++) {
+    const char* name = ShenandoahPhaseTimings::phase_name(ShenandoahPhaseTimings::Phase(i));
+    // Only top-level phases, sub-phase names are indented
+    if (r->_phase_times[i] > 0 && name[0] != ' ') {
+      out->print_cr("  %-30s %10.0f us", name, r->_phase_times[i] * 1000000.0);
+    }
+  }
+}
+
+void ShenandoahCycleHistory::print_record_json_on(outputStream* out, const Record* r) {
+  out->print("{\"cycle\": " SIZE_FORMAT ", \"kind\": \"%s\", \"end_time_s\": %.3f, "
+             "\"pause_ms\": %.3f, \"interval_ms\": %.3f, ",
+             r->_cycle, r->kind(), r->_end_time, r->_pause_time * 1000.0, r->_interval * 1000.0);
+  out->print("\"collection_set\": {\"regions\": " SIZE_FORMAT ", \"used\": " SIZE_FORMAT
+             ", \"live\": " SIZE_FORMAT ", \"garbage\": " SIZE_FORMAT "}, ",
+             r->_cset_regions, r->_cset_used, r->_cset_live, r->_cset_garbage);
+  out->print("\"free_set\": {\"mutator_capacity\": " SIZE_FORMAT ", \"mutator_available\": " SIZE_FORMAT
+             ", \"collector_available\": " SIZE_FORMAT ", \"old_collector_available\": " SIZE_FORMAT "}, ",
+             r->_mutator_capacity, r->_mutator_available, r->_collector_available, r->_old_collector_available);
+  out->print("\"phases_us\": {");
+  bool first = true;
+  for (uint i = 0; i < ShenandoahPhaseTimings::_num_phases; i++) {
+    const char* name = ShenandoahPhaseTimings::phase_name(ShenandoahPhaseTimings::Phase(i));
+    if (r->_phase_times[i] > 0 && name[0] != ' ') {
+      out->print("%s\"%s\": %.0f", first ? "" : ", ", name, r->_phase_times[i] * 1000000.0);
+      first = false;
+    }
+  }
+  out->print("}}");
+}
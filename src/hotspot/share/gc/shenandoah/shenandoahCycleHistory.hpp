@@ -0,0 +1,89 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#ifndef SHARE_GC_SHENANDOAH_SHENANDOAHCYCLEHISTORY_HPP
+#define SHARE_GC_SHENANDOAH_SHENANDOAHCYCLEHISTORY_HPP
+
+#include "gc/shenandoah/shenandoahPhaseTimings.hpp"
+#include "memory/allocation.hpp"
+#include "runtime/mutex.hpp"
+
+class ShenandoahCollectionSet;
+class outputStream;
+
+// Summaries of the last ShenandoahCycleHistorySize cycles, for the GC.shenandoah_stats
+// diagnostic command. The control thread records a cycle when it flushes the cycle's phase
+// timings. The collection set of the cycle is recorded when it is reclaimed, because it is
+// cleared before the cycle ends.
+class ShenandoahCycleHistory : public CHeapObj<mtGC> {
+private:
+  struct Record {
+    size_t _cycle;
+    double _end_time;
+    double _pause_time;
+    double _interval;
+
+    size_t _cset_regions;
+    size_t _cset_used;
+    size_t _cset_live;
+    size_t _cset_garbage;
+
+    size_t _mutator_capacity;
+    size_t _mutator_available;
+    size_t _collector_available;
+    size_t _old_collector_available;
+
+    double _phase_times[ShenandoahPhaseTimings::_num_phases];
+
+    const char* kind() const;
+  };
+
+  Mutex _lock;
+  const size_t _capacity;
+  Record* const _records;
+  size_t _recorded;
+  double _last_end_time;
+
+  // Collection set of the cycle in progress
+  size_t _cset_regions;
+  size_t _cset_used;
+  size_t _cset_live;
+  size_t _cset_garbage;
+
+  static void print_record_on(outputStream* out, const Record* r);
+  static void print_record_json_on(outputStream* out, const Record* r);
+
+public:
+  ShenandoahCycleHistory();
+  ~ShenandoahCycleHistory();
+
+  void record_collection_set(const ShenandoahCollectionSet* cset);
+  void record_cycle(const ShenandoahPhaseTimings* timings);
+
+  // Print at most the given number of the most recent cycles, oldest first.
+  void print_on(outputStream* out, size_t cycles, bool json);
+};
+
+#endif // SHARE_GC_SHENANDOAH_SHENANDOAHCYCLEHISTORY_HPP
@@ -0,0 +1,55 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#include "precompiled.hpp"
+
+#include "gc/shared/gc_globals.hpp"
+#include "gc/shenandoah/shenandoahCycleHistory.hpp"
+#include "gc/shenandoah/shenandoahDCmd.hpp"
+#include "gc/shenandoah/shenandoahHeap.hpp"
+#include "utilities/ostream.hpp"
+
+ShenandoahStatsDCmd::ShenandoahStatsDCmd(outputStream* output, bool heap) :
+  DCmdWithParser(output, heap),
+  _json("-json", "Print the statistics as a JSON object.", "BOOLEAN", false, "false"),
+  _cycles("-cycles", "Number of most recent cycles to print. 0 prints all the kept cycles.",
+          "INT", false, "0") {
+  _dcmdparser.add_dcmd_option(&_json);
+  _dcmdparser.add_dcmd_option(&_cycles);
+}
+
+void ShenandoahStatsDCmd::execute(DCmdSource source, TRAPS) {
+  if (!UseShenandoahGC) {
+    output()->print_cr("Shenandoah GC is not in use.");
+    return;
+  }
+  jlong cycles = _cycles.value();
+  if (cycles < 0) {
+    output()->print_cr("Number of cycles out of range (>=0): " JLONG_FORMAT, cycles);
+    return;
+  }
+  ShenandoahHeap::heap()->cycle_history()->print_on(output(), (cycles == 0) ? SIZE_MAX : (size_t)cycles,
+                                                    _json.value());
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#ifndef SHARE_GC_SHENANDOAH_SHENANDOAHDCMD_HPP
+#define SHARE_GC_SHENANDOAH_SHENANDOAHDCMD_HPP
+
+#include "services/diagnosticCommand.hpp"
+
+class outputStream;
+
+// Prints the summaries kept by ShenandoahCycleHistory, for tools that poll the collector
+// instead of parsing its logs.
+class ShenandoahStatsDCmd : public DCmdWithParser {
+  DCmdArgument<bool> _json;
+  DCmdArgument<jlong> _cycles;
+public:
+  ShenandoahStatsDCmd(outputStream* output, bool heap);
+  static const char* name() {
+    return "GC.shenandoah_stats";
+  }
+  static const char* description() {
+    return "Print phase timings, collection set, free set and pause statistics "
+           "of the recent Shenandoah GC cycles.";
+  }
+  static const char* impact() {
+    return "Low";
+  }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", nullptr};
+    return p;
+  }
+  static int num_arguments() { return 2; }
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
+#endif // SHARE_GC_SHENANDOAH_SHENANDOAHDCMD_HPP
@@ -94,6 +94,9 @@ void ShenandoahDegenGC::op_degenerated() {
   // some phase, we have to upgrade the Degenerate GC to Full GC.
   heap->clear_cancelled_gc(true /* clear oom handler */);
 
+  // Weak roots are processed in the pause, without the settled block summaries.
+  heap->invalidate_settled_weak_roots();
+
 #ifdef ASSERT
   if (heap->mode()->is_generational()) {
     ShenandoahOldGeneration* old_generation = heap->old_generation();
@@ -233,13 +236,15 @@ void ShenandoahDegenGC::op_degenerated() {
         // the collection set, and then the pin reached the cset region. If we continue
         // the cycle here, we would trash the cset and alive objects in it. To avoid
         // it, we fail degeneration right away and slide into Full GC to recover.
+        // With ShenandoahEvacuatePinnedRegions, the pins are covered by pinned ranges,
+        // and the objects in them are left in place instead.
 
         {
           heap->sync_pinned_region_status();
           heap->collection_set()->clear_current_index();
           ShenandoahHeapRegion* r;
           while ((r = heap->collection_set()->next()) != nullptr) {
-            if (r->is_pinned()) {
+            if (r->is_pinned() && !ShenandoahEvacuatePinnedRegions) {
               heap->cancel_gc(GCCause::_shenandoah_upgrade_to_full_gc);
               op_degenerated_fail();
               return;
@@ -323,6 +328,7 @@ void ShenandoahDegenGC::op_mark() {
   ShenandoahGCPhase phase(ShenandoahPhaseTimings::degen_gc_stw_mark);
   ShenandoahSTWMark mark(_generation, false /*full gc*/);
   mark.mark();
+  ShenandoahHeap::heap()->set_ref_summary_exact(true);
 }
 
 void ShenandoahDegenGC::op_finish_mark() {
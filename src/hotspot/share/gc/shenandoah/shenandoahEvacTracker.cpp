@@ -28,12 +28,17 @@
 #include "gc/shenandoah/shenandoahEvacTracker.hpp"
 #include "gc/shenandoah/shenandoahThreadLocalData.hpp"
 #include "gc/shenandoah/shenandoahRootProcessor.hpp"
+#include "jfr/jfrEvents.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/klass.hpp"
 #include "runtime/threadSMR.inline.hpp"
 #include "runtime/thread.hpp"
+#include "utilities/quickSort.hpp"
 
 ShenandoahEvacuationStats::ShenandoahEvacuationStats(bool generational)
   : _evacuations_completed(0), _bytes_completed(0),
     _evacuations_attempted(0), _bytes_attempted(0),
+    _plab_refills(0), _plab_waste_bytes(0),
     _use_age_table(generational && (ShenandoahGenerationalCensusAtEvac || !ShenandoahGenerationalAdaptiveTenuring)) {
   if (_use_age_table) {
     _age_table = new AgeTable(false);
@@ -62,11 +67,21 @@ void ShenandoahEvacuationStats::record_age(size_t bytes, uint age) {
   }
 }
 
+void ShenandoahEvacuationStats::record_plab_refill() {
+  ++_plab_refills;
+}
+
+void ShenandoahEvacuationStats::record_plab_waste(size_t bytes) {
+  _plab_waste_bytes += bytes;
+}
+
 void ShenandoahEvacuationStats::accumulate(const ShenandoahEvacuationStats* other) {
   _evacuations_completed += other->_evacuations_completed;
   _bytes_completed += other->_bytes_completed;
   _evacuations_attempted += other->_evacuations_attempted;
   _bytes_attempted += other->_bytes_attempted;
+  _plab_refills += other->_plab_refills;
+  _plab_waste_bytes += other->_plab_waste_bytes;
   if (_use_age_table) {
     _age_table->merge(other->age_table());
   }
@@ -75,6 +90,7 @@ void ShenandoahEvacuationStats::accumulate(const ShenandoahEvacuationStats* othe
 void ShenandoahEvacuationStats::reset() {
   _evacuations_completed = _evacuations_attempted = 0;
   _bytes_completed = _bytes_attempted = 0;
+  _plab_refills = _plab_waste_bytes = 0;
   if (_use_age_table) {
     _age_table->clear();
   }
@@ -89,12 +105,141 @@ void ShenandoahEvacuationStats::print_on(outputStream* st) {
             _evacuations_completed,
             byte_size_in_proper_unit(abandoned_size),   proper_unit_for_byte_size(abandoned_size),
             abandoned_count);
+  if (_plab_refills > 0) {
+    st->print_cr("Refilled " SIZE_FORMAT " PLABs, wasted " SIZE_FORMAT "%s in retired PLABs.",
+                 _plab_refills,
+                 byte_size_in_proper_unit(_plab_waste_bytes), proper_unit_for_byte_size(_plab_waste_bytes));
+  }
   if (_use_age_table) {
     shenandoah_assert_generational();
     _age_table->print_on(st, ShenandoahGenerationalHeap::heap()->age_census()->tenuring_threshold());
   }
 }
 
+ShenandoahEvacuationKlassTable::ShenandoahEvacuationKlassTable() :
+  _countdown(ShenandoahEvacuationKlassSampleRate) {
+  reset();
+}
+
+ShenandoahEvacuationKlassTable::Entry* ShenandoahEvacuationKlassTable::find_or_insert(Klass* klass) {
+  size_t h = ((uintptr_t)klass >> LogHeapWordSize) * 0x9E3779B97F4A7C15ULL;
+  for (size_t probe = 0; probe < MaxProbes; probe++) {
+    Entry* e = &_entries[(h + probe) & (Capacity - 1)];
+    if (e->_klass == klass) {
+      return e;
+    }
+    if (e->_klass == nullptr) {
+      e->_klass = klass;
+      return e;
+    }
+  }
+  return &_other;
+}
+
+void ShenandoahEvacuationKlassTable::add(Entry* e, size_t evacuations, size_t bytes, size_t promoted_bytes) {
+  e->_evacuations += evacuations;
+  e->_bytes += bytes;
+  e->_promoted_bytes += promoted_bytes;
+}
+
+void ShenandoahEvacuationKlassTable::record(Klass* klass, size_t bytes, bool promoted) {
+  if (--_countdown > 0) {
+    return;
+  }
+  size_t weight = ShenandoahEvacuationKlassSampleRate;
+  _countdown = weight;
+  add(find_or_insert(klass), weight, weight * bytes, promoted ? weight * bytes : 0);
+}
+
+void ShenandoahEvacuationKlassTable::accumulate(const ShenandoahEvacuationKlassTable* other) {
+  for (size_t i = 0; i < Capacity; i++) {
+    const Entry* o = &other->_entries[i];
+    if (o->_klass != nullptr) {
+      add(find_or_insert(o->_klass), o->_evacuations, o->_bytes, o->_promoted_bytes);
+    }
+  }
+  add(&_other, other->_other._evacuations, other->_other._bytes, other->_other._promoted_bytes);
+}
+
+void ShenandoahEvacuationKlassTable::reset() {
+  for (size_t i = 0; i < Capacity; i++) {
+    _entries[i] = {nullptr, 0, 0, 0};
+  }
+  _other = {nullptr, 0, 0, 0};
+}
+
+size_t ShenandoahEvacuationKlassTable::sort_by_bytes(Entry** sorted) {
+  size_t count = 0;
+  for (size_t i = 0; i < Capacity; i++) {
+    if (_entries[i]._klass != nullptr) {
+      sorted[count++] = &_entries[i];
+    }
+  }
+  QuickSort::sort(sorted, count, [](Entry* a, Entry* b) {
+    return (a->_bytes > b->_bytes) ? -1 : ((a->_bytes < b->_bytes) ? 1 : 0);
+  }, false);
+  return count;
+}
+
+void ShenandoahEvacuationKlassTable::print_top_on(outputStream* st, size_t limit) {
+  ResourceMark rm;
+  Entry** sorted = NEW_RESOURCE_ARRAY(Entry*, Capacity);
+  size_t count = sort_by_bytes(sorted);
+  if (count == 0) {
+    return;
+  }
+
+  st->print_cr("Evacuated classes (sampled 1 in " UINTX_FORMAT "):", ShenandoahEvacuationKlassSampleRate);
+  for (size_t i = 0; i < MIN2(count, limit); i++) {
+    Entry* e = sorted[i];
+    st->print_cr("  " SIZE_FORMAT_W(8) "%s in " SIZE_FORMAT_W(9) " objects, promoted " SIZE_FORMAT_W(8) "%s: %s",
+                 byte_size_in_proper_unit(e->_bytes), proper_unit_for_byte_size(e->_bytes),
+                 e->_evacuations,
+                 byte_size_in_proper_unit(e->_promoted_bytes), proper_unit_for_byte_size(e->_promoted_bytes),
+                 e->_klass->external_name());
+  }
+  if (_other._evacuations > 0) {
+    st->print_cr("  " SIZE_FORMAT_W(8) "%s in " SIZE_FORMAT_W(9) " objects of classes not tracked",
+                 byte_size_in_proper_unit(_other._bytes), proper_unit_for_byte_size(_other._bytes),
+                 _other._evacuations);
+  }
+}
+
+void ShenandoahEvacuationKlassTable::send_top_events(size_t limit) {
+  if (!EventShenandoahEvacuatedClass::is_enabled()) {
+    return;
+  }
+  ResourceMark rm;
+  Entry** sorted = NEW_RESOURCE_ARRAY(Entry*, Capacity);
+  size_t count = sort_by_bytes(sorted);
+  for (size_t i = 0; i < MIN2(count, limit); i++) {
+    Entry* e = sorted[i];
+    EventShenandoahEvacuatedClass evt;
+    evt.set_objectClass(e->_klass);
+    evt.set_evacuations(e->_evacuations);
+    evt.set_evacuatedBytes(e->_bytes);
+    evt.set_promotedBytes(e->_promoted_bytes);
+    evt.commit();
+  }
+}
+
+void ShenandoahEvacuationTracker::print_cycle_klasses_on(outputStream* st) {
+  if (_cycle_klasses != nullptr) {
+    _cycle_klasses->print_top_on(st, KlassReportSize);
+    st->cr();
+  }
+}
+
+ShenandoahEvacuationTracker::ShenandoahEvacuationTracker(bool generational) :
+  _generational(generational),
+  _workers_global(generational),
+  _mutators_global(generational),
+  _cycle_klasses(nullptr) {
+  if (generational && ShenandoahEvacuationKlassSampleRate > 0) {
+    _cycle_klasses = new ShenandoahEvacuationKlassTable();
+  }
+}
+
 void ShenandoahEvacuationTracker::print_global_on(outputStream* st) {
   print_evacuations_on(st, &_workers_global, &_mutators_global);
 }
@@ -136,6 +281,19 @@ public:
   }
 };
 
+class ShenandoahKlassAggregator : public ThreadClosure {
+public:
+  ShenandoahEvacuationKlassTable* _target;
+  explicit ShenandoahKlassAggregator(ShenandoahEvacuationKlassTable* target) : _target(target) {}
+  virtual void do_thread(Thread* thread) override {
+    ShenandoahEvacuationKlassTable* local = ShenandoahThreadLocalData::evacuation_klasses(thread);
+    if (local != nullptr) {
+      _target->accumulate(local);
+      local->reset();
+    }
+  }
+};
+
 ShenandoahCycleStats ShenandoahEvacuationTracker::flush_cycle_to_global() {
   ShenandoahEvacuationStats mutators(_generational), workers(_generational);
 
@@ -149,6 +307,16 @@ ShenandoahCycleStats ShenandoahEvacuationTracker::flush_cycle_to_global() {
   _mutators_global.accumulate(&mutators);
   _workers_global.accumulate(&workers);
 
+  if (_cycle_klasses != nullptr) {
+    // Threads only record classes of objects they evacuated in this cycle, and classes are
+    // not unloaded before the next cycle marks, so the merged classes are all alive.
+    _cycle_klasses->reset();
+    ShenandoahKlassAggregator aggregate_klasses(_cycle_klasses);
+    java_threads_iterator.list()->threads_do(&aggregate_klasses);
+    ShenandoahHeap::heap()->gc_threads_do(&aggregate_klasses);
+    _cycle_klasses->send_top_events(KlassReportSize);
+  }
+
   if (_generational && (ShenandoahGenerationalCensusAtEvac || !ShenandoahGenerationalAdaptiveTenuring)) {
     // Ingest mutator & worker collected population vectors into the heap's
     // global census data, and use it to compute an appropriate tenuring threshold
@@ -172,3 +340,18 @@ void ShenandoahEvacuationTracker::end_evacuation(Thread* thread, size_t bytes) {
 void ShenandoahEvacuationTracker::record_age(Thread* thread, size_t bytes, uint age) {
   ShenandoahThreadLocalData::record_age(thread, bytes, age);
 }
+
+void ShenandoahEvacuationTracker::record_plab_refill(Thread* thread) {
+  ShenandoahThreadLocalData::record_plab_refill(thread);
+}
+
+void ShenandoahEvacuationTracker::record_plab_waste(Thread* thread, size_t bytes) {
+  ShenandoahThreadLocalData::record_plab_waste(thread, bytes);
+}
+
+void ShenandoahEvacuationTracker::record_klass(Thread* thread, Klass* klass, size_t bytes, bool promoted) {
+  ShenandoahEvacuationKlassTable* table = ShenandoahThreadLocalData::evacuation_klasses(thread);
+  if (table != nullptr) {
+    table->record(klass, bytes, promoted);
+  }
+}
@@ -28,6 +28,8 @@
 #include "gc/shared/ageTable.hpp"
 #include "utilities/ostream.hpp"
 
+class Klass;
+
 class ShenandoahEvacuationStats : public CHeapObj<mtGC> {
 private:
   size_t _evacuations_completed;
@@ -35,6 +37,9 @@ private:
   size_t _evacuations_attempted;
   size_t _bytes_attempted;
 
+  size_t _plab_refills;
+  size_t _plab_waste_bytes;
+
   bool      _use_age_table;
   AgeTable* _age_table;
 
@@ -46,12 +51,55 @@ private:
   void begin_evacuation(size_t bytes);
   void end_evacuation(size_t bytes);
   void record_age(size_t bytes, uint age);
+  void record_plab_refill();
+  void record_plab_waste(size_t bytes);
 
   void print_on(outputStream* st);
   void accumulate(const ShenandoahEvacuationStats* other);
   void reset();
 };
 
+// Sampled evacuation volume by the class of the evacuated objects. Every thread records into
+// its own table, and the tables are merged when the cycle is flushed, so recording takes no
+// locks and no atomics. The table has a fixed capacity. Classes that do not fit are counted
+// as "other", so that the totals stay exact with respect to the samples taken.
+class ShenandoahEvacuationKlassTable : public CHeapObj<mtGC> {
+private:
+  struct Entry {
+    Klass* _klass;
+    size_t _evacuations;
+    size_t _bytes;
+    size_t _promoted_bytes;
+  };
+
+  static const size_t Capacity = 1024;
+  static const size_t MaxProbes = 16;
+
+  Entry _entries[Capacity];
+  Entry _other;
+
+  // Evacuations left until the next sample
+  size_t _countdown;
+
+  Entry* find_or_insert(Klass* klass);
+  size_t sort_by_bytes(Entry** sorted);
+  void add(Entry* e, size_t evacuations, size_t bytes, size_t promoted_bytes);
+
+public:
+  ShenandoahEvacuationKlassTable();
+
+  // Sample one in ShenandoahEvacuationKlassSampleRate evacuations. A sample stands for all
+  // the evacuations skipped since the previous one.
+  void record(Klass* klass, size_t bytes, bool promoted);
+
+  void accumulate(const ShenandoahEvacuationKlassTable* other);
+  void reset();
+
+  // Report the classes with the most evacuated bytes to the stream and as JFR events.
+  void print_top_on(outputStream* st, size_t limit);
+  void send_top_events(size_t limit);
+};
+
 struct ShenandoahCycleStats {
   ShenandoahEvacuationStats workers;
   ShenandoahEvacuationStats mutators;
@@ -64,20 +112,27 @@ private:
   ShenandoahEvacuationStats _workers_global;
   ShenandoahEvacuationStats _mutators_global;
 
+  // Classes evacuated by workers and mutators in the last flushed cycle, if sampling
+  ShenandoahEvacuationKlassTable* _cycle_klasses;
+
+  static const size_t KlassReportSize = 20;
+
 public:
-  ShenandoahEvacuationTracker(bool generational) :
-   _generational(generational),
-   _workers_global(generational),
-   _mutators_global(generational) {}
+  ShenandoahEvacuationTracker(bool generational);
 
   void begin_evacuation(Thread* thread, size_t bytes);
   void end_evacuation(Thread* thread, size_t bytes);
   void record_age(Thread* thread, size_t bytes, uint age);
+  void record_plab_refill(Thread* thread);
+  void record_plab_waste(Thread* thread, size_t bytes);
+  void record_klass(Thread* thread, Klass* klass, size_t bytes, bool promoted);
 
   void print_global_on(outputStream* st);
   void print_evacuations_on(outputStream* st,
                                    ShenandoahEvacuationStats* workers,
                                    ShenandoahEvacuationStats* mutators);
+  // Report the classes that dominated evacuation in the last flushed cycle, if sampling.
+  void print_cycle_klasses_on(outputStream* st);
 
   ShenandoahCycleStats flush_cycle_to_global();
 };
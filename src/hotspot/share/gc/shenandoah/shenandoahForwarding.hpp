@@ -28,6 +28,13 @@
 #include "oops/oop.hpp"
 #include "utilities/globalDefinitions.hpp"
 
+// The forwardee of an evacuated object is installed in the mark word of the from-space copy.
+// Only the from-space copy is overwritten: the to-space copy is made from the original header,
+// so locking and identity hashes on the live copy never see the forwarding. Besides the
+// accessors here, the forwarding bits are also decoded inline by the cmpxchg_oop barriers of
+// every platform's BarrierSetAssembler, and tested through oopDesc::is_forwarded() by the
+// evacuation and update-refs closures, so moving the forwardee out of the header would have
+// to change all of them together.
 class ShenandoahForwarding {
 public:
   /* Gets forwardee from the given object.
@@ -25,23 +25,46 @@
 
 #include "precompiled.hpp"
 #include "gc/shared/tlab_globals.hpp"
+#include "gc/shared/workerThread.hpp"
 #include "gc/shenandoah/shenandoahAffiliation.hpp"
 #include "gc/shenandoah/shenandoahBarrierSet.hpp"
 #include "gc/shenandoah/shenandoahFreeSet.hpp"
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahHeapRegionSet.hpp"
 #include "gc/shenandoah/shenandoahMarkingContext.inline.hpp"
+#include "gc/shenandoah/shenandoahNUMA.hpp"
 #include "gc/shenandoah/shenandoahOldGeneration.hpp"
+#include "gc/shenandoah/shenandoahPadding.hpp"
 #include "gc/shenandoah/shenandoahScanRemembered.inline.hpp"
+#include "gc/shenandoah/shenandoahThreadLocalData.hpp"
+#include "gc/shenandoah/shenandoahUtils.hpp"
 #include "gc/shenandoah/shenandoahYoungGeneration.hpp"
 #include "logging/logStream.hpp"
 #include "memory/resourceArea.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/orderAccess.hpp"
+#include "runtime/os.hpp"
+#include "runtime/safepoint.hpp"
+#include "utilities/copy.hpp"
+
+ShenandoahFreeSetsDelta::ShenandoahFreeSetsDelta(size_t max_regions) {
+  for (size_t idx = 0; idx < NumFreeSets; idx++) {
+    _leftmosts[idx] = max_regions;
+    _rightmosts[idx] = 0;
+    _leftmosts_empty[idx] = max_regions;
+    _rightmosts_empty[idx] = 0;
+    _capacity_of[idx] = 0;
+    _region_counts[idx] = 0;
+  }
+}
 
 ShenandoahSetsOfFree::ShenandoahSetsOfFree(size_t max_regions, ShenandoahFreeSet* free_set) :
     _max(max_regions),
+    _bits_per_set(align_up(max_regions, BitsPerWord)),
     _free_set(free_set),
-    _region_size_bytes(ShenandoahHeapRegion::region_size_bytes())
+    _region_size_bytes(ShenandoahHeapRegion::region_size_bytes()),
+    _members(NumFreeSets * _bits_per_set, mtGC),
+    _empties(NumFreeSets * _bits_per_set, mtGC)
 {
   _membership = NEW_C_HEAP_ARRAY(ShenandoahFreeMemoryType, max_regions, mtGC);
   clear_internal();
@@ -56,6 +79,8 @@ void ShenandoahSetsOfFree::clear_internal() {
   for (size_t idx = 0; idx < _max; idx++) {
     _membership[idx] = NotFree;
   }
+  _members.clear();
+  _empties.clear();
 
   for (size_t idx = 0; idx < NumFreeSets; idx++) {
     _leftmosts[idx] = _max;
@@ -89,19 +114,17 @@ void ShenandoahSetsOfFree::increase_used(ShenandoahFreeMemoryType which_set, siz
 }
 
 inline void ShenandoahSetsOfFree::shrink_bounds_if_touched(ShenandoahFreeMemoryType set, size_t idx) {
+  const BitMap::idx_t base = bit_for(set, 0);
   if (idx == _leftmosts[set]) {
-    while ((_leftmosts[set] < _max) && !in_free_set(_leftmosts[set], set)) {
-      _leftmosts[set]++;
-    }
+    _leftmosts[set] = _members.find_first_set_bit(base + idx, base + _max) - base;
     if (_leftmosts_empty[set] < _leftmosts[set]) {
       // This gets us closer to where we need to be; we'll scan further when leftmosts_empty is requested.
       _leftmosts_empty[set] = _leftmosts[set];
     }
   }
   if (idx == _rightmosts[set]) {
-    while (_rightmosts[set] > 0 && !in_free_set(_rightmosts[set], set)) {
-      _rightmosts[set]--;
-    }
+    BitMap::idx_t last = _members.find_last_set_bit(base, base + idx + 1);
+    _rightmosts[set] = (last == base + idx + 1) ? 0 : last - base;
     if (_rightmosts_empty[set] > _rightmosts[set]) {
       // This gets us closer to where we need to be; we'll scan further when rightmosts_empty is requested.
       _rightmosts_empty[set] = _rightmosts[set];
@@ -131,6 +154,8 @@ void ShenandoahSetsOfFree::remove_from_free_sets(size_t idx) {
   ShenandoahFreeMemoryType orig_set = membership(idx);
   assert (orig_set > NotFree && orig_set < NumFreeSets, "Cannot remove from free sets if not already free");
   _membership[idx] = NotFree;
+  _members.clear_bit(bit_for(orig_set, idx));
+  _empties.clear_bit(bit_for(orig_set, idx));
   shrink_bounds_if_touched(orig_set, idx);
 
   _region_counts[orig_set]--;
@@ -143,6 +168,10 @@ void ShenandoahSetsOfFree::make_free(size_t idx, ShenandoahFreeMemoryType which_
   assert (_membership[idx] == NotFree, "Cannot make free if already free");
   assert (which_set > NotFree && which_set < NumFreeSets, "selected free set must be valid");
   _membership[idx] = which_set;
+  _members.set_bit(bit_for(which_set, idx));
+  if (region_capacity == _region_size_bytes) {
+    _empties.set_bit(bit_for(which_set, idx));
+  }
   _capacity_of[which_set] += region_capacity;
   expand_bounds_maybe(which_set, idx, region_capacity);
 
@@ -150,6 +179,47 @@ void ShenandoahSetsOfFree::make_free(size_t idx, ShenandoahFreeMemoryType which_
   _region_counts[which_set]++;
 }
 
+void ShenandoahSetsOfFree::withdraw(size_t idx, size_t region_capacity) {
+  ShenandoahFreeMemoryType orig_set = membership(idx);
+  assert (orig_set > NotFree && orig_set < NumFreeSets, "Cannot withdraw if not free");
+  assert (_capacity_of[orig_set] - region_capacity >= _used_by[orig_set], "Cannot withdraw used capacity");
+  remove_from_free_sets(idx);
+  _capacity_of[orig_set] -= region_capacity;
+}
+
+void ShenandoahSetsOfFree::make_free_parallel(size_t idx, ShenandoahFreeMemoryType which_set, size_t region_capacity,
+                                              ShenandoahFreeSetsDelta& delta) {
+  assert (idx < _max, "index is sane: " SIZE_FORMAT " < " SIZE_FORMAT, idx, _max);
+  assert (_membership[idx] == NotFree, "Cannot make free if already free");
+  assert (which_set > NotFree && which_set < NumFreeSets, "selected free set must be valid");
+  _membership[idx] = which_set;
+  _members.set_bit(bit_for(which_set, idx));
+  if (region_capacity == _region_size_bytes) {
+    _empties.set_bit(bit_for(which_set, idx));
+    delta._leftmosts_empty[which_set] = MIN2(delta._leftmosts_empty[which_set], idx);
+    delta._rightmosts_empty[which_set] = MAX2(delta._rightmosts_empty[which_set], idx);
+  }
+  delta._leftmosts[which_set] = MIN2(delta._leftmosts[which_set], idx);
+  delta._rightmosts[which_set] = MAX2(delta._rightmosts[which_set], idx);
+  delta._capacity_of[which_set] += region_capacity;
+  delta._region_counts[which_set]++;
+}
+
+void ShenandoahSetsOfFree::merge(const ShenandoahFreeSetsDelta& delta) {
+  for (int set = Mutator; set < NumFreeSets; set++) {
+    if (delta._region_counts[set] == 0) {
+      continue;
+    }
+    _leftmosts[set] = MIN2(_leftmosts[set], delta._leftmosts[set]);
+    _rightmosts[set] = MAX2(_rightmosts[set], delta._rightmosts[set]);
+    _leftmosts_empty[set] = MIN2(_leftmosts_empty[set], delta._leftmosts_empty[set]);
+    _rightmosts_empty[set] = MAX2(_rightmosts_empty[set], delta._rightmosts_empty[set]);
+    _capacity_of[set] += delta._capacity_of[set];
+    _region_counts[set] += delta._region_counts[set];
+    _region_counts[NotFree] -= delta._region_counts[set];
+  }
+}
+
 void ShenandoahSetsOfFree::move_to_set(size_t idx, ShenandoahFreeMemoryType new_set, size_t region_capacity) {
   assert (idx < _max, "index is sane: " SIZE_FORMAT " < " SIZE_FORMAT, idx, _max);
   assert ((new_set > NotFree) && (new_set < NumFreeSets), "New set must be valid");
@@ -169,6 +239,12 @@ void ShenandoahSetsOfFree::move_to_set(size_t idx, ShenandoahFreeMemoryType new_
       "Unexpected movement between sets");
 
   _membership[idx] = new_set;
+  _members.clear_bit(bit_for(orig_set, idx));
+  _empties.clear_bit(bit_for(orig_set, idx));
+  _members.set_bit(bit_for(new_set, idx));
+  if (region_capacity == _region_size_bytes) {
+    _empties.set_bit(bit_for(new_set, idx));
+  }
   _capacity_of[orig_set] -= region_capacity;
   shrink_bounds_if_touched(orig_set, idx);
 
@@ -219,13 +295,33 @@ inline bool ShenandoahSetsOfFree::is_empty(ShenandoahFreeMemoryType which_set) c
   return (leftmost(which_set) > rightmost(which_set));
 }
 
+inline size_t ShenandoahSetsOfFree::find_first_empty(ShenandoahFreeMemoryType which_set, size_t beg, size_t end) const {
+  assert (which_set > NotFree && which_set < NumFreeSets, "selected free set must be valid");
+  assert (beg <= end && end <= _max, "range is sane: [" SIZE_FORMAT ", " SIZE_FORMAT ")", beg, end);
+  const BitMap::idx_t base = bit_for(which_set, 0);
+  return _empties.find_first_set_bit(base + beg, base + end) - base;
+}
+
+inline size_t ShenandoahSetsOfFree::find_first_non_empty(ShenandoahFreeMemoryType which_set, size_t beg, size_t end) const {
+  assert (which_set > NotFree && which_set < NumFreeSets, "selected free set must be valid");
+  assert (beg <= end && end <= _max, "range is sane: [" SIZE_FORMAT ", " SIZE_FORMAT ")", beg, end);
+  const BitMap::idx_t base = bit_for(which_set, 0);
+  return _empties.find_first_clear_bit(base + beg, base + end) - base;
+}
+
+inline void ShenandoahSetsOfFree::clear_empty(size_t idx) {
+  ShenandoahFreeMemoryType set = membership(idx);
+  assert (set > NotFree && set < NumFreeSets, "Region must be in a free set: " SIZE_FORMAT, idx);
+  _empties.clear_bit(bit_for(set, idx));
+}
+
 size_t ShenandoahSetsOfFree::leftmost_empty(ShenandoahFreeMemoryType which_set) {
   assert (which_set > NotFree && which_set < NumFreeSets, "selected free set must be valid");
-  for (size_t idx = _leftmosts_empty[which_set]; idx < _max; idx++) {
-    if ((membership(idx) == which_set) && (_free_set->alloc_capacity(idx) == _region_size_bytes)) {
-      _leftmosts_empty[which_set] = idx;
-      return idx;
-    }
+  size_t idx = find_first_empty(which_set, MIN2(_leftmosts_empty[which_set], _max), _max);
+  if (idx < _max) {
+    assert(_free_set->alloc_capacity(idx) == _region_size_bytes, "Region " SIZE_FORMAT " must be empty", idx);
+    _leftmosts_empty[which_set] = idx;
+    return idx;
   }
   _leftmosts_empty[which_set] = _max;
   _rightmosts_empty[which_set] = 0;
@@ -234,11 +330,14 @@ size_t ShenandoahSetsOfFree::leftmost_empty(ShenandoahFreeMemoryType which_set)
 
 inline size_t ShenandoahSetsOfFree::rightmost_empty(ShenandoahFreeMemoryType which_set) {
   assert (which_set > NotFree && which_set < NumFreeSets, "selected free set must be valid");
-  for (intptr_t idx = _rightmosts_empty[which_set]; idx >= 0; idx--) {
-    if ((membership(idx) == which_set) && (_free_set->alloc_capacity(idx) == _region_size_bytes)) {
-      _rightmosts_empty[which_set] = idx;
-      return idx;
-    }
+  const BitMap::idx_t base = bit_for(which_set, 0);
+  const BitMap::idx_t end = base + MIN2(_rightmosts_empty[which_set] + 1, _max);
+  BitMap::idx_t bit = _empties.find_last_set_bit(base, end);
+  if (bit < end) {
+    size_t idx = bit - base;
+    assert(_free_set->alloc_capacity(idx) == _region_size_bytes, "Region " SIZE_FORMAT " must be empty", idx);
+    _rightmosts_empty[which_set] = idx;
+    return idx;
   }
   _leftmosts_empty[which_set] = _max;
   _rightmosts_empty[which_set] = 0;
@@ -407,11 +506,229 @@ void ShenandoahSetsOfFree::assert_bounds() {
 
 ShenandoahFreeSet::ShenandoahFreeSet(ShenandoahHeap* heap, size_t max_regions) :
   _heap(heap),
-  _free_sets(max_regions, this)
+  _free_sets(max_regions, this),
+  _num_alloc_shards((uint) ShenandoahAllocShards),
+  _mutator_shards(nullptr),
+  _collector_shards(nullptr),
+  _num_medium_shards((uint) ShenandoahMediumAllocShards),
+  _medium_min_words(MAX2(ShenandoahMediumObjectMinSize / HeapWordSize, (size_t) 1)),
+  _medium_shards(nullptr)
 {
+  if (_num_alloc_shards > 0) {
+    _mutator_shards = NEW_C_HEAP_ARRAY(ShenandoahAllocShard, _num_alloc_shards, mtGC);
+    _collector_shards = NEW_C_HEAP_ARRAY(ShenandoahAllocShard, _num_alloc_shards, mtGC);
+    for (uint i = 0; i < _num_alloc_shards; i++) {
+      ::new (&_mutator_shards[i]) ShenandoahAllocShard();
+      ::new (&_collector_shards[i]) ShenandoahAllocShard();
+    }
+  }
+  if (_num_medium_shards > 0) {
+    _medium_shards = NEW_C_HEAP_ARRAY(ShenandoahAllocShard, _num_medium_shards, mtGC);
+    for (uint i = 0; i < _num_medium_shards; i++) {
+      ::new (&_medium_shards[i]) ShenandoahAllocShard();
+    }
+  }
   clear_internal();
 }
 
+ShenandoahAllocShard* ShenandoahFreeSet::alloc_shard_for(ShenandoahAllocRequest& req) const {
+  ShenandoahNUMA* numa = _heap->numa();
+  uint hint;
+  if (numa->is_enabled()) {
+    // Threads on the same node share shards, so that the regions they claim come from the local node.
+    hint = numa->node_index_of_current_thread();
+  } else {
+    hint = ShenandoahThreadLocalData::alloc_shard_hint(Thread::current());
+  }
+  if (is_medium_alloc(req)) {
+    return &_medium_shards[hint % _num_medium_shards];
+  }
+  assert(_num_alloc_shards > 0, "Allocation shards must be enabled");
+  ShenandoahAllocShard* shards = req.is_mutator_alloc() ? _mutator_shards : _collector_shards;
+  return &shards[hint % _num_alloc_shards];
+}
+
+HeapWord* ShenandoahFreeSet::allocate_in_shard_region(ShenandoahHeapRegion* r, ShenandoahAllocRequest& req) {
+  assert(r->affiliation() == req.affiliation(), "Shard region must match request affiliation");
+  if (!req.is_lab_alloc()) {
+    return r->allocate_shared_atomic(req);
+  }
+  HeapWord* result = r->allocate_lab_atomic(req);
+  if (result != nullptr && req.is_gc_alloc()) {
+    // See try_allocate_in(): objects evacuated into this region are not updated during evacuation.  Racing
+    // GCLAB allocations may publish their tops out of order, so the watermark is only ever raised.
+    r->raise_update_watermark(result + req.actual_size());
+  }
+  return result;
+}
+
+size_t ShenandoahFreeSet::retire_shard_region(ShenandoahAllocShard* shard) {
+  shenandoah_assert_heaplocked();
+  ShenandoahHeapRegion* r = shard->region();
+  if (r == nullptr) {
+    return 0;
+  }
+  shard->set_region(nullptr);
+  return r->seal_atomic();
+}
+
+void ShenandoahFreeSet::release_alloc_shards() {
+  shenandoah_assert_heaplocked();
+  // Outside of a safepoint, threads that have already loaded a shard region may still be allocating in it.
+  bool seal = !SafepointSynchronize::is_at_safepoint();
+  for (uint i = 0; i < _num_alloc_shards; i++) {
+    ShenandoahAllocShard* shards[] = { &_mutator_shards[i], &_collector_shards[i] };
+    for (ShenandoahAllocShard* shard : shards) {
+      ShenandoahLocker locker(shard->lock());
+      if (seal) {
+        retire_shard_region(shard);
+      } else {
+        shard->set_region(nullptr);
+      }
+    }
+  }
+  for (uint i = 0; i < _num_medium_shards; i++) {
+    ShenandoahLocker locker(_medium_shards[i].lock());
+    if (seal) {
+      retire_shard_region(&_medium_shards[i]);
+    } else {
+      _medium_shards[i].set_region(nullptr);
+    }
+  }
+}
+
+HeapWord* ShenandoahFreeSet::allocate_medium_region(ShenandoahAllocRequest& req, bool& in_new_region) {
+  shenandoah_assert_heaplocked();
+  assert(is_medium_alloc(req), "Only for medium objects");
+
+  // A medium shard bump allocates in its region until the next object does not fit, and then seals
+  // the rest of the region as waste.  Claiming empty regions first keeps the sealed waste per region
+  // the smallest.  See allocate_single() for when new regions may be affiliated.
+  bool allow_new_region = !_heap->mode()->is_generational() ||
+                          _heap->young_generation()->free_unaffiliated_regions() > 0;
+  if (allow_new_region) {
+    size_t leftmost = _free_sets.leftmost_empty(Mutator);
+    size_t rightmost = _free_sets.rightmost_empty(Mutator);
+    for (size_t c = rightmost + 1; c > leftmost; c--) {
+      size_t idx = c - 1;
+      if (_free_sets.in_free_set(idx, Mutator) && can_allocate_from(idx)) {
+        HeapWord* result = try_allocate_in(_heap->get_region(idx), req, in_new_region);
+        if (result != nullptr) {
+          return result;
+        }
+      }
+    }
+  }
+
+  size_t min_capacity = ShenandoahHeapRegion::region_size_bytes() / 2;
+  size_t leftmost = _free_sets.leftmost(Mutator);
+  size_t rightmost = _free_sets.rightmost(Mutator);
+  for (size_t c = rightmost + 1; c > leftmost; c--) {
+    size_t idx = c - 1;
+    if (_free_sets.in_free_set(idx, Mutator)) {
+      ShenandoahHeapRegion* r = _heap->get_region(idx);
+      if (r->is_affiliated() && alloc_capacity(r) >= min_capacity) {
+        HeapWord* result = try_allocate_in(r, req, in_new_region);
+        if (result != nullptr) {
+          return result;
+        }
+      }
+    }
+  }
+  return nullptr;
+}
+
+size_t ShenandoahFreeSet::release_collector_shards_to_mutator() {
+  shenandoah_assert_heaplocked();
+  assert(!_heap->is_evacuation_in_progress(), "No GCLAB allocations may race with the transfer");
+  size_t transferred = 0;
+  for (uint i = 0; i < _num_alloc_shards; i++) {
+    ShenandoahLocker locker(_collector_shards[i].lock());
+    ShenandoahHeapRegion* r = _collector_shards[i].region();
+    if (r != nullptr) {
+      size_t ac = alloc_capacity(r);
+      if (ac > 0) {
+        assert(_free_sets.membership(r->index()) == NotFree, "Shard regions are not in any free set");
+        _free_sets.make_free(r->index(), Mutator, ac);
+        transferred += ac;
+      }
+      _collector_shards[i].set_region(nullptr);
+    }
+  }
+  return transferred;
+}
+
+HeapWord* ShenandoahFreeSet::allocate_from_shard(ShenandoahAllocRequest& req, bool& in_new_region) {
+  shenandoah_assert_not_heaplocked();
+  assert(can_allocate_from_shard(req), "Only TLABs, GCLABs and medium objects are served from shards");
+  ShenandoahAllocShard* shard = alloc_shard_for(req);
+
+  // Fast path: the region owned by the shard fits the request.
+  ShenandoahHeapRegion* r = shard->region();
+  if (r != nullptr) {
+    HeapWord* result = allocate_in_shard_region(r, req);
+    if (result != nullptr) {
+      in_new_region = false;
+      return result;
+    }
+  }
+
+  // Slow path: retire the shard's region and claim a new one from the free set.  The heap lock is always
+  // acquired before the shard lock.
+  ShenandoahHeapLocker heap_locker(_heap->lock(), req.is_mutator_alloc());
+  ShenandoahLocker locker(shard->lock());
+
+  // Another thread may have claimed a new region for this shard while we were waiting for the locks.
+  r = shard->region();
+  if (r != nullptr) {
+    HeapWord* result = allocate_in_shard_region(r, req);
+    if (result != nullptr) {
+      in_new_region = false;
+      return result;
+    }
+    if (is_medium_alloc(req) && pointer_delta(r->end(), r->top()) >= _medium_min_words) {
+      // A medium shard keeps its region for as long as the smallest medium object still fits, and the
+      // object that does not fit is allocated elsewhere.
+      return allocate_single(req, in_new_region);
+    }
+    size_t sealed = retire_shard_region(shard);
+    if (req.is_mutator_alloc()) {
+      // The remainder was charged to the Mutator set when the shard claimed the region; now it becomes waste.
+      req.set_waste(req.waste() + sealed);
+    }
+  }
+
+  bool claim = true;
+  HeapWord* result = nullptr;
+  if (is_medium_alloc(req)) {
+    result = allocate_medium_region(req, in_new_region);
+    if (result == nullptr) {
+      // No region is worth claiming, allocate the object like any other shared object.
+      claim = false;
+      result = allocate_single(req, in_new_region);
+    }
+  } else {
+    result = allocate_single(req, in_new_region);
+  }
+  if (result != nullptr && claim) {
+    r = _heap->heap_region_containing(result);
+    size_t idx = r->index();
+    ShenandoahFreeMemoryType set = _free_sets.membership(idx);
+    if (set == Mutator && req.is_mutator_alloc()) {
+      // Charge the rest of the region to the Mutator set now, so that its accounting does not depend on
+      // allocations that happen outside of the heap lock.
+      _free_sets.increase_used(Mutator, r->free());
+      _free_sets.remove_from_free_sets(idx);
+      shard->set_region(r);
+    } else if (set == Collector && req.is_gc_alloc()) {
+      _free_sets.remove_from_free_sets(idx);
+      shard->set_region(r);
+    }
+    _free_sets.assert_bounds();
+  }
+  return result;
+}
+
 // This allocates from a region within the old_collector_set.  If affiliation equals OLD, the allocation must be taken
 // from a region that is_old().  Otherwise, affiliation should be FREE, in which case this will put a previously unaffiliated
 // region into service.
@@ -494,6 +811,39 @@ HeapWord* ShenandoahFreeSet::allocate_with_affiliation(ShenandoahAffiliation aff
   return nullptr;
 }
 
+HeapWord* ShenandoahFreeSet::allocate_from_mutator(ShenandoahAllocRequest& req, bool& in_new_region, bool allow_new_region,
+                                                   size_t leftmost, size_t rightmost) {
+  // Allocate within mutator free from high memory to low so as to preserve low memory for humongous allocations
+  // Use signed idx.  Otherwise, loop will never terminate.
+  for (int idx = (int) rightmost; idx >= (int) leftmost; idx--) {
+    ShenandoahHeapRegion* r = _heap->get_region(idx);
+    if (_free_sets.in_free_set(idx, Mutator) && (allow_new_region || r->is_affiliated())) {
+      // try_allocate_in() increases used if the allocation is successful.
+      HeapWord* result;
+      size_t min_size = (req.type() == ShenandoahAllocRequest::_alloc_tlab)? req.min_size(): req.size();
+      if ((alloc_capacity(r) >= min_size) && ((result = try_allocate_in(r, req, in_new_region)) != nullptr)) {
+        return result;
+      }
+    }
+  }
+  return nullptr;
+}
+
+HeapWord* ShenandoahFreeSet::allocate_from_collector(ShenandoahAllocRequest& req, bool& in_new_region,
+                                                     size_t leftmost, size_t rightmost) {
+  // size_t is unsigned, need to dodge underflow when _leftmost = 0
+  for (size_t c = rightmost + 1; c > leftmost; c--) {
+    size_t idx = c - 1;
+    if (_free_sets.in_free_set(idx, Collector)) {
+      HeapWord* result = try_allocate_in(_heap->get_region(idx), req, in_new_region);
+      if (result != nullptr) {
+        return result;
+      }
+    }
+  }
+  return nullptr;
+}
+
 HeapWord* ShenandoahFreeSet::allocate_single(ShenandoahAllocRequest& req, bool& in_new_region) {
   shenandoah_assert_heaplocked();
 
@@ -538,22 +888,38 @@ HeapWord* ShenandoahFreeSet::allocate_single(ShenandoahAllocRequest& req, bool&
   switch (req.type()) {
     case ShenandoahAllocRequest::_alloc_tlab:
     case ShenandoahAllocRequest::_alloc_shared: {
-      // Try to allocate in the mutator view
-      // Allocate within mutator free from high memory to low so as to preserve low memory for humongous allocations
+      // Try to allocate in the mutator view, preferring regions on the NUMA node of the requesting thread,
+      // then any region outside of the slow memory tier.
       if (!_free_sets.is_empty(Mutator)) {
-        // Use signed idx.  Otherwise, loop will never terminate.
-        int leftmost = (int) _free_sets.leftmost(Mutator);
-        for (int idx = (int) _free_sets.rightmost(Mutator); idx >= leftmost; idx--) {
-          ShenandoahHeapRegion* r = _heap->get_region(idx);
-          if (_free_sets.in_free_set(idx, Mutator) && (allow_new_region || r->is_affiliated())) {
-            // try_allocate_in() increases used if the allocation is successful.
-            HeapWord* result;
-            size_t min_size = (req.type() == ShenandoahAllocRequest::_alloc_tlab)? req.min_size(): req.size();
-            if ((alloc_capacity(r) >= min_size) && ((result = try_allocate_in(r, req, in_new_region)) != nullptr)) {
+        ShenandoahNUMA* numa = _heap->numa();
+        size_t fast_rightmost = _free_sets.rightmost(Mutator);
+        if (numa->has_slow_tier()) {
+          fast_rightmost = (numa->first_slow_region() > 0) ? MIN2(fast_rightmost, numa->first_slow_region() - 1) : 0;
+        }
+        if (numa->is_enabled()) {
+          uint node = numa->node_index_of_current_thread();
+          size_t leftmost = MAX2(_free_sets.leftmost(Mutator), numa->first_region_for_node(node));
+          size_t rightmost = MIN2(fast_rightmost, numa->last_region_for_node(node));
+          if (leftmost <= rightmost && !numa->is_slow_region(rightmost)) {
+            HeapWord* result = allocate_from_mutator(req, in_new_region, allow_new_region, leftmost, rightmost);
+            if (result != nullptr) {
               return result;
             }
           }
         }
+        if (fast_rightmost < _free_sets.rightmost(Mutator) && _free_sets.leftmost(Mutator) <= fast_rightmost &&
+            !numa->is_slow_region(fast_rightmost)) {
+          HeapWord* result = allocate_from_mutator(req, in_new_region, allow_new_region,
+                                                   _free_sets.leftmost(Mutator), fast_rightmost);
+          if (result != nullptr) {
+            return result;
+          }
+        }
+        HeapWord* result = allocate_from_mutator(req, in_new_region, allow_new_region,
+                                                 _free_sets.leftmost(Mutator), _free_sets.rightmost(Mutator));
+        if (result != nullptr) {
+          return result;
+        }
       }
       // There is no recovery. Mutator does not touch collector view at all.
       break;
@@ -567,17 +933,25 @@ HeapWord* ShenandoahFreeSet::allocate_single(ShenandoahAllocRequest& req, bool&
 
     case ShenandoahAllocRequest::_alloc_shared_gc: {
       if (!_heap->mode()->is_generational()) {
-        // size_t is unsigned, need to dodge underflow when _leftmost = 0
-        // Fast-path: try to allocate in the collector view first
-        for (size_t c = _free_sets.rightmost(Collector) + 1; c > _free_sets.leftmost(Collector); c--) {
-          size_t idx = c - 1;
-          if (_free_sets.in_free_set(idx, Collector)) {
-            HeapWord* result = try_allocate_in(_heap->get_region(idx), req, in_new_region);
+        // Fast-path: try to allocate in the collector view first, starting with regions local to the
+        // evacuating thread.
+        ShenandoahNUMA* numa = _heap->numa();
+        HeapWord* result;
+        if (numa->is_enabled() && !_free_sets.is_empty(Collector)) {
+          uint node = numa->node_index_of_current_thread();
+          size_t leftmost = MAX2(_free_sets.leftmost(Collector), numa->first_region_for_node(node));
+          size_t rightmost = MIN2(_free_sets.rightmost(Collector), numa->last_region_for_node(node));
+          if (leftmost <= rightmost) {
+            result = allocate_from_collector(req, in_new_region, leftmost, rightmost);
             if (result != nullptr) {
               return result;
             }
           }
         }
+        result = allocate_from_collector(req, in_new_region, _free_sets.leftmost(Collector), _free_sets.rightmost(Collector));
+        if (result != nullptr) {
+          return result;
+        }
       } else {
         // First try to fit into a region that is already in use in the same generation.
         HeapWord* result;
@@ -785,15 +1159,19 @@ HeapWord* ShenandoahFreeSet::try_allocate_in(ShenandoahHeapRegion* r, Shenandoah
     }
   } else {
     size_t size = req.size();
+    // Only an allocation at the bottom of a region that is known to be zeroed can skip zeroing its memory
+    bool zeroed = r->is_zeroed_when_committed();
     result = r->allocate(size, req);
     if (result != nullptr) {
       // Record actual allocation size
       req.set_actual_size(size);
+      req.set_zeroed(zeroed);
     }
   }
 
   ShenandoahGeneration* generation = _heap->generation_for(req.affiliation());
   if (result != nullptr) {
+    _free_sets.clear_empty(r->index());
     // Allocation successful, bump stats:
     if (req.is_mutator_alloc()) {
       assert(req.is_young(), "Mutator allocations always come from young generation.");
@@ -868,34 +1246,54 @@ HeapWord* ShenandoahFreeSet::allocate_contiguous(ShenandoahAllocRequest& req) {
   // Find the continuous interval of $num regions, starting from $beg and ending in $end,
   // inclusive. Contiguous allocations are biased to the beginning.
 
-  size_t beg = _free_sets.leftmost(Mutator);
-  size_t end = beg;
+  const size_t max = _free_sets.max();
+  size_t beg = _free_sets.leftmost_empty(Mutator);
+  size_t end;
 
   while (true) {
-    if (end >= _free_sets.max()) {
+    beg = _free_sets.find_first_empty(Mutator, beg, max);
+    if (beg + num > max) {
       // Hit the end, goodbye
+      if (_heap->mode()->is_generational()) {
+        // There are enough free regions, but old regions are in the way: have old clear a run of them.
+        _heap->old_generation()->heuristics()->trigger_humongous_fragmentation(num);
+      }
       return nullptr;
     }
 
-    // If regions are not adjacent, then current [beg; end] is useless, and we may fast-forward.
-    // If region is not completely free, the current [beg; end] is useless, and we may fast-forward.
-    if (!_free_sets.in_free_set(end, Mutator) || !can_allocate_from(_heap->get_region(end))) {
-      end++;
-      beg = end;
+    // If a region in [beg; beg + num) is not an empty Mutator region, the candidate interval is useless, and
+    // we may fast-forward past it.
+    end = _free_sets.find_first_non_empty(Mutator, beg, beg + num);
+    if (end < beg + num) {
+      beg = end + 1;
       continue;
     }
 
-    if ((end - beg + 1) == num) {
-      // found the match
-      break;
+    // Empty regions include trash, which cannot be recycled while concurrent weak roots are in progress.
+    end = beg;
+    while (end < beg + num && can_allocate_from(_heap->get_region(end))) {
+      end++;
+    }
+    if (end < beg + num) {
+      beg = end + 1;
+      continue;
     }
 
-    end++;
+    // found the match
+    end = beg + num - 1;
+    break;
   }
 
   size_t remainder = words_size & ShenandoahHeapRegion::region_size_words_mask();
   ShenandoahMarkingContext* const ctx = _heap->complete_marking_context();
 
+  // The object memory is known to be zeroed only if all regions were zeroed before they became humongous,
+  // or are about to be committed from fresh memory.
+  bool zeroed = true;
+  for (size_t i = beg; i <= end && zeroed; i++) {
+    zeroed = _heap->get_region(i)->is_zeroed_when_committed();
+  }
+
   // Initialize regions:
   for (size_t i = beg; i <= end; i++) {
     ShenandoahHeapRegion* r = _heap->get_region(i);
@@ -931,6 +1329,7 @@ HeapWord* ShenandoahFreeSet::allocate_contiguous(ShenandoahAllocRequest& req) {
   _free_sets.increase_used(Mutator, total_humongous_size);
   _free_sets.assert_bounds();
   req.set_actual_size(words_size);
+  req.set_zeroed(zeroed);
   if (remainder != 0) {
     req.set_waste(ShenandoahHeapRegion::region_size_words() - remainder);
   }
@@ -973,17 +1372,248 @@ void ShenandoahFreeSet::try_recycle_trashed(ShenandoahHeapRegion *r) {
   }
 }
 
+bool ShenandoahFreeSet::can_withdraw_from_mutator() const {
+  const size_t region_size_bytes = ShenandoahHeapRegion::region_size_bytes();
+  return _free_sets.capacity_of(Mutator) - _free_sets.used_by(Mutator) >= region_size_bytes;
+}
+
+void ShenandoahFreeSet::zero_withdrawn_regions(ShenandoahHeapRegion** regions, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    ShenandoahHeapRegion* r = regions[i];
+    assert(r->is_empty_committed(), "Only zero empty committed regions: " SIZE_FORMAT, r->index());
+    assert(_free_sets.membership(r->index()) == NotFree, "Region must be withdrawn while it is zeroed: " SIZE_FORMAT, r->index());
+    Copy::zero_to_words(r->bottom(), ShenandoahHeapRegion::region_size_words());
+    r->set_zeroed();
+  }
+}
+
+void ShenandoahFreeSet::recycle_trash_batch(ShenandoahHeapRegion** batch, size_t count) {
+  const size_t region_size_bytes = ShenandoahHeapRegion::region_size_bytes();
+  size_t zeroing = 0;
+  {
+    ShenandoahHeapLocker locker(_heap->lock());
+    for (size_t i = 0; i < count; i++) {
+      ShenandoahHeapRegion* r = batch[i];
+      if (!r->is_trash()) {
+        // An allocator recycled this region while we were collecting the batch
+        continue;
+      }
+      if (ShenandoahRecycleZeroing && _free_sets.membership(r->index()) == Mutator && can_withdraw_from_mutator()) {
+        // Take the region out of the free set until it has been zeroed, so that allocators cannot use it meanwhile.
+        // Recycle it first: recycling may mangle the region in debug builds.
+        _free_sets.withdraw(r->index(), region_size_bytes);
+        batch[zeroing++] = r;
+      }
+      try_recycle_trashed(r);
+    }
+  }
+
+  if (zeroing == 0) {
+    return;
+  }
+
+  zero_withdrawn_regions(batch, zeroing);
+
+  ShenandoahHeapLocker locker(_heap->lock());
+  for (size_t i = 0; i < zeroing; i++) {
+    _free_sets.make_free(batch[i]->index(), Mutator, region_size_bytes);
+  }
+  _free_sets.assert_bounds();
+}
+
+void ShenandoahFreeSet::maintain_zeroed_regions(size_t target) {
+  static const size_t BatchSize = 32;
+  const size_t region_size_bytes = ShenandoahHeapRegion::region_size_bytes();
+  ShenandoahHeapRegion* batch[BatchSize];
+
+  size_t zeroed = 0;
+  size_t next = 0;
+  while (zeroed < target) {
+    size_t count = 0;
+    {
+      ShenandoahHeapLocker locker(_heap->lock());
+      const size_t max = _free_sets.max();
+      size_t idx = _free_sets.find_first_empty(Mutator, MAX2(next, _free_sets.leftmost_empty(Mutator)), max);
+      while (idx < max && zeroed + count < target && count < BatchSize) {
+        ShenandoahHeapRegion* r = _heap->get_region(idx);
+        if (r->is_zeroed()) {
+          zeroed++;
+        } else if (r->is_empty_committed() && can_withdraw_from_mutator()) {
+          _free_sets.withdraw(idx, region_size_bytes);
+          batch[count++] = r;
+        }
+        idx = _free_sets.find_first_empty(Mutator, idx + 1, max);
+      }
+      next = idx;
+      if (count == 0) {
+        // No more empty regions to zero
+        return;
+      }
+    }
+
+    zero_withdrawn_regions(batch, count);
+    zeroed += count;
+
+    ShenandoahHeapLocker locker(_heap->lock());
+    for (size_t i = 0; i < count; i++) {
+      _free_sets.make_free(batch[i]->index(), Mutator, region_size_bytes);
+    }
+    _free_sets.assert_bounds();
+  }
+}
+
+class ShenandoahPretouchRegionsTask : public WorkerTask {
+private:
+  ShenandoahHeapRegion** const _regions;
+  const size_t _count;
+
+  shenandoah_padding(0);
+  volatile size_t _index;
+  shenandoah_padding(1);
+
+public:
+  ShenandoahPretouchRegionsTask(ShenandoahHeapRegion** regions, size_t count) :
+    WorkerTask("Shenandoah Pretouch Regions"),
+    _regions(regions),
+    _count(count),
+    _index(0) {}
+
+  void work(uint worker_id) override {
+    // Touch every small page: with transparent huge pages, the kernel coalesces them once they are all used.
+    // The pages land on the node the region was requested on when it was committed.
+    const size_t page_size = os::vm_page_size();
+    for (size_t i = Atomic::fetch_then_add(&_index, (size_t) 1); i < _count; i = Atomic::fetch_then_add(&_index, (size_t) 1)) {
+      ShenandoahHeapRegion* r = _regions[i];
+      os::pretouch_memory(r->bottom(), r->end(), page_size);
+    }
+  }
+};
+
+void ShenandoahFreeSet::pretouch_withdrawn_regions(ShenandoahHeapRegion** regions, size_t count) {
+#ifdef ASSERT
+  for (size_t i = 0; i < count; i++) {
+    assert(regions[i]->is_empty_committed(), "Only pretouch empty committed regions: " SIZE_FORMAT, regions[i]->index());
+    assert(_free_sets.membership(regions[i]->index()) == NotFree,
+           "Region must be withdrawn while it is pretouched: " SIZE_FORMAT, regions[i]->index());
+  }
+#endif
+  ShenandoahPretouchRegionsTask task(regions, count);
+  _heap->workers()->run_task(&task);
+}
+
+void ShenandoahFreeSet::maintain_committed_regions(size_t target) {
+  static const size_t BatchSize = 32;
+  const size_t region_size_bytes = ShenandoahHeapRegion::region_size_bytes();
+  ShenandoahHeapRegion* batch[BatchSize];
+
+  size_t committed = 0;
+  size_t precommitted = 0;
+  size_t next = 0;
+  while (committed < target) {
+    size_t count = 0;
+    {
+      ShenandoahHeapLocker locker(_heap->lock());
+      const size_t max = _free_sets.max();
+      size_t idx = _free_sets.find_first_empty(Mutator, MAX2(next, _free_sets.leftmost_empty(Mutator)), max);
+      while (idx < max && committed + count < target && count < BatchSize) {
+        ShenandoahHeapRegion* r = _heap->get_region(idx);
+        if (r->is_empty_committed()) {
+          committed++;
+        } else if (r->is_empty_uncommitted() && can_withdraw_from_mutator()) {
+          if (_heap->committed() + region_size_bytes > _heap->soft_max_capacity()) {
+            break;
+          }
+          _free_sets.withdraw(idx, region_size_bytes);
+          r->make_committed();
+          batch[count++] = r;
+        }
+        idx = _free_sets.find_first_empty(Mutator, idx + 1, max);
+      }
+      next = idx;
+      if (count == 0) {
+        break;
+      }
+    }
+
+    if (!AlwaysPreTouch) {
+      // Otherwise the commit has touched the memory already
+      pretouch_withdrawn_regions(batch, count);
+    }
+    committed += count;
+    precommitted += count;
+
+    ShenandoahHeapLocker locker(_heap->lock());
+    for (size_t i = 0; i < count; i++) {
+      _free_sets.make_free(batch[i]->index(), Mutator, region_size_bytes);
+    }
+    _free_sets.assert_bounds();
+  }
+
+  if (precommitted > 0) {
+    log_debug(gc, free)("Committed and pretouched " SIZE_FORMAT " regions ahead of allocation", precommitted);
+  }
+}
+
+// Workers claim chunks of regions and collect the trash regions they find into small batches.  Each batch is then
+// recycled under a single acquisition of the heap lock, and allocators get to take the lock between batches.
+class ShenandoahRecycleTrashedRegionsTask : public WorkerTask {
+private:
+  static const size_t BatchSize = 32;
+
+  ShenandoahHeap* const _heap;
+  ShenandoahFreeSet* const _free_set;
+  const bool _concurrent;
+  ShenandoahRegionClaimer _claimer;
+
+public:
+  ShenandoahRecycleTrashedRegionsTask(ShenandoahHeap* heap, ShenandoahFreeSet* free_set, bool concurrent) :
+    WorkerTask("Shenandoah Recycle Trash"),
+    _heap(heap),
+    _free_set(free_set),
+    _concurrent(concurrent),
+    _claimer(heap->num_regions(), heap->workers()->active_workers()) {}
+
+  void work(uint worker_id) {
+    if (_concurrent) {
+      ShenandoahConcurrentWorkerSession worker_session(worker_id);
+      do_work();
+    } else {
+      ShenandoahParallelWorkerSession worker_session(worker_id);
+      do_work();
+    }
+  }
+
+  void do_work() {
+    ShenandoahHeapRegion* batch[BatchSize];
+    size_t count = 0;
+    size_t begin, end;
+    while (_claimer.claim(&begin, &end)) {
+      for (size_t i = begin; i < end; i++) {
+        ShenandoahHeapRegion* r = _heap->get_region(i);
+        if (r->is_trash()) {
+          batch[count++] = r;
+          if (count == BatchSize) {
+            _free_set->recycle_trash_batch(batch, count);
+            count = 0;
+          }
+        }
+      }
+    }
+    if (count > 0) {
+      _free_set->recycle_trash_batch(batch, count);
+    }
+  }
+};
+
 void ShenandoahFreeSet::recycle_trash() {
   // lock is not reentrable, check we don't have it
   shenandoah_assert_not_heaplocked();
 
-  for (size_t i = 0; i < _heap->num_regions(); i++) {
-    ShenandoahHeapRegion* r = _heap->get_region(i);
-    if (r->is_trash()) {
-      ShenandoahHeapLocker locker(_heap->lock());
-      try_recycle_trashed(r);
-    }
-    SpinPause(); // allow allocators to take the lock
+  ShenandoahRecycleTrashedRegionsTask task(_heap, this, !SafepointSynchronize::is_at_safepoint());
+  if (_heap->num_regions() > ShenandoahParallelRegionStride) {
+    _heap->workers()->run_task(&task);
+  } else {
+    task.do_work();
   }
 }
 
@@ -1024,6 +1654,7 @@ void ShenandoahFreeSet::flip_to_gc(ShenandoahHeapRegion* r) {
 
 void ShenandoahFreeSet::clear() {
   shenandoah_assert_heaplocked();
+  release_alloc_shards();
   clear_internal();
 }
 
@@ -1036,15 +1667,11 @@ void ShenandoahFreeSet::clear_internal() {
 // move some of the mutator regions into the collector set or old_collector set with the intent of packing
 // old_collector memory into the highest (rightmost) addresses of the heap and the collector memory into the
 // next highest addresses of the heap, with mutator memory consuming the lowest addresses of the heap.
-void ShenandoahFreeSet::find_regions_with_alloc_capacity(size_t &young_cset_regions, size_t &old_cset_regions,
+void ShenandoahFreeSet::find_regions_with_alloc_capacity(size_t begin, size_t end, ShenandoahFreeSetsDelta& delta,
+                                                         size_t &young_cset_regions, size_t &old_cset_regions,
                                                          size_t &first_old_region, size_t &last_old_region,
                                                          size_t &old_region_count) {
-  first_old_region = _heap->num_regions();
-  last_old_region = 0;
-  old_region_count = 0;
-  old_cset_regions = 0;
-  young_cset_regions = 0;
-  for (size_t idx = 0; idx < _heap->num_regions(); idx++) {
+  for (size_t idx = begin; idx < end; idx++) {
     ShenandoahHeapRegion* region = _heap->get_region(idx);
     if (region->is_trash()) {
       // Trashed regions represent regions that had been in the collection set but have not yet been "cleaned up".
@@ -1069,13 +1696,13 @@ void ShenandoahFreeSet::find_regions_with_alloc_capacity(size_t &young_cset_regi
       if (alloc_capacity(region) < PLAB::min_size() * HeapWordSize) continue;
 
       if (region->is_old()) {
-        _free_sets.make_free(idx, OldCollector, alloc_capacity(region));
+        _free_sets.make_free_parallel(idx, OldCollector, alloc_capacity(region), delta);
         log_debug(gc, free)(
           "  Adding Region " SIZE_FORMAT  " (Free: " SIZE_FORMAT "%s, Used: " SIZE_FORMAT "%s) to old collector set",
           idx, byte_size_in_proper_unit(region->free()), proper_unit_for_byte_size(region->free()),
           byte_size_in_proper_unit(region->used()), proper_unit_for_byte_size(region->used()));
       } else {
-        _free_sets.make_free(idx, Mutator, alloc_capacity(region));
+        _free_sets.make_free_parallel(idx, Mutator, alloc_capacity(region), delta);
         log_debug(gc, free)(
           "  Adding Region " SIZE_FORMAT " (Free: " SIZE_FORMAT "%s, Used: " SIZE_FORMAT "%s) to mutator set",
           idx, byte_size_in_proper_unit(region->free()), proper_unit_for_byte_size(region->free()),
@@ -1085,6 +1712,106 @@ void ShenandoahFreeSet::find_regions_with_alloc_capacity(size_t &young_cset_regi
   }
 }
 
+// Classifies regions in parallel.  Workers claim word-aligned chunks of regions so that they can update the free set
+// bitmaps without synchronization, and each worker accumulates its own tallies, which are summed after the task.
+class ShenandoahFindRegionsWithAllocCapacityTask : public WorkerTask {
+private:
+  ShenandoahFreeSet* const _free_set;
+  const size_t _num_regions;
+  const size_t _chunk;
+
+  struct WorkerResult {
+    ShenandoahFreeSetsDelta _delta;
+    size_t _young_cset_regions;
+    size_t _old_cset_regions;
+    size_t _first_old_region;
+    size_t _last_old_region;
+    size_t _old_region_count;
+
+    WorkerResult(size_t num_regions) :
+      _delta(num_regions), _young_cset_regions(0), _old_cset_regions(0),
+      _first_old_region(num_regions), _last_old_region(0), _old_region_count(0) {}
+  };
+
+  const uint _num_workers;
+  WorkerResult* _results;
+
+  shenandoah_padding(0);
+  volatile size_t _index;
+  shenandoah_padding(1);
+
+public:
+  ShenandoahFindRegionsWithAllocCapacityTask(ShenandoahFreeSet* free_set, size_t num_regions, uint num_workers) :
+    WorkerTask("Shenandoah Rebuild Free Set"),
+    _free_set(free_set),
+    _num_regions(num_regions),
+    _chunk(align_up(ShenandoahParallelRegionStride, BitsPerWord)),
+    _num_workers(num_workers),
+    _results(NEW_C_HEAP_ARRAY(WorkerResult, num_workers, mtGC)),
+    _index(0) {
+    for (uint i = 0; i < _num_workers; i++) {
+      ::new (&_results[i]) WorkerResult(num_regions);
+    }
+  }
+
+  ~ShenandoahFindRegionsWithAllocCapacityTask() {
+    FREE_C_HEAP_ARRAY(WorkerResult, _results);
+  }
+
+  void work(uint worker_id) {
+    ShenandoahParallelWorkerSession worker_session(worker_id);
+    WorkerResult& result = _results[worker_id];
+    while (Atomic::load(&_index) < _num_regions) {
+      size_t begin = Atomic::fetch_then_add(&_index, _chunk, memory_order_relaxed);
+      if (begin >= _num_regions) {
+        break;
+      }
+      size_t end = MIN2(begin + _chunk, _num_regions);
+      _free_set->find_regions_with_alloc_capacity(begin, end, result._delta,
+                                                  result._young_cset_regions, result._old_cset_regions,
+                                                  result._first_old_region, result._last_old_region,
+                                                  result._old_region_count);
+    }
+  }
+
+  void merge_into(ShenandoahSetsOfFree& free_sets, size_t &young_cset_regions, size_t &old_cset_regions,
+                  size_t &first_old_region, size_t &last_old_region, size_t &old_region_count) const {
+    for (uint i = 0; i < _num_workers; i++) {
+      const WorkerResult& result = _results[i];
+      free_sets.merge(result._delta);
+      young_cset_regions += result._young_cset_regions;
+      old_cset_regions += result._old_cset_regions;
+      first_old_region = MIN2(first_old_region, result._first_old_region);
+      last_old_region = MAX2(last_old_region, result._last_old_region);
+      old_region_count += result._old_region_count;
+    }
+  }
+};
+
+void ShenandoahFreeSet::find_regions_with_alloc_capacity(size_t &young_cset_regions, size_t &old_cset_regions,
+                                                         size_t &first_old_region, size_t &last_old_region,
+                                                         size_t &old_region_count) {
+  size_t num_regions = _heap->num_regions();
+  first_old_region = num_regions;
+  last_old_region = 0;
+  old_region_count = 0;
+  old_cset_regions = 0;
+  young_cset_regions = 0;
+
+  // Workers are only used at safepoints, where region states do not change under our feet.
+  if (num_regions > ShenandoahParallelRegionStride && SafepointSynchronize::is_at_safepoint()) {
+    WorkerThreads* workers = _heap->workers();
+    ShenandoahFindRegionsWithAllocCapacityTask task(this, num_regions, workers->active_workers());
+    workers->run_task(&task);
+    task.merge_into(_free_sets, young_cset_regions, old_cset_regions, first_old_region, last_old_region, old_region_count);
+  } else {
+    ShenandoahFreeSetsDelta delta(num_regions);
+    find_regions_with_alloc_capacity(0, num_regions, delta, young_cset_regions, old_cset_regions,
+                                     first_old_region, last_old_region, old_region_count);
+    _free_sets.merge(delta);
+  }
+}
+
 // Move no more than cset_regions from the existing Collector and OldCollector free sets to the Mutator free set.
 // This is called from outside the heap lock.
 void ShenandoahFreeSet::move_collector_sets_to_mutator(size_t max_xfer_regions) {
@@ -1137,6 +1864,12 @@ void ShenandoahFreeSet::move_collector_sets_to_mutator(size_t max_xfer_regions)
     }
   }
 
+  // Regions held by GCLAB shards are no longer needed for evacuation either
+  if (_num_alloc_shards > 0) {
+    ShenandoahHeapLocker locker(_heap->lock());
+    collector_not_empty_xfer += release_collector_shards_to_mutator();
+  }
+
   size_t collector_xfer = collector_empty_xfer + collector_not_empty_xfer;
   size_t total_xfer = collector_xfer + old_collector_empty_xfer;
   log_info(gc, free)("At start of update refs, moving " SIZE_FORMAT "%s to Mutator free set from Collector Reserve ("
@@ -1282,7 +2015,7 @@ void ShenandoahFreeSet::reserve_regions(size_t to_reserve, size_t to_reserve_old
       }
     }
 
-    if (move_to_young) {
+    if (move_to_young && !_heap->numa()->is_slow_region(idx)) {
       // Note: In a previous implementation, regions were only placed into the survivor space (collector_is_free) if
       // they were entirely empty.  I'm not sure I understand the rationale for that.  That alternative behavior would
       // tend to mix survivor objects with ephemeral objects, making it more difficult to reclaim the memory for the
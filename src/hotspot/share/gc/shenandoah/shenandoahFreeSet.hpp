@@ -29,6 +29,9 @@
 
 #include "gc/shenandoah/shenandoahHeapRegionSet.hpp"
 #include "gc/shenandoah/shenandoahHeap.hpp"
+#include "gc/shenandoah/shenandoahLock.hpp"
+#include "runtime/atomic.hpp"
+#include "utilities/bitMap.hpp"
 
 enum ShenandoahFreeMemoryType : uint8_t {
   NotFree,
@@ -38,13 +41,39 @@ enum ShenandoahFreeMemoryType : uint8_t {
   NumFreeSets
 };
 
+// Bounds and counters for regions that were placed into free sets by one worker during a parallel rebuild.  Each
+// worker accumulates its own, and they are merged into ShenandoahSetsOfFree by a single thread afterwards.
+class ShenandoahFreeSetsDelta {
+  friend class ShenandoahSetsOfFree;
+private:
+  size_t _leftmosts[NumFreeSets];
+  size_t _rightmosts[NumFreeSets];
+  size_t _leftmosts_empty[NumFreeSets];
+  size_t _rightmosts_empty[NumFreeSets];
+  size_t _capacity_of[NumFreeSets];
+  size_t _region_counts[NumFreeSets];
+
+public:
+  ShenandoahFreeSetsDelta(size_t max_regions);
+};
+
 class ShenandoahSetsOfFree {
 
 private:
   size_t _max;                  // The maximum number of heap regions
+  size_t _bits_per_set;         // _max rounded up to a whole number of bitmap words
   ShenandoahFreeSet* _free_set;
   size_t _region_size_bytes;
   ShenandoahFreeMemoryType* _membership;
+
+  // Bit (which_set * _bits_per_set + idx) of _members is set iff region idx is in which_set, and the same bit of
+  // _empties is set iff region idx is in which_set and has all of its capacity available.  These let searches skip a
+  // word's worth of regions at a time, rather than reading the membership and alloc capacity of each region in turn.
+  // Because every set starts on a word boundary, workers that own disjoint, word-aligned ranges of regions may
+  // update the bitmaps in parallel.
+  CHeapBitMap _members;
+  CHeapBitMap _empties;
+
   size_t _leftmosts[NumFreeSets];
   size_t _rightmosts[NumFreeSets];
   size_t _leftmosts_empty[NumFreeSets];
@@ -54,6 +83,10 @@ private:
   bool _left_to_right_bias[NumFreeSets];
   size_t _region_counts[NumFreeSets];
 
+  inline BitMap::idx_t bit_for(ShenandoahFreeMemoryType which_set, size_t idx) const {
+    return (BitMap::idx_t) (which_set * _bits_per_set + idx);
+  }
+
   inline void shrink_bounds_if_touched(ShenandoahFreeMemoryType set, size_t idx);
   inline void expand_bounds_maybe(ShenandoahFreeMemoryType set, size_t idx, size_t capacity);
 
@@ -73,9 +106,22 @@ public:
   // Place region idx into free set which_set.  Requires that idx is currently NotFree.
   void make_free(size_t idx, ShenandoahFreeMemoryType which_set, size_t region_capacity);
 
+  // Remove region idx from its free set together with its capacity, so that it can be made free again with
+  // make_free() once it has been worked on outside of the heap lock.  Requires that idx has not been allocated from.
+  void withdraw(size_t idx, size_t region_capacity);
+
   // Place region idx into free set new_set.  Requires that idx is currently not NotFree.
   void move_to_set(size_t idx, ShenandoahFreeMemoryType new_set, size_t region_capacity);
 
+  // Like make_free(), but accumulate bounds and counters in delta rather than in this object.  Safe to call from
+  // several workers at once, provided that each worker owns a disjoint range of regions that starts at a multiple
+  // of BitsPerWord.
+  void make_free_parallel(size_t idx, ShenandoahFreeMemoryType which_set, size_t region_capacity,
+                          ShenandoahFreeSetsDelta& delta);
+
+  // Apply the bounds and counters that a worker accumulated with make_free_parallel().
+  void merge(const ShenandoahFreeSetsDelta& delta);
+
   // Returns the ShenandoahFreeMemoryType affiliation of region idx, or NotFree if this region is not currently free.  This does
   // not enforce that free_set membership implies allocation capacity.
   inline ShenandoahFreeMemoryType membership(size_t idx) const;
@@ -100,6 +146,15 @@ public:
 
   inline bool is_empty(ShenandoahFreeMemoryType which_set) const;
 
+  // Returns the index of the first region in [beg, end) of which_set that has all of its capacity available, or
+  // end if there is none.  Returns the index of the first region in [beg, end) that is not such a region, or end
+  // if there is none.  Together these find runs of empty regions for humongous allocation a word at a time.
+  inline size_t find_first_empty(ShenandoahFreeMemoryType which_set, size_t beg, size_t end) const;
+  inline size_t find_first_non_empty(ShenandoahFreeMemoryType which_set, size_t beg, size_t end) const;
+
+  // Record that region idx, which is in a free set, has been allocated from and so is no longer empty.
+  inline void clear_empty(size_t idx);
+
   inline void increase_used(ShenandoahFreeMemoryType which_set, size_t bytes);
 
   inline size_t capacity_of(ShenandoahFreeMemoryType which_set) const {
@@ -146,11 +201,75 @@ public:
   void assert_bounds() NOT_DEBUG_RETURN;
 };
 
+// An allocation shard owns at most one region, taken out of the Mutator or Collector free set, from which it
+// carves TLABs or GCLABs for the threads that map to the shard.  Refills that fit in the shard's region bump the
+// region's top with a CAS and take no lock at all.  The heap lock and then the shard lock are taken only to retire
+// the shard's region and to claim a new one from the free set.  Retirement seals the region by claiming and
+// filling its remainder, so that threads which still race on the old region fail and retry on the new one.
+//
+// When a region is claimed by a mutator shard, its remaining free memory is charged as used by the Mutator set,
+// just as if the region had been retired.  Whatever is left when the shard retires the region is reported as
+// waste by the request that caused the retirement.  Rebuilding the free set simply releases all shards: the
+// rebuild then recomputes membership and capacity from the regions themselves.
+//
+// Medium object shards work the same way for shared mutator allocations of medium objects, which are too large
+// to go through TLABs.  They claim only regions with plenty of room, and retire them only once the smallest
+// medium object no longer fits.
+class ShenandoahAllocShard {
+private:
+  ShenandoahLock _lock;
+  ShenandoahHeapRegion* volatile _region;
+
+public:
+  ShenandoahAllocShard() : _lock(), _region(nullptr) {}
+
+  ShenandoahLock* lock()                       { return &_lock;                              }
+  ShenandoahHeapRegion* region() const         { return Atomic::load_acquire(&_region);     }
+  void set_region(ShenandoahHeapRegion* r)     { Atomic::release_store(&_region, r);        }
+};
+
 class ShenandoahFreeSet : public CHeapObj<mtGC> {
 private:
   ShenandoahHeap* const _heap;
   ShenandoahSetsOfFree _free_sets;
 
+  // Allocation shards for TLABs and for GCLABs respectively, or nullptr if ShenandoahAllocShards is zero.
+  uint _num_alloc_shards;
+  ShenandoahAllocShard* _mutator_shards;
+  ShenandoahAllocShard* _collector_shards;
+
+  // Shards for shared mutator allocations of medium objects, or nullptr if ShenandoahMediumAllocShards is zero.
+  // Medium objects are at least _medium_min_words words large, and below the humongous threshold.
+  uint _num_medium_shards;
+  size_t _medium_min_words;
+  ShenandoahAllocShard* _medium_shards;
+
+  ShenandoahAllocShard* alloc_shard_for(ShenandoahAllocRequest& req) const;
+
+  inline bool is_medium_alloc(ShenandoahAllocRequest& req) const {
+    return _num_medium_shards > 0 && req.type() == ShenandoahAllocRequest::_alloc_shared &&
+           req.size() >= _medium_min_words && req.size() <= ShenandoahHeapRegion::humongous_threshold_words();
+  }
+
+  // Claim a Mutator region for a medium object shard and allocate req in it.  Only regions with room
+  // for at least half a region of medium objects are claimed, empty ones first.  Returns nullptr if
+  // there is no such region, and req is then allocated without a shard.
+  HeapWord* allocate_medium_region(ShenandoahAllocRequest& req, bool& in_new_region);
+
+  // Bump-allocate req in the region owned by a shard.  This does not require any lock.
+  HeapWord* allocate_in_shard_region(ShenandoahHeapRegion* r, ShenandoahAllocRequest& req);
+
+  // Seal and retire the region owned by shard, if any.  Requires that both the heap lock and the shard lock are
+  // held.  Returns the number of words that were sealed.
+  size_t retire_shard_region(ShenandoahAllocShard* shard);
+
+  // Drop the regions owned by all shards.  Requires that the heap lock is held.
+  void release_alloc_shards();
+
+  // Drop the regions owned by collector shards, placing those that still have capacity into the Mutator set.
+  // Requires that the heap lock is held.  Returns the number of bytes made available to the mutator.
+  size_t release_collector_shards_to_mutator();
+
   HeapWord* try_allocate_in(ShenandoahHeapRegion* region, ShenandoahAllocRequest& req, bool& in_new_region);
 
   HeapWord* allocate_aligned_plab(size_t size, ShenandoahAllocRequest& req, ShenandoahHeapRegion* r);
@@ -170,6 +289,12 @@ private:
   // most common case is that we are allocating a PLAB in which case object registering and card dirtying
   // is managed after the PLAB is divided into individual objects.
   HeapWord* allocate_single(ShenandoahAllocRequest& req, bool& in_new_region);
+
+  // Scan regions [leftmost, rightmost] of the Mutator or Collector set, right to left, for the first region that
+  // can satisfy req.  The bounds may be narrower than the bounds of the set, e.g. to prefer NUMA-local regions.
+  HeapWord* allocate_from_mutator(ShenandoahAllocRequest& req, bool& in_new_region, bool allow_new_region,
+                                  size_t leftmost, size_t rightmost);
+  HeapWord* allocate_from_collector(ShenandoahAllocRequest& req, bool& in_new_region, size_t leftmost, size_t rightmost);
   HeapWord* allocate_contiguous(ShenandoahAllocRequest& req);
 
   void flip_to_gc(ShenandoahHeapRegion* r);
@@ -179,6 +304,19 @@ private:
 
   void try_recycle_trashed(ShenandoahHeapRegion *r);
 
+  friend class ShenandoahRecycleTrashedRegionsTask;
+  // Recycle the trash regions among the count regions in batch, taking the heap lock once for all of them.
+  void recycle_trash_batch(ShenandoahHeapRegion** batch, size_t count);
+
+  // True if an empty region may be withdrawn from the Mutator set without taking away memory that is already used.
+  bool can_withdraw_from_mutator() const;
+
+  // Zero the memory of withdrawn empty regions, outside of the heap lock, and record that they are zeroed.
+  void zero_withdrawn_regions(ShenandoahHeapRegion** regions, size_t count);
+
+  // Touch the memory of withdrawn regions that were just committed, with the workers.
+  void pretouch_withdrawn_regions(ShenandoahHeapRegion** regions, size_t count);
+
   bool can_allocate_from(ShenandoahHeapRegion *r) const;
   bool can_allocate_from(size_t idx) const;
   bool has_alloc_capacity(ShenandoahHeapRegion *r) const;
@@ -213,6 +351,16 @@ public:
 
   void recycle_trash();
 
+  // Zero empty Mutator regions outside of the heap lock until at least target of them are known to be zeroed, or
+  // until no empty committed region is left to zero.  Shared and humongous allocations from zeroed regions do not
+  // need to clear the object memory again.
+  void maintain_zeroed_regions(size_t target);
+
+  // Commit empty Mutator regions at the allocation end of the set until at least target of them are committed, and
+  // pretouch them with the workers outside of the heap lock.  Allocators that come after an uncommit then do not
+  // page fault on the memory.  Commits stop at the soft max capacity.
+  void maintain_committed_regions(size_t target);
+
   void log_status();
 
   inline size_t capacity()  const { return _free_sets.capacity_of(Mutator); }
@@ -222,7 +370,29 @@ public:
     return capacity() - used();
   }
 
+  // Free memory in the Collector set, which serves young GCLABs and shared GC allocations.
+  inline size_t collector_available() const {
+    return _free_sets.capacity_of(Collector) - _free_sets.used_by(Collector);
+  }
+
+  // Free memory in the OldCollector set, which serves PLABs and shared promotions.
+  inline size_t old_collector_available() const {
+    return _free_sets.capacity_of(OldCollector) - _free_sets.used_by(OldCollector);
+  }
+
   HeapWord* allocate(ShenandoahAllocRequest& req, bool& in_new_region);
+
+  // Returns true iff req is a TLAB or GCLAB refill that may be served by an allocation shard.
+  inline bool can_allocate_from_shard(ShenandoahAllocRequest& req) const {
+    return (_num_alloc_shards > 0 &&
+            (req.type() == ShenandoahAllocRequest::_alloc_tlab || req.type() == ShenandoahAllocRequest::_alloc_gclab)) ||
+           is_medium_alloc(req);
+  }
+
+  // Allocate req from the calling thread's allocation shard.  Must be called without holding the heap lock,
+  // which is acquired only if the shard's region cannot satisfy the request.
+  HeapWord* allocate_from_shard(ShenandoahAllocRequest& req, bool& in_new_region);
+
   size_t unsafe_peek_free() const;
 
   double internal_fragmentation();
@@ -230,6 +400,11 @@ public:
 
   void print_on(outputStream* out) const;
 
+  friend class ShenandoahFindRegionsWithAllocCapacityTask;
+  void find_regions_with_alloc_capacity(size_t begin, size_t end, ShenandoahFreeSetsDelta& delta,
+                                        size_t &young_cset_regions, size_t &old_cset_regions,
+                                        size_t &first_old_region, size_t &last_old_region,
+                                        size_t &old_region_count);
   void find_regions_with_alloc_capacity(size_t &young_cset_regions, size_t &old_cset_regions,
                                         size_t &first_old_region, size_t &last_old_region, size_t &old_region_count);
   void reserve_regions(size_t young_reserve, size_t old_reserve);
@@ -60,6 +60,7 @@
 #include "memory/universe.hpp"
 #include "oops/compressedOops.inline.hpp"
 #include "oops/oop.inline.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/orderAccess.hpp"
 #include "runtime/vmThread.hpp"
 #include "utilities/copy.hpp"
@@ -133,6 +134,9 @@ void ShenandoahFullGC::op_full(GCCause::Cause cause) {
 void ShenandoahFullGC::do_it(GCCause::Cause gc_cause) {
   ShenandoahHeap* heap = ShenandoahHeap::heap();
 
+  // Objects move and change generation without concurrent weak root processing.
+  heap->invalidate_settled_weak_roots();
+
   if (heap->mode()->is_generational()) {
     ShenandoahGenerationalFullGC::prepare();
   }
@@ -599,6 +603,49 @@ public:
   }
 };
 
+// Summarizes compaction candidates before slices are distributed: every region gets its live size
+// recorded in the summary, or NotCandidate if it cannot be compacted. Workers claim chunks of regions,
+// and accumulate the live data they saw, so the total comes from a short sum over the workers.
+class ShenandoahCompactionSummaryTask : public WorkerTask {
+private:
+  static const size_t ChunkSize = 256;
+
+  ShenandoahHeap* const _heap;
+  size_t*         const _region_live;
+  size_t*         const _worker_live;
+  volatile size_t       _claimed;
+
+public:
+  static const size_t NotCandidate = SIZE_MAX;
+
+  ShenandoahCompactionSummaryTask(size_t* region_live, size_t* worker_live) :
+    WorkerTask("Shenandoah Compaction Summary"),
+    _heap(ShenandoahHeap::heap()),
+    _region_live(region_live),
+    _worker_live(worker_live),
+    _claimed(0) {}
+
+  void work(uint worker_id) override {
+    size_t n_regions = _heap->num_regions();
+    size_t live = 0;
+    size_t start;
+    while ((start = Atomic::fetch_then_add(&_claimed, ChunkSize)) < n_regions) {
+      size_t end = MIN2(start + ChunkSize, n_regions);
+      for (size_t idx = start; idx < end; idx++) {
+        ShenandoahHeapRegion* r = _heap->get_region(idx);
+        if (ShenandoahPrepareForCompactionTask::is_candidate_region(r)) {
+          size_t region_live = r->get_live_data_words();
+          _region_live[idx] = region_live;
+          live += region_live;
+        } else {
+          _region_live[idx] = NotCandidate;
+        }
+      }
+    }
+    _worker_live[worker_id] = live;
+  }
+};
+
 void ShenandoahFullGC::distribute_slices(ShenandoahHeapRegionSet** worker_slices) {
   ShenandoahHeap* heap = ShenandoahHeap::heap();
 
@@ -635,13 +682,18 @@ void ShenandoahFullGC::distribute_slices(ShenandoahHeapRegionSet** worker_slices
   //
 
   // Compute how much live data is there. This would approximate the size of dense prefix
-  // we target to create.
+  // we target to create. Summarizing the regions is done in parallel, the distribution
+  // below only consults the summary.
+  size_t* region_live = NEW_C_HEAP_ARRAY(size_t, n_regions, mtGC);
+  size_t* live = NEW_C_HEAP_ARRAY(size_t, n_workers, mtGC);
+  {
+    ShenandoahCompactionSummaryTask task(region_live, live);
+    heap->workers()->run_task(&task);
+  }
+
   size_t total_live = 0;
-  for (size_t idx = 0; idx < n_regions; idx++) {
-    ShenandoahHeapRegion *r = heap->get_region(idx);
-    if (ShenandoahPrepareForCompactionTask::is_candidate_region(r)) {
-      total_live += r->get_live_data_words();
-    }
+  for (size_t wid = 0; wid < n_workers; wid++) {
+    total_live += live[wid];
   }
 
   // Estimate the size for the dense prefix. Note that we specifically count only the
@@ -656,8 +708,7 @@ void ShenandoahFullGC::distribute_slices(ShenandoahHeapRegionSet** worker_slices
   // ends up being, we need to account those as well.
   size_t prefix_end = prefix_regions_total;
   for (size_t idx = 0; idx < prefix_regions_total; idx++) {
-    ShenandoahHeapRegion *r = heap->get_region(idx);
-    if (!ShenandoahPrepareForCompactionTask::is_candidate_region(r)) {
+    if (region_live[idx] == ShenandoahCompactionSummaryTask::NotCandidate) {
       prefix_end++;
     }
   }
@@ -668,8 +719,6 @@ void ShenandoahFullGC::distribute_slices(ShenandoahHeapRegionSet** worker_slices
   // subset of dense prefix.
   size_t prefix_idx = 0;
 
-  size_t* live = NEW_C_HEAP_ARRAY(size_t, n_workers, mtGC);
-
   for (size_t wid = 0; wid < n_workers; wid++) {
     ShenandoahHeapRegionSet* slice = worker_slices[wid];
 
@@ -678,10 +727,9 @@ void ShenandoahFullGC::distribute_slices(ShenandoahHeapRegionSet** worker_slices
 
     // Add all prefix regions for this worker
     while (prefix_idx < prefix_end && regs < prefix_regions_per_worker) {
-      ShenandoahHeapRegion *r = heap->get_region(prefix_idx);
-      if (ShenandoahPrepareForCompactionTask::is_candidate_region(r)) {
-        slice->add_region(r);
-        live[wid] += r->get_live_data_words();
+      if (region_live[prefix_idx] != ShenandoahCompactionSummaryTask::NotCandidate) {
+        slice->add_region(heap->get_region(prefix_idx));
+        live[wid] += region_live[prefix_idx];
         regs++;
       }
       prefix_idx++;
@@ -692,12 +740,10 @@ void ShenandoahFullGC::distribute_slices(ShenandoahHeapRegionSet** worker_slices
   size_t wid = n_workers - 1;
 
   for (size_t tail_idx = prefix_end; tail_idx < n_regions; tail_idx++) {
-    ShenandoahHeapRegion *r = heap->get_region(tail_idx);
-    if (ShenandoahPrepareForCompactionTask::is_candidate_region(r)) {
+    size_t live_region = region_live[tail_idx];
+    if (live_region != ShenandoahCompactionSummaryTask::NotCandidate) {
       assert(wid < n_workers, "Sanity");
 
-      size_t live_region = r->get_live_data_words();
-
       // Select next worker that still needs live data.
       size_t old_wid = wid;
       do {
@@ -712,12 +758,13 @@ void ShenandoahFullGC::distribute_slices(ShenandoahHeapRegionSet** worker_slices
         live_per_worker += ShenandoahHeapRegion::region_size_words();
       }
 
-      worker_slices[wid]->add_region(r);
+      worker_slices[wid]->add_region(heap->get_region(tail_idx));
       live[wid] += live_region;
     }
   }
 
   FREE_C_HEAP_ARRAY(size_t, live);
+  FREE_C_HEAP_ARRAY(size_t, region_live);
 
 #ifdef ASSERT
   ResourceBitMap map(n_regions);
@@ -1037,12 +1084,67 @@ public:
   }
 };
 
+// Copies [from, from + words) to [to, to + words) in slices claimed by the workers. The ranges must not overlap.
+class ShenandoahCopyHumongousSlicesTask : public WorkerTask {
+private:
+  static const size_t SliceWords = 128 * K;
+
+  HeapWord* const _from;
+  HeapWord* const _to;
+  const size_t _words;
+  volatile size_t _claimed;
+
+public:
+  ShenandoahCopyHumongousSlicesTask(HeapWord* from, HeapWord* to, size_t words) :
+    WorkerTask("Shenandoah Copy Humongous Slices"),
+    _from(from), _to(to), _words(words), _claimed(0) {
+    assert(to >= from + words || from >= to + words, "ranges must be disjoint");
+  }
+
+  void work(uint worker_id) {
+    ShenandoahParallelWorkerSession worker_session(worker_id);
+    size_t start;
+    while ((start = Atomic::fetch_then_add(&_claimed, SliceWords)) < _words) {
+      size_t len = MIN2(SliceWords, _words - start);
+      Copy::aligned_disjoint_words(_from + start, _to + start, len);
+    }
+  }
+
+  static bool is_worth_it(size_t words) {
+    return words > 2 * SliceWords;
+  }
+};
+
+void ShenandoahFullGC::move_humongous_object(HeapWord* from, HeapWord* to, size_t words) {
+  ShenandoahHeap* heap = ShenandoahHeap::heap();
+  if (!ShenandoahParallelHumongousMoves || heap->workers()->active_workers() == 1 ||
+      !ShenandoahCopyHumongousSlicesTask::is_worth_it(words)) {
+    Copy::aligned_conjoint_words(from, to, words);
+    return;
+  }
+
+  // Humongous objects only slide towards the end of the heap. Copying the object top-down in
+  // chunks no longer than the slide distance makes every chunk disjoint from its destination,
+  // and never overwrites a part of the object that is still to be copied.
+  assert(to > from, "humongous objects slide towards the end");
+  const size_t distance = pointer_delta(to, from);
+  size_t remaining = words;
+  while (remaining > 0) {
+    size_t len = MIN2(distance, remaining);
+    remaining -= len;
+    ShenandoahCopyHumongousSlicesTask task(from + remaining, to + remaining, len);
+    heap->workers()->run_task(&task);
+  }
+}
+
 void ShenandoahFullGC::compact_humongous_objects() {
   // Compact humongous regions, based on their fwdptr objects.
   //
-  // This code is serial, because doing the in-slice parallel sliding is tricky. In most cases,
+  // Objects are moved one at a time, in the order their targets were computed, because the target
+  // of one object may overlap the old location of an object that moves after it. The copy of each
+  // large object is split between the workers, see move_humongous_object(). In most cases,
   // humongous regions are already compacted, and do not require further moves, which alleviates
-  // sliding costs. We may consider doing this in parallel in the future.
+  // sliding costs.
 
   ShenandoahHeap* heap = ShenandoahHeap::heap();
 
@@ -1065,7 +1167,7 @@ void ShenandoahFullGC::compact_humongous_objects() {
       assert(r->is_stw_move_allowed(), "Region " SIZE_FORMAT " should be movable", r->index());
 
       log_debug(gc)("Full GC compaction moves humongous object from region " SIZE_FORMAT " to region " SIZE_FORMAT, old_start, new_start);
-      Copy::aligned_conjoint_words(r->bottom(), heap->get_region(new_start)->bottom(), words_size);
+      move_humongous_object(r->bottom(), heap->get_region(new_start)->bottom(), words_size);
       ContinuationGCSupport::relativize_stack_chunk(cast_to_oop<HeapWord*>(r->bottom()));
 
       oop new_obj = cast_to_oop(heap->get_region(new_start)->bottom());
@@ -1153,6 +1255,46 @@ void ShenandoahFullGC::phase4_compact_objects(ShenandoahHeapRegionSet** worker_s
   }
 }
 
+// Every worker restores the marks it preserved itself first: it allocated the stack segments and
+// prepared the objects, so both are likely local to it. Then it helps with the remaining stacks.
+class ShenandoahRestorePreservedMarksTask : public WorkerTask {
+private:
+  PreservedMarksSet* const _preserved_marks;
+  volatile uint* const     _claimed;
+
+  bool try_claim(uint i) {
+    return Atomic::load(&_claimed[i]) == 0 && Atomic::cmpxchg(&_claimed[i], 0u, 1u) == 0;
+  }
+
+public:
+  ShenandoahRestorePreservedMarksTask(PreservedMarksSet* preserved_marks) :
+    WorkerTask("Shenandoah Restore Preserved Marks"),
+    _preserved_marks(preserved_marks),
+    _claimed(NEW_C_HEAP_ARRAY(volatile uint, preserved_marks->num(), mtGC)) {
+    for (uint i = 0; i < _preserved_marks->num(); i++) {
+      _claimed[i] = 0;
+    }
+  }
+
+  ~ShenandoahRestorePreservedMarksTask() {
+    FREE_C_HEAP_ARRAY(volatile uint, _claimed);
+  }
+
+  void work(uint worker_id) {
+    ShenandoahParallelWorkerSession worker_session(worker_id);
+    const uint num = _preserved_marks->num();
+    if (worker_id < num && try_claim(worker_id)) {
+      _preserved_marks->get(worker_id)->restore();
+    }
+    for (uint c = 1; c <= num; c++) {
+      uint i = (worker_id + c) % num;
+      if (try_claim(i)) {
+        _preserved_marks->get(i)->restore();
+      }
+    }
+  }
+};
+
 void ShenandoahFullGC::phase5_epilog() {
   GCTraceTime(Info, gc, phases) time("Phase 5: Full GC epilog", _gc_timer);
   ShenandoahHeap* heap = ShenandoahHeap::heap();
@@ -1199,7 +1341,11 @@ void ShenandoahFullGC::phase5_epilog() {
     heap->clear_cancelled_gc(true /* clear oom handler */);
   }
 
-  _preserved_marks->restore(heap->workers());
+  {
+    ShenandoahGCPhase phase(ShenandoahPhaseTimings::full_gc_restore_marks);
+    ShenandoahRestorePreservedMarksTask task(_preserved_marks);
+    heap->workers()->run_task(&task);
+  }
   _preserved_marks->reclaim();
 
   // We defer generation resizing actions until after cset regions have been recycled.  We do this even following an
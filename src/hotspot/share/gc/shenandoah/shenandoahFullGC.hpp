@@ -86,6 +86,7 @@ private:
   void distribute_slices(ShenandoahHeapRegionSet** worker_slices);
   void calculate_target_humongous_objects();
   void compact_humongous_objects();
+  void move_humongous_object(HeapWord* from, HeapWord* to, size_t words);
 };
 
 #endif // SHARE_GC_SHENANDOAH_SHENANDOAHFULLGC_HPP
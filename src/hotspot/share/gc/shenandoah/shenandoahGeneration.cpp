@@ -28,6 +28,7 @@
 #include "gc/shenandoah/shenandoahFreeSet.hpp"
 #include "gc/shenandoah/shenandoahGeneration.hpp"
 #include "gc/shenandoah/shenandoahGenerationalHeap.hpp"
+#include "gc/shenandoah/shenandoahHeuristicsTrace.hpp"
 #include "gc/shenandoah/shenandoahMarkClosures.hpp"
 #include "gc/shenandoah/shenandoahMonitoringSupport.hpp"
 #include "gc/shenandoah/shenandoahOldGeneration.hpp"
@@ -55,6 +56,7 @@ class ShenandoahResetUpdateRegionStateClosure : public ShenandoahHeapRegionClosu
     if (_heap->is_bitmap_slice_committed(r)) {
       _ctx->clear_bitmap(r);
     }
+    r->clear_ref_summary();
 
     if (r->is_active()) {
       // Reset live data and set TAMS optimistically. We would recheck these under the pause
@@ -117,6 +119,19 @@ class ShenandoahCopyWriteCardTableToRead: public ShenandoahHeapRegionClosure {
   bool is_thread_safe() override { return true; }
 };
 
+class ShenandoahCleanReadCardTable: public ShenandoahHeapRegionClosure {
+ private:
+  RememberedScanner* _scanner;
+ public:
+  ShenandoahCleanReadCardTable(RememberedScanner* scanner) : _scanner(scanner) {}
+
+  void heap_region_do(ShenandoahHeapRegion* region) override {
+    _scanner->clean_read_table(region->bottom(), ShenandoahHeapRegion::region_size_words());
+  }
+
+  bool is_thread_safe() override { return true; }
+};
+
 void ShenandoahGeneration::confirm_heuristics_mode() {
   if (_heuristics->is_diagnostic() && !UnlockDiagnosticVMOptions) {
     vm_exit_during_initialization(
@@ -197,20 +212,43 @@ void ShenandoahGeneration::reset_mark_bitmap() {
   parallel_heap_region_iterate(&task);
 }
 
-// The ideal is to swap the remembered set so the safepoint effort is no more than a few pointer manipulations.
-// However, limitations in the implementation of the mutator write-barrier make it difficult to simply change the
-// location of the card table.  So the interim implementation of swap_remembered_set will copy the write-table
-// onto the read-table and will then clear the write-table.
+// Mutator card-marking barriers load the write table base from their thread-local data, so the remembered
+// set is swapped with a few pointer manipulations. The read table that becomes the new write table has
+// normally been cleaned during concurrent reset. With ShenandoahSwapCardTables disabled, the write-table
+// is copied onto the read-table and then cleared instead.
 void ShenandoahGeneration::swap_remembered_set() {
   // Must be sure that marking is complete before we swap remembered set.
   ShenandoahGenerationalHeap* heap = ShenandoahGenerationalHeap::heap();
   heap->assert_gc_workers(heap->workers()->active_workers());
   shenandoah_assert_safepoint();
 
-  // TODO: Eventually, we want to replace this with a constant-time exchange of pointers.
   ShenandoahOldGeneration* old_generation = heap->old_generation();
-  ShenandoahCopyWriteCardTableToRead task(old_generation->card_scan());
-  old_generation->parallel_heap_region_iterate(&task);
+  RememberedScanner* scanner = old_generation->card_scan();
+  if (ShenandoahSwapCardTables) {
+    if (!scanner->is_read_table_clean()) {
+      // Concurrent reset did not run for this cycle (e.g. we degenerated from outside the cycle).
+      clean_read_card_table();
+    }
+    scanner->swap_remset();
+  } else {
+    ShenandoahCopyWriteCardTableToRead task(scanner);
+    old_generation->parallel_heap_region_iterate(&task);
+    scanner->set_read_table_clean(false);
+  }
+}
+
+void ShenandoahGeneration::clean_read_card_table() {
+  ShenandoahGenerationalHeap* heap = ShenandoahGenerationalHeap::heap();
+  RememberedScanner* scanner = heap->old_generation()->card_scan();
+  if (scanner->is_read_table_clean()) {
+    return;
+  }
+
+  // Every region is cleaned, not just old ones: any young region may be old by the time its cards
+  // are written through the new write table.
+  ShenandoahCleanReadCardTable task(scanner);
+  heap->parallel_heap_region_iterate(&task);
+  scanner->set_read_table_clean(true);
 }
 
 // Copy the write-version of the card-table into the read-version, clearing the
@@ -225,6 +263,7 @@ void ShenandoahGeneration::merge_write_table() {
   ShenandoahOldGeneration* old_generation = heap->old_generation();
   ShenandoahMergeWriteTable task(old_generation->card_scan());
   old_generation->parallel_heap_region_iterate(&task);
+  old_generation->card_scan()->set_read_table_clean(false);
 }
 
 void ShenandoahGeneration::prepare_gc() {
@@ -654,10 +693,16 @@ void ShenandoahGeneration::prepare_regions_and_collection_set(bool concurrent) {
 
   assert(!heap->is_full_gc_in_progress(), "Only for concurrent and degenerated GC");
   assert(!is_old(), "Only YOUNG and GLOBAL GC perform evacuations");
+
+  // Objects above TAMS weren't included in the age census. Since they were all
+  // allocated in this cycle they belong in the age 0 cohort. The workers that
+  // update the region states sum the volume of objects between TAMS and top
+  // in young regions.
+  const bool age0_census = is_generational && ShenandoahGenerationalAdaptiveTenuring && !ShenandoahGenerationalCensusAtEvac;
+  ShenandoahFinalMarkUpdateRegionStateClosure cl(complete_marking_context(), age0_census);
   {
     ShenandoahGCPhase phase(concurrent ? ShenandoahPhaseTimings::final_update_region_states :
                             ShenandoahPhaseTimings::degen_gc_final_update_region_states);
-    ShenandoahFinalMarkUpdateRegionStateClosure cl(complete_marking_context());
     parallel_heap_region_iterate(&cl);
 
     if (is_young()) {
@@ -671,25 +716,21 @@ void ShenandoahGeneration::prepare_regions_and_collection_set(bool concurrent) {
   }
 
   // Tally the census counts and compute the adaptive tenuring threshold
-  if (is_generational && ShenandoahGenerationalAdaptiveTenuring && !ShenandoahGenerationalCensusAtEvac) {
-    // Objects above TAMS weren't included in the age census. Since they were all
-    // allocated in this cycle they belong in the age 0 cohort. We walk over all
-    // young regions and sum the volume of objects between TAMS and top.
-    ShenandoahUpdateCensusZeroCohortClosure age0_cl(complete_marking_context());
-    heap->young_generation()->heap_region_iterate(&age0_cl);
-    size_t age0_pop = age0_cl.get_age0_population();
+  if (age0_census) {
+    size_t age0_pop = cl.get_age0_population();
 
     // Update the global census, including the missed age 0 cohort above,
     // along with the census done during marking, and compute the tenuring threshold.
     ShenandoahAgeCensus* census = ShenandoahGenerationalHeap::heap()->age_census();
     census->update_census(age0_pop);
 #ifndef PRODUCT
-    size_t total_pop = age0_cl.get_total_population();
+    size_t total_pop = cl.get_total_population();
     size_t total_census = census->get_total();
     // Usually total_pop > total_census, but not by too much.
     // We use integer division so anything up to just less than 2 is considered
     // reasonable, and the "+1" is to avoid divide-by-zero.
-    assert((total_pop+1)/(total_census+1) ==  1, "Extreme divergence: "
+    // A sampling census is only an estimate, so the check does not apply to it.
+    assert(ShenandoahGenerationalCensusSampleRate > 1 || (total_pop+1)/(total_census+1) ==  1, "Extreme divergence: "
            SIZE_FORMAT "/" SIZE_FORMAT, total_pop, total_census);
 #endif
   }
@@ -741,6 +782,7 @@ void ShenandoahGeneration::prepare_regions_and_collection_set(bool concurrent) {
     } else {
       _heuristics->choose_collection_set(collection_set);
     }
+    ShenandoahHeuristicsTrace::record_collection_set(this, collection_set);
   }
 
 
@@ -797,6 +839,7 @@ void ShenandoahGeneration::cancel_marking() {
     set_mark_incomplete();
   }
   _task_queues->clear();
+  _task_queues->release_overflow_segments();
   ref_processor()->abandon_partial_discovery();
   set_concurrent_mark_in_progress(false);
 }
@@ -806,7 +849,7 @@ ShenandoahGeneration::ShenandoahGeneration(ShenandoahGenerationType type,
                                            size_t max_capacity,
                                            size_t soft_max_capacity) :
   _type(type),
-  _task_queues(new ShenandoahObjToScanQueueSet(max_workers)),
+  _task_queues(new ShenandoahObjToScanQueueSet(max_workers, ShenandoahHeap::heap()->mark_assist_queues())),
   _ref_processor(new ShenandoahReferenceProcessor(MAX2(max_workers, 1U))),
   _affiliated_region_count(0), _humongous_waste(0), _evacuation_reserve(0),
   _used(0), _bytes_allocated_since_gc_start(0),
@@ -815,7 +858,7 @@ ShenandoahGeneration::ShenandoahGeneration(ShenandoahGenerationType type,
 {
   _is_marking_complete.set();
   assert(max_workers > 0, "At least one queue");
-  for (uint i = 0; i < max_workers; ++i) {
+  for (uint i = 0; i < _task_queues->size(); ++i) {
     ShenandoahObjToScanQueue* task_queue = new ShenandoahObjToScanQueue();
     _task_queues->register_queue(i, task_queue);
   }
@@ -847,11 +890,15 @@ void ShenandoahGeneration::scan_remembered_set(bool is_concurrent) {
   ShenandoahReferenceProcessor* rp = ref_processor();
   ShenandoahRegionChunkIterator work_list(nworkers);
   ShenandoahScanRememberedTask task(task_queues(), old_gen_task_queues(), rp, &work_list, is_concurrent);
+  RememberedScanner* scanner = heap->old_generation()->card_scan();
+  assert(scanner != nullptr, "Not generational");
+  scanner->clear_scan_totals();
   heap->assert_gc_workers(nworkers);
   heap->workers()->run_task(&task);
+  // Clusters left unvisited by a cancelled scan keep their conservative summary bits.
+  scanner->set_summary_fresh();
+  scanner->report_scan_totals(nworkers, CARD_STAT_SCAN_RS);
   if (ShenandoahEnableCardStats) {
-    RememberedScanner* scanner = heap->old_generation()->card_scan();
-    assert(scanner != nullptr, "Not generational");
     scanner->log_card_stats(nworkers, CARD_STAT_SCAN_RS);
   }
 }
@@ -160,6 +160,10 @@ private:
   // Used by concurrent and degenerated GC to reset remembered set.
   void swap_remembered_set();
 
+  // Clean the read card table in parallel, so that the next swap_remembered_set() can simply exchange
+  // the tables. Used by concurrent reset, and by swap_remembered_set() if the table was not cleaned.
+  void clean_read_card_table();
+
   // Update the read cards with the state of the write table (write table is not cleared).
   void merge_write_table();
 
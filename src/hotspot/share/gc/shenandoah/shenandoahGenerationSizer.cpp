@@ -26,6 +26,7 @@
 
 #include "gc/shenandoah/shenandoahGeneration.hpp"
 #include "gc/shenandoah/shenandoahGenerationSizer.hpp"
+#include "gc/shenandoah/shenandoahGenerationalHeap.hpp"
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahHeapRegion.hpp"
 #include "gc/shenandoah/shenandoahOldGeneration.hpp"
@@ -33,6 +34,7 @@
 #include "gc/shared/gc_globals.hpp"
 #include "logging/log.hpp"
 #include "runtime/globals_extension.hpp"
+#include "utilities/align.hpp"
 
 
 ShenandoahGenerationSizer::ShenandoahGenerationSizer()
@@ -200,6 +202,29 @@ bool ShenandoahGenerationSizer::transfer_to_young(size_t regions) const {
   return transfer_regions(heap->old_generation(), heap->young_generation(), regions);
 }
 
+size_t ShenandoahGenerationSizer::cost_model_young_size() const {
+  ShenandoahGenerationalHeap* heap = ShenandoahGenerationalHeap::heap();
+  const ShenandoahMmuTracker* mmu = heap->mmu_tracker();
+  const double young_cost = mmu->young_cycle_cost();
+  if (young_cost <= 0.0) {
+    return max_young_size();
+  }
+
+  ShenandoahOldGeneration* old_gen = heap->old_generation();
+  const size_t heap_size = heap->young_generation()->max_capacity() + old_gen->max_capacity();
+  size_t old_live = old_gen->get_live_bytes_after_last_mark();
+  if (old_live == 0) {
+    old_live = old_gen->used();
+  }
+  if (old_live >= heap_size) {
+    return min_young_size();
+  }
+
+  const double ratio = sqrt(MAX2(mmu->old_cycle_cost() * mmu->old_growth_rate(), 0.0) / young_cost);
+  const size_t young_size = (size_t) ((heap_size - old_live) / (1.0 + ratio));
+  return clamp(align_down(young_size, ShenandoahHeapRegion::region_size_bytes()), min_young_size(), max_young_size());
+}
+
 size_t ShenandoahGenerationSizer::min_young_size() const {
   return min_young_regions() * ShenandoahHeapRegion::region_size_bytes();
 }
@@ -82,6 +82,14 @@ public:
     return _max_desired_young_regions;
   }
 
+  // Young generation size in bytes that minimizes the GC CPU time per allocated byte, as
+  // modeled from the costs recorded by the MMU tracker. With young size Y, old live data L
+  // and heap size H, young cycles cost Cy every Y allocated bytes. Old collections cost Co
+  // each time the old generation has grown into its free space H - Y - L, growing by a
+  // fraction s of every allocated byte. Cy/Y + Co*s/(H - Y - L) is smallest for
+  // Y = (H - L) / (1 + sqrt(Co*s/Cy)). The result is within the configured young bounds.
+  size_t cost_model_young_size() const;
+
   // True if transfer succeeds, else false. See transfer_regions.
   bool transfer_to_young(size_t regions) const;
   bool transfer_to_old(size_t regions) const;
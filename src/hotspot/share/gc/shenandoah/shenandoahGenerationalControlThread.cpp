@@ -29,6 +29,7 @@
 #include "gc/shenandoah/shenandoahAsserts.hpp"
 #include "gc/shenandoah/shenandoahCollectorPolicy.hpp"
 #include "gc/shenandoah/shenandoahConcurrentGC.hpp"
+#include "gc/shenandoah/shenandoahCycleHistory.hpp"
 #include "gc/shenandoah/shenandoahGenerationalControlThread.hpp"
 #include "gc/shenandoah/shenandoahDegeneratedGC.hpp"
 #include "gc/shenandoah/shenandoahFreeSet.hpp"
@@ -39,7 +40,9 @@
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahMonitoringSupport.hpp"
 #include "gc/shenandoah/shenandoahPacer.inline.hpp"
+#include "gc/shenandoah/shenandoahPretenureTable.hpp"
 #include "gc/shenandoah/shenandoahUtils.hpp"
+#include "gc/shenandoah/shenandoahWorkerPolicy.hpp"
 #include "gc/shenandoah/shenandoahYoungGeneration.hpp"
 #include "logging/log.hpp"
 #include "memory/metaspaceUtils.hpp"
@@ -303,6 +306,9 @@ void ShenandoahGenerationalControlThread::run_service() {
       // Print Metaspace change following GC (if logging is enabled).
       MetaspaceUtils::print_metaspace_change(meta_sizes);
 
+      // Pick the soft max heap size for the next cycles, to be applied on the next iteration
+      heap->soft_max_controller()->adjust(heap);
+
       // GC is over, we are at idle now
       if (ShenandoahPacing) {
         heap->pacer()->setup_for_idle();
@@ -334,6 +340,16 @@ void ShenandoahGenerationalControlThread::run_service() {
       last_shrink_time = current;
     }
 
+    // Commit regions ahead of the allocators, so that they do not take the page faults after an uncommit.
+    if (ShenandoahPrecommitRegions > 0 && !is_alloc_failure_gc()) {
+      heap->free_set()->maintain_committed_regions(ShenandoahPrecommitRegions);
+    }
+
+    // Replenish the pool of zeroed regions while there is no allocation failure to handle.
+    if (ShenandoahZeroedRegionPool > 0 && !is_alloc_failure_gc()) {
+      heap->free_set()->maintain_zeroed_regions(ShenandoahZeroedRegionPool);
+    }
+
     // Wait for ShenandoahControlIntervalMax unless there was an allocation failure or another request was made mid-cycle.
     if (!is_alloc_failure_gc() && _requested_gc_cause == GCCause::_no_gc) {
       // The timed wait is necessary because this thread has a responsibility to send
@@ -359,6 +375,11 @@ void ShenandoahGenerationalControlThread::process_phase_timings(const Shenandoah
   ShenandoahEvacuationTracker* evac_tracker = heap->evac_tracker();
   ShenandoahCycleStats         evac_stats   = evac_tracker->flush_cycle_to_global();
 
+  ShenandoahPretenureTable* pretenure_table = ShenandoahGenerationalHeap::heap()->pretenure_table();
+  if (pretenure_table != nullptr) {
+    pretenure_table->update();
+  }
+
   // Print GC stats for current cycle
   {
     LogTarget(Info, gc, stats) lt;
@@ -368,12 +389,17 @@ void ShenandoahGenerationalControlThread::process_phase_timings(const Shenandoah
       heap->phase_timings()->print_cycle_on(&ls);
       evac_tracker->print_evacuations_on(&ls, &evac_stats.workers,
                                               &evac_stats.mutators);
+      evac_tracker->print_cycle_klasses_on(&ls);
       if (ShenandoahPacing) {
         heap->pacer()->print_cycle_on(&ls);
       }
     }
   }
 
+  // Learn per-worker throughput from the phases of this cycle
+  ShenandoahWorkerPolicy::record_cycle(heap->phase_timings());
+  heap->cycle_history()->record_cycle(heap->phase_timings());
+
   // Commit statistics to globals
   heap->phase_timings()->flush_cycle_to_global();
 }
@@ -497,8 +523,9 @@ void ShenandoahGenerationalControlThread::service_concurrent_old_cycle(Shenandoa
       bool marking_complete = resume_concurrent_old_cycle(old_generation, cause);
       if (marking_complete) {
         assert(old_generation->state() != ShenandoahOldGeneration::MARKING, "Should not still be marking");
+        // Also when marking was never interrupted, this completes the cost of the old collection.
+        heap->mmu_tracker()->record_old_marking_increment(true);
         if (original_state == ShenandoahOldGeneration::MARKING) {
-          heap->mmu_tracker()->record_old_marking_increment(true);
           heap->log_heap_status("At end of Concurrent Old Marking finishing increment");
         }
       } else if (original_state == ShenandoahOldGeneration::MARKING) {
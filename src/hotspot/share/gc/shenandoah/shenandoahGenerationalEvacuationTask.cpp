@@ -31,9 +31,11 @@
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahOldGeneration.hpp"
 #include "gc/shenandoah/shenandoahPacer.hpp"
+#include "gc/shenandoah/shenandoahParallelEvacuation.hpp"
 #include "gc/shenandoah/shenandoahScanRemembered.inline.hpp"
 #include "gc/shenandoah/shenandoahYoungGeneration.hpp"
 #include "gc/shenandoah/shenandoahUtils.hpp"
+#include "memory/resourceArea.hpp"
 
 class ShenandoahConcurrentEvacuator : public ObjectClosure {
 private:
@@ -81,6 +83,12 @@ void ShenandoahGenerationalEvacuationTask::do_work() {
   ShenandoahConcurrentEvacuator cl(_heap);
   ShenandoahHeapRegion* r;
 
+  // Regions promoted in place are handed over to the old generation in batches, so that long runs of
+  // densely live, aged regions do not take the heap lock once per region.
+  ResourceMark rm;
+  ShenandoahHeapRegion** const promoted = NEW_RESOURCE_ARRAY(ShenandoahHeapRegion*, ShenandoahPromoteInPlaceBatch);
+  size_t promoted_count = 0;
+
   while ((r = _regions->next()) != nullptr) {
     log_debug(gc)("GenerationalEvacuationTask do_work(), looking at %s region " SIZE_FORMAT ", (age: %d) [%s, %s, %s]",
             r->is_old()? "old": r->is_young()? "young": "free", r->index(), r->age(),
@@ -99,11 +107,18 @@ void ShenandoahGenerationalEvacuationTask::do_work() {
         // We promote humongous_start regions along with their affiliated continuations during evacuation rather than
         // doing this work during a safepoint.  We cannot put humongous regions into the collection set because that
         // triggers the load-reference barrier (LRB) to copy on reference fetch.
-        promote_humongous(r);
+        if (_heap->should_promote_humongous(r)) {
+          promote_humongous(r);
+        }
       } else if (r->is_regular() && (r->get_top_before_promote() != nullptr)) {
         // Likewise, we cannot put promote-in-place regions into the collection set because that would also trigger
         // the LRB to copy on reference fetch.
         promote_in_place(r);
+        promoted[promoted_count++] = r;
+        if (promoted_count == ShenandoahPromoteInPlaceBatch) {
+          transfer_promoted_in_place(promoted, promoted_count);
+          promoted_count = 0;
+        }
       }
       // Aged humongous continuation regions are handled with their start region.  If an aged regular region has
       // more garbage than ShenandoahOldGarbageThreshold, we'll promote by evacuation.  If there is room for evacuation
@@ -115,10 +130,14 @@ void ShenandoahGenerationalEvacuationTask::do_work() {
     }
     // else, region is free, or OLD, or not in collection set, or humongous_continuation,
     // or is young humongous_start that is too young to be promoted
+    if (_heap->split_copier() != nullptr) {
+      _heap->split_copier()->help();
+    }
     if (_heap->check_cancelled_gc_and_yield(_concurrent)) {
       break;
     }
   }
+  transfer_promoted_in_place(promoted, promoted_count);
 }
 
 // When we promote a region in place, we can continue to use the established marking context to guide subsequent remembered
@@ -141,7 +160,6 @@ void ShenandoahGenerationalEvacuationTask::promote_in_place(ShenandoahHeapRegion
   }
 
   ShenandoahOldGeneration* const old_gen = _heap->old_generation();
-  ShenandoahYoungGeneration* const young_gen = _heap->young_generation();
 
   // Rebuild the remembered set information and mark the entire range as DIRTY.  We do NOT scan the content of this
   // range to determine which cards need to be DIRTY.  That would force us to scan the region twice, once now, and
@@ -176,41 +194,53 @@ void ShenandoahGenerationalEvacuationTask::promote_in_place(ShenandoahHeapRegion
   // We do not need to scan above TAMS because restored top equals tams
   assert(obj_addr == tams, "Expect loop to terminate when obj_addr equals tams");
 
+  // The region stays young, with its remnant filled, until transfer_promoted_in_place() hands it to old.
+}
 
-  {
-    ShenandoahHeapLocker locker(_heap->lock());
+void ShenandoahGenerationalEvacuationTask::transfer_promoted_in_place(ShenandoahHeapRegion** regions, size_t count) {
+  if (count == 0) {
+    return;
+  }
+
+  ShenandoahOldGeneration* const old_gen = _heap->old_generation();
+  ShenandoahYoungGeneration* const young_gen = _heap->young_generation();
+
+  ShenandoahHeapLocker locker(_heap->lock());
 
+  // Unconditionally transfer one region from young to old for each newly promoted region. This expands old and
+  // shrinks new by the size of these regions.  Strictly, we do not "need" to expand old if there are already
+  // enough unaffiliated regions in old to account for the newly promoted regions. However, if we do not transfer
+  // the capacities, we end up reducing the amount of memory that would have otherwise been available to hold old
+  // evacuations, because old available is max_capacity - used and now we would be trading fully empty regions for
+  // partially used regions.
+  //
+  // transfer_to_old() increases capacity of old and decreases capacity of young
+  _heap->generation_sizer()->force_transfer_to_old(count);
+
+  size_t promoted_used = 0;
+  for (size_t i = 0; i < count; i++) {
+    ShenandoahHeapRegion* const region = regions[i];
     HeapWord* update_watermark = region->get_update_watermark();
 
     // Now that this region is affiliated with old, we can allow it to receive allocations, though it may not be in the
     // is_collector_free range.
     region->restore_top_before_promote();
 
-    size_t region_used = region->used();
+    promoted_used += region->used();
 
     // The update_watermark was likely established while we had the artificially high value of top.  Make it sane now.
     assert(update_watermark >= region->top(), "original top cannot exceed preserved update_watermark");
     region->set_update_watermark(region->top());
-
-    // Unconditionally transfer one region from young to old. This represents the newly promoted region.
-    // This expands old and shrinks new by the size of one region.  Strictly, we do not "need" to expand old
-    // if there are already enough unaffiliated regions in old to account for this newly promoted region.
-    // However, if we do not transfer the capacities, we end up reducing the amount of memory that would have
-    // otherwise been available to hold old evacuations, because old available is max_capacity - used and now
-    // we would be trading a fully empty region for a partially used region.
-    young_gen->decrease_used(region_used);
-    young_gen->decrement_affiliated_region_count();
-
-    // transfer_to_old() increases capacity of old and decreases capacity of young
-    _heap->generation_sizer()->force_transfer_to_old(1);
     region->set_affiliation(OLD_GENERATION);
 
-    old_gen->increment_affiliated_region_count();
-    old_gen->increase_used(region_used);
-
     // add_old_collector_free_region() increases promoted_reserve() if available space exceeds plab_min_size()
     _heap->free_set()->add_old_collector_free_region(region);
   }
+
+  young_gen->decrease_used(promoted_used);
+  young_gen->decrease_affiliated_region_count(count);
+  old_gen->increase_affiliated_region_count(count);
+  old_gen->increase_used(promoted_used);
 }
 
 void ShenandoahGenerationalEvacuationTask::promote_humongous(ShenandoahHeapRegion* region) {
@@ -222,12 +252,10 @@ void ShenandoahGenerationalEvacuationTask::promote_humongous(ShenandoahHeapRegio
   assert(region->age() >= _tenuring_threshold, "Only promote regions that are sufficiently aged");
   assert(marking_context->is_marked(obj), "promoted humongous object should be alive");
 
-  // TODO: Consider not promoting humongous objects that represent primitive arrays.  Leaving a primitive array
-  // (obj->is_typeArray()) in young-gen is harmless because these objects are never relocated and they are not
-  // scanned.  Leaving primitive arrays in young-gen memory allows their memory to be reclaimed more quickly when
-  // it becomes garbage.  Better to not make this change until sizes of young-gen and old-gen are completely
-  // adaptive, as leaving primitive arrays in young-gen might be perceived as an "astonishing result" by someone
-  // has carefully analyzed the required sizes of an application's young-gen and old-gen.
+  // Primitive arrays may be left in young-gen with ShenandoahPromoteHumongousPrimitiveArrays.  That is harmless
+  // because these objects are never relocated and they are not scanned, and it allows their memory to be reclaimed
+  // more quickly when it becomes garbage.  It is not the default, because it might be perceived as an "astonishing
+  // result" by someone who has carefully analyzed the required sizes of an application's young-gen and old-gen.
   const size_t used_bytes = obj->size() * HeapWordSize;
   const size_t spanned_regions = ShenandoahHeapRegion::required_regions(used_bytes);
   const size_t humongous_waste = spanned_regions * ShenandoahHeapRegion::region_size_bytes() - obj->size() * HeapWordSize;
@@ -49,6 +49,7 @@ private:
   void do_work();
 
   void promote_in_place(ShenandoahHeapRegion* region);
+  void transfer_promoted_in_place(ShenandoahHeapRegion** regions, size_t count);
   void promote_humongous(ShenandoahHeapRegion* region);
 };
 
@@ -91,6 +91,7 @@ void ShenandoahGenerationalFullGC::rebuild_remembered_set(ShenandoahHeap* heap)
   ShenandoahRegionIterator regions;
   ShenandoahReconstructRememberedSetTask task(&regions);
   heap->workers()->run_task(&task);
+  heap->old_generation()->card_scan()->set_read_table_clean(false);
 
   // Rebuilding the remembered set recomputes all the card offsets for objects.
   // The adjust pointers phase coalesces and fills all necessary regions. In case
@@ -38,6 +38,7 @@
 #include "gc/shenandoah/shenandoahOldGeneration.hpp"
 #include "gc/shenandoah/shenandoahOopClosures.inline.hpp"
 #include "gc/shenandoah/shenandoahPhaseTimings.hpp"
+#include "gc/shenandoah/shenandoahPretenureTable.hpp"
 #include "gc/shenandoah/shenandoahRegulatorThread.hpp"
 #include "gc/shenandoah/shenandoahScanRemembered.inline.hpp"
 #include "gc/shenandoah/shenandoahWorkerPolicy.hpp"
@@ -106,8 +107,10 @@ size_t ShenandoahGenerationalHeap::unsafe_max_tlab_alloc(Thread *thread) const {
 ShenandoahGenerationalHeap::ShenandoahGenerationalHeap(ShenandoahCollectorPolicy* policy) :
   ShenandoahHeap(policy),
   _age_census(nullptr),
+  _pretenure_table(nullptr),
   _min_plab_size(calculate_min_plab()),
   _max_plab_size(calculate_max_plab()),
+  _update_refs_chunks(nullptr),
   _regulator_thread(nullptr),
   _young_gen_memory_pool(nullptr),
   _old_gen_memory_pool(nullptr) {
@@ -118,6 +121,10 @@ ShenandoahGenerationalHeap::ShenandoahGenerationalHeap(ShenandoahCollectorPolicy
 void ShenandoahGenerationalHeap::post_initialize() {
   ShenandoahHeap::post_initialize();
   _age_census = new ShenandoahAgeCensus();
+  if (ShenandoahPretenureSampleRate > 0) {
+    _pretenure_table = new ShenandoahPretenureTable();
+  }
+  _update_refs_chunks = new ShenandoahRegionChunkIterator(this, max_workers());
 }
 
 void ShenandoahGenerationalHeap::print_init_logger() const {
@@ -205,12 +212,28 @@ oop ShenandoahGenerationalHeap::evacuate_object(oop p, Thread* thread) {
     if (mark.has_displaced_mark_helper()) {
       // We don't want to deal with MT here just to ensure we read the right mark word.
       // Skip the potential promotion attempt for this one.
-    } else if (r->age() + mark.age() >= age_census()->tenuring_threshold()) {
-      oop result = try_evacuate_object(p, thread, r, OLD_GENERATION);
-      if (result != nullptr) {
-        return result;
+    } else {
+      bool tenured = r->age() + mark.age() >= age_census()->tenuring_threshold();
+      ShenandoahPretenureTable* table = _pretenure_table;
+      if (table != nullptr) {
+        if (ShenandoahPretenureTable::is_sample(p)) {
+          // Samples always take the age-based path, so that they measure the survival of their class.
+          if (tenured) {
+            table->record_tenured(p->klass(), p->size() * HeapWordSize);
+          } else if (mark.age() == 0) {
+            table->record_first_survival(p->klass(), p->size() * HeapWordSize);
+          }
+        } else if (!tenured && table->should_pretenure(p->klass())) {
+          tenured = true;
+        }
+      }
+      if (tenured) {
+        oop result = try_evacuate_object(p, thread, r, OLD_GENERATION);
+        if (result != nullptr) {
+          return result;
+        }
+        // If we failed to promote this aged object, we'll fall through to code below and evacuate to young-gen.
       }
-      // If we failed to promote this aged object, we'll fall through to code below and evacuate to young-gen.
     }
   }
   return try_evacuate_object(p, thread, r, target_gen);
@@ -319,7 +342,7 @@ oop ShenandoahGenerationalHeap::try_evacuate_object(oop p, Thread* thread, Shena
 
   // Copy the object:
   evac_tracker()->begin_evacuation(thread, size * HeapWordSize);
-  Copy::aligned_disjoint_words(cast_from_oop<HeapWord*>(p), copy, size);
+  copy_for_evacuation(thread, cast_from_oop<HeapWord*>(p), copy, size);
 
   oop copy_val = cast_to_oop(copy);
 
@@ -334,6 +357,10 @@ oop ShenandoahGenerationalHeap::try_evacuate_object(oop p, Thread* thread, Shena
   if (result == copy_val) {
     // Successfully evacuated. Our copy is now the public one!
     evac_tracker()->end_evacuation(thread, size * HeapWordSize);
+    if (ShenandoahEvacuationKlassSampleRate > 0) {
+      evac_tracker()->record_klass(thread, copy_val->klass(), size * HeapWordSize,
+                                   target_gen == OLD_GENERATION && from_region->is_young());
+    }
     if (target_gen == OLD_GENERATION) {
       old_generation()->handle_evacuation(copy, size, from_region->is_young());
     } else {
@@ -492,6 +519,8 @@ HeapWord* ShenandoahGenerationalHeap::allocate_from_plab_slow(Thread* thread, si
     }
     assert(is_aligned(actual_size, CardTable::card_size_in_words()), "Align by design");
     plab->set_buf(plab_buf, actual_size);
+    ShenandoahThreadLocalData::add_to_plab_allocated(thread, actual_size);
+    evac_tracker()->record_plab_refill(thread);
     if (is_promotion && !ShenandoahThreadLocalData::allow_plab_promotions(thread)) {
       return nullptr;
     }
@@ -550,6 +579,11 @@ void ShenandoahGenerationalHeap::retire_plab(PLAB* plab, Thread* thread) {
   // plab->retire() overwrites unused memory between plab->top() and plab->hard_end() with a dummy object to make memory parsable.
   // It adds the size of this unused memory, in words, to plab->waste().
   plab->retire();
+  if (plab->waste() > original_waste) {
+    const size_t remnant = plab->waste() - original_waste;
+    ShenandoahThreadLocalData::add_to_plab_wasted(thread, remnant);
+    evac_tracker()->record_plab_waste(thread, remnant * HeapWordSize);
+  }
   if (top != nullptr && plab->waste() > original_waste && is_in_old(top)) {
     // If retiring the plab created a filler object, then we need to register it with our card scanner so it can
     // safely walk the region backing the plab.
@@ -564,6 +598,28 @@ void ShenandoahGenerationalHeap::retire_plab(PLAB* plab) {
   retire_plab(plab, thread);
 }
 
+void ShenandoahGenerationalHeap::adjust_plab_size(Thread* thread) {
+  const size_t used = ShenandoahThreadLocalData::take_plab_used(thread);
+  if (!ShenandoahAdaptivePLABSize) {
+    // Start over from the minimum size, and double from there on every refill.
+    ShenandoahThreadLocalData::set_plab_size(thread, 0);
+    return;
+  }
+
+  // Like PLABStats, choose a size for which the plab left over at the end of a cycle wastes no more
+  // than TargetPLABWastePct of what this thread promotes and evacuates into old in a cycle. Threads
+  // that do most of the promotions start with large plabs and refill them less often under the
+  // heap lock, while threads that rarely promote start with small ones.
+  AdaptiveWeightedAverage* history = ShenandoahThreadLocalData::plab_used_history(thread);
+  history->sample((float) used);
+  size_t desired = (size_t) (history->average() * TargetPLABWastePct / 100);
+  desired = align_up(desired, CardTable::card_size_in_words());
+  desired = clamp(desired, plab_min_size(), plab_max_size());
+  log_debug(gc, free)("Adjust PLAB size for %s: used " SIZE_FORMAT ", desired " SIZE_FORMAT,
+                      thread->name(), used, desired);
+  ShenandoahThreadLocalData::set_plab_size(thread, desired);
+}
+
 ShenandoahGenerationalHeap::TransferResult ShenandoahGenerationalHeap::balance_generations() {
   shenandoah_assert_heaplocked_or_safepoint();
 
@@ -659,11 +715,24 @@ void ShenandoahGenerationalHeap::compute_old_generation_balance(size_t old_xfer_
   }
 
   // This is the total old we want to ideally reserve
-  const size_t old_reserve = reserve_for_mixed + reserve_for_promo;
+  size_t old_reserve = reserve_for_mixed + reserve_for_promo;
   assert(old_reserve <= max_old_reserve, "cannot reserve more than max for old evacuations");
 
   // We now check if the old generation is running a surplus or a deficit.
   const size_t max_old_available = old_generation()->available() + old_cset_regions * region_size_bytes;
+
+  if (ShenandoahCostModelGenerationSizing && mmu_tracker()->has_cost_model_samples()) {
+    // Young regions beyond the modeled size are cheaper as old headroom: keep them, or
+    // take them from young. A deficit is still bounded by old_xfer_limit below.
+    const size_t young_capacity = young_generation()->max_capacity();
+    const size_t young_target = generation_sizer()->cost_model_young_size();
+    if (young_capacity > young_target) {
+      const size_t model_reserve = max_old_available + (young_capacity - young_target);
+      log_debug(gc, ergo)("Cost model young size: " PROPERFMT ", keeping " PROPERFMT " available in old",
+                          PROPERFMTARGS(young_target), PROPERFMTARGS(model_reserve));
+      old_reserve = MAX2(old_reserve, model_reserve);
+    }
+  }
   if (max_old_available >= old_reserve) {
     // We are running a surplus, so the old region surplus can go to young
     const size_t old_surplus = (max_old_available - old_reserve) / region_size_bytes;
@@ -957,22 +1026,29 @@ private:
   }
 };
 
+void ShenandoahGenerationalHeap::prepare_update_refs_iteration() {
+  ShenandoahHeap::prepare_update_refs_iteration();
+  _update_refs_chunks->reset();
+}
+
 void ShenandoahGenerationalHeap::update_heap_references(bool concurrent) {
   assert(!is_full_gc_in_progress(), "Only for concurrent and degenerated GC");
   const uint nworkers = workers()->active_workers();
-  ShenandoahRegionChunkIterator work_list(nworkers);
+  RememberedScanner* card_scan = old_generation()->card_scan();
+  card_scan->clear_scan_totals();
+  // Workers finish the region or chunk they claimed before they notice cancellation, so
+  // everything claimed from the iterators is done. Degenerated GC picks up from there.
   if (concurrent) {
-    ShenandoahGenerationalUpdateHeapRefsTask<true> task(&_update_refs_iterator, &work_list);
+    ShenandoahGenerationalUpdateHeapRefsTask<true> task(&_update_refs_iterator, _update_refs_chunks);
     workers()->run_task(&task);
   } else {
-    ShenandoahGenerationalUpdateHeapRefsTask<false> task(&_update_refs_iterator, &work_list);
+    ShenandoahGenerationalUpdateHeapRefsTask<false> task(&_update_refs_iterator, _update_refs_chunks);
     workers()->run_task(&task);
   }
 
+  card_scan->report_scan_totals(nworkers, CARD_STAT_UPDATE_REFS);
   if (ShenandoahEnableCardStats) {
     // Only do this if we are collecting card stats
-    RememberedScanner* card_scan = old_generation()->card_scan();
-    assert(card_scan != nullptr, "Card table must exist when card stats are enabled");
     card_scan->log_card_stats(nworkers, CARD_STAT_UPDATE_REFS);
   }
 }
@@ -1117,3 +1193,8 @@ void ShenandoahGenerationalHeap::update_region_ages(ShenandoahMarkingContext* ct
   ShenandoahUpdateRegionAges cl(ctx);
   parallel_heap_region_iterate(&cl);
 }
+
+bool ShenandoahGenerationalHeap::should_promote_humongous(ShenandoahHeapRegion* r) const {
+  assert(r->is_young() && r->is_humongous_start(), "Only young humongous objects are promoted");
+  return ShenandoahPromoteHumongousPrimitiveArrays || !cast_to_oop(r->bottom())->is_typeArray();
+}
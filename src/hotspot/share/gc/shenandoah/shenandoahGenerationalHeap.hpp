@@ -28,9 +28,11 @@
 #include "gc/shenandoah/shenandoahHeap.hpp"
 
 class PLAB;
+class ShenandoahRegionChunkIterator;
 class ShenandoahRegulatorThread;
 class ShenandoahGenerationalControlThread;
 class ShenandoahAgeCensus;
+class ShenandoahPretenureTable;
 
 class ShenandoahGenerationalHeap : public ShenandoahHeap {
 public:
@@ -51,6 +53,8 @@ private:
   ShenandoahSharedFlag  _is_aging_cycle;
   // Age census used for adapting tenuring threshold
   ShenandoahAgeCensus* _age_census;
+  // Classes whose young instances are promoted at first survival, with ShenandoahPretenureSampleRate
+  ShenandoahPretenureTable* _pretenure_table;
 
 public:
   void set_aging_cycle(bool cond) {
@@ -66,10 +70,19 @@ public:
     return _age_census;
   }
 
+  // Return the pretenuring table, or null when ShenandoahPretenureSampleRate is 0
+  ShenandoahPretenureTable* pretenure_table() const {
+    return _pretenure_table;
+  }
+
   // Ages regions that haven't been used for allocations in the current cycle.
   // Resets ages for regions that have been used for allocations.
   void update_region_ages(ShenandoahMarkingContext* ctx);
 
+  // Whether the live object of this aged young humongous start region should be promoted.
+  // See ShenandoahPromoteHumongousPrimitiveArrays.
+  bool should_promote_humongous(ShenandoahHeapRegion* r) const;
+
   oop evacuate_object(oop p, Thread* thread) override;
   oop try_evacuate_object(oop p, Thread* thread, ShenandoahHeapRegion* from_region, ShenandoahAffiliation target_gen);
 
@@ -79,8 +92,12 @@ public:
   void retire_plab(PLAB* plab);
   void retire_plab(PLAB* plab, Thread* thread);
 
+  // Sets the size of the first plab this thread takes in the next cycle from its plab usage history.
+  void adjust_plab_size(Thread* thread);
+
   // ---------- Update References
   //
+  void prepare_update_refs_iteration() override;
   void update_heap_references(bool concurrent) override;
   void final_update_refs_update_region_states() override;
 
@@ -92,6 +109,11 @@ private:
   const size_t _min_plab_size;
   const size_t _max_plab_size;
 
+  // Remembered set chunks for update refs. Like _update_refs_iterator, this outlives
+  // a cancelled concurrent update refs, so that degenerated GC scans only the chunks
+  // that the concurrent phase did not get to.
+  ShenandoahRegionChunkIterator* _update_refs_chunks;
+
   static size_t calculate_min_plab();
   static size_t calculate_max_plab();
 
@@ -28,6 +28,7 @@
 #include "memory/allocation.hpp"
 #include "memory/universe.hpp"
 
+#include "cds/archiveHeapWriter.hpp"
 #include "gc/shared/classUnloadingContext.hpp"
 #include "gc/shared/gcArguments.hpp"
 #include "gc/shared/gcTimer.hpp"
@@ -35,18 +36,21 @@
 #include "gc/shared/locationPrinter.inline.hpp"
 #include "gc/shared/memAllocator.hpp"
 #include "gc/shared/plab.hpp"
+#include "gc/shared/threadLocalAllocBuffer.hpp"
 #include "gc/shared/tlab_globals.hpp"
 
 #include "gc/shenandoah/heuristics/shenandoahOldHeuristics.hpp"
 #include "gc/shenandoah/heuristics/shenandoahYoungHeuristics.hpp"
 #include "gc/shenandoah/shenandoahAllocRequest.hpp"
 #include "gc/shenandoah/shenandoahBarrierSet.hpp"
+#include "gc/shenandoah/shenandoahClassHistogram.hpp"
 #include "gc/shenandoah/shenandoahClosures.inline.hpp"
 #include "gc/shenandoah/shenandoahCollectionSet.hpp"
 #include "gc/shenandoah/shenandoahCollectorPolicy.hpp"
 #include "gc/shenandoah/shenandoahConcurrentMark.hpp"
 #include "gc/shenandoah/shenandoahMarkingContext.inline.hpp"
 #include "gc/shenandoah/shenandoahControlThread.hpp"
+#include "gc/shenandoah/shenandoahCycleHistory.hpp"
 #include "gc/shenandoah/shenandoahFreeSet.hpp"
 #include "gc/shenandoah/shenandoahGenerationalEvacuationTask.hpp"
 #include "gc/shenandoah/shenandoahGenerationalHeap.hpp"
@@ -55,19 +59,26 @@
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahHeapRegion.inline.hpp"
 #include "gc/shenandoah/shenandoahHeapRegionSet.hpp"
+#include "gc/shenandoah/shenandoahHeuristicsTrace.hpp"
+#include "gc/shenandoah/shenandoahHugePages.hpp"
 #include "gc/shenandoah/shenandoahInitLogger.hpp"
+#include "gc/shenandoah/shenandoahLivenessCache.hpp"
 #include "gc/shenandoah/shenandoahMarkingContext.inline.hpp"
 #include "gc/shenandoah/shenandoahMemoryPool.hpp"
 #include "gc/shenandoah/shenandoahMonitoringSupport.hpp"
+#include "gc/shenandoah/shenandoahNUMA.hpp"
 #include "gc/shenandoah/shenandoahOldGeneration.hpp"
 #include "gc/shenandoah/shenandoahOopClosures.inline.hpp"
 #include "gc/shenandoah/shenandoahPacer.inline.hpp"
 #include "gc/shenandoah/shenandoahPadding.hpp"
 #include "gc/shenandoah/shenandoahParallelCleaning.inline.hpp"
+#include "gc/shenandoah/shenandoahParallelEvacuation.hpp"
 #include "gc/shenandoah/shenandoahReferenceProcessor.hpp"
 #include "gc/shenandoah/shenandoahRootProcessor.inline.hpp"
 #include "gc/shenandoah/shenandoahScanRemembered.inline.hpp"
 #include "gc/shenandoah/shenandoahSTWMark.hpp"
+#include "gc/shenandoah/shenandoahTaskqueue.hpp"
+#include "gc/shenandoah/shenandoahThreadLocalData.hpp"
 #include "gc/shenandoah/shenandoahUtils.hpp"
 #include "gc/shenandoah/shenandoahVerifier.hpp"
 #include "gc/shenandoah/shenandoahCodeRoots.hpp"
@@ -85,17 +96,23 @@
 #include "gc/shenandoah/shenandoahJfrSupport.hpp"
 #endif
 
+#include "classfile/stringTable.hpp"
 #include "classfile/systemDictionary.hpp"
 #include "code/codeCache.hpp"
+#include "jfr/jfrEvents.hpp"
 #include "memory/classLoaderMetaspace.hpp"
 #include "memory/metaspaceUtils.hpp"
 #include "oops/compressedOops.inline.hpp"
 #include "prims/jvmtiTagMap.hpp"
 #include "runtime/atomic.hpp"
 #include "runtime/globals.hpp"
+#include "runtime/handshake.hpp"
 #include "runtime/interfaceSupport.inline.hpp"
 #include "runtime/java.hpp"
+#include "runtime/mutexLocker.hpp"
 #include "runtime/orderAccess.hpp"
+#include "runtime/prefetch.inline.hpp"
+#include "runtime/safepoint.hpp"
 #include "runtime/safepointMechanism.hpp"
 #include "runtime/vmThread.hpp"
 #include "services/mallocTracker.hpp"
@@ -190,6 +207,14 @@ jint ShenandoahHeap::initialize() {
   size_t heap_page_size   = UseLargePages ? os::large_page_size() : os::vm_page_size();
   size_t bitmap_page_size = UseLargePages ? os::large_page_size() : os::vm_page_size();
   size_t region_page_size = UseLargePages ? os::large_page_size() : os::vm_page_size();
+  _heap_page_size = heap_page_size;
+  _bitmap_page_size = bitmap_page_size;
+
+  _notes_weak_root_stores = ShenandoahSettledWeakRoots && mode()->is_generational();
+
+  if (ShenandoahParallelTableCleanup) {
+    StringTable::enable_parallel_cleanup();
+  }
 
   //
   // Reserve and commit memory for heap
@@ -218,10 +243,19 @@ jint ShenandoahHeap::initialize() {
   }
 #endif
 
+  _numa = new ShenandoahNUMA(_num_regions, reg_size_bytes, heap_rs.page_size());
+
+  if (ShenandoahSplitCopyThreshold > 0 && _max_workers > 1) {
+    _split_copier = new ShenandoahSplitCopier(_max_workers, ShenandoahSplitCopyThreshold);
+  }
+
+  ShenandoahTaskOverflowSpace::initialize(ShenandoahMarkOverflowReserve);
+
   ReservedSpace sh_rs = heap_rs.first_part(max_byte_size);
   if (!_heap_region_special) {
     os::commit_memory_or_exit(sh_rs.base(), _initial_size, heap_alignment, false,
                               "Cannot commit heap memory");
+    _numa->request_memory_on_nodes(sh_rs.base(), _initial_size, 0);
   }
 
   BarrierSet::set_barrier_set(new ShenandoahBarrierSet(this, _heap_region));
@@ -441,28 +475,45 @@ jint ShenandoahHeap::initialize() {
 
     ShenandoahPretouchHeapTask hcl(_pretouch_heap_page_size);
     _workers->run_task(&hcl);
+
+    // Everything is resident now, which tells what the kernel made of the huge page advice
+    LogTarget(Info, gc, init) lt;
+    if (UseLargePages && lt.is_enabled()) {
+      LogStream ls(lt);
+      print_huge_page_coverage_on(&ls);
+    }
   }
 
   //
   // Initialize the rest of GC subsystems
   //
 
-  _liveness_cache = NEW_C_HEAP_ARRAY(ShenandoahLiveData*, _max_workers, mtGC);
-  for (uint worker = 0; worker < _max_workers; worker++) {
-    _liveness_cache[worker] = NEW_C_HEAP_ARRAY(ShenandoahLiveData, _num_regions, mtGC);
-    Copy::fill_to_bytes(_liveness_cache[worker], _num_regions * sizeof(ShenandoahLiveData));
+  size_t liveness_cache_slots = MIN2(round_up_power_of_2(ShenandoahLivenessCacheSize),
+                                     round_up_power_of_2(_num_regions));
+  _liveness_cache = NEW_C_HEAP_ARRAY(ShenandoahLivenessCache*, _max_workers + mark_assist_queues(), mtGC);
+  for (uint worker = 0; worker < _max_workers + mark_assist_queues(); worker++) {
+    _liveness_cache[worker] = new ShenandoahLivenessCache(liveness_cache_slots);
   }
 
+#if INCLUDE_SERVICES
+  if (ShenandoahMarkingClassHistogram) {
+    _class_histogram = new ShenandoahClassHistogram(_max_workers);
+  }
+#endif
+
   // There should probably be Shenandoah-specific options for these,
   // just as there are G1-specific options.
   {
     ShenandoahSATBMarkQueueSet& satbqs = ShenandoahBarrierSet::satb_mark_queue_set();
     satbqs.set_process_completed_buffers_threshold(20); // G1SATBProcessCompletedThreshold
     satbqs.set_buffer_enqueue_threshold_percentage(60); // G1SATBBufferEnqueueingThresholdPercent
+    satbqs.initialize_node_lists(_numa->num_nodes());
   }
 
   _monitoring_support = new ShenandoahMonitoringSupport(this);
   _phase_timings = new ShenandoahPhaseTimings(max_workers());
+  _cycle_history = new ShenandoahCycleHistory();
+  ShenandoahHeuristicsTrace::initialize();
   ShenandoahCodeRoots::initialize();
 
   if (ShenandoahPacing) {
@@ -541,6 +592,10 @@ ShenandoahHeap::ShenandoahHeap(ShenandoahCollectorPolicy* policy) :
   _gc_no_progress_count(0),
   _cancel_requested_time(0),
   _update_refs_iterator(this),
+  _cset_ref_summary(0),
+  _ref_summary_exact(false),
+  _notes_weak_root_stores(false),
+  _settled_weak_roots_epoch(1),
   _global_generation(nullptr),
   _control_thread(nullptr),
   _young_generation(nullptr),
@@ -550,9 +605,14 @@ ShenandoahHeap::ShenandoahHeap(ShenandoahCollectorPolicy* policy) :
   _free_set(nullptr),
   _pacer(nullptr),
   _verifier(nullptr),
+  _numa(nullptr),
+  _split_copier(nullptr),
   _phase_timings(nullptr),
   _evac_tracker(nullptr),
+  _cycle_history(nullptr),
   _mmu_tracker(),
+  _alloc_spike_detector(),
+  _soft_max_controller(),
   _monitoring_support(nullptr),
   _memory_pool(nullptr),
   _stw_memory_manager("Shenandoah Pauses"),
@@ -564,9 +624,12 @@ ShenandoahHeap::ShenandoahHeap(ShenandoahCollectorPolicy* policy) :
   _bitmap_size(0),
   _bitmap_regions_per_slice(0),
   _bitmap_bytes_per_slice(0),
+  _heap_page_size(0),
+  _bitmap_page_size(0),
   _bitmap_region_special(false),
   _aux_bitmap_region_special(false),
   _liveness_cache(nullptr),
+  _class_histogram(nullptr),
   _collection_set(nullptr)
 {
   // Initialize GC mode early, many subsequent initialization procedures depend on it
@@ -644,6 +707,7 @@ public:
 void ShenandoahHeap::post_initialize() {
   CollectedHeap::post_initialize();
   _mmu_tracker.initialize();
+  _soft_max_controller.initialize();
 
   MutexLocker ml(Threads_lock);
 
@@ -871,6 +935,11 @@ bool ShenandoahHeap::check_soft_max_changed() {
   return false;
 }
 
+void ShenandoahHeap::invalidate_settled_weak_roots() {
+  assert(SafepointSynchronize::is_at_safepoint(), "Must be at a safepoint");
+  _settled_weak_roots_epoch++;
+}
+
 void ShenandoahHeap::notify_heap_changed() {
   // Update monitoring counters when we took a new region. This amortizes the
   // update costs on slow path.
@@ -921,9 +990,15 @@ HeapWord* ShenandoahHeap::allocate_from_gclab_slow(Thread* thread, size_t size)
 
   assert (size <= actual_size, "allocation should fit");
 
+  prepare_gclab_buffer(gclab_buf, actual_size);
+  gclab->set_buf(gclab_buf, actual_size);
+  return gclab->allocate(size);
+}
+
+void ShenandoahHeap::prepare_gclab_buffer(HeapWord* buf, size_t word_size) {
   if (ZeroTLAB) {
     // ..and clear it.
-    Copy::zero_to_words(gclab_buf, actual_size);
+    Copy::zero_to_words(buf, word_size);
   } else {
     // ...and zap just allocated object.
 #ifdef ASSERT
@@ -931,11 +1006,9 @@ HeapWord* ShenandoahHeap::allocate_from_gclab_slow(Thread* thread, size_t size)
     // ensure that the returned space is not considered parsable by
     // any concurrent GC thread.
     size_t hdr_size = oopDesc::header_size();
-    Copy::fill_to_words(gclab_buf + hdr_size, actual_size - hdr_size, badHeapWordVal);
+    Copy::fill_to_words(buf + hdr_size, word_size - hdr_size, badHeapWordVal);
 #endif // ASSERT
   }
-  gclab->set_buf(gclab_buf, actual_size);
-  return gclab->allocate(size);
 }
 
 // Called from stubs in JIT code or interpreter
@@ -946,6 +1019,7 @@ HeapWord* ShenandoahHeap::allocate_new_tlab(size_t min_size,
   HeapWord* res = allocate_memory(req);
   if (res != nullptr) {
     *actual_size = req.actual_size();
+    _alloc_spike_detector.record_refill();
   } else {
     *actual_size = 0;
   }
@@ -972,7 +1046,7 @@ HeapWord* ShenandoahHeap::allocate_memory(ShenandoahAllocRequest& req) {
 
   if (req.is_mutator_alloc()) {
     if (ShenandoahPacing) {
-      pacer()->pace_for_alloc(req.size());
+      pacer()->pace_for_alloc(req.size(), req.type());
       pacer_epoch = pacer()->epoch();
     }
 
@@ -1045,6 +1119,18 @@ HeapWord* ShenandoahHeap::allocate_memory(ShenandoahAllocRequest& req) {
       if (ShenandoahPacing && (pacer_epoch > 0) && (requested > actual)) {
         pacer()->unpace_for_alloc(pacer_epoch, requested - actual);
       }
+
+      if (actual > ShenandoahHeapRegion::humongous_threshold_words()) {
+        EventShenandoahHumongousAllocation event;
+        if (event.should_commit()) {
+          size_t size = actual * HeapWordSize;
+          event.set_size(size);
+          event.set_regions(ShenandoahHeapRegion::required_regions(size));
+          event.set_waste(req.waste() * HeapWordSize);
+          event.set_startRegion((unsigned) heap_region_index_containing(result));
+          event.commit();
+        }
+      }
     }
   }
 
@@ -1052,6 +1138,12 @@ HeapWord* ShenandoahHeap::allocate_memory(ShenandoahAllocRequest& req) {
 }
 
 HeapWord* ShenandoahHeap::allocate_memory_under_lock(ShenandoahAllocRequest& req, bool& in_new_region) {
+  // TLABs and GCLABs are refilled from the thread's allocation shard, which takes the heap lock only when
+  // it needs a new region.
+  if (_free_set->can_allocate_from_shard(req)) {
+    return _free_set->allocate_from_shard(req, in_new_region);
+  }
+
   // If we are dealing with mutator allocation, then we may need to block for safepoint.
   // We cannot block for safepoint for GC allocations, because there is a high chance
   // we are already running at safepoint or from stack watermark machinery, and we cannot
@@ -1099,7 +1191,13 @@ HeapWord* ShenandoahHeap::allocate_memory_under_lock(ShenandoahAllocRequest& req
 HeapWord* ShenandoahHeap::mem_allocate(size_t size,
                                         bool*  gc_overhead_limit_was_exceeded) {
   ShenandoahAllocRequest req = ShenandoahAllocRequest::for_shared(size);
-  return allocate_memory(req);
+  HeapWord* result = allocate_memory(req);
+  ShenandoahThreadLocalData::set_zeroed_allocation(Thread::current(), req.is_zeroed() ? result : nullptr);
+  return result;
+}
+
+bool ShenandoahHeap::is_zeroed_allocation(HeapWord* mem) const {
+  return mem != nullptr && ShenandoahThreadLocalData::zeroed_allocation(Thread::current()) == mem;
 }
 
 MetaWord* ShenandoahHeap::satisfy_failed_metadata_allocation(ClassLoaderData* loader_data,
@@ -1138,6 +1236,56 @@ MetaWord* ShenandoahHeap::satisfy_failed_metadata_allocation(ClassLoaderData* lo
   return nullptr;
 }
 
+// With ShenandoahEvacCoLocateDepth, evacuates the collection set objects that the first reference fields
+// of a just evacuated object point to, depth first, so that they are copied right after it and stay
+// close to it in to-space. There is no field access profile to pick the hot fields from; the fields
+// declared first are followed instead, as they tend to be the ones used together with the object.
+// Only plain instances are followed: arrays, mirrors, references and stack chunks are left alone.
+class ShenandoahEvacuateReferentsClosure : public BasicOopIterateClosure {
+private:
+  static const uint MaxFields = 4;
+
+  ShenandoahHeap* const _heap;
+  Thread* const _thread;
+  const uint _depth;
+  uint _fields;
+
+  template <class T>
+  void do_oop_work(T* p) {
+    if (_fields == 0) {
+      return;
+    }
+    _fields--;
+    T o = RawAccess<>::oop_load(p);
+    if (CompressedOops::is_null(o)) {
+      return;
+    }
+    oop obj = CompressedOops::decode_not_null(o);
+    if (!_heap->in_collection_set(obj) || obj->is_forwarded() ||
+        !_heap->complete_marking_context()->is_marked(obj)) {
+      return;
+    }
+    oop copy = _heap->evacuate_object(obj, _thread);
+    if (_depth > 1 && copy != obj) {
+      ShenandoahEvacuateReferentsClosure cl(_heap, _thread, _depth - 1);
+      cl.follow(copy);
+    }
+  }
+
+public:
+  ShenandoahEvacuateReferentsClosure(ShenandoahHeap* heap, Thread* thread, uint depth) :
+    _heap(heap), _thread(thread), _depth(depth), _fields(MaxFields) {}
+
+  void follow(oop obj) {
+    if (obj->klass()->kind() == Klass::InstanceKlassKind) {
+      obj->oop_iterate(this);
+    }
+  }
+
+  void do_oop(oop* p)       { do_oop_work(p); }
+  void do_oop(narrowOop* p) { do_oop_work(p); }
+};
+
 class ShenandoahConcurrentEvacuateRegionObjectClosure : public ObjectClosure {
 private:
   ShenandoahHeap* const _heap;
@@ -1149,7 +1297,11 @@ public:
   void do_object(oop p) {
     shenandoah_assert_marked(nullptr, p);
     if (!p->is_forwarded()) {
-      _heap->evacuate_object(p, _thread);
+      oop copy = _heap->evacuate_object(p, _thread);
+      if (ShenandoahEvacCoLocateDepth > 0 && copy != p) {
+        ShenandoahEvacuateReferentsClosure cl(_heap, _thread, (uint)ShenandoahEvacCoLocateDepth);
+        cl.follow(copy);
+      }
     }
   }
 };
@@ -1157,7 +1309,7 @@ public:
 class ShenandoahEvacuationTask : public WorkerTask {
 private:
   ShenandoahHeap* const _sh;
-  ShenandoahCollectionSet* const _cs;
+  ShenandoahCollectionSetChunkIterator _chunks;
   bool _concurrent;
 public:
   ShenandoahEvacuationTask(ShenandoahHeap* sh,
@@ -1165,7 +1317,7 @@ public:
                            bool concurrent) :
     WorkerTask("Shenandoah Evacuation"),
     _sh(sh),
-    _cs(cs),
+    _chunks(sh, cs),
     _concurrent(concurrent)
   {}
 
@@ -1185,17 +1337,97 @@ public:
 private:
   void do_work() {
     ShenandoahConcurrentEvacuateRegionObjectClosure cl(_sh);
+    ShenandoahSplitCopier* const copier = _sh->split_copier();
+    Thread* const thread = Thread::current();
     ShenandoahHeapRegion* r;
-    while ((r =_cs->claim_next()) != nullptr) {
+    HeapWord* from;
+    HeapWord* to;
+    while (_chunks.next(&r, &from, &to)) {
       assert(r->has_live(), "Region " SIZE_FORMAT " should have been reclaimed early", r->index());
-      _sh->marked_object_iterate(r, &cl);
+      evacuate_chunk(r, from, to, thread, &cl);
 
       if (ShenandoahPacing) {
-        _sh->pacer()->report_evac(r->used() >> LogHeapWordSize);
+        _sh->pacer()->report_evac(pointer_delta(to, from));
+      }
+
+      if (copier != nullptr) {
+        copier->help();
       }
 
       if (_sh->check_cancelled_gc_and_yield(_concurrent)) {
-        break;
+        return;
+      }
+    }
+
+    // Out of chunks, but other workers may still be copying large objects.
+    if (copier != nullptr) {
+      copier->help();
+    }
+  }
+
+  // Evacuates the marked objects that start in [from, to). Marked objects are decoded from the bitmap in
+  // batches of ShenandoahMarkScanPrefetch: the headers of the whole batch are prefetched before their
+  // forwarding state and sizes are read, and the GCLAB destinations of the live batch are prefetched for
+  // writing before anything is copied. The last chunk of the region also evacuates the objects above TAMS,
+  // which are walked by size.
+  void evacuate_chunk(ShenandoahHeapRegion* r, HeapWord* from, HeapWord* to, Thread* thread, ObjectClosure* cl) {
+    ShenandoahMarkingContext* const ctx = _sh->marking_context();
+    HeapWord* tams = ctx->top_at_mark_start(r);
+    HeapWord* limit_bitmap = MIN2(to, tams);
+
+    // No variable-length arrays in standard C++, have enough slots to fit the batch.
+    static const int SLOT_COUNT = 256;
+    const int batch = MAX2((int) ShenandoahMarkScanPrefetch, 1);
+    guarantee(batch <= SLOT_COUNT, "adjust slot count");
+    HeapWord* addrs[SLOT_COUNT];
+    oop slots[SLOT_COUNT];
+
+    PLAB* const gclab = UseTLAB ? ShenandoahThreadLocalData::gclab(thread) : nullptr;
+
+    HeapWord* cb = from;
+    while (cb < limit_bitmap) {
+      int avail = (int) ctx->get_next_marked_addrs(cb, limit_bitmap, addrs, batch, &cb);
+      for (int c = 0; c < avail; c++) {
+        Prefetch::read(addrs[c], oopDesc::mark_offset_in_bytes());
+        slots[c] = cast_to_oop(addrs[c]);
+      }
+
+      // Drop the objects that are already forwarded, and prefetch where the others will be copied.
+      HeapWord* dest = (gclab != nullptr) ? gclab->top() : nullptr;
+      HeapWord* const dest_end = (gclab != nullptr) ? gclab->top() + gclab->words_remaining() : nullptr;
+      int live = 0;
+      for (int c = 0; c < avail; c++) {
+        oop obj = slots[c];
+        assert(oopDesc::is_oop(obj), "sanity");
+        assert(ctx->is_marked(obj), "object expected to be marked");
+        if (obj->is_forwarded()) {
+          continue;
+        }
+        if (dest != nullptr) {
+          size_t size = obj->size();
+          if (dest + size <= dest_end) {
+            Prefetch::write(dest, 0);
+            dest += size;
+          } else {
+            dest = nullptr;
+          }
+        }
+        slots[live++] = obj;
+      }
+
+      for (int c = 0; c < live; c++) {
+        cl->do_object(slots[c]);
+      }
+    }
+
+    if (to == r->top()) {
+      HeapWord* cs = tams;
+      while (cs < to) {
+        oop obj = cast_to_oop(cs);
+        assert(oopDesc::is_oop(obj), "sanity");
+        size_t size = obj->size();
+        cl->do_object(obj);
+        cs += size;
       }
     }
   }
@@ -1225,6 +1457,12 @@ oop ShenandoahHeap::evacuate_object(oop p, Thread* thread) {
   ShenandoahHeapRegion* r = heap_region_containing(p);
   assert(!r->is_humongous(), "never evacuate humongous objects");
 
+  if (ShenandoahEvacuatePinnedRegions && r->is_in_pinned_range(p)) {
+    // Pinned objects stay where they are. An object can be caught by the range after it was
+    // evacuated, when the range widened after an evacuation failure, so it may be forwarded.
+    return ShenandoahBarrierSet::resolve_forwarded(p);
+  }
+
   ShenandoahAffiliation target_gen = r->affiliation();
   return try_evacuate_object(p, thread, r, target_gen);
 }
@@ -1266,6 +1504,13 @@ oop ShenandoahHeap::try_evacuate_object(oop p, Thread* thread, ShenandoahHeapReg
 #endif
 
   if (copy == nullptr) {
+    if (ShenandoahEvacuatePinnedRegions && ShenandoahSafepoint::is_at_shenandoah_safepoint()) {
+      // Only GC workers run, and they do not write to the objects they evacuate, so the failed object
+      // can be left in place like a pinned one, instead of failing the whole degenerated cycle.
+      from_region->record_pinned_object(cast_from_oop<HeapWord*>(p), size);
+      return ShenandoahBarrierSet::resolve_forwarded(p);
+    }
+
     control_thread()->handle_alloc_failure_evac(size);
 
     _oom_evac_handler.handle_out_of_memory_during_evacuation();
@@ -1275,7 +1520,7 @@ oop ShenandoahHeap::try_evacuate_object(oop p, Thread* thread, ShenandoahHeapReg
 
   // Copy the object:
   _evac_tracker->begin_evacuation(thread, size * HeapWordSize);
-  Copy::aligned_disjoint_words(cast_from_oop<HeapWord*>(p), copy, size);
+  copy_for_evacuation(thread, cast_from_oop<HeapWord*>(p), copy, size);
 
   oop copy_val = cast_to_oop(copy);
 
@@ -1313,6 +1558,35 @@ oop ShenandoahHeap::try_evacuate_object(oop p, Thread* thread, ShenandoahHeapReg
   }
 }
 
+void ShenandoahHeap::copy_for_evacuation(Thread* thread, HeapWord* from, HeapWord* to, size_t size) {
+  if (_split_copier != nullptr && _split_copier->should_split(size) && thread->is_Worker_thread()) {
+    _split_copier->copy(from, to, size);
+  } else {
+    Copy::aligned_disjoint_words(from, to, size);
+  }
+}
+
+// Fills the evacuated objects of a region left with pinned objects, and measures the objects
+// that were left in place.
+class ShenandoahFillEvacuatedObjectsClosure : public ObjectClosure {
+private:
+  size_t _retained_words;
+
+public:
+  ShenandoahFillEvacuatedObjectsClosure() : _retained_words(0) {}
+
+  void do_object(oop obj) {
+    size_t size = obj->size();
+    if (obj->is_forwarded()) {
+      ShenandoahHeap::fill_with_object(cast_from_oop<HeapWord*>(obj), size);
+    } else {
+      _retained_words += size;
+    }
+  }
+
+  size_t retained_words() const { return _retained_words; }
+};
+
 void ShenandoahHeap::trash_cset_regions() {
   ShenandoahHeapLocker locker(lock());
 
@@ -1320,11 +1594,38 @@ void ShenandoahHeap::trash_cset_regions() {
   ShenandoahHeapRegion* r;
   set->clear_current_index();
   while ((r = set->next()) != nullptr) {
-    r->make_trash();
+    if (ShenandoahEvacuatePinnedRegions && r->has_pinned_range()) {
+      retain_pinned_objects(r);
+    } else {
+      r->make_trash();
+    }
   }
+  _cycle_history->record_collection_set(collection_set());
   collection_set()->clear();
 }
 
+void ShenandoahHeap::retain_pinned_objects(ShenandoahHeapRegion* r) {
+  shenandoah_assert_heaplocked();
+  assert(SafepointSynchronize::is_at_safepoint(), "Must be at a safepoint");
+  assert(r->is_cset(), "Region " SIZE_FORMAT " should be in collection set", r->index());
+
+  // References to the evacuated objects have all been updated, so they can be
+  // turned into filler space. It is reclaimed as soon as the region is evacuated
+  // again with no pins left.
+  ShenandoahFillEvacuatedObjectsClosure cl;
+  marked_object_iterate(r, &cl);
+
+  if (r->pin_count() == 0) {
+    r->clear_pinned_range();
+    if (cl.retained_words() == 0) {
+      r->make_trash();
+      return;
+    }
+  }
+  r->set_live_data(cl.retained_words() * HeapWordSize);
+  r->make_retained();
+}
+
 void ShenandoahHeap::print_heap_regions_on(outputStream* st) const {
   st->print_cr("Heap Regions:");
   st->print_cr("Region state: EU=empty-uncommitted, EC=empty-committed, R=regular, H=humongous start, HP=pinned humongous start");
@@ -1350,6 +1651,15 @@ size_t ShenandoahHeap::trash_humongous_region_at(ShenandoahHeapRegion* start) {
 
   assert(!start->has_live(), "liveness must be zero");
 
+  EventShenandoahHumongousReclamation event;
+  if (event.should_commit()) {
+    event.set_objectClass(humongous_obj->klass());
+    event.set_size(size * HeapWordSize);
+    event.set_regions(required_regions);
+    event.set_startRegion((unsigned) start->index());
+    event.commit();
+  }
+
   for(size_t i = 0; i < required_regions; i++) {
     // Reclaim from tail. Otherwise, assertion fails when printing region to trace log,
     // as it expects that every region belongs to a humongous region starting with a humongous start region.
@@ -1400,8 +1710,8 @@ public:
       //  1. We need to make the plab memory parsable by remembered-set scanning.
       //  2. We need to establish a trustworthy UpdateWaterMark value within each old-gen heap region
       ShenandoahGenerationalHeap::heap()->retire_plab(plab, thread);
-      if (_resize && ShenandoahThreadLocalData::plab_size(thread) > 0) {
-        ShenandoahThreadLocalData::set_plab_size(thread, 0);
+      if (_resize) {
+        ShenandoahGenerationalHeap::heap()->adjust_plab_size(thread);
       }
     }
   }
@@ -1461,6 +1771,60 @@ void ShenandoahHeap::gclabs_retire(bool resize) {
   }
 }
 
+void ShenandoahHeap::prefill_mutator_gclabs() {
+  assert(ShenandoahSafepoint::is_at_shenandoah_safepoint(), "Should be at safepoint");
+  assert(UseTLAB && ShenandoahPrefilledGCLABSize > 0, "Only call when prefilling GCLABs");
+
+  const size_t word_size = clamp(ShenandoahPrefilledGCLABSize, PLAB::min_size(), PLAB::max_size());
+  size_t filled = 0;
+  bool in_new_region = false;
+  {
+    ShenandoahHeapLocker locker(lock());
+
+    // Prefilled GCLABs that are never used are wasted, so do not let them take more than
+    // a quarter of the memory the collector has for evacuation.
+    size_t budget = _free_set->collector_available() / HeapWordSize / 4;
+
+    for (JavaThreadIteratorWithHandle jtiwh; JavaThread* t = jtiwh.next(); ) {
+      PLAB* gclab = ShenandoahThreadLocalData::gclab(t);
+      if (gclab == nullptr || gclab->words_remaining() > 0) {
+        continue;
+      }
+      if (budget < word_size) {
+        break;
+      }
+
+      ShenandoahAllocRequest req = ShenandoahAllocRequest::for_gclab(word_size, word_size);
+      bool new_region = false;
+      HeapWord* buf = _free_set->allocate(req, new_region);
+      in_new_region |= new_region;
+      if (buf == nullptr) {
+        req.set_actual_size(0);
+      }
+      // Account for any waste created by retiring regions, as allocate_memory() does.
+      increase_used(req);
+      if (buf == nullptr) {
+        break;
+      }
+
+      prepare_gclab_buffer(buf, req.actual_size());
+      gclab->set_buf(buf, req.actual_size());
+      // Later refills grow from the prefilled size.
+      if (ShenandoahThreadLocalData::gclab_size(t) < word_size) {
+        ShenandoahThreadLocalData::set_gclab_size(t, word_size);
+      }
+      budget -= MIN2(budget, req.actual_size());
+      filled++;
+    }
+  }
+
+  if (in_new_region) {
+    notify_heap_changed();
+  }
+  log_debug(gc, free)("Prefilled " SIZE_FORMAT " mutator GCLABs of " SIZE_FORMAT "%s",
+                      filled, byte_size_in_proper_unit(word_size * HeapWordSize), proper_unit_for_byte_size(word_size * HeapWordSize));
+}
+
 // Returns size in bytes
 size_t ShenandoahHeap::unsafe_max_tlab_alloc(Thread *thread) const {
   // Return the max allowed size, and let the allocation path
@@ -1468,6 +1832,23 @@ size_t ShenandoahHeap::unsafe_max_tlab_alloc(Thread *thread) const {
   return ShenandoahHeapRegion::max_tlab_size_bytes();
 }
 
+// Returns size in words
+size_t ShenandoahHeap::adjust_tlab_size(Thread* thr, size_t desired_size) const {
+  // TLAB refills compete with GCLABs during evacuation, while outside of cycles
+  // fewer refills mean fewer trips to the heap lock.
+  uintx percent = 100;
+  if (is_evacuation_in_progress()) {
+    percent = ShenandoahEvacTLABSizePercent;
+  } else if (is_idle()) {
+    percent = ShenandoahIdleTLABSizePercent;
+  }
+  if (percent == 100) {
+    return desired_size;
+  }
+  size_t adjusted = desired_size * percent / 100;
+  return MIN2(MAX2(align_object_size(adjusted), ThreadLocalAllocBuffer::min_size()), max_tlab_size());
+}
+
 size_t ShenandoahHeap::max_tlab_size() const {
   // Returns size in words
   return ShenandoahHeapRegion::max_tlab_size_words();
@@ -1538,6 +1919,35 @@ void ShenandoahHeap::print_tracing_info() const {
 
     ls.cr();
     ls.cr();
+
+    if (UseLargePages) {
+      print_huge_page_coverage_on(&ls);
+      ls.cr();
+    }
+  }
+}
+
+bool ShenandoahHeap::print_class_histogram_snapshot(outputStream* st) const {
+#if INCLUDE_SERVICES
+  if (_class_histogram != nullptr) {
+    return _class_histogram->print_on(st);
+  }
+#endif
+  return false;
+}
+
+void ShenandoahHeap::print_huge_page_coverage_on(outputStream* out) const {
+  ShenandoahHugePages::print_coverage_on(out, "Heap:", _heap_region.start(), _heap_region.byte_size());
+  ShenandoahHugePages::print_coverage_on(out, "Mark Bitmap:", _bitmap_region.start(), _bitmap_region.byte_size());
+  if (mode()->is_generational()) {
+    ShenandoahCardTable* card_table = ShenandoahBarrierSet::barrier_set()->card_table();
+    // The read and write tables swap roles, report them by address
+    CardTable::CardValue* tables[] = { card_table->read_byte_map(), card_table->write_byte_map() };
+    if (tables[0] > tables[1]) {
+      swap(tables[0], tables[1]);
+    }
+    ShenandoahHugePages::print_coverage_on(out, "Card Table:", tables[0], card_table->byte_map_size());
+    ShenandoahHugePages::print_coverage_on(out, "Card Table:", tables[1], card_table->byte_map_size());
   }
 }
 
@@ -1820,7 +2230,53 @@ private:
   }
 };
 
+// When the marking of the last collection is complete, e.g. right after the full GC before
+// a live heap dump, the objects it found alive, and those allocated since, can be walked
+// region by region instead of tracing the heap again from the roots. Objects that are not
+// marked below TAMS are dead and never looked at, so their stale Klass* pointers do not
+// matter. Workers claim regions one at a time, as the closures this serves, like heap
+// dumping, do much more work per object than the claiming costs.
+class ShenandoahMarkedParallelObjectIterator : public ParallelObjectIteratorImpl {
+private:
+  ShenandoahHeap* const _heap;
+  shenandoah_padding(0);
+  volatile size_t _index;
+  shenandoah_padding(1);
+
+public:
+  ShenandoahMarkedParallelObjectIterator() :
+    _heap(ShenandoahHeap::heap()),
+    _index(0) {
+    assert(SafepointSynchronize::is_at_safepoint(), "safe iteration is only available during safepoints");
+    // The walk past TAMS is size-based, and needs the LABs filled.
+    if (UseTLAB) {
+      _heap->labs_make_parsable();
+    }
+  }
+
+  static bool can_iterate(ShenandoahHeap* heap) {
+    return ShenandoahMarkedObjectIteration &&
+           heap->global_generation()->is_mark_complete() &&
+           !heap->has_forwarded_objects();
+  }
+
+  virtual void object_iterate(ObjectClosure* cl, uint worker_id) {
+    size_t max = _heap->num_regions();
+    for (size_t i = Atomic::fetch_then_add(&_index, (size_t)1, memory_order_relaxed);
+         i < max;
+         i = Atomic::fetch_then_add(&_index, (size_t)1, memory_order_relaxed)) {
+      ShenandoahHeapRegion* r = _heap->get_region(i);
+      if (r->is_active() && !r->is_humongous_continuation()) {
+        _heap->marked_object_iterate(r, cl);
+      }
+    }
+  }
+};
+
 ParallelObjectIteratorImpl* ShenandoahHeap::parallel_object_iterator(uint workers) {
+  if (ShenandoahMarkedParallelObjectIterator::can_iterate(this)) {
+    return new ShenandoahMarkedParallelObjectIterator();
+  }
   return new ShenandoahParallelObjectIterator(workers, &_aux_bit_map);
 }
 
@@ -1842,28 +2298,18 @@ class ShenandoahParallelHeapRegionTask : public WorkerTask {
 private:
   ShenandoahHeap* const _heap;
   ShenandoahHeapRegionClosure* const _blk;
-
-  shenandoah_padding(0);
-  volatile size_t _index;
-  shenandoah_padding(1);
+  ShenandoahRegionClaimer _claimer;
 
 public:
-  ShenandoahParallelHeapRegionTask(ShenandoahHeapRegionClosure* blk) :
+  ShenandoahParallelHeapRegionTask(ShenandoahHeapRegionClosure* blk, uint num_workers) :
           WorkerTask("Shenandoah Parallel Region Operation"),
-          _heap(ShenandoahHeap::heap()), _blk(blk), _index(0) {}
+          _heap(ShenandoahHeap::heap()), _blk(blk), _claimer(_heap->num_regions(), num_workers) {}
 
   void work(uint worker_id) {
     ShenandoahParallelWorkerSession worker_session(worker_id);
-    size_t stride = ShenandoahParallelRegionStride;
-
-    size_t max = _heap->num_regions();
-    while (Atomic::load(&_index) < max) {
-      size_t cur = Atomic::fetch_then_add(&_index, stride, memory_order_relaxed);
-      size_t start = cur;
-      size_t end = MIN2(cur + stride, max);
-      if (start >= max) break;
-
-      for (size_t i = cur; i < end; i++) {
+    size_t begin, end;
+    while (_claimer.claim(&begin, &end)) {
+      for (size_t i = begin; i < end; i++) {
         ShenandoahHeapRegion* current = _heap->get_region(i);
         _blk->heap_region_do(current);
       }
@@ -1874,7 +2320,7 @@ public:
 void ShenandoahHeap::parallel_heap_region_iterate(ShenandoahHeapRegionClosure* blk) const {
   assert(blk->is_thread_safe(), "Only thread-safe closures here");
   if (num_regions() > ShenandoahParallelRegionStride) {
-    ShenandoahParallelHeapRegionTask task(blk);
+    ShenandoahParallelHeapRegionTask task(blk, workers()->active_workers());
     workers()->run_task(&task);
   } else {
     heap_region_iterate(blk);
@@ -1889,13 +2335,17 @@ public:
 
 void ShenandoahHeap::rendezvous_threads() {
   ShenandoahRendezvousClosure cl;
-  Handshake::execute(&cl);
+  ShenandoahHandshake::execute(&cl);
 }
 
 void ShenandoahHeap::recycle_trash() {
   free_set()->recycle_trash();
 }
 
+void ShenandoahHeap::do_deferred_class_unloading_purge() {
+  _unloader.purge_deferred(false /* at_safepoint */);
+}
+
 void ShenandoahHeap::do_class_unloading() {
   _unloader.unload();
   if (mode()->is_generational()) {
@@ -1925,17 +2375,125 @@ void ShenandoahHeap::prepare_update_heap_references(bool concurrent) {
     gclabs_retire(ResizeTLAB);
   }
 
+  prepare_update_refs_iteration();
+}
+
+class ShenandoahInitUpdateRefsHandshakeClosure : public HandshakeClosure {
+private:
+  const char _gc_state;
+
+public:
+  ShenandoahInitUpdateRefsHandshakeClosure(char gc_state) :
+    HandshakeClosure("Shenandoah Init Update Refs"),
+    _gc_state(gc_state) {}
+
+  void do_thread(Thread* thread) {
+    ShenandoahThreadLocalData::set_gc_state(thread, _gc_state);
+    if (UseTLAB) {
+      ShenandoahRetireGCLABClosure cl(ResizeTLAB);
+      cl.do_thread(thread);
+    }
+  }
+};
+
+void ShenandoahHeap::concurrent_prepare_update_heap_references() {
+  assert(!SafepointSynchronize::is_at_safepoint(), "Should not be at safepoint");
+  assert(!ShenandoahVerify, "Verification needs the pause");
+
+  char state;
+  {
+    // Threads that attach from now on pick up the new state, the others get it in the handshake.
+    MutexLocker ml(Threads_lock);
+    _gc_state.set_cond(EVACUATION | WEAK_ROOTS, false);
+    _gc_state.set_cond(UPDATEREFS, true);
+    state = gc_state();
+  }
+
+  // Once every thread has been handshaked, no mutator evacuates anymore and all GCLABs but the
+  // workers' are retired. The workers are idle after evacuation, so theirs can be retired here.
+  ShenandoahInitUpdateRefsHandshakeClosure cl(state);
+  ShenandoahHandshake::execute(&cl);
+  if (UseTLAB) {
+    ShenandoahRetireGCLABClosure wcl(ResizeTLAB);
+    workers()->threads_do(&wcl);
+    if (safepoint_workers() != nullptr) {
+      safepoint_workers()->threads_do(&wcl);
+    }
+  }
+
+  prepare_update_refs_iteration();
+}
+
+void ShenandoahHeap::prepare_update_refs_iteration() {
+  if (ShenandoahUpdateRefsRegionSummary) {
+    _cset_ref_summary = 0;
+    for (size_t i = 0; i < num_regions(); i++) {
+      if (get_region(i)->is_cset()) {
+        _cset_ref_summary |= ShenandoahHeapRegion::ref_summary_bit(i);
+      }
+    }
+  }
+
   _update_refs_iterator.reset();
 }
 
+// Stores the gc state into the thread local data of Java threads, claiming chunks of the
+// thread list. With many threads, the stores miss the cache for nearly every thread, and
+// spreading them over the workers shortens the pause.
+class ShenandoahPropagateGCStateTask : public WorkerTask {
+private:
+  static const uint _chunks_per_worker = 16;
+
+  const ThreadsListHandle _threads;
+  const uint              _length;
+  const uint              _stride;
+  const char              _gc_state;
+  volatile uint           _claimed;
+
+public:
+  ShenandoahPropagateGCStateTask(char gc_state, uint n_workers) :
+    WorkerTask("Shenandoah Propagate GC State"),
+    _threads(),
+    _length(_threads.length()),
+    _stride(MAX2(1u, _length / n_workers / _chunks_per_worker)),
+    _gc_state(gc_state),
+    _claimed(0) {}
+
+  uint length() const { return _length; }
+
+  void work(uint worker_id) {
+    for (uint i = Atomic::fetch_then_add(&_claimed, _stride, memory_order_relaxed);
+         i < _length;
+         i = Atomic::fetch_then_add(&_claimed, _stride, memory_order_relaxed)) {
+      for (uint t = i; t < MIN2(_length, i + _stride); t++) {
+        ShenandoahThreadLocalData::set_gc_state(_threads.thread_at(t), _gc_state);
+      }
+    }
+  }
+};
+
 void ShenandoahHeap::propagate_gc_state_to_java_threads() {
   assert(ShenandoahSafepoint::is_at_shenandoah_safepoint(), "Must be at Shenandoah safepoint");
   if (_gc_state_changed) {
     _gc_state_changed = false;
     char state = gc_state();
-    for (JavaThreadIteratorWithHandle jtiwh; JavaThread *t = jtiwh.next(); ) {
-      ShenandoahThreadLocalData::set_gc_state(t, state);
+    Ticks start = Ticks::now();
+    uint n_workers = workers()->active_workers();
+    uint n_threads = 0;
+    if (ShenandoahParallelGCStatePropagation > 0 && n_workers > 1 &&
+        ThreadsSMRSupport::get_java_thread_list()->length() >= ShenandoahParallelGCStatePropagation) {
+      ShenandoahPropagateGCStateTask task(state, n_workers);
+      workers()->run_task(&task);
+      n_threads = task.length();
+    } else {
+      n_workers = 0;
+      for (JavaThreadIteratorWithHandle jtiwh; JavaThread *t = jtiwh.next(); ) {
+        ShenandoahThreadLocalData::set_gc_state(t, state);
+        n_threads++;
+      }
     }
+    log_debug(gc, safepoint)("Propagated gc state to %u Java threads with %u workers: %.3fms",
+                             n_threads, n_workers, (Ticks::now() - start).seconds() * MILLIUNITS);
   }
 }
 
@@ -2069,10 +2627,15 @@ void ShenandoahHeap::stop() {
 
   // Step 3. Wait until GC worker exits normally.
   control_thread()->stop();
+
+  // Step 4. Write out what the heuristics trace still has buffered.
+  ShenandoahHeuristicsTrace::shutdown();
 }
 
 void ShenandoahHeap::stw_unload_classes(bool full_gc) {
   if (!unload_classes()) return;
+  // A concurrent cycle may have left its unlinked class loader data for later.
+  _unloader.purge_deferred(true /* at_safepoint */);
   ClassUnloadingContext ctx(_workers->active_workers(),
                             true /* unregister_nmethods_during_purge */,
                             false /* lock_codeblob_free_separately */);
@@ -2101,7 +2664,8 @@ void ShenandoahHeap::stw_unload_classes(bool full_gc) {
     ShenandoahGCPhase phase(full_gc ?
                             ShenandoahPhaseTimings::full_gc_purge_cldg :
                             ShenandoahPhaseTimings::degen_gc_purge_cldg);
-    ClassLoaderDataGraph::purge(true /* at_safepoint */);
+    ClassLoaderDataGraph::purge(true /* at_safepoint */,
+                                ShenandoahParallelClassLoaderDataPurge ? workers() : nullptr);
   }
   // Resize and verify metaspace
   MetaspaceGC::compute_new_size();
@@ -2169,6 +2733,23 @@ address ShenandoahHeap::in_cset_fast_test_addr() {
   return (address) heap->collection_set()->biased_map_address();
 }
 
+address ShenandoahHeap::affiliations_biased_addr() {
+  ShenandoahHeap* heap = ShenandoahHeap::heap();
+  assert(heap->_affiliations != nullptr, "Sanity");
+  // Only ever indexed with heap addresses, so the bias does not need a zero page like the cset map
+  return (address) (heap->_affiliations - ((uintx) heap->base() >> ShenandoahHeapRegion::region_size_bytes_shift()));
+}
+
+address ShenandoahHeap::mark_bit_map_biased_addr() {
+  ShenandoahHeap* heap = ShenandoahHeap::heap();
+  assert(heap->marking_context() != nullptr, "Sanity");
+  return (address) heap->marking_context()->mark_bit_map()->biased_map_address();
+}
+
+int ShenandoahHeap::mark_bit_map_index_shift() {
+  return ShenandoahHeap::heap()->marking_context()->mark_bit_map()->address_to_index_shift();
+}
+
 void ShenandoahHeap::reset_bytes_allocated_since_gc_start() {
   if (mode()->is_generational()) {
     young_generation()->reset_bytes_allocated_since_gc_start();
@@ -2204,7 +2785,11 @@ void ShenandoahHeap::unregister_nmethod(nmethod* nm) {
 }
 
 void ShenandoahHeap::pin_object(JavaThread* thr, oop o) {
-  heap_region_containing(o)->record_pin();
+  ShenandoahHeapRegion* r = heap_region_containing(o);
+  if (ShenandoahEvacuatePinnedRegions && !r->is_humongous()) {
+    r->record_pinned_object(cast_from_oop<HeapWord*>(o), o->size());
+  }
+  r->record_pin();
 }
 
 void ShenandoahHeap::unpin_object(JavaThread* thr, oop o) {
@@ -2273,14 +2858,16 @@ void ShenandoahHeap::finish_concurrent_roots() {
 void ShenandoahHeap::assert_gc_workers(uint nworkers) {
   assert(nworkers > 0 && nworkers <= max_workers(), "Sanity");
 
+  // Fewer workers are used while the CPU quota is below the one at startup, and
+  // adaptive phases may use up to all of them.
   if (ShenandoahSafepoint::is_at_shenandoah_safepoint()) {
     // Use ParallelGCThreads inside safepoints
-    assert(nworkers == ParallelGCThreads, "Use ParallelGCThreads (%u) within safepoint, not %u",
-           ParallelGCThreads, nworkers);
+    assert(nworkers <= ParallelGCThreads || ShenandoahAdaptiveWorkers,
+           "Use ParallelGCThreads (%u) within safepoint, not %u", ParallelGCThreads, nworkers);
   } else {
     // Use ConcGCThreads outside safepoints
-    assert(nworkers == ConcGCThreads, "Use ConcGCThreads (%u) outside safepoints, %u",
-           ConcGCThreads, nworkers);
+    assert(nworkers <= ConcGCThreads || ShenandoahAdaptiveWorkers,
+           "Use ConcGCThreads (%u) outside safepoints, %u", ConcGCThreads, nworkers);
   }
 }
 #endif
@@ -2291,6 +2878,22 @@ ShenandoahVerifier* ShenandoahHeap::verifier() {
   return _verifier;
 }
 
+// Visits the fields of the objects that evacuation left in place in a collection set region.
+template <class T>
+class ShenandoahRetainedObjectsOopClosure : public ObjectClosure {
+private:
+  T* const _cl;
+
+public:
+  ShenandoahRetainedObjectsOopClosure(T* cl) : _cl(cl) {}
+
+  void do_object(oop obj) {
+    if (!obj->is_forwarded()) {
+      obj->oop_iterate(_cl);
+    }
+  }
+};
+
 template<bool CONCURRENT>
 class ShenandoahUpdateHeapRefsTask : public WorkerTask {
 private:
@@ -2320,7 +2923,7 @@ private:
     if (CONCURRENT && (worker_id == 0)) {
       // We ask the first worker to replenish the Mutator free set by moving regions previously reserved to hold the
       // results of evacuation.  These reserves are no longer necessary because evacuation has completed.
-      size_t cset_regions = _heap->collection_set()->count();
+      size_t cset_regions = _heap->collection_set()->count() - _heap->collection_set()->pinned_count();
       // We cannot transfer any more regions than will be reclaimed when the existing collection set is recycled, because
       // we need the reclaimed collection set regions to replenish the collector reserves
       _heap->free_set()->move_collector_sets_to_mutator(cset_regions);
@@ -2331,8 +2934,16 @@ private:
     while (r != nullptr) {
       HeapWord* update_watermark = r->get_update_watermark();
       assert (update_watermark >= r->bottom(), "sanity");
-      if (r->is_active() && !r->is_cset()) {
-        _heap->marked_object_oop_iterate(r, &cl, update_watermark);
+      if (ShenandoahEvacuatePinnedRegions && r->is_cset() && r->has_pinned_range()) {
+        // Objects left in place by evacuation stay around after the cycle.
+        ShenandoahRetainedObjectsOopClosure<T> ocl(&cl);
+        _heap->marked_object_iterate(r, &ocl);
+      } else if (r->is_active() && !r->is_cset()) {
+        if (ShenandoahUpdateRefsRegionSummary && !r->is_humongous() && !_heap->marked_objects_may_refer_to_cset(r)) {
+          _heap->objects_above_tams_oop_iterate(r, &cl, update_watermark);
+        } else {
+          _heap->marked_object_oop_iterate(r, &cl, update_watermark);
+        }
         if (ShenandoahPacing) {
           _heap->pacer()->report_updaterefs(pointer_delta(update_watermark, r->bottom()));
         }
@@ -2491,7 +3102,7 @@ bool ShenandoahHeap::commit_bitmap_slice(ShenandoahHeapRegion* r) {
   size_t len = _bitmap_bytes_per_slice;
   char* start = (char*) _bitmap_region.start() + off;
 
-  if (!os::commit_memory(start, len, false)) {
+  if (!os::commit_memory(start, len, _bitmap_page_size, false)) {
     return false;
   }
 
@@ -2587,33 +3198,38 @@ bool ShenandoahRegionIterator::has_next() const {
   return _index < _heap->num_regions();
 }
 
+ShenandoahRegionClaimer::ShenandoahRegionClaimer(size_t num_regions, uint num_workers) :
+  _num_regions(num_regions),
+  _num_workers(MAX2(num_workers, 1u)),
+  _min_stride(MIN2(ShenandoahParallelRegionMinStride, ShenandoahParallelRegionStride)),
+  _max_stride(ShenandoahParallelRegionStride),
+  _index(0) {}
+
 char ShenandoahHeap::gc_state() const {
   return _gc_state.raw_value();
 }
 
-ShenandoahLiveData* ShenandoahHeap::get_liveness_cache(uint worker_id) {
-#ifdef ASSERT
+ShenandoahLivenessCache* ShenandoahHeap::get_liveness_cache(uint worker_id) {
   assert(_liveness_cache != nullptr, "sanity");
-  assert(worker_id < _max_workers, "sanity");
-  for (uint i = 0; i < num_regions(); i++) {
-    assert(_liveness_cache[worker_id][i] == 0, "liveness cache should be empty");
-  }
-#endif
+  assert(worker_id < _max_workers + mark_assist_queues(), "sanity");
+  assert(_liveness_cache[worker_id]->is_empty(), "liveness cache should be empty");
   return _liveness_cache[worker_id];
 }
 
 void ShenandoahHeap::flush_liveness_cache(uint worker_id) {
-  assert(worker_id < _max_workers, "sanity");
+  assert(worker_id < _max_workers + mark_assist_queues(), "sanity");
   assert(_liveness_cache != nullptr, "sanity");
-  ShenandoahLiveData* ld = _liveness_cache[worker_id];
-  for (uint i = 0; i < num_regions(); i++) {
-    ShenandoahLiveData live = ld[i];
-    if (live > 0) {
-      ShenandoahHeapRegion* r = get_region(i);
-      r->increase_live_data_gc_words(live);
-      ld[i] = 0;
-    }
+  _liveness_cache[worker_id]->flush(this);
+}
+
+uint ShenandoahHeap::mark_assist_queues() const {
+  // Assisting threads mark for the non-generational global generation only. They do not
+  // sample the class histogram, which is kept per worker.
+  if (!ShenandoahMarkAssist || !ShenandoahPacing ||
+      mode()->is_generational() || ShenandoahMarkingClassHistogram) {
+    return 0;
   }
+  return (uint) ShenandoahMarkAssistQueues;
 }
 
 bool ShenandoahHeap::requires_barriers(stackChunkOop obj) const {
@@ -2628,12 +3244,102 @@ bool ShenandoahHeap::requires_barriers(stackChunkOop obj) const {
 
   // Can not guarantee obj is deeply good.
   if (has_forwarded_objects()) {
+    // Once evacuation has completed, every frame copied into a chunk has had its oops
+    // processed by the stack watermark first, so only to-space references get frozen into
+    // it. A chunk allocated above its region's update watermark then stays deeply good:
+    // update-refs does not visit it, and it never held an unprocessed reference.
+    // Java threads go by their own gc state, which only changes in the init-update-refs
+    // handshake, so the answer is stable across a freeze or thaw.
+    Thread* const thread = Thread::current();
+    const char state = thread->is_Java_thread() ? ShenandoahThreadLocalData::gc_state(thread) : gc_state();
+    if ((state & (EVACUATION | UPDATEREFS)) == UPDATEREFS && !SafepointSynchronize::is_at_safepoint()) {
+      ShenandoahHeapRegion* r = heap_region_containing(obj);
+      return cast_from_oop<HeapWord*>(obj) < r->get_update_watermark();
+    }
     return true;
   }
 
   return false;
 }
 
+HeapWord* ShenandoahHeap::allocate_loaded_archive_space(size_t size) {
+#if INCLUDE_CDS_JAVA_HEAP
+  // CDS wants one contiguous range to copy archived objects into. This bypasses the
+  // normal allocation paths, and the result must still look like regular allocation
+  // to the rest of GC.
+  //
+  // CDS guarantees that no object straddles a MIN_GC_REGION_ALIGNMENT boundary, so with
+  // regions at least that large every object lies within a single region. With smaller
+  // regions, let CDS fall back to not using the archived heap.
+  if (ShenandoahHeapRegion::region_size_bytes() < ArchiveHeapWriter::MIN_GC_REGION_ALIGNMENT) {
+    return nullptr;
+  }
+
+  // The range is allocated as young (or global) memory, like any other mutator
+  // allocation. In generational mode, the fully live regions age and are later
+  // promoted in place, which registers their objects in the remembered set.
+  ShenandoahAllocRequest req = ShenandoahAllocRequest::for_shared(size);
+  HeapWord* mem = allocate_memory(req);
+  if (mem == nullptr || size <= ShenandoahHeapRegion::humongous_threshold_words()) {
+    return mem;
+  }
+
+  // A large range comes back as a humongous object. It holds many objects instead,
+  // so flip its regions to regular; the trailing region keeps its partial top.
+  size_t start_idx = heap_region_index_containing(mem);
+  size_t num_regions = ShenandoahHeapRegion::required_regions(size * HeapWordSize);
+  {
+    ShenandoahHeapLocker locker(lock());
+    for (size_t c = start_idx; c < start_idx + num_regions; c++) {
+      get_region(c)->make_regular_bypass();
+    }
+  }
+  return mem;
+#else
+  assert(false, "Archive heap loader should not be available, should not be here");
+  return nullptr;
+#endif // INCLUDE_CDS_JAVA_HEAP
+}
+
+void ShenandoahHeap::complete_loaded_archive_space(MemRegion archive_space) {
+  // Archived objects are loaded before the first cycle, so they are all above TAMS and
+  // implicitly live.
+  HeapWord* start = archive_space.start();
+  HeapWord* end = archive_space.end();
+
+  if (mode()->is_generational() && start < end) {
+    // Archived objects live as long as the VM. Let the first young cycle promote their
+    // regions in place, instead of marking them young for many cycles until they age.
+    // A region that shares its space with later allocations has its age reset by the
+    // first cycle, like any other region allocated into during the cycle.
+    size_t begin_idx = heap_region_index_containing(start);
+    size_t end_idx = heap_region_index_containing(end - 1);
+    for (size_t c = begin_idx; c <= end_idx; c++) {
+      get_region(c)->set_max_age();
+    }
+  }
+
+#ifdef ASSERT
+  assert(!is_concurrent_mark_in_progress(), "Archived objects must be loaded before marking");
+
+  // No unclaimed space between the objects, and the objects are in the correct regions.
+  HeapWord* cur = start;
+  while (cur < end) {
+    oop obj = cast_to_oop(cur);
+    shenandoah_assert_in_correct_region(nullptr, obj);
+    cur += obj->size();
+  }
+  assert(cur == end, "Archive space should be fully used: " PTR_FORMAT " " PTR_FORMAT, p2i(cur), p2i(end));
+
+  // All covered regions are regular.
+  ShenandoahHeapRegion* begin_reg = heap_region_containing(start);
+  ShenandoahHeapRegion* end_reg = heap_region_containing(end - 1);
+  for (size_t c = begin_reg->index(); c <= end_reg->index(); c++) {
+    assert(get_region(c)->is_regular(), "Region " SIZE_FORMAT " should be regular", c);
+  }
+#endif
+}
+
 ShenandoahGeneration* ShenandoahHeap::generation_for(ShenandoahAffiliation affiliation) const {
   if (!mode()->is_generational()) {
     return global_generation();
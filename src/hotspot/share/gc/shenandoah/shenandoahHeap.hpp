@@ -32,6 +32,7 @@
 #include "gc/shared/collectedHeap.hpp"
 #include "gc/shenandoah/heuristics/shenandoahSpaceInfo.hpp"
 #include "gc/shenandoah/shenandoahAllocRequest.hpp"
+#include "gc/shenandoah/shenandoahAllocationSpikeDetector.hpp"
 #include "gc/shenandoah/shenandoahAsserts.hpp"
 #include "gc/shenandoah/shenandoahController.hpp"
 #include "gc/shenandoah/shenandoahLock.hpp"
@@ -43,6 +44,7 @@
 #include "gc/shenandoah/mode/shenandoahMode.hpp"
 #include "gc/shenandoah/shenandoahPadding.hpp"
 #include "gc/shenandoah/shenandoahSharedVariables.hpp"
+#include "gc/shenandoah/shenandoahSoftMaxController.hpp"
 #include "gc/shenandoah/shenandoahUnload.hpp"
 #include "memory/metaspace.hpp"
 #include "services/memoryManager.hpp"
@@ -51,6 +53,7 @@
 
 class ConcurrentGCTimer;
 class ObjectIterateScanRootClosure;
+class ShenandoahClassHistogram;
 class ShenandoahCollectorPolicy;
 class ShenandoahGCSession;
 class ShenandoahGCStateResetter;
@@ -64,27 +67,21 @@ class ShenandoahPhaseTimings;
 class ShenandoahHeap;
 class ShenandoahHeapRegion;
 class ShenandoahHeapRegionClosure;
+class ShenandoahLivenessCache;
 class ShenandoahCollectionSet;
 class ShenandoahFreeSet;
 class ShenandoahConcurrentMark;
+class ShenandoahCycleHistory;
 class ShenandoahFullGC;
 class ShenandoahMonitoringSupport;
+class ShenandoahNUMA;
 class ShenandoahPacer;
 class ShenandoahReferenceProcessor;
+class ShenandoahSplitCopier;
 class ShenandoahVerifier;
 class ShenandoahWorkerThreads;
 class VMStructs;
 
-// Used for buffering per-region liveness data.
-// Needed since ShenandoahHeapRegion uses atomics to update liveness.
-// The ShenandoahHeap array has max-workers elements, each of which is an array of
-// uint16_t * max_regions. The choice of uint16_t is not accidental:
-// there is a tradeoff between static/dynamic footprint that translates
-// into cache pressure (which is already high during marking), and
-// too many atomic updates. uint32_t is too large, uint8_t is too small.
-typedef uint16_t ShenandoahLiveData;
-#define SHENANDOAH_LIVEDATA_MAX ((ShenandoahLiveData)-1)
-
 class ShenandoahRegionIterator : public StackObj {
 private:
   ShenandoahHeap* _heap;
@@ -112,6 +109,31 @@ public:
   bool has_next() const;
 };
 
+// Hands out ranges of region indices to parallel workers with guided scheduling. Each claim takes
+// a share of the regions left, between ShenandoahParallelRegionMinStride and ShenandoahParallelRegionStride,
+// so that claims are coarse while much work is left, and fine towards the end of the phase, when the
+// remaining work has to be balanced between workers.
+class ShenandoahRegionClaimer : public StackObj {
+private:
+  const size_t _num_regions;
+  const uint   _num_workers;
+  const size_t _min_stride;
+  const size_t _max_stride;
+
+  shenandoah_padding(0);
+  volatile size_t _index;
+  shenandoah_padding(1);
+
+  NONCOPYABLE(ShenandoahRegionClaimer);
+
+public:
+  ShenandoahRegionClaimer(size_t num_regions, uint num_workers);
+
+  // Claims the next range [*begin, *end). Returns false when all regions have been claimed.
+  // This is multi-thread-safe.
+  inline bool claim(size_t* begin, size_t* end);
+};
+
 class ShenandoahHeapRegionClosure : public StackObj {
 public:
   virtual void heap_region_do(ShenandoahHeapRegion* r) = 0;
@@ -193,6 +215,7 @@ public:
   void print_on(outputStream* st)              const override;
   void print_extended_on(outputStream *st)     const override;
   void print_tracing_info()                    const override;
+  bool print_class_histogram_snapshot(outputStream* st) const override;
   void print_heap_regions_on(outputStream* st) const;
 
   void stop() override;
@@ -291,6 +314,8 @@ public:
   void parallel_heap_region_iterate(ShenandoahHeapRegionClosure* blk) const;
 
   inline ShenandoahMmuTracker* mmu_tracker() { return &_mmu_tracker; };
+  ShenandoahAllocationSpikeDetector* alloc_spike_detector() { return &_alloc_spike_detector; }
+  ShenandoahSoftMaxController* soft_max_controller() { return &_soft_max_controller; }
 
 // ---------- GC state machinery
 //
@@ -443,6 +468,43 @@ protected:
   // also used in shGenerationalHeap, which uses a different closure for update refs.
   ShenandoahRegionIterator _update_refs_iterator;
 
+  // Union of the region reference summary bits of the collection set regions, and whether the
+  // region reference summaries are exact, see ShenandoahUpdateRefsRegionSummary.
+  uintx _cset_ref_summary;
+  bool _ref_summary_exact;
+
+  virtual void prepare_update_heap_references(bool concurrent);
+
+  // Like prepare_update_heap_references() followed by the switch of the gc state from evacuation
+  // to update-refs, but without a pause: threads get the new state and retire their GCLABs in a
+  // handshake. Used for small collection sets, see ShenandoahFuseUpdateRefsCSetRegions.
+  void concurrent_prepare_update_heap_references();
+
+  // Everything that prepares the update-refs iteration itself, once GCLABs are retired.
+  virtual void prepare_update_refs_iteration();
+
+public:
+  // Marking ran entirely in this pause, so no mutator has stored into the reference fields it visited.
+  void set_ref_summary_exact(bool exact) { _ref_summary_exact = exact; }
+
+  // Returns false if no marked object of the region below TAMS can refer to the collection set,
+  // so that update-refs only needs to visit the objects allocated since mark start.
+  inline bool marked_objects_may_refer_to_cset(ShenandoahHeapRegion* r) const;
+
+  // Weak OopStorage blocks whose entries all refer to old objects outside the collection set
+  // are recorded as settled, and skipped by concurrent weak root processing of young cycles.
+  // See ShenandoahSettledWeakRoots.
+private:
+  bool _notes_weak_root_stores;
+  uintx _settled_weak_roots_epoch;
+
+public:
+  bool notes_weak_root_stores() const    { return _notes_weak_root_stores; }
+  uintx settled_weak_roots_epoch() const { return _settled_weak_roots_epoch; }
+  // Forgets all settled blocks. Called whenever objects may change generation or move without
+  // the weak roots being processed concurrently, i.e. by degenerated and full GC.
+  void invalidate_settled_weak_roots();
+
 private:
   // GC support
   // Evacuation
@@ -452,8 +514,9 @@ private:
   void finish_concurrent_roots();
   // Concurrent class unloading support
   void do_class_unloading();
+  bool has_deferred_class_unloading_purge() const { return _unloader.has_deferred_purge(); }
+  void do_deferred_class_unloading_purge();
   // Reference updating
-  void prepare_update_heap_references(bool concurrent);
   virtual void update_heap_references(bool concurrent);
   // Final update region states
   void update_heap_region_states(bool concurrent);
@@ -484,10 +547,15 @@ private:
   ShenandoahFreeSet*         _free_set;
   ShenandoahPacer*           _pacer;
   ShenandoahVerifier*        _verifier;
+  ShenandoahNUMA*            _numa;
+  ShenandoahSplitCopier*     _split_copier;
 
   ShenandoahPhaseTimings*       _phase_timings;
   ShenandoahEvacuationTracker*  _evac_tracker;
+  ShenandoahCycleHistory*       _cycle_history;
   ShenandoahMmuTracker          _mmu_tracker;
+  ShenandoahAllocationSpikeDetector _alloc_spike_detector;
+  ShenandoahSoftMaxController   _soft_max_controller;
 
 public:
   ShenandoahController*   control_thread() { return _control_thread; }
@@ -509,9 +577,12 @@ public:
   ShenandoahMode*            mode()              const { return _gc_mode;           }
   ShenandoahFreeSet*         free_set()          const { return _free_set;          }
   ShenandoahPacer*           pacer()             const { return _pacer;             }
+  ShenandoahNUMA*            numa()              const { return _numa;              }
+  ShenandoahSplitCopier*     split_copier()      const { return _split_copier;      }
 
   ShenandoahPhaseTimings*      phase_timings()   const { return _phase_timings;     }
   ShenandoahEvacuationTracker* evac_tracker()    const { return _evac_tracker;      }
+  ShenandoahCycleHistory*      cycle_history()   const { return _cycle_history;     }
 
   ShenandoahEvacOOMHandler* oom_evac_handler() { return &_oom_evac_handler; }
 
@@ -611,6 +682,13 @@ public:
   // Keep alive an object that was loaded with AS_NO_KEEPALIVE.
   void keep_alive(oop obj) override;
 
+// ---------- CDS archived heap support
+//
+public:
+  bool can_load_archived_objects() const override { return UseCompressedOops; }
+  HeapWord* allocate_loaded_archive_space(size_t size) override;
+  void complete_loaded_archive_space(MemRegion archive_space) override;
+
 // ---------- Safepoint interface hooks
 //
 public:
@@ -648,10 +726,12 @@ private:
   HeapWord* allocate_memory_under_lock(ShenandoahAllocRequest& request, bool& in_new_region);
   HeapWord* allocate_from_gclab_slow(Thread* thread, size_t size);
   HeapWord* allocate_new_gclab(size_t min_size, size_t word_size, size_t* actual_size);
+  static void prepare_gclab_buffer(HeapWord* buf, size_t word_size);
 
 public:
   HeapWord* allocate_memory(ShenandoahAllocRequest& request);
   HeapWord* mem_allocate(size_t size, bool* what) override;
+  bool is_zeroed_allocation(HeapWord* mem) const override;
   MetaWord* satisfy_failed_metadata_allocation(ClassLoaderData* loader_data,
                                                size_t size,
                                                Metaspace::MetadataType mdtype) override;
@@ -661,6 +741,7 @@ public:
   HeapWord* allocate_new_tlab(size_t min_size, size_t requested_size, size_t* actual_size) override;
   size_t tlab_capacity(Thread *thr) const override;
   size_t unsafe_max_tlab_alloc(Thread *thread) const override;
+  size_t adjust_tlab_size(Thread* thr, size_t desired_size) const override;
   size_t max_tlab_size() const override;
   size_t tlab_used(Thread* ignored) const override;
 
@@ -670,6 +751,10 @@ public:
   void tlabs_retire(bool resize);
   void gclabs_retire(bool resize);
 
+  // Hand every Java thread a GCLAB of ShenandoahPrefilledGCLABSize words, all allocated under
+  // a single acquisition of the heap lock, before mutators start evacuating in the LRB slow path.
+  void prefill_mutator_gclabs();
+
 // ---------- Marking support
 //
 private:
@@ -686,12 +771,23 @@ private:
   size_t _pretouch_heap_page_size;
   size_t _pretouch_bitmap_page_size;
 
+  // Page sizes the heap and the bitmaps are committed with. Regions and bitmap slices are
+  // committed one by one with these as the alignment hint, so that they are advised for
+  // transparent huge pages like the initial commit.
+  size_t _heap_page_size;
+  size_t _bitmap_page_size;
+
   bool _bitmap_region_special;
   bool _aux_bitmap_region_special;
 
-  ShenandoahLiveData** _liveness_cache;
+  ShenandoahLivenessCache** _liveness_cache;
+
+  // See ShenandoahMarkingClassHistogram.
+  ShenandoahClassHistogram* _class_histogram;
 
 public:
+  ShenandoahClassHistogram* class_histogram() const { return _class_histogram; }
+
   inline ShenandoahMarkingContext* complete_marking_context() const;
   inline ShenandoahMarkingContext* marking_context() const;
 
@@ -704,6 +800,10 @@ public:
   template<class T>
   inline void marked_object_oop_iterate(ShenandoahHeapRegion* region, T* cl, HeapWord* limit);
 
+  // Iterate the oops of the objects allocated in a regular region since mark start, up to limit.
+  template<class T>
+  inline void objects_above_tams_oop_iterate(ShenandoahHeapRegion* region, T* cl, HeapWord* limit);
+
   // SATB barriers hooks
   inline bool requires_marking(const void* entry) const;
 
@@ -712,11 +812,18 @@ public:
   bool uncommit_bitmap_slice(ShenandoahHeapRegion *r);
   bool is_bitmap_slice_committed(ShenandoahHeapRegion* r, bool skip_self = false);
 
-  // Liveness caching support
-  ShenandoahLiveData* get_liveness_cache(uint worker_id);
+  // Liveness caching support. Marking assist queues have their caches after the workers' ones.
+  ShenandoahLivenessCache* get_liveness_cache(uint worker_id);
   void flush_liveness_cache(uint worker_id);
 
+  // Number of marking queues lent to allocating threads, see ShenandoahMarkAssist
+  uint mark_assist_queues() const;
+
   size_t pretouch_heap_page_size() { return _pretouch_heap_page_size; }
+  size_t heap_page_size() const    { return _heap_page_size; }
+
+  // How much of the heap, the bitmaps and the card tables is backed by huge pages
+  void print_huge_page_coverage_on(outputStream* out) const;
 
 // ---------- Evacuation support
 //
@@ -725,9 +832,19 @@ private:
   ShenandoahEvacOOMHandler _oom_evac_handler;
 
   oop try_evacuate_object(oop src, Thread* thread, ShenandoahHeapRegion* from_region, ShenandoahAffiliation target_gen);
+
+protected:
+  // Copies the object for evacuation. GC workers copy large objects cooperatively with the split copier.
+  void copy_for_evacuation(Thread* thread, HeapWord* from, HeapWord* to, size_t size);
+
 public:
 
   static address in_cset_fast_test_addr();
+  // Affiliations indexed by (address >> region shift), for barriers that filter on the generation.
+  static address affiliations_biased_addr();
+  // Mark bitmap words, see ShenandoahMarkBitMap::biased_map_address(), for barriers that test marks.
+  static address mark_bit_map_biased_addr();
+  static int mark_bit_map_index_shift();
 
   ShenandoahCollectionSet* collection_set() const { return _collection_set; }
 
@@ -737,6 +854,9 @@ public:
   // Checks if location is in the collection set. Can be interior pointer, not the oop itself.
   inline bool in_collection_set_loc(void* loc) const;
 
+  // Checks if location is in an object that evacuation leaves in place, see ShenandoahEvacuatePinnedRegions.
+  inline bool is_pinned_in_place(const void* loc) const;
+
   // Evacuates or promotes object src. Returns the evacuated object, either evacuated
   // by this thread, or by some other thread.
   virtual oop evacuate_object(oop src, Thread* thread);
@@ -751,6 +871,10 @@ public:
   template <class T>
   inline void conc_update_with_forwarded(T* p);
 
+  // Same as above, for a location p that was seen to hold obj, a collection set object
+  template <class T>
+  inline void conc_update_with_forwarded(T* p, oop obj);
+
   template <class T>
   inline void update_with_forwarded(T* p);
 
@@ -779,6 +903,7 @@ public:
 
 private:
   void trash_cset_regions();
+  void retain_pinned_objects(ShenandoahHeapRegion* r);
 
 // ---------- Testing helpers functions
 //
@@ -64,6 +64,23 @@ inline ShenandoahHeapRegion* ShenandoahRegionIterator::next() {
   return _heap->get_region(new_index - 1);
 }
 
+inline bool ShenandoahRegionClaimer::claim(size_t* begin, size_t* end) {
+  size_t cur = Atomic::load(&_index);
+  while (cur < _num_regions) {
+    size_t stride = (_num_regions - cur) / (2 * _num_workers);
+    stride = clamp(stride, _min_stride, _max_stride);
+    size_t next = MIN2(cur + stride, _num_regions);
+    size_t witness = Atomic::cmpxchg(&_index, cur, next, memory_order_relaxed);
+    if (witness == cur) {
+      *begin = cur;
+      *end = next;
+      return true;
+    }
+    cur = witness;
+  }
+  return false;
+}
+
 inline bool ShenandoahHeap::has_forwarded_objects() const {
   return _gc_state.is_set(HAS_FORWARDED);
 }
@@ -135,24 +152,30 @@ inline void ShenandoahHeap::conc_update_with_forwarded(T* p) {
   if (!CompressedOops::is_null(o)) {
     oop obj = CompressedOops::decode_not_null(o);
     if (in_collection_set(obj)) {
-      // Corner case: when evacuation fails, there are objects in collection
-      // set that are not really forwarded. We can still go and try CAS-update them
-      // (uselessly) to simplify the common path.
-      shenandoah_assert_forwarded_except(p, obj, cancelled_gc());
-      oop fwd = ShenandoahBarrierSet::resolve_forwarded_not_null(obj);
-      shenandoah_assert_not_in_cset_except(p, fwd, cancelled_gc());
-
-      // Sanity check: we should not be updating the cset regions themselves,
-      // unless we are recovering from the evacuation failure.
-      shenandoah_assert_not_in_cset_loc_except(p, !is_in(p) || cancelled_gc());
-
-      // Either we succeed in updating the reference, or something else gets in our way.
-      // We don't care if that is another concurrent GC update, or another mutator update.
-      atomic_update_oop(fwd, p, obj);
+      conc_update_with_forwarded(p, obj);
     }
   }
 }
 
+template <class T>
+inline void ShenandoahHeap::conc_update_with_forwarded(T* p, oop obj) {
+  // Corner case: when evacuation fails, there are objects in collection
+  // set that are not really forwarded. We can still go and try CAS-update them
+  // (uselessly) to simplify the common path.
+  shenandoah_assert_forwarded_except(p, obj, cancelled_gc());
+  oop fwd = ShenandoahBarrierSet::resolve_forwarded_not_null(obj);
+  shenandoah_assert_not_in_cset_except(p, fwd, cancelled_gc());
+
+  // Sanity check: we should not be updating the cset regions themselves,
+  // unless we are recovering from the evacuation failure.
+  shenandoah_assert_not_in_cset_loc_except(p, !is_in(p) || cancelled_gc());
+
+  // Either we succeed in updating the reference, or something else gets in our way.
+  // We don't care if that is another concurrent GC update, or another mutator update.
+  // If the location was changed since obj was seen there, the update fails.
+  atomic_update_oop(fwd, p, obj);
+}
+
 // Atomic updates of heap location. This is only expected to work with updating the same
 // logical object with its forwardee. The reason why we need stronger-than-relaxed memory
 // ordering has to do with coordination with GC barriers and mutator accesses.
@@ -448,6 +471,10 @@ inline bool ShenandoahHeap::in_collection_set_loc(void* p) const {
   return collection_set()->is_in_loc(p);
 }
 
+inline bool ShenandoahHeap::is_pinned_in_place(const void* p) const {
+  return ShenandoahEvacuatePinnedRegions && heap_region_containing(p)->is_in_pinned_range(p);
+}
+
 
 inline bool ShenandoahHeap::is_stable() const {
   return _gc_state.is_clear();
@@ -633,6 +660,29 @@ inline void ShenandoahHeap::marked_object_oop_iterate(ShenandoahHeapRegion* regi
   }
 }
 
+template<class T>
+inline void ShenandoahHeap::objects_above_tams_oop_iterate(ShenandoahHeapRegion* region, T* cl, HeapWord* limit) {
+  assert(!region->is_humongous(), "no humongous regions here");
+  HeapWord* cs = marking_context()->top_at_mark_start(region);
+  while (cs < limit) {
+    oop obj = cast_to_oop(cs);
+    assert(oopDesc::is_oop(obj), "sanity");
+    size_t size = obj->size();
+    obj->oop_iterate(cl);
+    cs += size;
+  }
+}
+
+inline bool ShenandoahHeap::marked_objects_may_refer_to_cset(ShenandoahHeapRegion* r) const {
+  uintx summary = r->ref_summary();
+  if (_ref_summary_exact) {
+    return (summary & _cset_ref_summary) != 0;
+  }
+  // Mutators may have stored any reference into the fields that concurrent marking visited,
+  // so only regions without reference fields can be trusted.
+  return summary != 0;
+}
+
 inline ShenandoahHeapRegion* ShenandoahHeap::get_region(size_t region_idx) const {
   if (region_idx < _num_regions) {
     return _regions[region_idx];
@@ -34,6 +34,8 @@
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahHeapRegion.hpp"
 #include "gc/shenandoah/shenandoahMarkingContext.inline.hpp"
+#include "gc/shenandoah/shenandoahMonitoringSupport.hpp"
+#include "gc/shenandoah/shenandoahNUMA.hpp"
 #include "gc/shenandoah/shenandoahOldGeneration.hpp"
 #include "gc/shenandoah/shenandoahGeneration.hpp"
 #include "gc/shenandoah/shenandoahYoungGeneration.hpp"
@@ -79,6 +81,12 @@ ShenandoahHeapRegion::ShenandoahHeapRegion(HeapWord* start, size_t index, bool c
   _plab_allocs(0),
   _live_data(0),
   _critical_pins(0),
+  _pinned_bottom(nullptr),
+  _pinned_top(nullptr),
+  _ref_summary(0),
+  _access_samples(0),
+  _lazily_uncommitted(false),
+  _zeroed(committed && !ZapUnusedHeapArea),  // Freshly committed by the heap
   _update_watermark(start),
   _age(0)
 #ifdef SHENANDOAH_CENSUS_NOISE
@@ -149,8 +157,10 @@ void ShenandoahHeapRegion::make_young_maybe() {
 
 void ShenandoahHeapRegion::make_regular_bypass() {
   shenandoah_assert_heaplocked();
-  assert (ShenandoahHeap::heap()->is_full_gc_in_progress() || ShenandoahHeap::heap()->is_degenerated_gc_in_progress(),
-          "only for full or degen GC");
+  assert (!Universe::is_fully_initialized() ||
+          ShenandoahHeap::heap()->is_full_gc_in_progress() ||
+          ShenandoahHeap::heap()->is_degenerated_gc_in_progress(),
+          "only for full or degen GC, or when Universe is initializing (CDS)");
   reset_age();
   switch (_state) {
     case _empty_uncommitted:
@@ -265,6 +275,7 @@ void ShenandoahHeapRegion::make_unpinned() {
   switch (_state) {
     case _pinned:
       assert(is_affiliated(), "Pinned region should be affiliated");
+      clear_pinned_range();
       set_state(_regular);
       return;
     case _regular:
@@ -284,16 +295,40 @@ void ShenandoahHeapRegion::make_unpinned() {
 void ShenandoahHeapRegion::make_cset() {
   shenandoah_assert_heaplocked();
   // Leave age untouched.  We need to consult the age when we are deciding whether to promote evacuated objects.
+  if (pin_count() == 0) {
+    // At safepoint, nothing can be pinned in this region until it is evacuated.
+    clear_pinned_range();
+  }
   switch (_state) {
     case _regular:
       set_state(_cset);
     case _cset:
       return;
+    case _pinned:
+      assert(ShenandoahEvacuatePinnedRegions, "Only with pinned region evacuation");
+      set_state(_pinned_cset);
+      return;
     default:
       report_illegal_transition("cset");
   }
 }
 
+void ShenandoahHeapRegion::make_retained() {
+  shenandoah_assert_heaplocked();
+  assert(ShenandoahEvacuatePinnedRegions, "Only with pinned region evacuation");
+  // Evacuation is over, but the objects it left in place keep the region around.
+  switch (_state) {
+    case _cset:
+      set_state(_regular);
+      return;
+    case _pinned_cset:
+      set_state(_pinned);
+      return;
+    default:
+      report_illegal_transition("retained");
+  }
+}
+
 void ShenandoahHeapRegion::make_trash() {
   shenandoah_assert_heaplocked();
   reset_age();
@@ -356,15 +391,35 @@ void ShenandoahHeapRegion::make_committed_bypass() {
   assert (ShenandoahHeap::heap()->is_full_gc_in_progress(), "only for full GC");
 
   switch (_state) {
-    case _empty_uncommitted:
+    case _empty_uncommitted: {
+      bool zeroed = is_zeroed_when_committed();
       do_commit();
       set_state(_empty_committed);
+      _zeroed = zeroed;
       return;
+    }
     default:
       report_illegal_transition("commit bypass");
   }
 }
 
+void ShenandoahHeapRegion::make_committed() {
+  shenandoah_assert_heaplocked();
+  switch (_state) {
+    case _empty_uncommitted: {
+      bool zeroed = is_zeroed_when_committed();
+      do_commit();
+      set_state(_empty_committed);
+      _zeroed = zeroed;
+      // Committed ahead of allocation: do not let periodic uncommit take it right back
+      _empty_time = os::elapsedTime();
+      return;
+    }
+    default:
+      report_illegal_transition("commit");
+  }
+}
+
 void ShenandoahHeapRegion::reset_alloc_metadata() {
   _tlab_allocs = 0;
   _gclab_allocs = 0;
@@ -578,6 +633,8 @@ void ShenandoahHeapRegion::recycle() {
 
   set_top(bottom());
   clear_live_data();
+  clear_pinned_range();
+  Atomic::store(&_access_samples, 0u);
 
   reset_alloc_metadata();
 
@@ -622,6 +679,12 @@ size_t ShenandoahHeapRegion::block_size(const HeapWord* p) const {
   }
 }
 
+// All regions have the same power-of-two size. The region index of an address is its offset in the heap
+// shifted by RegionSizeBytesShift, and this is compiled into the collection set tests of the barriers
+// (see region_size_bytes_shift_jint()), the biased collection set map, the marking bitmap slices and the
+// card table alignment. Splitting the heap into region size classes would change all of them, so the
+// trade-off between evacuation granularity and humongous rounding is made here, once per heap, through
+// ShenandoahTargetNumRegions, ShenandoahMinRegionSize and ShenandoahMaxRegionSize.
 size_t ShenandoahHeapRegion::setup_sizes(size_t max_heap_size) {
   // Absolute minimums we should not ever break.
   static const size_t MIN_REGION_SIZE = 256*K;
@@ -773,10 +836,25 @@ size_t ShenandoahHeapRegion::setup_sizes(size_t max_heap_size) {
   return max_heap_size;
 }
 
+bool ShenandoahHeapRegion::is_zeroed_when_committed() const {
+  if (is_empty_uncommitted()) {
+    // Committing maps fresh memory, unless the old pages are still mapped, or the heap is pre-committed.
+    return !_lazily_uncommitted && !ShenandoahHeap::heap()->is_heap_region_special();
+  }
+  return is_zeroed();
+}
+
 void ShenandoahHeapRegion::do_commit() {
   ShenandoahHeap* heap = ShenandoahHeap::heap();
-  if (!heap->is_heap_region_special() && !os::commit_memory((char *) bottom(), RegionSizeBytes, false)) {
-    report_java_out_of_memory("Unable to commit region");
+  if (_lazily_uncommitted) {
+    // The memory is still mapped where it was, and on the node it was requested from.  Pages that the OS has not
+    // reclaimed yet are simply reused, the others are faulted in again as they are touched.
+    _lazily_uncommitted = false;
+  } else if (!heap->is_heap_region_special()) {
+    if (!os::commit_memory((char *) bottom(), RegionSizeBytes, heap->heap_page_size(), false)) {
+      report_java_out_of_memory("Unable to commit region");
+    }
+    heap->numa()->request_memory_on_nodes((char *) bottom(), RegionSizeBytes, index());
   }
   if (!heap->commit_bitmap_slice(this)) {
     report_java_out_of_memory("Unable to commit bitmaps for region");
@@ -789,8 +867,12 @@ void ShenandoahHeapRegion::do_commit() {
 
 void ShenandoahHeapRegion::do_uncommit() {
   ShenandoahHeap* heap = ShenandoahHeap::heap();
-  if (!heap->is_heap_region_special() && !os::uncommit_memory((char *) bottom(), RegionSizeBytes)) {
-    report_java_out_of_memory("Unable to uncommit region");
+  if (!heap->is_heap_region_special()) {
+    if (ShenandoahUncommitLazily && os::free_memory_lazily((char *) bottom(), RegionSizeBytes)) {
+      _lazily_uncommitted = true;
+    } else if (!os::uncommit_memory((char *) bottom(), RegionSizeBytes)) {
+      report_java_out_of_memory("Unable to uncommit region");
+    }
   }
   if (!heap->uncommit_bitmap_slice(this)) {
     report_java_out_of_memory("Unable to uncommit bitmaps for region");
@@ -808,6 +890,15 @@ void ShenandoahHeapRegion::set_state(RegionState to) {
     evt.set_to(to);
     evt.commit();
   }
+  if (ShenandoahRegionTransitionLogSize > 0) {
+    ShenandoahMonitoringSupport* monitoring = ShenandoahHeap::heap()->monitoring_support();
+    if (monitoring != nullptr) {
+      monitoring->record_region_transition(index(), region_state_to_ordinal(_state), region_state_to_ordinal(to));
+    }
+  }
+  if (to != _empty_committed) {
+    _zeroed = false;
+  }
   _state = to;
 }
 
@@ -824,6 +915,33 @@ size_t ShenandoahHeapRegion::pin_count() const {
   return Atomic::load(&_critical_pins);
 }
 
+void ShenandoahHeapRegion::record_pinned_object(HeapWord* obj, size_t words) {
+  assert(ShenandoahEvacuatePinnedRegions, "Only track pinned ranges when pinned regions are evacuated");
+  assert(bottom() <= obj && obj + words <= end(), "Object should be in region " SIZE_FORMAT, index());
+  HeapWord* obj_end = obj + words;
+
+  HeapWord* cur = Atomic::load(&_pinned_bottom);
+  while (cur == nullptr || obj < cur) {
+    HeapWord* prev = Atomic::cmpxchg(&_pinned_bottom, cur, obj);
+    if (prev == cur) break;
+    cur = prev;
+  }
+
+  cur = Atomic::load(&_pinned_top);
+  while (obj_end > cur) {
+    HeapWord* prev = Atomic::cmpxchg(&_pinned_top, cur, obj_end);
+    if (prev == cur) break;
+    cur = prev;
+  }
+}
+
+// New pins can come in concurrently, unless this is a safepoint or no objects are left in the region.
+void ShenandoahHeapRegion::clear_pinned_range() {
+  assert(pin_count() == 0, "Cannot clear the range of pinned region " SIZE_FORMAT, index());
+  Atomic::store(&_pinned_bottom, (HeapWord*)nullptr);
+  Atomic::store(&_pinned_top, (HeapWord*)nullptr);
+}
+
 void ShenandoahHeapRegion::set_affiliation(ShenandoahAffiliation new_affiliation) {
   ShenandoahHeap* heap = ShenandoahHeap::heap();
 
@@ -182,15 +182,18 @@ public:
   void make_pinned();
   void make_unpinned();
   void make_cset();
+  void make_retained();
   void make_trash();
   void make_trash_immediate();
   void make_empty();
   void make_uncommitted();
   void make_committed_bypass();
+  void make_committed();
 
   // Individual states:
   bool is_empty_uncommitted()      const { return _state == _empty_uncommitted; }
   bool is_empty_committed()        const { return _state == _empty_committed; }
+  bool is_zeroed()                 const { return _zeroed; }
   bool is_regular()                const { return _state == _regular; }
   bool is_humongous_continuation() const { return _state == _humongous_cont; }
 
@@ -220,6 +223,14 @@ public:
   void record_unpin();
   size_t pin_count() const;
 
+  // Pinned ranges, see ShenandoahEvacuatePinnedRegions. The range covers all objects pinned in this region
+  // since it was last cleared, and those that degenerated evacuation failed to copy. Evacuation leaves the
+  // objects in it in place.
+  void record_pinned_object(HeapWord* obj, size_t words);
+  void clear_pinned_range();
+  inline bool has_pinned_range() const;
+  inline bool is_in_pinned_range(const void* p) const;
+
 private:
   static size_t RegionCount;
   static size_t RegionSizeBytes;
@@ -257,6 +268,25 @@ private:
 
   volatile size_t _live_data;
   volatile size_t _critical_pins;
+  HeapWord* volatile _pinned_bottom;
+  HeapWord* volatile _pinned_top;
+
+  // Summary of the reference fields of the objects marked in this region, see ShenandoahUpdateRefsRegionSummary.
+  // The top bit is set if any reference field was visited, and every other bit stands for the regions whose index
+  // is congruent to it, modulo the number of those bits, that are referenced by one of these fields.
+  volatile uintx _ref_summary;
+
+  // Load reference barrier slow paths sampled with ShenandoahRegionAccessSampleRate that loaded from
+  // this region. Halved every time a collection set is chosen, so it tracks recent accesses.
+  volatile uint _access_samples;
+
+  // True iff this region is _empty_uncommitted, but its memory is still mapped and only advised to be reclaimed
+  // lazily (see ShenandoahUncommitLazily).  Committing it again does not need to map the memory.
+  bool _lazily_uncommitted;
+
+  // True iff this region is _empty_committed and all of its memory is known to be zeroed.  Cleared when the region
+  // leaves the empty committed state.
+  bool _zeroed;
 
   HeapWord* volatile _update_watermark;
 
@@ -365,9 +395,39 @@ public:
   // Allocation (return nullptr if full)
   inline HeapWord* allocate(size_t word_size, ShenandoahAllocRequest req);
 
+  // Lock-free allocation of a TLAB or GCLAB of at least req.min_size() and at most req.size() words, for a
+  // regular region that is owned by an allocation shard rather than by the free set.  Sets req's actual size.
+  // Returns nullptr if the region cannot fit the minimum size.
+  inline HeapWord* allocate_lab_atomic(ShenandoahAllocRequest& req);
+
+  // Lock-free allocation of a shared mutator object of exactly req.size() words, for a regular region that
+  // is owned by a medium object shard.  Returns nullptr if the object does not fit.
+  inline HeapWord* allocate_shared_atomic(ShenandoahAllocRequest& req);
+
+  // Atomically claim the rest of a region that is owned by an allocation shard and fill it with a dummy
+  // object, so that racing atomic allocations fail.  Returns the number of words claimed.
+  inline size_t seal_atomic();
+
   inline void clear_live_data();
   void set_live_data(size_t s);
 
+  static const uintx RefSummaryHasFieldsBit = (uintx)1 << (BitsPerWord - 1);
+
+  // The summary bit that stands for references into the region with the given index.
+  static inline uintx ref_summary_bit(size_t region_index) {
+    return (uintx)1 << (region_index % (BitsPerWord - 1));
+  }
+
+  inline void clear_ref_summary();
+  inline uintx ref_summary() const;
+
+  inline void record_access_sample();
+  inline uint access_samples() const;
+  inline void decay_access_samples();
+
+  // Record that marking visited a reference field of an object in this region, which currently holds obj.
+  inline void record_ref_field(ShenandoahHeap* heap, oop obj);
+
   // Increase live data for newly allocated region
   inline void increase_live_data_alloc_words(size_t s);
 
@@ -447,6 +507,19 @@ public:
   inline void set_update_watermark(HeapWord* w);
   inline void set_update_watermark_at_safepoint(HeapWord* w);
 
+  // Raise the update watermark to w, unless a racing allocation has already raised it further.
+  inline void raise_update_watermark(HeapWord* w);
+
+  // True iff the memory of this empty region is known to be zeroed once the region is committed: the region
+  // is committed and zeroed, or committing it maps fresh memory from the OS.
+  bool is_zeroed_when_committed() const;
+
+  // Record that the memory of this empty committed region has been zeroed.
+  void set_zeroed() {
+    assert(is_empty_committed(), "Only empty committed regions are known to be zeroed");
+    _zeroed = true;
+  }
+
   inline ShenandoahAffiliation affiliation() const;
   inline const char* affiliation_name() const;
 
@@ -469,6 +542,11 @@ public:
     _age = 0;
   }
 
+  // For regions known to hold only long-lived objects, so that they are promoted at the first opportunity
+  void set_max_age() {
+    _age = markWord::max_age;
+  }
+
   CENSUS_NOISE(void clear_youth() { _youth = 0; })
 
 private:
@@ -107,6 +107,63 @@ HeapWord* ShenandoahHeapRegion::allocate(size_t size, ShenandoahAllocRequest req
   }
 }
 
+inline HeapWord* ShenandoahHeapRegion::allocate_lab_atomic(ShenandoahAllocRequest& req) {
+  assert(req.type() == ShenandoahAllocRequest::_alloc_tlab || req.type() == ShenandoahAllocRequest::_alloc_gclab,
+         "Only TLABs and GCLABs");
+  assert(is_regular(), "Only regular regions are owned by allocation shards");
+
+  HeapWord* obj = Atomic::load_acquire(&_top);
+  while (true) {
+    size_t size = MIN2(req.size(), align_down(pointer_delta(end(), obj), MinObjAlignment));
+    if (size < req.min_size()) {
+      return nullptr;
+    }
+    HeapWord* witness = Atomic::cmpxchg(&_top, obj, obj + size);
+    if (witness == obj) {
+      Atomic::add(req.is_mutator_alloc() ? &_tlab_allocs : &_gclab_allocs, size, memory_order_relaxed);
+      req.set_actual_size(size);
+      assert(is_object_aligned(obj), "obj is not aligned: " PTR_FORMAT, p2i(obj));
+      return obj;
+    }
+    obj = witness;
+  }
+}
+
+inline HeapWord* ShenandoahHeapRegion::allocate_shared_atomic(ShenandoahAllocRequest& req) {
+  assert(req.type() == ShenandoahAllocRequest::_alloc_shared, "Only shared mutator allocations");
+  assert(is_regular(), "Only regular regions are owned by allocation shards");
+
+  size_t size = req.size();
+  HeapWord* obj = Atomic::load_acquire(&_top);
+  while (pointer_delta(end(), obj) >= size) {
+    HeapWord* witness = Atomic::cmpxchg(&_top, obj, obj + size);
+    if (witness == obj) {
+      req.set_actual_size(size);
+      assert(is_object_aligned(obj), "obj is not aligned: " PTR_FORMAT, p2i(obj));
+      return obj;
+    }
+    obj = witness;
+  }
+  return nullptr;
+}
+
+inline size_t ShenandoahHeapRegion::seal_atomic() {
+  HeapWord* obj = Atomic::load_acquire(&_top);
+  while (true) {
+    size_t words = pointer_delta(end(), obj);
+    if (words < CollectedHeap::min_fill_size()) {
+      // No LAB fits in here, there is nothing to seal
+      return 0;
+    }
+    HeapWord* witness = Atomic::cmpxchg(&_top, obj, end());
+    if (witness == obj) {
+      CollectedHeap::fill_with_object(obj, words);
+      return words;
+    }
+    obj = witness;
+  }
+}
+
 inline void ShenandoahHeapRegion::adjust_alloc_metadata(ShenandoahAllocRequest::Type type, size_t size) {
   switch (type) {
     case ShenandoahAllocRequest::_alloc_shared:
@@ -146,6 +203,47 @@ inline void ShenandoahHeapRegion::clear_live_data() {
   Atomic::store(&_live_data, (size_t)0);
 }
 
+inline void ShenandoahHeapRegion::clear_ref_summary() {
+  Atomic::store(&_ref_summary, (uintx)0);
+}
+
+inline uintx ShenandoahHeapRegion::ref_summary() const {
+  return Atomic::load(&_ref_summary);
+}
+
+inline void ShenandoahHeapRegion::record_access_sample() {
+  Atomic::inc(&_access_samples, memory_order_relaxed);
+}
+
+inline uint ShenandoahHeapRegion::access_samples() const {
+  return Atomic::load(&_access_samples);
+}
+
+inline void ShenandoahHeapRegion::decay_access_samples() {
+  // Racing samples may be lost, which does not matter for a sampled estimate.
+  Atomic::store(&_access_samples, Atomic::load(&_access_samples) / 2);
+}
+
+inline bool ShenandoahHeapRegion::has_pinned_range() const {
+  return Atomic::load(&_pinned_bottom) != nullptr;
+}
+
+inline bool ShenandoahHeapRegion::is_in_pinned_range(const void* p) const {
+  HeapWord* bottom = Atomic::load(&_pinned_bottom);
+  return bottom != nullptr && bottom <= p && p < Atomic::load(&_pinned_top);
+}
+
+inline void ShenandoahHeapRegion::record_ref_field(ShenandoahHeap* heap, oop obj) {
+  uintx bits = RefSummaryHasFieldsBit;
+  if (obj != nullptr) {
+    bits |= ref_summary_bit(heap->heap_region_index_containing(obj));
+  }
+  // The summary saturates quickly, so most fields only need to read it.
+  if ((Atomic::load(&_ref_summary) & bits) != bits) {
+    Atomic::fetch_then_or(&_ref_summary, bits, memory_order_relaxed);
+  }
+}
+
 inline size_t ShenandoahHeapRegion::get_live_data_words() const {
   return Atomic::load(&_live_data);
 }
@@ -189,6 +287,17 @@ inline void ShenandoahHeapRegion::set_update_watermark(HeapWord* w) {
   Atomic::release_store(&_update_watermark, w);
 }
 
+inline void ShenandoahHeapRegion::raise_update_watermark(HeapWord* w) {
+  HeapWord* prev = Atomic::load(&_update_watermark);
+  while (prev < w) {
+    HeapWord* witness = Atomic::cmpxchg(&_update_watermark, prev, w, memory_order_release);
+    if (witness == prev) {
+      return;
+    }
+    prev = witness;
+  }
+}
+
 // Fast version that avoids synchronization, only to be used at safepoints.
 inline void ShenandoahHeapRegion::set_update_watermark_at_safepoint(HeapWord* w) {
   assert(bottom() <= w && w <= top(), "within bounds");
@@ -32,11 +32,17 @@
 #include "logging/logStream.hpp"
 #include "memory/resourceArea.hpp"
 #include "runtime/atomic.hpp"
+#include "runtime/orderAccess.hpp"
 #include "runtime/perfData.inline.hpp"
 #include "utilities/defaultStream.hpp"
 
 ShenandoahHeapRegionCounters::ShenandoahHeapRegionCounters() :
-  _last_sample_millis(0)
+  _last_sample_millis(0),
+  _transitions_size(0),
+  _transitions_data(nullptr),
+  _transitions_time(nullptr),
+  _transitions_count(nullptr),
+  _transitions_recorded(0)
 {
   if (UsePerfData && ShenandoahRegionSampling) {
     EXCEPTION_MARK;
@@ -47,7 +53,10 @@ ShenandoahHeapRegionCounters::ShenandoahHeapRegionCounters() :
     _name_space = NEW_C_HEAP_ARRAY(char, strlen(cns)+1, mtGC);
     strcpy(_name_space, cns); // copy cns into _name_space
 
-    const char* cname = PerfDataManager::counter_name(_name_space, "timestamp");
+    const char* cname = PerfDataManager::counter_name(_name_space, "sequence");
+    _sequence = PerfDataManager::create_long_variable(SUN_GC, cname, PerfData::U_Events, CHECK);
+
+    cname = PerfDataManager::counter_name(_name_space, "timestamp");
     _timestamp = PerfDataManager::create_long_variable(SUN_GC, cname, PerfData::U_None, CHECK);
 
     cname = PerfDataManager::counter_name(_name_space, "max_regions");
@@ -75,6 +84,30 @@ ShenandoahHeapRegionCounters::ShenandoahHeapRegionCounters() :
                                                                PerfData::U_None, CHECK);
     }
 
+    if (ShenandoahRegionTransitionLogSize > 0) {
+      const char* tns = PerfDataManager::name_space(_name_space, "transitions");
+      size_t size = ShenandoahRegionTransitionLogSize;
+
+      cname = PerfDataManager::counter_name(tns, "log_size");
+      PerfDataManager::create_constant(SUN_GC, cname, PerfData::U_None, size, CHECK);
+
+      cname = PerfDataManager::counter_name(tns, "count");
+      _transitions_count = PerfDataManager::create_long_variable(SUN_GC, cname, PerfData::U_Events, CHECK);
+
+      _transitions_data = NEW_C_HEAP_ARRAY(PerfVariable*, size, mtGC);
+      _transitions_time = NEW_C_HEAP_ARRAY(PerfVariable*, size, mtGC);
+      for (uint k = 0; k < size; k++) {
+        const char* slot_name = PerfDataManager::name_space(tns, k);
+        cname = PerfDataManager::counter_name(slot_name, "time");
+        _transitions_time[k] = PerfDataManager::create_long_variable(SUN_GC, cname, PerfData::U_Ticks, CHECK);
+        cname = PerfDataManager::counter_name(slot_name, "data");
+        _transitions_data[k] = PerfDataManager::create_long_variable(SUN_GC, cname, PerfData::U_None, CHECK);
+      }
+
+      // Publish the ring only when it is complete.
+      Atomic::release_store(&_transitions_size, size);
+    }
+
   }
 }
 
@@ -104,6 +137,28 @@ void ShenandoahHeapRegionCounters::write_snapshot(PerfLongVariable** regions,
   }
 }
 
+void ShenandoahHeapRegionCounters::record_transition(size_t region, int from_ordinal, int to_ordinal) {
+  size_t size = Atomic::load_acquire(&_transitions_size);
+  if (size == 0) {
+    return;
+  }
+
+  jlong n = Atomic::fetch_then_add(&_transitions_recorded, (jlong)1, memory_order_relaxed);
+  // The sequence number reaches into the sign bit, compose unsigned.
+  julong data = 0;
+  data |= ((julong)to_ordinal   & STATUS_MASK)            << TRANSITION_TO_SHIFT;
+  data |= ((julong)from_ordinal & STATUS_MASK)            << TRANSITION_FROM_SHIFT;
+  data |= ((julong)region       & TRANSITION_REGION_MASK) << TRANSITION_REGION_SHIFT;
+  data |= ((julong)n            & TRANSITION_SEQ_MASK)    << TRANSITION_SEQ_SHIFT;
+
+  size_t k = (size_t)n % size;
+  _transitions_time[k]->set_value(os::elapsed_counter());
+  OrderAccess::storestore();
+  _transitions_data[k]->set_value((jlong)data);
+  OrderAccess::storestore();
+  _transitions_count->set_value(n + 1);
+}
+
 void ShenandoahHeapRegionCounters::update() {
   if (ShenandoahRegionSampling) {
     jlong current = nanos_to_millis(os::javaTimeNanos());
@@ -111,11 +166,18 @@ void ShenandoahHeapRegionCounters::update() {
     if (current - last > ShenandoahRegionSamplingRate && Atomic::cmpxchg(&_last_sample_millis, last, current) == last) {
 
       ShenandoahHeap* heap = ShenandoahHeap::heap();
-      _status->set_value(encode_heap_status(heap));
-      _timestamp->set_value(os::elapsed_counter());
+      jlong status = encode_heap_status(heap);
 
       {
+        // Samples that outlast the sampling rate may overlap, the lock keeps their writes apart.
         ShenandoahHeapLocker locker(heap->lock());
+        const jlong seq = _sequence->get_value();
+        _sequence->set_value(seq + 1);
+        OrderAccess::storestore();
+
+        _status->set_value(status);
+        _timestamp->set_value(os::elapsed_counter());
+
         size_t rs = ShenandoahHeapRegion::region_size_bytes();
         size_t num_regions = heap->num_regions();
         for (uint i = 0; i < num_regions; i++) {
@@ -136,6 +198,9 @@ void ShenandoahHeapRegionCounters::update() {
 
         // If logging enabled, dump current region snapshot to log file
         write_snapshot(_regions_data, _timestamp, _status, num_regions, rs >> 10, VERSION_NUMBER);
+
+        OrderAccess::storestore();
+        _sequence->set_value(seq + 2);
       }
     }
   }
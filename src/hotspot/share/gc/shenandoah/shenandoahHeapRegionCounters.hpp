@@ -38,6 +38,7 @@
  * - sun.gc.shenandoah.regions.region_size  size per region, in kilobytes
  *
  * variables:
+ * - sun.gc.shenandoah.regions.sequence     sample sequence, odd while a sample is written
  * - sun.gc.shenandoah.regions.status       current GC status:
  *   | global | old   | young | mode |
  *   |  0..1  | 2..3  | 4..5  | 6..7 |
@@ -64,6 +65,28 @@
  * - bits 56-57  affiliation: 0 = free, young = 1, old = 2
  * - bits 58-63  status
  *      - bits describe the state as recorded in ShenandoahHeapRegion
+ *
+ * Readers sampling the shared memory directly get a consistent sample of .timestamp,
+ * .status and the region .data by reading .sequence before and after them: the sample
+ * is good if both reads return the same even value, and is retried otherwise.
+ *
+ * with ShenandoahRegionTransitionLogSize > 0, the ring buffer of region state
+ * transitions, with $log_size slots:
+ * - sun.gc.shenandoah.regions.transitions.log_size  number of slots (constant)
+ * - sun.gc.shenandoah.regions.transitions.count     transitions recorded so far
+ * - sun.gc.shenandoah.regions.transitions.$k.time   timestamp of the transition
+ * - sun.gc.shenandoah.regions.transitions.$k.data   the transition
+ * where transition $n goes to slot $k = $n % $log_size
+ *
+ * .data is in the following format:
+ * - bits 0-5    status after the transition, as above
+ * - bits 6-11   status before the transition, as above
+ * - bits 12-35  region number
+ * - bits 36-63  low bits of $n
+ *
+ * Writers do not wait for readers, and .count may briefly lag or lead the slots
+ * being written. Readers take the slots of the last $log_size transitions, and
+ * drop those whose data does not carry the expected $n.
  */
 class ShenandoahHeapRegionCounters : public CHeapObj<mtGC>  {
 private:
@@ -82,14 +105,29 @@ private:
   static const jlong AFFILIATION_SHIFT = 56;
   static const jlong STATUS_SHIFT      = 58;
 
-  static const jlong VERSION_NUMBER    = 2;
+  static const jlong VERSION_NUMBER    = 3;
 
   char* _name_space;
   PerfLongVariable** _regions_data;
+  PerfLongVariable* _sequence;
   PerfLongVariable* _timestamp;
   PerfLongVariable* _status;
   volatile jlong _last_sample_millis;
 
+  static const jlong TRANSITION_REGION_MASK = 0xffffff;
+  static const jlong TRANSITION_SEQ_MASK    = 0xfffffff;
+
+  static const jlong TRANSITION_TO_SHIFT     = 0;
+  static const jlong TRANSITION_FROM_SHIFT   = 6;
+  static const jlong TRANSITION_REGION_SHIFT = 12;
+  static const jlong TRANSITION_SEQ_SHIFT    = 36;
+
+  volatile size_t _transitions_size;
+  PerfLongVariable** _transitions_data;
+  PerfLongVariable** _transitions_time;
+  PerfLongVariable* _transitions_count;
+  volatile jlong _transitions_recorded;
+
   void write_snapshot(PerfLongVariable** regions,
                       PerfLongVariable* ts,
                       PerfLongVariable* status,
@@ -102,6 +140,9 @@ public:
   ~ShenandoahHeapRegionCounters();
   void update();
 
+  // Append a region state transition to the ring buffer, if it is enabled.
+  void record_transition(size_t region, int from_ordinal, int to_ordinal);
+
 private:
   static jlong encode_heap_status(ShenandoahHeap* heap) ;
 };
@@ -0,0 +1,336 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#include "precompiled.hpp"
+
+#include "gc/shenandoah/heuristics/shenandoahSpaceInfo.hpp"
+#include "gc/shenandoah/shenandoahCollectionSet.inline.hpp"
+#include "gc/shenandoah/shenandoahGeneration.hpp"
+#include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahHeapRegion.inline.hpp"
+#include "gc/shenandoah/shenandoahHeuristicsTrace.hpp"
+#include "gc/shenandoah/shenandoah_globals.hpp"
+#include "logging/log.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/os.hpp"
+
+#include <string.h>
+
+ShenandoahHeuristicsTrace* ShenandoahHeuristicsTrace::_trace = nullptr;
+
+ShenandoahTriggerInputs::ShenandoahTriggerInputs() :
+  _soft_max_capacity(0),
+  _max_capacity(0),
+  _soft_available(0),
+  _available(0),
+  _used(0),
+  _allocated(0),
+  _metaspace_oom(false),
+  _allocation_spike(false) {
+}
+
+ShenandoahTriggerInputs::ShenandoahTriggerInputs(ShenandoahSpaceInfo* space, bool metaspace_oom, bool allocation_spike) :
+  _soft_max_capacity(space->soft_max_capacity()),
+  _max_capacity(space->max_capacity()),
+  _soft_available(space->soft_available()),
+  _available(space->available()),
+  _used(space->used()),
+  _allocated(space->bytes_allocated_since_gc_start()),
+  _metaspace_oom(metaspace_oom),
+  _allocation_spike(allocation_spike) {
+}
+
+ShenandoahHeuristicsTrace::ShenandoahHeuristicsTrace(const char* path, size_t region_size,
+                                                     size_t num_regions, size_t max_capacity) :
+  _lock(Mutex::nosafepoint - 2, "ShenandoahHeuristicsTrace_lock", true),
+  _file(os::fopen(path, "wb")),
+  _buffer(NEW_C_HEAP_ARRAY(uint8_t, BufferSize, mtGC)),
+  _buffered(0) {
+  if (_file == nullptr) {
+    return;
+  }
+  MutexLocker ml(&_lock, Mutex::_no_safepoint_check_flag);
+  put_u4(Magic);
+  put_u2(Version);
+  put_u8(region_size);
+  put_u8(num_regions);
+  put_u8(max_capacity);
+}
+
+ShenandoahHeuristicsTrace::~ShenandoahHeuristicsTrace() {
+  if (_file != nullptr) {
+    flush();
+    fclose(_file);
+  }
+  FREE_C_HEAP_ARRAY(uint8_t, _buffer);
+}
+
+void ShenandoahHeuristicsTrace::initialize() {
+  if (ShenandoahHeuristicsTraceFile == nullptr) {
+    return;
+  }
+  ShenandoahHeap* const heap = ShenandoahHeap::heap();
+  ShenandoahHeuristicsTrace* trace = new ShenandoahHeuristicsTrace(ShenandoahHeuristicsTraceFile,
+                                                                   ShenandoahHeapRegion::region_size_bytes(),
+                                                                   heap->num_regions(), heap->max_capacity());
+  if (!trace->is_open()) {
+    log_warning(gc)("Could not open heuristics trace file: %s", ShenandoahHeuristicsTraceFile);
+    delete trace;
+    return;
+  }
+  log_info(gc, init)("Heuristics trace: %s", ShenandoahHeuristicsTraceFile);
+  _trace = trace;
+}
+
+void ShenandoahHeuristicsTrace::shutdown() {
+  if (_trace != nullptr) {
+    _trace->flush();
+  }
+}
+
+void ShenandoahHeuristicsTrace::put(const void* data, size_t size) {
+  assert(_lock.owned_by_self(), "Must hold the trace lock");
+  assert(size <= BufferSize, "Record field too large");
+  if (_buffered + size > BufferSize) {
+    flush_locked();
+  }
+  memcpy(_buffer + _buffered, data, size);
+  _buffered += size;
+}
+
+void ShenandoahHeuristicsTrace::put_record_header(Kind kind, const char* space, double time) {
+  size_t length = MIN2(strlen(space), (size_t) UINT8_MAX);
+  put_u1((uint8_t) kind);
+  put_double(time);
+  put_u1((uint8_t) length);
+  put(space, length);
+}
+
+void ShenandoahHeuristicsTrace::flush_locked() {
+  if (_buffered > 0) {
+    if (fwrite(_buffer, 1, _buffered, _file) != _buffered) {
+      log_warning(gc)("Could not write heuristics trace, %s", os::strerror(errno));
+    }
+    fflush(_file);
+    _buffered = 0;
+  }
+}
+
+void ShenandoahHeuristicsTrace::flush() {
+  MutexLocker ml(&_lock, Mutex::_no_safepoint_check_flag);
+  flush_locked();
+}
+
+void ShenandoahHeuristicsTrace::write_trigger(const char* space, double time,
+                                              const ShenandoahTriggerInputs& inputs, bool decision) {
+  uint8_t flags = (inputs._metaspace_oom    ? METASPACE_OOM    : 0) |
+                  (inputs._allocation_spike ? ALLOCATION_SPIKE : 0) |
+                  (decision                 ? DECISION         : 0);
+
+  MutexLocker ml(&_lock, Mutex::_no_safepoint_check_flag);
+  put_record_header(TRIGGER, space, time);
+  put_u8(inputs._soft_max_capacity);
+  put_u8(inputs._max_capacity);
+  put_u8(inputs._soft_available);
+  put_u8(inputs._available);
+  put_u8(inputs._used);
+  put_u8(inputs._allocated);
+  put_u1(flags);
+}
+
+void ShenandoahHeuristicsTrace::write_event(const char* space, double time, Kind kind) {
+  MutexLocker ml(&_lock, Mutex::_no_safepoint_check_flag);
+  put_record_header(kind, space, time);
+  if (kind == CYCLE_CONCURRENT || kind == CYCLE_DEGENERATED || kind == CYCLE_FULL) {
+    // Triggers are polled often, keep the file current once per cycle rather than per record
+    flush_locked();
+  }
+}
+
+void ShenandoahHeuristicsTrace::write_collection_set(const char* space, double time, size_t free,
+                                                     const ShenandoahTraceRegion* regions, size_t count) {
+  MutexLocker ml(&_lock, Mutex::_no_safepoint_check_flag);
+  put_record_header(COLLECTION_SET, space, time);
+  put_u8(free);
+  put_u8(count);
+  for (size_t i = 0; i < count; i++) {
+    const ShenandoahTraceRegion& r = regions[i];
+    put_u4(r._index);
+    put_u4(r._live_words);
+    put_u4(r._used_words);
+    put_u1(r._state);
+    put_u1(r._age);
+    put_u1(r._in_cset ? 1 : 0);
+  }
+}
+
+void ShenandoahHeuristicsTrace::record_event(ShenandoahSpaceInfo* space, Kind kind) {
+  if (_trace != nullptr) {
+    _trace->write_event(space->name(), os::elapsedTime(), kind);
+  }
+}
+
+void ShenandoahHeuristicsTrace::record_collection_set(ShenandoahGeneration* generation,
+                                                      ShenandoahCollectionSet* collection_set) {
+  if (_trace == nullptr) {
+    return;
+  }
+
+  ShenandoahHeap* const heap = ShenandoahHeap::heap();
+  size_t num_regions = heap->num_regions();
+  ShenandoahTraceRegion* regions = NEW_C_HEAP_ARRAY(ShenandoahTraceRegion, num_regions, mtGC);
+  size_t count = 0;
+  for (size_t i = 0; i < num_regions; i++) {
+    ShenandoahHeapRegion* r = heap->get_region(i);
+    // Regions reclaimed as immediate garbage are trash now, and are kept
+    if (r->is_empty() || !generation->contains(r)) {
+      continue;
+    }
+    ShenandoahTraceRegion& tr = regions[count++];
+    tr._index      = checked_cast<uint32_t>(i);
+    tr._live_words = checked_cast<uint32_t>(r->get_live_data_words());
+    tr._used_words = checked_cast<uint32_t>(r->used() / HeapWordSize);
+    tr._state      = checked_cast<uint8_t>(r->state_ordinal());
+    tr._age        = checked_cast<uint8_t>(r->age());
+    tr._in_cset    = collection_set->is_in(r);
+  }
+  _trace->write_collection_set(generation->name(), os::elapsedTime(), generation->available(), regions, count);
+  FREE_C_HEAP_ARRAY(ShenandoahTraceRegion, regions);
+}
+
+ShenandoahHeuristicsTraceReader::ShenandoahHeuristicsTraceReader(const char* path) :
+  _file(os::fopen(path, "rb")),
+  _valid(false),
+  _region_size(0),
+  _num_regions(0),
+  _max_capacity(0),
+  _kind(ShenandoahHeuristicsTrace::TRIGGER),
+  _time(0.0),
+  _inputs(),
+  _decision(false),
+  _free(0),
+  _region_count(0),
+  _regions(nullptr) {
+  _space[0] = '\0';
+  if (_file == nullptr) {
+    return;
+  }
+
+  uint32_t magic;
+  uint16_t version;
+  uint64_t region_size, num_regions, max_capacity;
+  if (!get(&magic, sizeof(magic)) || magic != ShenandoahHeuristicsTrace::Magic ||
+      !get(&version, sizeof(version)) || version != ShenandoahHeuristicsTrace::Version ||
+      !get(&region_size, sizeof(region_size)) ||
+      !get(&num_regions, sizeof(num_regions)) ||
+      !get(&max_capacity, sizeof(max_capacity))) {
+    return;
+  }
+  _region_size = region_size;
+  _num_regions = num_regions;
+  _max_capacity = max_capacity;
+  _regions = NEW_C_HEAP_ARRAY(ShenandoahTraceRegion, MAX2(_num_regions, (size_t) 1), mtGC);
+  _valid = true;
+}
+
+ShenandoahHeuristicsTraceReader::~ShenandoahHeuristicsTraceReader() {
+  if (_file != nullptr) {
+    fclose(_file);
+  }
+  if (_regions != nullptr) {
+    FREE_C_HEAP_ARRAY(ShenandoahTraceRegion, _regions);
+  }
+}
+
+bool ShenandoahHeuristicsTraceReader::get(void* data, size_t size) {
+  return fread(data, 1, size, _file) == size;
+}
+
+bool ShenandoahHeuristicsTraceReader::next() {
+  if (!_valid) {
+    return false;
+  }
+
+  uint8_t kind, length;
+  if (!get(&kind, sizeof(kind)) || !get(&_time, sizeof(_time)) ||
+      !get(&length, sizeof(length)) || !get(_space, length)) {
+    return false;
+  }
+  _space[length] = '\0';
+  _kind = (ShenandoahHeuristicsTrace::Kind) kind;
+
+  switch (_kind) {
+    case ShenandoahHeuristicsTrace::TRIGGER: {
+      uint64_t values[6];
+      uint8_t flags;
+      if (!get(values, sizeof(values)) || !get(&flags, sizeof(flags))) {
+        return false;
+      }
+      _inputs._soft_max_capacity = values[0];
+      _inputs._max_capacity      = values[1];
+      _inputs._soft_available    = values[2];
+      _inputs._available         = values[3];
+      _inputs._used              = values[4];
+      _inputs._allocated         = values[5];
+      _inputs._metaspace_oom     = (flags & ShenandoahHeuristicsTrace::METASPACE_OOM) != 0;
+      _inputs._allocation_spike  = (flags & ShenandoahHeuristicsTrace::ALLOCATION_SPIKE) != 0;
+      _decision                  = (flags & ShenandoahHeuristicsTrace::DECISION) != 0;
+      return true;
+    }
+    case ShenandoahHeuristicsTrace::CYCLE_START:
+    case ShenandoahHeuristicsTrace::CYCLE_END:
+    case ShenandoahHeuristicsTrace::CYCLE_CONCURRENT:
+    case ShenandoahHeuristicsTrace::CYCLE_DEGENERATED:
+    case ShenandoahHeuristicsTrace::CYCLE_FULL:
+    case ShenandoahHeuristicsTrace::ALLOCATION_FAILURE:
+    case ShenandoahHeuristicsTrace::REQUESTED_GC:
+      return true;
+    case ShenandoahHeuristicsTrace::COLLECTION_SET: {
+      uint64_t free, count;
+      if (!get(&free, sizeof(free)) || !get(&count, sizeof(count)) || count > _num_regions) {
+        return false;
+      }
+      _free = free;
+      _region_count = count;
+      for (size_t i = 0; i < count; i++) {
+        ShenandoahTraceRegion& r = _regions[i];
+        uint8_t in_cset;
+        if (!get(&r._index, sizeof(r._index)) ||
+            !get(&r._live_words, sizeof(r._live_words)) ||
+            !get(&r._used_words, sizeof(r._used_words)) ||
+            !get(&r._state, sizeof(r._state)) ||
+            !get(&r._age, sizeof(r._age)) ||
+            !get(&in_cset, sizeof(in_cset))) {
+          return false;
+        }
+        r._in_cset = in_cset != 0;
+      }
+      return true;
+    }
+    default:
+      // Written by a newer VM, or not a trace at all
+      return false;
+  }
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#ifndef SHARE_GC_SHENANDOAH_SHENANDOAHHEURISTICSTRACE_HPP
+#define SHARE_GC_SHENANDOAH_SHENANDOAHHEURISTICSTRACE_HPP
+
+#include "memory/allocation.hpp"
+#include "runtime/mutex.hpp"
+
+#include <stdio.h>
+
+class ShenandoahCollectionSet;
+class ShenandoahGeneration;
+class ShenandoahSpaceInfo;
+
+// What should_start_gc() sees when the heuristics are asked to start a cycle
+struct ShenandoahTriggerInputs {
+  size_t _soft_max_capacity;
+  size_t _max_capacity;
+  size_t _soft_available;
+  size_t _available;
+  size_t _used;
+  size_t _allocated;
+  bool _metaspace_oom;
+  bool _allocation_spike;
+
+  ShenandoahTriggerInputs();
+  ShenandoahTriggerInputs(ShenandoahSpaceInfo* space, bool metaspace_oom, bool allocation_spike);
+};
+
+// One region of the generation whose collection set was chosen, as the heuristics left it
+struct ShenandoahTraceRegion {
+  uint32_t _index;
+  uint32_t _live_words;
+  uint32_t _used_words;
+  uint8_t  _state;
+  uint8_t  _age;
+  bool     _in_cset;
+};
+
+// Records the inputs and decisions of the heuristics into a binary file named by
+// -XX:ShenandoahHeuristicsTraceFile, so that they can be replayed offline through
+// the heuristics classes (see test_shenandoahHeuristicsReplay.cpp).
+//
+// The file starts with a header:
+//   u4 magic, u2 version, u8 region size, u8 number of regions, u8 max capacity
+// followed by records:
+//   u1 kind, f8 time in seconds, u1 length and bytes of the space name
+// Trigger records add the trigger inputs as u8s and a u1 of flags. Collection set
+// records add the free memory of the generation, the number of regions and the
+// regions themselves. Values are written in the byte order of the recording VM.
+class ShenandoahHeuristicsTrace : public CHeapObj<mtGC> {
+public:
+  enum Kind {
+    TRIGGER = 1,
+    CYCLE_START,
+    CYCLE_END,
+    CYCLE_CONCURRENT,
+    CYCLE_DEGENERATED,
+    CYCLE_FULL,
+    ALLOCATION_FAILURE,
+    REQUESTED_GC,
+    COLLECTION_SET
+  };
+
+  enum TriggerFlags {
+    METASPACE_OOM    = 1 << 0,
+    ALLOCATION_SPIKE = 1 << 1,
+    DECISION         = 1 << 2
+  };
+
+  static const uint32_t Magic   = 0x53485452;
+  static const uint16_t Version = 1;
+
+private:
+  static const size_t BufferSize = 64 * K;
+
+  static ShenandoahHeuristicsTrace* _trace;
+
+  Mutex _lock;
+  FILE* _file;
+  uint8_t* const _buffer;
+  size_t _buffered;
+
+  void put(const void* data, size_t size);
+  void put_u1(uint8_t value)   { put(&value, sizeof(value)); }
+  void put_u2(uint16_t value)  { put(&value, sizeof(value)); }
+  void put_u4(uint32_t value)  { put(&value, sizeof(value)); }
+  void put_u8(uint64_t value)  { put(&value, sizeof(value)); }
+  void put_double(double value) { put(&value, sizeof(value)); }
+  void put_record_header(Kind kind, const char* space, double time);
+  void flush_locked();
+
+public:
+  ShenandoahHeuristicsTrace(const char* path, size_t region_size, size_t num_regions, size_t max_capacity);
+  ~ShenandoahHeuristicsTrace();
+
+  bool is_open() const { return _file != nullptr; }
+
+  // Opens the trace named by -XX:ShenandoahHeuristicsTraceFile, if any
+  static void initialize();
+  static void shutdown();
+  static ShenandoahHeuristicsTrace* trace() { return _trace; }
+
+  // Hooks for the heuristics and the generations, which do nothing unless a trace is open
+  static void record_event(ShenandoahSpaceInfo* space, Kind kind);
+  static void record_collection_set(ShenandoahGeneration* generation, ShenandoahCollectionSet* collection_set);
+
+  void write_trigger(const char* space, double time, const ShenandoahTriggerInputs& inputs, bool decision);
+  void write_event(const char* space, double time, Kind kind);
+  void write_collection_set(const char* space, double time, size_t free,
+                            const ShenandoahTraceRegion* regions, size_t count);
+  void flush();
+};
+
+// Reads back a trace written by ShenandoahHeuristicsTrace, one record at a time
+class ShenandoahHeuristicsTraceReader : public StackObj {
+private:
+  FILE* _file;
+  bool _valid;
+  size_t _region_size;
+  size_t _num_regions;
+  size_t _max_capacity;
+
+  ShenandoahHeuristicsTrace::Kind _kind;
+  double _time;
+  char _space[256];
+  ShenandoahTriggerInputs _inputs;
+  bool _decision;
+  size_t _free;
+  size_t _region_count;
+  ShenandoahTraceRegion* _regions;
+
+  bool get(void* data, size_t size);
+
+public:
+  explicit ShenandoahHeuristicsTraceReader(const char* path);
+  ~ShenandoahHeuristicsTraceReader();
+
+  // False when the file could not be opened or was not written by a compatible VM
+  bool is_valid() const        { return _valid; }
+  size_t region_size() const   { return _region_size; }
+  size_t num_regions() const   { return _num_regions; }
+  size_t max_capacity() const  { return _max_capacity; }
+
+  // Advances to the next record, returns false at the end of the trace or on a torn record
+  bool next();
+
+  ShenandoahHeuristicsTrace::Kind kind() const { return _kind; }
+  double time() const                          { return _time; }
+  const char* space() const                    { return _space; }
+
+  // Trigger records
+  const ShenandoahTriggerInputs& inputs() const { return _inputs; }
+  bool decision() const                         { return _decision; }
+
+  // Collection set records, the regions are valid until the next call to next()
+  size_t free() const                          { return _free; }
+  size_t region_count() const                  { return _region_count; }
+  const ShenandoahTraceRegion* regions() const { return _regions; }
+};
+
+#endif // SHARE_GC_SHENANDOAH_SHENANDOAHHEURISTICSTRACE_HPP
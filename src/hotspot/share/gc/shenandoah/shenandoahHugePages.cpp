@@ -0,0 +1,101 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#include "precompiled.hpp"
+
+#include "gc/shared/gc_globals.hpp"
+#include "gc/shenandoah/shenandoahHugePages.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/os.hpp"
+#include "utilities/ostream.hpp"
+
+#include <stdio.h>
+
+void ShenandoahHugePages::advise(char* start, size_t size) {
+#ifdef LINUX
+  if (UseTransparentHugePages && ShenandoahHugePageMetadata) {
+    os::realign_memory(start, size, os::large_page_size());
+  }
+#endif
+}
+
+bool ShenandoahHugePages::coverage(const void* start, const void* end, size_t* resident, size_t* huge) {
+  *resident = 0;
+  *huge = 0;
+#ifdef LINUX
+  FILE* smaps = os::fopen("/proc/self/smaps", "r");
+  if (smaps == nullptr) {
+    return false;
+  }
+
+  const uintptr_t lo = (uintptr_t) start;
+  const uintptr_t hi = (uintptr_t) end;
+
+  // Mappings are listed with their address range, followed by lines of
+  // "Key: value kB". Mappings that straddle the range count in proportion.
+  char line[512];
+  uintptr_t map_lo = 0, map_hi = 0;
+  bool in_range = false;
+  while (fgets(line, sizeof(line), smaps) != nullptr) {
+    unsigned long a, b;
+    if (sscanf(line, "%lx-%lx ", &a, &b) == 2) {
+      map_lo = (uintptr_t) a;
+      map_hi = (uintptr_t) b;
+      in_range = map_lo < hi && lo < map_hi;
+      continue;
+    }
+    if (!in_range) {
+      continue;
+    }
+    size_t kb;
+    size_t* total = nullptr;
+    if (sscanf(line, "Rss: " SIZE_FORMAT " kB", &kb) == 1) {
+      total = resident;
+    } else if (sscanf(line, "AnonHugePages: " SIZE_FORMAT " kB", &kb) == 1) {
+      total = huge;
+    }
+    if (total != nullptr) {
+      const uintptr_t overlap = MIN2(map_hi, hi) - MAX2(map_lo, lo);
+      *total += (size_t) ((double) kb * K * overlap / (map_hi - map_lo));
+    }
+  }
+  fclose(smaps);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void ShenandoahHugePages::print_coverage_on(outputStream* out, const char* name, const void* start, size_t size) {
+  size_t resident, huge;
+  if (!coverage(start, (const char*) start + size, &resident, &huge)) {
+    return;
+  }
+  out->print_cr("%-16s " SIZE_FORMAT_W(6) "%s resident, " SIZE_FORMAT_W(6) "%s (%5.1f%%) in huge pages",
+                name,
+                byte_size_in_proper_unit(resident), proper_unit_for_byte_size(resident),
+                byte_size_in_proper_unit(huge),     proper_unit_for_byte_size(huge),
+                resident == 0 ? 0.0 : 100.0 * huge / resident);
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#ifndef SHARE_GC_SHENANDOAH_SHENANDOAHHUGEPAGES_HPP
+#define SHARE_GC_SHENANDOAH_SHENANDOAHHUGEPAGES_HPP
+
+#include "memory/allStatic.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+class outputStream;
+
+// Support for transparent huge pages in "madvise" mode. Memory that is committed with
+// a large page alignment hint is advised for huge pages on commit. These helpers cover
+// the structures that are committed otherwise, and report how much of a range the
+// kernel actually backs with huge pages.
+class ShenandoahHugePages : public AllStatic {
+public:
+  // Advises huge pages for a committed range, when transparent huge pages are in use
+  static void advise(char* start, size_t size);
+
+  // Resident and huge page backed bytes of [start, end). Returns false when the
+  // operating system does not tell.
+  static bool coverage(const void* start, const void* end, size_t* resident, size_t* huge);
+
+  // Prints one line for the range, or nothing if the coverage is not known
+  static void print_coverage_on(outputStream* out, const char* name, const void* start, size_t size);
+};
+
+#endif // SHARE_GC_SHENANDOAH_SHENANDOAHHUGEPAGES_HPP
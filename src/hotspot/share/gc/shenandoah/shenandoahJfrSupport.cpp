@@ -69,3 +69,63 @@ void VM_ShenandoahSendHeapRegionInfoEvents::doit() {
   ShenandoahDumpHeapRegionInfoClosure c;
   ShenandoahHeap::heap()->heap_region_iterate(&c);
 }
+
+// Regions are visited in index order, so a humongous object is its start region followed
+// by its continuations. Sizes come from region usage, objects being allocated are not parsable.
+class ShenandoahHumongousSummaryClosure : public ShenandoahHeapRegionClosure {
+private:
+  size_t _objects;
+  size_t _regions;
+  size_t _used;
+  size_t _largest;
+  size_t _single_region;
+  size_t _current_regions;
+  size_t _current_used;
+
+  void finish_object() {
+    if (_current_regions == 1) {
+      _single_region++;
+    }
+    _largest = MAX2(_largest, _current_used);
+    _current_regions = 0;
+    _current_used = 0;
+  }
+
+public:
+  ShenandoahHumongousSummaryClosure() :
+    _objects(0), _regions(0), _used(0), _largest(0), _single_region(0),
+    _current_regions(0), _current_used(0) {}
+
+  virtual void heap_region_do(ShenandoahHeapRegion* r) {
+    if (r->is_humongous_start()) {
+      finish_object();
+      _objects++;
+    } else if (!r->is_humongous_continuation()) {
+      finish_object();
+      return;
+    }
+    _regions++;
+    _used += r->used();
+    _current_regions++;
+    _current_used += r->used();
+  }
+
+  void commit() {
+    finish_object();
+    EventShenandoahHumongousSummary evt;
+    evt.set_objects(_objects);
+    evt.set_regions(_regions);
+    evt.set_used(_used);
+    evt.set_waste(_regions * ShenandoahHeapRegion::region_size_bytes() - _used);
+    evt.set_largestObject(_largest);
+    evt.set_singleRegionObjects(_single_region);
+    evt.set_multiRegionObjects(_objects - _single_region);
+    evt.commit();
+  }
+};
+
+void VM_ShenandoahSendHumongousSummaryEvent::doit() {
+  ShenandoahHumongousSummaryClosure c;
+  ShenandoahHeap::heap()->heap_region_iterate(&c);
+  c.commit();
+}
@@ -33,6 +33,12 @@ public:
   virtual VMOp_Type type() const { return VMOp_HeapIterateOperation; }
 };
 
+class VM_ShenandoahSendHumongousSummaryEvent : public VM_Operation {
+public:
+  virtual void doit();
+  virtual VMOp_Type type() const { return VMOp_HeapIterateOperation; }
+};
+
 class ShenandoahJFRSupport {
 public:
   static void register_jfr_type_serializers();
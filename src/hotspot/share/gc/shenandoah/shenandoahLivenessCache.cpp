@@ -0,0 +1,65 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#include "precompiled.hpp"
+
+#include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahHeapRegion.inline.hpp"
+#include "gc/shenandoah/shenandoahLivenessCache.inline.hpp"
+#include "utilities/powerOfTwo.hpp"
+
+ShenandoahLivenessCache::ShenandoahLivenessCache(size_t slots) {
+  assert(is_power_of_2(slots), "slots should be a power of two: " SIZE_FORMAT, slots);
+  _entries = NEW_C_HEAP_ARRAY(Entry, slots, mtGC);
+  _dirty = NEW_C_HEAP_ARRAY(uint32_t, slots, mtGC);
+  _mask = (uint32_t) (slots - 1);
+  _dirty_count = 0;
+  for (size_t i = 0; i < slots; i++) {
+    _entries[i]._region = EmptySlot;
+    _entries[i]._words = 0;
+  }
+}
+
+ShenandoahLivenessCache::~ShenandoahLivenessCache() {
+  FREE_C_HEAP_ARRAY(Entry, _entries);
+  FREE_C_HEAP_ARRAY(uint32_t, _dirty);
+}
+
+void ShenandoahLivenessCache::flush_entry(ShenandoahHeap* heap, Entry* e) {
+  if (e->_words > 0) {
+    heap->get_region(e->_region)->increase_live_data_gc_words(e->_words);
+  }
+}
+
+void ShenandoahLivenessCache::flush(ShenandoahHeap* heap) {
+  for (uint32_t i = 0; i < _dirty_count; i++) {
+    Entry* const e = &_entries[_dirty[i]];
+    assert(e->_region != EmptySlot, "dirty slot should be claimed");
+    flush_entry(heap, e);
+    e->_region = EmptySlot;
+    e->_words = 0;
+  }
+  _dirty_count = 0;
+}
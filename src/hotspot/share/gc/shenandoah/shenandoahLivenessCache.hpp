@@ -0,0 +1,74 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#ifndef SHARE_GC_SHENANDOAH_SHENANDOAHLIVENESSCACHE_HPP
+#define SHARE_GC_SHENANDOAH_SHENANDOAHLIVENESSCACHE_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+class ShenandoahHeap;
+
+// Used for buffering per-region liveness data during marking.
+// Needed since ShenandoahHeapRegion uses atomics to update liveness.
+//
+// Each worker owns one cache. The cache is a small, direct-mapped table indexed by the low bits of
+// the region index, so that a worker marking a handful of neighbouring regions keeps all of its
+// counters in a few cache lines no matter how many regions the heap has. When a slot is claimed by
+// a different region, the previous owner is flushed to its region with one atomic add. Claimed
+// slots are remembered, so flushing at the end of marking only visits the regions that were
+// actually touched.
+class ShenandoahLivenessCache : public CHeapObj<mtGC> {
+private:
+  static const uint32_t EmptySlot = UINT32_MAX;
+
+  struct Entry {
+    uint32_t _region;
+    uint32_t _words;
+  };
+
+  Entry*   _entries;
+  uint32_t _mask;
+
+  // Slots claimed since the last flush, in claim order.
+  uint32_t* _dirty;
+  uint32_t  _dirty_count;
+
+  static void flush_entry(ShenandoahHeap* heap, Entry* e);
+
+public:
+  explicit ShenandoahLivenessCache(size_t slots);
+  ~ShenandoahLivenessCache();
+
+  // Account live words of a non-humongous object in region_idx.
+  inline void add(ShenandoahHeap* heap, size_t region_idx, size_t words);
+
+  // Push all cached liveness to the regions and leave the cache empty.
+  void flush(ShenandoahHeap* heap);
+
+  bool is_empty() const { return _dirty_count == 0; }
+};
+
+#endif // SHARE_GC_SHENANDOAH_SHENANDOAHLIVENESSCACHE_HPP
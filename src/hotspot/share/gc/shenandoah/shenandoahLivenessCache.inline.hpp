@@ -0,0 +1,65 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#ifndef SHARE_GC_SHENANDOAH_SHENANDOAHLIVENESSCACHE_INLINE_HPP
+#define SHARE_GC_SHENANDOAH_SHENANDOAHLIVENESSCACHE_INLINE_HPP
+
+#include "gc/shenandoah/shenandoahLivenessCache.hpp"
+
+#include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahHeapRegion.inline.hpp"
+
+inline void ShenandoahLivenessCache::add(ShenandoahHeap* heap, size_t region_idx, size_t words) {
+  assert(region_idx < EmptySlot, "region index fits: " SIZE_FORMAT, region_idx);
+  Entry* const e = &_entries[region_idx & _mask];
+  if (e->_region == region_idx) {
+    const size_t new_val = words + e->_words;
+    if (new_val >= EmptySlot) {
+      // overflow, flush to region data
+      heap->get_region(region_idx)->increase_live_data_gc_words(new_val);
+      e->_words = 0;
+    } else {
+      // still good, remember in cache
+      e->_words = (uint32_t) new_val;
+    }
+    return;
+  }
+
+  if (e->_region == EmptySlot) {
+    _dirty[_dirty_count++] = (uint32_t) (e - _entries);
+  } else {
+    // Slot conflict, the previous owner goes to its region
+    flush_entry(heap, e);
+  }
+  e->_region = (uint32_t) region_idx;
+  if (words >= EmptySlot) {
+    heap->get_region(region_idx)->increase_live_data_gc_words(words);
+    e->_words = 0;
+  } else {
+    e->_words = (uint32_t) words;
+  }
+}
+
+#endif // SHARE_GC_SHENANDOAH_SHENANDOAHLIVENESSCACHE_INLINE_HPP
@@ -31,6 +31,7 @@
 #include "gc/shenandoah/shenandoahGeneration.hpp"
 #include "gc/shenandoah/shenandoahMark.inline.hpp"
 #include "gc/shenandoah/shenandoahOopClosures.inline.hpp"
+#include "gc/shenandoah/shenandoahPhaseTimings.hpp"
 #include "gc/shenandoah/shenandoahReferenceProcessor.hpp"
 #include "gc/shenandoah/shenandoahTaskqueue.inline.hpp"
 #include "gc/shenandoah/shenandoahUtils.hpp"
@@ -70,7 +71,7 @@ void ShenandoahMark::mark_loop_prework(uint w, TaskTerminator *t, ShenandoahRefe
   ShenandoahObjToScanQueue* old_q = get_old_queue(w);
 
   ShenandoahHeap* const heap = ShenandoahHeap::heap();
-  ShenandoahLiveData* ld = heap->get_liveness_cache(w);
+  ShenandoahLivenessCache* ld = heap->get_liveness_cache(w);
 
   // TODO: We can clean up this if we figure out how to do templated oop closures that
   // play nice with specialized_oop_iterators.
@@ -87,6 +88,93 @@ void ShenandoahMark::mark_loop_prework(uint w, TaskTerminator *t, ShenandoahRefe
   heap->flush_liveness_cache(w);
 }
 
+bool ShenandoahMark::assist() {
+  ShenandoahHeap* const heap = ShenandoahHeap::heap();
+  if (!heap->is_concurrent_mark_in_progress() || heap->has_forwarded_objects() || heap->cancelled_gc()) {
+    return false;
+  }
+
+  ShenandoahGeneration* const generation = heap->active_generation();
+  ShenandoahObjToScanQueueSet* const queues = generation->task_queues();
+  const uint queue_id = queues->claim_assist_queue();
+  if (queue_id == UINT_MAX) {
+    return false;
+  }
+  assert(generation->type() == NON_GEN, "Only non-generational marking has assist queues");
+
+  ShenandoahMark mark(generation);
+  bool worked = mark.assist_work(queue_id);
+  queues->release_assist_queue(queue_id);
+  return worked;
+}
+
+bool ShenandoahMark::assist_work(uint queue_id) {
+  ShenandoahHeap* const heap = ShenandoahHeap::heap();
+  ShenandoahObjToScanQueueSet* const queues = task_queues();
+  ShenandoahObjToScanQueue* const q = queues->queue(queue_id);
+  ShenandoahLivenessCache* const ld = heap->get_liveness_cache(queue_id);
+
+  // Reference discovery keeps per-worker lists, so assisting threads do not discover.
+  // They trace the referents of the references they scan as strongly reachable instead.
+  using Closure = ShenandoahMarkRefsClosure<NON_GEN>;
+  Closure cl(q, nullptr, nullptr);
+
+  ShenandoahSATBBufferClosure<NON_GEN> drain_satb(q, nullptr);
+  bool worked = ShenandoahBarrierSet::satb_mark_queue_set().apply_closure_to_completed_buffer(&drain_satb);
+
+  ShenandoahMarkTask t;
+  for (uintx i = 0; i < ShenandoahMarkAssistTasks; i++) {
+    if (!q->pop(t) && !queues->steal(queue_id, t)) {
+      break;
+    }
+    do_task<Closure, NON_GEN, NO_DEDUP>(q, &cl, ld, nullptr, &t, queue_id);
+    worked = true;
+  }
+
+  // The queue is only stolen from until this thread assists again. Keep working on
+  // whatever tasks thieves could not take.
+  while (!q->publish() && q->pop(t)) {
+    do_task<Closure, NON_GEN, NO_DEDUP>(q, &cl, ld, nullptr, &t, queue_id);
+  }
+
+  // Flushing liveness reports the progress to the pacer, which repays the budget.
+  heap->flush_liveness_cache(queue_id);
+  return worked;
+}
+
+size_t ShenandoahMark::mark_old_tasks(uint worker_id, size_t budget) {
+  ShenandoahHeap* const heap = ShenandoahHeap::heap();
+  ShenandoahObjToScanQueueSet* const queues = old_task_queues();
+  assert(queues != nullptr, "Only while old marking is in progress");
+  ShenandoahObjToScanQueue* const q = queues->queue(worker_id);
+  ShenandoahLivenessCache* const ld = heap->get_liveness_cache(worker_id);
+
+  // The old reference processor is not ours to discover with, so referents are traced
+  // as strongly reachable, as assisting threads do. This only delays their reclamation.
+  using Closure = ShenandoahMarkRefsClosure<OLD>;
+  Closure cl(q, nullptr, nullptr);
+
+  ShenandoahMarkTask t;
+  size_t done = 0;
+  while (done < budget && !heap->cancelled_gc()) {
+    if (!q->pop(t) && !queues->steal(worker_id, t)) {
+      break;
+    }
+    do_task<Closure, OLD, NO_DEDUP>(q, &cl, ld, nullptr, &t, worker_id);
+    done++;
+  }
+
+  // Whatever is left in the queues is picked up when the old cycle resumes.
+  heap->flush_liveness_cache(worker_id);
+  return done;
+}
+
+ShenandoahMarkPrefetchRing::ShenandoahMarkPrefetchRing() :
+  _distance(MIN2((uint) ShenandoahMarkLoopPrefetch, Capacity)),
+  _head(0),
+  _count(0) {
+}
+
 template<bool CANCELLABLE, StringDedupMode STRING_DEDUP>
 void ShenandoahMark::mark_loop(uint worker_id, TaskTerminator* terminator, ShenandoahReferenceProcessor *rp,
                                ShenandoahGenerationType generation, StringDedup::Requests* const req) {
@@ -109,6 +197,9 @@ void ShenandoahMark::mark_loop(uint worker_id, TaskTerminator* terminator, Shena
       ShouldNotReachHere();
       break;
   }
+
+  ShenandoahStealStats stats = task_queues()->flush_steal_stats(worker_id);
+  ShenandoahHeap::heap()->phase_timings()->record_mark_stealing(worker_id, stats._steals, stats._attempts, stats._idle);
 }
 
 void ShenandoahMark::mark_loop(uint worker_id, TaskTerminator* terminator, ShenandoahReferenceProcessor *rp,
@@ -141,7 +232,7 @@ void ShenandoahMark::mark_loop(uint worker_id, TaskTerminator* terminator, Shena
 }
 
 template <class T, ShenandoahGenerationType GENERATION, bool CANCELLABLE, StringDedupMode STRING_DEDUP>
-void ShenandoahMark::mark_loop_work(T* cl, ShenandoahLiveData* live_data, uint worker_id, TaskTerminator *terminator, StringDedup::Requests* const req) {
+void ShenandoahMark::mark_loop_work(T* cl, ShenandoahLivenessCache* live_data, uint worker_id, TaskTerminator *terminator, StringDedup::Requests* const req) {
   uintx stride = ShenandoahMarkLoopStride;
 
   ShenandoahHeap* heap = ShenandoahHeap::heap();
@@ -162,27 +253,37 @@ void ShenandoahMark::mark_loop_work(T* cl, ShenandoahLiveData* live_data, uint w
   assert(queues->get_reserved() == heap->workers()->active_workers(),
          "Need to reserve proper number of queues: reserved: %u, active: %u", queues->get_reserved(), heap->workers()->active_workers());
 
+  // Popped tasks wait in the ring for their prefetches. The ring is drained at the end of every
+  // stride, so that no task is held back across yields, queue switches or termination.
+  ShenandoahMarkPrefetchRing ring;
+
   q = queues->claim_next();
   while (q != nullptr) {
     if (CANCELLABLE && heap->check_cancelled_gc_and_yield()) {
       return;
     }
 
+    ShenandoahObjToScanQueue* cur_q = q;
     for (uint i = 0; i < stride; i++) {
       if (q->pop(t)) {
-        do_task<T, GENERATION, STRING_DEDUP>(q, cl, live_data, req, &t, worker_id);
+        if (ring.exchange(&t)) {
+          do_task<T, GENERATION, STRING_DEDUP>(q, cl, live_data, req, &t, worker_id);
+        }
       } else {
         assert(q->is_empty(), "Must be empty");
         q = queues->claim_next();
         break;
       }
     }
+    while (ring.pop(&t)) {
+      do_task<T, GENERATION, STRING_DEDUP>(cur_q, cl, live_data, req, &t, worker_id);
+    }
   }
   q = get_queue(worker_id);
   ShenandoahObjToScanQueue* old_q = get_old_queue(worker_id);
 
   ShenandoahSATBBufferClosure<GENERATION> drain_satb(q, old_q);
-  SATBMarkQueueSet& satb_mq_set = ShenandoahBarrierSet::satb_mark_queue_set();
+  ShenandoahSATBMarkQueueSet& satb_mq_set = ShenandoahBarrierSet::satb_mark_queue_set();
 
   /*
    * Normal marking loop:
@@ -191,27 +292,42 @@ void ShenandoahMark::mark_loop_work(T* cl, ShenandoahLiveData* live_data, uint w
     if (CANCELLABLE && heap->check_cancelled_gc_and_yield()) {
       return;
     }
-    while (satb_mq_set.completed_buffers_num() > 0) {
-      satb_mq_set.apply_closure_to_completed_buffer(&drain_satb);
+    if (ShenandoahSATBLowPriorityDrain && !q->is_empty()) {
+      // Local work is available: only take a buffer produced on this node, and leave the rest
+      // for when the queue runs dry. Every stride that finds no work drains everything first.
+      satb_mq_set.apply_closure_to_local_completed_buffer(&drain_satb);
+    } else {
+      while (satb_mq_set.completed_buffers_num() > 0) {
+        satb_mq_set.apply_closure_to_completed_buffer(&drain_satb);
+      }
     }
 
     uint work = 0;
     for (uint i = 0; i < stride; i++) {
       if (q->pop(t) ||
           queues->steal(worker_id, t)) {
-        do_task<T, GENERATION, STRING_DEDUP>(q, cl, live_data, req, &t, worker_id);
+        if (ring.exchange(&t)) {
+          do_task<T, GENERATION, STRING_DEDUP>(q, cl, live_data, req, &t, worker_id);
+        }
         work++;
       } else {
         break;
       }
     }
+    while (ring.pop(&t)) {
+      do_task<T, GENERATION, STRING_DEDUP>(q, cl, live_data, req, &t, worker_id);
+    }
 
     if (work == 0) {
+      queues->record_idle(worker_id);
       // No work encountered in current stride, try to terminate.
       // Need to leave the STS here otherwise it might block safepoints.
       ShenandoahSuspendibleThreadSetLeaver stsl(CANCELLABLE);
       ShenandoahTerminatorTerminator tt(heap);
-      if (terminator->offer_termination(&tt)) return;
+      queues->enter_idle();
+      bool terminated = terminator->offer_termination(&tt);
+      queues->exit_idle();
+      if (terminated) return;
     }
   }
 }
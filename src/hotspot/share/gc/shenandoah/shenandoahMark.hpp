@@ -40,9 +40,33 @@ enum StringDedupMode {
   ALWAYS_DEDUP   // Enqueue Strings for deduplication
 };
 
+class ShenandoahLivenessCache;
 class ShenandoahMarkingContext;
 class ShenandoahReferenceProcessor;
 
+// A small per-worker FIFO that holds popped mark tasks back for ShenandoahMarkLoopPrefetch steps.
+// The header of each task's object is prefetched when the task enters the ring, so that the
+// cache miss is overlapped with scanning the tasks ahead of it.
+class ShenandoahMarkPrefetchRing : public StackObj {
+private:
+  static const uint Capacity = 64;
+
+  ShenandoahMarkTask _tasks[Capacity];
+  const uint _distance;
+  uint _head;
+  uint _count;
+
+public:
+  ShenandoahMarkPrefetchRing();
+
+  // Prefetches and enqueues *task. Returns true with the oldest task in *task if that task is due
+  // for processing, false if *task was only enqueued.
+  inline bool exchange(ShenandoahMarkTask* task);
+
+  // Dequeues the oldest task, regardless of whether its prefetch had time to complete.
+  inline bool pop(ShenandoahMarkTask* task);
+};
+
 // Base class for mark
 // Mark class does not maintain states. Instead, mark states are
 // maintained by task queues, mark bitmap and SATB buffers (concurrent mark)
@@ -74,11 +98,19 @@ public:
 
   inline ShenandoahGeneration* generation() { return _generation; };
 
+  // Lets the current allocating thread do some of the concurrent marking work, instead of
+  // waiting for pacing. Returns false if it found no work, or could not get an assist queue.
+  static bool assist();
+
+  // Lets a young cycle trace up to budget tasks from the old generation mark queues, so that
+  // old marking makes progress while young cycles keep interrupting it. Returns the tasks done.
+  size_t mark_old_tasks(uint worker_id, size_t budget);
+
 private:
 // ---------- Marking loop and tasks
 
   template <class T, ShenandoahGenerationType GENERATION, StringDedupMode STRING_DEDUP>
-  inline void do_task(ShenandoahObjToScanQueue* q, T* cl, ShenandoahLiveData* live_data, StringDedup::Requests* const req, ShenandoahMarkTask* task, uint worker_id);
+  inline void do_task(ShenandoahObjToScanQueue* q, T* cl, ShenandoahLivenessCache* live_data, StringDedup::Requests* const req, ShenandoahMarkTask* task, uint worker_id);
 
   template <class T>
   inline void do_chunked_array_start(ShenandoahObjToScanQueue* q, T* cl, oop array, bool weak);
@@ -86,11 +118,28 @@ private:
   template <class T>
   inline void do_chunked_array(ShenandoahObjToScanQueue* q, T* cl, oop array, int chunk, int pow, bool weak);
 
+  // Large continuation stack chunks are split in the same way as arrays, over the bits of
+  // the chunk's oop bitmap. The start returns false if the chunk is not worth splitting.
+  template <class T, class OopT>
+  inline bool do_chunked_stack_chunk_start(ShenandoahObjToScanQueue* q, T* cl, stackChunkOop chunk);
+
+  template <class T, class OopT>
+  inline void do_chunked_stack_chunk(ShenandoahObjToScanQueue* q, T* cl, stackChunkOop chunk, int chunk_id, int pow);
+
+  template <class T, class OopT>
+  inline void do_stack_chunk_range(T* cl, stackChunkOop chunk, BitMap::idx_t from, BitMap::idx_t to);
+
+  // Number of array elements below which array chunks are not split further. Adapts to
+  // the demand for work when ShenandoahAdaptiveArrayChunking is enabled.
+  inline int array_chunk_stride(ShenandoahObjToScanQueue* q) const;
+
   template <ShenandoahGenerationType GENERATION>
-  inline void count_liveness(ShenandoahLiveData* live_data, oop obj, uint worker_id);
+  inline void count_liveness(ShenandoahLivenessCache* live_data, oop obj, uint worker_id);
 
   template <class T, ShenandoahGenerationType GENERATION, bool CANCELLABLE, StringDedupMode STRING_DEDUP>
-  void mark_loop_work(T* cl, ShenandoahLiveData* live_data, uint worker_id, TaskTerminator *t, StringDedup::Requests* const req);
+  void mark_loop_work(T* cl, ShenandoahLivenessCache* live_data, uint worker_id, TaskTerminator *t, StringDedup::Requests* const req);
+
+  bool assist_work(uint queue_id);
 
   template <ShenandoahGenerationType GENERATION, bool CANCELLABLE, StringDedupMode STRING_DEDUP>
   void mark_loop_prework(uint worker_id, TaskTerminator *terminator, ShenandoahReferenceProcessor *rp, StringDedup::Requests* const req, bool update_refs);
@@ -101,6 +150,9 @@ private:
   template <class T>
   static void mark_non_generational_ref(T *p, ShenandoahObjToScanQueue* q, ShenandoahMarkingContext* const mark_context, bool weak);
 
+  template <class T>
+  static void record_ref_summary(T* p, oop obj);
+
   static void mark_ref(ShenandoahObjToScanQueue* q,
                        ShenandoahMarkingContext* const mark_context,
                        bool weak, oop obj);
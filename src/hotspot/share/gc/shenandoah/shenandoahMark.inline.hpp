@@ -32,7 +32,9 @@
 #include "gc/shenandoah/shenandoahAgeCensus.hpp"
 #include "gc/shenandoah/shenandoahAsserts.hpp"
 #include "gc/shenandoah/shenandoahBarrierSet.inline.hpp"
+#include "gc/shenandoah/shenandoahClassHistogram.hpp"
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahLivenessCache.inline.hpp"
 #include "gc/shenandoah/shenandoahMarkingContext.inline.hpp"
 #include "gc/shenandoah/shenandoahOldGeneration.hpp"
 #include "gc/shenandoah/shenandoahOopClosures.inline.hpp"
@@ -42,11 +44,40 @@
 #include "gc/shenandoah/shenandoahUtils.hpp"
 #include "memory/iterator.inline.hpp"
 #include "oops/compressedOops.inline.hpp"
+#include "oops/instanceStackChunkKlass.inline.hpp"
 #include "oops/oop.inline.hpp"
+#include "oops/stackChunkOop.inline.hpp"
 #include "runtime/prefetch.inline.hpp"
 #include "utilities/devirtualizer.inline.hpp"
 #include "utilities/powerOfTwo.hpp"
 
+inline bool ShenandoahMarkPrefetchRing::exchange(ShenandoahMarkTask* task) {
+  if (_distance == 0) {
+    return true;
+  }
+  Prefetch::read(task->obj(), oopDesc::mark_offset_in_bytes());
+  if (_count < _distance) {
+    _tasks[(_head + _count) % Capacity] = *task;
+    _count++;
+    return false;
+  }
+  ShenandoahMarkTask oldest = _tasks[_head];
+  _tasks[(_head + _count) % Capacity] = *task;
+  _head = (_head + 1) % Capacity;
+  *task = oldest;
+  return true;
+}
+
+inline bool ShenandoahMarkPrefetchRing::pop(ShenandoahMarkTask* task) {
+  if (_count == 0) {
+    return false;
+  }
+  *task = _tasks[_head];
+  _head = (_head + 1) % Capacity;
+  _count--;
+  return true;
+}
+
 template <StringDedupMode STRING_DEDUP>
 void ShenandoahMark::dedup_string(oop obj, StringDedup::Requests* const req) {
   if (STRING_DEDUP == ENQUEUE_DEDUP) {
@@ -55,14 +86,14 @@ void ShenandoahMark::dedup_string(oop obj, StringDedup::Requests* const req) {
     }
   } else if (STRING_DEDUP == ALWAYS_DEDUP) {
     if (ShenandoahStringDedup::is_string_candidate(obj) &&
-        !ShenandoahStringDedup::dedup_requested(obj)) {
+        ShenandoahStringDedup::try_request(obj)) {
         req->add(obj);
     }
   }
 }
 
 template <class T, ShenandoahGenerationType GENERATION, StringDedupMode STRING_DEDUP>
-void ShenandoahMark::do_task(ShenandoahObjToScanQueue* q, T* cl, ShenandoahLiveData* live_data, StringDedup::Requests* const req, ShenandoahMarkTask* task, uint worker_id) {
+void ShenandoahMark::do_task(ShenandoahObjToScanQueue* q, T* cl, ShenandoahLivenessCache* live_data, StringDedup::Requests* const req, ShenandoahMarkTask* task, uint worker_id) {
   oop obj = task->obj();
 
   // TODO: This will push array chunks into the mark queue with no regard for
@@ -86,7 +117,15 @@ void ShenandoahMark::do_task(ShenandoahObjToScanQueue* q, T* cl, ShenandoahLiveD
           cl->set_weak(false);
       }
 
-      obj->oop_iterate(cl);
+      bool chunked = false;
+      if (ShenandoahChunkedStackChunkMarking && obj->is_stackChunk()) {
+        stackChunkOop chunk = stackChunkOopDesc::cast(obj);
+        chunked = UseCompressedOops ? do_chunked_stack_chunk_start<T, narrowOop>(q, cl, chunk)
+                                    : do_chunked_stack_chunk_start<T, oop>(q, cl, chunk);
+      }
+      if (!chunked) {
+        obj->oop_iterate(cl);
+      }
       dedup_string<STRING_DEDUP>(obj, req);
     } else if (obj->is_objArray()) {
       // Case 2: Object array instance and no chunk is set. Must be the first
@@ -105,44 +144,53 @@ void ShenandoahMark::do_task(ShenandoahObjToScanQueue* q, T* cl, ShenandoahLiveD
     if (task->count_liveness()) {
       count_liveness<GENERATION>(live_data, obj, worker_id);
     }
-  } else {
+  } else if (obj->is_objArray()) {
     // Case 4: Array chunk, has sensible chunk id. Process it.
     do_chunked_array<T>(q, cl, obj, task->chunk(), task->pow(), weak);
+  } else {
+    // Case 5: Stack chunk frames, the chunk id points into the oop bitmap.
+    stackChunkOop chunk = stackChunkOopDesc::cast(obj);
+    cl->set_weak(false);
+    if (UseCompressedOops) {
+      do_chunked_stack_chunk<T, narrowOop>(q, cl, chunk, task->chunk(), task->pow());
+    } else {
+      do_chunked_stack_chunk<T, oop>(q, cl, chunk, task->chunk(), task->pow());
+    }
   }
 }
 
 template <ShenandoahGenerationType GENERATION>
-inline void ShenandoahMark::count_liveness(ShenandoahLiveData* live_data, oop obj, uint worker_id) {
-  const ShenandoahHeap* const heap = ShenandoahHeap::heap();
+inline void ShenandoahMark::count_liveness(ShenandoahLivenessCache* live_data, oop obj, uint worker_id) {
+  ShenandoahHeap* const heap = ShenandoahHeap::heap();
   const size_t region_idx = heap->heap_region_index_containing(obj);
   ShenandoahHeapRegion* const region = heap->get_region(region_idx);
   const size_t size = obj->size();
 
+#if INCLUDE_SERVICES
+  // Old marking only sees part of the heap, the histogram is only recorded by global marking.
+  if (GENERATION != OLD && ShenandoahMarkingClassHistogram) {
+    heap->class_histogram()->record(worker_id, obj);
+  }
+#endif
+
   // Age census for objects in the young generation
   if (GENERATION == YOUNG || (GENERATION == GLOBAL && region->is_young())) {
     assert(heap->mode()->is_generational(), "Only if generational");
     if (ShenandoahGenerationalAdaptiveTenuring && !ShenandoahGenerationalCensusAtEvac) {
       assert(region->is_young(), "Only for young objects");
-      uint age = ShenandoahHeap::get_object_age(obj);
       ShenandoahAgeCensus* const census = ShenandoahGenerationalHeap::heap()->age_census();
-      CENSUS_NOISE(census->add(age, region->age(), region->youth(), size, worker_id);)
-      NO_CENSUS_NOISE(census->add(age, region->age(), size, worker_id);)
+      if (census->should_sample(worker_id)) {
+        uint age = ShenandoahHeap::get_object_age(obj);
+        CENSUS_NOISE(census->add(age, region->age(), region->youth(), size, worker_id);)
+        NO_CENSUS_NOISE(census->add(age, region->age(), size, worker_id);)
+      }
     }
   }
 
   if (!region->is_humongous_start()) {
     assert(!region->is_humongous(), "Cannot have continuations here");
     assert(region->is_affiliated(), "Do not count live data within Free Regular Region " SIZE_FORMAT, region_idx);
-    ShenandoahLiveData cur = live_data[region_idx];
-    size_t new_val = size + cur;
-    if (new_val >= SHENANDOAH_LIVEDATA_MAX) {
-      // overflow, flush to region data
-      region->increase_live_data_gc_words(new_val);
-      live_data[region_idx] = 0;
-    } else {
-      // still good, remember in locals
-      live_data[region_idx] = (ShenandoahLiveData) new_val;
-    }
+    live_data->add(heap, region_idx, size);
   } else {
     shenandoah_assert_in_correct_region(nullptr, obj);
     size_t num_regions = ShenandoahHeapRegion::required_regions(size * HeapWordSize);
@@ -157,6 +205,22 @@ inline void ShenandoahMark::count_liveness(ShenandoahLiveData* live_data, oop ob
   }
 }
 
+inline int ShenandoahMark::array_chunk_stride(ShenandoahObjToScanQueue* q) const {
+  const int stride = (int) ObjArrayMarkingStride;
+  if (!ShenandoahAdaptiveArrayChunking) {
+    return stride;
+  }
+  if (_task_queues->idle_workers() > 0) {
+    // Some workers are out of work: split finer, so that the array can be shared among them.
+    return MAX2(stride / 4, 1);
+  }
+  if (q->size() >= ShenandoahAdaptiveArrayChunkingQueueDepth) {
+    // Plenty of work to steal from this queue: coarse chunks cost fewer tasks.
+    return stride * 4;
+  }
+  return stride;
+}
+
 template <class T>
 inline void ShenandoahMark::do_chunked_array_start(ShenandoahObjToScanQueue* q, T* cl, oop obj, bool weak) {
   assert(obj->is_objArray(), "expect object array");
@@ -168,7 +232,8 @@ inline void ShenandoahMark::do_chunked_array_start(ShenandoahObjToScanQueue* q,
     Devirtualizer::do_klass(cl, array->klass());
   }
 
-  if (len <= (int) ObjArrayMarkingStride*2) {
+  const int stride = array_chunk_stride(q);
+  if (len <= stride*2) {
     // A few slices only, process directly
     array->oop_iterate_range(cl, 0, len);
   } else {
@@ -200,7 +265,7 @@ inline void ShenandoahMark::do_chunked_array_start(ShenandoahObjToScanQueue* q,
 
     // Split out tasks, as suggested in ShenandoahMarkTask docs. Record the last
     // successful right boundary to figure out the irregular tail.
-    while ((1 << pow) > (int)ObjArrayMarkingStride &&
+    while ((1 << pow) > stride &&
            (chunk*2 < ShenandoahMarkTask::chunk_size())) {
       pow--;
       int left_chunk = chunk*2 - 1;
@@ -230,10 +295,11 @@ inline void ShenandoahMark::do_chunked_array(ShenandoahObjToScanQueue* q, T* cl,
   objArrayOop array = objArrayOop(obj);
 
   assert (ObjArrayMarkingStride > 0, "sanity");
+  const int stride = array_chunk_stride(q);
 
   // Split out tasks, as suggested in ShenandoahMarkTask docs. Avoid pushing tasks that
   // are known to start beyond the array.
-  while ((1 << pow) > (int)ObjArrayMarkingStride && (chunk*2 < ShenandoahMarkTask::chunk_size())) {
+  while ((1 << pow) > stride && (chunk*2 < ShenandoahMarkTask::chunk_size())) {
     pow--;
     chunk *= 2;
     bool pushed = q->push(ShenandoahMarkTask(array, true, weak, chunk - 1, pow));
@@ -254,6 +320,87 @@ inline void ShenandoahMark::do_chunked_array(ShenandoahObjToScanQueue* q, T* cl,
   array->oop_iterate_range(cl, from, to);
 }
 
+template <class T, class OopT>
+inline bool ShenandoahMark::do_chunked_stack_chunk_start(ShenandoahObjToScanQueue* q, T* cl, stackChunkOop chunk) {
+  if (!chunk->has_bitmap()) {
+    // Without the bitmap, every bounded walk has to go over all frames.
+    return false;
+  }
+
+  const int stride = array_chunk_stride(q);
+  const int live_from = (int) chunk->bit_index_for((OopT*) (chunk->sp_address() - frame::metadata_words_at_bottom));
+  const int len = (int) chunk->bit_index_for((OopT*) chunk->end_address());
+  if (len - live_from <= stride * 2) {
+    return false;
+  }
+
+  // Klass, methods and header oops: the bounded walk stops before the frames.
+  chunk->oop_iterate(cl, MemRegion(cast_from_oop<HeapWord*>(chunk), (HeapWord*) chunk->start_address()));
+
+  int bits = log2i_graceful(len);
+  if (len != (1 << bits)) bits++;
+  assert(bits < 31, "stack chunk bitmap is too large: %d", len);
+
+  // Same splitting as for arrays, except that chunks that end before the live frames
+  // are dropped instead of pushed.
+  int last_idx = 0;
+  int chunk_id = 1;
+  int pow = bits;
+  while ((1 << pow) > stride &&
+         (chunk_id * 2 < ShenandoahMarkTask::chunk_size())) {
+    pow--;
+    int left_chunk = chunk_id * 2 - 1;
+    int right_chunk = chunk_id * 2;
+    int left_chunk_end = left_chunk * (1 << pow);
+    if (left_chunk_end < len) {
+      if (left_chunk_end > live_from) {
+        bool pushed = q->push(ShenandoahMarkTask(chunk, true, false, left_chunk, pow));
+        assert(pushed, "overflow queue should always succeed pushing");
+      }
+      chunk_id = right_chunk;
+      last_idx = left_chunk_end;
+    } else {
+      chunk_id = left_chunk;
+    }
+  }
+
+  // Process the irregular tail, if present
+  if (last_idx < len) {
+    do_stack_chunk_range<T, OopT>(cl, chunk, last_idx, len);
+  }
+  return true;
+}
+
+template <class T, class OopT>
+inline void ShenandoahMark::do_chunked_stack_chunk(ShenandoahObjToScanQueue* q, T* cl, stackChunkOop chunk, int chunk_id, int pow) {
+  const int stride = array_chunk_stride(q);
+  const int live_from = (int) chunk->bit_index_for((OopT*) (chunk->sp_address() - frame::metadata_words_at_bottom));
+
+  while ((1 << pow) > stride && (chunk_id * 2 < ShenandoahMarkTask::chunk_size())) {
+    pow--;
+    chunk_id *= 2;
+    // Frames may have been thawed in the meantime, do not push chunks that hold none.
+    if ((chunk_id - 1) * (1 << pow) > live_from) {
+      bool pushed = q->push(ShenandoahMarkTask(chunk, true, false, chunk_id - 1, pow));
+      assert(pushed, "overflow queue should always succeed pushing");
+    }
+  }
+
+  int chunk_size = 1 << pow;
+  do_stack_chunk_range<T, OopT>(cl, chunk, (chunk_id - 1) * chunk_size, chunk_id * chunk_size);
+}
+
+template <class T, class OopT>
+inline void ShenandoahMark::do_stack_chunk_range(T* cl, stackChunkOop chunk, BitMap::idx_t from, BitMap::idx_t to) {
+  // Clip to the frames that are live now, like the bounded stack chunk walk does.
+  from = MAX2(from, chunk->bit_index_for((OopT*) (chunk->sp_address() - frame::metadata_words_at_bottom)));
+  to = MIN2(to, chunk->bit_index_for((OopT*) chunk->end_address()));
+  if (from < to) {
+    StackChunkOopIterateBitmapClosure<OopT, T> bitmap_closure(chunk, cl);
+    chunk->bitmap().iterate(&bitmap_closure, from, to);
+  }
+}
+
 template <ShenandoahGenerationType GENERATION>
 class ShenandoahSATBBufferClosure : public SATBBufferClosure {
 private:
@@ -354,6 +501,9 @@ template<class T>
 inline void ShenandoahMark::mark_non_generational_ref(T* p, ShenandoahObjToScanQueue* q,
                                                       ShenandoahMarkingContext* const mark_context, bool weak) {
   oop o = RawAccess<>::oop_load(p);
+  if (ShenandoahUpdateRefsRegionSummary) {
+    record_ref_summary(p, o);
+  }
   if (!CompressedOops::is_null(o)) {
     oop obj = CompressedOops::decode_not_null(o);
 
@@ -366,6 +516,19 @@ inline void ShenandoahMark::mark_non_generational_ref(T* p, ShenandoahObjToScanQ
   }
 }
 
+template<class T>
+inline void ShenandoahMark::record_ref_summary(T* p, oop obj) {
+  ShenandoahHeap* const heap = ShenandoahHeap::heap();
+  if (heap->is_in_reserved(p)) {
+    ShenandoahHeapRegion* r = heap->heap_region_containing(p);
+    if (r->is_humongous_continuation()) {
+      // Update-refs visits humongous objects from their start region.
+      r = r->humongous_start_region();
+    }
+    r->record_ref_field(heap, obj);
+  }
+}
+
 inline void ShenandoahMark::mark_ref(ShenandoahObjToScanQueue* q,
                               ShenandoahMarkingContext* const mark_context,
                               bool weak, oop obj) {
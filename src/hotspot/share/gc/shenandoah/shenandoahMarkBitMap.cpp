@@ -27,13 +27,37 @@
 #include "precompiled.hpp"
 #include "gc/shenandoah/shenandoahMarkBitMap.inline.hpp"
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahHeapRegion.hpp"
+#include "memory/allocation.hpp"
 #include "utilities/globalDefinitions.hpp"
+#include "utilities/powerOfTwo.hpp"
+
+// Chunks of 4K bytes of bitmap, unless the bitmap slice of a region is smaller
+static int log_dirty_chunk_words(int shift) {
+  size_t region_bitmap_words = ((ShenandoahHeapRegion::region_size_words() * 2) >> shift) / BitsPerWord;
+  return MIN2(log2i_exact(region_bitmap_words), 12 - LogBytesPerWord);
+}
+
+static volatile uint8_t* allocate_dirty_chunks(size_t num_chunks) {
+  uint8_t* chunks = NEW_C_HEAP_ARRAY(uint8_t, num_chunks, mtGC);
+  // The bitmap starts out zero
+  memset(chunks, 0, num_chunks);
+  return chunks;
+}
 
 ShenandoahMarkBitMap::ShenandoahMarkBitMap(MemRegion heap, MemRegion storage) :
   _shift(LogMinObjAlignment),
   _covered(heap),
   _map((BitMap::bm_word_t*) storage.start()),
-  _size((heap.word_size() * 2) >> _shift) {
+  _size((heap.word_size() * 2) >> _shift),
+  _log_dirty_chunk_words(log_dirty_chunk_words(_shift)),
+  _dirty_chunks(allocate_dirty_chunks(align_up(raw_to_words_align_up(_size), (size_t)1 << _log_dirty_chunk_words) >> _log_dirty_chunk_words)) {
+}
+
+ShenandoahMarkBitMap::bm_word_t* ShenandoahMarkBitMap::biased_map_address() const {
+  const int word_shift = address_to_index_shift() + LogBitsPerWord;
+  assert(is_aligned(_covered.start(), (size_t)1 << word_shift), "bias must not skip bits");
+  return _map - ((uintptr_t) _covered.start() >> word_shift);
 }
 
 size_t ShenandoahMarkBitMap::compute_size(size_t heap_size) {
@@ -77,6 +101,42 @@ HeapWord* ShenandoahMarkBitMap::get_next_marked_addr(const HeapWord* addr,
   return index_to_address(nextOffset);
 }
 
+size_t ShenandoahMarkBitMap::get_next_marked_addrs(const HeapWord* addr, const HeapWord* limit,
+                                                   HeapWord** addrs, size_t max, HeapWord** next) const {
+  assert(addr <= limit, "addr must not be above limit");
+
+  // Round addr up to a possible object boundary to be safe.
+  idx_t const limit_offset = address_to_index(limit);
+  idx_t offset = get_next_one_offset(address_to_index(align_up(addr, HeapWordSize << LogMinObjAlignment)), limit_offset);
+  size_t count = 0;
+  while (offset < limit_offset && count < max) {
+    idx_t const word_end = MIN2(bit_index(to_words_align_down(offset) + 1), limit_offset);
+    bm_word_t cword = map(to_words_align_down(offset)) >> bit_in_word(offset);
+    idx_t bit = offset;
+    while (cword != 0 && count < max) {
+      unsigned tz = count_trailing_zeros(cword);
+      bit += tz;
+      if (bit >= word_end) {
+        break;
+      }
+      addrs[count++] = index_to_address(bit);
+      // Each object has a strong and a weak bit, skip the rest of the pair.
+      idx_t skip = 2 - (bit & 1);
+      cword = (cword >> tz) >> skip;
+      bit += skip;
+    }
+    if (count == max) {
+      offset = bit;
+    } else if (word_end < limit_offset) {
+      offset = get_next_one_offset(word_end, limit_offset);
+    } else {
+      offset = limit_offset;
+    }
+  }
+  *next = (offset < limit_offset) ? index_to_address(offset) : const_cast<HeapWord*>(limit);
+  return count;
+}
+
 void ShenandoahMarkBitMap::clear_range_within_word(idx_t beg, idx_t end) {
   // With a valid range (beg <= end), this test ensures that end != 0, as
   // required by inverted_bit_mask_for_range.  Also avoids an unnecessary write.
@@ -129,10 +189,27 @@ void ShenandoahMarkBitMap::clear_large_range(idx_t beg, idx_t end) {
 
   // The range includes at least one full word.
   clear_range_within_word(beg, bit_index(beg_full_word));
-  clear_large_range_of_words(beg_full_word, end_full_word);
+  clear_dirty_range_of_words(beg_full_word, end_full_word);
   clear_range_within_word(bit_index(end_full_word), end);
 }
 
+void ShenandoahMarkBitMap::clear_dirty_range_of_words(idx_t beg, idx_t end) {
+  const idx_t chunk_words = (idx_t)1 << _log_dirty_chunk_words;
+  idx_t cur = beg;
+  while (cur < end) {
+    const idx_t chunk = cur >> _log_dirty_chunk_words;
+    const idx_t chunk_end = MIN2((chunk + 1) << _log_dirty_chunk_words, end);
+    if (Atomic::load(&_dirty_chunks[chunk]) != 0) {
+      clear_large_range_of_words(cur, chunk_end);
+      if (cur == (chunk << _log_dirty_chunk_words) && chunk_end - cur == chunk_words) {
+        // The whole chunk is zero again
+        Atomic::store(&_dirty_chunks[chunk], (uint8_t)0);
+      }
+    }
+    cur = chunk_end;
+  }
+}
+
 void ShenandoahMarkBitMap::clear_range_large(MemRegion mr) {
   MemRegion intersection = mr.intersection(_covered);
   assert(!intersection.is_empty(),
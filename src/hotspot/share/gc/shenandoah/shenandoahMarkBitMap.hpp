@@ -48,10 +48,23 @@ private:
   bm_word_t* _map;     // First word in bitmap
   idx_t      _size;    // Size of bitmap (in bits)
 
+  // One flag per chunk of bitmap words, set when marking turns a word of the chunk
+  // from zero to non-zero. A clear flag means that the whole chunk is zero, so that
+  // clearing large ranges only has to write to the chunks that were marked in.
+  // Chunks are never larger than the bitmap slice of a region.
+  int const               _log_dirty_chunk_words;
+  volatile uint8_t* const _dirty_chunks;
+
+  inline void note_dirty_word(idx_t bit);
+  void clear_dirty_range_of_words(idx_t beg, idx_t end);
+
   // Threshold for performing small range operation, even when large range
   // operation was requested. Measured in words.
   static const size_t small_range_words = 32;
 
+  // Number of words that searches test at once when skipping runs of empty words.
+  static const size_t skip_group_words = 8;
+
   static bool is_small_range_of_words(idx_t beg_full_word, idx_t end_full_word);
 
   inline size_t address_to_index(const HeapWord* addr) const;
@@ -142,6 +155,13 @@ public:
 
   ShenandoahMarkBitMap(MemRegion heap, MemRegion storage);
 
+  // The strong mark bit of an object is at index (address >> address_to_index_shift()),
+  // the weak mark bit follows it.
+  int address_to_index_shift() const { return LogHeapWordSize - 1 + _shift; }
+  // Bitmap words indexed by (address >> (address_to_index_shift() + LogBitsPerWord)), for
+  // barriers that test mark bits inline.
+  bm_word_t* biased_map_address() const;
+
   // Mark word as 'strong' if it hasn't been marked strong yet.
   // Return true if the word has been marked strong, false if it has already been
   // marked strong or if another thread has beat us by marking it
@@ -168,6 +188,13 @@ public:
   HeapWord* get_next_marked_addr(const HeapWord* addr,
                                  const HeapWord* limit) const;
 
+  // Decode the addresses of up to "max" marked objects at or after "addr" and before
+  // "limit" into "addrs", a whole bitmap word at a time. Returns the number of
+  // addresses decoded, and sets "next" to the address at which to resume, which
+  // is "limit" once the range is exhausted.
+  size_t get_next_marked_addrs(const HeapWord* addr, const HeapWord* limit,
+                               HeapWord** addrs, size_t max, HeapWord** next) const;
+
   bm_word_t inverted_bit_mask_for_range(idx_t beg, idx_t end) const;
   void  clear_range_within_word    (idx_t beg, idx_t end);
   void clear_range (idx_t beg, idx_t end);
@@ -39,6 +39,13 @@ inline HeapWord* ShenandoahMarkBitMap::index_to_address(size_t offset) const {
   return _covered.start() + ((offset >> 1) << _shift);
 }
 
+inline void ShenandoahMarkBitMap::note_dirty_word(idx_t bit) {
+  volatile uint8_t* const flag = &_dirty_chunks[to_words_align_down(bit) >> _log_dirty_chunk_words];
+  if (Atomic::load(flag) == 0) {
+    Atomic::store(flag, (uint8_t)1);
+  }
+}
+
 inline bool ShenandoahMarkBitMap::mark_strong(HeapWord* heap_addr, bool& was_upgraded) {
   check_mark(heap_addr);
 
@@ -58,6 +65,9 @@ inline bool ShenandoahMarkBitMap::mark_strong(HeapWord* heap_addr, bool& was_upg
     const bm_word_t cur_val = Atomic::cmpxchg(addr, old_val, new_val, memory_order_relaxed);
     if (cur_val == old_val) {
       was_upgraded = (cur_val & mask_weak) != 0;
+      if (cur_val == 0) {
+        note_dirty_word(bit);
+      }
       return true;      // Success.
     }
     old_val = cur_val;  // The value changed, try again.
@@ -84,6 +94,9 @@ inline bool ShenandoahMarkBitMap::mark_weak(HeapWord* heap_addr) {
     }
     const bm_word_t cur_val = Atomic::cmpxchg(addr, old_val, new_val, memory_order_relaxed);
     if (cur_val == old_val) {
+      if (cur_val == 0) {
+        note_dirty_word(bit);
+      }
       return true;      // Success.
     }
     old_val = cur_val;  // The value changed, try again.
@@ -156,6 +169,21 @@ inline ShenandoahMarkBitMap::idx_t ShenandoahMarkBitMap::get_next_bit_impl(idx_t
                     ? to_words_align_down(r_index) // Minuscule savings when aligned.
                     : to_words_align_up(r_index);
       while (++index < limit) {
+        // Sparse bitmaps have long runs of empty words. Skip them a group of words at a
+        // time: or-ing the group has no dependent branches, and compilers vectorize it.
+        while (index + skip_group_words <= limit) {
+          bm_word_t group = 0;
+          for (idx_t i = 0; i < skip_group_words; i++) {
+            group |= map(index + i) ^ flip;
+          }
+          if (group != 0) {
+            break;
+          }
+          index += skip_group_words;
+        }
+        if (index >= limit) {
+          break;
+        }
         cword = map(index) ^ flip;
         if (cword != 0) {
           idx_t result = bit_index(index) + count_trailing_zeros(cword);
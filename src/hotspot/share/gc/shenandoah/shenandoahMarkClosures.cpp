@@ -25,6 +25,7 @@
 
 #include "precompiled.hpp"
 
+#include "gc/shared/workerThread.hpp"
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahHeapRegion.hpp"
 #include "gc/shenandoah/shenandoahMarkClosures.hpp"
@@ -33,8 +34,45 @@
 
 
 ShenandoahFinalMarkUpdateRegionStateClosure::ShenandoahFinalMarkUpdateRegionStateClosure(
-  ShenandoahMarkingContext *ctx) :
-  _ctx(ctx), _lock(ShenandoahHeap::heap()->lock()) {}
+  ShenandoahMarkingContext *ctx, bool age0_census) :
+  _ctx(ctx), _lock(ShenandoahHeap::heap()->lock()), _tallies(nullptr), _num_tallies(0) {
+  if (age0_census) {
+    assert(ctx != nullptr, "Census needs TAMS");
+    _num_tallies = ShenandoahHeap::heap()->max_workers();
+    _tallies = NEW_C_HEAP_ARRAY(CensusTally, _num_tallies, mtGC);
+    for (uint i = 0; i < _num_tallies; i++) {
+      _tallies[i]._age0_pop = 0;
+      _tallies[i]._total_pop = 0;
+    }
+  }
+}
+
+ShenandoahFinalMarkUpdateRegionStateClosure::~ShenandoahFinalMarkUpdateRegionStateClosure() {
+  FREE_C_HEAP_ARRAY(CensusTally, _tallies);
+}
+
+ShenandoahFinalMarkUpdateRegionStateClosure::CensusTally* ShenandoahFinalMarkUpdateRegionStateClosure::tally() {
+  // Small heaps are iterated by the VM thread alone.
+  uint worker_id = Thread::current()->is_Worker_thread() ? WorkerThread::worker_id() : 0;
+  assert(worker_id < _num_tallies, "worker_id (%u) out of range (%u)", worker_id, _num_tallies);
+  return &_tallies[worker_id];
+}
+
+size_t ShenandoahFinalMarkUpdateRegionStateClosure::get_age0_population() const {
+  size_t pop = 0;
+  for (uint i = 0; i < _num_tallies; i++) {
+    pop += _tallies[i]._age0_pop;
+  }
+  return pop;
+}
+
+size_t ShenandoahFinalMarkUpdateRegionStateClosure::get_total_population() const {
+  size_t pop = 0;
+  for (uint i = 0; i < _num_tallies; i++) {
+    pop += _tallies[i]._total_pop;
+  }
+  return pop;
+}
 
 void ShenandoahFinalMarkUpdateRegionStateClosure::heap_region_do(ShenandoahHeapRegion* r) {
   if (r->is_active()) {
@@ -48,8 +86,17 @@ void ShenandoahFinalMarkUpdateRegionStateClosure::heap_region_do(ShenandoahHeapR
       // Bitmaps/TAMS are swapped at this point, so we need to poll complete bitmap.
       HeapWord *tams = _ctx->top_at_mark_start(r);
       HeapWord *top = r->top();
-      if (top > tams) {
-        r->increase_live_data_alloc_words(pointer_delta(top, tams));
+      size_t alloc_words = (top > tams) ? pointer_delta(top, tams) : 0;
+      if (alloc_words > 0) {
+        r->increase_live_data_alloc_words(alloc_words);
+      }
+      if (_tallies != nullptr && r->is_young()) {
+        // Objects above TAMS were all allocated in this cycle, they are in the age 0 cohort.
+        CensusTally* t = tally();
+        t->_age0_pop += alloc_words;
+        // TODO: check significance of _ctx != nullptr above, can that
+        // spoof _total_pop in some corner cases?
+        NOT_PRODUCT(t->_total_pop += r->get_live_data_words();)
       }
     }
 
@@ -78,21 +125,3 @@ void ShenandoahFinalMarkUpdateRegionStateClosure::heap_region_do(ShenandoahHeapR
   }
 }
 
-
-ShenandoahUpdateCensusZeroCohortClosure::ShenandoahUpdateCensusZeroCohortClosure(
-  ShenandoahMarkingContext *ctx) :
-  _ctx(ctx), _age0_pop(0), _total_pop(0) {}
-
-void ShenandoahUpdateCensusZeroCohortClosure::heap_region_do(ShenandoahHeapRegion* r) {
-  if (_ctx != nullptr && r->is_active()) {
-    assert(r->is_young(), "Young regions only");
-    HeapWord* tams = _ctx->top_at_mark_start(r);
-    HeapWord* top  = r->top();
-    if (top > tams) {
-      _age0_pop += pointer_delta(top, tams);
-    }
-    // TODO: check significance of _ctx != nullptr above, can that
-    // spoof _total_pop in some corner cases?
-    NOT_PRODUCT(_total_pop += r->get_live_data_words();)
-  }
-}
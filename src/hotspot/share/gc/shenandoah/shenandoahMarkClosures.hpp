@@ -31,34 +31,37 @@
 class ShenandoahMarkingContext;
 class ShenandoahHeapRegion;
 
+// When asked to, also adds the [TAMS, top) volume over young regions. Used to correct age 0
+// cohort census for adaptive tenuring when census is taken during marking.
+// In non-product builds, for the purposes of verification, we also collect the total
+// live objects in young regions as well.
 class ShenandoahFinalMarkUpdateRegionStateClosure : public ShenandoahHeapRegionClosure {
 private:
+  // Population size units are words (not bytes). Each worker keeps its own tally,
+  // padded to its own cache line.
+  struct CensusTally {
+    size_t _age0_pop;              // running tally of age0 population size
+    size_t _total_pop;             // total live population size
+    char _pad[DEFAULT_CACHE_LINE_SIZE - 2 * sizeof(size_t)];
+  };
+
   ShenandoahMarkingContext* const _ctx;
   ShenandoahHeapLock* const _lock;
-public:
-  explicit ShenandoahFinalMarkUpdateRegionStateClosure(ShenandoahMarkingContext* ctx);
+  CensusTally* _tallies;
+  uint _num_tallies;
 
-  void heap_region_do(ShenandoahHeapRegion* r);
-
-  bool is_thread_safe() { return true; }
-};
+  CensusTally* tally();
 
-// Add [TAMS, top) volume over young regions. Used to correct age 0 cohort census
-// for adaptive tenuring when census is taken during marking.
-// In non-product builds, for the purposes of verification, we also collect the total
-// live objects in young regions as well.
-class ShenandoahUpdateCensusZeroCohortClosure : public ShenandoahHeapRegionClosure {
-private:
-  ShenandoahMarkingContext* const _ctx;
-  // Population size units are words (not bytes)
-  size_t _age0_pop;                // running tally of age0 population size
-  size_t _total_pop;               // total live population size
 public:
-  ShenandoahUpdateCensusZeroCohortClosure(ShenandoahMarkingContext* ctx);
+  explicit ShenandoahFinalMarkUpdateRegionStateClosure(ShenandoahMarkingContext* ctx, bool age0_census = false);
+  ~ShenandoahFinalMarkUpdateRegionStateClosure();
 
   void heap_region_do(ShenandoahHeapRegion* r);
 
-  size_t get_age0_population()  { return _age0_pop; }
-  size_t get_total_population() { return _total_pop; }
+  bool is_thread_safe() { return true; }
+
+  // The tallies merged over all workers, once the iteration is done
+  size_t get_age0_population() const;
+  size_t get_total_population() const;
 };
 #endif // SHARE_GC_SHENANDOAH_SHENANDOAHMARKCLOSURES_HPP
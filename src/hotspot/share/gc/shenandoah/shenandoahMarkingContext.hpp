@@ -52,6 +52,8 @@ private:
 public:
   ShenandoahMarkingContext(MemRegion heap_region, MemRegion bitmap_region, size_t num_regions);
 
+  const ShenandoahMarkBitMap* mark_bit_map() const { return &_mark_bit_map; }
+
   /*
    * Marks the object. Returns true if the object has not been marked before and has
    * been marked by this thread. Returns false if the object has already been marked,
@@ -69,6 +71,8 @@ public:
   inline bool is_marked_strong_or_old(const oop obj) const;
 
   inline HeapWord* get_next_marked_addr(const HeapWord* addr, const HeapWord* limit) const;
+  inline size_t get_next_marked_addrs(const HeapWord* addr, const HeapWord* limit,
+                                      HeapWord** addrs, size_t max, HeapWord** next) const;
 
   inline bool allocated_after_mark_start(const oop obj) const;
   inline bool allocated_after_mark_start(const HeapWord* addr) const;
@@ -62,6 +62,11 @@ inline HeapWord* ShenandoahMarkingContext::get_next_marked_addr(const HeapWord*
   return _mark_bit_map.get_next_marked_addr(start, limit);
 }
 
+inline size_t ShenandoahMarkingContext::get_next_marked_addrs(const HeapWord* start, const HeapWord* limit,
+                                                              HeapWord** addrs, size_t max, HeapWord** next) const {
+  return _mark_bit_map.get_next_marked_addrs(start, limit, addrs, max, next);
+}
+
 inline bool ShenandoahMarkingContext::allocated_after_mark_start(const oop obj) const {
   const HeapWord* addr = cast_from_oop<HeapWord*>(obj);
   return allocated_after_mark_start(addr);
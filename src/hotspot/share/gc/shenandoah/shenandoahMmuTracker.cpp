@@ -28,6 +28,7 @@
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahOldGeneration.hpp"
 #include "gc/shenandoah/shenandoahYoungGeneration.hpp"
+#include "jfr/jfrEvents.hpp"
 #include "logging/log.hpp"
 #include "runtime/os.hpp"
 #include "runtime/task.hpp"
@@ -61,7 +62,11 @@ ShenandoahMmuTracker::ShenandoahMmuTracker() :
     _most_recent_periodic_time_stamp(0.0),
     _most_recent_periodic_gc_time(0.0),
     _most_recent_periodic_mutator_time(0.0),
-    _mmu_periodic_task(new ShenandoahMmuTask(this)) {
+    _mmu_periodic_task(new ShenandoahMmuTask(this)),
+    _most_recent_old_increment_gc_time(0.0),
+    _pending_old_gc_time(0.0),
+    _old_cycle_gc_time(0.0),
+    _most_recent_old_used(0) {
 }
 
 ShenandoahMmuTracker::~ShenandoahMmuTracker() {
@@ -83,7 +88,7 @@ void ShenandoahMmuTracker::fetch_cpu_times(double &gc_time, double &mutator_time
   mutator_time =(process_user_time + process_system_time) - most_recent_gc_thread_time;
 }
 
-void ShenandoahMmuTracker::update_utilization(size_t gcid, const char* msg) {
+double ShenandoahMmuTracker::update_utilization(size_t gcid, const char* msg) {
   double current = os::elapsedTime();
   _most_recent_gcid = gcid;
   _most_recent_is_full = false;
@@ -92,6 +97,7 @@ void ShenandoahMmuTracker::update_utilization(size_t gcid, const char* msg) {
     fetch_cpu_times(_most_recent_gc_time, _most_recent_mutator_time);
 
     _most_recent_timestamp = current;
+    return 0.0;
   } else {
     double gc_cycle_period = current - _most_recent_timestamp;
     _most_recent_timestamp = current;
@@ -106,20 +112,51 @@ void ShenandoahMmuTracker::update_utilization(size_t gcid, const char* msg) {
     _most_recent_mu = mutator_time / (_active_processors * gc_cycle_period);
     log_info(gc, ergo)("At end of %s: GCU: %.1f%%, MU: %.1f%% during period of %.3fs",
                        msg, _most_recent_gcu * 100, _most_recent_mu * 100, gc_cycle_period);
+    return gc_time;
   }
 }
 
+void ShenandoahMmuTracker::sample_old_growth() {
+  ShenandoahHeap* const heap = ShenandoahHeap::heap();
+  const size_t old_used = heap->old_generation()->used();
+  const size_t young_capacity = heap->young_generation()->max_capacity();
+  if (old_used >= _most_recent_old_used && young_capacity > 0) {
+    _old_growth_rate.add((double) (old_used - _most_recent_old_used) / young_capacity);
+  }
+  _most_recent_old_used = old_used;
+}
+
+// Cycles that are neither young nor mixed take no samples. The old marking done
+// before them is not a cost of the next young cycle.
+void ShenandoahMmuTracker::reset_cost_model_baseline() {
+  _pending_old_gc_time = 0.0;
+  _most_recent_old_used = ShenandoahHeap::heap()->old_generation()->used();
+}
+
+bool ShenandoahMmuTracker::has_cost_model_samples() const {
+  return _young_cycle_cost.num() >= 3 && _old_cycle_cost.num() >= 1 && _old_growth_rate.num() >= 3;
+}
+
 void ShenandoahMmuTracker::record_young(size_t gcid) {
-  update_utilization(gcid, "Concurrent Young GC");
+  // Old marking increments since the previous cycle are reported with this one, but
+  // they are costs of the old collection.
+  double gc_time = update_utilization(gcid, "Concurrent Young GC");
+  if (gc_time > 0.0) {
+    _young_cycle_cost.add(MAX2(gc_time - _pending_old_gc_time, 0.0));
+    sample_old_growth();
+  }
+  _pending_old_gc_time = 0.0;
 }
 
 void ShenandoahMmuTracker::record_global(size_t gcid) {
   update_utilization(gcid, "Concurrent Global GC");
+  reset_cost_model_baseline();
 }
 
 void ShenandoahMmuTracker::record_bootstrap(size_t gcid) {
   // Not likely that this will represent an "ideal" GCU, but doesn't hurt to try
   update_utilization(gcid, "Concurrent Bootstrap GC");
+  reset_cost_model_baseline();
 }
 
 void ShenandoahMmuTracker::record_old_marking_increment(bool old_marking_done) {
@@ -129,6 +166,18 @@ void ShenandoahMmuTracker::record_old_marking_increment(bool old_marking_done) {
 
   double gc_time, mutator_time;
   fetch_cpu_times(gc_time, mutator_time);
+
+  // Cumulative times: the later of the two snapshots is where this increment started.
+  double increment_gc_time = gc_time - MAX2(_most_recent_gc_time, _most_recent_old_increment_gc_time);
+  _most_recent_old_increment_gc_time = gc_time;
+  _pending_old_gc_time += increment_gc_time;
+  _old_cycle_gc_time += increment_gc_time;
+  if (old_marking_done) {
+    // Mixed evacuations of the previous old collection were added to its cost meanwhile.
+    _old_cycle_cost.add(_old_cycle_gc_time);
+    _old_cycle_gc_time = 0.0;
+  }
+
   double gcu = (gc_time - _most_recent_gc_time) / duration;
   double mu = (mutator_time - _most_recent_mutator_time) / duration;
   log_info(gc, ergo)("At end of %s: GCU: %.1f%%, MU: %.1f%% for duration %.3fs (totals to be subsumed in next gc report)",
@@ -137,7 +186,13 @@ void ShenandoahMmuTracker::record_old_marking_increment(bool old_marking_done) {
 }
 
 void ShenandoahMmuTracker::record_mixed(size_t gcid) {
-  update_utilization(gcid, "Mixed Concurrent GC");
+  // What a mixed cycle costs over a young cycle is the cost of evacuating old regions.
+  double gc_time = update_utilization(gcid, "Mixed Concurrent GC");
+  if (gc_time > 0.0) {
+    double young_cost = (_young_cycle_cost.num() > 0) ? _young_cycle_cost.davg() : 0.0;
+    _old_cycle_gc_time += MAX2(gc_time - _pending_old_gc_time - young_cost, 0.0);
+  }
+  reset_cost_model_baseline();
 }
 
 void ShenandoahMmuTracker::record_degenerated(size_t gcid, bool is_old_bootstrap) {
@@ -149,10 +204,12 @@ void ShenandoahMmuTracker::record_degenerated(size_t gcid, bool is_old_bootstrap
   } else {
     update_utilization(gcid, "Degenerated Young GC");
   }
+  reset_cost_model_baseline();
 }
 
 void ShenandoahMmuTracker::record_full(size_t gcid) {
   update_utilization(gcid, "Full GC");
+  reset_cost_model_baseline();
   _most_recent_is_full = true;
 }
 
@@ -173,7 +230,30 @@ void ShenandoahMmuTracker::report() {
 
   double mu = mutator_delta / (_active_processors * time_delta);
   double gcu = gc_delta / (_active_processors * time_delta);
+  _mmu_average.add(mu);
   log_info(gc)("Periodic Sample: GCU = %.3f%%, MU = %.3f%% during most recent %.1fs", gcu * 100, mu * 100, time_delta);
+
+  EventShenandoahMutatorUtilization evt;
+  if (evt.should_commit()) {
+    evt.set_window((s8) (time_delta * NANOSECS_PER_SEC));
+    evt.set_gcUtilization((float) gcu);
+    evt.set_mutatorUtilization((float) mu);
+    evt.set_averageMutatorUtilization((float) _mmu_average.davg());
+    evt.commit();
+  }
+
+  if (ShenandoahMutatorUtilizationTarget > 0 && mu * 100 < ShenandoahMutatorUtilizationTarget) {
+    log_warning(gc)("Mutator utilization %.1f%% during most recent %.1fs is below target of " UINTX_FORMAT "%%, GCU = %.1f%%",
+                    mu * 100, time_delta, ShenandoahMutatorUtilizationTarget, gcu * 100);
+    EventShenandoahMutatorUtilizationBelowTarget alert;
+    if (alert.should_commit()) {
+      alert.set_window((s8) (time_delta * NANOSECS_PER_SEC));
+      alert.set_mutatorUtilization((float) mu);
+      alert.set_target((float) ShenandoahMutatorUtilizationTarget / 100);
+      alert.set_gcUtilization((float) gcu);
+      alert.commit();
+    }
+  }
 }
 
 void ShenandoahMmuTracker::initialize() {
@@ -73,10 +73,25 @@ private:
   ShenandoahMmuTask* _mmu_periodic_task;
   TruncatedSeq _mmu_average;
 
-  void update_utilization(size_t gcid, const char* msg);
-  static void fetch_cpu_times(double &gc_time, double &mutator_time);
+  // Samples for the generation sizing cost model. GC CPU seconds spent by each young cycle
+  // and by each old collection, and old generation growth per byte of young capacity.
+  TruncatedSeq _young_cycle_cost;
+  TruncatedSeq _old_cycle_cost;
+  TruncatedSeq _old_growth_rate;
+  double _most_recent_old_increment_gc_time;
+  double _pending_old_gc_time;
+  double _old_cycle_gc_time;
+  size_t _most_recent_old_used;
+
+  // Returns the GC CPU seconds spent since the previous cycle, zero for the first one.
+  double update_utilization(size_t gcid, const char* msg);
+  void sample_old_growth();
+  void reset_cost_model_baseline();
 
 public:
+  // Cumulative CPU time, in seconds, given to GC threads and to the rest of the process.
+  static void fetch_cpu_times(double &gc_time, double &mutator_time);
+
   explicit ShenandoahMmuTracker();
   ~ShenandoahMmuTracker();
 
@@ -101,7 +116,17 @@ public:
   // This is called by the periodic task timer. The interval is defined by
   // GCPauseIntervalMillis and defaults to 5 seconds. This method computes
   // the MMU over the elapsed interval and records it in a running average.
+  // The sample is sent to JFR, and checked against ShenandoahMutatorUtilizationTarget.
   void report();
+
+  // Fraction of the CPU time given to GC threads over the most recently completed cycle.
+  double gc_utilization() const { return _most_recent_gcu; }
+
+  // Inputs of the generation sizing cost model, see ShenandoahGenerationSizer::cost_model_young_size.
+  bool has_cost_model_samples() const;
+  double young_cycle_cost() const { return _young_cycle_cost.davg(); }
+  double old_cycle_cost() const   { return _old_cycle_cost.davg(); }
+  double old_growth_rate() const  { return _old_growth_rate.davg(); }
 };
 
 #endif //SHARE_GC_SHENANDOAH_SHENANDOAHMMUTRACKER_HPP
@@ -107,6 +107,10 @@ void ShenandoahMonitoringSupport::update_counters() {
   }
 }
 
+void ShenandoahMonitoringSupport::record_region_transition(size_t region, int from_ordinal, int to_ordinal) {
+  _heap_region_counters->record_transition(region, from_ordinal, to_ordinal);
+}
+
 void ShenandoahMonitoringSupport::notify_heap_changed() {
   _counters_update_task.notify_heap_changed();
 }
@@ -80,6 +80,9 @@ public:
   void handle_force_counters_update();
 
   void update_counters();
+
+  // Publish a region state transition, when region sampling keeps a transition log.
+  void record_region_transition(size_t region, int from_ordinal, int to_ordinal);
 };
 
 #endif // SHARE_GC_SHENANDOAH_SHENANDOAHMONITORINGSUPPORT_HPP
@@ -24,6 +24,7 @@
 
 #include "precompiled.hpp"
 
+#include "gc/shared/workerThread.hpp"
 #include "gc/shenandoah/shenandoahClosures.inline.hpp"
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahNMethod.inline.hpp"
@@ -420,7 +421,20 @@ void ShenandoahNMethodList::release() {
 }
 
 ShenandoahNMethodTableSnapshot::ShenandoahNMethodTableSnapshot(ShenandoahNMethodTable* table) :
-  _heap(ShenandoahHeap::heap()), _list(table->_list->acquire()), _limit(table->_index), _claimed(0) {
+  _heap(ShenandoahHeap::heap()), _list(table->_list->acquire()), _limit(table->_index),
+  _stride(claim_stride(table->_index)), _claimed(0) {
+}
+
+// A fixed stride leaves most workers idle when the code cache is small compared to the
+// number of workers, and the pause then waits on a few of them. Hand out several chunks
+// per worker instead, but keep them large enough that claiming does not dominate.
+size_t ShenandoahNMethodTableSnapshot::claim_stride(int limit) {
+  const size_t min_stride = 16;
+  const size_t max_stride = 256;
+  const size_t chunks_per_worker = 8;
+  size_t nworkers = MAX2(ShenandoahHeap::heap()->workers()->active_workers(), 1u);
+  size_t stride = (size_t)limit / (nworkers * chunks_per_worker);
+  return clamp(stride, min_stride, max_stride);
 }
 
 ShenandoahNMethodTableSnapshot::~ShenandoahNMethodTableSnapshot() {
@@ -428,7 +442,7 @@ ShenandoahNMethodTableSnapshot::~ShenandoahNMethodTableSnapshot() {
 }
 
 void ShenandoahNMethodTableSnapshot::parallel_blobs_do(CodeBlobClosure *f) {
-  size_t stride = 256; // educated guess
+  const size_t stride = _stride;
 
   ShenandoahNMethod** const list = _list->list();
 
@@ -453,7 +467,7 @@ void ShenandoahNMethodTableSnapshot::parallel_blobs_do(CodeBlobClosure *f) {
 }
 
 void ShenandoahNMethodTableSnapshot::concurrent_nmethods_do(NMethodClosure* cl) {
-  size_t stride = 256; // educated guess
+  const size_t stride = _stride;
 
   ShenandoahNMethod** list = _list->list();
   size_t max = (size_t)_limit;
@@ -52,6 +52,9 @@ public:
   inline nmethod* nm() const;
   inline ShenandoahReentrantLock* lock();
   inline void oops_do(OopClosure* oops, bool fix_relocations = false);
+  // Whether any of the recorded oops points into the collection set. This reads the oops
+  // without the lock, it is only exact while nobody else updates them.
+  inline bool has_cset_oops(ShenandoahHeap* heap) const;
   // Update oops when the nmethod is re-registered
   void update();
 
@@ -110,6 +113,8 @@ private:
   ShenandoahNMethodList*      _list;
   /* snapshot iteration limit */
   int                         _limit;
+  /* number of nmethods claimed at once */
+  const size_t                _stride;
 
   shenandoah_padding(0);
   volatile size_t       _claimed;
@@ -119,6 +124,11 @@ public:
   ShenandoahNMethodTableSnapshot(ShenandoahNMethodTable* table);
   ~ShenandoahNMethodTableSnapshot();
 
+private:
+  static size_t claim_stride(int limit);
+
+public:
+
   void parallel_blobs_do(CodeBlobClosure *f);
   void concurrent_nmethods_do(NMethodClosure* cl);
 };
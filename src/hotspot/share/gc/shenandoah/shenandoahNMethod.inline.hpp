@@ -30,6 +30,8 @@
 #include "gc/shared/barrierSet.hpp"
 #include "gc/shared/barrierSetNMethod.hpp"
 #include "gc/shenandoah/shenandoahClosures.inline.hpp"
+#include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "oops/access.inline.hpp"
 
 nmethod* ShenandoahNMethod::nm() const {
   return _nm;
@@ -61,7 +63,33 @@ void ShenandoahNMethod::oops_do(OopClosure* oops, bool fix_relocations) {
   }
 }
 
+bool ShenandoahNMethod::has_cset_oops(ShenandoahHeap* heap) const {
+  for (int c = 0; c < _oops_count; c++) {
+    oop o = RawAccess<>::oop_load(_oops[c]);
+    if (heap->in_collection_set(o)) {
+      return true;
+    }
+  }
+
+  oop* const begin = _nm->oops_begin();
+  oop* const end = _nm->oops_end();
+  for (oop* p = begin; p < end; p++) {
+    if (*p != Universe::non_oop_word()) {
+      oop o = RawAccess<>::oop_load(p);
+      if (heap->in_collection_set(o)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 void ShenandoahNMethod::heal_nmethod_metadata(ShenandoahNMethod* nmethod_data) {
+  // Only oops into the collection set get evacuated and updated. Without any, there is nothing
+  // to write and no relocation to fix, which is the common case with a large code cache.
+  if (!nmethod_data->has_cset_oops(ShenandoahHeap::heap())) {
+    return;
+  }
   ShenandoahEvacuateUpdateMetadataClosure cl;
   nmethod_data->oops_do(&cl, true /*fix relocation*/);
 }
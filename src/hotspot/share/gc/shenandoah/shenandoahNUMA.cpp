@@ -0,0 +1,193 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "gc/shared/gc_globals.hpp"
+#include "gc/shenandoah/shenandoahNUMA.hpp"
+#include "logging/log.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/os.hpp"
+#include "utilities/align.hpp"
+#include "utilities/ostream.hpp"
+
+ShenandoahNUMA::ShenandoahNUMA(size_t num_regions, size_t region_size_bytes, size_t page_size) :
+  _num_nodes(1),
+  _node_ids(nullptr),
+  _node_id_to_index(nullptr),
+  _max_node_id(0),
+  _num_regions(num_regions),
+  _region_size_bytes(region_size_bytes),
+  _slow_node_id(-1),
+  _first_slow_region(num_regions) {
+
+  initialize_slow_tier(page_size);
+
+  if (!ShenandoahNUMAAffinity || !UseNUMA) {
+    initialize_without_numa();
+    return;
+  }
+
+  if (region_size_bytes < page_size) {
+    // Several regions would share a page, and we cannot place them on different nodes.
+    log_info(gc, heap, numa)("NUMA affinity disabled: region size (" SIZE_FORMAT "%s) is smaller than page size (" SIZE_FORMAT "%s)",
+                             byte_size_in_proper_unit(region_size_bytes), proper_unit_for_byte_size(region_size_bytes),
+                             byte_size_in_proper_unit(page_size), proper_unit_for_byte_size(page_size));
+    initialize_without_numa();
+    return;
+  }
+
+  size_t num_groups = os::numa_get_groups_num();
+  if (num_groups <= 1 || num_regions < num_groups) {
+    initialize_without_numa();
+    return;
+  }
+
+  int* ids = NEW_C_HEAP_ARRAY(int, num_groups, mtGC);
+  uint num_nodes = (uint) os::numa_get_leaf_groups(ids, num_groups);
+  if (num_nodes <= 1) {
+    FREE_C_HEAP_ARRAY(int, ids);
+    initialize_without_numa();
+    return;
+  }
+
+  _num_nodes = num_nodes;
+  _node_ids = ids;
+
+  for (uint i = 0; i < _num_nodes; i++) {
+    _max_node_id = MAX2(_max_node_id, _node_ids[i]);
+  }
+  _node_id_to_index = NEW_C_HEAP_ARRAY(uint, _max_node_id + 1, mtGC);
+  for (int id = 0; id <= _max_node_id; id++) {
+    _node_id_to_index[id] = 0;
+  }
+  for (uint i = 0; i < _num_nodes; i++) {
+    _node_id_to_index[_node_ids[i]] = i;
+  }
+
+  log_info(gc, heap, numa)("NUMA affinity: %u nodes, " SIZE_FORMAT " regions per node", _num_nodes, _num_regions / _num_nodes);
+}
+
+ShenandoahNUMA::~ShenandoahNUMA() {
+  FREE_C_HEAP_ARRAY(int, _node_ids);
+  FREE_C_HEAP_ARRAY(uint, _node_id_to_index);
+}
+
+void ShenandoahNUMA::initialize_without_numa() {
+  _num_nodes = 1;
+}
+
+void ShenandoahNUMA::initialize_slow_tier(size_t page_size) {
+  if (ShenandoahSlowMemoryNode < 0 || ShenandoahSlowMemoryPercent == 0) {
+    return;
+  }
+  if (!UseNUMA) {
+    log_warning(gc, heap, numa)("Slow memory tier disabled: requires UseNUMA");
+    return;
+  }
+  if (_region_size_bytes < page_size) {
+    log_warning(gc, heap, numa)("Slow memory tier disabled: region size (" SIZE_FORMAT "%s) is smaller than page size (" SIZE_FORMAT "%s)",
+                                byte_size_in_proper_unit(_region_size_bytes), proper_unit_for_byte_size(_region_size_bytes),
+                                byte_size_in_proper_unit(page_size), proper_unit_for_byte_size(page_size));
+    return;
+  }
+
+  // The node usually has memory but no CPUs, so look for it among all the leaf groups.
+  size_t num_groups = os::numa_get_groups_num();
+  int* ids = NEW_C_HEAP_ARRAY(int, MAX2(num_groups, (size_t)1), mtGC);
+  size_t num_ids = os::numa_get_leaf_groups(ids, num_groups);
+  bool found = false;
+  for (size_t i = 0; i < num_ids; i++) {
+    found |= (ids[i] == ShenandoahSlowMemoryNode);
+  }
+  FREE_C_HEAP_ARRAY(int, ids);
+  if (!found) {
+    log_warning(gc, heap, numa)("Slow memory tier disabled: NUMA node " INTX_FORMAT " is not available", ShenandoahSlowMemoryNode);
+    return;
+  }
+
+  size_t num_slow = _num_regions * ShenandoahSlowMemoryPercent / 100;
+  _slow_node_id = (int) ShenandoahSlowMemoryNode;
+  _first_slow_region = _num_regions - num_slow;
+  log_info(gc, heap, numa)("Slow memory tier: regions [" SIZE_FORMAT ", " SIZE_FORMAT ") on NUMA id (%d)",
+                           _first_slow_region, _num_regions, _slow_node_id);
+}
+
+uint ShenandoahNUMA::node_index_of_current_thread() const {
+  if (!is_enabled()) {
+    return 0;
+  }
+  int id = os::numa_get_group_id();
+  if (id < 0 || id > _max_node_id) {
+    return 0;
+  }
+  return _node_id_to_index[id];
+}
+
+void ShenandoahNUMA::request_memory_on_nodes(char* addr, size_t bytes, size_t first_region_idx) const {
+  if ((!is_enabled() && !has_slow_tier()) || bytes == 0) {
+    return;
+  }
+
+  assert(is_aligned(bytes, _region_size_bytes), "Should cover whole regions: " SIZE_FORMAT, bytes);
+  char* const end = addr + bytes;
+  size_t idx = first_region_idx;
+  while (addr < end) {
+    size_t stripe_bytes = pointer_delta(end, addr, 1);
+    int node_id = -1;
+    if (is_slow_region(idx)) {
+      node_id = _slow_node_id;
+    } else {
+      // Fast stripes end where the slow tier starts
+      stripe_bytes = MIN2((_first_slow_region - idx) * _region_size_bytes, stripe_bytes);
+      if (is_enabled()) {
+        uint node = node_index_for_region(idx);
+        stripe_bytes = MIN2((last_region_for_node(node) - idx + 1) * _region_size_bytes, stripe_bytes);
+        node_id = _node_ids[node];
+      }
+    }
+    if (node_id >= 0) {
+      log_trace(gc, heap, numa)("Request memory [" PTR_FORMAT ", " PTR_FORMAT ") to be NUMA id (%d)",
+                                p2i(addr), p2i(addr + stripe_bytes), node_id);
+      os::numa_make_local(addr, stripe_bytes, node_id);
+    }
+    addr += stripe_bytes;
+    idx += stripe_bytes / _region_size_bytes;
+  }
+}
+
+void ShenandoahNUMA::print_on(outputStream* out) const {
+  if (has_slow_tier()) {
+    out->print_cr("Slow memory tier: regions [" SIZE_FORMAT ", " SIZE_FORMAT "] on os id %d",
+                  _first_slow_region, _num_regions - 1, _slow_node_id);
+  }
+  if (!is_enabled()) {
+    out->print_cr("NUMA affinity: disabled");
+    return;
+  }
+  out->print_cr("NUMA affinity: %u nodes", _num_nodes);
+  for (uint i = 0; i < _num_nodes; i++) {
+    out->print_cr("  node %u (os id %d): regions [" SIZE_FORMAT ", " SIZE_FORMAT "]",
+                  i, _node_ids[i], first_region_for_node(i), last_region_for_node(i));
+  }
+}
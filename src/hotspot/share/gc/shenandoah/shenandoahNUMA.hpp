@@ -0,0 +1,107 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_GC_SHENANDOAH_SHENANDOAHNUMA_HPP
+#define SHARE_GC_SHENANDOAH_SHENANDOAHNUMA_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+// Maps heap regions to NUMA nodes. When ShenandoahNUMAAffinity is enabled, the heap is carved into
+// one contiguous, evenly sized stripe of regions per active NUMA node, and the memory backing each stripe is
+// requested from its node when it is committed. Keeping the stripes contiguous (rather than
+// interleaving regions round-robin as G1 does) lets the free set express "regions local to node N"
+// as a simple clamp of its existing leftmost/rightmost bounds, and keeps humongous allocations
+// contiguous within a node whenever they fit.
+//
+// When NUMA affinity is disabled or only one node is available, there is exactly one node that
+// spans the entire heap, and all queries degenerate to the heap-wide bounds.
+//
+// Independently of the stripes, the highest regions of the heap can form a slow memory tier, see
+// ShenandoahSlowMemoryNode. The memory of those regions is requested from the slow node instead.
+// The free set carves the old reserve from the top of the heap first, and keeps allocating for
+// mutators and young evacuation below the tier for as long as it can.
+class ShenandoahNUMA : public CHeapObj<mtGC> {
+private:
+  // Number of active nodes. Always at least one.
+  uint _num_nodes;
+
+  // OS node ids, indexed by node index in [0, _num_nodes).
+  int* _node_ids;
+
+  // Maps an OS node id to its node index. Unknown ids map to zero.
+  uint* _node_id_to_index;
+  int _max_node_id;
+
+  size_t _num_regions;
+  size_t _region_size_bytes;
+
+  // OS node id of the slow memory tier, and the first region in it. Without a slow tier,
+  // the first region is past the end of the heap.
+  int _slow_node_id;
+  size_t _first_slow_region;
+
+  void initialize_without_numa();
+  void initialize_slow_tier(size_t page_size);
+
+public:
+  ShenandoahNUMA(size_t num_regions, size_t region_size_bytes, size_t page_size);
+  ~ShenandoahNUMA();
+
+  inline bool is_enabled() const { return _num_nodes > 1; }
+  inline uint num_nodes() const  { return _num_nodes; }
+
+  inline bool has_slow_tier() const                   { return _first_slow_region < _num_regions; }
+  inline size_t first_slow_region() const             { return _first_slow_region; }
+  inline bool is_slow_region(size_t region_idx) const { return region_idx >= _first_slow_region; }
+
+  inline uint node_index_for_region(size_t region_idx) const {
+    assert(region_idx < _num_regions, "region index is sane: " SIZE_FORMAT, region_idx);
+    return (uint) (((region_idx + 1) * _num_nodes - 1) / _num_regions);
+  }
+
+  // First and last (inclusive) region index of the stripe owned by node.
+  inline size_t first_region_for_node(uint node) const {
+    assert(node < _num_nodes, "node index is sane: %u", node);
+    return node * _num_regions / _num_nodes;
+  }
+
+  inline size_t last_region_for_node(uint node) const {
+    assert(node < _num_nodes, "node index is sane: %u", node);
+    return (node + 1) * _num_regions / _num_nodes - 1;
+  }
+
+  // Node index of the CPU the calling thread currently runs on. This is only a hint: the thread may
+  // be migrated at any time.
+  uint node_index_of_current_thread() const;
+
+  // Request that the memory [addr, addr + bytes) which backs regions starting at first_region_idx is
+  // placed on the node that owns those regions, or on the slow node for slow regions. The range must
+  // be page-aligned.
+  void request_memory_on_nodes(char* addr, size_t bytes, size_t first_region_idx) const;
+
+  void print_on(outputStream* out) const;
+};
+
+#endif // SHARE_GC_SHENANDOAH_SHENANDOAHNUMA_HPP
@@ -39,6 +39,7 @@
 #include "gc/shenandoah/shenandoahMonitoringSupport.hpp"
 #include "gc/shenandoah/shenandoahOldGeneration.hpp"
 #include "gc/shenandoah/shenandoahOopClosures.inline.hpp"
+#include "gc/shenandoah/shenandoahPadding.hpp"
 #include "gc/shenandoah/shenandoahReferenceProcessor.hpp"
 #include "gc/shenandoah/shenandoahScanRemembered.inline.hpp"
 #include "gc/shenandoah/shenandoahUtils.hpp"
@@ -128,25 +129,34 @@ public:
 
 class ShenandoahConcurrentCoalesceAndFillTask : public WorkerTask {
 private:
-  uint                    _nworkers;
   ShenandoahHeapRegion**  _coalesce_and_fill_region_array;
   uint                    _coalesce_and_fill_region_count;
+  shenandoah_padding(0);
+  volatile uint           _next_region;
+  shenandoah_padding(1);
   volatile bool           _is_preempted;
 
 public:
-  ShenandoahConcurrentCoalesceAndFillTask(uint nworkers,
-                                          ShenandoahHeapRegion** coalesce_and_fill_region_array,
+  ShenandoahConcurrentCoalesceAndFillTask(ShenandoahHeapRegion** coalesce_and_fill_region_array,
                                           uint region_count) :
     WorkerTask("Shenandoah Concurrent Coalesce and Fill"),
-    _nworkers(nworkers),
     _coalesce_and_fill_region_array(coalesce_and_fill_region_array),
     _coalesce_and_fill_region_count(region_count),
+    _next_region(0),
     _is_preempted(false) {
   }
 
   void work(uint worker_id) override {
     ShenandoahWorkerTimingsTracker timer(ShenandoahPhaseTimings::conc_coalesce_and_fill, ShenandoahPhaseTimings::ScanClusters, worker_id);
-    for (uint region_idx = worker_id; region_idx < _coalesce_and_fill_region_count; region_idx += _nworkers) {
+    // Regions are claimed one at a time rather than striped across workers: the amount of dead
+    // space differs widely between candidates, and a fixed stripe leaves the workers that drew
+    // the sparse regions idle while the others are still filling. Once any worker has been
+    // preempted, the rest stop claiming so that the cycle can yield promptly.
+    while (!Atomic::load(&_is_preempted)) {
+      uint region_idx = Atomic::fetch_then_add(&_next_region, 1u);
+      if (region_idx >= _coalesce_and_fill_region_count) {
+        break;
+      }
       ShenandoahHeapRegion* r = _coalesce_and_fill_region_array[region_idx];
       if (r->is_humongous()) {
         // There is only one object in this region and it is not garbage,
@@ -406,8 +416,7 @@ bool ShenandoahOldGeneration::coalesce_and_fill() {
 
   ShenandoahHeap* const heap = ShenandoahHeap::heap();
   WorkerThreads* workers = heap->workers();
-  uint nworkers = workers->active_workers();
-  ShenandoahConcurrentCoalesceAndFillTask task(nworkers, _coalesce_and_fill_region_array, coalesce_and_fill_regions_count);
+  ShenandoahConcurrentCoalesceAndFillTask task(_coalesce_and_fill_region_array, coalesce_and_fill_regions_count);
 
   log_info(gc)("Starting (or resuming) coalesce-and-fill of " UINT32_FORMAT " old heap regions", coalesce_and_fill_regions_count);
   workers->run_task(&task);
@@ -128,13 +128,35 @@ public:
   virtual void do_oop(oop* p)       { work(p); }
 };
 
+// Updates references concurrently. With ShenandoahUpdateRefsPrefetch, the locations that point
+// into the collection set are first collected in a window, and the headers of their objects are
+// prefetched. The forwardees are resolved and the locations updated once the window is full, or
+// when the closure goes out of scope, so that the header misses of a window overlap.
 class ShenandoahConcUpdateRefsClosure : public ShenandoahUpdateRefsSuperClosure {
 private:
+  static const uint WindowCapacity = 64;
+
+  struct PendingUpdate {
+    void* _loc;
+    oop   _obj;
+    bool  _narrow;
+  };
+
+  PendingUpdate _pending[WindowCapacity];
+  const uint _window;
+  uint _count;
+
   template<class T>
   inline void work(T* p);
 
+  inline void flush();
+
 public:
-  ShenandoahConcUpdateRefsClosure() : ShenandoahUpdateRefsSuperClosure() {}
+  ShenandoahConcUpdateRefsClosure() : ShenandoahUpdateRefsSuperClosure(),
+    _window(MIN2((uint) ShenandoahUpdateRefsPrefetch, WindowCapacity)),
+    _count(0) {}
+
+  inline ~ShenandoahConcUpdateRefsClosure();
 
   virtual void do_oop(narrowOop* p) { work(p); }
   virtual void do_oop(oop* p)       { work(p); }
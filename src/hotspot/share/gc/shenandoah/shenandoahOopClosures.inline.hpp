@@ -30,6 +30,7 @@
 
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahMark.inline.hpp"
+#include "runtime/prefetch.inline.hpp"
 
 template<class T, ShenandoahGenerationType GENERATION>
 inline void ShenandoahMarkRefsSuperClosure::work(T* p) {
@@ -52,7 +53,40 @@ inline void ShenandoahSTWUpdateRefsClosure::work(T* p) {
 
 template<class T>
 inline void ShenandoahConcUpdateRefsClosure::work(T* p) {
-  _heap->conc_update_with_forwarded(p);
+  if (_window == 0) {
+    _heap->conc_update_with_forwarded(p);
+    return;
+  }
+  T o = RawAccess<>::oop_load(p);
+  if (!CompressedOops::is_null(o)) {
+    oop obj = CompressedOops::decode_not_null(o);
+    if (_heap->in_collection_set(obj)) {
+      Prefetch::read(obj, oopDesc::mark_offset_in_bytes());
+      if (_count == _window) {
+        flush();
+      }
+      PendingUpdate& u = _pending[_count++];
+      u._loc = p;
+      u._obj = obj;
+      u._narrow = (sizeof(T) == sizeof(narrowOop));
+    }
+  }
+}
+
+inline void ShenandoahConcUpdateRefsClosure::flush() {
+  for (uint i = 0; i < _count; i++) {
+    const PendingUpdate& u = _pending[i];
+    if (u._narrow) {
+      _heap->conc_update_with_forwarded(reinterpret_cast<narrowOop*>(u._loc), u._obj);
+    } else {
+      _heap->conc_update_with_forwarded(reinterpret_cast<oop*>(u._loc), u._obj);
+    }
+  }
+  _count = 0;
+}
+
+inline ShenandoahConcUpdateRefsClosure::~ShenandoahConcUpdateRefsClosure() {
+  flush();
 }
 
 #endif // SHARE_GC_SHENANDOAH_SHENANDOAHOOPCLOSURES_INLINE_HPP
@@ -26,12 +26,18 @@
 
 #include "gc/shenandoah/shenandoahFreeSet.hpp"
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahMark.hpp"
 #include "gc/shenandoah/shenandoahPacer.hpp"
 #include "gc/shenandoah/shenandoahPhaseTimings.hpp"
+#include "gc/shenandoah/shenandoahThreadLocalData.hpp"
+#include "jfr/jfrEvents.hpp"
+#include "memory/resourceArea.hpp"
 #include "runtime/atomic.hpp"
+#include "runtime/interfaceSupport.inline.hpp"
 #include "runtime/javaThread.inline.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "runtime/threadSMR.hpp"
+#include "utilities/stringUtils.hpp"
 
 /*
  * In normal concurrent cycle, we have to pace the application to let GC finish.
@@ -165,6 +171,61 @@ void ShenandoahPacer::setup_for_reset() {
                      byte_size_in_proper_unit(initial), proper_unit_for_byte_size(initial));
 }
 
+/*
+ * ShenandoahPacingThreadWeights is a comma-separated list of pattern=weight entries.
+ * Patterns are matched against thread names as in StringUtils::is_star_match, and the
+ * first matching entry gives the weight. Threads that match no entry have weight 1.
+ */
+
+void ShenandoahPacer::initialize_thread_weights() {
+  if (ShenandoahPacingThreadWeights == nullptr || ShenandoahPacingThreadWeights[0] == '\0') {
+    return;
+  }
+
+  uint entries = 1;
+  for (const char* p = ShenandoahPacingThreadWeights; *p != '\0'; p++) {
+    if (*p == ',') {
+      entries++;
+    }
+  }
+  _thread_weights = NEW_C_HEAP_ARRAY(ThreadWeight, entries, mtGC);
+
+  char* list = os::strdup_check_oom(ShenandoahPacingThreadWeights, mtGC);
+  char* save = nullptr;
+  for (char* entry = strtok_r(list, ",", &save); entry != nullptr; entry = strtok_r(nullptr, ",", &save)) {
+    char* sep = strrchr(entry, '=');
+    char* end = nullptr;
+    double weight = (sep != nullptr) ? strtod(sep + 1, &end) : -1;
+    if (sep == nullptr || sep == entry || end == sep + 1 || *end != '\0' || weight < 0 || weight > 100) {
+      vm_exit_during_initialization(err_msg("Invalid ShenandoahPacingThreadWeights entry \"%s\": "
+                                            "expected pattern=weight, with weight between 0 and 100", entry));
+    }
+    *sep = '\0';
+    _thread_weights[_num_thread_weights]._pattern = os::strdup_check_oom(entry, mtGC);
+    _thread_weights[_num_thread_weights]._weight = weight;
+    _num_thread_weights++;
+  }
+  os::free(list);
+}
+
+double ShenandoahPacer::thread_weight(JavaThread* thread) const {
+  if (_num_thread_weights == 0) {
+    return 1.0;
+  }
+  ResourceMark rm;
+  const char* name = thread->name();
+  for (uint i = 0; i < _num_thread_weights; i++) {
+    if (StringUtils::is_star_match(_thread_weights[i]._pattern, name)) {
+      return _thread_weights[i]._weight;
+    }
+  }
+  return 1.0;
+}
+
+double ShenandoahPacer::weighted_tax_rate(Thread* thread) const {
+  return Atomic::load(&_tax_rate) * ShenandoahThreadLocalData::pacing_weight(thread);
+}
+
 size_t ShenandoahPacer::update_and_get_progress_history() {
   if (_progress == -1) {
     // First initialization, report some prior
@@ -193,7 +254,10 @@ bool ShenandoahPacer::claim_for_alloc(size_t words, bool force) {
   assert(ShenandoahPacing, "Only be here when pacing is enabled");
 
   intptr_t tax = MAX2<intptr_t>(1, words * Atomic::load(&_tax_rate));
+  return claim_budget(tax, force);
+}
 
+bool ShenandoahPacer::claim_budget(intptr_t tax, bool force) {
   intptr_t cur = 0;
   intptr_t new_val = 0;
   do {
@@ -215,7 +279,7 @@ void ShenandoahPacer::unpace_for_alloc(intptr_t epoch, size_t words) {
     return;
   }
 
-  size_t tax = MAX2<size_t>(1, words * Atomic::load(&_tax_rate));
+  size_t tax = MAX2<size_t>(1, words * weighted_tax_rate(Thread::current()));
   add_budget(tax);
 }
 
@@ -223,12 +287,50 @@ intptr_t ShenandoahPacer::epoch() {
   return Atomic::load(&_epoch);
 }
 
-void ShenandoahPacer::pace_for_alloc(size_t words) {
+bool ShenandoahPacer::claim_from_bucket(Thread* thread, intptr_t tax) {
+  intptr_t epoch = Atomic::load(&_epoch);
+  if (ShenandoahThreadLocalData::pacing_epoch(thread) != epoch) {
+    // Tokens claimed in the previous phase were accounted against its budget, drop them.
+    ShenandoahThreadLocalData::set_pacing_tokens(thread, epoch, 0);
+  }
+  if (tax == 0) {
+    return true;
+  }
+
+  intptr_t tokens = ShenandoahThreadLocalData::pacing_tokens(thread);
+  if (tokens >= tax) {
+    ShenandoahThreadLocalData::set_pacing_tokens(thread, epoch, tokens - tax);
+    return true;
+  }
+
+  // Refill the bucket along with this claim, so that the next allocations spend locally.
+  intptr_t refill = (intptr_t) ShenandoahPacingTokenBucket;
+  if (refill > 0 && claim_budget(tax - tokens + refill, false)) {
+    ShenandoahThreadLocalData::set_pacing_tokens(thread, epoch, refill);
+    return true;
+  }
+  if (claim_budget(tax - tokens, false)) {
+    ShenandoahThreadLocalData::set_pacing_tokens(thread, epoch, 0);
+    return true;
+  }
+  return false;
+}
+
+void ShenandoahPacer::pace_for_alloc(size_t words, ShenandoahAllocRequest::Type type) {
   assert(ShenandoahPacing, "Only be here when pacing is enabled");
 
-  // Fast path: try to allocate right away
-  bool claimed = claim_for_alloc(words, false);
-  if (claimed) {
+  JavaThread* current = JavaThread::current();
+  if (ShenandoahThreadLocalData::pacing_epoch(current) != epoch()) {
+    // Threads can be renamed, look the weight up again once per phase.
+    ShenandoahThreadLocalData::set_pacing_weight(current, thread_weight(current));
+  }
+
+  // Exempt threads are neither taxed nor delayed.
+  double weight = ShenandoahThreadLocalData::pacing_weight(current);
+  intptr_t tax = (weight == 0) ? 0 : MAX2<intptr_t>(1, words * Atomic::load(&_tax_rate) * weight);
+
+  // Fast path: try to allocate right away, from this thread's tokens if possible
+  if (claim_from_bucket(current, tax)) {
     return;
   }
 
@@ -236,7 +338,7 @@ void ShenandoahPacer::pace_for_alloc(size_t words) {
   // GC should replenish for this and subsequent allocations. After this claim,
   // we would wait a bit until our claim is matched by additional progress,
   // or the time budget depletes.
-  claimed = claim_for_alloc(words, true);
+  bool claimed = claim_budget(tax, true);
   assert(claimed, "Should always succeed");
 
   // Threads that are attaching should not block at all: they are not
@@ -246,37 +348,70 @@ void ShenandoahPacer::pace_for_alloc(size_t words) {
   // Thread which is not an active Java thread should also not block.
   // This can happen during VM init when main thread is still not an
   // active Java thread.
-  JavaThread* current = JavaThread::current();
   if (current->is_attaching_via_jni() ||
       !current->is_active_Java_thread()) {
     return;
   }
 
-  double start = os::elapsedTime();
+  EventShenandoahAllocationPacing event;
+  jlong start = os::javaTimeNanos();
 
-  size_t max_ms = ShenandoahPacingMaxDelay;
-  size_t total_ms = 0;
+  // Heavier threads wait longer, so that they absorb the delay before lighter threads do.
+  const jlong max_ns = (jlong) (ShenandoahPacingMaxDelay * weight * NANOSECS_PER_MILLISEC);
+  jlong total_ns = 0;
 
   while (true) {
-    // We could instead assist GC, but this would suffice for now.
-    size_t cur_ms = (max_ms > total_ms) ? (max_ms - total_ms) : 1;
-    wait(cur_ms);
+    // Do some of the marking instead of waiting for it, if there is any to do.
+    if (!ShenandoahMarkAssist || !ShenandoahMark::assist()) {
+      park(current, park_time((max_ns > total_ns) ? (max_ns - total_ns) : 1));
+    }
 
-    double end = os::elapsedTime();
-    total_ms = (size_t)((end - start) * 1000);
+    jlong end = os::javaTimeNanos();
+    total_ns = end - start;
 
-    if (total_ms > max_ms || Atomic::load(&_budget) >= 0) {
+    bool exhausted = total_ns > max_ns;
+    if (exhausted || Atomic::load(&_budget) >= 0) {
       // Exiting if either:
       //  a) Spent local time budget to wait for enough GC progress.
       //     Breaking out and allocating anyway, which may mean we outpace GC,
       //     and start Degenerated GC cycle.
       //  b) The budget had been replenished, which means our claim is satisfied.
-      ShenandoahThreadLocalData::add_paced_time(JavaThread::current(), end - start);
+      ShenandoahThreadLocalData::add_paced_time(current, (double) total_ns / NANOSECS_PER_SEC);
+      size_t total_ms = (size_t) (total_ns / NANOSECS_PER_MILLISEC);
+      Atomic::inc(&_delays[MIN2(total_ms, (size_t) DelayBuckets - 1)]);
+      if (event.should_commit()) {
+        event.set_size(words * HeapWordSize);
+        event.set_allocationType(ShenandoahAllocRequest::alloc_type_to_string(type));
+        event.set_exhausted(exhausted);
+        event.commit();
+      }
       break;
     }
   }
 }
 
+jlong ShenandoahPacer::park_time(jlong remaining_ns) const {
+  // Expect GC to make up the deficit at the rate it provided credit recently. Without
+  // a recent rate, fall back to waiting for a notification for the remaining time.
+  intptr_t deficit = -Atomic::load(&_budget);
+  double rate = Atomic::load(&_replenish_rate);
+  if (deficit > 0 && rate > 0) {
+    jlong expected_ns = (jlong) (deficit / rate);
+    return clamp<jlong>(expected_ns, 10 * NANOSECS_PER_MILLISEC / 1000, remaining_ns);
+  }
+  return remaining_ns;
+}
+
+void ShenandoahPacer::park(JavaThread* thread, jlong time_ns) {
+  if (time_ns >= NANOSECS_PER_MILLISEC) {
+    wait((size_t) (time_ns / NANOSECS_PER_MILLISEC));
+  } else {
+    // Too short for the monitor wait. Still let safepoints proceed while parked.
+    ThreadBlockInVM tbivm(thread);
+    os::naked_short_nanosleep(time_ns);
+  }
+}
+
 void ShenandoahPacer::wait(size_t time_ms) {
   // Perform timed wait. It works like like sleep(), except without modifying
   // the thread interruptible status. MonitorLocker also checks for safepoints.
@@ -293,6 +428,18 @@ void ShenandoahPacer::notify_waiters() {
   }
 }
 
+void ShenandoahPacer::update_replenish_rate() {
+  jlong now = os::javaTimeNanos();
+  jlong elapsed = now - _replenish_rate_time;
+  if (elapsed <= 0) {
+    return;
+  }
+  intptr_t replenished = Atomic::xchg(&_replenished, (intptr_t) 0, memory_order_relaxed);
+  double rate = (double) replenished / elapsed;
+  Atomic::store(&_replenish_rate, (Atomic::load(&_replenish_rate) + rate) / 2);
+  _replenish_rate_time = now;
+}
+
 void ShenandoahPacer::flush_stats_to_cycle() {
   double sum = 0;
   for (JavaThreadIteratorWithHandle jtiwh; JavaThread *t = jtiwh.next(); ) {
@@ -301,6 +448,29 @@ void ShenandoahPacer::flush_stats_to_cycle() {
   ShenandoahHeap::heap()->phase_timings()->record_phase_time(ShenandoahPhaseTimings::pacing, sum);
 }
 
+size_t ShenandoahPacer::take_delay_percentile(double percentile) {
+  size_t delays[DelayBuckets];
+  size_t total = 0;
+  for (uint i = 0; i < DelayBuckets; i++) {
+    delays[i] = Atomic::xchg(&_delays[i], (size_t) 0);
+    total += delays[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  // Delays in bucket i took at most i + 1 ms.
+  const size_t rank = (size_t) ceil(total * percentile / 100);
+  size_t seen = 0;
+  for (uint i = 0; i < DelayBuckets; i++) {
+    seen += delays[i];
+    if (seen >= rank) {
+      return i + 1;
+    }
+  }
+  return DelayBuckets;
+}
+
 void ShenandoahPacer::print_cycle_on(outputStream* out) {
   MutexLocker lock(Threads_lock);
 
@@ -341,5 +511,6 @@ void ShenandoahPacer::print_cycle_on(outputStream* out) {
 
 void ShenandoahPeriodicPacerNotifyTask::task() {
   assert(ShenandoahPacing, "Should not be here otherwise");
+  _pacer->update_replenish_rate();
   _pacer->notify_waiters();
 }
@@ -25,6 +25,7 @@
 #ifndef SHARE_GC_SHENANDOAH_SHENANDOAHPACER_HPP
 #define SHARE_GC_SHENANDOAH_SHENANDOAHPACER_HPP
 
+#include "gc/shenandoah/shenandoahAllocRequest.hpp"
 #include "gc/shenandoah/shenandoahNumberSeq.hpp"
 #include "gc/shenandoah/shenandoahPadding.hpp"
 #include "gc/shenandoah/shenandoahSharedVariables.hpp"
@@ -56,6 +57,21 @@ public:
  *
  * Currently it implements simple tax-and-spend pacing policy: GC threads provide
  * credit, allocating thread spend the credit, or stall when credit is not available.
+ *
+ * Allocating threads do not spend the shared credit directly: each keeps a small bucket
+ * of tokens, claimed from the shared credit ShenandoahPacingTokenBucket words at a time,
+ * so that most allocations do not touch the shared counter. A thread that finds no credit
+ * parks for the time GC needs to make up the deficit at its recent progress rate, rather
+ * than in whole milliseconds.
+ *
+ * Threads can be given pacing weights by name with ShenandoahPacingThreadWeights. A thread
+ * is taxed, and waits at most ShenandoahPacingMaxDelay, in proportion to its weight: heavier
+ * background threads drive the budget into deficit and absorb the delay, while lighter
+ * latency-critical threads allocate from what remains. Threads of weight 0 are not paced.
+ *
+ * With ShenandoahMarkAssist, a thread that finds no credit during concurrent mark does some
+ * of the marking itself, and only parks when there is no marking work it could take. The
+ * liveness it finds is credited like that of GC threads.
  */
 class ShenandoahPacer : public CHeapObj<mtGC> {
 private:
@@ -80,6 +96,28 @@ private:
   volatile intptr_t _progress;
   shenandoah_padding(3);
 
+  // Credit GC provided since the replenish rate was last updated, heavily updated as well
+  volatile intptr_t _replenished;
+  shenandoah_padding(4);
+
+  // Decaying average of the credit GC provides, in words per nanosecond, and the time
+  // it was last updated. Only the periodic notify task writes these.
+  volatile double _replenish_rate;
+  jlong _replenish_rate_time;
+
+  // Parsed ShenandoahPacingThreadWeights, matched against thread names in order
+  struct ThreadWeight {
+    char* _pattern;
+    double _weight;
+  };
+  ThreadWeight* _thread_weights;
+  uint _num_thread_weights;
+
+  // Number of allocations that waited since the delays were last taken, by whole milliseconds
+  // of delay. The last bucket also counts all longer delays.
+  static const uint DelayBuckets = 32;
+  volatile size_t _delays[DelayBuckets];
+
 public:
   explicit ShenandoahPacer(ShenandoahHeap* heap) :
           _heap(heap),
@@ -90,7 +128,16 @@ public:
           _epoch(0),
           _tax_rate(1),
           _budget(0),
-          _progress(PACING_PROGRESS_UNINIT) {
+          _progress(PACING_PROGRESS_UNINIT),
+          _replenished(0),
+          _replenish_rate(0),
+          _replenish_rate_time(os::javaTimeNanos()),
+          _thread_weights(nullptr),
+          _num_thread_weights(0) {
+    initialize_thread_weights();
+    for (uint i = 0; i < DelayBuckets; i++) {
+      _delays[i] = 0;
+    }
     _notify_waiters_task.enroll();
   }
 
@@ -108,14 +155,19 @@ public:
   inline void report_alloc(size_t words);
 
   bool claim_for_alloc(size_t words, bool force);
-  void pace_for_alloc(size_t words);
+  void pace_for_alloc(size_t words, ShenandoahAllocRequest::Type type);
   void unpace_for_alloc(intptr_t epoch, size_t words);
 
   void notify_waiters();
+  void update_replenish_rate();
 
   intptr_t epoch();
 
   void flush_stats_to_cycle();
+
+  // Return the delay, in milliseconds, that the given percentile of the allocations which waited
+  // since the last call did not exceed, and start over. Returns 0 if no allocation waited.
+  size_t take_delay_percentile(double percentile);
   void print_cycle_on(outputStream* out);
 
 private:
@@ -125,9 +177,18 @@ private:
   inline void add_budget(size_t words);
   void restart_with(size_t non_taxable_bytes, double tax_rate);
 
+  void initialize_thread_weights();
+  double thread_weight(JavaThread* thread) const;
+  double weighted_tax_rate(Thread* thread) const;
+
+  bool claim_budget(intptr_t tax, bool force);
+  bool claim_from_bucket(Thread* thread, intptr_t tax);
+  jlong park_time(jlong remaining_ns) const;
+
   size_t update_and_get_progress_history();
 
   void wait(size_t time_ms);
+  void park(JavaThread* thread, jlong time_ns);
 };
 
 #endif // SHARE_GC_SHENANDOAH_SHENANDOAHPACER_HPP
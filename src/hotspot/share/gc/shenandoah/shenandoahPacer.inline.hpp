@@ -49,6 +49,7 @@ inline void ShenandoahPacer::report_alloc(size_t words) {
 inline void ShenandoahPacer::report_internal(size_t words) {
   assert(ShenandoahPacing, "Only be here when pacing is enabled");
   add_budget(words);
+  Atomic::add(&_replenished, (intptr_t) words, memory_order_relaxed);
 }
 
 inline void ShenandoahPacer::report_progress_internal(size_t words) {
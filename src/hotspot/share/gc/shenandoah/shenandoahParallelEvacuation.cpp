@@ -0,0 +1,169 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "gc/shenandoah/shenandoahCollectionSet.inline.hpp"
+#include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahHeapRegion.hpp"
+#include "gc/shenandoah/shenandoahParallelEvacuation.hpp"
+#include "runtime/atomic.hpp"
+#include "utilities/copy.hpp"
+#include "utilities/spinYield.hpp"
+
+ShenandoahCollectionSetChunkIterator::ShenandoahCollectionSetChunkIterator(ShenandoahHeap* heap, ShenandoahCollectionSet* cs) :
+  _regions(NEW_C_HEAP_ARRAY(ShenandoahHeapRegion*, MAX2(cs->count(), (size_t) 1), mtGC)),
+  _num_regions(0),
+  _chunk_words(MIN2(align_down(ShenandoahEvacuationChunkSize, HeapWordSize) / HeapWordSize,
+                    ShenandoahHeapRegion::region_size_words())),
+  _chunks_per_region(0),
+  _index(0) {
+  assert(_chunk_words > 0, "Chunks must not be empty");
+  _chunks_per_region = align_up(ShenandoahHeapRegion::region_size_words(), _chunk_words) / _chunk_words;
+
+  size_t num_regions = heap->num_regions();
+  for (size_t i = 0; i < num_regions; i++) {
+    if (cs->is_in(i)) {
+      assert(_num_regions < cs->count(), "Should not have more regions than the collection set");
+      _regions[_num_regions++] = heap->get_region(i);
+    }
+  }
+}
+
+ShenandoahCollectionSetChunkIterator::~ShenandoahCollectionSetChunkIterator() {
+  FREE_C_HEAP_ARRAY(ShenandoahHeapRegion*, _regions);
+}
+
+bool ShenandoahCollectionSetChunkIterator::next(ShenandoahHeapRegion** region, HeapWord** from, HeapWord** to) {
+  const size_t max = _num_regions * _chunks_per_region;
+  while (true) {
+    size_t index = Atomic::fetch_then_add(&_index, (size_t) 1, memory_order_relaxed);
+    if (index >= max) {
+      return false;
+    }
+    ShenandoahHeapRegion* r = _regions[index / _chunks_per_region];
+    HeapWord* chunk_from = r->bottom() + (index % _chunks_per_region) * _chunk_words;
+    HeapWord* top = r->top();
+    if (chunk_from < top) {
+      *region = r;
+      *from = chunk_from;
+      *to = MIN2(chunk_from + _chunk_words, top);
+      return true;
+    }
+    // Nothing was allocated in this chunk, try the next one
+  }
+}
+
+ShenandoahSplitCopier::ShenandoahSplitCopier(uint num_jobs, size_t threshold_bytes) :
+  _threshold_words(MAX2(threshold_bytes, PieceBytes) / HeapWordSize),
+  _num_jobs(num_jobs),
+  _jobs(NEW_C_HEAP_ARRAY(Job, num_jobs, mtGC)) {
+  for (uint i = 0; i < _num_jobs; i++) {
+    Job* job = &_jobs[i];
+    job->_state = Free;
+    job->_helpers = 0;
+    job->_from = nullptr;
+    job->_to = nullptr;
+    job->_words = 0;
+    job->_pieces = 0;
+    job->_next_piece = 0;
+    job->_done_pieces = 0;
+  }
+}
+
+ShenandoahSplitCopier::~ShenandoahSplitCopier() {
+  FREE_C_HEAP_ARRAY(Job, _jobs);
+}
+
+ShenandoahSplitCopier::Job* ShenandoahSplitCopier::claim_job() {
+  for (uint i = 0; i < _num_jobs; i++) {
+    Job* job = &_jobs[i];
+    if (Atomic::load(&job->_state) == Free && Atomic::cmpxchg(&job->_state, (int) Free, (int) Setup) == Free) {
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+bool ShenandoahSplitCopier::copy_piece(Job* job) {
+  size_t piece = Atomic::fetch_then_add(&job->_next_piece, (size_t) 1, memory_order_relaxed);
+  if (piece >= job->_pieces) {
+    return false;
+  }
+  const size_t piece_words = PieceBytes / HeapWordSize;
+  size_t offset = piece * piece_words;
+  Copy::aligned_disjoint_words(job->_from + offset, job->_to + offset, MIN2(piece_words, job->_words - offset));
+  // Conservative update publishes the copied piece to the owner
+  Atomic::add(&job->_done_pieces, (size_t) 1);
+  return true;
+}
+
+void ShenandoahSplitCopier::copy(HeapWord* from, HeapWord* to, size_t words) {
+  Job* job = should_split(words) ? claim_job() : nullptr;
+  if (job == nullptr) {
+    Copy::aligned_disjoint_words(from, to, words);
+    return;
+  }
+
+  const size_t piece_words = PieceBytes / HeapWordSize;
+  job->_from = from;
+  job->_to = to;
+  job->_words = words;
+  job->_pieces = align_up(words, piece_words) / piece_words;
+  job->_next_piece = 0;
+  job->_done_pieces = 0;
+  Atomic::release_store(&job->_state, (int) Active);
+
+  while (copy_piece(job)) {
+    // Copy our share of the pieces
+  }
+
+  // Helpers never yield while they copy a piece, so this wait is short.
+  SpinYield spin;
+  while (Atomic::load_acquire(&job->_done_pieces) < job->_pieces) {
+    spin.wait();
+  }
+
+  // Late helpers may still look at the job, wait for them to leave before the job can be reused.
+  Atomic::release_store_fence(&job->_state, (int) Draining);
+  while (Atomic::load_acquire(&job->_helpers) != 0) {
+    spin.wait();
+  }
+  Atomic::release_store(&job->_state, (int) Free);
+}
+
+void ShenandoahSplitCopier::help() {
+  for (uint i = 0; i < _num_jobs; i++) {
+    Job* job = &_jobs[i];
+    if (Atomic::load(&job->_state) != Active) {
+      continue;
+    }
+    Atomic::inc(&job->_helpers);
+    if (Atomic::load_acquire(&job->_state) == Active) {
+      while (copy_piece(job)) {
+        // Help until all pieces are claimed
+      }
+    }
+    Atomic::dec(&job->_helpers);
+  }
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_GC_SHENANDOAH_SHENANDOAHPARALLELEVACUATION_HPP
+#define SHARE_GC_SHENANDOAH_SHENANDOAHPARALLELEVACUATION_HPP
+
+#include "gc/shenandoah/shenandoahPadding.hpp"
+#include "memory/allocation.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+class ShenandoahCollectionSet;
+class ShenandoahHeap;
+class ShenandoahHeapRegion;
+
+// Hands out chunks of collection set regions to evacuating workers. Chunks are claimed in region order, so
+// that a region dense with live data is evacuated by several workers at once instead of by a single straggler.
+// Each chunk is responsible for the marked objects that start within it, and the last chunk of a region is also
+// responsible for the objects above TAMS, which can only be walked by size from TAMS.
+class ShenandoahCollectionSetChunkIterator : public StackObj {
+private:
+  ShenandoahHeapRegion** _regions;
+  size_t _num_regions;
+  size_t _chunk_words;
+  size_t _chunks_per_region;
+
+  shenandoah_padding(0);
+  volatile size_t _index;
+  shenandoah_padding(1);
+
+  // No implicit copying: iterators should be passed by reference to capture the state
+  NONCOPYABLE(ShenandoahCollectionSetChunkIterator);
+
+public:
+  ShenandoahCollectionSetChunkIterator(ShenandoahHeap* heap, ShenandoahCollectionSet* cs);
+  ~ShenandoahCollectionSetChunkIterator();
+
+  // Claims the next non-empty chunk [from, to) of a collection set region. Returns false when all chunks
+  // have been claimed. Thread-safe.
+  bool next(ShenandoahHeapRegion** region, HeapWord** from, HeapWord** to);
+};
+
+// Copies large objects in pieces, with the help of other GC workers. The worker that evacuates a large object
+// publishes a copy job and claims pieces of it until none are left, while other workers pick up pieces whenever
+// they call help(). Once all pieces have been copied, the owner installs the forwarding pointer as usual, so
+// the copy becomes visible only when it is complete.
+class ShenandoahSplitCopier : public CHeapObj<mtGC> {
+private:
+  static const size_t PieceBytes = 256 * K;
+
+  enum JobState {
+    Free,
+    Setup,
+    Active,
+    Draining
+  };
+
+  struct Job {
+    shenandoah_padding(0);
+    volatile int    _state;
+    volatile uint   _helpers;
+    HeapWord*       _from;
+    HeapWord*       _to;
+    size_t          _words;
+    size_t          _pieces;
+    volatile size_t _next_piece;
+    volatile size_t _done_pieces;
+    shenandoah_padding(1);
+  };
+
+  const size_t _threshold_words;
+  const uint   _num_jobs;
+  Job*         _jobs;
+
+  Job* claim_job();
+
+  // Claim and copy one piece of job. Returns false if all pieces have been claimed.
+  bool copy_piece(Job* job);
+
+public:
+  ShenandoahSplitCopier(uint num_jobs, size_t threshold_bytes);
+  ~ShenandoahSplitCopier();
+
+  bool should_split(size_t words) const { return words >= _threshold_words; }
+
+  // Copy words from from to to, cooperatively with helping workers if the copy is large enough.
+  void copy(HeapWord* from, HeapWord* to, size_t words);
+
+  // Copy pieces of the large objects that other workers are currently copying.
+  void help();
+};
+
+#endif // SHARE_GC_SHENANDOAH_SHENANDOAHPARALLELEVACUATION_HPP
@@ -31,7 +31,10 @@
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahUtils.hpp"
 #include "gc/shenandoah/heuristics/shenandoahHeuristics.hpp"
+#include "memory/resourceArea.hpp"
 #include "runtime/orderAccess.hpp"
+#include "runtime/os.hpp"
+#include "runtime/perfData.inline.hpp"
 #include "utilities/ostream.hpp"
 
 #define SHENANDOAH_PHASE_NAME_FORMAT "%-30s"
@@ -50,10 +53,34 @@ const char* ShenandoahPhaseTimings::_phase_names[] = {
 
 #undef SHENANDOAH_PHASE_DECLARE_NAME
 
+#define SHENANDOAH_PHASE_DECLARE_ID(type, title) \
+  #type,
+
+const char* ShenandoahPhaseTimings::_phase_ids[] = {
+  SHENANDOAH_PHASE_DO(SHENANDOAH_PHASE_DECLARE_ID)
+};
+
+#undef SHENANDOAH_PHASE_DECLARE_ID
+
 ShenandoahPhaseTimings::ShenandoahPhaseTimings(uint max_workers) :
-  _max_workers(max_workers) {
+  _max_workers(max_workers),
+  _mark_steals(NEW_C_HEAP_ARRAY(size_t, max_workers, mtGC)),
+  _mark_steal_attempts(NEW_C_HEAP_ARRAY(size_t, max_workers, mtGC)),
+  _mark_idle(NEW_C_HEAP_ARRAY(size_t, max_workers, mtGC)) {
   assert(_max_workers > 0, "Must have some GC threads");
 
+  for (uint c = 0; c < _max_workers; c++) {
+    _mark_steals[c] = 0;
+    _mark_steal_attempts[c] = 0;
+    _mark_idle[c] = 0;
+  }
+  for (uint t = 0; t < _num_ref_types; t++) {
+    _ref_proc_time[t] = NEW_C_HEAP_ARRAY(double, max_workers, mtGC);
+    for (uint c = 0; c < _max_workers; c++) {
+      _ref_proc_time[t][c] = 0.0;
+    }
+  }
+
   // Initialize everything to sane defaults
   for (uint i = 0; i < _num_phases; i++) {
 #define SHENANDOAH_WORKER_DATA_NULL(type, title) \
@@ -61,6 +88,11 @@ ShenandoahPhaseTimings::ShenandoahPhaseTimings(uint max_workers) :
     SHENANDOAH_PAR_PHASE_DO(,, SHENANDOAH_WORKER_DATA_NULL)
 #undef SHENANDOAH_WORKER_DATA_NULL
     _cycle_data[i] = uninitialized();
+    _cycle_worker_max[i] = uninitialized();
+    _cycle_worker_avg[i] = uninitialized();
+    _global_worker_max[i] = nullptr;
+    _worker_max_counters[i] = nullptr;
+    _worker_avg_counters[i] = nullptr;
   }
 
   // Then punch in the worker-related data.
@@ -73,13 +105,35 @@ ShenandoahPhaseTimings::ShenandoahPhaseTimings(uint max_workers) :
       if (c++ != 0) _worker_data[i + c] = new ShenandoahWorkerData(nullptr, title, _max_workers);
       SHENANDOAH_PAR_PHASE_DO(,, SHENANDOAH_WORKER_DATA_INIT)
 #undef SHENANDOAH_WORKER_DATA_INIT
+      _global_worker_max[i] = new HdrSeq();
     }
   }
 
+  create_worker_counters();
+
   _policy = ShenandoahHeap::heap()->shenandoah_policy();
   assert(_policy != nullptr, "Can not be null");
 }
 
+void ShenandoahPhaseTimings::create_worker_counters() {
+  if (!UsePerfData) {
+    return;
+  }
+
+  EXCEPTION_MARK;
+  ResourceMark rm;
+  const char* ns = PerfDataManager::name_space("shenandoah", "phases");
+  for (uint i = 0; i < _num_phases; i++) {
+    if (is_worker_phase(Phase(i))) {
+      const char* pns = PerfDataManager::name_space(ns, _phase_ids[i]);
+      const char* cname = PerfDataManager::counter_name(pns, "workerMaxTime");
+      _worker_max_counters[i] = PerfDataManager::create_long_variable(SUN_GC, cname, PerfData::U_Ticks, CHECK);
+      cname = PerfDataManager::counter_name(pns, "workerAvgTime");
+      _worker_avg_counters[i] = PerfDataManager::create_long_variable(SUN_GC, cname, PerfData::U_Ticks, CHECK);
+    }
+  }
+}
+
 ShenandoahPhaseTimings::Phase ShenandoahPhaseTimings::worker_par_phase(Phase phase, ParPhase par_phase) {
   assert(is_worker_phase(phase), "Phase should accept worker phase times: %s", phase_name(phase));
   Phase p = Phase(phase + 1 + par_phase);
@@ -213,11 +267,56 @@ void ShenandoahPhaseTimings::flush_par_workers_to_cycle() {
       if (s != uninitialized()) {
         // add to total for phase
         set_cycle_data(Phase(phase + 1), s);
+        flush_worker_distribution(phase);
       }
     }
   }
 }
 
+void ShenandoahPhaseTimings::flush_worker_distribution(Phase phase) {
+  uint workers = 0;
+  double min = 0.0;
+  double max = 0.0;
+  double sum = 0.0;
+  for (uint c = 0; c < _max_workers; c++) {
+    double t = uninitialized();
+    for (uint i = 1; i < _num_par_phases; i++) {
+      double v = worker_data(phase, ParPhase(i))->get(c);
+      if (v != ShenandoahWorkerData::uninitialized()) {
+        t = (t == uninitialized()) ? v : t + v;
+      }
+    }
+    if (t != uninitialized()) {
+      min = (workers == 0) ? t : MIN2(min, t);
+      max = MAX2(max, t);
+      sum += t;
+      workers++;
+    }
+  }
+  if (workers == 0) {
+    return;
+  }
+
+  double avg = sum / workers;
+  _cycle_worker_max[phase] = max;
+  _cycle_worker_avg[phase] = avg;
+
+  if (_worker_max_counters[phase] != nullptr) {
+    _worker_max_counters[phase]->set_value((jlong)(max * os::elapsed_frequency()));
+    _worker_avg_counters[phase]->set_value((jlong)(avg * os::elapsed_frequency()));
+  }
+
+  EventShenandoahWorkerPhaseTimes evt;
+  if (evt.should_commit()) {
+    evt.set_name(_phase_names[phase]);
+    evt.set_workers(workers);
+    evt.set_minimum((s8)(min * NANOSECS_PER_SEC));
+    evt.set_average((s8)(avg * NANOSECS_PER_SEC));
+    evt.set_maximum((s8)(max * NANOSECS_PER_SEC));
+    evt.commit();
+  }
+}
+
 void ShenandoahPhaseTimings::flush_cycle_to_global() {
   for (uint i = 0; i < _num_phases; i++) {
     if (_cycle_data[i] != uninitialized()) {
@@ -227,10 +326,38 @@ void ShenandoahPhaseTimings::flush_cycle_to_global() {
     if (_worker_data[i] != nullptr) {
       _worker_data[i]->reset();
     }
+    if (_cycle_worker_max[i] != uninitialized()) {
+      _global_worker_max[i]->add(_cycle_worker_max[i]);
+      _cycle_worker_max[i] = uninitialized();
+      _cycle_worker_avg[i] = uninitialized();
+    }
+  }
+  for (uint c = 0; c < _max_workers; c++) {
+    _mark_steals[c] = 0;
+    _mark_steal_attempts[c] = 0;
+    _mark_idle[c] = 0;
+  }
+  for (uint t = 0; t < _num_ref_types; t++) {
+    for (uint c = 0; c < _max_workers; c++) {
+      _ref_proc_time[t][c] = 0.0;
+    }
   }
   OrderAccess::fence();
 }
 
+void ShenandoahPhaseTimings::record_mark_stealing(uint worker_id, size_t steals, size_t attempts, size_t idle) {
+  assert(worker_id < _max_workers, "Worker id is sane: %u", worker_id);
+  _mark_steals[worker_id] += steals;
+  _mark_steal_attempts[worker_id] += attempts;
+  _mark_idle[worker_id] += idle;
+}
+
+void ShenandoahPhaseTimings::record_reference_processing(uint worker_id, ReferenceType type, double time) {
+  assert(worker_id < _max_workers, "Worker id is sane: %u", worker_id);
+  assert(type < _num_ref_types, "Reference type is sane: %d", type);
+  _ref_proc_time[type][worker_id] += time;
+}
+
 void ShenandoahPhaseTimings::print_cycle_on(outputStream* out) const {
   out->cr();
   out->print_cr("All times are wall-clock times, except per-root-class counters, that are sum over");
@@ -246,6 +373,10 @@ void ShenandoahPhaseTimings::print_cycle_on(outputStream* out) const {
         if (total > 0) {
           out->print(", parallelism: " SHENANDOAH_PARALLELISM_FORMAT "x", total / v);
         }
+        if (_cycle_worker_max[i] != uninitialized() && _cycle_worker_avg[i] > 0) {
+          out->print(", slowest worker: " SHENANDOAH_US_TIME_FORMAT " us, imbalance: " SHENANDOAH_PARALLELISM_FORMAT "x",
+                     _cycle_worker_max[i] * 1000000.0, _cycle_worker_max[i] / _cycle_worker_avg[i]);
+        }
       }
 
       if (_worker_data[i] != nullptr) {
@@ -262,6 +393,42 @@ void ShenandoahPhaseTimings::print_cycle_on(outputStream* out) const {
       out->cr();
     }
   }
+
+  size_t steals = 0;
+  size_t attempts = 0;
+  size_t idle = 0;
+  for (uint c = 0; c < _max_workers; c++) {
+    steals += _mark_steals[c];
+    attempts += _mark_steal_attempts[c];
+    idle += _mark_idle[c];
+  }
+  if (attempts > 0 || idle > 0) {
+    out->print(SHENANDOAH_PHASE_NAME_FORMAT " steals: " SIZE_FORMAT ", attempts: " SIZE_FORMAT ", idle: " SIZE_FORMAT,
+               "Mark Work Stealing", steals, attempts, idle);
+    out->print(", workers (steals/attempts/idle): ");
+    for (uint c = 0; c < _max_workers; c++) {
+      out->print(SIZE_FORMAT "/" SIZE_FORMAT "/" SIZE_FORMAT ", ", _mark_steals[c], _mark_steal_attempts[c], _mark_idle[c]);
+    }
+    out->cr();
+  }
+
+  static const char* const ref_type_names[_num_ref_types] = {
+    nullptr, "Soft References", "Weak References", "Final References", "Phantom References"
+  };
+  for (uint t = REF_SOFT; t < _num_ref_types; t++) {
+    double total = 0.0;
+    for (uint c = 0; c < _max_workers; c++) {
+      total += _ref_proc_time[t][c];
+    }
+    if (total > 0) {
+      out->print("Reference Processing: " SHENANDOAH_PHASE_NAME_FORMAT " " SHENANDOAH_US_TIME_FORMAT " us, workers (us): ",
+                 ref_type_names[t], total * 1000000.0);
+      for (uint c = 0; c < _max_workers; c++) {
+        out->print(SHENANDOAH_US_WORKER_TIME_FORMAT ", ", _ref_proc_time[t][c] * 1000000.0);
+      }
+      out->cr();
+    }
+  }
 }
 
 void ShenandoahPhaseTimings::print_global_on(outputStream* out) const {
@@ -287,6 +454,9 @@ void ShenandoahPhaseTimings::print_global_on(outputStream* out) const {
   out->print_cr("  invisible to the usual profiling tools, but would add up to end-to-end application latency.");
   out->print_cr("  Raise max pacing delay with care.");
   out->cr();
+  out->print_cr("  \"slowest worker\" is the time of the worker that spent the longest in the phase, over");
+  out->print_cr("  all its sub-phases. Levels far above the phase time over parallelism point to imbalance.");
+  out->cr();
 
   for (uint i = 0; i < _num_phases; i++) {
     if (_global_data[i].maximum() != 0) {
@@ -310,6 +480,30 @@ void ShenandoahPhaseTimings::print_global_on(outputStream* out) const {
       );
     }
   }
+
+  out->cr();
+  for (uint i = 0; i < _num_phases; i++) {
+    const HdrSeq* seq = _global_worker_max[i];
+    if (seq != nullptr && seq->maximum() != 0) {
+      out->print_cr(SHENANDOAH_PHASE_NAME_FORMAT " slowest worker "
+                    "(a = " SHENANDOAH_US_TIME_FORMAT " us) "
+                    "(n = " INT32_FORMAT_W(5) ") (lvls, us = "
+                    SHENANDOAH_US_TIME_FORMAT ", "
+                    SHENANDOAH_US_TIME_FORMAT ", "
+                    SHENANDOAH_US_TIME_FORMAT ", "
+                    SHENANDOAH_US_TIME_FORMAT ", "
+                    SHENANDOAH_US_TIME_FORMAT ")",
+                    _phase_names[i],
+                    seq->avg() * 1000000.0,
+                    seq->num(),
+                    seq->percentile(0) * 1000000.0,
+                    seq->percentile(25) * 1000000.0,
+                    seq->percentile(50) * 1000000.0,
+                    seq->percentile(75) * 1000000.0,
+                    seq->maximum() * 1000000.0
+      );
+    }
+  }
 }
 
 ShenandoahWorkerTimingsTracker::ShenandoahWorkerTimingsTracker(ShenandoahPhaseTimings::Phase phase,
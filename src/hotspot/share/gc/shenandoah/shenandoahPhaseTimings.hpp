@@ -30,6 +30,8 @@
 #include "gc/shenandoah/shenandoahNumberSeq.hpp"
 #include "gc/shared/workerDataArray.hpp"
 #include "memory/allocation.hpp"
+#include "memory/referenceType.hpp"
+#include "runtime/perfDataTypes.hpp"
 
 class ShenandoahCollectorPolicy;
 class outputStream;
@@ -89,6 +91,7 @@ class outputStream;
   f(conc_weak_roots_work,                           "  Roots")                         \
   SHENANDOAH_PAR_PHASE_DO(conc_weak_roots_work_,    "    CWR: ", f)                    \
   f(conc_weak_roots_rendezvous,                     "  Rendezvous")                    \
+  f(conc_weak_roots_tables,                         "  Table Cleanup")                 \
   f(conc_cleanup_early,                             "Concurrent Cleanup")              \
   f(conc_class_unload,                              "Concurrent Class Unloading")      \
   f(conc_class_unload_unlink,                       "  Unlink Stale")                  \
@@ -110,6 +113,7 @@ class outputStream;
   f(init_update_refs_gross,                         "Pause Init Update Refs (G)")      \
   f(init_update_refs,                               "Pause Init Update Refs (N)")      \
   f(init_update_refs_manage_gclabs,                 "  Manage GCLABs")                 \
+  f(conc_init_update_refs,                          "Concurrent Init Update Refs")     \
                                                                                        \
   f(conc_update_refs,                               "Concurrent Update Refs")          \
   f(conc_update_thread_roots,                       "Concurrent Update Thread Roots")  \
@@ -122,6 +126,8 @@ class outputStream;
   f(final_update_refs_rebuild_freeset,              "  Rebuild Free Set")              \
                                                                                        \
   f(conc_cleanup_complete,                          "Concurrent Cleanup")              \
+  f(conc_reset_after_collect,                       "Concurrent Reset After Collect")  \
+  f(conc_class_unload_deferred_purge,               "Concurrent Metadata Purge")       \
   f(conc_coalesce_and_fill,                         "Concurrent Coalesce and Fill")    \
   SHENANDOAH_PAR_PHASE_DO(conc_coalesce_,           "  CC&F: ", f)                     \
                                                                                        \
@@ -184,6 +190,7 @@ class outputStream;
   f(full_gc_recompute_generation_usage,             "    Recompute generation usage")  \
   f(full_gc_copy_objects_reset_complete,            "    Reset Complete Bitmap")       \
   f(full_gc_copy_objects_rebuild,                   "    Rebuild Region Sets")         \
+  f(full_gc_restore_marks,                          "    Restore Preserved Marks")     \
   f(full_gc_reconstruct_remembered_set,             "    Reconstruct Remembered Set")  \
   f(full_gc_heapdump_post,                          "  Post Heap Dump")                \
                                                                                        \
@@ -220,10 +227,30 @@ private:
   double              _cycle_data[_num_phases];
   HdrSeq              _global_data[_num_phases];
   static const char*  _phase_names[_num_phases];
+  static const char*  _phase_ids[_num_phases];
 
   ShenandoahWorkerData* _worker_data[_num_phases];
+
+  // Distribution of per-worker times in worker phases, indexed by the worker phase. A worker
+  // time is the sum over all parallel sub-phases. The cycle keeps the slowest and the mean
+  // worker time, and the slowest worker time accumulates into a histogram over all cycles.
+  // The last cycle is also published through perf counters, when UsePerfData is enabled.
+  double              _cycle_worker_max[_num_phases];
+  double              _cycle_worker_avg[_num_phases];
+  HdrSeq*             _global_worker_max[_num_phases];
+  PerfVariable*       _worker_max_counters[_num_phases];
+  PerfVariable*       _worker_avg_counters[_num_phases];
   ShenandoahCollectorPolicy* _policy;
 
+  // Work stealing counters of marking workers in the current cycle, indexed by worker id.
+  size_t* _mark_steals;
+  size_t* _mark_steal_attempts;
+  size_t* _mark_idle;
+
+  // Reference processing time of workers in the current cycle, by reference type and worker id.
+  static const uint _num_ref_types = REF_PHANTOM + 1;
+  double* _ref_proc_time[_num_ref_types];
+
   static bool is_worker_phase(Phase phase);
   static bool is_root_work_phase(Phase phase);
 
@@ -231,6 +258,8 @@ private:
   Phase worker_par_phase(Phase phase, ParPhase par_phase);
 
   void set_cycle_data(Phase phase, double time);
+  void flush_worker_distribution(Phase phase);
+  void create_worker_counters();
   static double uninitialized() { return -1; }
 
 public:
@@ -244,6 +273,18 @@ public:
   void flush_par_workers_to_cycle();
   void flush_cycle_to_global();
 
+  // Time, in seconds, recorded for the phase in the current cycle, or zero if it has not been recorded.
+  double cycle_time(Phase phase) const {
+    double d = _cycle_data[phase];
+    return (d == uninitialized()) ? 0.0 : d;
+  }
+
+  // Accumulate the work stealing counters of a marking worker into the current cycle.
+  void record_mark_stealing(uint worker_id, size_t steals, size_t attempts, size_t idle);
+
+  // Accumulate the time a worker spent processing discovered references of the given type.
+  void record_reference_processing(uint worker_id, ReferenceType type, double time);
+
   static const char* phase_name(Phase phase) {
     assert(phase >= 0 && phase < _num_phases, "Out of bound");
     return _phase_names[phase];
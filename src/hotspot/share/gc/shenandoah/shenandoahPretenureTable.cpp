@@ -0,0 +1,134 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#include "precompiled.hpp"
+
+#include "gc/shared/gc_globals.hpp"
+#include "gc/shenandoah/shenandoahPretenureTable.hpp"
+#include "logging/log.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/klass.hpp"
+#include "runtime/atomic.hpp"
+
+ShenandoahPretenureTable::ShenandoahPretenureTable() : _pretenured_count(0) {
+  memset(_entries, 0, sizeof(_entries));
+}
+
+size_t ShenandoahPretenureTable::hash(Klass* klass) {
+  return (size_t)(((uintptr_t)klass >> LogHeapWordSize) * 0x9E3779B97F4A7C15ULL);
+}
+
+bool ShenandoahPretenureTable::is_sample(oop obj) {
+  uint64_t h = (uint64_t)(cast_from_oop<uintptr_t>(obj) >> LogMinObjAlignmentInBytes) * 0x9E3779B97F4A7C15ULL;
+  return (h >> 32) % ShenandoahPretenureSampleRate == 0;
+}
+
+const ShenandoahPretenureTable::Entry* ShenandoahPretenureTable::find(Klass* klass) const {
+  size_t h = hash(klass);
+  for (size_t probe = 0; probe < MaxProbes; probe++) {
+    const Entry* e = &_entries[(h + probe) & (Capacity - 1)];
+    Klass* k = Atomic::load(&e->_klass);
+    if (k == klass) {
+      return e;
+    }
+    if (k == nullptr) {
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+ShenandoahPretenureTable::Entry* ShenandoahPretenureTable::find_or_insert(Klass* klass) {
+  size_t h = hash(klass);
+  for (size_t probe = 0; probe < MaxProbes; probe++) {
+    Entry* e = &_entries[(h + probe) & (Capacity - 1)];
+    Klass* k = Atomic::load(&e->_klass);
+    if (k == nullptr) {
+      k = Atomic::cmpxchg(&e->_klass, (Klass*)nullptr, klass);
+      if (k == nullptr) {
+        return e;
+      }
+    }
+    if (k == klass) {
+      return e;
+    }
+  }
+  // The classes that do not fit are simply not learned.
+  return nullptr;
+}
+
+bool ShenandoahPretenureTable::should_pretenure(Klass* klass) const {
+  if (Atomic::load(&_pretenured_count) == 0) {
+    return false;
+  }
+  const Entry* e = find(klass);
+  return e != nullptr && Atomic::load(&e->_pretenure);
+}
+
+void ShenandoahPretenureTable::record_first_survival(Klass* klass, size_t bytes) {
+  Entry* e = find_or_insert(klass);
+  if (e != nullptr) {
+    Atomic::add(&e->_first_survival_bytes, bytes, memory_order_relaxed);
+  }
+}
+
+void ShenandoahPretenureTable::record_tenured(Klass* klass, size_t bytes) {
+  Entry* e = find_or_insert(klass);
+  if (e != nullptr) {
+    Atomic::add(&e->_tenured_bytes, bytes, memory_order_relaxed);
+  }
+}
+
+void ShenandoahPretenureTable::update() {
+  const double decay = 0.7;
+  const double threshold = ShenandoahPretenureSurvivalPercent / 100.0;
+  size_t pretenured = 0;
+  for (size_t i = 0; i < Capacity; i++) {
+    Entry* e = &_entries[i];
+    if (Atomic::load(&e->_klass) == nullptr) {
+      continue;
+    }
+    size_t first = Atomic::xchg(&e->_first_survival_bytes, (size_t)0);
+    size_t tenured = Atomic::xchg(&e->_tenured_bytes, (size_t)0);
+    if (first == 0 && tenured == 0) {
+      // Nothing sampled this cycle, keep the previous decision.
+      pretenured += e->_pretenure ? 1 : 0;
+      continue;
+    }
+    e->_avg_first_survival_bytes = decay * e->_avg_first_survival_bytes + (1 - decay) * first;
+    e->_avg_tenured_bytes = decay * e->_avg_tenured_bytes + (1 - decay) * tenured;
+    bool pretenure = e->_avg_first_survival_bytes > 0 &&
+                     e->_avg_tenured_bytes >= threshold * e->_avg_first_survival_bytes;
+    if (pretenure != e->_pretenure) {
+      ResourceMark rm;
+      log_debug(gc, ergo)("%s pretenuring %s: tenured %.0fB of %.0fB first surviving (sampled averages)",
+                          pretenure ? "Start" : "Stop", e->_klass->external_name(),
+                          e->_avg_tenured_bytes, e->_avg_first_survival_bytes);
+      Atomic::store(&e->_pretenure, pretenure);
+    }
+    pretenured += pretenure ? 1 : 0;
+  }
+  Atomic::store(&_pretenured_count, pretenured);
+}
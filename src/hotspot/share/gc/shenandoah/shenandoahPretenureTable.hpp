@@ -0,0 +1,83 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#ifndef SHARE_GC_SHENANDOAH_SHENANDOAHPRETENURETABLE_HPP
+#define SHARE_GC_SHENANDOAH_SHENANDOAHPRETENURETABLE_HPP
+
+#include "memory/allocation.hpp"
+#include "oops/oopsHierarchy.hpp"
+
+class Klass;
+
+// With ShenandoahPretenureSampleRate, learns which classes have young instances that mostly live until
+// they are tenured, and lets evacuation promote those instances as soon as they first survive a young
+// collection, instead of copying them within young until they reach the tenuring age.
+//
+// One in ShenandoahPretenureSampleRate young objects evacuated during young collections is sampled,
+// picked by a hash of its address. Sampled objects always take the age-based path, so the statistics
+// do not depend on the decisions they lead to. For each class, the table accumulates the bytes of
+// sampled objects evacuated for the first time, and of those promoted at the tenuring age. Once a
+// cycle is over, their decaying averages are compared: a class is pretenured while the tenured bytes
+// reach ShenandoahPretenureSurvivalPercent of the first-survival bytes.
+//
+// A class that is unloaded leaves a stale entry behind. A class loaded later at the same address may
+// inherit its decision until the averages catch up, which only affects where its objects are copied.
+class ShenandoahPretenureTable : public CHeapObj<mtGC> {
+private:
+  struct Entry {
+    Klass* volatile _klass;
+    volatile size_t _first_survival_bytes;
+    volatile size_t _tenured_bytes;
+    double _avg_first_survival_bytes;
+    double _avg_tenured_bytes;
+    volatile bool _pretenure;
+  };
+
+  static const size_t Capacity = 1024;
+  static const size_t MaxProbes = 16;
+
+  Entry _entries[Capacity];
+  volatile size_t _pretenured_count;
+
+  static size_t hash(Klass* klass);
+  const Entry* find(Klass* klass) const;
+  Entry* find_or_insert(Klass* klass);
+
+public:
+  ShenandoahPretenureTable();
+
+  // True if this evacuated object is a sample, and must take the age-based path.
+  static bool is_sample(oop obj);
+
+  bool should_pretenure(Klass* klass) const;
+
+  void record_first_survival(Klass* klass, size_t bytes);
+  void record_tenured(Klass* klass, size_t bytes);
+
+  // Folds the samples of the last cycle into the averages and updates the decisions.
+  void update();
+};
+
+#endif // SHARE_GC_SHENANDOAH_SHENANDOAHPRETENURETABLE_HPP
@@ -34,7 +34,9 @@
 #include "gc/shenandoah/shenandoahThreadLocalData.hpp"
 #include "gc/shenandoah/shenandoahUtils.hpp"
 #include "runtime/atomic.hpp"
+#include "runtime/os.hpp"
 #include "logging/log.hpp"
+#include "utilities/align.hpp"
 
 static ReferenceType reference_type(oop reference) {
   return InstanceKlass::cast(reference->klass())->reference_type();
@@ -173,7 +175,8 @@ ShenandoahRefProcThreadLocal::ShenandoahRefProcThreadLocal() :
   _discovered_list(nullptr),
   _encountered_count(),
   _discovered_count(),
-  _enqueued_count() {
+  _enqueued_count(),
+  _process_time() {
 }
 
 void ShenandoahRefProcThreadLocal::reset() {
@@ -183,6 +186,7 @@ void ShenandoahRefProcThreadLocal::reset() {
     _encountered_count[i] = 0;
     _discovered_count[i] = 0;
     _enqueued_count[i] = 0;
+    _process_time[i] = 0.0;
   }
 }
 
@@ -454,6 +458,48 @@ T* ShenandoahReferenceProcessor::keep(oop reference, ReferenceType type, uint wo
   return reference_discovered_addr<T>(reference);
 }
 
+// Time is taken once per batch of references and split between the types seen in the batch,
+// which keeps the clock reads off the per-reference path.
+class ShenandoahRefProcTypeTimer : public StackObj {
+private:
+  static const uint BatchSize = 64;
+
+  ShenandoahRefProcThreadLocal& _refproc_data;
+  size_t _batch[reference_type_count];
+  uint _batch_count;
+  double _start;
+
+  void flush_batch() {
+    const double now = os::elapsedTime();
+    const double elapsed = now - _start;
+    for (uint i = 0; i < reference_type_count; i++) {
+      if (_batch[i] > 0) {
+        _refproc_data.add_process_time((ReferenceType) i, elapsed * _batch[i] / _batch_count);
+        _batch[i] = 0;
+      }
+    }
+    _batch_count = 0;
+    _start = now;
+  }
+
+public:
+  ShenandoahRefProcTypeTimer(ShenandoahRefProcThreadLocal& refproc_data) :
+    _refproc_data(refproc_data), _batch(), _batch_count(0), _start(os::elapsedTime()) {}
+
+  ~ShenandoahRefProcTypeTimer() {
+    if (_batch_count > 0) {
+      flush_batch();
+    }
+  }
+
+  void processed(ReferenceType type) {
+    _batch[type]++;
+    if (++_batch_count == BatchSize) {
+      flush_batch();
+    }
+  }
+};
+
 template <typename T>
 void ShenandoahReferenceProcessor::process_references(ShenandoahRefProcThreadLocal& refproc_data, uint worker_id) {
   log_trace(gc, ref)("Processing discovered list #%u : " PTR_FORMAT, worker_id, p2i(refproc_data.discovered_list_head<T>()));
@@ -465,6 +511,7 @@ void ShenandoahReferenceProcessor::process_references(ShenandoahRefProcThreadLoc
     set_oop_field(list, first_resolved);
   }
   T* p = list;
+  ShenandoahRefProcTypeTimer timer(refproc_data);
   while (true) {
     const oop reference = lrb(CompressedOops::decode(*p));
     if (reference == nullptr) {
@@ -472,6 +519,7 @@ void ShenandoahReferenceProcessor::process_references(ShenandoahRefProcThreadLoc
     }
     log_trace(gc, ref)("Processing reference: " PTR_FORMAT, p2i(reference));
     const ReferenceType type = reference_type(reference);
+    timer.processed(type);
 
     if (should_drop<T>(reference, type)) {
       set_oop_field(p, drop<T>(reference, type));
@@ -504,6 +552,100 @@ void ShenandoahReferenceProcessor::process_references(ShenandoahRefProcThreadLoc
   }
 }
 
+// Advance *ref by up to count - 1 references, stopping at the end of the list.
+// Returns the number of references from the start up to and including the new *ref.
+template <typename T>
+static size_t walk_discovered_list(oop* ref, size_t count) {
+  size_t walked = 1;
+  while (walked < count) {
+    oop next = reference_discovered<T>(*ref);
+    if (next == *ref) {
+      break;
+    }
+    *ref = next;
+    walked++;
+  }
+  return walked;
+}
+
+// Discovered lists are owned by the worker that discovered the references, so a single thread
+// that finds most references leaves one long list that only one worker can process. Move the
+// tails of long lists to the heads of short ones until no list is longer than the average.
+// Lists are singly linked through the discovered field and terminated by a self-loop.
+template <typename T>
+void ShenandoahReferenceProcessor::balance_discovered_lists() {
+  const uint max_workers = ShenandoahHeap::heap()->max_workers();
+  size_t* lengths = NEW_C_HEAP_ARRAY(size_t, max_workers, mtGC);
+  size_t total = 0;
+  size_t longest = 0;
+  for (uint i = 0; i < max_workers; i++) {
+    size_t length = 0;
+    for (size_t type = 0; type < reference_type_count; type++) {
+      length += _ref_proc_thread_locals[i].discovered((ReferenceType) type);
+    }
+    lengths[i] = length;
+    total += length;
+    longest = MAX2(longest, length);
+  }
+
+  const size_t target = MAX2(align_up(total, max_workers) / max_workers, (size_t) ShenandoahRefProcBalanceMinLength);
+  if (longest <= 2 * target) {
+    FREE_C_HEAP_ARRAY(size_t, lengths);
+    return;
+  }
+
+  uint to = 0;
+  for (uint from = 0; from < max_workers; from++) {
+    if (lengths[from] <= target) {
+      continue;
+    }
+
+    // Cut the list after target references.
+    oop last = lrb(_ref_proc_thread_locals[from].discovered_list_head<T>());
+    if (last == nullptr) {
+      lengths[from] = 0;
+      continue;
+    }
+    size_t walked = walk_discovered_list<T>(&last, target);
+    oop rest = reference_discovered<T>(last);
+    if (rest == last) {
+      // Shorter than the discovery counters claimed, nothing to move.
+      lengths[from] = walked;
+      continue;
+    }
+    set_oop_field(reference_discovered_addr<T>(last), last);
+    lengths[from] = target;
+
+    // Prepend the rest to the short lists, in pieces that fill them up to target.
+    while (rest != nullptr) {
+      while (to < max_workers && lengths[to] >= target) {
+        to++;
+      }
+      // Only when the counters undercount the lists: give the remainder back to its owner.
+      const uint dest = (to < max_workers) ? to : from;
+      const size_t room = (to < max_workers) ? target - lengths[to] : SIZE_MAX;
+
+      oop piece_head = rest;
+      oop piece_last = rest;
+      walked = walk_discovered_list<T>(&piece_last, room);
+      rest = reference_discovered<T>(piece_last);
+      if (rest == piece_last) {
+        rest = nullptr;
+      }
+
+      ShenandoahRefProcThreadLocal& dest_data = _ref_proc_thread_locals[dest];
+      oop old_head = lrb(dest_data.discovered_list_head<T>());
+      set_oop_field(reference_discovered_addr<T>(piece_last), old_head == nullptr ? piece_last : old_head);
+      dest_data.set_discovered_list_head<T>(piece_head);
+      lengths[dest] += walked;
+    }
+  }
+
+  log_debug(gc, ref)("Balanced discovered lists: " SIZE_FORMAT " references, longest list " SIZE_FORMAT " -> " SIZE_FORMAT,
+                     total, longest, target);
+  FREE_C_HEAP_ARRAY(size_t, lengths);
+}
+
 void ShenandoahReferenceProcessor::work() {
   // Process discovered references
   uint max_workers = ShenandoahHeap::heap()->max_workers();
@@ -547,6 +689,14 @@ public:
 
 void ShenandoahReferenceProcessor::process_references(ShenandoahPhaseTimings::Phase phase, WorkerThreads* workers, bool concurrent) {
 
+  if (ShenandoahRefProcBalanceLists) {
+    if (UseCompressedOops) {
+      balance_discovered_lists<narrowOop>();
+    } else {
+      balance_discovered_lists<oop>();
+    }
+  }
+
   Atomic::release_store_fence(&_iterate_discovered_list_id, 0U);
 
   // Process discovered lists
@@ -646,12 +796,17 @@ void ShenandoahReferenceProcessor::collect_statistics() {
   Counters encountered = {};
   Counters discovered = {};
   Counters enqueued = {};
+  double process_time[reference_type_count] = {};
+  ShenandoahPhaseTimings* const timings = ShenandoahHeap::heap()->phase_timings();
   uint max_workers = ShenandoahHeap::heap()->max_workers();
   for (uint i = 0; i < max_workers; i++) {
     for (size_t type = 0; type < reference_type_count; type++) {
       encountered[type] += _ref_proc_thread_locals[i].encountered((ReferenceType)type);
       discovered[type] += _ref_proc_thread_locals[i].discovered((ReferenceType)type);
       enqueued[type] += _ref_proc_thread_locals[i].enqueued((ReferenceType)type);
+      double time = _ref_proc_thread_locals[i].process_time((ReferenceType)type);
+      process_time[type] += time;
+      timings->record_reference_processing(i, (ReferenceType)type, time);
     }
   }
 
@@ -666,4 +821,7 @@ void ShenandoahReferenceProcessor::collect_statistics() {
                    discovered[REF_SOFT], discovered[REF_WEAK], discovered[REF_FINAL], discovered[REF_PHANTOM]);
   log_info(gc,ref)("Enqueued    references: Soft: " SIZE_FORMAT ", Weak: " SIZE_FORMAT ", Final: " SIZE_FORMAT ", Phantom: " SIZE_FORMAT,
                    enqueued[REF_SOFT], enqueued[REF_WEAK], enqueued[REF_FINAL], enqueued[REF_PHANTOM]);
+  log_debug(gc,ref)("Processing time (us): Soft: %.0f, Weak: %.0f, Final: %.0f, Phantom: %.0f",
+                    process_time[REF_SOFT] * 1000000.0, process_time[REF_WEAK] * 1000000.0,
+                    process_time[REF_FINAL] * 1000000.0, process_time[REF_PHANTOM] * 1000000.0);
 }
@@ -82,6 +82,7 @@ private:
   Counters _encountered_count;
   Counters _discovered_count;
   Counters _enqueued_count;
+  double _process_time[reference_type_count];
   NONCOPYABLE(ShenandoahRefProcThreadLocal);
 
 public:
@@ -123,6 +124,14 @@ public:
   void inc_enqueued(ReferenceType type) {
     _enqueued_count[type]++;
   }
+
+  // Time spent processing references of the given type, in seconds.
+  double process_time(ReferenceType type) const {
+    return _process_time[type];
+  }
+  void add_process_time(ReferenceType type, double time) {
+    _process_time[type] += time;
+  }
 };
 
 class ShenandoahReferenceProcessor : public ReferenceDiscoverer {
@@ -161,6 +170,9 @@ private:
 
   template <typename T>
   void process_references(ShenandoahRefProcThreadLocal& refproc_data, uint worker_id);
+
+  template <typename T>
+  void balance_discovered_lists();
   void enqueue_references_locked();
   void enqueue_references(bool concurrent);
 
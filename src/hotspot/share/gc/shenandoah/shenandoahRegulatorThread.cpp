@@ -67,7 +67,7 @@ void ShenandoahRegulatorThread::regulate_young_and_old_cycles() {
           log_info(gc)("Heuristics request for global (unload classes) accepted.");
         }
       } else {
-        if (_young_heuristics->should_start_gc()) {
+        if (_young_heuristics->evaluate_trigger()) {
           // Give the old generation a chance to run. The old generation cycle
           // begins with a 'bootstrap' cycle that will also collect young.
           if (start_old_cycle()) {
@@ -115,7 +115,12 @@ void ShenandoahRegulatorThread::regulator_sleep() {
     _last_sleep_adjust_time = current;
   }
 
-  os::naked_short_sleep(_sleep);
+  if (ShenandoahHeap::heap()->alloc_spike_detector()->sleep(_sleep)) {
+    // Let the heuristics check the allocation rate without waiting for their next sample.
+    _young_heuristics->record_allocation_spike();
+    _global_heuristics->record_allocation_spike();
+    _sleep = ShenandoahControlIntervalMin;
+  }
   if (LogTarget(Debug, gc, thread)::is_enabled()) {
     double elapsed = os::elapsedTime() - current;
     double hiccup = elapsed - double(_sleep);
@@ -126,15 +131,15 @@ void ShenandoahRegulatorThread::regulator_sleep() {
 }
 
 bool ShenandoahRegulatorThread::start_old_cycle() {
-  return _old_heuristics->should_start_gc() && request_concurrent_gc(OLD);
+  return _old_heuristics->evaluate_trigger() && request_concurrent_gc(OLD);
 }
 
 bool ShenandoahRegulatorThread::start_young_cycle() {
-  return _young_heuristics->should_start_gc() && request_concurrent_gc(YOUNG);
+  return _young_heuristics->evaluate_trigger() && request_concurrent_gc(YOUNG);
 }
 
 bool ShenandoahRegulatorThread::start_global_cycle() {
-  return _global_heuristics->should_start_gc() && request_concurrent_gc(GLOBAL);
+  return _global_heuristics->evaluate_trigger() && request_concurrent_gc(GLOBAL);
 }
 
 bool ShenandoahRegulatorThread::request_concurrent_gc(ShenandoahGenerationType generation) {
@@ -46,6 +46,10 @@ public:
   template <typename T>
   void oops_do(T* cl, uint worker_id);
 
+  // See OopStorage::ParState::oops_do_settling(). Returns the number of skipped blocks.
+  template <typename T, typename SettledFn>
+  size_t oops_do_settling(T* cl, SettledFn settled, uintx epoch, bool skip_settled, uint worker_id);
+
   template <typename IsAlive, typename KeepAlive>
   void weak_oops_do(IsAlive* is_alive, KeepAlive* keep_alive, uint worker_id);
 
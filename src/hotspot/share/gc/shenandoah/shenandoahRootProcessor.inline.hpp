@@ -50,6 +50,13 @@ void ShenandoahVMWeakRoots<CONCURRENT>::oops_do(T* cl, uint worker_id) {
   _weak_roots.oops_do(cl);
 }
 
+template <bool CONCURRENT>
+template <typename T, typename SettledFn>
+size_t ShenandoahVMWeakRoots<CONCURRENT>::oops_do_settling(T* cl, SettledFn settled, uintx epoch, bool skip_settled, uint worker_id) {
+  ShenandoahWorkerTimingsTracker timer(_phase, ShenandoahPhaseTimings::VMWeakRoots, worker_id);
+  return _weak_roots.oops_do_settling(cl, settled, epoch, skip_settled);
+}
+
 template <bool CONCURRENT>
 template <typename IsAlive, typename KeepAlive>
 void ShenandoahVMWeakRoots<CONCURRENT>::weak_oops_do(IsAlive* is_alive, KeepAlive* keep_alive, uint worker_id) {
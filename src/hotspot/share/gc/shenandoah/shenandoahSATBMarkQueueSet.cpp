@@ -25,13 +25,119 @@
 #include "precompiled.hpp"
 
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahNUMA.hpp"
 #include "gc/shenandoah/shenandoahSATBMarkQueueSet.hpp"
 #include "gc/shenandoah/shenandoahThreadLocalData.hpp"
+#include "memory/padded.inline.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/safepoint.hpp"
+#include "utilities/globalCounter.inline.hpp"
 
 ShenandoahSATBMarkQueueSet::ShenandoahSATBMarkQueueSet(BufferNode::Allocator* allocator) :
-  SATBMarkQueueSet(allocator)
+  SATBMarkQueueSet(allocator),
+  _node_lists(nullptr),
+  _num_nodes(0)
 {}
 
+void ShenandoahSATBMarkQueueSet::initialize_node_lists(uint num_nodes) {
+  assert(_node_lists == nullptr, "Only once");
+  if (!ShenandoahSATBNodeRouting || num_nodes <= 1) {
+    return;
+  }
+  _node_lists = PaddedArray<NodeList, mtGC>::create_unfreeable(num_nodes);
+  _num_nodes = num_nodes;
+}
+
+void ShenandoahSATBMarkQueueSet::enqueue_completed_buffer(BufferNode* node) {
+  if (_num_nodes == 0) {
+    SATBMarkQueueSet::enqueue_completed_buffer(node);
+    return;
+  }
+  // The buffer was filtered by the producer when it was retired, which is the cheapest moment:
+  // entries that got marked in the meantime never reach a worker queue.
+  uint n = ShenandoahHeap::heap()->numa()->node_index_of_current_thread();
+  assert(n < _num_nodes, "node index is sane: %u", n);
+  NodeList* list = &_node_lists[n];
+  // Count before pushing, so the count is never below the actual number of buffers in the list.
+  Atomic::inc(&list->_count);
+  list->_list.push(*node);
+}
+
+BufferNode* ShenandoahSATBMarkQueueSet::get_node_buffer(uint n) {
+  NodeList* list = &_node_lists[n];
+  if (Atomic::load(&list->_count) == 0) {
+    return nullptr;
+  }
+  BufferNode* node;
+  {
+    // Same ABA protection as the shared list: buffers are recycled by the allocator only
+    // after a global counter synchronization.
+    GlobalCounter::CriticalSection cs(Thread::current());
+    node = list->_list.pop();
+  }
+  if (node != nullptr) {
+    Atomic::dec(&list->_count);
+  }
+  return node;
+}
+
+bool ShenandoahSATBMarkQueueSet::apply_closure_to_buffer(SATBBufferClosure* cl, BufferNode* node) {
+  void** buf = BufferNode::make_buffer_from_node(node);
+  size_t index = node->index();
+  size_t size = buffer_size();
+  assert(index <= size, "invariant");
+  cl->do_buffer(buf + index, size - index);
+  deallocate_buffer(node);
+  return true;
+}
+
+bool ShenandoahSATBMarkQueueSet::apply_closure_to_local_completed_buffer(SATBBufferClosure* cl) {
+  if (_num_nodes == 0) {
+    return SATBMarkQueueSet::apply_closure_to_completed_buffer(cl);
+  }
+  uint n = ShenandoahHeap::heap()->numa()->node_index_of_current_thread();
+  BufferNode* node = get_node_buffer(n);
+  return node != nullptr && apply_closure_to_buffer(cl, node);
+}
+
+bool ShenandoahSATBMarkQueueSet::apply_closure_to_completed_buffer(SATBBufferClosure* cl) {
+  if (_num_nodes > 0) {
+    uint local = ShenandoahHeap::heap()->numa()->node_index_of_current_thread();
+    for (uint i = 0; i < _num_nodes; i++) {
+      BufferNode* node = get_node_buffer((local + i) % _num_nodes);
+      if (node != nullptr) {
+        return apply_closure_to_buffer(cl, node);
+      }
+    }
+  }
+  // Buffers enqueued before node lists were set up, or by code that bypasses routing.
+  return SATBMarkQueueSet::apply_closure_to_completed_buffer(cl);
+}
+
+size_t ShenandoahSATBMarkQueueSet::completed_buffers_num() const {
+  size_t count = SATBMarkQueueSet::completed_buffers_num();
+  for (uint i = 0; i < _num_nodes; i++) {
+    count += Atomic::load(&_node_lists[i]._count);
+  }
+  return count;
+}
+
+void ShenandoahSATBMarkQueueSet::abandon_partial_marking() {
+  assert(SafepointSynchronize::is_at_safepoint(), "Must be at safepoint.");
+  for (uint i = 0; i < _num_nodes; i++) {
+    NodeList* list = &_node_lists[i];
+    Atomic::store(&list->_count, size_t(0));
+    BufferNode* buffers_to_delete = list->_list.pop_all();
+    while (buffers_to_delete != nullptr) {
+      BufferNode* bn = buffers_to_delete;
+      buffers_to_delete = bn->next();
+      bn->set_next(nullptr);
+      deallocate_buffer(bn);
+    }
+  }
+  SATBMarkQueueSet::abandon_partial_marking();
+}
+
 SATBMarkQueue& ShenandoahSATBMarkQueueSet::satb_queue_for_thread(Thread* const t) const {
   return ShenandoahThreadLocalData::satb_mark_queue(t);
 }
@@ -26,15 +26,53 @@
 #define SHARE_GC_SHENANDOAH_SHENANDOAHSATBMARKQUEUESET_HPP
 
 #include "gc/shared/satbMarkQueue.hpp"
+#include "memory/padded.hpp"
 #include "runtime/javaThread.hpp"
 #include "runtime/mutex.hpp"
 
+// In addition to the shared list of completed buffers, the set can keep one list per NUMA node.
+// When ShenandoahSATBNodeRouting is enabled, a completed (and already filtered) buffer is handed
+// to the list of the node its producer runs on, and marking workers drain the list of their own
+// node before they look at the other nodes. This keeps the objects reached from a buffer on the
+// node that most likely touched them last.
+//
+// Buffers on the node lists are not visible to the SATBMarkQueueSet accessors. Shenandoah code
+// must go through the accessors below, which hide the SATBMarkQueueSet versions and account for
+// both the shared and the node lists.
 class ShenandoahSATBMarkQueueSet : public SATBMarkQueueSet {
+private:
+  struct NodeList {
+    BufferNode::Stack _list;
+    volatile size_t   _count;
+    NodeList() : _list(), _count(0) {}
+  };
+
+  PaddedEnd<NodeList>* _node_lists;
+  uint                 _num_nodes;
+
+  BufferNode* get_node_buffer(uint node);
+  bool apply_closure_to_buffer(SATBBufferClosure* cl, BufferNode* node);
+
 public:
   ShenandoahSATBMarkQueueSet(BufferNode::Allocator* allocator);
 
+  // Set up the node lists. Called once the heap knows its NUMA layout, before marking starts.
+  void initialize_node_lists(uint num_nodes);
+
   virtual SATBMarkQueue& satb_queue_for_thread(Thread* const t) const;
   virtual void filter(SATBMarkQueue& queue);
+  virtual void enqueue_completed_buffer(BufferNode* node);
+
+  // Pop and process a completed buffer, preferring the list of the calling thread's node.
+  bool apply_closure_to_completed_buffer(SATBBufferClosure* cl);
+
+  // Pop and process a completed buffer only from the list of the calling thread's node,
+  // falling back to the shared list when node lists are not in use.
+  bool apply_closure_to_local_completed_buffer(SATBBufferClosure* cl);
+
+  size_t completed_buffers_num() const;
+
+  void abandon_partial_marking();
 };
 
 #endif // SHARE_GC_SHENANDOAH_SHENANDOAHSATBMARKQUEUESET_HPP
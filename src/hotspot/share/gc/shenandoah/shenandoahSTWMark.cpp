@@ -144,6 +144,7 @@ void ShenandoahSTWMark::mark() {
   assert(task_queues()->is_empty(), "Should be empty");
   TASKQUEUE_STATS_ONLY(task_queues()->print_taskqueue_stats());
   TASKQUEUE_STATS_ONLY(task_queues()->reset_taskqueue_stats());
+  task_queues()->release_overflow_segments();
 }
 
 void ShenandoahSTWMark::mark_roots(uint worker_id) {
@@ -30,7 +30,10 @@
 #include "gc/shenandoah/shenandoahOopClosures.inline.hpp"
 #include "gc/shenandoah/shenandoahReferenceProcessor.hpp"
 #include "gc/shenandoah/shenandoahScanRemembered.inline.hpp"
+#include "gc/shenandoah/shenandoahThreadLocalData.hpp"
+#include "gc/shenandoah/shenandoahUtils.hpp"
 #include "logging/log.hpp"
+#include "runtime/threadSMR.hpp"
 
 // A closure that takes an oop in the old generation and, if it's pointing
 // into the young generation, dirties the corresponding remembered set entry.
@@ -64,7 +67,10 @@ public:
 
 ShenandoahDirectCardMarkRememberedSet::ShenandoahDirectCardMarkRememberedSet(ShenandoahCardTable* card_table, size_t total_card_count) :
   LogCardValsPerIntPtr(log2i_exact(sizeof(intptr_t)) - log2i_exact(sizeof(CardValue))),
-  LogCardSizeInWords(log2i_exact(CardTable::card_size_in_words())) {
+  LogCardSizeInWords(log2i_exact(CardTable::card_size_in_words())),
+  _dirty_clusters(mtGC),
+  _read_table_clean(false),
+  _summary_stale(false) {
 
   // Paranoid assert for LogCardsPerIntPtr calculation above
   assert(sizeof(intptr_t) > sizeof(CardValue), "LogsCardValsPerIntPtr would underflow");
@@ -82,6 +88,93 @@ ShenandoahDirectCardMarkRememberedSet::ShenandoahDirectCardMarkRememberedSet(She
 
   assert(total_card_count % ShenandoahCardCluster<ShenandoahDirectCardMarkRememberedSet>::CardsPerCluster == 0, "Invalid card count.");
   assert(total_card_count > 0, "Card count cannot be zero.");
+
+  if (ShenandoahCardClusterSummary) {
+    // The card tables are committed as zeroes, which read as dirty cards, so the summary starts out all set.
+    _dirty_clusters.initialize(_cluster_count);
+    _dirty_clusters.set_large_range(0, _cluster_count);
+  }
+}
+
+void ShenandoahDirectCardMarkRememberedSet::swap_remset() {
+  shenandoah_assert_safepoint();
+  assert(_read_table_clean, "The read table becomes the write table and must be clean");
+
+  _card_table->swap_card_tables();
+  CardValue* const write_table_base = _card_table->write_byte_map_base();
+  for (JavaThreadIteratorWithHandle jtiwh; JavaThread *t = jtiwh.next(); ) {
+    ShenandoahThreadLocalData::set_card_table(t, write_table_base);
+  }
+  _read_table_clean = false;
+
+  if (ShenandoahCardClusterSummary) {
+    // Nothing is known about the new read table yet, so every cluster has to be treated as possibly dirty
+    // until the remembered set scan refreshes the summary.
+    _dirty_clusters.set_large_range(0, _cluster_count);
+    _summary_stale = true;
+  }
+}
+
+void ShenandoahDirectCardMarkRememberedSet::refresh_cluster_summary(size_t start_cluster_no, size_t clusters) {
+  if (!ShenandoahCardClusterSummary || !_summary_stale) {
+    return;
+  }
+  assert(start_cluster_no + clusters <= _cluster_count, "Bad cluster range");
+  const size_t cards_per_cluster = ShenandoahCardCluster<ShenandoahDirectCardMarkRememberedSet>::CardsPerCluster;
+  const size_t start_index = start_cluster_no * cards_per_cluster;
+  const intptr_t* read_table = (const intptr_t*) &(_card_table->read_byte_map())[start_index];
+  update_cluster_summary(start_index, read_table, (clusters * cards_per_cluster) >> LogCardValsPerIntPtr);
+}
+
+void ShenandoahDirectCardMarkRememberedSet::clean_read_table(HeapWord* start, size_t word_count) {
+  size_t start_index = card_index_for_addr(start);
+  assert(start_index % ((size_t)1 << LogCardValsPerIntPtr) == 0, "Expected a multiple of CardValsPerIntPtr");
+
+  intptr_t* const read_table = (intptr_t*) &(_card_table->read_byte_map())[start_index];
+
+  // Avoid division, use shift instead
+  assert(word_count % ((size_t)1 << (LogCardSizeInWords + LogCardValsPerIntPtr)) == 0, "Expected a multiple of CardSizeInWords*CardValsPerIntPtr");
+  size_t const num = word_count >> (LogCardSizeInWords + LogCardValsPerIntPtr);
+
+  for (size_t i = 0; i < num; i++) {
+    read_table[i] = CardTable::clean_card_row_val();
+  }
+  update_cluster_summary(start_index, read_table, num);
+}
+
+void ShenandoahDirectCardMarkRememberedSet::update_cluster_summary(size_t start_index, const intptr_t* read_table, size_t num) {
+  if (!ShenandoahCardClusterSummary) {
+    return;
+  }
+  const size_t cards_per_cluster = ShenandoahCardCluster<ShenandoahDirectCardMarkRememberedSet>::CardsPerCluster;
+  const size_t words_per_cluster = cards_per_cluster >> LogCardValsPerIntPtr;
+  assert(start_index % cards_per_cluster == 0, "Expected start on a cluster boundary");
+  assert(num % words_per_cluster == 0, "Expected a whole number of clusters");
+
+  size_t cluster_no = start_index / cards_per_cluster;
+  for (size_t i = 0; i < num; i += words_per_cluster, cluster_no++) {
+    // Clean cards are all ones, so the conjunction of the cluster's groups is a clean row iff every card is clean.
+    intptr_t all = CardTable::clean_card_row_val();
+    for (size_t j = 0; j < words_per_cluster; j++) {
+      all &= read_table[i + j];
+    }
+    const bool dirty = (all != CardTable::clean_card_row_val());
+    // Neighboring regions may share a bitmap word, so only touch the word when the bit changes.
+    if (_dirty_clusters.at(cluster_no) != dirty) {
+      if (dirty) {
+        _dirty_clusters.par_set_bit(cluster_no);
+      } else {
+        _dirty_clusters.par_clear_bit(cluster_no);
+      }
+    }
+  }
+}
+
+void ShenandoahDirectCardMarkRememberedSet::clear_old_remset() {
+  _card_table->clear_read_table();
+  if (ShenandoahCardClusterSummary) {
+    _dirty_clusters.clear_large();
+  }
 }
 
 // Merge any dirty values from write table into the read table, while leaving
@@ -106,6 +199,7 @@ void ShenandoahDirectCardMarkRememberedSet::merge_write_table(HeapWord* start, s
   for (size_t i = 0; i < num; i++) {
     read_table[i] &= write_table[i];
   }
+  update_cluster_summary(start_index, read_table, num);
 }
 
 // Destructively copy the write table to the read table, and clean the write table.
@@ -130,6 +224,7 @@ void ShenandoahDirectCardMarkRememberedSet::reset_remset(HeapWord* start, size_t
     read_table[i]  = write_table[i];
     write_table[i] = CardTable::clean_card_row_val();
   }
+  update_cluster_summary(start_index, read_table, num);
 }
 
 ShenandoahScanRememberedTask::ShenandoahScanRememberedTask(ShenandoahObjToScanQueueSet* queue_set,
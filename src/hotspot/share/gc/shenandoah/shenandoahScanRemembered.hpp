@@ -180,6 +180,8 @@
 #include "gc/shenandoah/shenandoahNumberSeq.hpp"
 #include "gc/shenandoah/shenandoahTaskqueue.hpp"
 #include "memory/iterator.hpp"
+#include "memory/padded.hpp"
+#include "utilities/bitMap.hpp"
 #include "utilities/globalDefinitions.hpp"
 
 class ShenandoahReferenceProcessor;
@@ -215,6 +217,22 @@ private:
   CardValue* _byte_map;         // Points to first entry within the card table
   CardValue* _byte_map_base;    // Points to byte_map minus the bias computed from address of heap memory
 
+  // Summary of the read table with one bit per card cluster. A clear bit means that every card of the
+  // cluster is clean in the read table, so the scan of the cluster may be skipped wholesale. The bitmap
+  // is maintained whenever the read table is refreshed from the write table or cleared. Searches for
+  // the next set bit step over 64 clean clusters at a time, which serves as the coarse level.
+  CHeapBitMap _dirty_clusters;
+
+  // True when every card of the read table is known to be clean, so that it may become the write table.
+  bool _read_table_clean;
+
+  // True when the summary was conservatively set after swapping in a new read table, so that the first
+  // scan of the read table should recompute it for the clusters it visits.
+  bool _summary_stale;
+
+  // Recompute the summary bits for the clusters spanned by the intptr_t groups [read_table, read_table + num).
+  void update_cluster_summary(size_t start_index, const intptr_t* read_table, size_t num);
+
 public:
 
   // count is the number of cards represented by the card table.
@@ -239,11 +257,36 @@ public:
   inline void mark_range_as_clean(HeapWord *p, size_t num_heap_words);
   inline size_t cluster_count() const;
 
-  // Called by GC thread at start of concurrent mark to exchange roles of read and write remembered sets.
-  // Not currently used because mutator write barrier does not honor changes to the location of card table.
-  // Instead of swap_remset, the current implementation of concurrent remembered set scanning does reset_remset
-  // in parallel threads, each invocation processing one entire HeapRegion at a time.
-  void swap_remset() {  _card_table->swap_card_tables(); }
+  // Return the first cluster in [from, to) that may hold a dirty card of the read table, or to if there is none.
+  inline size_t next_dirty_cluster(size_t from, size_t to) const;
+
+  // Return the first cluster in [from, to) whose read table cards are known to be clean, or to if there is none.
+  inline size_t next_clean_cluster(size_t from, size_t to) const;
+
+  // Return the highest index in [lowest, cur] whose card in ctbm is not clean, or lowest - 1 if all are clean.
+  // Cards are compared Stride at a time where the range allows it: Stride = CardValue is the plain byte-wise
+  // search, and wider unsigned integer types examine sizeof(Stride) cards with each load.
+  template <typename Stride>
+  static inline ssize_t find_prev_non_clean_card(const CardValue* ctbm, ssize_t cur, ssize_t lowest);
+
+  // Called by the VM thread at the init-mark safepoint to exchange roles of read and write remembered sets,
+  // and to publish the new write table to the card-marking barriers of all mutator threads. The read table
+  // must have been cleaned beforehand, see clean_read_table(). When ShenandoahSwapCardTables is disabled,
+  // reset_remset is used instead, copying each old region's cards from the write table to the read table.
+  void swap_remset();
+
+  // Clean the read table cards spanning [start, start + word_count). Callers clean the whole card table
+  // in parallel chunks and then record that with set_read_table_clean(true).
+  void clean_read_table(HeapWord* start, size_t word_count);
+
+  bool is_read_table_clean() const { return _read_table_clean; }
+  void set_read_table_clean(bool clean) { _read_table_clean = clean; }
+
+  // Recompute the summary of the read table for the clusters [start_cluster_no, start_cluster_no + clusters)
+  // if it is stale. Workers refresh disjoint ranges in parallel while they scan the remembered set, which
+  // costs one pass over the cards, and then skip every cluster that turned out clean.
+  void refresh_cluster_summary(size_t start_cluster_no, size_t clusters);
+  void set_summary_fresh() { _summary_stale = false; }
 
   // Merge any dirty values from write table into the read table, while leaving
   // the write table unchanged.
@@ -253,7 +296,7 @@ public:
   void reset_remset(HeapWord* start, size_t word_count);
 
   // Called by GC thread after scanning old remembered set in order to prepare for next GC pass
-  void clear_old_remset() {  _card_table->clear_read_table(); }
+  void clear_old_remset();
 };
 
 // A ShenandoahCardCluster represents the minimal unit of work
@@ -403,6 +446,11 @@ public:
     return (object_starts[card_index].offsets.first & ObjectStartsInCardRegion) != 0;
   }
 
+  // Return the highest index in [lowest, cur_index] for which starts_object() holds, or lowest - 1 if there
+  // is none. Entries are tested a machine word at a time where possible, which shortens the walk over the
+  // cards spanned by a large object.
+  inline ssize_t find_prev_starts_object(ssize_t cur_index, ssize_t lowest) const;
+
   inline void clear_objects_in_range(HeapWord *addr, size_t num_words) {
     size_t card_index = _rs->card_index_for_addr(addr);
     size_t last_card_index = _rs->card_index_for_addr(addr + num_words - 1);
@@ -714,6 +762,9 @@ private:
 
   int _card_stats_log_counter[2] = {0, 0};
 
+  // Per worker totals of the current scan, kept in all builds
+  PaddedEnd<ShenandoahCardScanTotals>* _scan_totals;
+
 public:
   // How to instantiate this object?
   //   ShenandoahDirectCardMarkRememberedSet *rs =
@@ -745,10 +796,14 @@ public:
     } else {
       _card_stats = nullptr;
     }
+
+    _scan_totals = NEW_C_HEAP_ARRAY(PaddedEnd<ShenandoahCardScanTotals>, ParallelGCThreads, mtGC);
+    clear_scan_totals();
   }
 
   ~ShenandoahScanRemembered() {
     delete _scc;
+    FREE_C_HEAP_ARRAY(PaddedEnd<ShenandoahCardScanTotals>, _scan_totals);
     if (ShenandoahEnableCardStats) {
       for (uint i = 0; i < ParallelGCThreads; i++) {
         delete _card_stats[i];
@@ -765,6 +820,17 @@ public:
     return ShenandoahEnableCardStats ? _card_stats[worker_id] : nullptr;
   }
 
+  ShenandoahCardScanTotals* scan_totals(uint worker_id) {
+    assert(worker_id < ParallelGCThreads, "Error");
+    return &_scan_totals[worker_id];
+  }
+
+  void clear_scan_totals() {
+    for (uint i = 0; i < ParallelGCThreads; i++) {
+      _scan_totals[i].clear();
+    }
+  }
+
   HdrSeq* card_stats_for_phase(CardStatLogType t) {
     switch (t) {
       case CARD_STAT_SCAN_RS:
@@ -812,6 +878,14 @@ public:
   // Called by GC thread at start of concurrent mark to exchange roles of read and write remembered sets.
   void swap_remset() { _rs->swap_remset(); }
 
+  void clean_read_table(HeapWord* start, size_t word_count) { _rs->clean_read_table(start, word_count); }
+
+  bool is_read_table_clean() const { return _rs->is_read_table_clean(); }
+  void set_read_table_clean(bool clean) { _rs->set_read_table_clean(clean); }
+
+  // Called once the remembered set scan has refreshed the summary of the clusters it visited.
+  void set_summary_fresh() { _rs->set_summary_fresh(); }
+
   void reset_remset(HeapWord* start, size_t word_count) { _rs->reset_remset(start, word_count); }
 
   void merge_write_table(HeapWord* start, size_t word_count) { _rs->merge_write_table(start, word_count); }
@@ -910,6 +984,9 @@ public:
 
   // Log stats related to card/RS stats for given phase t
   void log_card_stats(uint nworkers, CardStatLogType t) PRODUCT_RETURN;
+
+  // Log and send to JFR the totals of the scan of phase t just completed by nworkers, then clear them
+  void report_scan_totals(uint nworkers, CardStatLogType t);
 private:
   // Log stats for given worker id related into given summary card/RS stats
   void log_worker_card_stats(uint worker_id, HdrSeq* sum_stats) PRODUCT_RETURN;
@@ -942,7 +1019,7 @@ struct ShenandoahRegionChunk {
 // when there is less meaningful work to be performed by the remaining worker threads while they wait for
 // worker threads with difficult assignments to finish, reducing the overall duration of the phase.
 
-class ShenandoahRegionChunkIterator : public StackObj {
+class ShenandoahRegionChunkIterator : public CHeapObj<mtGC> {
 private:
   // The largest chunk size is 4 MiB, measured in words.  Otherwise, remembered set scanning may become too unbalanced.
   // If the largest chunk size is too small, there is too much overhead sifting out assignments to individual worker threads.
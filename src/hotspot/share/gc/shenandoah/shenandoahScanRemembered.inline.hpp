@@ -36,7 +36,10 @@
 #include "gc/shenandoah/shenandoahOldGeneration.hpp"
 #include "gc/shenandoah/shenandoahScanRemembered.hpp"
 #include "gc/shenandoah/mode/shenandoahMode.hpp"
+#include "jfr/jfrEvents.hpp"
 #include "logging/log.hpp"
+#include "runtime/timer.hpp"
+#include "utilities/align.hpp"
 
 inline size_t
 ShenandoahDirectCardMarkRememberedSet::last_valid_index() const {
@@ -157,6 +160,50 @@ ShenandoahDirectCardMarkRememberedSet::cluster_count() const {
   return _cluster_count;
 }
 
+inline size_t
+ShenandoahDirectCardMarkRememberedSet::next_dirty_cluster(size_t from, size_t to) const {
+  assert(from <= to && to <= _cluster_count, "Bad cluster range");
+  if (!ShenandoahCardClusterSummary) {
+    return from;
+  }
+  return _dirty_clusters.find_first_set_bit(from, to);
+}
+
+inline size_t
+ShenandoahDirectCardMarkRememberedSet::next_clean_cluster(size_t from, size_t to) const {
+  assert(from <= to && to <= _cluster_count, "Bad cluster range");
+  if (!ShenandoahCardClusterSummary) {
+    return to;
+  }
+  return _dirty_clusters.find_first_clear_bit(from, to);
+}
+
+template <typename Stride>
+inline ssize_t
+ShenandoahDirectCardMarkRememberedSet::find_prev_non_clean_card(const CardValue* ctbm, ssize_t cur, ssize_t lowest) {
+  STATIC_ASSERT(CardTable::clean_card_val() == (CardValue) -1);
+  constexpr ssize_t cards_per_stride = sizeof(Stride) / sizeof(CardValue);
+  constexpr Stride clean_stride = ~(Stride) 0;
+
+  // Walk back card by card until the cards below cur + 1 can be loaded Stride at a time.
+  while (cur >= lowest && !is_aligned(&ctbm[cur + 1], sizeof(Stride))) {
+    if (ctbm[cur] != CardTable::clean_card_val()) {
+      return cur;
+    }
+    cur--;
+  }
+  // Skip whole strides of clean cards.
+  while (cur - cards_per_stride + 1 >= lowest &&
+         *reinterpret_cast<const Stride*>(&ctbm[cur - cards_per_stride + 1]) == clean_stride) {
+    cur -= cards_per_stride;
+  }
+  // Pin down the card within the first stride that is not clean, or finish the unaligned tail.
+  while (cur >= lowest && ctbm[cur] == CardTable::clean_card_val()) {
+    cur--;
+  }
+  return cur;
+}
+
 // No lock required because arguments align with card boundaries.
 template<typename RememberedSet>
 inline void
@@ -189,16 +236,50 @@ ShenandoahCardCluster<RememberedSet>::register_object_without_lock(HeapWord* add
   HeapWord *card_start_address = _rs->addr_for_card_index(card_at_start);
   uint8_t offset_in_card = address - card_start_address;
 
-  if (!starts_object(card_at_start)) {
-    set_starts_object_bit(card_at_start);
-    set_first_start(card_at_start, offset_in_card);
-    set_last_start(card_at_start, offset_in_card);
+  // Compute the new entry in a register and publish it with a single store, so that the
+  // first and last start of a card are never observed out of step with each other.
+  crossing_info info = object_starts[card_at_start];
+  if ((info.offsets.first & ObjectStartsInCardRegion) == 0) {
+    info.offsets.first = ObjectStartsInCardRegion | offset_in_card;
+    info.offsets.last = offset_in_card;
   } else {
-    if (offset_in_card < get_first_start(card_at_start))
-      set_first_start(card_at_start, offset_in_card);
-    if (offset_in_card > get_last_start(card_at_start))
-      set_last_start(card_at_start, offset_in_card);
+    if (offset_in_card < (info.offsets.first & FirstStartBits)) {
+      info.offsets.first = ObjectStartsInCardRegion | offset_in_card;
+    }
+    if (offset_in_card > info.offsets.last) {
+      info.offsets.last = offset_in_card;
+    }
+  }
+  object_starts[card_at_start].short_word = info.short_word;
+}
+
+template<typename RememberedSet>
+inline ssize_t
+ShenandoahCardCluster<RememberedSet>::find_prev_starts_object(ssize_t cur_index, ssize_t lowest) const {
+  // Entries are examined four at a time once cur_index + 1 is aligned on a group of them.
+  typedef uint64_t group_t;
+  constexpr ssize_t entries_per_group = sizeof(group_t) / sizeof(crossing_info);
+  STATIC_ASSERT(entries_per_group == 4);
+
+  crossing_info starts_bit;
+  starts_bit.short_word = 0;
+  starts_bit.offsets.first = ObjectStartsInCardRegion;
+  const group_t starts_mask = (group_t) starts_bit.short_word * UCONST64(0x0001000100010001);
+
+  while (cur_index >= lowest && !is_aligned(&object_starts[cur_index + 1], sizeof(group_t))) {
+    if (starts_object(cur_index)) {
+      return cur_index;
+    }
+    cur_index--;
+  }
+  while (cur_index - entries_per_group + 1 >= lowest &&
+         (*reinterpret_cast<const group_t*>(&object_starts[cur_index - entries_per_group + 1]) & starts_mask) == 0) {
+    cur_index -= entries_per_group;
   }
+  while (cur_index >= lowest && !starts_object(cur_index)) {
+    cur_index--;
+  }
+  return cur_index;
 }
 
 template<typename RememberedSet>
@@ -301,10 +382,9 @@ ShenandoahCardCluster<RememberedSet>::block_start(const size_t card_index) const
   ssize_t cur_index = (ssize_t)card_index;
   assert(cur_index >= 0, "Overflow");
   assert(cur_index > 0, "Should have returned above");
-  // Walk backwards over the cards...
-  while (--cur_index > 0 && !starts_object(cur_index)) {
-   // ... to the one that starts the object
-  }
+  // Walk backwards over the cards to the one that starts the object, several cards at a time.
+  // This stops at card 0 without inspecting it.
+  cur_index = find_prev_starts_object(cur_index - 1, 1);
   // cur_index should start an object: we should not have walked
   // past the left end of the region.
   assert(cur_index >= 0 && (cur_index <= (ssize_t)card_index), "Error");
@@ -604,6 +684,7 @@ void ShenandoahScanRemembered<RememberedSet>::process_clusters(size_t first_clus
   const HeapWord* tams = (ctx == nullptr ? region->bottom() : ctx->top_at_mark_start(region));
 
   NOT_PRODUCT(ShenandoahCardStats stats(whole_cards, card_stats(worker_id));)
+  ShenandoahCardScanCounter counts(whole_cards, scan_totals(worker_id));
 
   // In the case of imprecise marking, we remember the lowest address
   // scanned in a range of dirty cards, as we work our way left from the
@@ -656,6 +737,7 @@ void ShenandoahScanRemembered<RememberedSet>::process_clusters(size_t first_clus
       assert(ctbm[dirty_r] == CardTable::dirty_card_val(), "Last card in range should be dirty");
       // Record alternations, dirty run length, and dirty card count
       NOT_PRODUCT(stats.record_dirty_run(dirty_r - dirty_l + 1);)
+      counts.record_dirty_run(dirty_r - dirty_l + 1);
 
       // Find first object that starts this range:
       // [left, right) is a maximal right-open interval of dirty cards
@@ -737,7 +819,7 @@ void ShenandoahScanRemembered<RememberedSet>::process_clusters(size_t first_clus
           // apply the closure to the oops in the portion of
           // the object within mr.
           p += obj->oop_iterate_size(cl, mr);
-          NOT_PRODUCT(i++);
+          i++;
         } else {
           // forget the last object pointer we remembered
           last_p = nullptr;
@@ -770,6 +852,7 @@ void ShenandoahScanRemembered<RememberedSet>::process_clusters(size_t first_clus
         }
       }
       NOT_PRODUCT(stats.record_scan_obj_cnt(i);)
+      counts.record_scan_obj_cnt(i);
 
       // ==== END   DIRTY card range processing ====
     } else {
@@ -780,13 +863,11 @@ void ShenandoahScanRemembered<RememberedSet>::process_clusters(size_t first_clus
       // counting contiguous runs of clean cards (and only for non-product builds).
       assert(use_write_table || ctbm[cur_index] == CardTable::clean_card_val(), "Error");
 
-      // walk back over contiguous clean cards
-      size_t i = 0;
-      while (--cur_index >= (ssize_t)start_card_index && ctbm[cur_index] == CardTable::clean_card_val()) {
-        NOT_PRODUCT(i++);
-      }
+      // walk back over contiguous clean cards, a word at a time where possible
+      const ssize_t clean_r = cur_index;
+      cur_index = RememberedSet::template find_prev_non_clean_card<uintptr_t>(ctbm, cur_index - 1, (ssize_t)start_card_index);
       // Record alternations, clean run length, and clean card count
-      NOT_PRODUCT(stats.record_clean_run(i);)
+      NOT_PRODUCT(stats.record_clean_run(clean_r - cur_index - 1);)
 
       // ==== END CLEAN card range processing ====
     }
@@ -858,13 +939,19 @@ ShenandoahScanRemembered<RememberedSet>::process_region_slice(ShenandoahHeapRegi
   // Objects that start between start_of_range and end_of_range, including humongous objects, will
   // be fully processed by process_clusters. In no case should we need to scan past end_of_range.
   if (start_of_range < end_of_range) {
+    if (!use_write_table) {
+      _rs->refresh_cluster_summary(start_cluster_no, clusters);
+    }
     if (region->is_humongous()) {
       ShenandoahHeapRegion* start_region = region->humongous_start_region();
       // TODO: ysr : This will be called multiple times with same start_region, but different start_cluster_no.
       // Check that it does the right thing here, and doesn't do redundant work. Also see if the call API/interface
       // can be simplified.
-      process_humongous_clusters(start_region, start_cluster_no, clusters, end_of_range, cl, use_write_table);
-    } else {
+      const size_t end_cluster_no = start_cluster_no + clusters;
+      if (use_write_table || _rs->next_dirty_cluster(start_cluster_no, end_cluster_no) < end_cluster_no) {
+        process_humongous_clusters(start_region, start_cluster_no, clusters, end_of_range, cl, use_write_table);
+      }
+    } else if (use_write_table) {
       // TODO: ysr The start_of_range calculated above is discarded and may be calculated again in process_clusters().
       // See if the redundant and wasted calculations can be avoided, and if the call parameters can be cleaned up.
       // It almost sounds like this set of methods needs a working class to stash away some useful info that can be
@@ -874,6 +961,17 @@ ShenandoahScanRemembered<RememberedSet>::process_region_slice(ShenandoahHeapRegi
       // We need to be careful however that if the number of workers changes dynamically that state isn't sequestered
       // and become obsolete.
       process_clusters(start_cluster_no, clusters, end_of_range, cl, use_write_table, worker_id);
+    } else {
+      // The read table does not change while we scan it, so its summary tells us which runs of clusters
+      // hold no dirty cards at all. Those are skipped wholesale. Objects that straddle into a skipped run
+      // are still handled by the run holding their head card, exactly as if the clean cards had been walked.
+      const size_t end_cluster_no = start_cluster_no + clusters;
+      size_t cluster_no = _rs->next_dirty_cluster(start_cluster_no, end_cluster_no);
+      while (cluster_no < end_cluster_no && addr_for_cluster(cluster_no) < end_of_range) {
+        const size_t run_end = _rs->next_clean_cluster(cluster_no + 1, end_cluster_no);
+        process_clusters(cluster_no, run_end - cluster_no, end_of_range, cl, false /* use_write_table */, worker_id);
+        cluster_no = _rs->next_dirty_cluster(run_end, end_cluster_no);
+      }
     }
   }
 }
@@ -922,6 +1020,43 @@ void ShenandoahScanRemembered<RememberedSet>::roots_do(OopIterateClosure* cl) {
   }
 }
 
+template<typename RememberedSet>
+void ShenandoahScanRemembered<RememberedSet>::report_scan_totals(uint nworkers, CardStatLogType t) {
+  ShenandoahCardScanTotals sum;
+  sum.clear();
+  jlong max_ticks = 0;
+  for (uint i = 0; i < nworkers; i++) {
+    const ShenandoahCardScanTotals* w = scan_totals(i);
+    log_debug(gc, remset)("%s: worker %u examined " SIZE_FORMAT " cards, " SIZE_FORMAT " dirty, "
+                          SIZE_FORMAT " objects scanned in %.3fms",
+                          _card_stat_log_type[t], i, w->_cards, w->_dirty_cards, w->_objects,
+                          TimeHelper::counter_to_millis(w->_ticks));
+    sum.add(*w);
+    max_ticks = MAX2(max_ticks, w->_ticks);
+  }
+  const jlong avg_ticks = nworkers > 0 ? sum._ticks / nworkers : 0;
+
+  log_info(gc, remset)("%s: " SIZE_FORMAT " cards examined, " SIZE_FORMAT " dirty (%.1f%%), "
+                       SIZE_FORMAT " objects scanned (%.2f per dirty card), worker time avg %.3fms, max %.3fms",
+                       _card_stat_log_type[t], sum._cards, sum._dirty_cards, percent_of(sum._dirty_cards, sum._cards),
+                       sum._objects, sum._dirty_cards > 0 ? (double) sum._objects / sum._dirty_cards : 0.0,
+                       TimeHelper::counter_to_millis(avg_ticks), TimeHelper::counter_to_millis(max_ticks));
+
+  EventShenandoahRememberedSetScan evt;
+  if (evt.should_commit()) {
+    evt.set_phase(_card_stat_log_type[t]);
+    evt.set_workers(nworkers);
+    evt.set_cards(sum._cards);
+    evt.set_dirtyCards(sum._dirty_cards);
+    evt.set_objects(sum._objects);
+    evt.set_averageWorkerTime((s8) (TimeHelper::counter_to_seconds(avg_ticks) * NANOSECS_PER_SEC));
+    evt.set_maximumWorkerTime((s8) (TimeHelper::counter_to_seconds(max_ticks) * NANOSECS_PER_SEC));
+    evt.commit();
+  }
+
+  clear_scan_totals();
+}
+
 #ifndef PRODUCT
 // Log given card stats
 template<typename RememberedSet>
@@ -0,0 +1,159 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#include "precompiled.hpp"
+
+#include "gc/shared/gc_globals.hpp"
+#include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahHeapRegion.hpp"
+#include "gc/shenandoah/shenandoahMmuTracker.hpp"
+#include "gc/shenandoah/shenandoahSoftMaxController.hpp"
+#include "logging/log.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/os.hpp"
+#ifdef LINUX
+#include "osContainer_linux.hpp"
+#endif
+
+// Total time the tasks of the container stalled on memory, or -1 if not known.
+static jlong memory_stall_time_us() {
+#ifdef LINUX
+  if (OSContainer::is_containerized()) {
+    return OSContainer::memory_stall_time_us();
+  }
+#endif
+  return -1;
+}
+
+ShenandoahSoftMaxController::ShenandoahSoftMaxController() :
+  _last_time(0.0),
+  _last_gc_time(0.0),
+  _last_stall_check_time(0.0),
+  _last_stall_us(-1),
+  _initial_soft_max(0) {
+}
+
+void ShenandoahSoftMaxController::initialize() {
+  double mutator_time;
+  ShenandoahMmuTracker::fetch_cpu_times(_last_gc_time, mutator_time);
+  _last_time = os::elapsedTime();
+  _last_stall_check_time = _last_time;
+  _last_stall_us = memory_stall_time_us();
+  _initial_soft_max = ShenandoahHeap::heap()->soft_max_capacity();
+}
+
+size_t ShenandoahSoftMaxController::step(ShenandoahHeap* heap) {
+  return align_up(heap->max_capacity() / 32, ShenandoahHeapRegion::region_size_bytes());
+}
+
+size_t ShenandoahSoftMaxController::bound(ShenandoahHeap* heap, size_t proposed) {
+  // Leave the heuristics the free space they would otherwise trigger on right away.
+  size_t floor = heap->used() + heap->max_capacity() / 100 * ShenandoahMinFreeThreshold;
+  proposed = MAX2(proposed, MAX2(floor, heap->min_capacity()));
+  return MIN2(align_up(proposed, ShenandoahHeapRegion::region_size_bytes()), heap->max_capacity());
+}
+
+bool ShenandoahSoftMaxController::low_on_memory(julong& available, julong& physical) {
+  physical = os::physical_memory();
+  available = os::available_memory();
+  return available < physical / 100 * ShenandoahSoftMaxMemoryPressure;
+}
+
+void ShenandoahSoftMaxController::adjust(ShenandoahHeap* heap) {
+  if (!ShenandoahSoftMaxControl) {
+    return;
+  }
+
+  double now = os::elapsedTime();
+  double gc_time, mutator_time;
+  ShenandoahMmuTracker::fetch_cpu_times(gc_time, mutator_time);
+  double period = now - _last_time;
+  double gcu = (period > 0) ? (gc_time - _last_gc_time) / (os::initial_active_processor_count() * period) : 0;
+  _last_time = now;
+  _last_gc_time = gc_time;
+
+  julong physical, available;
+  bool pressure = low_on_memory(available, physical);
+
+  const size_t current = heap->soft_max_capacity();
+  const size_t step = ShenandoahSoftMaxController::step(heap);
+  const double target = ShenandoahSoftMaxTargetGCU / 100.0;
+
+  size_t proposed = current;
+  if (pressure || gcu < target / 2) {
+    proposed = (current > step) ? current - step : 0;
+  } else if (gcu > target) {
+    proposed = current + step;
+  }
+  proposed = bound(heap, proposed);
+
+  if (proposed != current) {
+    log_info(gc, ergo)("Soft max heap size " PROPERFMT " -> " PROPERFMT ": GCU %.1f%% (target %.1f%%), available memory " PROPERFMT " of " PROPERFMT,
+                       PROPERFMTARGS(current), PROPERFMTARGS(proposed), gcu * 100, target * 100,
+                       PROPERFMTARGS(available), PROPERFMTARGS(physical));
+    Atomic::store(&SoftMaxHeapSize, proposed);
+  }
+}
+
+bool ShenandoahSoftMaxController::check_memory_pressure(ShenandoahHeap* heap) {
+  if (ShenandoahMemoryStallThreshold == 0) {
+    return false;
+  }
+
+  // Stall ratios over shorter periods are too noisy to act on.
+  double now = os::elapsedTime();
+  double period = now - _last_stall_check_time;
+  if (period < 1.0) {
+    return false;
+  }
+  jlong stall_us = memory_stall_time_us();
+  double stall = (stall_us >= 0 && _last_stall_us >= 0) ? (stall_us - _last_stall_us) / (period * 1000000) : 0;
+  _last_stall_check_time = now;
+  _last_stall_us = stall_us;
+
+  julong physical, available;
+  bool low = low_on_memory(available, physical);
+  bool pressure = low || stall * 100 > ShenandoahMemoryStallThreshold;
+
+  const size_t current = heap->soft_max_capacity();
+  size_t proposed = current;
+  if (pressure) {
+    proposed = bound(heap, (current > step(heap)) ? current - step(heap) : 0);
+    if (proposed >= current) {
+      // Soft max is as low as the live heap allows, another cycle would not shed more.
+      return false;
+    }
+  } else if (!ShenandoahSoftMaxControl && current < _initial_soft_max) {
+    proposed = MIN2(current + step(heap), _initial_soft_max);
+  } else {
+    return false;
+  }
+
+  log_info(gc, ergo)("Soft max heap size " PROPERFMT " -> " PROPERFMT ": memory stalls %.1f%% (threshold " UINTX_FORMAT "%%), available memory " PROPERFMT " of " PROPERFMT,
+                     PROPERFMTARGS(current), PROPERFMTARGS(proposed), stall * 100, ShenandoahMemoryStallThreshold,
+                     PROPERFMTARGS(available), PROPERFMTARGS(physical));
+  Atomic::store(&SoftMaxHeapSize, proposed);
+  return pressure;
+}
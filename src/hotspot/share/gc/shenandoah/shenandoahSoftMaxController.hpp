@@ -0,0 +1,74 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#ifndef SHARE_GC_SHENANDOAH_SHENANDOAHSOFTMAXCONTROLLER_HPP
+#define SHARE_GC_SHENANDOAH_SHENANDOAHSOFTMAXCONTROLLER_HPP
+
+#include "memory/allocation.hpp"
+
+class ShenandoahHeap;
+
+/*
+ * With ShenandoahSoftMaxControl, this controller sets SoftMaxHeapSize after every GC
+ * session, and the control thread then applies it with the existing soft max and
+ * uncommit machinery. Soft max grows while the GC threads use more than
+ * ShenandoahSoftMaxTargetGCU percent of the CPU, and shrinks while they use less than
+ * half of that, or while the machine (or container) runs low on available memory. It
+ * never shrinks below the heap used at the end of the session, plus the free space the
+ * heuristics need to avoid triggering back to back.
+ *
+ * With ShenandoahMemoryStallThreshold, the controller also samples the memory pressure
+ * stall time of the container every second. While tasks stall on memory for more than
+ * that percentage of the time, or available memory runs low, it lowers soft max by a
+ * step and asks for a cycle, after which the heap is uncommitted down to the new soft
+ * max. Once the pressure is gone, soft max is raised back to its initial value.
+ */
+class ShenandoahSoftMaxController {
+private:
+  double _last_time;
+  double _last_gc_time;
+
+  double _last_stall_check_time;
+  jlong  _last_stall_us;
+  size_t _initial_soft_max;
+
+  static size_t step(ShenandoahHeap* heap);
+  static size_t bound(ShenandoahHeap* heap, size_t proposed);
+  static bool low_on_memory(julong& available, julong& physical);
+
+public:
+  ShenandoahSoftMaxController();
+
+  void initialize();
+
+  // Called by the control thread once a GC session is over.
+  void adjust(ShenandoahHeap* heap);
+
+  // Called by the thread evaluating the heuristics. Returns true if memory
+  // pressure lowered soft max and a cycle should start to shed memory.
+  bool check_memory_pressure(ShenandoahHeap* heap);
+};
+
+#endif // SHARE_GC_SHENANDOAH_SHENANDOAHSOFTMAXCONTROLLER_HPP
@@ -32,6 +32,7 @@ public:
   static inline bool is_string_candidate(oop obj);
   static inline bool is_candidate(oop obj);
   static inline bool dedup_requested(oop obj);
+  static inline bool try_request(oop obj);
 };
 
 #endif // SHARE_GC_SHENANDOAH_SHENANDOAHSTRINGDEDUP_HPP
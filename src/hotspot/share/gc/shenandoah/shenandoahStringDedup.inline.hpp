@@ -41,6 +41,17 @@ bool ShenandoahStringDedup::dedup_requested(oop obj) {
   return java_lang_String::test_and_set_deduplication_requested(obj);
 }
 
+// Most Strings that marking visits were already requested in an earlier cycle, or were
+// interned and can never be deduplicated. Checking the flags with a plain load first keeps
+// marking from dirtying all of these Strings with an atomic update.
+bool ShenandoahStringDedup::try_request(oop obj) {
+  if (java_lang_String::deduplication_requested(obj) ||
+      java_lang_String::deduplication_forbidden(obj)) {
+    return false;
+  }
+  return !dedup_requested(obj);
+}
+
 bool ShenandoahStringDedup::is_candidate(oop obj) {
   if (!is_string_candidate(obj)) {
     return false;
@@ -49,7 +60,7 @@ bool ShenandoahStringDedup::is_candidate(oop obj) {
   uint age = ShenandoahHeap::get_object_age(obj);
   return (age <= markWord::max_age) &&
          StringDedup::is_below_threshold_age(age) &&
-         !dedup_requested(obj);
+         try_request(obj);
 }
 
 #endif // SHARE_GC_SHENANDOAH_SHENANDOAHSTRINGDEDUP_INLINE_HPP
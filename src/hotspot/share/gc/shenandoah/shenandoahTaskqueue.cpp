@@ -25,10 +25,205 @@
 #include "precompiled.hpp"
 
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahNUMA.hpp"
 #include "gc/shenandoah/shenandoahTaskqueue.inline.hpp"
 #include "logging/log.hpp"
 #include "logging/logStream.hpp"
 #include "memory/resourceArea.hpp"
+#include "runtime/os.hpp"
+
+ShenandoahTaskOverflowSpace* ShenandoahTaskOverflowSpace::_space = nullptr;
+
+ShenandoahTaskOverflowSpace::ShenandoahTaskOverflowSpace(char* base, size_t num_segments) :
+  _base(base),
+  _num_segments(num_segments),
+  _lock(),
+  _next_unused(0),
+  _free_list(nullptr),
+  _allocated(0) {
+}
+
+void ShenandoahTaskOverflowSpace::initialize(size_t reserve_bytes) {
+  assert(_space == nullptr, "Should be initialized once");
+  size_t granularity = MAX2(SegmentBytes, os::vm_allocation_granularity());
+  size_t bytes = align_up(reserve_bytes, granularity);
+  if (bytes == 0) {
+    return;
+  }
+  char* base = os::reserve_memory(bytes, !ExecMem, mtGC);
+  if (base == nullptr) {
+    log_info(gc, init)("Cannot reserve " SIZE_FORMAT "%s for marking overflow, overflow into C heap",
+                       byte_size_in_proper_unit(bytes), proper_unit_for_byte_size(bytes));
+    return;
+  }
+  _space = new ShenandoahTaskOverflowSpace(base, bytes / SegmentBytes);
+}
+
+ShenandoahOverflowSegment* ShenandoahTaskOverflowSpace::allocate_segment() {
+  ShenandoahLocker locker(&_lock);
+  ShenandoahOverflowSegment* seg = _free_list;
+  if (seg != nullptr) {
+    _free_list = seg->_next;
+  } else {
+    if (_next_unused == _num_segments) {
+      return nullptr;
+    }
+    char* addr = _base + _next_unused * SegmentBytes;
+    if (!os::commit_memory(addr, SegmentBytes, !ExecMem)) {
+      return nullptr;
+    }
+    _next_unused++;
+    seg = reinterpret_cast<ShenandoahOverflowSegment*>(addr);
+  }
+  _allocated++;
+  return seg;
+}
+
+void ShenandoahTaskOverflowSpace::free_segment(ShenandoahOverflowSegment* seg) {
+  assert((char*) seg >= _base && (char*) seg < _base + _next_unused * SegmentBytes, "Segment should be from this space");
+  ShenandoahLocker locker(&_lock);
+  seg->_next = _free_list;
+  _free_list = seg;
+  _allocated--;
+}
+
+void ShenandoahTaskOverflowSpace::release_memory() {
+  ShenandoahLocker locker(&_lock);
+  size_t released = 0;
+  for (ShenandoahOverflowSegment* seg = _free_list; seg != nullptr; seg = seg->_next) {
+    // The link lives in the first page, so only release the pages after it.
+    char* start = align_up((char*) (seg + 1), os::vm_page_size());
+    char* end = (char*) seg + SegmentBytes;
+    if (start < end && !os::free_memory_lazily(start, pointer_delta(end, start, 1))) {
+      os::free_memory(start, pointer_delta(end, start, 1), os::vm_page_size());
+    }
+    released++;
+  }
+  log_debug(gc, task)("Released " SIZE_FORMAT " free marking overflow segments, " SIZE_FORMAT " in use, " SIZE_FORMAT " committed",
+                      released, _allocated, _next_unused);
+}
+
+ShenandoahObjToScanQueueSet::ShenandoahObjToScanQueueSet(int n, uint num_assist) :
+  ParallelClaimableQueueSet<ShenandoahObjToScanQueue, mtGC>(n + (int)num_assist, (uint)n),
+  _queue_node(NEW_C_HEAP_ARRAY(uint, n + num_assist, mtGC)),
+  _steal_stats(NEW_C_HEAP_ARRAY(ShenandoahStealStats, n + num_assist, mtGC)),
+  _idle_workers(0),
+  _num_assist(num_assist),
+  _assist_in_use(0) {
+  assert(num_assist <= BitsPerByte * sizeof(uint64_t), "Assist queues should fit in the mask");
+  for (int i = 0; i < n + (int)num_assist; i++) {
+    _queue_node[i] = UnknownNode;
+    _steal_stats[i] = ShenandoahStealStats();
+  }
+}
+
+ShenandoahObjToScanQueueSet::~ShenandoahObjToScanQueueSet() {
+  FREE_C_HEAP_ARRAY(uint, _queue_node);
+  FREE_C_HEAP_ARRAY(ShenandoahStealStats, _steal_stats);
+}
+
+bool ShenandoahObjToScanQueueSet::steal_from(uint queue_num, uint victim, ShenandoahMarkTask& t) {
+  ShenandoahObjToScanQueue* const v = queue(victim);
+  if (v->pop_global(t) != ShenandoahObjToScanQueue::PopResult::Success) {
+    return false;
+  }
+  ShenandoahStealStats* const stats = &_steal_stats[queue_num];
+  stats->_steals++;
+
+  // Take more of the work while we are at it, so that we do not come back for every task.
+  ShenandoahObjToScanQueue* const local = queue(queue_num);
+  uint extra = MIN2(v->size() / 2, (uint) ShenandoahMarkStealBatch - 1);
+  ShenandoahMarkTask s;
+  for (uint i = 0; i < extra && v->pop_global(s) == ShenandoahObjToScanQueue::PopResult::Success; i++) {
+    local->push(s);
+    stats->_steals++;
+  }
+  local->set_last_stolen_queue_id(victim);
+  return true;
+}
+
+bool ShenandoahObjToScanQueueSet::steal(uint queue_num, ShenandoahMarkTask& t) {
+  ShenandoahStealStats* const stats = &_steal_stats[queue_num];
+  ShenandoahObjToScanQueue* const local = queue(queue_num);
+  const uint n = size();
+
+  ShenandoahNUMA* const numa = ShenandoahHeap::heap()->numa();
+  if (numa->is_enabled() && n > 2) {
+    const uint node = numa->node_index_of_current_thread();
+    Atomic::store(&_queue_node[queue_num], node);
+    const uint start = (uint) local->next_random_queue_id() % n;
+    for (uint i = 0; i < n; i++) {
+      uint k = (start + i) % n;
+      if (k == queue_num || Atomic::load(&_queue_node[k]) != node || queue(k)->size() == 0) {
+        continue;
+      }
+      stats->_attempts++;
+      if (steal_from(queue_num, k, t)) {
+        return true;
+      }
+    }
+  }
+
+  // Try the victim we last stole from first, it is likely to have more work.
+  if (n > 1 && local->is_last_stolen_queue_id_valid()) {
+    uint k = local->last_stolen_queue_id();
+    if (queue(k)->size() > 0) {
+      stats->_attempts++;
+      if (steal_from(queue_num, k, t)) {
+        return true;
+      }
+    }
+    local->invalidate_last_stolen_queue_id();
+  }
+
+  stats->_attempts++;
+  if (GenericTaskQueueSet<ShenandoahObjToScanQueue, mtGC>::steal(queue_num, t)) {
+    stats->_steals++;
+    return true;
+  }
+  return false;
+}
+
+uint ShenandoahObjToScanQueueSet::claim_assist_queue() {
+  uint64_t cur = Atomic::load(&_assist_in_use);
+  while (true) {
+    uint k = 0;
+    while (k < _num_assist && (cur & (uint64_t(1) << k)) != 0) {
+      k++;
+    }
+    if (k == _num_assist) {
+      return UINT_MAX;
+    }
+    uint64_t prev = Atomic::cmpxchg(&_assist_in_use, cur, cur | (uint64_t(1) << k));
+    if (prev == cur) {
+      uint queue_num = size() - _num_assist + k;
+      assert(queue(queue_num)->is_published(), "Only stealable tasks are left behind");
+      return queue_num;
+    }
+    cur = prev;
+  }
+}
+
+void ShenandoahObjToScanQueueSet::release_assist_queue(uint queue_num) {
+  assert(queue_num >= size() - _num_assist && queue_num < size(), "Not an assist queue: %u", queue_num);
+  assert(queue(queue_num)->is_published(), "Tasks left behind should be stealable");
+  const uint64_t bit = uint64_t(1) << (queue_num - (size() - _num_assist));
+  uint64_t cur = Atomic::load(&_assist_in_use);
+  while (true) {
+    assert((cur & bit) != 0, "Should be claimed");
+    uint64_t prev = Atomic::cmpxchg(&_assist_in_use, cur, cur & ~bit);
+    if (prev == cur) {
+      return;
+    }
+    cur = prev;
+  }
+}
+
+ShenandoahStealStats ShenandoahObjToScanQueueSet::flush_steal_stats(uint queue_num) {
+  ShenandoahStealStats stats = _steal_stats[queue_num];
+  _steal_stats[queue_num] = ShenandoahStealStats();
+  return stats;
+}
 
 void ShenandoahObjToScanQueueSet::clear() {
   uint size = GenericTaskQueueSet<ShenandoahObjToScanQueue, mtGC>::size();
@@ -39,6 +234,20 @@ void ShenandoahObjToScanQueueSet::clear() {
   }
 }
 
+void ShenandoahObjToScanQueueSet::release_overflow_segments() {
+  uint size = GenericTaskQueueSet<ShenandoahObjToScanQueue, mtGC>::size();
+  for (uint index = 0; index < size; index ++) {
+    ShenandoahObjToScanQueue* q = queue(index);
+    assert(q != nullptr, "Sanity");
+    if (q->is_empty()) {
+      q->release_overflow_segments();
+    }
+  }
+  if (ShenandoahTaskOverflowSpace::space() != nullptr) {
+    ShenandoahTaskOverflowSpace::space()->release_memory();
+  }
+}
+
 bool ShenandoahObjToScanQueueSet::is_empty() {
   uint size = GenericTaskQueueSet<ShenandoahObjToScanQueue, mtGC>::size();
   for (uint index = 0; index < size; index ++) {
@@ -27,6 +27,7 @@
 
 #include "gc/shared/taskTerminator.hpp"
 #include "gc/shared/taskqueue.hpp"
+#include "gc/shenandoah/shenandoahLock.hpp"
 #include "gc/shenandoah/shenandoahPadding.hpp"
 #include "memory/allocation.hpp"
 #include "runtime/atomic.hpp"
@@ -36,13 +37,66 @@
 
 class ShenandoahHeap;
 
+// A fixed-size segment of overflow tasks, handed out by ShenandoahTaskOverflowSpace.
+// The tasks follow the header.
+struct ShenandoahOverflowSegment {
+  ShenandoahOverflowSegment* _next;
+};
+
+// Task queues overflow into segments carved from one reserved virtual range, instead of
+// into C-heap stacks. Segments are committed when they are first handed out, and are then
+// reused by later marking cycles. Once marking is done, free segments are handed back
+// to the OS with a lazy madvise, so that overflow peaks do not persist in RSS while the
+// address range stays reserved. When the range is exhausted, queues fall back to
+// overflowing into the C heap.
+class ShenandoahTaskOverflowSpace : public CHeapObj<mtGC> {
+public:
+  static const size_t SegmentBytes = 64 * K;
+
+private:
+  static ShenandoahTaskOverflowSpace* _space;
+
+  char* const  _base;
+  const size_t _num_segments;
+
+  ShenandoahLock             _lock;
+  size_t                     _next_unused;
+  ShenandoahOverflowSegment* _free_list;
+  size_t                     _allocated;
+
+  ShenandoahTaskOverflowSpace(char* base, size_t num_segments);
+
+public:
+  // Reserves reserve_bytes of address space for overflow segments, if non-zero.
+  static void initialize(size_t reserve_bytes);
+  static ShenandoahTaskOverflowSpace* space() { return _space; }
+
+  template <class E>
+  static size_t segment_capacity() {
+    return (SegmentBytes - sizeof(ShenandoahOverflowSegment)) / sizeof(E);
+  }
+
+  template <class E>
+  static E* segment_tasks(ShenandoahOverflowSegment* seg) {
+    return reinterpret_cast<E*>(seg + 1);
+  }
+
+  // Returns nullptr if the reserved range is exhausted, or its memory cannot be committed.
+  ShenandoahOverflowSegment* allocate_segment();
+  void free_segment(ShenandoahOverflowSegment* seg);
+
+  // Let the OS reclaim the memory of free segments. They remain reusable.
+  void release_memory();
+};
+
 template<class E, MEMFLAGS F, unsigned int N = TASKQUEUE_SIZE>
 class BufferedOverflowTaskQueue: public OverflowTaskQueue<E, F, N>
 {
 public:
   typedef OverflowTaskQueue<E, F, N> taskqueue_t;
 
-  BufferedOverflowTaskQueue() : _buf_empty(true) {};
+  BufferedOverflowTaskQueue() : _buf_empty(true), _segment(nullptr), _segment_len(0) {};
+  ~BufferedOverflowTaskQueue();
 
   TASKQUEUE_STATS_ONLY(using taskqueue_t::stats;)
 
@@ -54,13 +108,32 @@ public:
 
   inline void clear();
 
+  // Return the empty overflow segment that is kept cached, if any.
+  inline void release_overflow_segments();
+
   inline bool is_empty()        const {
-    return _buf_empty && taskqueue_t::is_empty();
+    return _buf_empty && taskqueue_t::is_empty() && _segment_len == 0;
+  }
+
+  // Whether all tasks in the queue can be stolen.
+  inline bool is_published()    const {
+    return _buf_empty && _segment_len == 0 && taskqueue_t::overflow_empty();
   }
 
+  // Move the buffered task to where thieves can take it. Returns is_published().
+  inline bool publish();
+
 private:
   bool _buf_empty;
   E _elem;
+
+  // Overflow segments form a stack of full segments under a partially filled top segment.
+  // An empty top segment is kept cached until release_overflow_segments().
+  ShenandoahOverflowSegment* _segment;
+  size_t _segment_len;
+
+  inline void push_overflow(E t);
+  inline bool pop_overflow_segment(E& t);
 };
 
 // ShenandoahMarkTask
@@ -308,13 +381,18 @@ private:
   volatile jint     _claimed_index;
   shenandoah_padding(1);
 
+  // Queues past the claimable ones are never claimed, only stolen from
+  const uint        _num_claimable;
+
   debug_only(uint   _reserved;  )
 
 public:
   using GenericTaskQueueSet<T, F>::size;
 
 public:
-  ParallelClaimableQueueSet(int n) : GenericTaskQueueSet<T, F>(n), _claimed_index(0) {
+  ParallelClaimableQueueSet(int n, uint num_claimable) :
+    GenericTaskQueueSet<T, F>(n), _claimed_index(0), _num_claimable(num_claimable) {
+    assert(num_claimable <= (uint)n, "Sanity");
     debug_only(_reserved = 0; )
   }
 
@@ -323,7 +401,7 @@ public:
 
   // reserve queues that not for parallel claiming
   void reserve(uint n) {
-    assert(n <= size(), "Sanity");
+    assert(n <= _num_claimable, "Sanity");
     _claimed_index = (jint)n;
     debug_only(_reserved = n;)
   }
@@ -333,7 +411,7 @@ public:
 
 template <class T, MEMFLAGS F>
 T* ParallelClaimableQueueSet<T, F>::claim_next() {
-  jint size = (jint)GenericTaskQueueSet<T, F>::size();
+  jint size = (jint)_num_claimable;
 
   if (_claimed_index >= size) {
     return nullptr;
@@ -348,12 +426,66 @@ T* ParallelClaimableQueueSet<T, F>::claim_next() {
   }
 }
 
+// Work stealing counters of one worker during marking.
+struct ShenandoahStealStats {
+  size_t _steals;    // Tasks stolen, including those stolen in batches
+  size_t _attempts;  // Attempts to steal from some victim
+  size_t _idle;      // Strides that found no work and offered termination
+
+  ShenandoahStealStats() : _steals(0), _attempts(0), _idle(0) {}
+};
+
 class ShenandoahObjToScanQueueSet: public ParallelClaimableQueueSet<ShenandoahObjToScanQueue, mtGC> {
+private:
+  static const uint UnknownNode = UINT_MAX;
+
+  // NUMA node on which the owner of each queue was last seen stealing.
+  volatile uint* _queue_node;
+
+  // Owned and updated by the worker of each queue, without synchronization.
+  ShenandoahStealStats* _steal_stats;
+
+  shenandoah_padding(0);
+  volatile uint _idle_workers;
+  shenandoah_padding(1);
+
+  // The last queues of the set are lent to allocating threads that assist marking, one
+  // thread at a time. Each bit tells whether the matching assist queue is lent out.
+  const uint        _num_assist;
+  volatile uint64_t _assist_in_use;
+
+  // Steal one task from victim, and up to half of the remaining ones, bounded by
+  // ShenandoahMarkStealBatch, into the queue of the thief.
+  bool steal_from(uint queue_num, uint victim, ShenandoahMarkTask& t);
+
 public:
-  ShenandoahObjToScanQueueSet(int n) : ParallelClaimableQueueSet<ShenandoahObjToScanQueue, mtGC>(n) {}
+  ShenandoahObjToScanQueueSet(int n, uint num_assist = 0);
+  ~ShenandoahObjToScanQueueSet();
 
   bool is_empty();
   void clear();
+  void release_overflow_segments();
+
+  // Steal a task for the worker that owns queue_num. When NUMA affinity is enabled, queues
+  // of workers on the same node are tried first. Then falls back to the random best-of-2
+  // stealing of GenericTaskQueueSet.
+  bool steal(uint queue_num, ShenandoahMarkTask& t);
+
+  void record_idle(uint queue_num) { _steal_stats[queue_num]._idle++; }
+
+  // Number of workers currently out of work, offering termination.
+  uint idle_workers() const { return Atomic::load(&_idle_workers); }
+  void enter_idle()         { Atomic::inc(&_idle_workers); }
+  void exit_idle()          { Atomic::dec(&_idle_workers); }
+
+  // Returns and resets the stealing counters of queue_num.
+  ShenandoahStealStats flush_steal_stats(uint queue_num);
+
+  // Returns the index of an assist queue that the current thread owns until it releases
+  // it, or UINT_MAX if there are none left. The queue must only contain tasks that can
+  // be stolen when it is released.
+  uint claim_assist_queue();
+  void release_assist_queue(uint queue_num);
 
 #if TASKQUEUE_STATS
   static void print_taskqueue_stats_hdr(outputStream* const st);
@@ -42,6 +42,10 @@ bool BufferedOverflowTaskQueue<E, F, N>::pop(E &t) {
     return true;
   }
 
+  if (pop_overflow_segment(t)) {
+    return true;
+  }
+
   return taskqueue_t::pop_overflow(t);
 }
 
@@ -51,18 +55,78 @@ inline bool BufferedOverflowTaskQueue<E, F, N>::push(E t) {
     _elem = t;
     _buf_empty = false;
   } else {
-    bool pushed = taskqueue_t::push(_elem);
-    assert(pushed, "overflow queue should always succeed pushing");
+    if (!taskqueue_t::try_push_to_taskqueue(_elem)) {
+      push_overflow(_elem);
+    }
     _elem = t;
   }
   return true;
 }
 
+template <class E, MEMFLAGS F, unsigned int N>
+inline bool BufferedOverflowTaskQueue<E, F, N>::publish() {
+  if (!_buf_empty && taskqueue_t::try_push_to_taskqueue(_elem)) {
+    _buf_empty = true;
+  }
+  return is_published();
+}
+
+template <class E, MEMFLAGS F, unsigned int N>
+inline void BufferedOverflowTaskQueue<E, F, N>::push_overflow(E t) {
+  const size_t capacity = ShenandoahTaskOverflowSpace::segment_capacity<E>();
+  if (_segment == nullptr || _segment_len == capacity) {
+    ShenandoahTaskOverflowSpace* space = ShenandoahTaskOverflowSpace::space();
+    ShenandoahOverflowSegment* seg = (space != nullptr) ? space->allocate_segment() : nullptr;
+    if (seg == nullptr) {
+      bool pushed = taskqueue_t::push(t);
+      assert(pushed, "overflow queue should always succeed pushing");
+      return;
+    }
+    seg->_next = _segment;
+    _segment = seg;
+    _segment_len = 0;
+  }
+  ShenandoahTaskOverflowSpace::segment_tasks<E>(_segment)[_segment_len++] = t;
+  TASKQUEUE_STATS_ONLY(stats.record_overflow(_segment_len));
+}
+
+template <class E, MEMFLAGS F, unsigned int N>
+inline bool BufferedOverflowTaskQueue<E, F, N>::pop_overflow_segment(E& t) {
+  if (_segment_len == 0) {
+    return false;
+  }
+  t = ShenandoahTaskOverflowSpace::segment_tasks<E>(_segment)[--_segment_len];
+  if (_segment_len == 0 && _segment->_next != nullptr) {
+    // Segments below the top are full. Keep the last one cached to avoid churn at its boundary.
+    ShenandoahOverflowSegment* next = _segment->_next;
+    ShenandoahTaskOverflowSpace::space()->free_segment(_segment);
+    _segment = next;
+    _segment_len = ShenandoahTaskOverflowSpace::segment_capacity<E>();
+  }
+  return true;
+}
+
+template <class E, MEMFLAGS F, unsigned int N>
+inline void BufferedOverflowTaskQueue<E, F, N>::release_overflow_segments() {
+  while (_segment != nullptr) {
+    ShenandoahOverflowSegment* next = _segment->_next;
+    ShenandoahTaskOverflowSpace::space()->free_segment(_segment);
+    _segment = next;
+  }
+  _segment_len = 0;
+}
+
+template <class E, MEMFLAGS F, unsigned int N>
+BufferedOverflowTaskQueue<E, F, N>::~BufferedOverflowTaskQueue() {
+  release_overflow_segments();
+}
+
 template <class E, MEMFLAGS F, unsigned int N>
 void BufferedOverflowTaskQueue<E, F, N>::clear() {
     _buf_empty = true;
     taskqueue_t::set_empty();
     taskqueue_t::overflow_stack()->clear();
+    release_overflow_segments();
 }
 
 
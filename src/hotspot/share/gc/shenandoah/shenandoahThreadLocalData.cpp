@@ -30,24 +30,41 @@
 #include "gc/shenandoah/shenandoahGenerationalHeap.hpp"
 #include "gc/shenandoah/shenandoahHeap.inline.hpp"
 #include "gc/shenandoah/shenandoahThreadLocalData.hpp"
+#include "runtime/atomic.hpp"
+
+volatile uint ShenandoahThreadLocalData::_alloc_shard_counter = 0;
 
 ShenandoahThreadLocalData::ShenandoahThreadLocalData() :
   _gc_state(0),
   _oom_scope_nesting_level(0),
   _oom_during_evac(false),
   _satb_mark_queue(&ShenandoahBarrierSet::satb_mark_queue_set()),
+  _card_table(nullptr),
   _gclab(nullptr),
   _gclab_size(0),
   _paced_time(0),
+  _pacing_tokens(0),
+  _pacing_epoch(0),
+  _pacing_weight(1.0),
   _plab(nullptr),
   _plab_desired_size(0),
   _plab_actual_size(0),
   _plab_promoted(0),
   _plab_allows_promotion(true),
   _plab_retries_enabled(true),
-  _evacuation_stats(nullptr) {
+  _plab_allocated(0),
+  _plab_wasted(0),
+  _plab_used_history(PLABWeight),
+  _evacuation_stats(nullptr),
+  _evacuation_klasses(nullptr),
+  _alloc_shard_hint(Atomic::fetch_then_add(&_alloc_shard_counter, 1u)),
+  _zeroed_allocation(nullptr),
+  _access_sample_countdown((uint)MIN2(ShenandoahRegionAccessSampleRate, (uintx)max_juint)) {
   bool gen_mode = ShenandoahHeap::heap()->mode()->is_generational();
   _evacuation_stats = new ShenandoahEvacuationStats(gen_mode);
+  if (gen_mode && ShenandoahEvacuationKlassSampleRate > 0) {
+    _evacuation_klasses = new ShenandoahEvacuationKlassTable();
+  }
 }
 
 ShenandoahThreadLocalData::~ShenandoahThreadLocalData() {
@@ -61,4 +78,5 @@ ShenandoahThreadLocalData::~ShenandoahThreadLocalData() {
 
   // TODO: Preserve these stats somewhere for mutator threads.
   delete _evacuation_stats;
+  delete _evacuation_klasses;
 }
@@ -29,6 +29,7 @@
 #include "gc/shared/plab.hpp"
 #include "gc/shared/gcThreadLocalData.hpp"
 #include "gc/shared/gc_globals.hpp"
+#include "gc/shared/gcUtil.hpp"
 #include "gc/shenandoah/shenandoahBarrierSet.hpp"
 #include "gc/shenandoah/shenandoahCodeRoots.hpp"
 #include "gc/shenandoah/shenandoahGenerationalHeap.hpp"
@@ -48,6 +49,10 @@ private:
 
   SATBMarkQueue           _satb_mark_queue;
 
+  // Current biased base of the write card table. Card-marking barriers load it from here, which lets
+  // the collector exchange the read and write card tables at a safepoint.
+  CardTable::CardValue*   _card_table;
+
   // Thread-local allocation buffer for object evacuations.
   // In generational mode, it is exclusive to the young generation.
   PLAB* _gclab;
@@ -55,6 +60,13 @@ private:
 
   double _paced_time;
 
+  // Pacing tokens this thread claimed from the pacer, and the pacing epoch they belong to.
+  intptr_t _pacing_tokens;
+  intptr_t _pacing_epoch;
+
+  // Pacing weight from ShenandoahPacingThreadWeights, looked up again every pacing epoch.
+  double _pacing_weight;
+
   // Thread-local allocation buffer only used in generational mode.
   // Used both by mutator threads and by GC worker threads
   // for evacuations within the old generation and
@@ -78,8 +90,31 @@ private:
   // If true, evacuations may attempt to allocate a smaller plab if the original size fails.
   bool   _plab_retries_enabled;
 
+  // Words of plab handed to this thread, and words of them left unused when the plabs were
+  // retired, since the plab size was last adjusted.
+  size_t _plab_allocated;
+  size_t _plab_wasted;
+
+  // Smoothed number of plab words used by this thread per cycle. Sizes the first plab of a cycle.
+  AdaptiveWeightedAverage _plab_used_history;
+
   ShenandoahEvacuationStats* _evacuation_stats;
 
+  // Sampled evacuations by class, or null unless ShenandoahEvacuationKlassSampleRate is set
+  ShenandoahEvacuationKlassTable* _evacuation_klasses;
+
+  // Assigned round-robin at thread creation; selects the free set allocation shard used by this thread
+  // when NUMA affinity does not determine one.
+  uint _alloc_shard_hint;
+
+  static volatile uint _alloc_shard_counter;
+
+  // The most recent shared allocation made by this thread, if its memory was known to be zeroed.
+  HeapWord* _zeroed_allocation;
+
+  // Load reference barrier slow paths left until the next sample with ShenandoahRegionAccessSampleRate.
+  uint _access_sample_countdown;
+
   ShenandoahThreadLocalData();
   ~ShenandoahThreadLocalData();
 
@@ -114,6 +149,17 @@ public:
     return data(thread)->_gc_state;
   }
 
+  static void set_card_table(Thread* thread, CardTable::CardValue* ct) {
+    assert(ct != nullptr, "Trying to set thread-local card table base to null");
+    data(thread)->_card_table = ct;
+  }
+
+  static CardTable::CardValue* card_table(Thread* thread) {
+    CardTable::CardValue* ct = data(thread)->_card_table;
+    assert(ct != nullptr, "Thread-local card table base should be set");
+    return ct;
+  }
+
   static void initialize_gclab(Thread* thread) {
     assert (thread->is_Java_thread() || thread->is_Worker_thread(), "Only Java and GC worker threads are allowed to get GCLABs");
     assert(data(thread)->_gclab == nullptr, "Only initialize once");
@@ -126,6 +172,10 @@ public:
     }
   }
 
+  static uint alloc_shard_hint(Thread* thread) {
+    return data(thread)->_alloc_shard_hint;
+  }
+
   static PLAB* gclab(Thread* thread) {
     return data(thread)->_gclab;
   }
@@ -150,10 +200,40 @@ public:
     data(thread)->_evacuation_stats->record_age(bytes, age);
   }
 
+  static void record_plab_refill(Thread* thread) {
+    data(thread)->_evacuation_stats->record_plab_refill();
+  }
+
+  static void record_plab_waste(Thread* thread, size_t bytes) {
+    data(thread)->_evacuation_stats->record_plab_waste(bytes);
+  }
+
   static ShenandoahEvacuationStats* evacuation_stats(Thread* thread) {
     return data(thread)->_evacuation_stats;
   }
 
+  static ShenandoahEvacuationKlassTable* evacuation_klasses(Thread* thread) {
+    return data(thread)->_evacuation_klasses;
+  }
+
+  static HeapWord* zeroed_allocation(Thread* thread) {
+    return data(thread)->_zeroed_allocation;
+  }
+
+  static void set_zeroed_allocation(Thread* thread, HeapWord* mem) {
+    data(thread)->_zeroed_allocation = mem;
+  }
+
+  static bool should_sample_access(Thread* thread) {
+    ShenandoahThreadLocalData* const d = data(thread);
+    if (d->_access_sample_countdown > 1) {
+      d->_access_sample_countdown--;
+      return false;
+    }
+    d->_access_sample_countdown = (uint)MIN2(ShenandoahRegionAccessSampleRate, (uintx)max_juint);
+    return true;
+  }
+
   static PLAB* plab(Thread* thread) {
     return data(thread)->_plab;
   }
@@ -215,6 +295,27 @@ public:
     return data(thread)->_plab_actual_size;
   }
 
+  static void add_to_plab_allocated(Thread* thread, size_t words) {
+    data(thread)->_plab_allocated += words;
+  }
+
+  static void add_to_plab_wasted(Thread* thread, size_t words) {
+    data(thread)->_plab_wasted += words;
+  }
+
+  // Returns the plab words used since the last call, and starts counting afresh.
+  static size_t take_plab_used(Thread* thread) {
+    ShenandoahThreadLocalData* const d = data(thread);
+    size_t used = (d->_plab_allocated > d->_plab_wasted) ? d->_plab_allocated - d->_plab_wasted : 0;
+    d->_plab_allocated = 0;
+    d->_plab_wasted = 0;
+    return used;
+  }
+
+  static AdaptiveWeightedAverage* plab_used_history(Thread* thread) {
+    return &data(thread)->_plab_used_history;
+  }
+
   static void add_paced_time(Thread* thread, double v) {
     data(thread)->_paced_time += v;
   }
@@ -227,6 +328,27 @@ public:
     data(thread)->_paced_time = 0;
   }
 
+  static intptr_t pacing_tokens(Thread* thread) {
+    return data(thread)->_pacing_tokens;
+  }
+
+  static intptr_t pacing_epoch(Thread* thread) {
+    return data(thread)->_pacing_epoch;
+  }
+
+  static void set_pacing_tokens(Thread* thread, intptr_t epoch, intptr_t tokens) {
+    data(thread)->_pacing_epoch = epoch;
+    data(thread)->_pacing_tokens = tokens;
+  }
+
+  static double pacing_weight(Thread* thread) {
+    return data(thread)->_pacing_weight;
+  }
+
+  static void set_pacing_weight(Thread* thread, double weight) {
+    data(thread)->_pacing_weight = weight;
+  }
+
   // Evacuation OOM handling
   static bool is_oom_during_evac(Thread* thread) {
     return data(thread)->_oom_during_evac;
@@ -276,6 +398,10 @@ public:
   static ByteSize gc_state_offset() {
     return Thread::gc_data_offset() + byte_offset_of(ShenandoahThreadLocalData, _gc_state);
   }
+
+  static ByteSize card_table_offset() {
+    return Thread::gc_data_offset() + byte_offset_of(ShenandoahThreadLocalData, _card_table);
+  }
 };
 
 STATIC_ASSERT(sizeof(ShenandoahThreadLocalData) <= sizeof(GCThreadLocalData));
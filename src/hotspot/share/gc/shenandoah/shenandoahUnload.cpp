@@ -118,7 +118,8 @@ public:
   }
 };
 
-ShenandoahUnload::ShenandoahUnload() {
+ShenandoahUnload::ShenandoahUnload() :
+  _deferred_purge(nullptr) {
   if (ClassUnloading) {
     static ShenandoahIsUnloadingBehaviour is_unloading_behaviour;
     IsUnloadingBehaviour::set_current(&is_unloading_behaviour);
@@ -131,6 +132,7 @@ ShenandoahUnload::ShenandoahUnload() {
 void ShenandoahUnload::prepare() {
   assert(SafepointSynchronize::is_at_safepoint(), "Should be at safepoint");
   assert(ClassUnloading, "Sanity");
+  purge_deferred(true /* at_safepoint */);
   CodeCache::increment_unloading_cycle();
   DependencyContext::cleaning_start();
 }
@@ -140,9 +142,11 @@ void ShenandoahUnload::unload() {
   assert(ClassUnloading, "Filtered by caller");
   assert(heap->is_concurrent_weak_root_in_progress(), "Filtered by caller");
 
-  ClassUnloadingContext ctx(heap->workers()->active_workers(),
-                            true /* unregister_nmethods_during_purge */,
-                            true /* lock_codeblob_free_separately */);
+  assert(!has_deferred_purge(), "Previous purge should have completed in prepare()");
+
+  ClassUnloadingContext* ctx = new ClassUnloadingContext(heap->workers()->active_workers(),
+                                                         true /* unregister_nmethods_during_purge */,
+                                                         true /* lock_codeblob_free_separately */);
 
   // Unlink stale metadata and nmethods
   {
@@ -185,19 +189,44 @@ void ShenandoahUnload::unload() {
       ShenandoahCodeRoots::purge();
     }
 
-    {
-      ShenandoahTimingsTracker t(ShenandoahPhaseTimings::conc_class_unload_purge_cldg);
-      ClassLoaderDataGraph::purge(false /* at_safepoint */);
-    }
-
     {
       ShenandoahTimingsTracker t(ShenandoahPhaseTimings::conc_class_unload_purge_ec);
       CodeCache::purge_exception_caches();
     }
+
+    // Unlinked class loader data is no longer reachable, and freeing it does not give back any
+    // heap memory. With many unloaded classes this is the longest part of unloading, so it can
+    // wait until the cycle has reclaimed the collection set.
+    _deferred_purge = ctx;
+    if (!ShenandoahDeferClassUnloadingPurge) {
+      ShenandoahTimingsTracker t(ShenandoahPhaseTimings::conc_class_unload_purge_cldg);
+      purge_class_loader_data(false /* at_safepoint */);
+    }
   }
 }
 
+void ShenandoahUnload::purge_class_loader_data(bool at_safepoint) {
+  assert(has_deferred_purge(), "Should have unlinked class loader data");
+  WorkerThreads* workers = ShenandoahParallelClassLoaderDataPurge ? ShenandoahHeap::heap()->workers() : nullptr;
+  ClassLoaderDataGraph::purge(at_safepoint, workers);
+  delete _deferred_purge;
+  _deferred_purge = nullptr;
+}
+
+void ShenandoahUnload::purge_deferred(bool at_safepoint) {
+  if (!has_deferred_purge()) {
+    return;
+  }
+  purge_class_loader_data(at_safepoint);
+  MetaspaceGC::compute_new_size();
+  DEBUG_ONLY(MetaspaceUtils::verify();)
+}
+
 void ShenandoahUnload::finish() {
+  if (has_deferred_purge()) {
+    // Metaspace is resized after the deferred purge.
+    return;
+  }
   MetaspaceGC::compute_new_size();
   DEBUG_ONLY(MetaspaceUtils::verify();)
 }
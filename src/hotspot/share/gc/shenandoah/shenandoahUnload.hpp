@@ -27,14 +27,29 @@
 
 #include "memory/allocation.hpp"
 
+class ClassUnloadingContext;
 class ShenandoahHeap;
 
 class ShenandoahUnload {
+private:
+  // Context of the last concurrent unloading whose class loader data has been unlinked,
+  // but not purged yet. See ShenandoahDeferClassUnloadingPurge.
+  ClassUnloadingContext* _deferred_purge;
+
+  void purge_class_loader_data(bool at_safepoint);
+
 public:
   ShenandoahUnload();
   void prepare();
   void unload();
   void finish();
+
+  bool has_deferred_purge() const { return _deferred_purge != nullptr; }
+
+  // Free the metadata of class loaders unlinked by a previous unload(). Called by the control
+  // thread once the cycle has reclaimed memory, and by any unloading that would otherwise need a
+  // second ClassUnloadingContext.
+  void purge_deferred(bool at_safepoint);
 };
 
 #endif // SHARE_GC_SHENANDOAH_SHENANDOAHCLASSUNLOAD_HPP
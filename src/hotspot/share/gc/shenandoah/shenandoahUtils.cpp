@@ -37,6 +37,7 @@
 #include "gc/shenandoah/shenandoahReferenceProcessor.hpp"
 #include "gc/shenandoah/shenandoahUtils.hpp"
 #include "gc/shenandoah/shenandoahYoungGeneration.hpp"
+#include "runtime/handshake.hpp"
 #include "utilities/debug.hpp"
 
 ShenandoahPhaseTimings::Phase ShenandoahTimingsTracker::_current_phase = ShenandoahPhaseTimings::_invalid_phase;
@@ -150,6 +151,27 @@ ShenandoahGCWorkerPhase::~ShenandoahGCWorkerPhase() {
   _timings->record_workers_end(_phase);
 }
 
+class ShenandoahSharedClosureBatcher : public HandshakeBatcher {
+private:
+  HandshakeClosure* const _cl;
+
+public:
+  ShenandoahSharedClosureBatcher(HandshakeClosure* cl) : HandshakeBatcher(cl->name()), _cl(cl) {}
+
+  virtual HandshakeClosure* closure_for_batch(int batch) {
+    return _cl;
+  }
+};
+
+void ShenandoahHandshake::execute(HandshakeClosure* cl) {
+  if (ShenandoahHandshakeBatchSize == 0) {
+    Handshake::execute(cl);
+  } else {
+    ShenandoahSharedClosureBatcher batcher(cl);
+    Handshake::execute(&batcher, (int) ShenandoahHandshakeBatchSize);
+  }
+}
+
 ShenandoahWorkerSession::ShenandoahWorkerSession(uint worker_id) {
   assert(worker_id == WorkerThread::worker_id(), "Wrong worker id");
 }
@@ -42,6 +42,7 @@
 #include "services/memoryService.hpp"
 
 class GCTimer;
+class HandshakeClosure;
 class ShenandoahGeneration;
 
 #define SHENANDOAH_RETURN_EVENT_MESSAGE(generation_type, prefix, postfix) \
@@ -190,6 +191,13 @@ public:
   }
 };
 
+class ShenandoahHandshake : public AllStatic {
+public:
+  // Handshakes all threads with the closure, one operation per ShenandoahHandshakeBatchSize
+  // threads, so that the VM thread stops polling threads of batches that are done.
+  static void execute(HandshakeClosure* cl);
+};
+
 class ShenandoahWorkerSession : public StackObj {
 protected:
   ShenandoahWorkerSession(uint worker_id);
@@ -44,6 +44,7 @@
 #include "oops/compressedOops.inline.hpp"
 #include "runtime/atomic.hpp"
 #include "runtime/orderAccess.hpp"
+#include "runtime/os.hpp"
 #include "runtime/threads.hpp"
 #include "utilities/align.hpp"
 
@@ -292,11 +293,11 @@ private:
         // skip
         break;
       case ShenandoahVerifier::_verify_cset_none:
-        check(ShenandoahAsserts::_safe_all, obj, !_heap->in_collection_set(obj),
+        check(ShenandoahAsserts::_safe_all, obj, !_heap->in_collection_set(obj) || _heap->is_pinned_in_place(obj),
                "Should not have references to collection set");
         break;
       case ShenandoahVerifier::_verify_cset_forwarded:
-        if (_heap->in_collection_set(obj)) {
+        if (_heap->in_collection_set(obj) && !_heap->is_pinned_in_place(obj)) {
           check(ShenandoahAsserts::_safe_all, obj, (obj != fwd),
                  "Object in collection set, should have forwardee");
         }
@@ -618,12 +619,15 @@ private:
   volatile size_t _claimed;
   volatile size_t _processed;
   ShenandoahGeneration* _generation;
+  // Regions to walk, or null to walk all of them
+  const bool* _sampled;
 
 public:
   ShenandoahVerifierMarkedRegionTask(MarkBitMap* bitmap,
                                      ShenandoahLivenessData* ld,
                                      const char* label,
-                                     ShenandoahVerifier::VerifyOptions options) :
+                                     ShenandoahVerifier::VerifyOptions options,
+                                     const bool* sampled = nullptr) :
           WorkerTask("Shenandoah Verifier Marked Objects"),
           _label(label),
           _options(options),
@@ -632,7 +636,8 @@ public:
           _ld(ld),
           _claimed(0),
           _processed(0),
-          _generation(nullptr) {
+          _generation(nullptr),
+          _sampled(sampled) {
     if (_options._verify_marked == ShenandoahVerifier::_verify_marked_complete_satb_empty) {
       Threads::change_thread_claim_token();
     }
@@ -662,7 +667,7 @@ public:
       size_t v = Atomic::fetch_then_add(&_claimed, 1u, memory_order_relaxed);
       if (v < _heap->num_regions()) {
         ShenandoahHeapRegion* r = _heap->get_region(v);
-        if (!in_generation(r)) {
+        if (!in_generation(r) || !is_sampled(r)) {
           continue;
         }
 
@@ -681,6 +686,10 @@ public:
     return _generation == nullptr || _generation->contains(r);
   }
 
+  bool is_sampled(ShenandoahHeapRegion* r) {
+    return _sampled == nullptr || _sampled[r->index()];
+  }
+
   virtual void work_humongous(ShenandoahHeapRegion *r, ShenandoahVerifierStack& stack, ShenandoahVerifyOopClosure& cl) {
     size_t processed = 0;
     HeapWord* obj = r->bottom();
@@ -738,8 +747,12 @@ public:
     }
     while (!stack.is_empty()) {
       ShenandoahVerifierTask task = stack.pop();
-      cl.verify_oops_from(task.obj());
-      (*processed)++;
+      // The referents have been verified when they were pushed. When sampling, only
+      // follow those in sampled regions, so that the walk stays within the sample.
+      if (_sampled == nullptr || is_sampled(_heap->heap_region_containing(task.obj()))) {
+        cl.verify_oops_from(task.obj());
+        (*processed)++;
+      }
     }
   }
 };
@@ -956,10 +969,29 @@ void ShenandoahVerifier::verify_at_safepoint(const char* label,
 
   const VerifyOptions& options = ShenandoahVerifier::VerifyOptions(forwarded, marked, cset, liveness, regions, gcstate);
 
+  // When sampling, pick the regions to walk. Selection sampling picks exactly the requested
+  // number of distinct regions, each with the same probability.
+  bool* sampled = nullptr;
+  size_t num_sampled = _heap->num_regions();
+  if (ShenandoahVerifySampledRegions > 0 && ShenandoahVerifySampledRegions < _heap->num_regions()) {
+    sampled = NEW_C_HEAP_ARRAY(bool, _heap->num_regions(), mtGC);
+    num_sampled = ShenandoahVerifySampledRegions;
+    size_t needed = num_sampled;
+    for (size_t i = 0; i < _heap->num_regions(); i++) {
+      size_t left = _heap->num_regions() - i;
+      sampled[i] = ((size_t)os::random() % left) < needed;
+      if (sampled[i]) {
+        needed--;
+      }
+    }
+    assert(needed == 0, "Should have sampled all requested regions");
+  }
+
   // Steps 1-2. Scan root set to get initial reachable set. Finish walking the reachable heap.
   // This verifies what application can see, since it only cares about reachable objects.
+  // The reachable heap is not confined to any set of regions, so sampling skips this walk.
   size_t count_reachable = 0;
-  if (ShenandoahVerifyLevel >= 2) {
+  if (ShenandoahVerifyLevel >= 2 && sampled == nullptr) {
     ShenandoahVerifierReachableTask task(_verification_bit_map, ld, label, options);
     _heap->workers()->run_task(&task);
     count_reachable = task.processed();
@@ -980,7 +1012,7 @@ void ShenandoahVerifier::verify_at_safepoint(const char* label,
          marked == _verify_marked_complete_except_references ||
          marked == _verify_marked_complete_satb_empty)) {
     guarantee(_heap->marking_context()->is_complete(), "Marking context should be complete");
-    ShenandoahVerifierMarkedRegionTask task(_verification_bit_map, ld, label, options);
+    ShenandoahVerifierMarkedRegionTask task(_verification_bit_map, ld, label, options, sampled);
     _heap->workers()->run_task(&task);
     count_marked = task.processed();
   } else {
@@ -990,9 +1022,10 @@ void ShenandoahVerifier::verify_at_safepoint(const char* label,
   log_debug(gc)("Safepoint verification finished walking marked objects");
 
   // Step 4. Verify accumulated liveness data, if needed. Only reliable if verification level includes
-  // marked objects.
+  // marked objects, and all regions were walked.
 
-  if (ShenandoahVerifyLevel >= 4 && marked == _verify_marked_complete && liveness == _verify_liveness_complete) {
+  if (ShenandoahVerifyLevel >= 4 && marked == _verify_marked_complete && liveness == _verify_liveness_complete &&
+      sampled == nullptr) {
     for (size_t i = 0; i < _heap->num_regions(); i++) {
       ShenandoahHeapRegion* r = _heap->get_region(i);
       if (generation != nullptr && !generation->contains(r)) {
@@ -1024,10 +1057,14 @@ void ShenandoahVerifier::verify_at_safepoint(const char* label,
   log_debug(gc)("Safepoint verification finished accumulation of liveness data");
 
 
-  log_info(gc)("Verify %s, Level " INTX_FORMAT " (" SIZE_FORMAT " reachable, " SIZE_FORMAT " marked)",
-               label, ShenandoahVerifyLevel, count_reachable, count_marked);
+  log_info(gc)("Verify %s, Level " INTX_FORMAT " (" SIZE_FORMAT " reachable, " SIZE_FORMAT " marked, "
+               SIZE_FORMAT " of " SIZE_FORMAT " regions walked)",
+               label, ShenandoahVerifyLevel, count_reachable, count_marked, num_sampled, _heap->num_regions());
 
   FREE_C_HEAP_ARRAY(ShenandoahLivenessData, ld);
+  if (sampled != nullptr) {
+    FREE_C_HEAP_ARRAY(bool, sampled);
+  }
 }
 
 void ShenandoahVerifier::verify_generic(VerifyOption vo) {
@@ -1224,7 +1261,7 @@ private:
                 "Verify Roots In To-Space", "Should be marked", __FILE__, __LINE__);
       }
 
-      if (heap->in_collection_set(obj)) {
+      if (heap->in_collection_set(obj) && !heap->is_pinned_in_place(obj)) {
         ShenandoahAsserts::print_failure(ShenandoahAsserts::_safe_all, obj, p, nullptr,
                 "Verify Roots In To-Space", "Should not be in collection set", __FILE__, __LINE__);
       }
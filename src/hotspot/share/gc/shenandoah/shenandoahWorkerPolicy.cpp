@@ -24,53 +24,112 @@
 
 #include "precompiled.hpp"
 
+#include "code/codeCache.hpp"
 #include "gc/shared/gc_globals.hpp"
+#include "gc/shared/workerPolicy.hpp"
+#include "gc/shenandoah/shenandoahCollectionSet.hpp"
+#include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahPhaseTimings.hpp"
 #include "gc/shenandoah/shenandoahWorkerPolicy.hpp"
+#include "runtime/globals_extension.hpp"
+#include "runtime/os.hpp"
+
+size_t ShenandoahWorkerPolicy::_work[ShenandoahWorkerPolicy::_num_tuned_phases] = {};
+uint   ShenandoahWorkerPolicy::_workers[ShenandoahWorkerPolicy::_num_tuned_phases] = {};
+double ShenandoahWorkerPolicy::_throughput[ShenandoahWorkerPolicy::_num_tuned_phases] = {};
+
+// Once the throughput of a phase is known, give it as many workers as can each get at
+// least ShenandoahWorkerMinWorkMs of its work, up to the workers the CPU quota allows.
+// Small phases then use a few workers, and phases with a lot of work may use more than
+// the default count.
+uint ShenandoahWorkerPolicy::calc_workers(TunedPhase phase, size_t work, uint default_workers) {
+  _work[phase] = work;
+  uint workers = default_workers;
+  if (ShenandoahAdaptiveWorkers && _throughput[phase] > 0 && work > 0) {
+    double single_worker_ms = work / _throughput[phase] * 1000;
+    uint limit = MIN2(ShenandoahHeap::heap()->max_workers(), (uint) os::active_processor_count());
+    double wanted = ceil(single_worker_ms / ShenandoahWorkerMinWorkMs);
+    workers = (uint) clamp<double>(wanted, 1, limit);
+  }
+  _workers[phase] = workers;
+  return workers;
+}
+
+uint ShenandoahWorkerPolicy::parallel_workers() {
+  return FLAG_IS_DEFAULT(ParallelGCThreads) ? WorkerPolicy::fit_to_active_processors(ParallelGCThreads) : ParallelGCThreads;
+}
+
+uint ShenandoahWorkerPolicy::conc_workers() {
+  return FLAG_IS_DEFAULT(ConcGCThreads) ? WorkerPolicy::fit_to_active_processors(ConcGCThreads) : ConcGCThreads;
+}
+
+void ShenandoahWorkerPolicy::record_cycle(const ShenandoahPhaseTimings* timings) {
+  static const ShenandoahPhaseTimings::Phase phases[_num_tuned_phases] = {
+    ShenandoahPhaseTimings::conc_reset,
+    ShenandoahPhaseTimings::conc_class_unload,
+    ShenandoahPhaseTimings::conc_evac,
+    ShenandoahPhaseTimings::conc_update_refs,
+    ShenandoahPhaseTimings::final_update_refs
+  };
+  for (uint i = 0; i < _num_tuned_phases; i++) {
+    double time = timings->cycle_time(phases[i]);
+    if (time > 0 && _work[i] > 0 && _workers[i] > 0) {
+      double throughput = _work[i] / (time * _workers[i]);
+      _throughput[i] = (_throughput[i] > 0) ? (0.7 * _throughput[i] + 0.3 * throughput) : throughput;
+    }
+    _work[i] = 0;
+    _workers[i] = 0;
+  }
+}
 
 uint ShenandoahWorkerPolicy::calc_workers_for_init_marking() {
-  return ParallelGCThreads;
+  return parallel_workers();
 }
 
 uint ShenandoahWorkerPolicy::calc_workers_for_conc_marking() {
-  return ConcGCThreads;
+  return conc_workers();
 }
 
 uint ShenandoahWorkerPolicy::calc_workers_for_rs_scanning() {
-  return ConcGCThreads;
+  return conc_workers();
 }
 
 uint ShenandoahWorkerPolicy::calc_workers_for_final_marking() {
-  return ParallelGCThreads;
+  return parallel_workers();
 }
 
 uint ShenandoahWorkerPolicy::calc_workers_for_conc_refs_processing() {
-  return ConcGCThreads;
+  return conc_workers();
 }
 
 uint ShenandoahWorkerPolicy::calc_workers_for_conc_root_processing() {
-  return ConcGCThreads;
+  return conc_workers();
+}
+
+uint ShenandoahWorkerPolicy::calc_workers_for_conc_class_unloading() {
+  return calc_workers(_conc_class_unloading, CodeCache::nmethod_count(), conc_workers());
 }
 
 uint ShenandoahWorkerPolicy::calc_workers_for_conc_evac() {
-  return ConcGCThreads;
+  return calc_workers(_conc_evac, ShenandoahHeap::heap()->collection_set()->live(), conc_workers());
 }
 
 uint ShenandoahWorkerPolicy::calc_workers_for_fullgc() {
-  return ParallelGCThreads;
+  return parallel_workers();
 }
 
 uint ShenandoahWorkerPolicy::calc_workers_for_stw_degenerated() {
-  return ParallelGCThreads;
+  return parallel_workers();
 }
 
 uint ShenandoahWorkerPolicy::calc_workers_for_conc_update_ref() {
-  return ConcGCThreads;
+  return calc_workers(_conc_update_refs, ShenandoahHeap::heap()->used(), conc_workers());
 }
 
 uint ShenandoahWorkerPolicy::calc_workers_for_final_update_ref() {
-  return ParallelGCThreads;
+  return calc_workers(_final_update_refs, ShenandoahHeap::heap()->num_regions(), parallel_workers());
 }
 
 uint ShenandoahWorkerPolicy::calc_workers_for_conc_reset() {
-  return ConcGCThreads;
+  return calc_workers(_conc_reset, ShenandoahHeap::heap()->num_regions(), conc_workers());
 }
@@ -27,7 +27,33 @@
 
 #include "memory/allStatic.hpp"
 
+class ShenandoahPhaseTimings;
+
 class ShenandoahWorkerPolicy : AllStatic {
+private:
+  // Phases whose worker counts follow their work size with ShenandoahAdaptiveWorkers.
+  enum TunedPhase {
+    _conc_reset,
+    _conc_class_unloading,
+    _conc_evac,
+    _conc_update_refs,
+    _final_update_refs,
+    _num_tuned_phases
+  };
+
+  // Work and workers given to each phase in the current cycle, and decaying average of
+  // the work one worker completed per second in past cycles.
+  static size_t _work[_num_tuned_phases];
+  static uint   _workers[_num_tuned_phases];
+  static double _throughput[_num_tuned_phases];
+
+  static uint calc_workers(TunedPhase phase, size_t work, uint default_workers);
+
+  // ParallelGCThreads and ConcGCThreads, scaled down while the CPU quota is below
+  // the one at startup, unless set on the command line.
+  static uint parallel_workers();
+  static uint conc_workers();
+
 public:
   // Calculate the number of workers for initial marking
   static uint calc_workers_for_init_marking();
@@ -47,6 +73,9 @@ public:
   // Calculate workers for concurrent refs processing
   static uint calc_workers_for_conc_refs_processing();
 
+  // Calculate workers for concurrent class unloading
+  static uint calc_workers_for_conc_class_unloading();
+
   // Calculate workers for concurrent evacuation (concurrent GC)
   static uint calc_workers_for_conc_evac();
 
@@ -64,6 +93,9 @@ public:
 
   // Calculate workers for concurrent reset
   static uint calc_workers_for_conc_reset();
+
+  // Learn per-worker throughput from the phases of the cycle that just completed.
+  static void record_cycle(const ShenandoahPhaseTimings* timings);
 };
 
 #endif // SHARE_GC_SHENANDOAH_SHENANDOAHWORKERPOLICY_HPP
@@ -75,6 +75,24 @@
           "(Generational mode only) Object age census at evacuation, "      \
           "rather than during marking.")                                    \
                                                                             \
+  product(uintx, ShenandoahEvacuationKlassSampleRate, 0, EXPERIMENTAL,      \
+          "(Generational mode only) Sample one in this many evacuations "   \
+          "to account evacuated and promoted bytes by class. The classes "  \
+          "with most evacuated bytes are reported with the cycle stats, "   \
+          "and as JFR events. 0 disables the accounting.")                  \
+                                                                            \
+  product(uintx, ShenandoahPretenureSampleRate, 0, EXPERIMENTAL,            \
+          "(Generational mode only) Sample one in this many evacuations "   \
+          "from young to learn which classes mostly survive until they "    \
+          "are tenured, and promote the instances of those classes at "     \
+          "their first survival. 0 disables pretenuring.")                  \
+                                                                            \
+  product(uintx, ShenandoahPretenureSurvivalPercent, 80, EXPERIMENTAL,      \
+          "(Generational mode only) With ShenandoahPretenureSampleRate, "   \
+          "pretenure a class when the sampled bytes promoted at tenuring "  \
+          "age reach this percent of the sampled bytes first surviving.")   \
+          range(1, 100)                                                     \
+                                                                            \
   product(bool, ShenandoahGenerationalAdaptiveTenuring, true, EXPERIMENTAL, \
           "(Generational mode only) Dynamically adapt tenuring age.")       \
                                                                             \
@@ -115,6 +133,14 @@
           "population volume that you are comfortable ignoring when making "\
           "tenuring decisions.")                                            \
                                                                             \
+  product(uintx, ShenandoahGenerationalCensusSampleRate, 1, EXPERIMENTAL,   \
+          "(Generational mode only) When the age census is taken during "   \
+          "marking, count only one in this many marked young objects and "  \
+          "scale their volume up accordingly. Cohorts are then tenured "    \
+          "only if the upper end of the confidence interval of their "      \
+          "mortality rate is low. 1 counts every object.")                  \
+          range(1, 1024)                                                    \
+                                                                            \
   product(size_t, ShenandoahRegionSize, 0, EXPERIMENTAL,                    \
           "Static heap region size. Set zero to enable automatic sizing.")  \
                                                                             \
@@ -156,7 +182,10 @@
           " static -  trigger GC when free heap falls below the threshold;" \
           " aggressive - run GC continuously, try to evacuate everything;"  \
           " compact - run GC more frequently and with deeper targets to "   \
-          "free up more memory.")                                           \
+          "free up more memory;"                                            \
+          " deadline - predict the cycle time from learned phase costs, "   \
+          "and adapt to meet ShenandoahDeadlinePacingTargetMs and "         \
+          "ShenandoahDeadlineStallBudgetMs.")                               \
                                                                             \
   product(uintx, ShenandoahExpeditePromotionsThreshold, 5, EXPERIMENTAL,    \
           "When Shenandoah expects to promote at least this percentage "    \
@@ -232,6 +261,24 @@
           "to 100 effectively disables the shortcut.")                      \
           range(0,100)                                                      \
                                                                             \
+  product(bool, ShenandoahPresortCollectionSet, false, EXPERIMENTAL,        \
+          "Sort the collection set candidates by garbage concurrently, "    \
+          "once marking is done. Final mark then only sorts the "           \
+          "candidates whose garbage changed since, and merges them in.")    \
+                                                                            \
+  product(uintx, ShenandoahRegionAccessSampleRate, 0, EXPERIMENTAL,         \
+          "Sample one in this many load reference barrier slow paths of "   \
+          "each thread, and count the region of the loaded field. "         \
+          "Regions with many samples are considered hot when choosing "     \
+          "the collection set. 0 disables the sampling.")                   \
+                                                                            \
+  product(uintx, ShenandoahHotRegionGarbageThreshold, 50, EXPERIMENTAL,     \
+          "With ShenandoahRegionAccessSampleRate, regions sampled more "    \
+          "than four times as often as the average sampled region are "     \
+          "only added to the collection set if at least this percent of "   \
+          "them is garbage.")                                               \
+          range(0,100)                                                      \
+                                                                            \
   product(uintx, ShenandoahAdaptiveSampleFrequencyHz, 10, EXPERIMENTAL,     \
           "The number of times per second to update the allocation rate "   \
           "moving average.")                                                \
@@ -260,6 +307,36 @@
           "Larger values give more weight to recent values.")               \
           range(0,1.0)                                                      \
                                                                             \
+  product(uintx, ShenandoahAllocSpikeRefills, 64, EXPERIMENTAL,             \
+          "Every this many TLAB refills, compare the time they took with "  \
+          "the average, and wake up the thread that decides when to "       \
+          "start a cycle if refills accelerated, so that it samples the "   \
+          "allocation rate right away. Setting this to 0 disables the "     \
+          "feature.")                                                       \
+                                                                            \
+  product(uintx, ShenandoahAllocSpikeAcceleration, 4, EXPERIMENTAL,         \
+          "With ShenandoahAllocSpikeRefills, how many times faster than "   \
+          "average a batch of TLAB refills must complete to wake up the "   \
+          "thread that decides when to start a cycle.")                     \
+          range(2, 1000)                                                    \
+                                                                            \
+  product(bool, ShenandoahAdaptivePredictPhases, true, EXPERIMENTAL,        \
+          "Predict the cycle time from per-phase models, fitted to the "    \
+          "live data marked, the live data evacuated and the used memory "  \
+          "updated in recent cycles, rather than from the average cycle "   \
+          "time. The prediction also limits the collection set size.")      \
+                                                                            \
+  product(uintx, ShenandoahDeadlinePacingTargetMs, 1, EXPERIMENTAL,         \
+          "Deadline heuristics start cycles early enough, and keep their "  \
+          "collection sets small enough, that the 99th percentile of "      \
+          "pacing delays stays below this many milliseconds.")              \
+          range(1, 1000)                                                    \
+                                                                            \
+  product(uintx, ShenandoahDeadlineStallBudgetMs, 10, EXPERIMENTAL,         \
+          "Deadline heuristics react more strongly to a degenerated or "    \
+          "full cycle that stalled allocations for longer than this many "  \
+          "milliseconds.")                                                  \
+                                                                            \
   product(uintx, ShenandoahGuaranteedGCInterval, 5*60*1000, EXPERIMENTAL,   \
           "Many heuristics would guarantee a concurrent GC cycle at "       \
           "least with this interval. This is useful when large idle "       \
@@ -288,6 +365,17 @@
           "regions that require committing back. Uncommits would be "       \
           "disabled by some heuristics, or with static heap size.")         \
                                                                             \
+  product(bool, ShenandoahUncommitLazily, false, EXPERIMENTAL,              \
+          "Uncommit regions by telling the OS to reclaim their pages "      \
+          "lazily, with MADV_FREE on Linux and BSD, rather than unmapping " \
+          "them. A region whose pages have not been reclaimed yet is "      \
+          "committed again without a system call or page faults. Falls "    \
+          "back to regular uncommit where this is not supported.")          \
+                                                                            \
+  product(bool, ShenandoahHugePageMetadata, true, EXPERIMENTAL,             \
+          "With transparent huge pages, also advise huge pages for the "    \
+          "card tables, which are otherwise committed with small pages.")   \
+                                                                            \
   product(uintx, ShenandoahUncommitDelay, 5*60*1000, EXPERIMENTAL,          \
           "Uncommit memory for regions that were not used for more than "   \
           "this time. First use after that would incur allocation stalls. " \
@@ -296,6 +384,111 @@
           "milliseconds. Setting this delay to 0 effectively uncommits "    \
           "regions almost immediately after they become unused.")           \
                                                                             \
+  product(bool, ShenandoahNUMAAffinity, false, EXPERIMENTAL,                \
+          "Place the memory of each heap region on a NUMA node, with one "  \
+          "contiguous range of regions per node, and prefer allocating "    \
+          "TLABs and GCLABs from regions local to the requesting thread. "  \
+          "Allocations fall back to other nodes when the local node has "   \
+          "no suitable free regions. Requires UseNUMA.")                    \
+                                                                            \
+  product(intx, ShenandoahSlowMemoryNode, -1, EXPERIMENTAL,                 \
+          "OS id of a NUMA node with slower memory, such as CXL-attached "  \
+          "memory. The highest ShenandoahSlowMemoryPercent of the heap "    \
+          "regions are placed on it. The free set takes the old reserve "   \
+          "from these regions first, and allocates for mutators and young " \
+          "evacuation in them only when other regions are exhausted. "      \
+          "-1 disables the slow tier. Requires UseNUMA.")                   \
+          range(-1, max_jint)                                               \
+                                                                            \
+  product(uintx, ShenandoahSlowMemoryPercent, 0, EXPERIMENTAL,              \
+          "Percentage of the heap regions that is placed on "               \
+          "ShenandoahSlowMemoryNode.")                                      \
+          range(0, 100)                                                     \
+                                                                            \
+  product(bool, ShenandoahRecycleZeroing, false, EXPERIMENTAL,              \
+          "Zero the memory of trash regions that are recycled into the "    \
+          "mutator free set. The zeroing is done by GC workers, outside "   \
+          "of the heap lock.")                                              \
+                                                                            \
+  product(uintx, ShenandoahZeroedRegionPool, 0, EXPERIMENTAL,               \
+          "Number of empty regions that the control thread keeps zeroed "   \
+          "while it is idle. Humongous allocations and other allocations "  \
+          "outside of TLABs from zeroed regions do not need to clear "      \
+          "the object memory. Zero disables the pool.")                     \
+                                                                            \
+  product(uintx, ShenandoahPrecommitRegions, 0, EXPERIMENTAL,               \
+          "Number of empty regions next in line for mutator allocation "    \
+          "that the control thread keeps committed and pretouched while "   \
+          "it is idle, with the GC workers. Allocations after an uncommit " \
+          "then do not page fault. Commits stop at the soft max heap "      \
+          "size. Zero disables this.")                                      \
+                                                                            \
+  product(bool, ShenandoahParallelTableCleanup, false, EXPERIMENTAL,        \
+          "Delete dead string and symbol table entries with the GC "        \
+          "workers at the end of the concurrent weak roots phase, "         \
+          "instead of with the service thread. Growing the tables is "      \
+          "still done by the service thread.")                              \
+                                                                            \
+  product(bool, ShenandoahSettledWeakRoots, false, EXPERIMENTAL,            \
+          "In generational mode, record blocks of weak OopStorage whose "   \
+          "entries all refer to old objects outside the collection set, "   \
+          "and skip them in the concurrent weak roots phase of young "      \
+          "cycles until a weak root store or allocation in the block.")     \
+                                                                            \
+  product(uintx, ShenandoahFuseUpdateRefsCSetRegions, 0, EXPERIMENTAL,      \
+          "Go from concurrent evacuation straight to concurrent "           \
+          "update-refs when the collection set has at most this many "      \
+          "regions. The Init Update Refs pause is replaced by a handshake " \
+          "that hands threads the new gc state and retires their GCLABs. "  \
+          "Not used with ShenandoahVerify.")                                \
+                                                                            \
+  product(bool, ShenandoahUpdateRefsRegionSummary, false, EXPERIMENTAL,     \
+          "Summarize during marking which regions the reference fields "    \
+          "of every region point to, and let update-refs skip the marked "  \
+          "objects of regions that cannot point into the collection set. "  \
+          "After concurrent marking, only regions without reference "       \
+          "fields qualify. Only for non-generational modes.")               \
+                                                                            \
+  product(uintx, ShenandoahPrefilledGCLABSize, 2*K, EXPERIMENTAL,           \
+          "Size in words of the GCLAB handed to every Java thread when "    \
+          "concurrent evacuation starts, so that the first evacuations in " \
+          "the load reference barrier slow path do not take the heap "      \
+          "lock. Prefilling takes at most a quarter of the collector "      \
+          "reserve. Zero disables prefilling.")                             \
+                                                                            \
+  product(uintx, ShenandoahAllocShards, 0, EXPERIMENTAL,                    \
+          "Number of allocation shards that refill TLABs and GCLABs from "  \
+          "their own region without taking the heap lock. Threads map to "  \
+          "shards by NUMA node when ShenandoahNUMAAffinity is active, and " \
+          "round-robin otherwise. Zero disables sharding.")                 \
+          range(0,1024)                                                     \
+                                                                            \
+  product(uintx, ShenandoahMediumAllocShards, 0, EXPERIMENTAL,              \
+          "Number of allocation shards that serve medium objects, which "   \
+          "are allocated outside of TLABs, from their own region without "  \
+          "taking the heap lock. Threads map to shards like they do for "   \
+          "ShenandoahAllocShards. Zero disables medium object shards.")     \
+          range(0,1024)                                                     \
+                                                                            \
+  product(size_t, ShenandoahMediumObjectMinSize, 64 * K, EXPERIMENTAL,      \
+          "Smallest object size in bytes that is allocated from medium "    \
+          "object shards. Objects up to the humongous threshold are "       \
+          "medium objects.")                                                \
+                                                                            \
+  product(uintx, ShenandoahEvacTLABSizePercent, 100, EXPERIMENTAL,          \
+          "Size of new TLABs while evacuation is in progress, in percent "  \
+          "of the size the thread's allocation history calls for. "         \
+          "Smaller TLABs leave more of the free set to GCLABs and "         \
+          "shared evacuations.")                                            \
+          range(1,100)                                                      \
+                                                                            \
+  product(uintx, ShenandoahIdleTLABSizePercent, 100, EXPERIMENTAL,          \
+          "Size of new TLABs while no GC cycle is in progress, in percent " \
+          "of the size the thread's allocation history calls for. Larger "  \
+          "TLABs mean fewer refills. TLABs are still capped at their "      \
+          "maximum size.")                                                  \
+          range(100,1000)                                                   \
+                                                                            \
   product(bool, ShenandoahRegionSampling, false, EXPERIMENTAL,              \
           "Provide heap region sampling data via jvmstat.")                 \
                                                                             \
@@ -304,6 +497,24 @@
           "the samples. Higher values provide more fidelity, at expense "   \
           "of more sampling overhead.")                                     \
                                                                             \
+  product(uintx, ShenandoahCycleHistorySize, 16, EXPERIMENTAL,              \
+          "Number of recent cycles whose phase timings, collection set "    \
+          "and free set are kept for the GC.shenandoah_stats diagnostic "   \
+          "command.")                                                       \
+          range(1, 1024)                                                    \
+                                                                            \
+  product(ccstr, ShenandoahHeuristicsTraceFile, nullptr, DIAGNOSTIC,        \
+          "Record the inputs and decisions of the heuristics into a "       \
+          "binary trace at this path, for replaying them offline through "  \
+          "the heuristics classes.")                                        \
+                                                                            \
+  product(uintx, ShenandoahRegionTransitionLogSize, 0, EXPERIMENTAL,        \
+          "With ShenandoahRegionSampling, also publish every region state " \
+          "transition with its timestamp via jvmstat, in a ring buffer "    \
+          "of this many entries. External tools can replay the heap "       \
+          "evolution between samples from it. 0 disables the log.")         \
+          range(0, 1024*K)                                                  \
+                                                                            \
   product(uintx, ShenandoahControlIntervalMin, 1, EXPERIMENTAL,             \
           "The minimum sleep interval for the control loop that drives "    \
           "the cycles. Lower values would increase GC responsiveness "      \
@@ -335,6 +546,13 @@
           " 3 = previous level, plus all reachable objects; "               \
           " 4 = previous level, plus all marked objects")                   \
                                                                             \
+  product(uintx, ShenandoahVerifySampledRegions, 0, DIAGNOSTIC,             \
+          "When non-zero, verification walks the marked objects of only "   \
+          "this many randomly chosen regions on every pass, and skips the " \
+          "walk of the reachable heap and the liveness check. This makes "  \
+          "verification pauses short enough for large heaps, at the cost "  \
+          "of coverage. 0 walks all regions.")                              \
+                                                                            \
   product(uintx, ShenandoahEvacReserve, 5, EXPERIMENTAL,                    \
           "How much of (young-generation) heap to reserve for "             \
           "(young-generation) evacuations.  Larger values allow GC to "     \
@@ -415,6 +633,14 @@
           "to be more than this.")                                          \
           range(0, 100)                                                     \
                                                                             \
+  product(bool, ShenandoahCostModelGenerationSizing, false,                 \
+                                                               EXPERIMENTAL,\
+          "(Generational mode only) Keep free regions in the old "          \
+          "generation when a model of young and old cycle CPU costs finds " \
+          "that a smaller young generation costs less GC time overall. "    \
+          "The model uses the GC CPU time of recent cycles and the growth " \
+          "of the old generation per young cycle.")                         \
+                                                                            \
   product(bool, ShenandoahPacing, true, EXPERIMENTAL,                       \
           "Pace application allocations to give GC chance to start "        \
           "and complete before allocation failure is reached.")             \
@@ -427,6 +653,43 @@
           "GC effectively stall the threads indefinitely instead of going " \
           "to degenerated or Full GC.")                                     \
                                                                             \
+  product(size_t, ShenandoahPacingTokenBucket, 64 * K, EXPERIMENTAL,        \
+          "Pacing credit, in words, that each allocating thread claims "    \
+          "ahead of its allocations, so that most allocations do not "      \
+          "update the shared pacing budget. Setting this to 0 makes each "  \
+          "allocation claim its own credit.")                               \
+                                                                            \
+  product(ccstr, ShenandoahPacingThreadWeights, nullptr, EXPERIMENTAL,      \
+          "Pacing weights for threads by name, as a comma-separated list "  \
+          "of pattern=weight entries, where patterns may contain * and "    \
+          "the first match applies. Threads are taxed and delayed in "      \
+          "proportion to their weight, which defaults to 1. Weights above " \
+          "1 make background threads absorb pacing delays first, and "      \
+          "weight 0 exempts threads from pacing.")                          \
+                                                                            \
+  product(bool, ShenandoahMarkAssist, false, EXPERIMENTAL,                  \
+          "Allocating threads that run out of pacing budget during "        \
+          "concurrent mark do some of the marking work, instead of "        \
+          "waiting for GC threads to make progress. Only in the "           \
+          "non-generational mode, and not with marking class histograms.")  \
+                                                                            \
+  product(uintx, ShenandoahMarkAssistTasks, 256, EXPERIMENTAL,              \
+          "Number of marking tasks an allocating thread processes each "    \
+          "time it assists marking.")                                       \
+          range(1, max_juint)                                               \
+                                                                            \
+  product(uintx, ShenandoahMarkAssistQueues, 4, EXPERIMENTAL,               \
+          "Number of allocating threads that can assist marking at the "    \
+          "same time. Other threads are paced as usual.")                   \
+          range(1, 64)                                                      \
+                                                                            \
+  product(uintx, ShenandoahOldMarkTasksPerYoungCycle, 8192, EXPERIMENTAL,   \
+          "(Generational mode only) Number of old marking tasks the "       \
+          "workers of a young cycle trace at the end of its concurrent "    \
+          "mark, when it runs during old marking. This keeps old marking "  \
+          "converging when young cycles interrupt it often. Setting this "  \
+          "to 0 leaves all old marking to the old cycle.")                  \
+                                                                            \
   product(uintx, ShenandoahPacingIdleSlack, 2, EXPERIMENTAL,                \
           "How much of heap counted as non-taxable allocations during idle "\
           "phases. Larger value makes the pacing milder when collector is " \
@@ -483,6 +746,19 @@
           "humongous allocations, at the expense of higher GC copying "     \
           "costs. Currently affects stop-the-world (Full) cycle only.")     \
                                                                             \
+  product(bool, ShenandoahParallelHumongousMoves, true, DIAGNOSTIC,         \
+          "Split the copy of large humongous objects that Full GC moves "   \
+          "between the GC workers.")                                        \
+                                                                            \
+  product(bool, ShenandoahEvacuatePinnedRegions, false, EXPERIMENTAL,       \
+          "Allow regions with pinned objects in the collection set. The "   \
+          "bounds of the pinned objects are tracked, evacuation leaves "    \
+          "the objects within them in place, and turns the rest of the "    \
+          "region into filler space that a later cycle reclaims. Objects "  \
+          "that degenerated GC fails to evacuate are left in place the "    \
+          "same way, instead of upgrading to Full GC. Not supported in "    \
+          "generational mode.")                                             \
+                                                                            \
   product(bool, ShenandoahOOMDuringEvacALot, false, DIAGNOSTIC,             \
           "Testing: simulate OOM during evacuation.")                       \
                                                                             \
@@ -503,14 +779,86 @@
           "Set to 0 to disable prefetching.")                               \
           range(0, 256)                                                     \
                                                                             \
+  product(uintx, ShenandoahLivenessCacheSize, 1024, EXPERIMENTAL,           \
+          "Number of regions each marking worker accumulates live data "    \
+          "for before flushing it to the regions. Rounded up to a power "   \
+          "of two, and capped by the number of regions.")                   \
+          range(1, 1024 * K)                                                \
+                                                                            \
   product(uintx, ShenandoahMarkLoopStride, 1000, EXPERIMENTAL,              \
           "How many items to process during one marking iteration before "  \
           "checking for cancellation, yielding, etc. Larger values improve "\
           "marking performance at expense of responsiveness.")              \
                                                                             \
+  product(bool, ShenandoahAdaptiveArrayChunking, true, EXPERIMENTAL,        \
+          "Adapt the size of object array chunks during marking: split "    \
+          "arrays finer while some workers are out of work, and coarser "   \
+          "while the local queue is deep.")                                 \
+                                                                            \
+  product(uintx, ShenandoahAdaptiveArrayChunkingQueueDepth, 1024,           \
+          EXPERIMENTAL,                                                     \
+          "Local queue depth at which adaptive array chunking makes "       \
+          "array chunks coarser.")                                          \
+          range(1, max_uintx)                                               \
+                                                                            \
+  product(bool, ShenandoahChunkedStackChunkMarking, true, DIAGNOSTIC,       \
+          "Split the frames of large continuation stack chunks into "       \
+          "marking tasks the same way as object arrays, so that "           \
+          "workers can share a single deep stack.")                         \
+                                                                            \
+  product(uintx, ShenandoahMarkStealBatch, 16, EXPERIMENTAL,                \
+          "Maximum number of marking tasks a worker steals from a victim "  \
+          "at once. Workers steal up to half of the tasks of the victim, "  \
+          "within this bound.")                                             \
+          range(1, 1024)                                                    \
+                                                                            \
+  product(uintx, ShenandoahMarkLoopPrefetch, 8, EXPERIMENTAL,               \
+          "How many popped marking tasks to hold back after prefetching "   \
+          "their objects, before the objects are scanned. Set to 0 to "     \
+          "disable prefetching.")                                           \
+          range(0, 64)                                                      \
+                                                                            \
+  product(uintx, ShenandoahUpdateRefsPrefetch, 16, EXPERIMENTAL,            \
+          "How many locations pointing into the collection set concurrent " \
+          "update-refs collects before it resolves their forwardees, "      \
+          "after prefetching the headers of their objects. Set to 0 to "    \
+          "update every location as it is visited.")                        \
+          range(0, 64)                                                      \
+                                                                            \
   product(uintx, ShenandoahParallelRegionStride, 1024, EXPERIMENTAL,        \
-          "How many regions to process at once during parallel region "     \
-          "iteration. Affects heaps with lots of regions.")                 \
+          "How many regions to process at most at once during parallel "    \
+          "region iteration. Affects heaps with lots of regions.")          \
+                                                                            \
+  product(uintx, ShenandoahParallelRegionMinStride, 16, EXPERIMENTAL,       \
+          "How many regions to process at least at once during parallel "   \
+          "region iteration. Workers claim a share of the remaining "       \
+          "regions at a time, within this bound and "                       \
+          "ShenandoahParallelRegionStride.")                                \
+          range(1, max_uintx)                                               \
+                                                                            \
+  product(size_t, ShenandoahEvacuationChunkSize, 1 * M, EXPERIMENTAL,       \
+          "Size of the chunks of collection set regions that workers "      \
+          "claim during evacuation, in bytes. Smaller chunks balance the "  \
+          "work better for regions dense with live data.")                  \
+          range(4 * K, max_uintx)                                           \
+                                                                            \
+  product(size_t, ShenandoahSplitCopyThreshold, 1 * M, EXPERIMENTAL,        \
+          "Objects at least this large, in bytes, are copied by several "   \
+          "GC workers cooperatively during evacuation. Zero disables "      \
+          "cooperative copying.")                                           \
+                                                                            \
+  product(uintx, ShenandoahEvacCoLocateDepth, 0, EXPERIMENTAL,              \
+          "When evacuating a plain object, also evacuate the objects its "  \
+          "first few reference fields point to, depth first up to this "    \
+          "many levels, so that they land next to it in the GCLAB. "        \
+          "Applies to the non-generational modes. 0 disables it.")          \
+          range(0, 8)                                                       \
+                                                                            \
+  product(size_t, ShenandoahMarkOverflowReserve, 256 * M, EXPERIMENTAL,     \
+          "Size of the virtual address range reserved for marking task "    \
+          "queue overflow, in bytes. Memory in the range is committed on "  \
+          "demand and released after marking. Overflow beyond the range "   \
+          "goes to the C heap. Zero disables the range.")                   \
                                                                             \
   product(size_t, ShenandoahSATBBufferSize, 1 * K, EXPERIMENTAL,            \
           "Number of entries in an SATB log buffer.")                       \
@@ -520,6 +868,62 @@
           "How many times to maximum attempt to flush SATB buffers at the " \
           "end of concurrent marking.")                                     \
                                                                             \
+  product(uintx, ShenandoahHandshakeBatchSize, 256, EXPERIMENTAL,           \
+          "Number of threads per handshake operation in the handshakes "    \
+          "with all threads. Zero issues a single operation for all "       \
+          "threads.")                                                       \
+          range(0, max_jint)                                                \
+                                                                            \
+  product(uintx, ShenandoahSATBQuiescentBuffers, 0, EXPERIMENTAL,           \
+          "Stop retrying SATB buffer flushes at the end of concurrent "     \
+          "marking once a flush yields at most this many buffers. The "     \
+          "remaining buffers are drained at final mark.")                   \
+                                                                            \
+  product(bool, ShenandoahSATBNodeRouting, true, EXPERIMENTAL,              \
+          "Hand completed SATB buffers to per-NUMA-node lists, and let "    \
+          "marking workers drain the buffers of their own node first. "     \
+          "Only effective when NUMA affinity is in use.")                   \
+                                                                            \
+  product(bool, ShenandoahSATBLowPriorityDrain, true, EXPERIMENTAL,         \
+          "While a marking worker has local work, drain at most one "       \
+          "SATB buffer of its own node per stride instead of all "          \
+          "completed buffers.")                                             \
+                                                                            \
+  product(bool, ShenandoahDeferClassUnloadingPurge, true, EXPERIMENTAL,     \
+          "Free the metadata of classes unloaded by a concurrent cycle "    \
+          "after the cycle has reclaimed memory, instead of during "        \
+          "class unloading.")                                               \
+                                                                            \
+  product(bool, ShenandoahParallelClassLoaderDataPurge, true, EXPERIMENTAL, \
+          "Delete the class loader data of unloaded classes, and release "  \
+          "their metaspace, with GC workers if there are many of them.")    \
+                                                                            \
+  product(bool, ShenandoahMarkingClassHistogram, false, EXPERIMENTAL,       \
+          "Record a class histogram of the live objects found by every "    \
+          "global marking, for GC.class_histogram -snapshot to print "      \
+          "without a pause.")                                               \
+                                                                            \
+  product(bool, ShenandoahMarkedObjectIteration, true, EXPERIMENTAL,        \
+          "When the marking of the last collection is still complete, "     \
+          "iterate objects in parallel, e.g. for heap dumps, by walking "   \
+          "the marked objects region by region, instead of tracing the "    \
+          "heap from the roots.")                                           \
+                                                                            \
+  product(uintx, ShenandoahParallelGCStatePropagation, 4096, EXPERIMENTAL,  \
+          "Have GC workers store a changed gc state into Java threads at "  \
+          "safepoints, when there are at least this many Java threads. "    \
+          "0 always stores it from the VM thread.")                         \
+                                                                            \
+  product(bool, ShenandoahRefProcBalanceLists, true, EXPERIMENTAL,          \
+          "Before processing discovered references, move references from "  \
+          "long discovered lists to short ones, so that references found "  \
+          "by one worker are processed by all workers.")                    \
+                                                                            \
+  product(uintx, ShenandoahRefProcBalanceMinLength, 256, EXPERIMENTAL,      \
+          "Do not split discovered lists into pieces shorter than this "    \
+          "many references.")                                               \
+          range(1, max_uintx)                                               \
+                                                                            \
   product(bool, ShenandoahSATBBarrier, true, DIAGNOSTIC,                    \
           "Turn on/off SATB barriers in Shenandoah")                        \
                                                                             \
@@ -530,6 +934,11 @@
           "Turn on/off card-marking post-write barrier in Shenandoah: "     \
           " true when ShenandoahGCMode is generational, false otherwise")   \
                                                                             \
+  product(bool, ShenandoahCardBarrierYoungFilter, true, DIAGNOSTIC,         \
+          "Only dirty the card when the stored reference is not null "      \
+          "and points into the young generation. Other stores cannot "      \
+          "create old-to-young pointers.")                                  \
+                                                                            \
   product(bool, ShenandoahCASBarrier, true, DIAGNOSTIC,                     \
           "Turn on/off CAS barriers in Shenandoah")                         \
                                                                             \
@@ -542,6 +951,21 @@
   product(bool, ShenandoahStackWatermarkBarrier, true, DIAGNOSTIC,          \
           "Turn on/off stack watermark barriers in Shenandoah")             \
                                                                             \
+  product(bool, ShenandoahElideDominatedBarrierTests, true, DIAGNOSTIC,     \
+          "Remove C2 heap stable tests that are dominated by another "      \
+          "heap stable test with no safepoint in between, because "         \
+          "the gc state cannot change without a safepoint")                 \
+                                                                            \
+  product(bool, ShenandoahWeakBarrierMarkTest, true, DIAGNOSTIC,            \
+          "Test the mark bitmap inline in the interpreter and C1 weak and " \
+          "phantom load reference barriers, and skip the runtime call "     \
+          "for marked referents outside of the collection set")             \
+                                                                            \
+  product(bool, ShenandoahElideImmutableLoadBarriers, true, DIAGNOSTIC,     \
+          "Remove C2 load reference barriers on objects that are only "     \
+          "used to read fields of classes whose fields are all trusted "    \
+          "final primitives")                                               \
+                                                                            \
   develop(bool, ShenandoahVerifyOptoBarriers, trueInDebug,                  \
           "Verify no missing barriers in C2.")                              \
                                                                             \
@@ -567,6 +991,117 @@
           "Log cumulative card stats every so many remembered set or "      \
           "update refs scans")                                              \
                                                                             \
+  product(bool, ShenandoahCardClusterSummary, true, EXPERIMENTAL,           \
+          "Keep a summary of the remembered set with one bit per card "     \
+          "cluster, and skip clusters without dirty cards wholesale "       \
+          "when scanning the remembered set during young marking.")         \
+                                                                            \
+  product(bool, ShenandoahSwapCardTables, true, EXPERIMENTAL,               \
+          "Exchange the read and write card tables at init mark by "        \
+          "flipping pointers, and clean the old read table during "         \
+          "concurrent reset. Otherwise, the write table is copied to "      \
+          "the read table and cleaned during the init mark pause.")         \
+                                                                            \
+  product(bool, ShenandoahAdaptivePLABSize, true, EXPERIMENTAL,             \
+          "Start the PLABs of each thread at a size derived from the "      \
+          "PLAB volume that thread has used in recent cycles, instead "     \
+          "of at the minimum size. The size still doubles on every "        \
+          "refill within a cycle. See TargetPLABWastePct and PLABWeight.")  \
+                                                                            \
+  product(uintx, ShenandoahPromoteInPlaceBatch, 16, EXPERIMENTAL,           \
+          "Number of regions promoted in place that an evacuation "         \
+          "worker hands over to the old generation under a single "         \
+          "acquisition of the heap lock.")                                  \
+          range(1, 1024)                                                    \
+                                                                            \
+  product(bool, ShenandoahPromoteHumongousPrimitiveArrays, true,            \
+          EXPERIMENTAL,                                                     \
+          "(Generational mode only) Promote aged humongous primitive "      \
+          "arrays to the old generation. If disabled, they stay young: "    \
+          "they are never scanned or moved, and young collections "         \
+          "reclaim them as soon as they die, instead of old collections.")  \
+                                                                            \
+  product(bool, ShenandoahOldEvacCostModel, true, EXPERIMENTAL,             \
+          "Rank old candidate regions for mixed collections by the cost "   \
+          "of evacuating them: live bytes to copy plus dirty cards to "     \
+          "rescan, with pinned regions last. Also bound the evacuation "    \
+          "effort of a mixed collection while the GC utilization stays "    \
+          "above ShenandoahMixedTargetGCU.")                                \
+                                                                            \
+  product(uintx, ShenandoahMixedTargetGCU, 20, EXPERIMENTAL,                \
+          "With ShenandoahOldEvacCostModel, the percentage of CPU time "    \
+          "given to GC threads over the most recent cycle above which "     \
+          "the next mixed collection halves its old evacuation effort. "    \
+          "The effort recovers gradually once utilization drops below.")    \
+          range(1, 100)                                                     \
+                                                                            \
+  product(uintx, ShenandoahMutatorUtilizationTarget, 0, EXPERIMENTAL,       \
+          "In generational mode, the percentage of CPU time that mutator "  \
+          "threads should get over each GCPauseIntervalMillis window. "     \
+          "A window that falls below it is reported with a warning and a "  \
+          "JFR event. Zero disables the check.")                            \
+          range(0, 100)                                                     \
+                                                                            \
+  product(bool, ShenandoahOldHumongousDefrag, true, EXPERIMENTAL,           \
+          "When a humongous allocation finds enough free regions, but "     \
+          "no contiguous run of them, start an old collection that "        \
+          "evacuates the cheapest run of old regions of that length "       \
+          "with its mixed collections. Old evacuation effort remains "      \
+          "bounded by ShenandoahMixedTargetGCU.")                           \
+                                                                            \
+  product(bool, ShenandoahSoftMaxControl, false, EXPERIMENTAL,              \
+          "Adjust SoftMaxHeapSize after every GC session: grow it when GC " \
+          "threads use more than ShenandoahSoftMaxTargetGCU of the CPU, "   \
+          "and shrink it, down to the used heap plus "                      \
+          "ShenandoahMinFreeThreshold, when they use less than half of "    \
+          "that or when available memory runs low. With ShenandoahUncommit "\
+          "the heap is uncommitted down to the new soft max.")              \
+                                                                            \
+  product(uintx, ShenandoahSoftMaxTargetGCU, 5, EXPERIMENTAL,               \
+          "With ShenandoahSoftMaxControl, the percentage of CPU time that " \
+          "GC threads should use.")                                         \
+          range(1, 100)                                                     \
+                                                                            \
+  product(uintx, ShenandoahSoftMaxMemoryPressure, 10, EXPERIMENTAL,         \
+          "With ShenandoahSoftMaxControl or ShenandoahMemoryStallThreshold,"\
+          " shrink soft max heap size while the available memory of the "   \
+          "machine or container is below this percentage of its physical "  \
+          "memory.")                                                        \
+          range(0, 100)                                                     \
+                                                                            \
+  product(uintx, ShenandoahMemoryStallThreshold, 0, EXPERIMENTAL,           \
+          "Percentage of time the tasks of the container may stall on "     \
+          "memory, per cgroup v2 pressure stall information, before soft "  \
+          "max heap size is lowered and a cycle is started to uncommit "    \
+          "memory. Soft max is raised back once the pressure is gone. "     \
+          "0 disables the check.")                                          \
+          range(0, 100)                                                     \
+                                                                            \
+  product(bool, ShenandoahAdaptiveWorkers, false, EXPERIMENTAL,             \
+          "Choose the workers for reset, class unloading, evacuation and "  \
+          "update refs from their work size and the per-worker throughput " \
+          "of past cycles, instead of using ConcGCThreads and "             \
+          "ParallelGCThreads. Phases may use fewer or more workers, up to " \
+          "the processors available to the process.")                       \
+                                                                            \
+  product(uintx, ShenandoahWorkerMinWorkMs, 2, EXPERIMENTAL,                \
+          "With ShenandoahAdaptiveWorkers, the least expected time, in "    \
+          "milliseconds, that each worker of a phase should work for.")     \
+          range(1, 1000)                                                    \
+                                                                            \
+  product(bool, ShenandoahResetAfterCollect, true, EXPERIMENTAL,            \
+          "Clear the mark bitmaps at the end of a concurrent cycle, so "    \
+          "that the concurrent reset of the next cycle has less to do "     \
+          "when it starts. In generational mode, this only happens after "  \
+          "young cycles.")                                                  \
+                                                                            \
+  product(uintx, ShenandoahAllocStallDuringEvacMs, 10, EXPERIMENTAL,        \
+          "When an allocation fails during concurrent evacuation or "       \
+          "update refs, stop the allocating thread for up to this many "    \
+          "milliseconds for the cycle to reclaim the collection set, "      \
+          "while GC threads continue, before cancelling the cycle for a "   \
+          "degenerated one. Setting this to 0 cancels right away.")         \
+                                                                            \
   product(uintx, ShenandoahMinimumOldMarkTimeMs, 100, EXPERIMENTAL,         \
          "Minimum amount of time in milliseconds to run old marking "       \
          "before a young collection is allowed to run. This is intended "   \
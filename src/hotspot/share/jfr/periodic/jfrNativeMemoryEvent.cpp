@@ -49,6 +49,17 @@ static NMTUsage* get_usage(const Ticks& timestamp) {
   return usage;
 }
 
+// Values reported by the previous events, used to compute the deltas.
+// Periodic events are sent from a single thread at a time.
+static NMTUsagePair last_total = { 0, 0 };
+static NMTUsagePair last_by_type[mt_number_of_types];
+
+static int64_t delta(size_t current, size_t* last) {
+  const int64_t result = (int64_t)current - (int64_t)*last;
+  *last = current;
+  return result;
+}
+
 void JfrNativeMemoryEvent::send_total_event(const Ticks& timestamp) {
   if (!MemTracker::enabled()) {
     return;
@@ -58,8 +69,12 @@ void JfrNativeMemoryEvent::send_total_event(const Ticks& timestamp) {
 
   EventNativeMemoryUsageTotal event(UNTIMED);
   event.set_starttime(timestamp);
-  event.set_reserved(usage->total_reserved());
-  event.set_committed(usage->total_committed());
+  const size_t reserved = usage->total_reserved();
+  const size_t committed = usage->total_committed();
+  event.set_reserved(reserved);
+  event.set_committed(committed);
+  event.set_reservedDelta(delta(reserved, &last_total.reserved));
+  event.set_committedDelta(delta(committed, &last_total.committed));
   event.commit();
 }
 
@@ -69,6 +84,9 @@ void JfrNativeMemoryEvent::send_type_event(const Ticks& starttime, MEMFLAGS flag
   event.set_type(NMTUtil::flag_to_index(flag));
   event.set_reserved(reserved);
   event.set_committed(committed);
+  NMTUsagePair* const last = &last_by_type[NMTUtil::flag_to_index(flag)];
+  event.set_reservedDelta(delta(reserved, &last->reserved));
+  event.set_committedDelta(delta(committed, &last->committed));
   event.commit();
 }
 
@@ -708,6 +708,15 @@ TRACE_REQUEST_FUNC(ShenandoahHeapRegionInformation) {
 #endif
 }
 
+TRACE_REQUEST_FUNC(ShenandoahHumongousSummary) {
+#if INCLUDE_SHENANDOAHGC
+  if (UseShenandoahGC) {
+    VM_ShenandoahSendHumongousSummaryEvent op;
+    VMThread::execute(&op);
+  }
+#endif
+}
+
 TRACE_REQUEST_FUNC(FinalizerStatistics) {
 #if INCLUDE_MANAGEMENT
   JfrFinalizerStatisticsEvent::generate_events();
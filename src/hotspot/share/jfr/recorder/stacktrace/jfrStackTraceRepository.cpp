@@ -28,7 +28,9 @@
 #include "jfr/recorder/repository/jfrChunkWriter.hpp"
 #include "jfr/recorder/stacktrace/jfrStackTraceRepository.hpp"
 #include "jfr/support/jfrThreadLocal.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/mutexLocker.hpp"
+#include "utilities/globalCounter.inline.hpp"
 
 /*
  * There are two separate repository instances.
@@ -51,8 +53,8 @@ static JfrStackTraceRepository& leak_profiler_instance() {
   return *_leak_profiler_instance;
 }
 
-JfrStackTraceRepository::JfrStackTraceRepository() : _last_entries(0), _entries(0) {
-  memset(_table, 0, sizeof(_table));
+JfrStackTraceRepository::JfrStackTraceRepository() : _last_entries(0), _entries(0), _generation(1) {
+  memset((void*)_table, 0, sizeof(_table));
 }
 
 JfrStackTraceRepository* JfrStackTraceRepository::create() {
@@ -101,48 +103,75 @@ size_t JfrStackTraceRepository::write(JfrChunkWriter& sw, bool clear) {
   if (_entries == 0) {
     return 0;
   }
-  MutexLocker lock(JfrStacktrace_lock, Mutex::_no_safepoint_check_flag);
-  assert(_entries > 0, "invariant");
+  JfrStackTrace** const detached = clear ? NEW_C_HEAP_ARRAY(JfrStackTrace*, TABLE_SIZE, mtTracing) : nullptr;
   int count = 0;
-  for (u4 i = 0; i < TABLE_SIZE; ++i) {
-    JfrStackTrace* stacktrace = _table[i];
-    while (stacktrace != nullptr) {
-      JfrStackTrace* next = const_cast<JfrStackTrace*>(stacktrace->next());
-      if (stacktrace->should_write()) {
-        stacktrace->write(sw);
-        ++count;
-      }
-      if (clear) {
-        delete stacktrace;
+  {
+    MutexLocker lock(JfrStacktrace_lock, Mutex::_no_safepoint_check_flag);
+    assert(_entries > 0, "invariant");
+    for (u4 i = 0; i < TABLE_SIZE; ++i) {
+      const JfrStackTrace* stacktrace = _table[i];
+      while (stacktrace != nullptr) {
+        if (stacktrace->should_write()) {
+          stacktrace->write(sw);
+          ++count;
+        }
+        stacktrace = stacktrace->next();
       }
-      stacktrace = next;
     }
+    if (clear) {
+      detach(detached);
+    }
+    _last_entries = _entries;
   }
   if (clear) {
-    memset(_table, 0, sizeof(_table));
-    _entries = 0;
+    purge(detached);
   }
-  _last_entries = _entries;
   return count;
 }
 
-size_t JfrStackTraceRepository::clear(JfrStackTraceRepository& repo) {
-  MutexLocker lock(JfrStacktrace_lock, Mutex::_no_safepoint_check_flag);
-  if (repo._entries == 0) {
-    return 0;
+// Unlinks all entries and invalidates the per-thread last trace caches.
+// Concurrent lookups may still be walking the detached chains until purged.
+// Purging is done outside of JfrStacktrace_lock, since write_synchronize()
+// iterates the threads list.
+void JfrStackTraceRepository::detach(JfrStackTrace** detached) {
+  assert_lock_strong(JfrStacktrace_lock);
+  for (u4 i = 0; i < TABLE_SIZE; ++i) {
+    detached[i] = _table[i];
+    Atomic::store(&_table[i], (JfrStackTrace*)nullptr);
   }
+  Atomic::inc(&_generation);
+  _entries = 0;
+}
+
+void JfrStackTraceRepository::purge(JfrStackTrace** detached) {
+  GlobalCounter::write_synchronize();
   for (u4 i = 0; i < TABLE_SIZE; ++i) {
-    JfrStackTrace* stacktrace = repo._table[i];
+    JfrStackTrace* stacktrace = detached[i];
     while (stacktrace != nullptr) {
       JfrStackTrace* next = const_cast<JfrStackTrace*>(stacktrace->next());
       delete stacktrace;
       stacktrace = next;
     }
   }
-  memset(repo._table, 0, sizeof(repo._table));
-  const size_t processed = repo._entries;
-  repo._entries = 0;
-  repo._last_entries = 0;
+  FREE_C_HEAP_ARRAY(JfrStackTrace*, detached);
+}
+
+size_t JfrStackTraceRepository::clear(JfrStackTraceRepository& repo) {
+  JfrStackTrace** const detached = NEW_C_HEAP_ARRAY(JfrStackTrace*, TABLE_SIZE, mtTracing);
+  size_t processed;
+  {
+    MutexLocker lock(JfrStacktrace_lock, Mutex::_no_safepoint_check_flag);
+    processed = repo._entries;
+    if (processed > 0) {
+      repo.detach(detached);
+      repo._last_entries = 0;
+    }
+  }
+  if (processed == 0) {
+    FREE_C_HEAP_ARRAY(JfrStackTrace*, detached);
+    return 0;
+  }
+  purge(detached);
   return processed;
 }
 
@@ -198,17 +227,49 @@ void JfrStackTraceRepository::record_for_leak_profiler(JavaThread* current_threa
   }
 }
 
+const JfrStackTrace* JfrStackTraceRepository::lookup(const JfrStackTrace& stacktrace, size_t index) const {
+  const JfrStackTrace* table_entry = Atomic::load_acquire(&_table[index]);
+  while (table_entry != nullptr) {
+    if (table_entry->equals(stacktrace)) {
+      return table_entry;
+    }
+    table_entry = table_entry->next();
+  }
+  return nullptr;
+}
+
 traceid JfrStackTraceRepository::add_trace(const JfrStackTrace& stacktrace) {
-  MutexLocker lock(JfrStacktrace_lock, Mutex::_no_safepoint_check_flag);
   assert(stacktrace._nr_of_frames > 0, "invariant");
   const size_t index = stacktrace._hash % TABLE_SIZE;
-  const JfrStackTrace* table_entry = _table[index];
-
-  while (table_entry != nullptr) {
-    if (table_entry->equals(stacktrace)) {
+  // Only the regular repository uses the per-thread cache; it must not
+  // hand out ids of leak profiler entries.
+  const bool use_thread_cache = this == _instance;
+  {
+    Thread* const thread = Thread::current();
+    GlobalCounter::CriticalSection cs(thread);
+    const u4 generation = Atomic::load(&_generation);
+    JfrThreadLocal* const tl = thread->jfr_thread_local();
+    if (use_thread_cache) {
+      // Exception and allocation sampling tend to record the same trace repeatedly.
+      const JfrStackTrace* const last = tl->last_stack_trace(generation);
+      if (last != nullptr && last->equals(stacktrace)) {
+        return last->id();
+      }
+    }
+    const JfrStackTrace* const table_entry = lookup(stacktrace, index);
+    if (table_entry != nullptr) {
+      if (use_thread_cache) {
+        tl->set_last_stack_trace(table_entry, generation);
+      }
       return table_entry->id();
     }
-    table_entry = table_entry->next();
+  }
+
+  MutexLocker lock(JfrStacktrace_lock, Mutex::_no_safepoint_check_flag);
+  // Another thread may have added the trace since the lock-free lookup.
+  const JfrStackTrace* const table_entry = lookup(stacktrace, index);
+  if (table_entry != nullptr) {
+    return table_entry->id();
   }
 
   if (!stacktrace.have_lineno()) {
@@ -216,7 +277,7 @@ traceid JfrStackTraceRepository::add_trace(const JfrStackTrace& stacktrace) {
   }
 
   traceid id = ++_next_id;
-  _table[index] = new JfrStackTrace(id, stacktrace, _table[index]);
+  Atomic::release_store(&_table[index], new JfrStackTrace(id, stacktrace, _table[index]));
   ++_entries;
   return id;
 }
@@ -224,7 +285,7 @@ traceid JfrStackTraceRepository::add_trace(const JfrStackTrace& stacktrace) {
 // invariant is that the entry to be resolved actually exists in the table
 const JfrStackTrace* JfrStackTraceRepository::lookup_for_leak_profiler(unsigned int hash, traceid id) {
   const size_t index = (hash % TABLE_SIZE);
-  const JfrStackTrace* trace = leak_profiler_instance()._table[index];
+  const JfrStackTrace* trace = Atomic::load_acquire(&leak_profiler_instance()._table[index]);
   while (trace != nullptr && trace->id() != id) {
     trace = trace->next();
   }
@@ -45,9 +45,13 @@ class JfrStackTraceRepository : public JfrCHeapObj {
 
  private:
   static const u4 TABLE_SIZE = 2053;
-  JfrStackTrace* _table[TABLE_SIZE];
+  // Insertions are serialized by JfrStacktrace_lock and publish fully built entries,
+  // so lookups can walk the buckets in a GlobalCounter critical section without the lock.
+  // Entries are only freed after a GlobalCounter::write_synchronize().
+  JfrStackTrace* volatile _table[TABLE_SIZE];
   u4 _last_entries;
   u4 _entries;
+  volatile u4 _generation;
 
   JfrStackTraceRepository();
   static JfrStackTraceRepository& instance();
@@ -59,11 +63,14 @@ class JfrStackTraceRepository : public JfrCHeapObj {
   static size_t clear();
   static size_t clear(JfrStackTraceRepository& repo);
   size_t write(JfrChunkWriter& cw, bool clear);
+  void detach(JfrStackTrace** detached);
+  static void purge(JfrStackTrace** detached);
 
   static const JfrStackTrace* lookup_for_leak_profiler(unsigned int hash, traceid id);
   static void record_for_leak_profiler(JavaThread* thread, int skip = 0);
   static void clear_leak_profiler();
 
+  const JfrStackTrace* lookup(const JfrStackTrace& stacktrace, size_t index) const;
   traceid add_trace(const JfrStackTrace& stacktrace);
   static traceid add(JfrStackTraceRepository& repo, const JfrStackTrace& stacktrace);
   static traceid add(const JfrStackTrace& stacktrace);
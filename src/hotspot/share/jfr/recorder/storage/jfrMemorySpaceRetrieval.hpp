@@ -26,6 +26,7 @@
 #define SHARE_JFR_RECORDER_STORAGE_JFRMEMORYSPACERETRIEVAL_HPP
 
 #include "jfr/utilities/jfrIterator.hpp"
+#include "utilities/globalDefinitions.hpp"
 
 /* Some policy classes for getting mspace memory. */
 
@@ -38,10 +39,39 @@ class JfrMspaceRetrieval {
       StopOnNullCondition<typename Mspace::FreeList> iterator(mspace->free_list());
       return acquire(mspace, iterator, thread, size);
     }
-    StopOnNullCondition<typename Mspace::LiveList> iterator(mspace->live_list(previous_epoch));
-    return acquire(mspace, iterator, thread, size);
+    return acquire_live(mspace, mspace->live_list(previous_epoch), thread, size);
   }
  private:
+  // Live nodes are shared by all threads. Starting every search at the head
+  // would make concurrent promotions contend on acquiring the same first nodes,
+  // so each thread starts a few nodes in, and only falls back to the nodes
+  // before its start if none after it fits.
+  static const size_t live_list_spread = 8;
+
+  static size_t live_list_start(Thread* thread) {
+    uintptr_t hash = p2i(thread);
+    hash ^= hash >> 16;
+    hash ^= hash >> 8;
+    return (size_t)((hash >> LogHeapWordSize) % live_list_spread);
+  }
+
+  template <typename List>
+  static Node* acquire_live(Mspace* mspace, List& list, Thread* thread, size_t size) {
+    const size_t start = live_list_start(thread);
+    if (start > 0) {
+      StopOnNullCondition<List> iterator(list);
+      for (size_t i = 0; i < start && iterator.has_next(); i++) {
+        iterator.next();
+      }
+      Node* const node = acquire(mspace, iterator, thread, size);
+      if (node != nullptr) {
+        return node;
+      }
+    }
+    StopOnNullCondition<List> iterator(list);
+    return acquire(mspace, iterator, thread, size);
+  }
+
   template <typename Iterator>
   static Node* acquire(Mspace* mspace, Iterator& iterator, Thread* thread, size_t size) {
     assert(mspace != nullptr, "invariant");
@@ -56,6 +56,7 @@ JfrThreadLocal::JfrThreadLocal() :
   _checkpoint_buffer_epoch_0(nullptr),
   _checkpoint_buffer_epoch_1(nullptr),
   _stackframes(nullptr),
+  _last_stack_trace(nullptr),
   _dcmd_arena(nullptr),
   _thread(),
   _vthread_id(0),
@@ -70,6 +71,7 @@ JfrThreadLocal::JfrThreadLocal() :
   _wallclock_time(os::javaTimeNanos()),
   _stack_trace_hash(0),
   _stackdepth(0),
+  _last_stack_trace_generation(0),
   _entering_suspend_flag(0),
   _critical_section(0),
   _vthread_epoch(0),
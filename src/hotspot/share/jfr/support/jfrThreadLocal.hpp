@@ -32,6 +32,7 @@ class Arena;
 class JavaThread;
 class JfrBuffer;
 class JfrStackFrame;
+class JfrStackTrace;
 class Thread;
 
 class JfrThreadLocal {
@@ -50,6 +51,7 @@ class JfrThreadLocal {
   JfrBuffer* _checkpoint_buffer_epoch_0;
   JfrBuffer* _checkpoint_buffer_epoch_1;
   mutable JfrStackFrame* _stackframes;
+  const JfrStackTrace* _last_stack_trace;
   Arena* _dcmd_arena;
   JfrBlobHandle _thread;
   mutable traceid _vthread_id;
@@ -64,6 +66,7 @@ class JfrThreadLocal {
   jlong _wallclock_time;
   unsigned int _stack_trace_hash;
   mutable u4 _stackdepth;
+  u4 _last_stack_trace_generation;
   volatile jint _entering_suspend_flag;
   mutable volatile int _critical_section;
   u2 _vthread_epoch;
@@ -209,6 +212,17 @@ class JfrThreadLocal {
     return _stack_trace_hash;
   }
 
+  // The repository entry this thread last recorded, valid only while the
+  // repository generation is unchanged.
+  const JfrStackTrace* last_stack_trace(u4 generation) const {
+    return _last_stack_trace_generation == generation ? _last_stack_trace : nullptr;
+  }
+
+  void set_last_stack_trace(const JfrStackTrace* stacktrace, u4 generation) {
+    _last_stack_trace = stacktrace;
+    _last_stack_trace_generation = generation;
+  }
+
   void set_trace_block() {
     _entering_suspend_flag = 1;
   }
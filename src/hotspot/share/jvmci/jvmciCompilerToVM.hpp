@@ -68,6 +68,11 @@ class CompilerToVM {
     static address ZBarrierSetRuntime_load_barrier_on_oop_array;
     static address ZBarrierSetRuntime_clone;
 
+    static address shenandoah_in_cset_fast_test_addr;
+    static address shenandoah_mark_bit_map_biased_addr;
+    static int shenandoah_mark_bit_map_index_shift;
+    static int shenandoah_region_size_bytes_shift;
+
     static bool continuations_enabled;
 
     static size_t ThreadLocalAllocBuffer_alignment_reserve;
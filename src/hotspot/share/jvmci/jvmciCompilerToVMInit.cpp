@@ -32,6 +32,10 @@
 #include "gc/shared/collectedHeap.hpp"
 #include "gc/shared/gc_globals.hpp"
 #include "gc/shared/tlab_globals.hpp"
+#if INCLUDE_SHENANDOAHGC
+#include "gc/shenandoah/shenandoahHeap.hpp"
+#include "gc/shenandoah/shenandoahHeapRegion.hpp"
+#endif
 #if INCLUDE_ZGC
 #include "gc/x/xBarrierSetRuntime.hpp"
 #include "gc/x/xThreadLocalData.hpp"
@@ -73,6 +77,11 @@ address CompilerToVM::Data::ZBarrierSetRuntime_weak_load_barrier_on_phantom_oop_
 address CompilerToVM::Data::ZBarrierSetRuntime_load_barrier_on_oop_array;
 address CompilerToVM::Data::ZBarrierSetRuntime_clone;
 
+address CompilerToVM::Data::shenandoah_in_cset_fast_test_addr;
+address CompilerToVM::Data::shenandoah_mark_bit_map_biased_addr;
+int CompilerToVM::Data::shenandoah_mark_bit_map_index_shift;
+int CompilerToVM::Data::shenandoah_region_size_bytes_shift;
+
 bool CompilerToVM::Data::continuations_enabled;
 
 #ifdef AARCH64
@@ -161,6 +170,17 @@ void CompilerToVM::Data::initialize(JVMCI_TRAPS) {
   }
 #endif
 
+#if INCLUDE_SHENANDOAHGC
+  if (UseShenandoahGC) {
+    // Thread-local offsets, gc state bits and the runtime entries are exported as
+    // constants and functions in vmStructs_jvmci.cpp. These depend on the heap layout.
+    shenandoah_in_cset_fast_test_addr =   ShenandoahHeap::in_cset_fast_test_addr();
+    shenandoah_mark_bit_map_biased_addr = ShenandoahHeap::mark_bit_map_biased_addr();
+    shenandoah_mark_bit_map_index_shift = ShenandoahHeap::mark_bit_map_index_shift();
+    shenandoah_region_size_bytes_shift =  (int) ShenandoahHeapRegion::region_size_bytes_shift();
+  }
+#endif
+
   continuations_enabled = Continuations::enabled();
 
   ThreadLocalAllocBuffer_alignment_reserve = ThreadLocalAllocBuffer::alignment_reserve();
@@ -197,6 +217,12 @@ void CompilerToVM::Data::initialize(JVMCI_TRAPS) {
     assert(base != nullptr, "unexpected byte_map_base");
     cardtable_start_address = base;
     cardtable_shift = CardTable::card_shift();
+#if INCLUDE_SHENANDOAHGC
+  } else if (UseShenandoahGC && ShenandoahCardBarrier) {
+    // Each thread holds its own card table base, see ShenandoahThreadLocalData::card_table_offset()
+    cardtable_start_address = 0;
+    cardtable_shift = CardTable::card_shift();
+#endif
   } else {
     // No card mark barriers
     cardtable_start_address = 0;
@@ -297,6 +323,13 @@ JVMCIObjectArray CompilerToVM::initialize_intrinsics(JVMCI_TRAPS) {
   do_bool_flag(UseParallelGC)                                              \
   do_bool_flag(UseSerialGC)                                                \
   do_bool_flag(UseZGC)                                                     \
+  do_bool_flag(UseShenandoahGC)                                            \
+  SHENANDOAHGC_ONLY(do_bool_flag(ShenandoahSATBBarrier))                   \
+  SHENANDOAHGC_ONLY(do_bool_flag(ShenandoahIUBarrier))                     \
+  SHENANDOAHGC_ONLY(do_bool_flag(ShenandoahLoadRefBarrier))                \
+  SHENANDOAHGC_ONLY(do_bool_flag(ShenandoahCASBarrier))                    \
+  SHENANDOAHGC_ONLY(do_bool_flag(ShenandoahCloneBarrier))                  \
+  SHENANDOAHGC_ONLY(do_bool_flag(ShenandoahCardBarrier))                   \
   do_bool_flag(UseEpsilonGC)                                               \
   COMPILER2_PRESENT(do_bool_flag(UseMontgomeryMultiplyIntrinsic))          \
   COMPILER2_PRESENT(do_bool_flag(UseMontgomerySquareIntrinsic))            \
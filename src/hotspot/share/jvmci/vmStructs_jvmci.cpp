@@ -44,6 +44,11 @@
 #include "gc/g1/heapRegion.hpp"
 #include "gc/g1/g1ThreadLocalData.hpp"
 #endif
+#if INCLUDE_SHENANDOAHGC
+#include "gc/shenandoah/shenandoahHeap.hpp"
+#include "gc/shenandoah/shenandoahRuntime.hpp"
+#include "gc/shenandoah/shenandoahThreadLocalData.hpp"
+#endif
 
 #define VM_STRUCTS(nonstatic_field, static_field, unchecked_nonstatic_field, volatile_nonstatic_field) \
   static_field(CompilerToVM::Data,             Klass_vtable_start_offset,              int)                                          \
@@ -74,6 +79,11 @@
   static_field(CompilerToVM::Data,             ZBarrierSetRuntime_load_barrier_on_oop_array, address)                                \
   static_field(CompilerToVM::Data,             ZBarrierSetRuntime_clone, address)                                                    \
                                                                                                                                      \
+  static_field(CompilerToVM::Data,             shenandoah_in_cset_fast_test_addr, address)                                           \
+  static_field(CompilerToVM::Data,             shenandoah_mark_bit_map_biased_addr, address)                                         \
+  static_field(CompilerToVM::Data,             shenandoah_mark_bit_map_index_shift, int)                                             \
+  static_field(CompilerToVM::Data,             shenandoah_region_size_bytes_shift, int)                                              \
+                                                                                                                                     \
   static_field(CompilerToVM::Data,             continuations_enabled, bool)                                                          \
                                                                                                                                      \
   static_field(CompilerToVM::Data,             ThreadLocalAllocBuffer_alignment_reserve, size_t)                                     \
@@ -807,6 +817,16 @@
   declare_function(JVMCIRuntime::load_and_clear_exception) \
   G1GC_ONLY(declare_function(JVMCIRuntime::write_barrier_pre)) \
   G1GC_ONLY(declare_function(JVMCIRuntime::write_barrier_post)) \
+  SHENANDOAHGC_ONLY(declare_function(ShenandoahRuntime::load_reference_barrier_strong)) \
+  SHENANDOAHGC_ONLY(declare_function(ShenandoahRuntime::load_reference_barrier_strong_narrow)) \
+  SHENANDOAHGC_ONLY(declare_function(ShenandoahRuntime::load_reference_barrier_weak)) \
+  SHENANDOAHGC_ONLY(declare_function(ShenandoahRuntime::load_reference_barrier_weak_narrow)) \
+  SHENANDOAHGC_ONLY(declare_function(ShenandoahRuntime::load_reference_barrier_phantom)) \
+  SHENANDOAHGC_ONLY(declare_function(ShenandoahRuntime::load_reference_barrier_phantom_narrow)) \
+  SHENANDOAHGC_ONLY(declare_function(ShenandoahRuntime::write_ref_field_pre_entry)) \
+  SHENANDOAHGC_ONLY(declare_function(ShenandoahRuntime::arraycopy_barrier_oop_entry)) \
+  SHENANDOAHGC_ONLY(declare_function(ShenandoahRuntime::arraycopy_barrier_narrow_oop_entry)) \
+  SHENANDOAHGC_ONLY(declare_function(ShenandoahRuntime::shenandoah_clone_barrier)) \
   declare_function(JVMCIRuntime::validate_object) \
   \
   declare_function(JVMCIRuntime::test_deoptimize_call_int)
@@ -827,6 +847,24 @@
 
 #endif // INCLUDE_G1GC
 
+#if INCLUDE_SHENANDOAHGC
+
+#define VM_INT_CONSTANTS_JVMCI_SHENANDOAHGC(declare_constant, declare_constant_with_value, declare_preprocessor_constant) \
+  declare_constant(ShenandoahHeap::HAS_FORWARDED) \
+  declare_constant(ShenandoahHeap::MARKING) \
+  declare_constant(ShenandoahHeap::EVACUATION) \
+  declare_constant(ShenandoahHeap::UPDATEREFS) \
+  declare_constant(ShenandoahHeap::WEAK_ROOTS) \
+  declare_constant(ShenandoahHeap::YOUNG_MARKING) \
+  declare_constant(ShenandoahHeap::OLD_MARKING) \
+  declare_constant_with_value("ShenandoahThreadLocalData::gc_state_offset", in_bytes(ShenandoahThreadLocalData::gc_state_offset())) \
+  declare_constant_with_value("ShenandoahThreadLocalData::satb_mark_queue_active_offset", in_bytes(ShenandoahThreadLocalData::satb_mark_queue_active_offset())) \
+  declare_constant_with_value("ShenandoahThreadLocalData::satb_mark_queue_index_offset", in_bytes(ShenandoahThreadLocalData::satb_mark_queue_index_offset())) \
+  declare_constant_with_value("ShenandoahThreadLocalData::satb_mark_queue_buffer_offset", in_bytes(ShenandoahThreadLocalData::satb_mark_queue_buffer_offset())) \
+  declare_constant_with_value("ShenandoahThreadLocalData::card_table_offset", in_bytes(ShenandoahThreadLocalData::card_table_offset()))
+
+#endif // INCLUDE_SHENANDOAHGC
+
 
 #ifdef LINUX
 
@@ -946,6 +984,11 @@ VMIntConstantEntry JVMCIVMStructs::localHotSpotVMIntConstants[] = {
                               GENERATE_VM_INT_CONSTANT_WITH_VALUE_ENTRY,
                               GENERATE_PREPROCESSOR_VM_INT_CONSTANT_ENTRY)
 #endif
+#if INCLUDE_SHENANDOAHGC
+  VM_INT_CONSTANTS_JVMCI_SHENANDOAHGC(GENERATE_VM_INT_CONSTANT_ENTRY,
+                                      GENERATE_VM_INT_CONSTANT_WITH_VALUE_ENTRY,
+                                      GENERATE_PREPROCESSOR_VM_INT_CONSTANT_ENTRY)
+#endif
 #ifdef VM_INT_CPU_FEATURE_CONSTANTS
   VM_INT_CPU_FEATURE_CONSTANTS
 #endif
@@ -72,13 +72,20 @@ void AsyncLogWriter::enqueue_locked(LogFileStreamOutput* output, const LogDecora
   // client should use "" instead.
   assert(msg != nullptr, "enqueuing a null message!");
 
+  const bool was_empty = !_data_available;
   if (!_buffer->push_back(output, decorations, msg)) {
     bool p_created;
-    uint32_t* counter = _stats.put_if_absent(output, 0, &p_created);
-    *counter = *counter + 1;
+    Dropped* dropped = _stats.put_if_absent(output, Dropped(), &p_created);
+    size_t len = strlen(msg);
+    dropped->_messages++;
+    dropped->_bytes += len;
+    _dropped_bytes += len;
     return;
   }
 
+  if (was_empty) {
+    _first_enqueue_ns = os::javaTimeNanos();
+  }
   _data_available = true;
   _lock.notify();
 }
@@ -101,7 +108,11 @@ void AsyncLogWriter::enqueue(LogFileStreamOutput& output, LogMessageBuffer::Iter
 AsyncLogWriter::AsyncLogWriter()
   : _flush_sem(0), _lock(), _data_available(false),
     _initialized(false),
-    _stats() {
+    _stats(),
+    _written_bytes(0),
+    _dropped_bytes(0),
+    _first_enqueue_ns(0),
+    _max_delay_ns(0) {
 
   size_t size = AsyncLogBufferSize / 2;
   _buffer = new Buffer(size);
@@ -117,6 +128,7 @@ AsyncLogWriter::AsyncLogWriter()
 void AsyncLogWriter::write() {
   ResourceMark rm;
   AsyncLogMap<AnyObj::RESOURCE_AREA> snapshot;
+  jlong first_enqueue_ns;
 
   // lock protection. This guarantees I/O jobs don't block logsites.
   {
@@ -126,24 +138,27 @@ void AsyncLogWriter::write() {
     swap(_buffer, _buffer_staging);
 
     // move counters to snapshot and reset them.
-    _stats.iterate([&] (LogFileStreamOutput* output, uint32_t& counter) {
-      if (counter > 0) {
-        bool created = snapshot.put(output, counter);
+    _stats.iterate([&] (LogFileStreamOutput* output, Dropped& dropped) {
+      if (dropped._messages > 0) {
+        bool created = snapshot.put(output, dropped);
         assert(created == true, "sanity check");
-        counter = 0;
+        dropped = Dropped();
       }
       return true;
     });
+    first_enqueue_ns = _first_enqueue_ns;
     _data_available = false;
   }
 
   int req = 0;
+  uint64_t written = 0;
   auto it = _buffer_staging->iterator();
   while (it.hasNext()) {
     const Message* e = it.next();
 
     if (!e->is_token()){
       e->output()->write_blocking(e->decorations(), e->message());
+      written += strlen(e->message());
     } else {
       // This is a flush token. Record that we found it and then
       // signal the flushing thread after the loop.
@@ -153,15 +168,22 @@ void AsyncLogWriter::write() {
 
   LogDecorations decorations(LogLevel::Warning, LogTagSetMapping<LogTag::__NO_TAG>::tagset(),
                              LogDecorators::All);
-  snapshot.iterate([&](LogFileStreamOutput* output, uint32_t& counter) {
-    if (counter > 0) {
+  snapshot.iterate([&](LogFileStreamOutput* output, Dropped& dropped) {
+    if (dropped._messages > 0) {
       stringStream ss;
-      ss.print(UINT32_FORMAT_W(6) " messages dropped due to async logging", counter);
+      ss.print(UINT32_FORMAT_W(6) " messages dropped due to async logging (" SIZE_FORMAT " bytes)",
+               dropped._messages, dropped._bytes);
       output->write_blocking(decorations, ss.as_string(false));
     }
     return true;
   });
 
+  {
+    AsyncLogLocker locker;
+    _written_bytes += written;
+    _max_delay_ns = MAX2(_max_delay_ns, os::javaTimeNanos() - first_enqueue_ns);
+  }
+
   if (req > 0) {
     assert(req == 1, "Only one token is allowed in queue. AsyncLogWriter::flush() is NOT MT-safe!");
     _flush_sem.signal(req);
@@ -219,6 +241,9 @@ void AsyncLogWriter::flush() {
       AsyncLogLocker locker;
       // Push directly in-case we are at logical max capacity, as this must not get dropped.
       _instance->_buffer->push_flush_token();
+      if (!_instance->_data_available) {
+        _instance->_first_enqueue_ns = os::javaTimeNanos();
+      }
       _instance->_data_available = true;
       _instance->_lock.notify();
     }
@@ -250,3 +275,18 @@ AsyncLogWriter::BufferUpdater::~BufferUpdater() {
     p->_buffer_staging = _buf2;
   }
 }
+
+void AsyncLogWriter::print_statistics(outputStream* out) {
+  if (_instance != nullptr) {
+    uint64_t written, dropped;
+    jlong max_delay_ns;
+    {
+      AsyncLogLocker locker;
+      written = _instance->_written_bytes;
+      dropped = _instance->_dropped_bytes;
+      max_delay_ns = _instance->_max_delay_ns;
+    }
+    out->print_cr("Async log writer: " UINT64_FORMAT " bytes written, " UINT64_FORMAT " bytes dropped, longest delay %.3fms",
+                  written, dropped, (double) max_delay_ns / NANOSECS_PER_MILLISEC);
+  }
+}
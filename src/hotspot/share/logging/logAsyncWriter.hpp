@@ -61,9 +61,15 @@ class AsyncLogWriter : public NonJavaThread {
   class AsyncLogLocker;
 
   // account for dropped messages
+  struct Dropped {
+    uint32_t _messages;
+    size_t _bytes;
+    Dropped() : _messages(0), _bytes(0) {}
+  };
+
   template <AnyObj::allocation_type ALLOC_TYPE>
   using AsyncLogMap = ResourceHashtable<LogFileStreamOutput*,
-                          uint32_t, 17, /*table_size*/
+                          Dropped, 17, /*table_size*/
                           ALLOC_TYPE, mtLogging>;
 
   // Messsage is the envelop of a log line and its associative data.
@@ -158,6 +164,13 @@ class AsyncLogWriter : public NonJavaThread {
   volatile bool _initialized;
   AsyncLogMap<AnyObj::C_HEAP> _stats;
 
+  // Totals since startup. Bytes count message text only. The delay is the
+  // longest time a message waited in the buffer before it was written out.
+  uint64_t _written_bytes;
+  uint64_t _dropped_bytes;
+  jlong _first_enqueue_ns;
+  jlong _max_delay_ns;
+
   // ping-pong buffers
   Buffer* _buffer;
   Buffer* _buffer_staging;
@@ -197,6 +210,9 @@ class AsyncLogWriter : public NonJavaThread {
   static AsyncLogWriter* instance();
   static void initialize();
   static void flush();
+
+  // Prints bytes written, dropped and the longest delay, if async logging is on.
+  static void print_statistics(outputStream* out);
 };
 
 #endif // SHARE_LOGGING_LOGASYNCWRITER_HPP
@@ -564,6 +564,7 @@ void LogConfiguration::describe_current_configuration(outputStream* out) {
     }
     out->cr();
   }
+  AsyncLogWriter::print_statistics(out);
 }
 
 void LogConfiguration::describe(outputStream* out) {
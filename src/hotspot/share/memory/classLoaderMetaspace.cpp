@@ -41,15 +41,17 @@
 using metaspace::ChunkManager;
 using metaspace::MetaspaceArena;
 using metaspace::ArenaGrowthPolicy;
+using metaspace::ArenaSizeHints;
 using metaspace::RunningCounters;
 using metaspace::InternalStats;
 
 #define LOGFMT         "CLMS @" PTR_FORMAT " "
 #define LOGFMT_ARGS    p2i(this)
 
-ClassLoaderMetaspace::ClassLoaderMetaspace(Mutex* lock, Metaspace::MetaspaceType space_type) :
+ClassLoaderMetaspace::ClassLoaderMetaspace(Mutex* lock, Metaspace::MetaspaceType space_type, unsigned size_hint_key) :
   _lock(lock),
   _space_type(space_type),
+  _size_hint_key(size_hint_key),
   _non_class_space_arena(nullptr),
   _class_space_arena(nullptr)
 {
@@ -63,6 +65,9 @@ ClassLoaderMetaspace::ClassLoaderMetaspace(Mutex* lock, Metaspace::MetaspaceType
       lock,
       RunningCounters::used_nonclass_counter(),
       "non-class sm");
+  if (_size_hint_key != 0) {
+    _non_class_space_arena->set_first_chunk_level(ArenaSizeHints::first_chunk_level(_size_hint_key, false));
+  }
 
   // If needed, initialize class arena
   if (Metaspace::using_class_space()) {
@@ -74,6 +79,9 @@ ClassLoaderMetaspace::ClassLoaderMetaspace(Mutex* lock, Metaspace::MetaspaceType
         lock,
         RunningCounters::used_class_counter(),
         "class sm");
+    if (_size_hint_key != 0) {
+      _class_space_arena->set_first_chunk_level(ArenaSizeHints::first_chunk_level(_size_hint_key, true));
+    }
   }
 
   UL2(debug, "born (nonclass arena: " PTR_FORMAT ", class arena: " PTR_FORMAT ".",
@@ -83,6 +91,15 @@ ClassLoaderMetaspace::ClassLoaderMetaspace(Mutex* lock, Metaspace::MetaspaceType
 ClassLoaderMetaspace::~ClassLoaderMetaspace() {
   UL(debug, "dies.");
 
+  if (_size_hint_key != 0) {
+    size_t used_nc = 0, used_c = 0;
+    usage_numbers(Metaspace::MetadataType::NonClassType, &used_nc, nullptr, nullptr);
+    if (Metaspace::using_class_space()) {
+      usage_numbers(Metaspace::MetadataType::ClassType, &used_c, nullptr, nullptr);
+    }
+    ArenaSizeHints::record(_size_hint_key, used_nc, used_c);
+  }
+
   delete _non_class_space_arena;
   delete _class_space_arena;
 
@@ -63,6 +63,9 @@ class ClassLoaderMetaspace : public CHeapObj<mtClass> {
 
   const Metaspace::MetaspaceType _space_type;
 
+  // Key into metaspace::ArenaSizeHints for the class of the owning loader, or 0.
+  const unsigned _size_hint_key;
+
   // Arena for allocations from non-class  metaspace
   //  (resp. for all allocations if -XX:-UseCompressedClassPointers).
   metaspace::MetaspaceArena* _non_class_space_arena;
@@ -77,7 +80,9 @@ class ClassLoaderMetaspace : public CHeapObj<mtClass> {
 
 public:
 
-  ClassLoaderMetaspace(Mutex* lock, Metaspace::MetaspaceType space_type);
+  // If size_hint_key is not 0, the arenas start with chunks sized after what earlier
+  // loaders with the same key used, and this loader's usage is recorded when it dies.
+  ClassLoaderMetaspace(Mutex* lock, Metaspace::MetaspaceType space_type, unsigned size_hint_key = 0);
 
   ~ClassLoaderMetaspace();
 
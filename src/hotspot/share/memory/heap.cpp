@@ -23,6 +23,7 @@
  */
 
 #include "precompiled.hpp"
+#include "logging/log.hpp"
 #include "memory/heap.hpp"
 #include "oops/oop.inline.hpp"
 #include "runtime/os.hpp"
@@ -51,6 +52,8 @@ CodeHeap::CodeHeap(const char* name, const CodeBlobType code_blob_type)
   _adapter_count                = 0;
   _full_count                   = 0;
   _fragmentation_count          = 0;
+  _huge_pages                   = false;
+  _huge_page_size               = 0;
 }
 
 // Dummy initialization of template array.
@@ -194,6 +197,9 @@ void CodeHeap::on_code_mapping(char* base, size_t size) {
   extern void linux_wrap_code(char* base, size_t size);
   linux_wrap_code(base, size);
 #endif
+  if (_huge_pages) {
+    _huge_page_size = os::request_huge_pages(base, size);
+  }
 }
 
 
@@ -219,6 +225,10 @@ bool CodeHeap::reserve(ReservedSpace rs, size_t committed_size, size_t segment_s
   }
 
   on_code_mapping(_memory.low(), _memory.committed_size());
+  if (_huge_pages) {
+    log_info(pagesize)("%s: transparent huge pages %s (" SIZE_FORMAT "K)", _name,
+                       _huge_page_size > 0 ? "requested" : "not available", _huge_page_size / K);
+  }
   _number_of_committed_segments = size_to_segments(_memory.committed_size());
   _number_of_reserved_segments  = size_to_segments(_memory.reserved_size());
   assert(_number_of_reserved_segments >= _number_of_committed_segments, "just checking");
@@ -662,7 +672,9 @@ void CodeHeap::add_to_freelist(HeapBlock* a) {
 }
 
 /**
- * Search freelist for an entry on the list with the best fit.
+ * Search freelist for an entry on the list with the best fit,
+ * or with CodeCacheFirstFit, the first one that fits. The freelist is
+ * sorted by address, so the latter packs code at the low end of the heap.
  * @return null, if no one was found
  */
 HeapBlock* CodeHeap::search_freelist(size_t length) {
@@ -690,6 +702,9 @@ HeapBlock* CodeHeap::search_freelist(size_t length) {
       found_block  = cur;
       found_prev   = prev;
       found_length = cur_length;
+      if (CodeCacheFirstFit) {
+        break;
+      }
     }
     // Next element in list
     prev = cur;
@@ -105,6 +105,8 @@ class CodeHeap : public CHeapObj<mtCode> {
   int          _adapter_count;                   // Number of adapters
   int          _full_count;                      // Number of times the code heap was full
   int          _fragmentation_count;             // #FreeBlock joins without fully initializing segment map elements.
+  bool         _huge_pages;                      // Request transparent huge pages for committed memory
+  size_t       _huge_page_size;                  // Huge page size granted by the OS, or 0
 
   enum { free_sentinel = 0xFF };
   static const int fragmentation_limit = 10000;  // defragment after that many potential fragmentations.
@@ -206,6 +208,10 @@ class CodeHeap : public CHeapObj<mtCode> {
                                                           (_code_blob_type == code_blob_type); }
   CodeBlobType code_blob_type() const            { return _code_blob_type; }
 
+  // Must be set before the heap is reserved
+  void   set_huge_pages()                        { _huge_pages = true; }
+  size_t huge_page_size() const                  { return _huge_page_size; }
+
   // Debugging / Profiling
   const char* name() const                       { return _name; }
   int         blob_count()                       { return _blob_count; }
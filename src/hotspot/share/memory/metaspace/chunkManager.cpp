@@ -251,6 +251,23 @@ void ChunkManager::return_chunk(Metachunk* c) {
   return_chunk_locked(c);
 }
 
+// See return_chunks().
+void ChunkManager::return_chunks(Metachunk* first, MemRangeCounter* counter) {
+  MutexLocker fcl(Metaspace_lock, Mutex::_no_safepoint_check_flag);
+  Metachunk* c = first;
+  while (c != nullptr) {
+    Metachunk* next = c->next();
+    counter->add(c->used_words());
+    DEBUG_ONLY(c->set_prev(nullptr);)
+    DEBUG_ONLY(c->set_next(nullptr);)
+    UL2(debug, "return chunk: " METACHUNK_FORMAT ".", METACHUNK_FORMAT_ARGS(c));
+    ASAN_POISON_MEMORY_REGION(c->base(), c->word_size() * BytesPerWord);
+    return_chunk_locked(c);
+    // c may be invalid after return_chunk_locked(c) was called. Don't access anymore.
+    c = next;
+  }
+}
+
 // See return_chunk().
 void ChunkManager::return_chunk_locked(Metachunk* c) {
   assert_lock_strong(Metaspace_lock);
@@ -373,6 +390,21 @@ void ChunkManager::purge() {
       ls.cr();
     }
   }
+  if (log_is_enabled(Info, metaspace)) {
+    // Smaller free chunks cannot be uncommitted: buddies are merged on return, so a
+    // free chunk below granule size shares its granule with chunks still in use.
+    // Report how much memory is stuck that way, since only unloading more classes
+    // can release it.
+    size_t stranded = 0;
+    for (chunklevel_t l = max_level + 1;
+         l <= chunklevel::HIGHEST_CHUNK_LEVEL;
+         l++) {
+      stranded += _chunks.calc_committed_word_size_at_level(l);
+    }
+    if (stranded > 0) {
+      UL2(info, "committed in free chunks smaller than a commit granule: " SIZE_FORMAT " words.", stranded);
+    }
+  }
   SOMETIMES(_vslist->verify_locked();)
   SOMETIMES(verify_locked();)
 }
@@ -136,6 +136,13 @@ public:
   //       calling this method.
   void return_chunk(Metachunk* c);
 
+  // Like return_chunk(), for all chunks of a list linked through their next pointers, under a
+  //  single acquisition of the Metaspace_lock. Adds the used words of the chunks to counter.
+  //  Used when an arena dies, so that arenas released in parallel contend once per arena
+  //  rather than once per chunk.
+  // !! Note: as with return_chunk(), do not access the chunks after this function returns.
+  void return_chunks(Metachunk* first, MemRangeCounter* counter);
+
   // Given a chunk c, which must be "in use" and must not be a root chunk, attempt to
   // enlarge it in place by claiming its trailing buddy.
   //
@@ -53,7 +53,18 @@ namespace metaspace {
 // Returns the level of the next chunk to be added, acc to growth policy.
 chunklevel_t MetaspaceArena::next_chunk_level() const {
   const int growth_step = _chunks.count();
-  return _growth_policy->get_level_at_step(growth_step);
+  const chunklevel_t level = _growth_policy->get_level_at_step(growth_step);
+  if (growth_step == 0 && _first_chunk_level != chunklevel::INVALID_CHUNK_LEVEL) {
+    // Lower level means larger chunk.
+    return MIN2(level, _first_chunk_level);
+  }
+  return level;
+}
+
+void MetaspaceArena::set_first_chunk_level(chunklevel_t level) {
+  assert(level == chunklevel::INVALID_CHUNK_LEVEL || chunklevel::is_valid_level(level), "invalid level");
+  assert(_chunks.count() == 0, "Too late, arena has chunks already");
+  _first_chunk_level = level;
 }
 
 // Given a chunk, add its remaining free committed space to the free block list.
@@ -113,6 +124,7 @@ MetaspaceArena::MetaspaceArena(ChunkManager* chunk_manager, const ArenaGrowthPol
   _lock(lock),
   _chunk_manager(chunk_manager),
   _growth_policy(growth_policy),
+  _first_chunk_level(chunklevel::INVALID_CHUNK_LEVEL),
   _chunks(),
   _fbl(nullptr),
   _total_used_words_counter(total_used_words_counter),
@@ -137,20 +149,7 @@ MetaspaceArena::~MetaspaceArena() {
 
   MutexLocker fcl(lock(), Mutex::_no_safepoint_check_flag);
   MemRangeCounter return_counter;
-
-  Metachunk* c = _chunks.first();
-  Metachunk* c2 = nullptr;
-
-  while (c) {
-    c2 = c->next();
-    return_counter.add(c->used_words());
-    DEBUG_ONLY(c->set_prev(nullptr);)
-    DEBUG_ONLY(c->set_next(nullptr);)
-    UL2(debug, "return chunk: " METACHUNK_FORMAT ".", METACHUNK_FORMAT_ARGS(c));
-    _chunk_manager->return_chunk(c);
-    // c may be invalid after return_chunk(c) was called. Don't access anymore.
-    c = c2;
-  }
+  _chunk_manager->return_chunks(_chunks.first(), &return_counter);
 
   UL2(info, "returned %d chunks, total capacity " SIZE_FORMAT " words.",
       return_counter.count(), return_counter.total_size());
@@ -91,6 +91,9 @@ class MetaspaceArena : public CHeapObj<mtClass> {
   // Reference to the growth policy to use.
   const ArenaGrowthPolicy* const _growth_policy;
 
+  // If valid, the level of the first chunk, overriding the growth policy if larger.
+  chunklevel_t _first_chunk_level;
+
   // List of chunks. Head of the list is the current chunk.
   MetachunkList _chunks;
 
@@ -170,6 +173,9 @@ public:
 
   ~MetaspaceArena();
 
+  // Start this arena with a chunk of at least the given level's size (see ArenaSizeHints).
+  void set_first_chunk_level(chunklevel_t level);
+
   // Allocate memory from Metaspace.
   // 1) Attempt to allocate from the dictionary of deallocated blocks.
   // 2) Attempt to allocate from the current chunk.
@@ -25,6 +25,8 @@
 
 #include "precompiled.hpp"
 #include "memory/metaspace/metaspaceArenaGrowthPolicy.hpp"
+#include "oops/symbol.hpp"
+#include "runtime/atomic.hpp"
 #include "utilities/globalDefinitions.hpp"
 
 namespace metaspace {
@@ -122,5 +124,41 @@ const ArenaGrowthPolicy* ArenaGrowthPolicy::policy_for_space_type(Metaspace::Met
 
 }
 
+ArenaSizeHints::Entry ArenaSizeHints::_table[ArenaSizeHints::TableSize];
+
+unsigned ArenaSizeHints::key_for(const Symbol* loader_class_name) {
+  unsigned h = 0;
+  for (int i = 0; i < loader_class_name->utf8_length(); i++) {
+    h = 31 * h + (u1)loader_class_name->char_at(i);
+  }
+  return h != 0 ? h : 1;
+}
+
+void ArenaSizeHints::record(unsigned key, size_t used_non_class_words, size_t used_class_words) {
+  assert(key != 0, "Sanity");
+  Entry* const e = &_table[key % TableSize];
+  const size_t used[2] = { used_non_class_words, used_class_words };
+  const bool known = Atomic::load(&e->_key) == key;
+  for (int i = 0; i < 2; i++) {
+    // Average with what earlier loaders of this class used, to dampen outliers.
+    const size_t words = known ? (Atomic::load(&e->_used_words[i]) + used[i]) / 2 : used[i];
+    Atomic::store(&e->_used_words[i], words);
+  }
+  Atomic::release_store(&e->_key, key);
+}
+
+chunklevel_t ArenaSizeHints::first_chunk_level(unsigned key, bool is_class) {
+  const Entry* const e = &_table[key % TableSize];
+  if (key == 0 || Atomic::load_acquire(&e->_key) != key) {
+    return chunklevel::INVALID_CHUNK_LEVEL;
+  }
+  const size_t words = Atomic::load(&e->_used_words[is_class ? 1 : 0]);
+  if (words == 0) {
+    return chunklevel::INVALID_CHUNK_LEVEL;
+  }
+  const size_t max_words = chunklevel::word_size_for_level(MaxHintLevel);
+  return chunklevel::level_fitting_word_size(MIN2(words, max_words));
+}
+
 } // namespace
 
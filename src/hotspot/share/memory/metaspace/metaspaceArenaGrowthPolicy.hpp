@@ -29,6 +29,9 @@
 #include "memory/metaspace.hpp" // For Metaspace::MetaspaceType
 #include "memory/metaspace/chunklevel.hpp"
 #include "utilities/debug.hpp"
+#include "utilities/globalDefinitions.hpp"
+
+class Symbol;
 
 namespace metaspace {
 
@@ -74,6 +77,43 @@ public:
 
 };
 
+// ArenaSizeHints remembers how much metaspace loaders of a given loader class
+// used by the time they died, so that the next loader of that class can start
+// with a chunk large enough for all of it instead of growing step by step.
+// Frameworks creating many short-lived loaders of the same class (script engines,
+// per-request proxies) thus stop churning through small chunks.
+//
+// Loader classes are identified by a hash of their name; the table is small and
+// direct-mapped, and updated without locking. Collisions and races only yield
+// a different first chunk size.
+class ArenaSizeHints : public AllStatic {
+
+  static const int TableSize = 64;
+
+  struct Entry {
+    volatile unsigned _key;
+    volatile size_t _used_words[2]; // non-class, class
+  };
+
+  static Entry _table[TableSize];
+
+  // Largest first chunk handed out because of a hint.
+  static const chunklevel_t MaxHintLevel = chunklevel::CHUNK_LEVEL_256K;
+
+public:
+
+  // Returns the key for loaders whose class has the given name; never 0.
+  static unsigned key_for(const Symbol* loader_class_name);
+
+  // Record the usage of a dying loader.
+  static void record(unsigned key, size_t used_non_class_words, size_t used_class_words);
+
+  // Returns the level of the first chunk for a new loader, or INVALID_CHUNK_LEVEL
+  // if nothing is known about loaders with this key.
+  static chunklevel_t first_chunk_level(unsigned key, bool is_class);
+
+};
+
 } // namespace metaspace
 
 #endif // SHARE_MEMORY_METASPACE_METASPACEARENAGROWTHPOLICY_HPP
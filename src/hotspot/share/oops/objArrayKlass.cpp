@@ -167,6 +167,31 @@ objArrayOop ObjArrayKlass::allocate(int length, TRAPS) {
                                                        /* do_zero */ true, THREAD);
 }
 
+// Fills the elements of h_array from index on with zeroed ld_klass arrays like sub_array,
+// carved from the TLAB of the thread without safepointing. Returns the first index left
+// unfilled once the TLAB is exhausted.
+static int allocate_leaf_arrays(objArrayHandle h_array, int index, oop sub_array, JavaThread* thread) {
+  Klass* ld_klass = sub_array->klass();
+  size_t size = sub_array->size();
+  int sub_length = arrayOop(sub_array)->length();
+  const int batch_size = 64;
+  oop batch[batch_size];
+  int length = h_array->length();
+  while (index < length) {
+    size_t count = MIN2(length - index, batch_size);
+    size_t allocated = Universe::heap()->array_allocate_in_tlab(ld_klass, size, sub_length,
+                                                                batch, count, thread);
+    for (size_t i = 0; i < allocated; i++) {
+      h_array->obj_at_put(index++, batch[i]);
+    }
+    if (allocated < count) {
+      // The TLAB is exhausted, the regular path refills it.
+      break;
+    }
+  }
+  return index;
+}
+
 oop ObjArrayKlass::multi_allocate(int rank, jint* sizes, TRAPS) {
   int length = *sizes;
   // Call to lower_dimension uses this pointer, so most be called before a
@@ -177,10 +202,16 @@ oop ObjArrayKlass::multi_allocate(int rank, jint* sizes, TRAPS) {
   objArrayHandle h_array (THREAD, array);
   if (rank > 1) {
     if (length != 0) {
-      for (int index = 0; index < length; index++) {
+      int index = 0;
+      while (index < length) {
         ArrayKlass* ak = ArrayKlass::cast(ld_klass);
         oop sub_array = ak->multi_allocate(rank-1, &sizes[1], CHECK_NULL);
-        h_array->obj_at_put(index, sub_array);
+        h_array->obj_at_put(index++, sub_array);
+        if (rank == 2) {
+          // The leaf arrays are all the same, and the first one checked the length:
+          // carve as many of the rest as fit from the TLAB at once.
+          index = allocate_leaf_arrays(h_array, index, sub_array, THREAD);
+        }
       }
     } else {
       // Since this array dimension has zero length, nothing will be
@@ -1586,6 +1586,9 @@ void PhaseBlockLayout::find_edges() {
       // We see a merge point, so stop search for the next block
       if (n->num_preds() != 1) break;
 
+      // Or the start of uncommon code
+      if (splits_cold(b, n)) break;
+
       i++;
       assert(n == _cfg.get_block(i), "expecting next block");
       tr->append(n);
@@ -1658,6 +1661,8 @@ void PhaseBlockLayout::grow_traces() {
     Block *src_block = e->from();
     Block *targ_block = e->to();
 
+    if (splits_cold(src_block, targ_block)) continue;
+
     // Don't grow traces along backedges?
     if (!BlockLayoutRotateLoops) {
       if (targ_block->_rpo <= src_block->_rpo) {
@@ -1701,6 +1706,8 @@ void PhaseBlockLayout::merge_traces(bool fall_thru_only) {
       if (e->infrequent()) continue;
     }
 
+    if (splits_cold(e->from(), e->to())) continue;
+
     Block *src_block = e->from();
     Trace *src_trace = trace(src_block);
     bool src_at_tail = src_trace->last_block() == src_block;
@@ -1783,6 +1790,32 @@ void PhaseBlockLayout::reorder_traces(int count) {
   // Sort the new trace list by frequency
   qsort(new_traces + 1, new_count - 1, sizeof(new_traces[0]), trace_frequency_order);
 
+  // Move uncommon traces after all frequent ones, but before the trace of
+  // connector blocks, keeping their order.
+  if (BlockLayoutSplitCold) {
+    Trace** cold_traces = NEW_RESOURCE_ARRAY(Trace*, new_count);
+    int hot_count = 1;
+    int cold_count = 0;
+    for (int i = 1; i < new_count; i++) {
+      Trace* tr = new_traces[i];
+      if (is_cold(tr->first_block()) && !tr->first_block()->is_connector()) {
+        cold_traces[cold_count++] = tr;
+      } else {
+        new_traces[hot_count++] = tr;
+      }
+    }
+    if (cold_count > 0) {
+      if (hot_count > 1 && new_traces[hot_count - 1]->first_block()->is_connector()) {
+        // The connector trace stays last
+        new_traces[new_count - 1] = new_traces[hot_count - 1];
+        hot_count--;
+      }
+      for (int i = 0; i < cold_count; i++) {
+        new_traces[hot_count + i] = cold_traces[i];
+      }
+    }
+  }
+
   // Collect all blocks from existing Traces
   _cfg.clear_blocks();
   for (int i = 0; i < new_count; i++) {
@@ -1810,6 +1843,14 @@ PhaseBlockLayout::PhaseBlockLayout(PhaseCFG &cfg)
   memset(next,   0, size*sizeof(Block*));
   prev = NEW_RESOURCE_ARRAY(Block*, size);
   memset(prev  , 0, size*sizeof(Block*));
+  cold = NEW_RESOURCE_ARRAY(bool, size);
+  memset(cold  , 0, size*sizeof(bool));
+  if (BlockLayoutSplitCold) {
+    for (uint i = 0; i < _cfg.number_of_blocks(); i++) {
+      Block* b = _cfg.get_block(i);
+      cold[b->_pre_order] = !b->is_connector() && _cfg.is_uncommon(b);
+    }
+  }
 
   // List of edges
   edges = new GrowableArray<CFGEdge*>;
@@ -896,12 +896,19 @@ class PhaseBlockLayout : public Phase {
   Trace **traces;
   Block **next;
   Block **prev;
+  bool *cold;                   // Uncommon blocks, by pre-order
   UnionFind *uf;
 
   // Given a block, find its encompassing Trace
   Trace * trace(Block *b) {
     return traces[uf->Find_compress(b->_pre_order)];
   }
+
+  // Frequent and uncommon blocks are not put in the same trace
+  bool is_cold(const Block* b) const { return cold[b->_pre_order]; }
+  bool splits_cold(const Block* from, const Block* to) const {
+    return is_cold(from) != is_cold(to);
+  }
  public:
   PhaseBlockLayout(PhaseCFG &cfg);
 
@@ -344,6 +344,11 @@
   product(bool, SuperWordReductions, true,                                  \
           "Enable reductions support in superword.")                        \
                                                                             \
+  product(intx, SuperWordReductionAccumulators, 4,                          \
+          "Maximum number of independent vector accumulators a reduction "  \
+          "moved out of the loop is split over.")                           \
+          range(1, 16)                                                      \
+                                                                            \
   product(bool, UseCMoveUnconditionally, false,                             \
           "Use CMove (scalar and vector) ignoring profitability test.")     \
                                                                             \
@@ -489,6 +494,20 @@
   product(bool, EliminateAllocations, true,                                 \
           "Use escape analysis to eliminate allocations")                   \
                                                                             \
+  product(bool, ReduceAllocationMerges, true, DIAGNOSTIC,                   \
+          "Split field loads from phis of allocations, so that escape "     \
+          "analysis does not see the allocations escape through the phi")   \
+                                                                            \
+  product(bool, TrapColdEscapingCalls, false, EXPERIMENTAL,                 \
+          "Replace cold call sites that are not inlined and take an "       \
+          "allocation of the compiled method as argument by an uncommon "   \
+          "trap, so that the allocation may still be eliminated")           \
+                                                                            \
+  product(double, ColdEscapingCallFrequency, 0.001, EXPERIMENTAL,           \
+          "Maximum ratio of call site to method invocations for "           \
+          "TrapColdEscapingCalls")                                          \
+          range(0.0, 1.0)                                                   \
+                                                                            \
   notproduct(bool, PrintEliminateAllocations, false,                        \
           "Print out when allocations are eliminated")                      \
                                                                             \
@@ -538,6 +557,10 @@
   product(bool, BlockLayoutRotateLoops, true,                               \
           "Allow back branches to be fall throughs in the block layout")    \
                                                                             \
+  product(bool, BlockLayoutSplitCold, true,                                 \
+          "Keep uncommon blocks out of the traces of frequent blocks, and " \
+          "lay them out after all frequent code")                           \
+                                                                            \
   product(bool, InlineReflectionGetCallerClass, true, DIAGNOSTIC,           \
           "inline sun.reflect.Reflection.getCallerClass(), known to be "    \
           "part of base library DLL")                                       \
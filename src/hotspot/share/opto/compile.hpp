@@ -931,6 +931,7 @@ class Compile : public Phase {
   bool should_delay_boxing_inlining(ciMethod* call_method, JVMState* jvms);
   bool should_delay_vector_inlining(ciMethod* call_method, JVMState* jvms);
   bool should_delay_vector_reboxing_inlining(ciMethod* call_method, JVMState* jvms);
+  bool should_trap_cold_escape(JVMState* jvms, const ciCallProfile& profile);
 
   // Helper functions to identify inlining potential at call-site
   ciMethod* optimize_virtual_call(ciMethod* caller, ciInstanceKlass* klass,
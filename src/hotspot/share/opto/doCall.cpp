@@ -356,6 +356,17 @@ CallGenerator* Compile::call_generator(ciMethod* callee, int vtable_index, bool
   } // allow_inline
 
   // There was no special inlining tactic, or it bailed out.
+  // An allocation passed to the call escapes, even if the call is almost
+  // never made. Deoptimize there instead, the object is then materialized
+  // only when the call is actually reached.
+  if (should_trap_cold_escape(jvms, profile)) {
+    if (C->print_inlining()) {
+      print_inlining(callee, jvms->depth() - 1, jvms->bci(), "cold call with escaping allocation");
+    }
+    return CallGenerator::for_uncommon_trap(callee, Deoptimization::Reason_unreached,
+                                            Deoptimization::Action_reinterpret);
+  }
+
   // Use a more generic tactic, like a simple call.
   if (call_does_dispatch) {
     const char* msg = "virtual call";
@@ -451,6 +462,35 @@ bool Compile::should_delay_vector_reboxing_inlining(ciMethod* call_method, JVMSt
   return EnableVectorSupport && (call_method->intrinsic_id() == vmIntrinsics::_VectorRebox);
 }
 
+// Return true for a cold, not inlined call site that takes an object
+// allocated in this compilation as argument, which would make it escape.
+bool Compile::should_trap_cold_escape(JVMState* jvms, const ciCallProfile& profile) {
+  if (!TrapColdEscapingCalls || !DoEscapeAnalysis || !EliminateAllocations ||
+      inlining_incrementally() || jvms->map() == nullptr) {
+    return false;
+  }
+  ciMethod* caller = jvms->method();
+  int invoke_count = caller->interpreter_invocation_count();
+  if (invoke_count <= 0 || profile.count() < 0) {
+    return false;
+  }
+  double freq = (double)caller->scale_count(profile.count()) / (double)invoke_count;
+  if (freq > ColdEscapingCallFrequency ||
+      too_many_traps(caller, jvms->bci(), Deoptimization::Reason_unreached)) {
+    return false;
+  }
+  // Use the call site signature, as the uncommon trap does.
+  int nargs = caller->get_method_at_bci(jvms->bci())->arg_size();
+  for (int i = 0; i < nargs; i++) {
+    Node* arg = jvms->map()->argument(jvms, i);
+    if (arg->bottom_type()->isa_oopptr() != nullptr &&
+        AllocateNode::Ideal_allocation(arg, initial_gvn()) != nullptr) {
+      return true;
+    }
+  }
+  return false;
+}
+
 // uncommon-trap call-sites where callee is unloaded, uninitialized or will not link
 bool Parse::can_not_compile_call_site(ciMethod *dest_method, ciInstanceKlass* klass) {
   // Additional inputs to consider...
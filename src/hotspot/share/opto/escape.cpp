@@ -95,6 +95,10 @@ void ConnectionGraph::do_analysis(Compile *C, PhaseIterGVN *igvn) {
   Compile::TracePhase tp("escapeAnalysis", &Phase::timers[Phase::_t_escapeAnalysis]);
   ResourceMark rm;
 
+  if (ReduceAllocationMerges) {
+    reduce_allocation_merges(C, igvn);
+  }
+
   // Add ConP and ConN null oop nodes before ConnectionGraph construction
   // to create space for them in ConnectionGraph::_nodes[].
   Node* oop_null = igvn->zerocon(T_OBJECT);
@@ -118,6 +122,107 @@ void ConnectionGraph::do_analysis(Compile *C, PhaseIterGVN *igvn) {
   }
 }
 
+// A phi of allocations, as in "p = cond ? new P(a) : new P(b)", makes
+// all of them escape to the phi. When the phi is only used to load
+// fields, each load is split into a phi of loads from the allocations,
+// with the memory state of the corresponding path. The original phi
+// becomes dead and the allocations may be scalar replaced.
+void ConnectionGraph::reduce_allocation_merges(Compile* C, PhaseIterGVN* igvn) {
+  Unique_Node_List phis;
+  for (int i = 0; i < C->macro_count(); i++) {
+    Node* n = C->macro_node(i);
+    if (!n->is_Allocate() || n->is_AllocateArray()) {
+      continue;
+    }
+    Node* res = n->as_Allocate()->result_cast();
+    if (res == nullptr) {
+      continue;
+    }
+    for (DUIterator_Fast jmax, j = res->fast_outs(jmax); j < jmax; j++) {
+      Node* use = res->fast_out(j);
+      if (use->is_Phi() && can_reduce_allocation_merge(use->as_Phi(), igvn)) {
+        phis.push(use);
+      }
+    }
+  }
+  for (uint i = 0; i < phis.size(); i++) {
+    reduce_allocation_merge(phis.at(i)->as_Phi(), igvn);
+  }
+}
+
+bool ConnectionGraph::can_reduce_allocation_merge(PhiNode* phi, PhaseIterGVN* igvn) {
+  Node* region = phi->region();
+  if (region == nullptr || region->is_Loop() || phi->type()->isa_instptr() == nullptr) {
+    return false;
+  }
+  // Every input is the result of an instance allocation of the same class.
+  ciKlass* klass = nullptr;
+  for (uint i = 1; i < phi->req(); i++) {
+    Node* in = phi->in(i);
+    if (in == nullptr || region->in(i) == nullptr || igvn->type(region->in(i)) == Type::TOP) {
+      return false;
+    }
+    AllocateNode* alloc = AllocateNode::Ideal_allocation(in, igvn);
+    if (alloc == nullptr || alloc->is_AllocateArray() || alloc->result_cast() != in) {
+      return false;
+    }
+    ciKlass* k = igvn->type(in)->is_instptr()->instance_klass();
+    if (klass != nullptr && k != klass) {
+      return false;
+    }
+    klass = k;
+  }
+  // Every use loads a field, with a memory state from each path.
+  for (DUIterator_Fast imax, i = phi->fast_outs(imax); i < imax; i++) {
+    Node* addp = phi->fast_out(i);
+    if (!addp->is_AddP() || addp->in(AddPNode::Base) != phi || addp->in(AddPNode::Address) != phi ||
+        igvn->find_intptr_t_con(addp->in(AddPNode::Offset), Type::OffsetBot) == Type::OffsetBot) {
+      return false;
+    }
+    for (DUIterator_Fast jmax, j = addp->fast_outs(jmax); j < jmax; j++) {
+      Node* use = addp->fast_out(j);
+      if (!use->is_Load() || use->in(MemNode::Address) != addp || use->req() > 3) {
+        return false;
+      }
+      Node* mem = use->in(MemNode::Memory);
+      if (!(mem->is_Phi() && mem->in(0) == region) && !MemNode::all_controls_dominate(mem, region)) {
+        return false;
+      }
+    }
+  }
+  return phi->outcnt() > 0;
+}
+
+void ConnectionGraph::reduce_allocation_merge(PhiNode* phi, PhaseIterGVN* igvn) {
+  Node* region = phi->region();
+  Node_List loads;
+  for (DUIterator_Fast imax, i = phi->fast_outs(imax); i < imax; i++) {
+    Node* addp = phi->fast_out(i);
+    for (DUIterator_Fast jmax, j = addp->fast_outs(jmax); j < jmax; j++) {
+      loads.push(addp->fast_out(j));
+    }
+  }
+  for (uint k = 0; k < loads.size(); k++) {
+    Node* load = loads.at(k);
+    Node* mem = load->in(MemNode::Memory);
+    Node* offset = load->in(MemNode::Address)->in(AddPNode::Offset);
+    PhiNode* value_phi = new PhiNode(region, load->bottom_type());
+    for (uint i = 1; i < region->req(); i++) {
+      Node* base = phi->in(i);
+      Node* x = load->clone();
+      // The field of a new object can be loaded anywhere on its path.
+      x->set_req(0, nullptr);
+      if (mem->is_Phi() && mem->in(0) == region) {
+        x->set_req(MemNode::Memory, mem->in(i));
+      }
+      x->set_req(MemNode::Address, igvn->transform(new AddPNode(base, base, offset)));
+      value_phi->init_req(i, igvn->transform(x));
+    }
+    igvn->replace_node(load, igvn->transform(value_phi));
+  }
+  assert(phi->outcnt() == 0 || phi->is_top(), "phi only had field loads as uses");
+}
+
 bool ConnectionGraph::compute_escape() {
   Compile* C = _compile;
   PhaseGVN* igvn = _igvn;
@@ -596,6 +596,12 @@ private:
   const char* trace_merged_message(PointsToNode* other) const;
 #endif
 
+  // Split the field loads from phis which only merge allocations
+  // through the phis, so that the phis do not make them escape.
+  static void reduce_allocation_merges(Compile* C, PhaseIterGVN* igvn);
+  static bool can_reduce_allocation_merge(PhiNode* phi, PhaseIterGVN* igvn);
+  static void reduce_allocation_merge(PhiNode* phi, PhaseIterGVN* igvn);
+
 public:
   ConnectionGraph(Compile *C, PhaseIterGVN *igvn, int iteration);
 
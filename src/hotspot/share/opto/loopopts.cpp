@@ -4194,6 +4194,13 @@ bool PhaseIdealLoop::duplicate_loop_backedge(IdealLoopTree *loop, Node_List &old
 // after the loop, and also reduce the init value into it.
 // We can not do this with all reductions. Some reductions do not allow the
 // reordering of operations (for example float addition).
+//
+// When the loop was unrolled into several vectors, the vector_accumulators
+// still form a single chain through (v), and each waits for the latency of
+// the previous one. Up to SuperWordReductionAccumulators independent phis
+// are used instead, the chain elements are assigned to them round-robin,
+// and their values are combined element wise after the loop, before the
+// UnorderedReduction.
 void PhaseIdealLoop::move_unordered_reduction_out_of_loop(IdealLoopTree* loop) {
   assert(!C->major_progress() && loop->is_counted() && loop->is_innermost(), "sanity");
 
@@ -4303,40 +4310,53 @@ void PhaseIdealLoop::move_unordered_reduction_out_of_loop(IdealLoopTree* loop) {
     phi->as_Type()->set_type(vec_t);
     _igvn.set_type(phi, vec_t);
 
-    // Traverse down the chain of UnorderedReductions, and replace them with vector_accumulators.
-    current = first_ur;
-    while (true) {
-      // Create vector_accumulator to replace current.
-      Node* last_vector_accumulator = current->in(1);
-      Node* vector_input            = current->in(2);
-      VectorNode* vector_accumulator = VectorNode::make(vopc, last_vector_accumulator, vector_input, vec_t);
+    // Collect the chain of UnorderedReductions, from first_ur down to last_ur.
+    Node_List chain;
+    for (current = first_ur; current != last_ur; current = current->unique_out()->as_UnorderedReduction()) {
+      chain.push(current);
+    }
+    chain.push(last_ur);
+
+    // One vector phi per accumulator, (v) being the first.
+    const uint num_accumulators = MIN2((uint)SuperWordReductionAccumulators, chain.size());
+    Node_List phis;
+    Node_List accumulators;
+    phis.push(phi);
+    accumulators.push(phi);
+    for (uint k = 1; k < num_accumulators; k++) {
+      PhiNode* accumulator_phi = PhiNode::make(cl, identity_vector, vec_t);
+      register_new_node(accumulator_phi, cl);
+      phis.push(accumulator_phi);
+      accumulators.push(accumulator_phi);
+    }
+
+    // Create a vector_accumulator for every UnorderedReduction, round-robin over the phis.
+    for (uint i = 0; i < chain.size(); i++) {
+      const uint k = i % num_accumulators;
+      Node* vector_input = chain.at(i)->in(2);
+      VectorNode* vector_accumulator = VectorNode::make(vopc, accumulators.at(k), vector_input, vec_t);
       register_new_node(vector_accumulator, cl);
-      _igvn.replace_node(current, vector_accumulator);
       VectorNode::trace_new_vector(vector_accumulator, "UnorderedReduction");
-      if (current == last_ur) {
-        break;
-      }
-      current = vector_accumulator->unique_out()->as_UnorderedReduction();
+      accumulators.map(k, vector_accumulator);
+    }
+    for (uint k = 0; k < num_accumulators; k++) {
+      _igvn.replace_input_of(phis.at(k), LoopNode::LoopBackControl, accumulators.at(k));
     }
 
-    // Create post-loop reduction.
-    Node* last_accumulator = phi->in(2);
-    Node* post_loop_reduction = ReductionNode::make(sopc, nullptr, init, last_accumulator, bt);
-
-    // Take over uses of last_accumulator that are not in the loop.
-    for (DUIterator i = last_accumulator->outs(); last_accumulator->has_out(i); i++) {
-      Node* use = last_accumulator->out(i);
-      if (use != phi && use != post_loop_reduction) {
-        assert(ctrl_or_self(use) != cl, "use must be outside loop");
-        use->replace_edge(last_accumulator, post_loop_reduction,  &_igvn);
-        --i;
-      }
+    // All remaining uses of last_ur are outside the loop: the post-loop reduction takes them over.
+    Node* post_loop_ctrl = get_late_ctrl(last_ur, cl);
+    Node* combined = accumulators.at(0);
+    for (uint k = 1; k < num_accumulators; k++) {
+      combined = VectorNode::make(vopc, combined, accumulators.at(k), vec_t);
+      register_new_node(combined, post_loop_ctrl);
+      VectorNode::trace_new_vector(combined, "UnorderedReduction");
     }
-    register_new_node(post_loop_reduction, get_late_ctrl(post_loop_reduction, cl));
+    Node* post_loop_reduction = ReductionNode::make(sopc, nullptr, init, combined, bt);
+    register_new_node(post_loop_reduction, post_loop_ctrl);
     VectorNode::trace_new_vector(post_loop_reduction, "UnorderedReduction");
+    _igvn.replace_node(last_ur, post_loop_reduction);
 
-    assert(last_accumulator->outcnt() == 2, "last_accumulator has 2 uses: phi and post_loop_reduction");
-    assert(post_loop_reduction->outcnt() > 0, "should have taken over all non loop uses of last_accumulator");
+    assert(post_loop_reduction->outcnt() > 0, "should have taken over all non loop uses of last_ur");
     assert(phi->outcnt() == 1, "accumulator is the only use of phi");
   }
 }
@@ -1508,20 +1508,67 @@ void PhaseStringOpts::copy_latin1_string(GraphKit& kit, IdealKit& ideal, Node* s
   }
 }
 
-// Read two bytes from index and index+1 and convert them to a char
-static jchar readChar(ciTypeArray* array, int index) {
-  int shift_high, shift_low;
+// Return byte 'index' of the contents of constant src_array, encoded in the destination coder
+static jbyte constant_string_byte(ciTypeArray* src_array, bool src_is_byte, bool dst_is_byte, int index) {
+  if (dst_is_byte || !src_is_byte) {
+    return src_array->byte_at(index);
+  }
+  // Latin1 inflated to UTF16: the high byte of each char is zero
 #ifdef VM_LITTLE_ENDIAN
-    shift_high = 0;
-    shift_low = 8;
+  return (index % 2 == 0) ? src_array->byte_at(index / 2) : 0;
 #else
-    shift_high = 8;
-    shift_low = 0;
+  return (index % 2 == 0) ? 0 : src_array->byte_at(index / 2);
 #endif
+}
+
+// Store the contents of constant src_array into dst_array. Where unaligned accesses are
+// allowed, up to 8 bytes are combined into one store, instead of storing each byte or char.
+void PhaseStringOpts::store_constant_string(GraphKit& kit, IdealKit& ideal, ciTypeArray* src_array, bool src_is_byte,
+                                            bool dst_is_byte, Node* dst_array, Node* start) {
+  int length = (dst_is_byte || !src_is_byte) ? src_array->length() : 2 * src_array->length();
+  Node* index = start;
+  int i = 0;
+  while (i < length) {
+    int remaining = length - i;
+    int size;
+    if (UseUnalignedAccesses) {
+      size = (remaining >= 8) ? 8 : (remaining >= 4) ? 4 : (remaining >= 2) ? 2 : 1;
+    } else {
+      size = dst_is_byte ? 1 : 2;
+    }
 
-  jchar b1 = ((jchar) array->byte_at(index)) & 0xff;
-  jchar b2 = ((jchar) array->byte_at(index+1)) & 0xff;
-  return (b1 << shift_high) | (b2 << shift_low);
+    // Pack the bytes so that the value has them in order in memory
+    jlong val = 0;
+    for (int k = 0; k < size; k++) {
+      jlong b = constant_string_byte(src_array, src_is_byte, dst_is_byte, i + k) & 0xff;
+#ifdef VM_LITTLE_ENDIAN
+      val |= b << (8 * k);
+#else
+      val = (val << 8) | b;
+#endif
+    }
+
+    Node* adr = kit.array_element_address(dst_array, index, T_BYTE);
+    switch (size) {
+      case 8:
+        __ store(__ ctrl(), adr, kit.longcon(val), T_LONG, byte_adr_idx, MemNode::unordered,
+                 false /* require_atomic_access */, true /* mismatched */);
+        break;
+      case 4:
+        __ store(__ ctrl(), adr, __ ConI((jint) val), T_INT, byte_adr_idx, MemNode::unordered,
+                 false /* require_atomic_access */, true /* mismatched */);
+        break;
+      case 2:
+        __ store(__ ctrl(), adr, __ ConI((jchar) val), T_CHAR, byte_adr_idx, MemNode::unordered,
+                 false /* require_atomic_access */, true /* mismatched */);
+        break;
+      default:
+        __ store(__ ctrl(), adr, __ ConI((jbyte) val), T_BYTE, byte_adr_idx, MemNode::unordered);
+        break;
+    }
+    index = __ AddI(index, __ ConI(size));
+    i += size;
+  }
 }
 
 // Copy contents of constant src_array to dst_array by emitting individual stores
@@ -1535,33 +1582,15 @@ void PhaseStringOpts::copy_constant_string(GraphKit& kit, IdealKit& ideal, ciTyp
     __ if_then(dst_coder, BoolTest::eq, __ ConI(java_lang_String::CODER_LATIN1));
   }
   if (!dcon || dbyte) {
-    // Destination is Latin1. Copy each byte of src_array into dst_array.
-    Node* index = start;
-    for (int i = 0; i < length; i++) {
-      Node* adr = kit.array_element_address(dst_array, index, T_BYTE);
-      Node* val = __ ConI(src_array->byte_at(i));
-      __ store(__ ctrl(), adr, val, T_BYTE, byte_adr_idx, MemNode::unordered);
-      index = __ AddI(index, __ ConI(1));
-    }
+    // Destination is Latin1. Copy the bytes of src_array into dst_array.
+    store_constant_string(kit, ideal, src_array, src_is_byte, true /* dst_is_byte */, dst_array, start);
   }
   if (!dcon) {
     __ else_();
   }
   if (!dcon || !dbyte) {
-    // Destination is UTF16. Copy each char of src_array into dst_array.
-    Node* index = start;
-    for (int i = 0; i < length; i++) {
-      Node* adr = kit.array_element_address(dst_array, index, T_BYTE);
-      jchar val;
-      if (src_is_byte) {
-        val = src_array->byte_at(i) & 0xff;
-      } else {
-        val = readChar(src_array, i++);
-      }
-      __ store(__ ctrl(), adr, __ ConI(val), T_CHAR, byte_adr_idx, MemNode::unordered, false /* require_atomic_access */,
-               true /* mismatched */);
-      index = __ AddI(index, __ ConI(2));
-    }
+    // Destination is UTF16. Copy the chars of src_array into dst_array.
+    store_constant_string(kit, ideal, src_array, src_is_byte, false /* dst_is_byte */, dst_array, start);
     if (src_is_byte) {
       // Multiply count by two since we now need two bytes per char
       __ set(count, __ ConI(2 * length));
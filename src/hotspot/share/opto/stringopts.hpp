@@ -75,6 +75,10 @@ class PhaseStringOpts : public Phase {
   void copy_constant_string(GraphKit& kit, IdealKit& ideal, ciTypeArray* src_array, IdealVariable& count,
                             bool src_is_byte, Node* dst_array, Node* dst_coder, Node* start);
 
+  // Store the contents of constant src_array, encoded in the destination coder, into dst_array starting at start
+  void store_constant_string(GraphKit& kit, IdealKit& ideal, ciTypeArray* src_array, bool src_is_byte,
+                             bool dst_is_byte, Node* dst_array, Node* start);
+
   // Copy contents of a Latin1 encoded string from src_array to dst_array
   void copy_latin1_string(GraphKit& kit, IdealKit& ideal, Node* src_array, IdealVariable& count,
                           Node* dst_array, Node* dst_coder, Node* start);
@@ -3087,15 +3087,9 @@ Node* SuperWord::create_post_loop_vmask() {
     default: return nullptr;
   }
 
-  // Currently we can't remove this MaxVectorSize constraint. Without it,
-  // it's not guaranteed that the RCE'd post loop runs at most "vlen - 1"
-  // iterations, because the vector drain loop may not be cloned from the
-  // vectorized main loop. We should re-engineer PostLoopMultiversioning
-  // to fix this problem.
+  // The vector length is the one of the main loop, which need not use the
+  // full MaxVectorSize. The trip count is clamped to it below.
   int vlen = cl->slp_max_unroll();
-  if (unique_size * vlen != MaxVectorSize) {
-    return nullptr;
-  }
 
   // Bail out if target doesn't support mask generator or masked load/store
   if (!Matcher::match_rule_supported_vector(Op_LoadVectorMasked, vlen, vmask_bt)  ||
@@ -3109,20 +3103,27 @@ Node* SuperWord::create_post_loop_vmask() {
     return nullptr;
   }
 
-  // Create vector mask with the post loop trip count. Note there's another
-  // vector drain loop which is cloned from main loop before super-unrolling
-  // so the scalar post loop runs at most vlen-1 trips. Hence, this version
-  // only runs at most 1 iteration after vector mask transformation.
+  // Create vector mask with the post loop trip count, clamped to vlen, so
+  // that this version only runs 1 iteration after vector mask transformation.
+  // Usually there's another vector drain loop which is cloned from main loop
+  // before super-unrolling, and the scalar post loop runs at most vlen-1
+  // trips anyway. When there is none, the original scalar post loop, which
+  // follows the RCE'd one, runs the iterations left over.
   Node* trip_cnt;
   Node* new_incr;
   if (cl->stride_con() > 0) {
     trip_cnt = new SubINode(cl->limit(), cl->init_trip());
-    new_incr = new AddINode(cl->phi(), trip_cnt);
   } else {
     trip_cnt = new SubINode(cl->init_trip(), cl->limit());
-    new_incr = new SubINode(cl->phi(), trip_cnt);
   }
   _igvn.register_new_node_with_optimizer(trip_cnt);
+  trip_cnt = new MinINode(trip_cnt, _igvn.intcon(vlen));
+  _igvn.register_new_node_with_optimizer(trip_cnt);
+  if (cl->stride_con() > 0) {
+    new_incr = new AddINode(cl->phi(), trip_cnt);
+  } else {
+    new_incr = new SubINode(cl->phi(), trip_cnt);
+  }
   _igvn.register_new_node_with_optimizer(new_incr);
   _igvn.replace_node(cl->incr(), new_incr);
   Node* length = new ConvI2LNode(trip_cnt);
@@ -1033,16 +1033,27 @@ class DeoptimizeMarkedClosure : public HandshakeClosure {
 
 void Deoptimization::deoptimize_all_marked() {
   ResourceMark rm;
+  JFR_ONLY(EventBulkDeoptimization event;)
+  const bool at_safepoint = SafepointSynchronize::is_at_safepoint();
 
   // Make the dependent methods not entrant
-  CodeCache::make_marked_nmethods_deoptimized();
+  int count = CodeCache::make_marked_nmethods_deoptimized();
 
   DeoptimizeMarkedClosure deopt;
-  if (SafepointSynchronize::is_at_safepoint()) {
+  if (at_safepoint) {
     Threads::java_threads_do(&deopt);
   } else {
     Handshake::execute(&deopt);
   }
+
+  log_debug(deoptimization)("Deoptimized %d marked compiled methods%s", count, at_safepoint ? " at safepoint" : "");
+#if INCLUDE_JFR
+  if (event.should_commit()) {
+    event.set_compiledMethods(count);
+    event.set_atSafepoint(at_safepoint);
+    event.commit();
+  }
+#endif
 }
 
 Deoptimization::DeoptAction Deoptimization::_unloaded_action
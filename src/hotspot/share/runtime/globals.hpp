@@ -732,6 +732,12 @@ const int ObjectAlignmentInBytes = 8;
           "at one time (minimum is 1024).")                      \
           range(1024, max_jint)                                             \
                                                                             \
+  product(intx, MonitorDeflationScanMax, 0, DIAGNOSTIC,                     \
+          "The maximum number of in-use monitors to visit in one "          \
+          "deflation pass; the next pass resumes where this one "           \
+          "stopped. 0 visits the whole list")                               \
+          range(0, max_jint)                                                \
+                                                                            \
   product(intx, MonitorUnlinkBatch, 500, DIAGNOSTIC,                        \
           "The maximum number of monitors to unlink in one batch. ")        \
           range(1, max_jint)                                                \
@@ -1196,6 +1202,12 @@ const int ObjectAlignmentInBytes = 8;
   product_pd(bool, ProfileInterpreter,                                      \
           "Profile at the bytecode level during interpretation")            \
                                                                             \
+  product(int, ProfileInterpreterSampleRate, 1, EXPERIMENTAL,               \
+          "Record only one in this many interpreter MethodData counter "    \
+          "updates per thread, weighted by this number. 1 records all "     \
+          "updates. Only supported on x86_64")                              \
+          range(1, 1024)                                                    \
+                                                                            \
   develop_pd(bool, ProfileTraps,                                            \
           "Profile deoptimization traps at the bytecode level")             \
                                                                             \
@@ -1294,6 +1306,12 @@ const int ObjectAlignmentInBytes = 8;
           "Delay in milliseconds for option SafepointTimeout")              \
           range(0, max_intx LP64_ONLY(/MICROUNITS))                         \
                                                                             \
+  product(intx, SafepointSlowSyncThreshold, 0, DIAGNOSTIC,                  \
+          "Log the last thread to reach a safepoint, and where it "         \
+          "stopped, when reaching the safepoint took at least this many "   \
+          "milliseconds (-Xlog:safepoint). 0 disables")                     \
+          range(0, max_jint)                                                \
+                                                                            \
   product(bool, UseSystemMemoryBarrier, false,                              \
           "Try to enable system memory barrier if supported by OS")         \
                                                                             \
@@ -1538,6 +1556,11 @@ const int ObjectAlignmentInBytes = 8;
   product(bool, SegmentedCodeCache, false,                                  \
           "Use a segmented code cache")                                     \
                                                                             \
+  product(bool, NonProfiledCodeHeapHugePages, false,                        \
+          "Back the non-profiled code heap with transparent huge pages "    \
+          "where the OS allows, independent of UseLargePages. Requires "    \
+          "SegmentedCodeCache")                                             \
+                                                                            \
   product_pd(uintx, ReservedCodeCacheSize,                                  \
           "Reserved code cache size (in bytes) - maximum code cache size")  \
           constraint(VMPageSizeConstraintFunc, AtParse)                     \
@@ -1562,6 +1585,11 @@ const int ObjectAlignmentInBytes = 8;
           "Minimum number of segments in a code cache block")               \
           range(1, 100)                                                     \
                                                                             \
+  product(bool, CodeCacheFirstFit, false,                                   \
+          "Allocate code blobs from the free block with the lowest "        \
+          "address that fits instead of the best fitting one, so that "     \
+          "code stays clustered at the bottom of each code heap")           \
+                                                                            \
   notproduct(bool, ExitOnFullCodeCache, false,                              \
           "Exit the VM if we fill the code cache")                          \
                                                                             \
@@ -1980,6 +2008,12 @@ const int ObjectAlignmentInBytes = 8;
           "2: monitors & new lightweight locking (LM_LIGHTWEIGHT)")         \
           range(0, 2)                                                       \
                                                                             \
+  product(int, LightweightFastLockingSpins, 10, DIAGNOSTIC,                 \
+          "Number of exponentially backed-off retries of a contended "      \
+          "lightweight fast lock before inflating it; the total number "    \
+          "of spins is on the order of 2^value. 0 inflates at once")        \
+          range(0, 20)                                                      \
+                                                                            \
   product(uint, TrimNativeHeapInterval, 0,                                  \
           "Interval, in ms, at which the JVM will trim the native heap if " \
           "the platform supports that. Lower values will reclaim memory "   \
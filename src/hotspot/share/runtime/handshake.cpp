@@ -299,6 +299,93 @@ class VM_HandshakeAllThreads: public VM_Operation {
   VMOp_Type type() const { return VMOp_HandshakeAllThreads; }
 };
 
+class VM_HandshakeAllThreadsInBatches: public VM_Operation {
+  HandshakeBatcher* const _batcher;
+  const int _batch_size;
+  Thread* const _requester;
+ public:
+  VM_HandshakeAllThreadsInBatches(HandshakeBatcher* batcher, int batch_size, Thread* requester) :
+    _batcher(batcher), _batch_size(batch_size), _requester(requester) {}
+
+  static bool is_completed(HandshakeOperation** ops, int number_of_batches) {
+    for (int b = 0; b < number_of_batches; b++) {
+      if (!ops[b]->is_completed()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const char* cause() const { return _batcher->name(); }
+
+  bool evaluate_at_safepoint() const { return false; }
+
+  void doit() {
+    jlong start_time_ns = os::javaTimeNanos();
+
+    JavaThreadIteratorWithHandle jtiwh;
+    const int number_of_threads_issued = (int) jtiwh.length();
+    if (number_of_threads_issued < 1) {
+      log_handshake_info(start_time_ns, _batcher->name(), 0, 0, "no threads alive");
+      return;
+    }
+
+    const int number_of_batches = (number_of_threads_issued + _batch_size - 1) / _batch_size;
+    HandshakeOperation** ops = NEW_C_HEAP_ARRAY(HandshakeOperation*, number_of_batches, mtThread);
+    int idx = 0;
+    for (JavaThread* thr = jtiwh.next(); thr != nullptr; thr = jtiwh.next(), idx++) {
+      const int batch = idx / _batch_size;
+      if (idx % _batch_size == 0) {
+        ops[batch] = new HandshakeOperation(_batcher->closure_for_batch(batch), nullptr, _requester);
+      } else {
+        // Count the target before it can complete the operation.
+        ops[batch]->add_target_count(1);
+      }
+      thr->handshake_state()->add_operation(ops[batch]);
+    }
+    assert(idx == number_of_threads_issued, "must issue to all threads in the list");
+    if (UseSystemMemoryBarrier) {
+      SystemMemoryBarrier::emit();
+    }
+
+    log_trace(handshake)("Threads signaled in %d batches, begin processing blocked threads by VMThread", number_of_batches);
+    HandshakeSpinYield hsy(start_time_ns);
+    int emitted_handshakes_executed = 0;
+    do {
+      jtiwh.rewind();
+      idx = 0;
+      for (JavaThread* thr = jtiwh.next(); thr != nullptr; thr = jtiwh.next(), idx++) {
+        HandshakeOperation* op = ops[idx / _batch_size];
+        if (op->is_completed()) {
+          // Nothing left to do for this batch.
+          continue;
+        }
+        if (idx % _batch_size == 0) {
+          check_handshake_timeout(start_time_ns, op);
+        }
+        HandshakeState::ProcessResult pr = thr->handshake_state()->try_process(op);
+        hsy.add_result(pr);
+        if (pr == HandshakeState::_succeeded) {
+          emitted_handshakes_executed++;
+        }
+      }
+      hsy.process();
+    } while (!is_completed(ops, number_of_batches));
+
+    // This pairs up with the release store in do_handshake(), as for VM_HandshakeAllThreads.
+    OrderAccess::acquire();
+
+    log_handshake_info(start_time_ns, _batcher->name(), number_of_threads_issued, emitted_handshakes_executed);
+
+    for (int b = 0; b < number_of_batches; b++) {
+      delete ops[b];
+    }
+    FREE_C_HEAP_ARRAY(HandshakeOperation*, ops);
+  }
+
+  VMOp_Type type() const { return VMOp_HandshakeAllThreads; }
+};
+
 void HandshakeOperation::prepare(JavaThread* current_target, Thread* executing_thread) {
   if (current_target->is_terminated()) {
     // Will never execute any handshakes on this thread.
@@ -350,6 +437,12 @@ void Handshake::execute(HandshakeClosure* hs_cl) {
   VMThread::execute(&handshake);
 }
 
+void Handshake::execute(HandshakeBatcher* batcher, int batch_size) {
+  assert(batch_size > 0, "batches must hold threads: %d", batch_size);
+  VM_HandshakeAllThreadsInBatches handshake(batcher, batch_size, Thread::current());
+  VMThread::execute(&handshake);
+}
+
 void Handshake::execute(HandshakeClosure* hs_cl, JavaThread* target) {
   // tlh == nullptr means we rely on a ThreadsListHandle somewhere
   // in the caller's context (and we sanity check for that).
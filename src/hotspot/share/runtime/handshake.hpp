@@ -64,10 +64,25 @@ class AsyncHandshakeClosure : public HandshakeClosure {
    virtual bool is_async()          { return true; }
 };
 
+// Supplies the closures of a handshake with all threads that is issued as one
+// operation per batch of threads. Threads are assigned to batches in thread list order.
+class HandshakeBatcher : public StackObj {
+  const char* const _name;
+ public:
+  HandshakeBatcher(const char* name) : _name(name) {}
+  const char* name() const { return _name; }
+  // The closure for the threads of the given batch. It has to stay alive until
+  // the handshake has completed, and may be shared between batches.
+  virtual HandshakeClosure* closure_for_batch(int batch) = 0;
+};
+
 class Handshake : public AllStatic {
  public:
   // Execution of handshake operation
   static void execute(HandshakeClosure*       hs_cl);
+  // Execution of a handshake with all threads, in operations of up to batch_size
+  // threads each. The requester only polls threads of batches that have not completed.
+  static void execute(HandshakeBatcher*       batcher, int batch_size);
   // This version of execute() relies on a ThreadListHandle somewhere in
   // the caller's context to protect target (and we sanity check for that).
   static void execute(HandshakeClosure*       hs_cl, JavaThread* target);
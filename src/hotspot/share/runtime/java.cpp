@@ -509,6 +509,10 @@ void before_exit(JavaThread* thread, bool halt) {
   }
 #endif
 
+  if (DumpHotMethodsAtExit != nullptr) {
+    CodeCache::write_hot_methods(DumpHotMethodsAtExit);
+  }
+
   if (JvmtiExport::should_post_thread_life()) {
     JvmtiExport::post_thread_end(thread);
   }
@@ -484,6 +484,7 @@ JavaThread::JavaThread() :
 
   _jvmti_thread_state(nullptr),
   _interp_only_mode(0),
+  _profile_sample_countdown(1),
   _should_post_on_exceptions_flag(JNI_FALSE),
   _thread_stat(new ThreadStatistics()),
 
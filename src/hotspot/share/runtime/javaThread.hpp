@@ -1085,6 +1085,14 @@ private:
   void increment_interp_only_mode()         { ++_interp_only_mode; }
   void decrement_interp_only_mode()         { --_interp_only_mode; }
 
+ private:
+  // Number of interpreter profile counter updates left until the next one that is
+  // recorded (see ProfileInterpreterSampleRate).
+  int               _profile_sample_countdown;
+
+ public:
+  static ByteSize profile_sample_countdown_offset() { return byte_offset_of(JavaThread, _profile_sample_countdown); }
+
   // support for cached flag that indicates whether exceptions need to be posted for this thread
   // if this is false, we can avoid deoptimizing when events are thrown
   // this gets set to reflect whether jvmtiExport::post_exception_throw would actually do anything
@@ -1936,6 +1936,14 @@ void os::free_memory(char *addr, size_t bytes, size_t alignment_hint) {
   pd_free_memory(addr, bytes, alignment_hint);
 }
 
+bool os::free_memory_lazily(char *addr, size_t bytes) {
+  return pd_free_memory_lazily(addr, bytes);
+}
+
+size_t os::request_huge_pages(char *addr, size_t bytes) {
+  return pd_request_huge_pages(addr, bytes);
+}
+
 void os::realign_memory(char *addr, size_t bytes, size_t alignment_hint) {
   pd_realign_memory(addr, bytes, alignment_hint);
 }
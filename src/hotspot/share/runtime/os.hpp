@@ -217,6 +217,8 @@ class os: AllStatic {
                              bool allow_exec);
   static bool   pd_unmap_memory(char *addr, size_t bytes);
   static void   pd_free_memory(char *addr, size_t bytes, size_t alignment_hint);
+  static bool   pd_free_memory_lazily(char *addr, size_t bytes);
+  static size_t pd_request_huge_pages(char *addr, size_t bytes);
   static void   pd_realign_memory(char *addr, size_t bytes, size_t alignment_hint);
 
   static char*  pd_reserve_memory_special(size_t size, size_t alignment, size_t page_size,
@@ -494,6 +496,13 @@ class os: AllStatic {
                              bool allow_exec);
   static bool   unmap_memory(char *addr, size_t bytes);
   static void   free_memory(char *addr, size_t bytes, size_t alignment_hint);
+  // Tell the OS that the contents of the committed range [addr, addr + bytes) are no longer needed, so that it may
+  // reclaim the backing pages when it runs short of memory. The range stays committed and may be reused at any time
+  // without committing it again. Returns false if the platform cannot do this.
+  static bool   free_memory_lazily(char *addr, size_t bytes);
+  // Ask the OS to back the committed range [addr, addr + bytes) with transparent huge pages, independent of
+  // UseTransparentHugePages. Returns the huge page size, or 0 if the platform cannot do this.
+  static size_t request_huge_pages(char *addr, size_t bytes);
   static void   realign_memory(char *addr, size_t bytes, size_t alignment_hint);
 
   // NUMA-specific interface
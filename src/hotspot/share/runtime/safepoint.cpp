@@ -40,6 +40,7 @@
 #include "gc/shared/workerUtils.hpp"
 #include "interpreter/interpreter.hpp"
 #include "jfr/jfrEvents.hpp"
+#include "jfr/support/jfrThreadId.hpp"
 #include "logging/log.hpp"
 #include "logging/logStream.hpp"
 #include "memory/resourceArea.hpp"
@@ -56,6 +57,7 @@
 #include "runtime/mutexLocker.hpp"
 #include "runtime/orderAccess.hpp"
 #include "runtime/osThread.hpp"
+#include "runtime/registerMap.hpp"
 #include "runtime/safepoint.hpp"
 #include "runtime/safepointMechanism.inline.hpp"
 #include "runtime/signature.hpp"
@@ -67,6 +69,7 @@
 #include "runtime/threadSMR.hpp"
 #include "runtime/threadWXSetters.inline.hpp"
 #include "runtime/timerTrace.hpp"
+#include "runtime/vframe.inline.hpp"
 #include "services/runtimeService.hpp"
 #include "utilities/events.hpp"
 #include "utilities/macros.hpp"
@@ -91,16 +94,66 @@ static void post_safepoint_cleanup_event(EventSafepointCleanup& event, uint64_t
   }
 }
 
+// Where the last thread to reach a safepoint stopped: the top Java frame of a
+// thread that was late is usually just past the loop or call that kept it from
+// polling.
+class SafepointLastToArrive : public StackObj {
+  JavaThread* _thread;
+  Method*     _method;
+  int         _bci;
+  bool        _compiled;
+
+public:
+  SafepointLastToArrive(JavaThread* thread) :
+    _thread(thread), _method(nullptr), _bci(-1), _compiled(false) {
+    if (_thread != nullptr && _thread->has_last_Java_frame()) {
+      // Only metadata is read, so the frames need not be processed.
+      RegisterMap reg_map(_thread,
+                          RegisterMap::UpdateMap::skip,
+                          RegisterMap::ProcessFrames::skip,
+                          RegisterMap::WalkContinuation::skip);
+      javaVFrame* jvf = _thread->last_java_vframe(&reg_map);
+      if (jvf != nullptr) {
+        _method = jvf->method();
+        _bci = jvf->bci();
+        _compiled = jvf->is_compiled_frame();
+      }
+    }
+  }
+
+  JavaThread* thread() const { return _thread; }
+  Method* method() const     { return _method; }
+  int bci() const            { return _bci; }
+  int line_number() const    { return _method != nullptr ? _method->line_number_from_bci(_bci) : -1; }
+
+  void print_on(outputStream* st, jlong sync_ms) const {
+    st->print("Reaching safepoint took " JLONG_FORMAT " ms, last thread to arrive: \"%s\"",
+              sync_ms, _thread->name());
+    if (_method != nullptr) {
+      st->print(" in %s method %s @ bci %d (line %d)", _compiled ? "compiled" : "interpreted",
+                _method->external_name(), _bci, line_number());
+    }
+    st->cr();
+  }
+};
+
 static void post_safepoint_synchronize_event(EventSafepointStateSynchronization& event,
                                              uint64_t safepoint_id,
                                              int initial_number_of_threads,
                                              int threads_waiting_to_block,
-                                             uint64_t iterations) {
+                                             uint64_t iterations,
+                                             const SafepointLastToArrive& last) {
   if (event.should_commit()) {
     event.set_safepointId(safepoint_id);
     event.set_initialThreadCount(initial_number_of_threads);
     event.set_runningThreadCount(threads_waiting_to_block);
     event.set_iterations(iterations);
+    if (last.thread() != nullptr) {
+      event.set_lastThread(JFR_JVM_THREAD_ID(last.thread()));
+      event.set_lastMethod(last.method());
+      event.set_lastLineNumber(last.line_number());
+      event.set_lastBci(last.bci());
+    }
     event.commit();
   }
 }
@@ -215,7 +268,8 @@ static void back_off(int64_t start_time) {
   }
 }
 
-int SafepointSynchronize::synchronize_threads(jlong safepoint_limit_time, int nof_threads, int* initial_running)
+int SafepointSynchronize::synchronize_threads(jlong safepoint_limit_time, int nof_threads, int* initial_running,
+                                              JavaThread** last_to_arrive)
 {
   JavaThreadIteratorWithHandle jtiwh;
 
@@ -245,6 +299,7 @@ int SafepointSynchronize::synchronize_threads(jlong safepoint_limit_time, int no
   DEBUG_ONLY(assert_list_is_valid(tss_head, still_running);)
 
   *initial_running = still_running;
+  *last_to_arrive = nullptr;
 
   // If there is no thread still running, we are already done.
   if (still_running <= 0) {
@@ -267,6 +322,7 @@ int SafepointSynchronize::synchronize_threads(jlong safepoint_limit_time, int no
       assert(cur_tss->is_running(), "Illegal initial state");
       if (thread_not_running(cur_tss)) {
         --still_running;
+        *last_to_arrive = cur_tss->thread();
         *p_prev = nullptr;
         ThreadSafepointState *tmp = cur_tss;
         cur_tss = cur_tss->get_next();
@@ -390,7 +446,8 @@ void SafepointSynchronize::begin() {
   arm_safepoint();
 
   // Will spin until all threads are safe.
-  int iterations = synchronize_threads(safepoint_limit_time, nof_threads, &initial_running);
+  JavaThread* last_to_arrive = nullptr;
+  int iterations = synchronize_threads(safepoint_limit_time, nof_threads, &initial_running, &last_to_arrive);
   assert(_waiting_to_block == 0, "No thread should be running");
 
 #ifndef PRODUCT
@@ -432,10 +489,23 @@ void SafepointSynchronize::begin() {
   // Update the count of active JNI critical regions
   GCLocker::set_jni_lock_count(_current_jni_active_count);
 
-  post_safepoint_synchronize_event(sync_event,
-                                   _safepoint_id,
-                                   initial_running,
-                                   _waiting_to_block, iterations);
+  {
+    ResourceMark rm;
+    jlong sync_ms = (os::javaTimeNanos() - SafepointTracing::start_of_safepoint()) / (NANOUNITS / MILLIUNITS);
+    bool is_slow = SafepointSlowSyncThreshold > 0 && sync_ms >= SafepointSlowSyncThreshold;
+    SafepointLastToArrive last((is_slow || sync_event.should_commit()) ? last_to_arrive : nullptr);
+    if (is_slow && last.thread() != nullptr) {
+      LogTarget(Info, safepoint) lt;
+      if (lt.is_enabled()) {
+        LogStream ls(lt);
+        last.print_on(&ls, sync_ms);
+      }
+    }
+    post_safepoint_synchronize_event(sync_event,
+                                     _safepoint_id,
+                                     initial_running,
+                                     _waiting_to_block, iterations, last);
+  }
 
   SafepointTracing::synchronized(nof_threads, initial_running, _nof_threads_hit_polling_page);
 
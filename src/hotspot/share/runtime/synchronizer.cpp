@@ -297,6 +297,11 @@ jlong ObjectSynchronizer::_last_async_deflation_time_ns = 0;
 static uintx _no_progress_cnt = 0;
 static bool _no_progress_skip_increment = false;
 
+// Where the last deflation walk stopped early, or null if it reached the end of
+// the in-use list. Only deflation unlinks monitors, and the monitor recorded here
+// has not been deflated, so it is still on the list when the next walk starts.
+static ObjectMonitor* _deflation_cursor = nullptr;
+
 // =====================> Quick functions
 
 // The quick_* forms are special fast-path variants used to improve
@@ -493,6 +498,46 @@ static bool useHeavyMonitors() {
 #endif
 }
 
+// Try once to swing a neutral mark word into the fast-locked state.
+static bool fast_lock_try_enter(oop obj, LockStack& lock_stack) {
+  markWord mark = obj->mark_acquire();
+  if (mark.is_neutral()) {
+    assert(!lock_stack.contains(obj), "thread must not already hold the lock");
+    markWord locked_mark = mark.set_fast_locked();
+    markWord old_mark = obj->cas_set_mark(locked_mark, mark);
+    if (old_mark == mark) {
+      // Successfully fast-locked, push object to lock-stack.
+      lock_stack.push(obj);
+      return true;
+    }
+  }
+  return false;
+}
+
+// While another thread holds the lock fast-locked, retry with exponential backoff
+// before falling back to inflation. Short critical sections are often released
+// within that time, and inflating them costs a monitor and its later deflation.
+static bool fast_lock_spin_enter(oop obj, LockStack& lock_stack, JavaThread* current) {
+  const int log_spin_limit = os::is_MP() ? LightweightFastLockingSpins : 0;
+  if (log_spin_limit == 0 || lock_stack.contains(obj)) {
+    // Recursive enters always inflate, spinning does not help.
+    return false;
+  }
+  for (int i = 0; i < log_spin_limit; i++) {
+    if (obj->mark().has_monitor() || SafepointMechanism::should_process(current)) {
+      // Already inflated, or we would hold up a safepoint or handshake.
+      return false;
+    }
+    for (int spin = 1 << i; spin > 0; spin--) {
+      SpinPause();
+    }
+    if (fast_lock_try_enter(obj, lock_stack)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 // -----------------------------------------------------------------------------
 // Monitor Enter/Exit
 // The interpreter and compiler assembly code tries to lock using the fast path
@@ -511,17 +556,9 @@ void ObjectSynchronizer::enter(Handle obj, BasicLock* lock, JavaThread* current)
       // Fast-locking does not use the 'lock' argument.
       LockStack& lock_stack = current->lock_stack();
       if (lock_stack.can_push()) {
-        markWord mark = obj()->mark_acquire();
-        if (mark.is_neutral()) {
-          assert(!lock_stack.contains(obj()), "thread must not already hold the lock");
-          // Try to swing into 'fast-locked' state.
-          markWord locked_mark = mark.set_fast_locked();
-          markWord old_mark = obj()->cas_set_mark(locked_mark, mark);
-          if (old_mark == mark) {
-            // Successfully fast-locked, push object to lock-stack and return.
-            lock_stack.push(obj());
-            return;
-          }
+        if (fast_lock_try_enter(obj(), lock_stack) ||
+            fast_lock_spin_enter(obj(), lock_stack, current)) {
+          return;
         }
       }
       // All other paths fall-through to inflate-enter.
@@ -1574,15 +1611,26 @@ void ObjectSynchronizer::chk_for_block_req(JavaThread* current, const char* op_n
 // Walk the in-use list and deflate (at most MonitorDeflationMax) idle
 // ObjectMonitors. Returns the number of deflated ObjectMonitors.
 //
+// A walk that stops early, at MonitorDeflationMax deflated or at
+// MonitorDeflationScanMax visited monitors, is resumed where it stopped
+// by the next walk, so a long list is covered in bounded increments
+// instead of re-scanning its busy front every time.
+//
 size_t ObjectSynchronizer::deflate_monitor_list(Thread* current, LogStream* ls,
                                                 elapsedTimer* timer_p) {
-  MonitorList::Iterator iter = _in_use_list.iterator();
+  MonitorList::Iterator iter = _deflation_cursor != nullptr ? MonitorList::Iterator(_deflation_cursor)
+                                                            : _in_use_list.iterator();
+  _deflation_cursor = nullptr;
   size_t deflated_count = 0;
+  size_t scanned_count = 0;
 
   while (iter.has_next()) {
-    if (deflated_count >= (size_t)MonitorDeflationMax) {
+    if (deflated_count >= (size_t)MonitorDeflationMax ||
+        (MonitorDeflationScanMax > 0 && scanned_count >= (size_t)MonitorDeflationScanMax)) {
+      _deflation_cursor = iter.peek();
       break;
     }
+    scanned_count++;
     ObjectMonitor* mid = iter.next();
     if (mid->deflate_monitor()) {
       deflated_count++;
@@ -1724,11 +1772,17 @@ size_t ObjectSynchronizer::deflate_idle_monitors() {
 
   GVars.stw_random = os::random();
 
+  if (_deflation_cursor != nullptr && current->is_Java_thread()) {
+    // The walk stopped early: come back for the rest of the list right away.
+    set_is_async_deflation_requested(true);
+  }
+
   if (deflated_count != 0) {
     _no_progress_cnt = 0;
   } else if (_no_progress_skip_increment) {
     _no_progress_skip_increment = false;
-  } else {
+  } else if (_deflation_cursor == nullptr) {
+    // Only a walk of the whole list can show that deflation made no progress.
     _no_progress_cnt++;
   }
 
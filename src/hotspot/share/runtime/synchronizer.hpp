@@ -62,6 +62,7 @@ class MonitorList::Iterator {
 public:
   Iterator(ObjectMonitor* head) : _current(head) {}
   bool has_next() const { return _current != nullptr; }
+  ObjectMonitor* peek() const { return _current; }
   ObjectMonitor* next();
 };
 
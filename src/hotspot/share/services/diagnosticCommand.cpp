@@ -63,6 +63,9 @@
 #include "utilities/events.hpp"
 #include "utilities/formatBuffer.hpp"
 #include "utilities/macros.hpp"
+#if INCLUDE_SHENANDOAHGC
+#include "gc/shenandoah/shenandoahDCmd.hpp"
+#endif
 #ifdef LINUX
 #include "trimCHeapDCmd.hpp"
 #include "mallocInfoDcmd.hpp"
@@ -101,6 +104,9 @@ void DCmd::register_dcmds(){
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<SystemGCDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<RunFinalizationDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<HeapInfoDCmd>(full_export, true, false));
+#if INCLUDE_SHENANDOAHGC
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<ShenandoahStatsDCmd>(full_export, true, false));
+#endif // INCLUDE_SHENANDOAHGC
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<FinalizerInfoDCmd>(full_export, true, false));
 #if INCLUDE_SERVICES
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<HeapDumpDCmd>(DCmd_Source_Internal | DCmd_Source_AttachAPI, true, false));
@@ -505,12 +511,22 @@ ClassHistogramDCmd::ClassHistogramDCmd(outputStream* output, bool heap) :
        "1 means use one thread (disable parallelism). "
        "For any other value the VM will try to use the specified number of "
        "threads, but might use fewer.",
-       "INT", false, "0") {
+       "INT", false, "0"),
+  _snapshot("-snapshot", "Print the histogram of live objects last recorded by the GC, "
+       "without inspecting the heap, if the GC records one",
+       "BOOLEAN", false, "false") {
   _dcmdparser.add_dcmd_option(&_all);
   _dcmdparser.add_dcmd_option(&_parallel_thread_num);
+  _dcmdparser.add_dcmd_option(&_snapshot);
 }
 
 void ClassHistogramDCmd::execute(DCmdSource source, TRAPS) {
+  if (_snapshot.value()) {
+    if (!Universe::heap()->print_class_histogram_snapshot(output())) {
+      output()->print_cr("No class histogram has been recorded by the GC");
+    }
+    return;
+  }
   jlong num = _parallel_thread_num.value();
   if (num < 0) {
     output()->print_cr("Parallel thread number out of range (>=0): " JLONG_FORMAT, num);
@@ -347,8 +347,9 @@ class ClassHistogramDCmd : public DCmdWithParser {
 protected:
   DCmdArgument<bool> _all;
   DCmdArgument<jlong> _parallel_thread_num;
+  DCmdArgument<bool> _snapshot;
 public:
-  static int num_arguments() { return 2; }
+  static int num_arguments() { return 3; }
   ClassHistogramDCmd(outputStream* output, bool heap);
   static const char* name() {
     return "GC.class_histogram";
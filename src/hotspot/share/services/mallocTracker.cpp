@@ -60,6 +60,24 @@ void MemoryCounter::update_peak(size_t size, size_t cnt) {
   }
 }
 
+size_t MallocMemorySnapshot::total_count() const {
+  size_t count = 0;
+  for (int index = 0; index < mt_number_of_types; index ++) {
+    count += _malloc[index].malloc_count();
+  }
+  return count;
+}
+
+size_t MallocMemorySnapshot::total() const {
+  size_t count = 0;
+  size_t amount = 0;
+  for (int index = 0; index < mt_number_of_types; index ++) {
+    count += _malloc[index].malloc_count();
+    amount += _malloc[index].malloc_size() + _malloc[index].arena_size();
+  }
+  return amount + count * sizeof(MallocHeader);
+}
+
 // Total malloc'd memory used by arenas
 size_t MallocMemorySnapshot::total_arena() const {
   size_t amount = 0;
@@ -75,7 +93,6 @@ void MallocMemorySnapshot::make_adjustment() {
   size_t arena_size = total_arena();
   int chunk_idx = NMTUtil::flag_to_index(mtChunk);
   _malloc[chunk_idx].record_free(arena_size);
-  _all_mallocs.deallocate(arena_size);
 }
 
 void MallocMemorySummary::initialize() {
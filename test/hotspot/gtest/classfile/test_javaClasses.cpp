@@ -0,0 +1,52 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#include "precompiled.hpp"
+#include "classfile/javaClasses.hpp"
+#include "unittest.hpp"
+
+// Reference implementation of String.hashCode()
+template <typename T>
+static unsigned int reference_hash_code(const T* s, int len, unsigned int mask) {
+  unsigned int h = 0;
+  for (int i = 0; i < len; i++) {
+    h = 31 * h + (((unsigned int) s[i]) & mask);
+  }
+  return h;
+}
+
+TEST(java_lang_String, hash_code) {
+  jbyte bytes[67];
+  jchar chars[67];
+  for (int i = 0; i < 67; i++) {
+    // Include bytes with the high bit set, which must hash unsigned
+    bytes[i] = (jbyte)(i * 37 + 11);
+    chars[i] = (jchar)(i * 7919 + 3);
+  }
+  for (int len = 0; len <= 67; len++) {
+    ASSERT_EQ(java_lang_String::hash_code(bytes, len), reference_hash_code(bytes, len, 0xFF)) << "len " << len;
+    ASSERT_EQ(java_lang_String::hash_code(chars, len), reference_hash_code(chars, len, 0xFFFF)) << "len " << len;
+  }
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#include "precompiled.hpp"
+#include "gc/shenandoah/shenandoahScanRemembered.inline.hpp"
+#include "utilities/align.hpp"
+#include "unittest.hpp"
+
+// Compares the word-at-a-time search for the previous non-clean card against the byte-wise search,
+// over every end point of a card range, using ranges that start at each possible misalignment.
+class ShenandoahCardSearchTest : public ::testing::Test {
+protected:
+  static const ssize_t NumCards = 256;
+
+  // Room for the range at any misalignment of a word
+  CardValue _storage[NumCards + 2 * sizeof(uintptr_t)];
+
+  CardValue* cards(size_t misalignment) {
+    return align_up(&_storage[0], sizeof(uintptr_t)) + misalignment;
+  }
+
+  void fill_clean(CardValue* ctbm) {
+    for (ssize_t i = 0; i < NumCards; i++) {
+      ctbm[i] = CardTable::clean_card_val();
+    }
+  }
+
+  void check_all_end_points(CardValue* ctbm, ssize_t lowest) {
+    for (ssize_t cur = lowest - 1; cur < NumCards; cur++) {
+      ssize_t expected = ShenandoahDirectCardMarkRememberedSet::find_prev_non_clean_card<CardValue>(ctbm, cur, lowest);
+      ssize_t actual = ShenandoahDirectCardMarkRememberedSet::find_prev_non_clean_card<uintptr_t>(ctbm, cur, lowest);
+      ASSERT_EQ(expected, actual) << "cur = " << cur << ", lowest = " << lowest;
+    }
+  }
+};
+
+TEST_VM_F(ShenandoahCardSearchTest, all_clean) {
+  for (size_t misalignment = 0; misalignment < sizeof(uintptr_t); misalignment++) {
+    CardValue* ctbm = cards(misalignment);
+    fill_clean(ctbm);
+    for (ssize_t lowest = 0; lowest < 2 * (ssize_t) sizeof(uintptr_t); lowest++) {
+      check_all_end_points(ctbm, lowest);
+      ASSERT_EQ(lowest - 1, ShenandoahDirectCardMarkRememberedSet::find_prev_non_clean_card<uintptr_t>(ctbm, NumCards - 1, lowest));
+    }
+  }
+}
+
+TEST_VM_F(ShenandoahCardSearchTest, single_dirty_card) {
+  for (size_t misalignment = 0; misalignment < sizeof(uintptr_t); misalignment++) {
+    CardValue* ctbm = cards(misalignment);
+    for (ssize_t dirty = 0; dirty < NumCards; dirty += 3) {
+      fill_clean(ctbm);
+      ctbm[dirty] = CardTable::dirty_card_val();
+      check_all_end_points(ctbm, 0);
+      check_all_end_points(ctbm, 5);
+    }
+  }
+}
+
+TEST_VM_F(ShenandoahCardSearchTest, sparse_dirty_cards) {
+  for (size_t misalignment = 0; misalignment < sizeof(uintptr_t); misalignment++) {
+    CardValue* ctbm = cards(misalignment);
+    fill_clean(ctbm);
+    // Dirty cards with growing gaps, so that runs of clean cards span zero, one and many words
+    for (ssize_t dirty = 1, gap = 1; dirty < NumCards; gap++, dirty += gap) {
+      ctbm[dirty] = (gap % 2 == 0) ? CardTable::dirty_card_val() : (CardValue) 0x7f;
+    }
+    check_all_end_points(ctbm, 0);
+    check_all_end_points(ctbm, 3);
+  }
+}
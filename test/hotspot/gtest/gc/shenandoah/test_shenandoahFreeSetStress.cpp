@@ -0,0 +1,277 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/shared/collectedHeap.hpp"
+#include "gc/shenandoah/mode/shenandoahMode.hpp"
+#include "gc/shenandoah/shenandoahAllocRequest.hpp"
+#include "gc/shenandoah/shenandoahFreeSet.hpp"
+#include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahHeapRegion.inline.hpp"
+#include "gc/shenandoah/shenandoahNumberSeq.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/os.hpp"
+#include "runtime/timer.hpp"
+#include "threadHelper.inline.hpp"
+#include "unittest.hpp"
+#include "utilities/autoRestore.hpp"
+#include "utilities/ostream.hpp"
+
+#include <stdlib.h>
+
+// Stress harness for the free set and the heap lock.
+//
+// A number of threads allocate shared objects and TLABs through ShenandoahHeap::allocate_memory()
+// until a budget of regions is used up. Then one of them retires the allocation shards, trashes and
+// recycles the regions that were filled, and rebuilds the free set, the way a GC cycle would. This
+// repeats until the time is up. Safepoints are blocked for the duration, so no GC cycle interferes.
+//
+// The test runs in a VM of its own, and is skipped unless that VM uses Shenandoah in a single
+// generation mode. The load is shaped with environment variables:
+//
+//   SHENANDOAH_FREESET_STRESS_THREADS    allocating threads (4)
+//   SHENANDOAH_FREESET_STRESS_REGIONS    regions to fill between recycles (16)
+//   SHENANDOAH_FREESET_STRESS_MILLIS     duration of the run (250)
+//   SHENANDOAH_FREESET_STRESS_WORDS      size of shared allocations, in words (64)
+//   SHENANDOAH_FREESET_STRESS_TLAB_PCT   percentage of allocations that are TLABs (10)
+//
+// Throughput and latencies are printed when the run completes. The heap lock is taken and released
+// every few allocations: the time it takes to get it reflects how long the other threads hold it.
+
+static const size_t TLAB_WORDS = 4096;
+static const size_t LOCK_PROBE_INTERVAL = 64;
+
+static size_t stress_parameter(const char* name, size_t value) {
+  const char* v = ::getenv(name);
+  return v != nullptr ? (size_t) atol(v) : value;
+}
+
+class ShenandoahFreeSetStress {
+private:
+  const uint   _threads;
+  const size_t _regions;
+  const jlong  _millis;
+  const size_t _words;
+  const size_t _tlab_pct;
+
+  // Words left to allocate in the current round
+  volatile intptr_t _budget;
+  volatile bool     _stop;
+  volatile size_t   _failures;
+
+  volatile uint _arrived;
+  volatile uint _epoch;
+
+  bool*   _was_empty;
+  size_t* _ops;
+  HdrSeq* _alloc_latency;
+  HdrSeq* _lock_latency;
+  HdrSeq  _recycle_hold;
+  size_t  _rounds;
+  size_t  _recycled;
+
+  static double counter_to_micros(jlong counter) {
+    return TimeHelper::counter_to_millis(counter) * 1000;
+  }
+
+  void barrier() {
+    const uint epoch = Atomic::load_acquire(&_epoch);
+    if (Atomic::add(&_arrived, 1u) == _threads) {
+      Atomic::store(&_arrived, 0u);
+      Atomic::release_store(&_epoch, epoch + 1);
+    } else {
+      while (Atomic::load_acquire(&_epoch) == epoch) {
+        SpinPause();
+      }
+    }
+  }
+
+  // Remembers which regions are empty, so that exactly the regions filled in this round are recycled.
+  bool start_round() {
+    ShenandoahHeap* const heap = ShenandoahHeap::heap();
+    ShenandoahHeapLocker locker(heap->lock());
+    for (size_t i = 0; i < heap->num_regions(); i++) {
+      _was_empty[i] = heap->get_region(i)->is_empty();
+    }
+    // Stay well clear of running out of memory: an allocation failure would wait for a GC that cannot run.
+    const size_t free_regions = heap->free_set()->available() / ShenandoahHeapRegion::region_size_bytes();
+    const size_t regions = MIN2(_regions, free_regions / 2);
+    Atomic::store(&_budget, (intptr_t) (regions * ShenandoahHeapRegion::region_size_words()));
+    return regions > 0;
+  }
+
+  void allocate(uint id) {
+    ShenandoahHeap* const heap = ShenandoahHeap::heap();
+    const size_t tlab_words = MIN2(TLAB_WORDS, ShenandoahHeapRegion::max_tlab_size_words());
+    const size_t shared_words = clamp(_words, CollectedHeap::min_fill_size(), ShenandoahHeapRegion::humongous_threshold_words());
+    for (size_t n = 0; ; n++) {
+      const bool tlab = ((n * 37) % 100) < _tlab_pct;
+      const size_t words = tlab ? tlab_words : shared_words;
+      if (Atomic::sub(&_budget, (intptr_t) words) < 0) {
+        return;
+      }
+
+      ShenandoahAllocRequest req = tlab ? ShenandoahAllocRequest::for_tlab(words, words) :
+                                          ShenandoahAllocRequest::for_shared(words);
+      const jlong start = os::elapsed_counter();
+      HeapWord* const mem = heap->allocate_memory(req);
+      _alloc_latency[id].add(counter_to_micros(os::elapsed_counter() - start));
+      if (mem == nullptr) {
+        Atomic::inc(&_failures);
+        return;
+      }
+      // Keep the regions parsable
+      CollectedHeap::fill_with_objects(mem, req.actual_size());
+      _ops[id]++;
+
+      if (n % LOCK_PROBE_INTERVAL == 0) {
+        const jlong probe = os::elapsed_counter();
+        ShenandoahHeapLocker locker(heap->lock(), true);
+        _lock_latency[id].add(counter_to_micros(os::elapsed_counter() - probe));
+      }
+    }
+  }
+
+  // Retires the allocation shards, recycles the regions filled in this round and rebuilds the free set.
+  void recycle() {
+    ShenandoahHeap* const heap = ShenandoahHeap::heap();
+    ShenandoahFreeSet* const free_set = heap->free_set();
+    ShenandoahHeapLocker locker(heap->lock());
+    const jlong start = os::elapsed_counter();
+
+    free_set->clear();
+    for (size_t i = 0; i < heap->num_regions(); i++) {
+      ShenandoahHeapRegion* const r = heap->get_region(i);
+      if (_was_empty[i] && r->is_regular() && r->used() > 0) {
+        r->make_trash();
+        r->recycle();
+        _recycled++;
+      }
+    }
+
+    size_t young_cset_regions, old_cset_regions, first_old_region, last_old_region, old_region_count;
+    free_set->prepare_to_rebuild(young_cset_regions, old_cset_regions, first_old_region, last_old_region, old_region_count);
+    free_set->rebuild(young_cset_regions, old_cset_regions);
+
+    _recycle_hold.add(counter_to_micros(os::elapsed_counter() - start));
+    _rounds++;
+  }
+
+public:
+  ShenandoahFreeSetStress() :
+    _threads((uint) MAX2(stress_parameter("SHENANDOAH_FREESET_STRESS_THREADS", 4), (size_t) 1)),
+    _regions(stress_parameter("SHENANDOAH_FREESET_STRESS_REGIONS", 16)),
+    _millis((jlong) stress_parameter("SHENANDOAH_FREESET_STRESS_MILLIS", 250)),
+    _words(stress_parameter("SHENANDOAH_FREESET_STRESS_WORDS", 64)),
+    _tlab_pct(MIN2(stress_parameter("SHENANDOAH_FREESET_STRESS_TLAB_PCT", 10), (size_t) 100)),
+    _budget(0),
+    _stop(false),
+    _failures(0),
+    _arrived(0),
+    _epoch(0),
+    _was_empty(NEW_C_HEAP_ARRAY(bool, ShenandoahHeap::heap()->num_regions(), mtGC)),
+    _ops(NEW_C_HEAP_ARRAY(size_t, _threads, mtGC)),
+    _alloc_latency(new HdrSeq[_threads]),
+    _lock_latency(new HdrSeq[_threads]),
+    _rounds(0),
+    _recycled(0) {
+    for (uint i = 0; i < _threads; i++) {
+      _ops[i] = 0;
+    }
+  }
+
+  ~ShenandoahFreeSetStress() {
+    FREE_C_HEAP_ARRAY(bool, _was_empty);
+    FREE_C_HEAP_ARRAY(size_t, _ops);
+    delete[] _alloc_latency;
+    delete[] _lock_latency;
+  }
+
+  uint threads() const    { return _threads; }
+  size_t rounds() const   { return _rounds; }
+  size_t failures() const { return Atomic::load(&_failures); }
+
+  // Body of each of the allocating threads. Thread 0 also prepares and recycles each round.
+  void run(uint id) {
+    const jlong deadline = os::javaTimeMillis() + _millis;
+    while (true) {
+      if (id == 0) {
+        Atomic::store(&_stop, os::javaTimeMillis() >= deadline || !start_round());
+      }
+      barrier();
+      if (Atomic::load(&_stop)) {
+        return;
+      }
+      allocate(id);
+      barrier();
+      if (id == 0) {
+        recycle();
+      }
+    }
+  }
+
+  void print_on(outputStream* out, double seconds) const {
+    HdrSeq alloc_latency;
+    HdrSeq lock_latency;
+    size_t ops = 0;
+    for (uint i = 0; i < _threads; i++) {
+      ops += _ops[i];
+      alloc_latency.add(_alloc_latency[i]);
+      lock_latency.add(_lock_latency[i]);
+    }
+    out->print_cr("Free set stress: %u threads, " SIZE_FORMAT " regions per round, " SIZE_FORMAT " rounds, "
+                  SIZE_FORMAT " regions recycled, " SIZE_FORMAT " failures",
+                  _threads, _regions, _rounds, _recycled, failures());
+    out->print_cr("  Allocations: " SIZE_FORMAT " in %.3fs, %.0f/s", ops, seconds, ops / MAX2(seconds, 1e-9));
+    out->print_cr("  Allocation latency (us): p50 = %.2f, p99 = %.2f, max = %.2f",
+                  alloc_latency.percentile(50), alloc_latency.percentile(99), alloc_latency.maximum());
+    out->print_cr("  Heap lock wait (us): p50 = %.2f, p99 = %.2f, max = %.2f",
+                  lock_latency.percentile(50), lock_latency.percentile(99), lock_latency.maximum());
+    out->print_cr("  Recycle lock hold (us): avg = %.2f, max = %.2f", _recycle_hold.avg(), _recycle_hold.maximum());
+  }
+};
+
+TEST_OTHER_VM(ShenandoahFreeSetStress, alloc_retire_recycle) {
+  if (!UseShenandoahGC || ShenandoahHeap::heap()->mode()->is_generational()) {
+    tty->print_cr("skipped (run with -XX:+UseShenandoahGC in a single generation mode)");
+    return;
+  }
+
+  // The pacer would delay allocations that have nothing to do with the free set.
+  AutoModifyRestore<bool> no_pacing(ShenandoahPacing, false);
+
+  ShenandoahFreeSetStress stress;
+  auto body = [&](Thread* thread, int id) {
+    stress.run((uint) id);
+  };
+  TestThreadGroup<decltype(body)> group(body, (int) stress.threads());
+
+  const jlong start = os::elapsed_counter();
+  group.doit();
+  group.join();
+  const double seconds = TimeHelper::counter_to_seconds(os::elapsed_counter() - start);
+
+  stress.print_on(tty, seconds);
+  EXPECT_GT(stress.rounds(), 0u);
+  EXPECT_EQ(0u, stress.failures());
+}
@@ -0,0 +1,348 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+
+#include "precompiled.hpp"
+#include "gc/shenandoah/heuristics/shenandoahAdaptiveHeuristics.hpp"
+#include "gc/shenandoah/heuristics/shenandoahCompactHeuristics.hpp"
+#include "gc/shenandoah/heuristics/shenandoahSpaceInfo.hpp"
+#include "gc/shenandoah/heuristics/shenandoahStaticHeuristics.hpp"
+#include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahHeuristicsTrace.hpp"
+#include "gc/shenandoah/shenandoah_globals.hpp"
+#include "runtime/os.hpp"
+#include "unittest.hpp"
+#include "utilities/autoRestore.hpp"
+#include "utilities/ostream.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Replays traces recorded with -XX:ShenandoahHeuristicsTraceFile through the heuristics classes.
+//
+// The replayed heuristics see the recorded space and the recorded clock, so that changes to the
+// triggers can be evaluated against the inputs of a real run without running it again. The tests
+// run in a VM of their own, because the heuristics need a Shenandoah heap to exist, and are skipped
+// unless that VM uses Shenandoah. To replay a trace:
+//
+//   SHENANDOAH_HEURISTICS_TRACE    the trace to replay
+//   SHENANDOAH_HEURISTICS_REPLAY   heuristics to replay it through: adaptive, static or compact (adaptive)
+//   SHENANDOAH_HEURISTICS_SPACE    space whose records are replayed (the space of the first trigger)
+//
+// Only the triggers are replayed. The collection sets of the trace are summarized, because choosing
+// a collection set needs the regions and the collection set of a live heap.
+
+class ShenandoahReplaySpace : public ShenandoahSpaceInfo {
+private:
+  char _name[256];
+  ShenandoahTriggerInputs _inputs;
+
+public:
+  explicit ShenandoahReplaySpace(const char* name) : _inputs() {
+    jio_snprintf(_name, sizeof(_name), "%s", name);
+  }
+
+  void set_inputs(const ShenandoahTriggerInputs& inputs) { _inputs = inputs; }
+
+  const char* name() const override                  { return _name; }
+  size_t soft_max_capacity() const override          { return _inputs._soft_max_capacity; }
+  size_t max_capacity() const override               { return _inputs._max_capacity; }
+  size_t soft_available() const override             { return _inputs._soft_available; }
+  size_t available() const override                  { return _inputs._available; }
+  size_t used() const override                       { return _inputs._used; }
+  size_t bytes_allocated_since_gc_start() const override { return _inputs._allocated; }
+};
+
+struct ShenandoahReplayResult {
+  size_t _triggers;
+  size_t _recorded_starts;
+  size_t _replayed_starts;
+  size_t _mismatches;
+  size_t _cycles;
+  size_t _collection_sets;
+
+  ShenandoahReplayResult() :
+    _triggers(0), _recorded_starts(0), _replayed_starts(0), _mismatches(0), _cycles(0), _collection_sets(0) {}
+};
+
+static ShenandoahHeuristics* replay_heuristics(const char* name, ShenandoahSpaceInfo* space) {
+  if (strcmp(name, "static") == 0) {
+    return new ShenandoahStaticHeuristics(space);
+  }
+  if (strcmp(name, "compact") == 0) {
+    return new ShenandoahCompactHeuristics(space);
+  }
+  if (strcmp(name, "adaptive") == 0) {
+    return new ShenandoahAdaptiveHeuristics(space);
+  }
+  return nullptr;
+}
+
+static void replay(ShenandoahHeuristicsTraceReader* reader, ShenandoahHeuristics* heuristics,
+                   ShenandoahReplaySpace* space, ShenandoahReplayResult* result, outputStream* out) {
+  while (reader->next()) {
+    if (strcmp(reader->space(), space->name()) != 0) {
+      continue;
+    }
+    ShenandoahHeuristics::set_replay_time(reader->time());
+    switch (reader->kind()) {
+      case ShenandoahHeuristicsTrace::TRIGGER: {
+        const ShenandoahTriggerInputs& inputs = reader->inputs();
+        space->set_inputs(inputs);
+        if (inputs._metaspace_oom) {
+          heuristics->record_metaspace_oom();
+        } else {
+          heuristics->clear_metaspace_oom();
+        }
+        if (inputs._allocation_spike) {
+          heuristics->record_allocation_spike();
+        }
+        bool decision = heuristics->should_start_gc();
+        result->_triggers++;
+        result->_recorded_starts += reader->decision() ? 1 : 0;
+        result->_replayed_starts += decision ? 1 : 0;
+        if (decision != reader->decision()) {
+          result->_mismatches++;
+          if (out != nullptr) {
+            out->print_cr("%.3fs: recorded %s, replayed %s (available " SIZE_FORMAT "%s of " SIZE_FORMAT "%s, "
+                          "allocated " SIZE_FORMAT "%s)", reader->time(),
+                          reader->decision() ? "start" : "wait", decision ? "start" : "wait",
+                          byte_size_in_proper_unit(inputs._soft_available), proper_unit_for_byte_size(inputs._soft_available),
+                          byte_size_in_proper_unit(inputs._soft_max_capacity), proper_unit_for_byte_size(inputs._soft_max_capacity),
+                          byte_size_in_proper_unit(inputs._allocated), proper_unit_for_byte_size(inputs._allocated));
+          }
+        }
+        break;
+      }
+      case ShenandoahHeuristicsTrace::CYCLE_START:
+        heuristics->record_cycle_start();
+        break;
+      case ShenandoahHeuristicsTrace::CYCLE_END:
+        heuristics->record_cycle_end();
+        break;
+      case ShenandoahHeuristicsTrace::CYCLE_CONCURRENT:
+        heuristics->record_success_concurrent();
+        result->_cycles++;
+        break;
+      case ShenandoahHeuristicsTrace::CYCLE_DEGENERATED:
+        heuristics->record_success_degenerated();
+        result->_cycles++;
+        break;
+      case ShenandoahHeuristicsTrace::CYCLE_FULL:
+        heuristics->record_success_full();
+        result->_cycles++;
+        break;
+      case ShenandoahHeuristicsTrace::ALLOCATION_FAILURE:
+        heuristics->record_allocation_failure_gc();
+        break;
+      case ShenandoahHeuristicsTrace::REQUESTED_GC:
+        heuristics->record_requested_gc();
+        break;
+      case ShenandoahHeuristicsTrace::COLLECTION_SET: {
+        size_t cset_regions = 0, cset_live = 0, garbage = 0;
+        for (size_t i = 0; i < reader->region_count(); i++) {
+          const ShenandoahTraceRegion& r = reader->regions()[i];
+          garbage += (r._used_words - MIN2(r._live_words, r._used_words)) * HeapWordSize;
+          if (r._in_cset) {
+            cset_regions++;
+            cset_live += r._live_words * HeapWordSize;
+          }
+        }
+        result->_collection_sets++;
+        if (out != nullptr) {
+          out->print_cr("%.3fs: collection set of " SIZE_FORMAT " out of " SIZE_FORMAT " regions, live " SIZE_FORMAT "%s, "
+                        "garbage in the space " SIZE_FORMAT "%s, free " SIZE_FORMAT "%s", reader->time(),
+                        cset_regions, reader->region_count(),
+                        byte_size_in_proper_unit(cset_live), proper_unit_for_byte_size(cset_live),
+                        byte_size_in_proper_unit(garbage), proper_unit_for_byte_size(garbage),
+                        byte_size_in_proper_unit(reader->free()), proper_unit_for_byte_size(reader->free()));
+        }
+        break;
+      }
+      default:
+        ShouldNotReachHere();
+    }
+  }
+  ShenandoahHeuristics::clear_replay_time();
+}
+
+static ShenandoahTriggerInputs trigger_inputs(size_t capacity, size_t available, bool metaspace_oom) {
+  ShenandoahTriggerInputs inputs;
+  inputs._soft_max_capacity = capacity;
+  inputs._max_capacity = capacity;
+  inputs._soft_available = available;
+  inputs._available = available;
+  inputs._used = capacity - available;
+  inputs._allocated = capacity - available;
+  inputs._metaspace_oom = metaspace_oom;
+  return inputs;
+}
+
+TEST_OTHER_VM(ShenandoahHeuristicsTrace, round_trip_and_replay) {
+  if (!UseShenandoahGC) {
+    tty->print_cr("skipped");
+    return;
+  }
+
+  AutoModifyRestore<uintx> threshold(ShenandoahMinFreeThreshold, 10);
+
+  char path[JVM_MAXPATHLEN];
+  jio_snprintf(path, sizeof(path), "%s%sshenandoah_heuristics_trace_%d.bin",
+               os::get_temp_directory(), os::file_separator(), os::current_process_id());
+
+  const size_t capacity = 1024 * M;
+  const size_t plenty = capacity / 2;
+  const size_t scarce = capacity / 100 * 5;
+  {
+    ShenandoahHeuristicsTrace trace(path, 4 * M, 256, capacity);
+    ASSERT_TRUE(trace.is_open());
+    trace.write_trigger("Replay", 0.9, trigger_inputs(capacity, plenty, false), false);
+    trace.write_trigger("Replay", 1.1, trigger_inputs(capacity, scarce, false), true);
+    trace.write_event("Replay", 1.2, ShenandoahHeuristicsTrace::CYCLE_START);
+    trace.write_event("Replay", 1.5, ShenandoahHeuristicsTrace::CYCLE_CONCURRENT);
+    trace.write_event("Replay", 1.5, ShenandoahHeuristicsTrace::CYCLE_END);
+
+    ShenandoahTraceRegion regions[2] = {
+      { 3, 100, 1000, 1, 2, true },
+      { 7, 900, 1000, 1, 0, false }
+    };
+    trace.write_collection_set("Replay", 1.6, plenty, regions, 2);
+
+    // Elsewhere in the heap, ignored by the replay
+    trace.write_trigger("Other", 1.7, trigger_inputs(capacity, scarce, false), true);
+
+    // Before and after the guaranteed interval elapses, then with metaspace running out
+    trace.write_trigger("Replay", 2.0, trigger_inputs(capacity, plenty, false), false);
+    trace.write_trigger("Replay", 3.0, trigger_inputs(capacity, plenty, false), true);
+    trace.write_trigger("Replay", 3.1, trigger_inputs(capacity, plenty, true), true);
+  }
+
+  {
+    ShenandoahHeuristicsTraceReader reader(path);
+    ASSERT_TRUE(reader.is_valid());
+    EXPECT_EQ(reader.region_size(), 4 * M);
+    EXPECT_EQ(reader.num_regions(), (size_t) 256);
+    EXPECT_EQ(reader.max_capacity(), capacity);
+
+    ASSERT_TRUE(reader.next());
+    EXPECT_EQ(reader.kind(), ShenandoahHeuristicsTrace::TRIGGER);
+    EXPECT_EQ(reader.time(), 0.9);
+    EXPECT_STREQ(reader.space(), "Replay");
+    EXPECT_EQ(reader.inputs()._soft_available, plenty);
+    EXPECT_EQ(reader.inputs()._used, capacity - plenty);
+    EXPECT_FALSE(reader.decision());
+
+    ASSERT_TRUE(reader.next());
+    EXPECT_TRUE(reader.decision());
+    ASSERT_TRUE(reader.next());
+    EXPECT_EQ(reader.kind(), ShenandoahHeuristicsTrace::CYCLE_START);
+    ASSERT_TRUE(reader.next());
+    EXPECT_EQ(reader.kind(), ShenandoahHeuristicsTrace::CYCLE_CONCURRENT);
+    ASSERT_TRUE(reader.next());
+    EXPECT_EQ(reader.kind(), ShenandoahHeuristicsTrace::CYCLE_END);
+
+    ASSERT_TRUE(reader.next());
+    EXPECT_EQ(reader.kind(), ShenandoahHeuristicsTrace::COLLECTION_SET);
+    EXPECT_EQ(reader.free(), plenty);
+    ASSERT_EQ(reader.region_count(), (size_t) 2);
+    EXPECT_EQ(reader.regions()[0]._index, 3u);
+    EXPECT_EQ(reader.regions()[0]._live_words, 100u);
+    EXPECT_EQ(reader.regions()[0]._age, 2);
+    EXPECT_TRUE(reader.regions()[0]._in_cset);
+    EXPECT_FALSE(reader.regions()[1]._in_cset);
+
+    ASSERT_TRUE(reader.next());
+    EXPECT_STREQ(reader.space(), "Other");
+    ASSERT_TRUE(reader.next());
+    ASSERT_TRUE(reader.next());
+    ASSERT_TRUE(reader.next());
+    EXPECT_TRUE(reader.inputs()._metaspace_oom);
+    EXPECT_FALSE(reader.next());
+  }
+
+  {
+    ShenandoahHeuristicsTraceReader reader(path);
+    ShenandoahReplaySpace space("Replay");
+    ShenandoahHeuristics* heuristics = replay_heuristics("static", &space);
+    heuristics->set_guaranteed_gc_interval(1000);
+
+    ShenandoahReplayResult result;
+    replay(&reader, heuristics, &space, &result, tty);
+    delete heuristics;
+
+    EXPECT_EQ(result._triggers, (size_t) 5);
+    EXPECT_EQ(result._recorded_starts, (size_t) 3);
+    EXPECT_EQ(result._mismatches, (size_t) 0);
+    EXPECT_EQ(result._cycles, (size_t) 1);
+    EXPECT_EQ(result._collection_sets, (size_t) 1);
+  }
+
+  remove(path);
+}
+
+TEST_OTHER_VM(ShenandoahHeuristicsTrace, replay_file) {
+  const char* path = ::getenv("SHENANDOAH_HEURISTICS_TRACE");
+  if (!UseShenandoahGC || path == nullptr) {
+    tty->print_cr("skipped");
+    return;
+  }
+
+  const char* name = ::getenv("SHENANDOAH_HEURISTICS_REPLAY");
+  if (name == nullptr) {
+    name = "adaptive";
+  }
+
+  char space_name[256];
+  const char* space_env = ::getenv("SHENANDOAH_HEURISTICS_SPACE");
+  if (space_env != nullptr) {
+    jio_snprintf(space_name, sizeof(space_name), "%s", space_env);
+  } else {
+    ShenandoahHeuristicsTraceReader reader(path);
+    ASSERT_TRUE(reader.is_valid()) << "Not a heuristics trace: " << path;
+    space_name[0] = '\0';
+    while (reader.next()) {
+      if (reader.kind() == ShenandoahHeuristicsTrace::TRIGGER) {
+        jio_snprintf(space_name, sizeof(space_name), "%s", reader.space());
+        break;
+      }
+    }
+  }
+
+  ShenandoahHeuristicsTraceReader reader(path);
+  ASSERT_TRUE(reader.is_valid()) << "Not a heuristics trace: " << path;
+  ShenandoahReplaySpace space(space_name);
+  ShenandoahHeuristics* heuristics = replay_heuristics(name, &space);
+  ASSERT_TRUE(heuristics != nullptr) << "Unknown heuristics: " << name;
+  heuristics->set_guaranteed_gc_interval(ShenandoahGuaranteedGCInterval);
+
+  ShenandoahReplayResult result;
+  replay(&reader, heuristics, &space, &result, tty);
+  delete heuristics;
+
+  tty->print_cr("Replayed %s through %s heuristics: " SIZE_FORMAT " triggers, " SIZE_FORMAT " recorded starts, "
+                SIZE_FORMAT " replayed starts, " SIZE_FORMAT " differ; " SIZE_FORMAT " cycles, " SIZE_FORMAT " collection sets",
+                space_name, name, result._triggers, result._recorded_starts, result._replayed_starts,
+                result._mismatches, result._cycles, result._collection_sets);
+}
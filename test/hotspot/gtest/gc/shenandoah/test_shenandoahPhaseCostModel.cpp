@@ -0,0 +1,67 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "gc/shenandoah/heuristics/shenandoahAdaptiveHeuristics.hpp"
+
+#include "unittest.hpp"
+
+TEST(ShenandoahPhaseCostModelTest, untrained) {
+  ShenandoahPhaseCostModel model(0.9);
+  EXPECT_FALSE(model.is_trained());
+  EXPECT_DOUBLE_EQ(0.0, model.predict(100.0));
+  EXPECT_DOUBLE_EQ(0.0, model.sd());
+}
+
+TEST(ShenandoahPhaseCostModelTest, fits_constant_and_proportional_costs) {
+  ShenandoahPhaseCostModel model(0.9);
+  for (int i = 1; i <= 20; i++) {
+    const double work = 1000.0 * (i % 5 + 1);
+    model.add(work, 0.002 + work * 1e-6);
+  }
+  EXPECT_TRUE(model.is_trained());
+  EXPECT_NEAR(0.002 + 8000 * 1e-6, model.predict(8000.0), 1e-9);
+  EXPECT_NEAR(0.0, model.sd(), 1e-9);
+  EXPECT_NEAR(8000.0, model.max_work(0.002 + 8000 * 1e-6), 1e-3);
+}
+
+TEST(ShenandoahPhaseCostModelTest, constant_work_predicts_average) {
+  ShenandoahPhaseCostModel model(0.9);
+  model.add(1000.0, 0.010);
+  model.add(1000.0, 0.010);
+  model.add(1000.0, 0.010);
+  EXPECT_NEAR(0.010, model.predict(5000.0), 1e-12);
+  EXPECT_GT(model.max_work(0.011), 1e300);
+  EXPECT_DOUBLE_EQ(0.0, model.max_work(0.009));
+}
+
+TEST(ShenandoahPhaseCostModelTest, ignores_negative_slope) {
+  ShenandoahPhaseCostModel model(0.9);
+  model.add(1000.0, 0.020);
+  model.add(2000.0, 0.010);
+  const double average = model.predict(1500.0);
+  EXPECT_DOUBLE_EQ(average, model.predict(1000.0));
+  EXPECT_DOUBLE_EQ(average, model.predict(4000.0));
+  EXPECT_GT(model.sd(), 0.0);
+}
@@ -0,0 +1,385 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "gc/shared/collectedHeap.hpp"
+#include "gc/shared/memAllocator.hpp"
+#include "gc/shenandoah/mode/shenandoahMode.hpp"
+#include "gc/shenandoah/shenandoahFreeSet.hpp"
+#include "gc/shenandoah/shenandoahHeap.inline.hpp"
+#include "gc/shenandoah/shenandoahHeapRegion.inline.hpp"
+#include "gc/shenandoah/shenandoahOldGeneration.hpp"
+#include "gc/shenandoah/shenandoahScanRemembered.inline.hpp"
+#include "memory/iterator.inline.hpp"
+#include "memory/universe.hpp"
+#include "oops/objArrayOop.inline.hpp"
+#include "oops/oop.inline.hpp"
+#include "runtime/os.hpp"
+#include "runtime/timer.hpp"
+#include "runtime/vmOperations.hpp"
+#include "runtime/vmThread.hpp"
+#include "unittest.hpp"
+#include "utilities/ostream.hpp"
+
+#include <stdlib.h>
+
+// Microbenchmark for the remembered set scanning kernels.
+//
+// A VM operation takes an empty region, makes it old and fills it with a synthetic mix of object
+// arrays and filler objects, registering each of them in the card cluster start table. It dirties
+// a share of the cards, then times:
+//
+//   register   filling the region and registering every object start
+//   scan       process_clusters() over the whole region, with a closure that counts references
+//   search     the byte-wise and the word-at-a-time search for the previous non-clean card,
+//              over a copy of the region's cards (a vector search would be timed the same way)
+//   coalesce   filling runs of dead objects and coalescing them in the start table, the way
+//              coalesce-and-fill does
+//
+// The region is trashed and recycled afterwards, and the free set rebuilt. The test runs in a VM of
+// its own, and is skipped unless that VM uses Shenandoah in generational mode. The layout is shaped
+// with environment variables:
+//
+//   SHENANDOAH_REMSET_BENCH_MIN_WORDS    smallest object, in words (4)
+//   SHENANDOAH_REMSET_BENCH_MAX_WORDS    largest object, in words (64)
+//   SHENANDOAH_REMSET_BENCH_ARRAY_PCT    percentage of objects that are object arrays (50)
+//   SHENANDOAH_REMSET_BENCH_DIRTY_PCT    percentage of dirty cards (10)
+//   SHENANDOAH_REMSET_BENCH_DIRTY_RUN    length of each run of dirty cards (1)
+//   SHENANDOAH_REMSET_BENCH_DEAD_PCT     percentage of objects coalesced as dead (30)
+//   SHENANDOAH_REMSET_BENCH_ITERATIONS   rounds of the whole sequence (10)
+
+static size_t bench_parameter(const char* name, size_t value) {
+  const char* v = ::getenv(name);
+  return v != nullptr ? (size_t) atol(v) : value;
+}
+
+// Deterministic, so that runs with the same parameters scan the same layout.
+class ShenandoahBenchRandom {
+private:
+  uint64_t _state;
+public:
+  explicit ShenandoahBenchRandom(uint64_t seed) : _state(seed) {}
+
+  uint32_t next() {
+    _state = _state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t) (_state >> 33);
+  }
+
+  bool percent(size_t pct) { return next() % 100 < pct; }
+  size_t between(size_t lo, size_t hi) { return lo + next() % (hi - lo + 1); }
+};
+
+class ShenandoahCountRefsClosure : public BasicOopIterateClosure {
+private:
+  template <class T>
+  inline void do_oop_work(T* p) {
+    _refs++;
+    if (!CompressedOops::is_null(RawAccess<>::oop_load(p))) {
+      _non_null++;
+    }
+  }
+
+public:
+  size_t _refs;
+  size_t _non_null;
+
+  ShenandoahCountRefsClosure() : _refs(0), _non_null(0) {}
+
+  void do_oop(oop* p)       { do_oop_work(p); }
+  void do_oop(narrowOop* p) { do_oop_work(p); }
+};
+
+class VM_ShenandoahRemsetScanBenchmark : public VM_Operation {
+private:
+  const size_t _min_words;
+  const size_t _max_words;
+  const size_t _array_pct;
+  const size_t _dirty_pct;
+  const size_t _dirty_run;
+  const size_t _dead_pct;
+  const size_t _iterations;
+
+  ShenandoahBenchRandom _random;
+
+  jlong _register_ticks;
+  jlong _scan_ticks;
+  jlong _byte_search_ticks;
+  jlong _word_search_ticks;
+  jlong _coalesce_ticks;
+  size_t _objects;
+  size_t _cards;
+  size_t _dirty_cards;
+  size_t _refs;
+  size_t _non_null_refs;
+  size_t _coalesced;
+  bool _skipped;
+
+  ShenandoahHeapRegion* take_empty_region() {
+    ShenandoahHeap* const heap = ShenandoahHeap::heap();
+    for (size_t i = 0; i < heap->num_regions(); i++) {
+      ShenandoahHeapRegion* const r = heap->get_region(i);
+      if (r->is_empty_committed() && !r->is_affiliated()) {
+        // The same steps as the free set takes to start an old allocation region
+        heap->free_set()->clear();
+        r->set_affiliation(OLD_GENERATION);
+        r->end_preemptible_coalesce_and_fill();
+        heap->old_generation()->clear_cards_for(r);
+        heap->old_generation()->increment_affiliated_region_count();
+        r->make_regular_allocation(OLD_GENERATION);
+        return r;
+      }
+    }
+    return nullptr;
+  }
+
+  void release_region(ShenandoahHeapRegion* r) {
+    ShenandoahHeap* const heap = ShenandoahHeap::heap();
+    ShenandoahFreeSet* const free_set = heap->free_set();
+    heap->old_generation()->clear_cards_for(r);
+    r->make_trash();
+    r->recycle();
+
+    size_t young_cset_regions, old_cset_regions, first_old_region, last_old_region, old_region_count;
+    free_set->prepare_to_rebuild(young_cset_regions, old_cset_regions, first_old_region, last_old_region, old_region_count);
+    free_set->rebuild(young_cset_regions, old_cset_regions);
+  }
+
+  // Fills the region up to its end with object arrays and filler objects, and registers them.
+  void populate(ShenandoahHeapRegion* r) {
+    RememberedScanner* const scanner = ShenandoahHeap::heap()->old_generation()->card_scan();
+    const size_t min_words = MAX2(_min_words, objArrayOopDesc::object_size(0));
+    const size_t max_words = clamp(_max_words, min_words, ShenandoahHeapRegion::humongous_threshold_words());
+    oop previous = nullptr;
+
+    HeapWord* p = r->bottom();
+    while (true) {
+      size_t words = _random.between(min_words, max_words);
+      if (p + words + max_words > r->end()) {
+        words = pointer_delta(r->end(), p);
+      }
+      int length = (int) ((words - objArrayOopDesc::object_size(0)) * HeapWordSize / heapOopSize);
+      while (length > 0 && objArrayOopDesc::object_size(length) > words) {
+        length--;
+      }
+      const size_t array_words = objArrayOopDesc::object_size(length);
+      const bool fits = array_words == words || words - array_words >= CollectedHeap::min_fill_size();
+      if (fits && _random.percent(_array_pct)) {
+        ObjArrayAllocator allocator(Universe::objectArrayKlassObj(), array_words, length, true /* do_zero */);
+        objArrayOop array = (objArrayOop) cast_to_oop(allocator.initialize(p));
+        for (int i = 0; i < length && previous != nullptr; i += 2) {
+          array->obj_at_put(i, previous);
+        }
+        previous = array;
+        scanner->register_object_without_lock(p);
+        if (array_words < words) {
+          CollectedHeap::fill_with_object(p + array_words, words - array_words);
+          scanner->register_object_without_lock(p + array_words);
+        }
+      } else {
+        CollectedHeap::fill_with_object(p, words);
+        scanner->register_object_without_lock(p);
+      }
+      _objects++;
+      p += words;
+      if (p == r->end()) {
+        break;
+      }
+    }
+    r->set_top(p);
+    ShenandoahHeap::heap()->increase_used(ShenandoahHeap::heap()->old_generation(), r->used());
+  }
+
+  // Cleans the cards dirtied by the stores above, then dirties runs of cards at random.
+  void dirty_cards(ShenandoahHeapRegion* r, size_t first_card, size_t cards) {
+    RememberedScanner* const scanner = ShenandoahHeap::heap()->old_generation()->card_scan();
+    scanner->mark_range_as_clean(first_card, cards);
+    const size_t run = MAX2(_dirty_run, (size_t) 1);
+    for (size_t c = 0; c < cards; c += run) {
+      if (_random.percent(_dirty_pct)) {
+        const size_t n = MIN2(run, cards - c);
+        scanner->mark_range_as_dirty(first_card + c, n);
+        _dirty_cards += n;
+      }
+    }
+  }
+
+  void scan(ShenandoahHeapRegion* r) {
+    RememberedScanner* const scanner = ShenandoahHeap::heap()->old_generation()->card_scan();
+    const size_t first_cluster = scanner->cluster_for_addr(r->bottom());
+    const size_t cluster_words = ShenandoahCardCluster<ShenandoahDirectCardMarkRememberedSet>::CardsPerCluster *
+                                 CardTable::card_size_in_words();
+    const size_t clusters = ShenandoahHeapRegion::region_size_words() / cluster_words;
+    ShenandoahCountRefsClosure cl;
+    const jlong start = os::elapsed_counter();
+    scanner->process_clusters(first_cluster, clusters, r->top(), &cl, true /* use_write_table */, 0);
+    _scan_ticks += os::elapsed_counter() - start;
+    _refs += cl._refs;
+    _non_null_refs += cl._non_null;
+  }
+
+  void search(size_t first_card, size_t cards) {
+    RememberedScanner* const scanner = ShenandoahHeap::heap()->old_generation()->card_scan();
+    CardValue* const copy = NEW_C_HEAP_ARRAY(CardValue, cards, mtGC);
+    for (size_t c = 0; c < cards; c++) {
+      copy[c] = scanner->is_write_card_dirty(first_card + c) ? CardTable::dirty_card_val() : CardTable::clean_card_val();
+    }
+
+    ssize_t found = 0;
+    jlong start = os::elapsed_counter();
+    for (ssize_t cur = (ssize_t) cards - 1; cur >= 0; cur--) {
+      cur = ShenandoahDirectCardMarkRememberedSet::find_prev_non_clean_card<CardValue>(copy, cur, 0);
+      found++;
+    }
+    _byte_search_ticks += os::elapsed_counter() - start;
+
+    ssize_t found_words = 0;
+    start = os::elapsed_counter();
+    for (ssize_t cur = (ssize_t) cards - 1; cur >= 0; cur--) {
+      cur = ShenandoahDirectCardMarkRememberedSet::find_prev_non_clean_card<uintptr_t>(copy, cur, 0);
+      found_words++;
+    }
+    _word_search_ticks += os::elapsed_counter() - start;
+
+    FREE_C_HEAP_ARRAY(CardValue, copy);
+    EXPECT_EQ(found, found_words) << "Searches should stop at the same cards";
+  }
+
+  // Walks the region like coalesce-and-fill, with objects chosen at random as dead.
+  void coalesce(ShenandoahHeapRegion* r) {
+    RememberedScanner* const scanner = ShenandoahHeap::heap()->old_generation()->card_scan();
+    const jlong start = os::elapsed_counter();
+    HeapWord* p = r->bottom();
+    while (p < r->top()) {
+      if (!_random.percent(_dead_pct)) {
+        p += cast_to_oop(p)->size();
+        continue;
+      }
+      HeapWord* next = p + cast_to_oop(p)->size();
+      while (next < r->top() && _random.percent(_dead_pct)) {
+        next += cast_to_oop(next)->size();
+      }
+      const size_t fill_size = pointer_delta(next, p);
+      CollectedHeap::fill_with_object(p, fill_size);
+      scanner->coalesce_objects(p, fill_size);
+      _coalesced++;
+      p = next;
+    }
+    _coalesce_ticks += os::elapsed_counter() - start;
+  }
+
+public:
+  VM_ShenandoahRemsetScanBenchmark() :
+    _min_words(bench_parameter("SHENANDOAH_REMSET_BENCH_MIN_WORDS", 4)),
+    _max_words(bench_parameter("SHENANDOAH_REMSET_BENCH_MAX_WORDS", 64)),
+    _array_pct(MIN2(bench_parameter("SHENANDOAH_REMSET_BENCH_ARRAY_PCT", 50), (size_t) 100)),
+    _dirty_pct(MIN2(bench_parameter("SHENANDOAH_REMSET_BENCH_DIRTY_PCT", 10), (size_t) 100)),
+    _dirty_run(bench_parameter("SHENANDOAH_REMSET_BENCH_DIRTY_RUN", 1)),
+    _dead_pct(MIN2(bench_parameter("SHENANDOAH_REMSET_BENCH_DEAD_PCT", 30), (size_t) 100)),
+    _iterations(MAX2(bench_parameter("SHENANDOAH_REMSET_BENCH_ITERATIONS", 10), (size_t) 1)),
+    _random(0x5eed),
+    _register_ticks(0),
+    _scan_ticks(0),
+    _byte_search_ticks(0),
+    _word_search_ticks(0),
+    _coalesce_ticks(0),
+    _objects(0),
+    _cards(0),
+    _dirty_cards(0),
+    _refs(0),
+    _non_null_refs(0),
+    _coalesced(0),
+    _skipped(false) {}
+
+  VMOp_Type type() const { return VMOp_HeapIterateOperation; }
+
+  void doit() {
+    ShenandoahHeap* const heap = ShenandoahHeap::heap();
+    ShenandoahHeapLocker locker(heap->lock());
+    RememberedScanner* const scanner = heap->old_generation()->card_scan();
+    if (!heap->old_generation()->is_parseable()) {
+      _skipped = true;
+      return;
+    }
+
+    for (size_t i = 0; i < _iterations; i++) {
+      ShenandoahHeapRegion* const r = take_empty_region();
+      if (r == nullptr) {
+        _skipped = true;
+        return;
+      }
+      const size_t first_card = scanner->card_index_for_addr(r->bottom());
+      const size_t cards = ShenandoahHeapRegion::region_size_words() / CardTable::card_size_in_words();
+
+      jlong start = os::elapsed_counter();
+      populate(r);
+      _register_ticks += os::elapsed_counter() - start;
+
+      dirty_cards(r, first_card, cards);
+      _cards += cards;
+      scan(r);
+      search(first_card, cards);
+      coalesce(r);
+
+      release_region(r);
+    }
+  }
+
+  bool skipped() const { return _skipped; }
+  size_t objects() const { return _objects; }
+  size_t non_null_refs() const { return _non_null_refs; }
+
+  void print_on(outputStream* out) const {
+    const double region_mb = (double) (_iterations * ShenandoahHeapRegion::region_size_bytes()) / M;
+    const double scan_s = TimeHelper::counter_to_seconds(_scan_ticks);
+    out->print_cr("Remembered set scan benchmark: " SIZE_FORMAT " rounds over " SIZE_FORMAT "K regions, objects of "
+                  SIZE_FORMAT "-" SIZE_FORMAT " words, " SIZE_FORMAT "%% arrays, " SIZE_FORMAT "%% dirty in runs of " SIZE_FORMAT,
+                  _iterations, ShenandoahHeapRegion::region_size_bytes() / K, _min_words, _max_words,
+                  _array_pct, _dirty_pct, _dirty_run);
+    out->print_cr("  Register: " SIZE_FORMAT " objects in %.3fms", _objects, TimeHelper::counter_to_millis(_register_ticks));
+    out->print_cr("  Scan: " SIZE_FORMAT " cards, " SIZE_FORMAT " dirty, " SIZE_FORMAT " references (" SIZE_FORMAT " non-null) "
+                  "in %.3fms, %.1f MB/s, %.2f ns/card",
+                  _cards, _dirty_cards, _refs, _non_null_refs, scan_s * 1000, region_mb / MAX2(scan_s, 1e-9),
+                  scan_s * 1e9 / MAX2(_cards, (size_t) 1));
+    out->print_cr("  Search: byte-wise %.3fms, word-at-a-time %.3fms",
+                  TimeHelper::counter_to_millis(_byte_search_ticks), TimeHelper::counter_to_millis(_word_search_ticks));
+    out->print_cr("  Coalesce: " SIZE_FORMAT " runs in %.3fms", _coalesced, TimeHelper::counter_to_millis(_coalesce_ticks));
+  }
+};
+
+TEST_OTHER_VM(ShenandoahRemsetScanBenchmark, scan_search_coalesce) {
+  if (!(UseShenandoahGC && ShenandoahHeap::heap()->mode()->is_generational())) {
+    tty->print_cr("skipped (run with -XX:+UseShenandoahGC -XX:ShenandoahGCMode=generational)");
+    return;
+  }
+
+  VM_ShenandoahRemsetScanBenchmark op;
+  VMThread::execute(&op);
+  if (op.skipped()) {
+    tty->print_cr("skipped (no empty region, or old generation not parseable)");
+    return;
+  }
+
+  op.print_on(tty);
+  EXPECT_GT(op.objects(), 0u);
+  EXPECT_GT(op.non_null_refs(), 0u);
+}
@@ -250,6 +250,11 @@ TEST_VM_F(AsyncLogTest, droppingMessage) {
   AsyncLogWriter::flush();
   if (AsyncLogWriter::instance() != nullptr) {
     EXPECT_TRUE(file_contains_substring(TestLogFileName, "messages dropped due to async logging"));
+
+    stringStream ss;
+    AsyncLogWriter::print_statistics(&ss);
+    EXPECT_TRUE(strstr(ss.base(), "Async log writer: ") != nullptr);
+    EXPECT_TRUE(strstr(ss.base(), " 0 bytes dropped") == nullptr);
   }
 }
 
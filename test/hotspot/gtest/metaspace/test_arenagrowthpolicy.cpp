@@ -31,6 +31,7 @@
 #include "metaspaceGtestCommon.hpp"
 
 using metaspace::ArenaGrowthPolicy;
+using metaspace::ArenaSizeHints;
 using metaspace::chunklevel_t;
 using namespace metaspace::chunklevel;
 
@@ -70,3 +71,25 @@ DEFINE_GROWTH_POLICY_TEST(StandardMetaspaceType, false)
 DEFINE_GROWTH_POLICY_TEST(BootMetaspaceType, true)
 DEFINE_GROWTH_POLICY_TEST(BootMetaspaceType, false)
 
+
+TEST_VM(metaspace, arena_size_hints) {
+  // Arbitrary key, unlikely to be used by a real loader class in the test VM
+  const unsigned key = 0x5eed1e55;
+
+  ArenaSizeHints::record(key, word_size_for_level(CHUNK_LEVEL_32K) - 1, 0);
+  ASSERT_EQ(ArenaSizeHints::first_chunk_level(key, false), CHUNK_LEVEL_32K);
+  ASSERT_EQ(ArenaSizeHints::first_chunk_level(key, true), INVALID_CHUNK_LEVEL);
+
+  // Usage is averaged with what was recorded before
+  ArenaSizeHints::record(key, 0, word_size_for_level(CHUNK_LEVEL_8K) * 2);
+  ASSERT_EQ(ArenaSizeHints::first_chunk_level(key, false), CHUNK_LEVEL_16K);
+  ASSERT_EQ(ArenaSizeHints::first_chunk_level(key, true), CHUNK_LEVEL_8K);
+
+  // Hints are capped
+  for (int i = 0; i < 32; i++) {
+    ArenaSizeHints::record(key, word_size_for_level(CHUNK_LEVEL_16M), 0);
+  }
+  ASSERT_GT(ArenaSizeHints::first_chunk_level(key, false), CHUNK_LEVEL_16M);
+
+  ASSERT_EQ(ArenaSizeHints::first_chunk_level(key + 1, false), INVALID_CHUNK_LEVEL);
+}
@@ -149,6 +149,13 @@ TEST(cgroupTest, SubSystemFileLineContentsMultipleLinesSuccessCases) {
   err = subsystem_file_line_contents(&my_controller, test_file, nullptr, "%*s %d", &x);
   EXPECT_EQ(err, 0);
   EXPECT_EQ(x, 10001);
+
+  jlong total = -3;
+  fill_file(test_file, "some avg10=1.50 avg60=0.25 avg300=0.05 total=123456\n"
+                       "full avg10=0.00 avg60=0.00 avg300=0.00 total=789");
+  err = subsystem_file_line_contents(&my_controller, test_file, "some", "%*s %*s %*s total=" JLONG_FORMAT, &total);
+  EXPECT_EQ(err, 0);
+  EXPECT_EQ(total, 123456);
 }
 
 TEST(cgroupTest, SubSystemFileLineContentsSingleLine) {
@@ -0,0 +1,402 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test id=default
+ * @summary Measure GC pauses, pacing delays and allocation stalls of a synthetic service workload
+ * @requires vm.gc.Shenandoah & vm.hasJFR
+ *
+ * @run main/native/othervm/timeout=300 -Xms1g -Xmx1g -XX:+UnlockExperimentalVMOptions -XX:+UnlockDiagnosticVMOptions
+ *      -XX:+UseShenandoahGC
+ *      TestServiceLatency
+ *
+ * @run main/native/othervm/timeout=300 -Xms1g -Xmx1g -XX:+UnlockExperimentalVMOptions -XX:+UnlockDiagnosticVMOptions
+ *      -XX:+UseShenandoahGC
+ *      -Dshenandoah.latency.shape=tree -Dshenandoah.latency.humongousPercent=10 -Dshenandoah.latency.pinPercent=1
+ *      TestServiceLatency
+ */
+
+/*
+ * @test id=generational
+ * @summary Measure GC pauses, pacing delays and allocation stalls of a synthetic service workload
+ * @requires vm.gc.Shenandoah & vm.hasJFR
+ *
+ * @run main/native/othervm/timeout=300 -Xms1g -Xmx1g -XX:+UnlockExperimentalVMOptions -XX:+UnlockDiagnosticVMOptions
+ *      -XX:+UseShenandoahGC -XX:ShenandoahGCMode=generational
+ *      TestServiceLatency
+ *
+ * @run main/native/othervm/timeout=300 -Xms1g -Xmx1g -XX:+UnlockExperimentalVMOptions -XX:+UnlockDiagnosticVMOptions
+ *      -XX:+UseShenandoahGC -XX:ShenandoahGCMode=generational
+ *      -Dshenandoah.latency.shape=tree -Dshenandoah.latency.humongousPercent=10 -Dshenandoah.latency.pinPercent=1
+ *      TestServiceLatency
+ */
+
+import java.lang.management.ManagementFactory;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.time.Duration;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.Random;
+import java.util.concurrent.atomic.AtomicLong;
+import java.util.concurrent.atomic.AtomicReferenceArray;
+import java.util.concurrent.locks.LockSupport;
+
+import com.sun.management.HotSpotDiagnosticMXBean;
+import jdk.jfr.Recording;
+import jdk.jfr.consumer.RecordedEvent;
+import jdk.jfr.consumer.RecordingFile;
+
+/**
+ * A repeatable latency benchmark for Shenandoah.
+ *
+ * Worker threads stand in for a service: each operation replaces one entry of a live set of fixed
+ * size with a new object graph, throttled to a target allocation rate. A share of the allocated
+ * bytes goes to short-lived humongous arrays, and a share of the operations pins an array in a JNI
+ * critical section. After a warmup, a JFR recording collects GC pauses (jdk.GCPhasePause), pacing
+ * delays (jdk.ShenandoahAllocationPacing), allocation stalls (jdk.ShenandoahAllocationStall) and
+ * degenerating allocation failures (jdk.ShenandoahAllocationFailureStall). Their distributions are
+ * printed as a single line of JSON starting with the "RESULT " marker, and written to the file
+ * named by shenandoah.latency.output, if any.
+ *
+ * The workload is shaped by system properties, all prefixed with "shenandoah.latency.":
+ *
+ *   threads           worker threads (4)
+ *   warmup            seconds to run before recording (2)
+ *   duration          seconds to record (10)
+ *   allocRate         allocation rate in MB/s over all threads, 0 for as fast as possible (256)
+ *   liveSet           live set in MB (256)
+ *   objectSize        approximate size in bytes of each object graph (4096)
+ *   shape             object graph shape: array, list or tree (list)
+ *   humongousPercent  percentage of allocated bytes in humongous arrays (0)
+ *   humongousSize     size in bytes of each humongous array (4194304)
+ *   pinPercent        percentage of operations that pin an array (0)
+ *   pinPasses         passes over the pinned array while it is pinned (16)
+ *   seed              seed of the random choices (42)
+ *   output            file to write the JSON result to
+ *
+ * Budgets turn the benchmark into a regression test. A budget is a property named
+ * shenandoah.latency.budget.KIND.STAT, where KIND is pause, pacing, stall or failureStall, and
+ * STAT is count, p50, p90, p99, p999 or max. Percentiles and max are in milliseconds. The test
+ * fails when any recorded statistic exceeds its budget; without budgets, it only reports.
+ */
+public class TestServiceLatency {
+    static {
+        System.loadLibrary("TestServiceLatency");
+    }
+
+    private static final String PREFIX = "shenandoah.latency.";
+
+    private static final String[][] KINDS = {
+        { "pause",        "jdk.GCPhasePause" },
+        { "pacing",       "jdk.ShenandoahAllocationPacing" },
+        { "stall",        "jdk.ShenandoahAllocationStall" },
+        { "failureStall", "jdk.ShenandoahAllocationFailureStall" },
+    };
+
+    private static final String[] STATS = { "count", "p50", "p90", "p99", "p999", "max" };
+
+    // Rough footprint of a Node and its payload, used to size the graphs
+    private static final int NODE_PAYLOAD = 48;
+    private static final int NODE_BYTES = 24 + 16 + NODE_PAYLOAD;
+
+    private static final int PIN_SIZE = 4096;
+
+    private static native long pinAndTouch(byte[] a, int passes);
+
+    static final class Node {
+        Node left;
+        Node right;
+        final byte[] payload = new byte[NODE_PAYLOAD];
+    }
+
+    private static final int threads = intProperty("threads", 4);
+    private static final int warmup = intProperty("warmup", 2);
+    private static final int duration = intProperty("duration", 10);
+    private static final long allocRate = longProperty("allocRate", 256) * 1024 * 1024;
+    private static final long liveSet = longProperty("liveSet", 256) * 1024 * 1024;
+    private static final int objectSize = Math.max(intProperty("objectSize", 4096), NODE_BYTES);
+    private static final String shape = System.getProperty(PREFIX + "shape", "list");
+    private static final int humongousPercent = Math.min(intProperty("humongousPercent", 0), 100);
+    private static final int humongousSize = intProperty("humongousSize", 4 * 1024 * 1024);
+    private static final int pinPercent = Math.min(intProperty("pinPercent", 0), 100);
+    private static final int pinPasses = intProperty("pinPasses", 16);
+    private static final long seed = longProperty("seed", 42);
+
+    private static final AtomicReferenceArray<Object> live =
+        new AtomicReferenceArray<>((int) Math.max(1, liveSet / objectSize));
+
+    private static final AtomicLong allocated = new AtomicLong();
+    private static final AtomicLong operations = new AtomicLong();
+    private static final AtomicLong pins = new AtomicLong();
+    private static volatile boolean done;
+    private static volatile long sink;
+
+    private static int intProperty(String name, int value) {
+        return Integer.getInteger(PREFIX + name, value);
+    }
+
+    private static long longProperty(String name, long value) {
+        return Long.getLong(PREFIX + name, value);
+    }
+
+    private static Object buildList(int nodes) {
+        Node head = null;
+        for (int i = 0; i < nodes; i++) {
+            Node n = new Node();
+            n.left = head;
+            head = n;
+        }
+        return head;
+    }
+
+    private static Node buildTree(int nodes) {
+        if (nodes == 0) {
+            return null;
+        }
+        Node n = new Node();
+        int rest = nodes - 1;
+        n.left = buildTree(rest / 2);
+        n.right = buildTree(rest - rest / 2);
+        return n;
+    }
+
+    private static Object buildGraph() {
+        int nodes = objectSize / NODE_BYTES;
+        switch (shape) {
+            case "array": return new byte[objectSize];
+            case "list":  return buildList(nodes);
+            case "tree":  return buildTree(nodes);
+            default:      throw new IllegalArgumentException("Unknown shape: " + shape);
+        }
+    }
+
+    static final class Worker extends Thread {
+        private final Random random;
+        private final long rate;
+        private final Object[] humongous = new Object[4];
+        private long bytes;
+        private long humongousBytes;
+
+        Worker(int id) {
+            super("Service-" + id);
+            setDaemon(true);
+            random = new Random(seed + id);
+            rate = allocRate / threads;
+        }
+
+        private void operate() {
+            if (humongousBytes * 100 < (long) humongousPercent * bytes) {
+                humongous[random.nextInt(humongous.length)] = new byte[humongousSize];
+                humongousBytes += humongousSize;
+                bytes += humongousSize;
+            } else {
+                live.set(random.nextInt(live.length()), buildGraph());
+                bytes += objectSize;
+            }
+            if (pinPercent > 0 && random.nextInt(100) < pinPercent) {
+                sink += pinAndTouch(new byte[PIN_SIZE], pinPasses);
+                bytes += PIN_SIZE;
+                pins.incrementAndGet();
+            }
+            operations.incrementAndGet();
+        }
+
+        @Override
+        public void run() {
+            long start = System.nanoTime();
+            long reported = 0;
+            while (!done) {
+                operate();
+                if (rate > 0) {
+                    long due = start + (long) (bytes * 1e9 / rate);
+                    long ahead = due - System.nanoTime();
+                    if (ahead > 100_000) {
+                        LockSupport.parkNanos(ahead);
+                    }
+                }
+                if (bytes - reported > 1024 * 1024) {
+                    allocated.addAndGet(bytes - reported);
+                    reported = bytes;
+                }
+            }
+            allocated.addAndGet(bytes - reported);
+        }
+    }
+
+    static final class Distribution {
+        private final double[] millis;
+
+        Distribution(List<Double> values) {
+            millis = values.stream().mapToDouble(Double::doubleValue).sorted().toArray();
+        }
+
+        double stat(String name) {
+            switch (name) {
+                case "count": return millis.length;
+                case "p50":   return percentile(50);
+                case "p90":   return percentile(90);
+                case "p99":   return percentile(99);
+                case "p999":  return percentile(99.9);
+                case "max":   return millis.length == 0 ? 0 : millis[millis.length - 1];
+                default:      throw new IllegalArgumentException(name);
+            }
+        }
+
+        double total() {
+            return Arrays.stream(millis).sum();
+        }
+
+        private double percentile(double p) {
+            if (millis.length == 0) {
+                return 0;
+            }
+            int index = (int) Math.ceil(p / 100 * millis.length) - 1;
+            return millis[Math.max(0, Math.min(index, millis.length - 1))];
+        }
+    }
+
+    private static String vmOption(HotSpotDiagnosticMXBean bean, String name) {
+        try {
+            return bean.getVMOption(name).getValue();
+        } catch (IllegalArgumentException e) {
+            return "";
+        }
+    }
+
+    private static String number(double v) {
+        return v == Math.rint(v) ? Long.toString((long) v) : String.format("%.3f", v);
+    }
+
+    public static void main(String[] args) throws Exception {
+        Worker[] workers = new Worker[threads];
+        for (int i = 0; i < threads; i++) {
+            workers[i] = new Worker(i);
+        }
+
+        // Fill the live set before the clock starts, so that it is at its size throughout
+        for (int i = 0; i < live.length(); i++) {
+            live.set(i, buildGraph());
+        }
+
+        for (Worker w : workers) {
+            w.start();
+        }
+        Thread.sleep(warmup * 1000L);
+
+        Path file = Files.createTempFile("shenandoah-latency", ".jfr");
+        Map<String, List<Double>> samples = new LinkedHashMap<>();
+        long recordedBytes;
+        long recordedOperations;
+        long recordedPins;
+        try (Recording recording = new Recording()) {
+            for (String[] kind : KINDS) {
+                recording.enable(kind[1]).withThreshold(Duration.ZERO).withoutStackTrace();
+                samples.put(kind[0], new ArrayList<>());
+            }
+            long bytes = allocated.get();
+            long ops = operations.get();
+            long pinned = pins.get();
+            recording.start();
+            Thread.sleep(duration * 1000L);
+            recording.stop();
+            recordedBytes = allocated.get() - bytes;
+            recordedOperations = operations.get() - ops;
+            recordedPins = pins.get() - pinned;
+            recording.dump(file);
+        } finally {
+            done = true;
+            for (Worker w : workers) {
+                w.join();
+            }
+        }
+
+        for (RecordedEvent event : RecordingFile.readAllEvents(file)) {
+            String name = event.getEventType().getName();
+            for (String[] kind : KINDS) {
+                if (kind[1].equals(name)) {
+                    samples.get(kind[0]).add(event.getDuration().toNanos() / 1e6);
+                }
+            }
+        }
+        Files.deleteIfExists(file);
+
+        HotSpotDiagnosticMXBean bean = ManagementFactory.getPlatformMXBean(HotSpotDiagnosticMXBean.class);
+        StringBuilder json = new StringBuilder();
+        json.append("{\"benchmark\":\"TestServiceLatency\"");
+        json.append(",\"mode\":\"").append(vmOption(bean, "ShenandoahGCMode")).append('"');
+        json.append(",\"heuristics\":\"").append(vmOption(bean, "ShenandoahGCHeuristics")).append('"');
+        json.append(",\"maxHeap\":").append(Runtime.getRuntime().maxMemory());
+        json.append(",\"config\":{");
+        json.append("\"threads\":").append(threads);
+        json.append(",\"duration\":").append(duration);
+        json.append(",\"allocRate\":").append(allocRate);
+        json.append(",\"liveSet\":").append(liveSet);
+        json.append(",\"objectSize\":").append(objectSize);
+        json.append(",\"shape\":\"").append(shape).append('"');
+        json.append(",\"humongousPercent\":").append(humongousPercent);
+        json.append(",\"humongousSize\":").append(humongousSize);
+        json.append(",\"pinPercent\":").append(pinPercent);
+        json.append(",\"seed\":").append(seed);
+        json.append("}");
+        json.append(",\"allocated\":").append(recordedBytes);
+        json.append(",\"allocRateAchieved\":").append(number(recordedBytes / (double) duration));
+        json.append(",\"operations\":").append(recordedOperations);
+        json.append(",\"pins\":").append(recordedPins);
+
+        List<String> violations = new ArrayList<>();
+        for (String[] kind : KINDS) {
+            Distribution d = new Distribution(samples.get(kind[0]));
+            json.append(",\"").append(kind[0]).append("\":{");
+            for (String stat : STATS) {
+                double value = d.stat(stat);
+                json.append('"').append(stat).append("\":").append(number(value)).append(',');
+                String budget = System.getProperty(PREFIX + "budget." + kind[0] + "." + stat);
+                if (budget != null && value > Double.parseDouble(budget)) {
+                    violations.add(kind[0] + "." + stat + " = " + number(value) + " exceeds budget " + budget);
+                }
+            }
+            json.append("\"total\":").append(number(d.total())).append('}');
+        }
+        json.append(",\"violations\":").append(violations.size());
+        json.append('}');
+
+        System.out.println("RESULT " + json);
+        String output = System.getProperty(PREFIX + "output");
+        if (output != null) {
+            Files.writeString(Paths.get(output), json + System.lineSeparator());
+        }
+
+        if (recordedOperations == 0) {
+            throw new RuntimeException("Workload made no progress while recording");
+        }
+        if (!violations.isEmpty()) {
+            throw new RuntimeException("Latency budgets exceeded: " + String.join(", ", violations));
+        }
+    }
+}
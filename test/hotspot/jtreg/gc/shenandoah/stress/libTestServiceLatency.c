@@ -0,0 +1,43 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include <jni.h>
+
+// Holds the array pinned while making the given number of passes over it.
+JNIEXPORT jlong JNICALL
+Java_TestServiceLatency_pinAndTouch(JNIEnv* env, jclass unused, jbyteArray arr, jint passes) {
+  jsize size = (*env)->GetArrayLength(env, arr);
+  jbyte* p = (*env)->GetPrimitiveArrayCritical(env, arr, NULL);
+  jlong sum = 0;
+  jint pass;
+  jsize i;
+  for (pass = 0; pass < passes; pass++) {
+    for (i = 0; i < size; i++) {
+      p[i] = (jbyte) (p[i] + pass);
+      sum += p[i];
+    }
+  }
+  (*env)->ReleasePrimitiveArrayCritical(env, arr, p, 0);
+  return sum;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package org.openjdk.bench.jdk.jfr;
+
+import jdk.jfr.Event;
+import jdk.jfr.Recording;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+import org.openjdk.jmh.annotations.Threads;
+import org.openjdk.jmh.annotations.Warmup;
+
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Commits of a small event from many threads while a recording is running.
+ * Once a thread's buffer fills up, it is promoted to the global buffers, so
+ * with many threads this measures contention on promotion as well as the
+ * commit path itself.
+ */
+@BenchmarkMode(Mode.Throughput)
+@OutputTimeUnit(TimeUnit.MICROSECONDS)
+@State(Scope.Benchmark)
+@Warmup(iterations = 5, time = 1)
+@Measurement(iterations = 5, time = 1)
+@Fork(value = 3)
+public class EventCommit {
+
+    static class SmallEvent extends Event {
+        long value;
+    }
+
+    private Recording recording;
+
+    @Setup(Level.Trial)
+    public void setup() {
+        recording = new Recording();
+        recording.enable(SmallEvent.class).withoutStackTrace();
+        recording.start();
+    }
+
+    @TearDown(Level.Trial)
+    public void tearDown() {
+        recording.stop();
+        recording.close();
+    }
+
+    @Benchmark
+    @Threads(1)
+    public void commitSingleThread() {
+        commit();
+    }
+
+    @Benchmark
+    @Threads(Threads.MAX)
+    public void commitAllThreads() {
+        commit();
+    }
+
+    private static void commit() {
+        SmallEvent event = new SmallEvent();
+        event.value = 42;
+        event.commit();
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package org.openjdk.bench.vm.compiler;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Warmup;
+
+import java.util.Random;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Nested loops over double[][]. The row load, its null check and the range
+ * checks against the row length are invariant in the inner loop, and loop
+ * predication hoists them, so "a[i][j]" should run as fast as reading a
+ * row hoisted by hand. The variants without predication show the cost of
+ * the per-iteration checks.
+ */
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.MICROSECONDS)
+@State(Scope.Thread)
+@Warmup(iterations = 5, time = 1)
+@Measurement(iterations = 5, time = 1)
+public abstract class MatrixRowChecks {
+    @Param({"64", "512"})
+    public int n;
+
+    private double[][] a;
+    private double[][] b;
+    private double[] x;
+    private double[] y;
+
+    @Setup
+    public void setup() {
+        Random r = new Random(42);
+        a = new double[n][n];
+        b = new double[n][n];
+        x = new double[n];
+        y = new double[n];
+        for (int i = 0; i < n; i++) {
+            x[i] = r.nextDouble();
+            for (int j = 0; j < n; j++) {
+                a[i][j] = r.nextDouble();
+            }
+        }
+    }
+
+    @Benchmark
+    public double[] matVec() {
+        for (int i = 0; i < n; i++) {
+            double s = 0;
+            for (int j = 0; j < n; j++) {
+                s += a[i][j] * x[j];
+            }
+            y[i] = s;
+        }
+        return y;
+    }
+
+    @Benchmark
+    public double[] matVecHoistedRow() {
+        for (int i = 0; i < n; i++) {
+            double[] row = a[i];
+            double s = 0;
+            for (int j = 0; j < n; j++) {
+                s += row[j] * x[j];
+            }
+            y[i] = s;
+        }
+        return y;
+    }
+
+    @Benchmark
+    public double[][] scale() {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                b[i][j] = a[i][j] * 0.5;
+            }
+        }
+        return b;
+    }
+
+    @Fork(value = 1)
+    public static class Default extends MatrixRowChecks {}
+
+    @Fork(value = 1, jvmArgsAppend = {"-XX:-UseLoopPredicate"})
+    public static class NoLoopPredicate extends MatrixRowChecks {}
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package org.openjdk.bench.vm.compiler;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Warmup;
+
+import java.util.Random;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Vectorized reductions whose accumulation is moved out of the loop, with one
+ * or several independent vector accumulators (-XX:SuperWordReductionAccumulators).
+ */
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.NANOSECONDS)
+@State(Scope.Thread)
+@Warmup(iterations = 5, time = 1)
+@Measurement(iterations = 5, time = 1)
+public abstract class ReductionAccumulators {
+    @Param({"1024", "65536"})
+    public int size;
+
+    private int[] ints;
+    private long[] longs;
+
+    @Setup
+    public void setup() {
+        Random r = new Random(42);
+        ints = new int[size];
+        longs = new long[size];
+        for (int i = 0; i < size; i++) {
+            ints[i] = r.nextInt();
+            longs[i] = r.nextLong();
+        }
+    }
+
+    @Benchmark
+    public int intAdd() {
+        int sum = 0;
+        for (int i = 0; i < ints.length; i++) {
+            sum += ints[i];
+        }
+        return sum;
+    }
+
+    @Benchmark
+    public int intXor() {
+        int checksum = 0;
+        for (int i = 0; i < ints.length; i++) {
+            checksum ^= ints[i] * 31;
+        }
+        return checksum;
+    }
+
+    @Benchmark
+    public long longAdd() {
+        long sum = 0;
+        for (int i = 0; i < longs.length; i++) {
+            sum += longs[i];
+        }
+        return sum;
+    }
+
+    @Benchmark
+    public int intMax() {
+        int max = Integer.MIN_VALUE;
+        for (int i = 0; i < ints.length; i++) {
+            max = Math.max(max, ints[i]);
+        }
+        return max;
+    }
+
+    @Fork(value = 1, jvmArgsAppend = {"-XX:SuperWordReductionAccumulators=1"})
+    public static class SingleAccumulator extends ReductionAccumulators {}
+
+    @Fork(value = 1, jvmArgsAppend = {"-XX:SuperWordReductionAccumulators=4"})
+    public static class FourAccumulators extends ReductionAccumulators {}
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package org.openjdk.bench.vm.compiler;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Warmup;
+
+import java.util.Random;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Vectorized loops over short arrays, where the remainder after the main loop
+ * is a large part of the work. With -XX:+PostLoopMultiversioning, CPUs with
+ * predicated vectors run the remainder as one masked vector iteration.
+ */
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.NANOSECONDS)
+@State(Scope.Thread)
+@Warmup(iterations = 5, time = 1)
+@Measurement(iterations = 5, time = 1)
+public abstract class ShortArrayTails {
+    @Param({"17", "63", "100", "199"})
+    public int size;
+
+    private int[] ints;
+    private int[] intResult;
+    private byte[] bytes;
+    private byte[] byteResult;
+
+    @Setup
+    public void setup() {
+        Random r = new Random(42);
+        ints = new int[size];
+        intResult = new int[size];
+        bytes = new byte[size];
+        byteResult = new byte[size];
+        for (int i = 0; i < size; i++) {
+            ints[i] = r.nextInt();
+            bytes[i] = (byte) r.nextInt();
+        }
+    }
+
+    @Benchmark
+    public int[] intScale() {
+        for (int i = 0; i < ints.length; i++) {
+            intResult[i] = ints[i] * 7 + 3;
+        }
+        return intResult;
+    }
+
+    @Benchmark
+    public byte[] byteMask() {
+        for (int i = 0; i < bytes.length; i++) {
+            byteResult[i] = (byte) (bytes[i] & 0x7f);
+        }
+        return byteResult;
+    }
+
+    @Fork(value = 1)
+    public static class ScalarPostLoop extends ShortArrayTails {}
+
+    @Fork(value = 1, jvmArgsAppend = {"-XX:+UnlockExperimentalVMOptions", "-XX:+PostLoopMultiversioning"})
+    public static class MaskedPostLoop extends ShortArrayTails {}
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package org.openjdk.bench.vm.gc.shenandoah;
+
+import org.openjdk.bench.vm.gc.shenandoah.ShenandoahHeapShape.Node;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Warmup;
+
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Cost of allocation: small objects, which mostly exercise TLAB refills, and
+ * arrays up to humongous sizes, which are allocated outside of TLABs. These
+ * allocate enough to drive GC cycles even in the Idle flavor; the Cycling
+ * flavor adds the allocation pacing of back-to-back cycles.
+ */
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.NANOSECONDS)
+@State(Scope.Thread)
+@Warmup(iterations = 5, time = 1)
+@Measurement(iterations = 5, time = 1)
+public abstract class ShenandoahAllocation {
+
+    @State(Scope.Benchmark)
+    public static class ArraySize {
+        // With a 4g heap, regions are 2 MB: the largest size is humongous.
+        @Param({"1024", "65536", "4194304"})
+        int bytes;
+    }
+
+    @Setup
+    public void setup() {
+        ShenandoahHeapShape.retain();
+    }
+
+    @Benchmark
+    public Node allocateObject() {
+        return new Node();
+    }
+
+    @Benchmark
+    public Node allocateObjects() {
+        Node n = null;
+        for (int i = 0; i < 1024; i++) {
+            Node m = new Node();
+            m.next = n;
+            n = m;
+        }
+        return n;
+    }
+
+    @Benchmark
+    public byte[] allocateByteArray(ArraySize size) {
+        return new byte[size.bytes];
+    }
+
+    @Benchmark
+    public Object[] allocateObjectArray(ArraySize size) {
+        return new Object[size.bytes / 8];
+    }
+
+    @Fork(value = 3, jvmArgsAppend = {"-XX:+UseShenandoahGC", "-Xms4g", "-Xmx4g", "-XX:+AlwaysPreTouch"})
+    public static class Idle extends ShenandoahAllocation {
+    }
+
+    // Small fixed TLABs, so that the refill path is taken every few allocations
+    @Fork(value = 3, jvmArgsAppend = {"-XX:+UseShenandoahGC", "-Xms4g", "-Xmx4g", "-XX:+AlwaysPreTouch",
+                                      "-XX:-ResizeTLAB", "-XX:TLABSize=4k"})
+    public static class SmallTLAB extends ShenandoahAllocation {
+    }
+
+    @Fork(value = 3, jvmArgsAppend = {"-XX:+UseShenandoahGC", "-Xms4g", "-Xmx4g", "-XX:+AlwaysPreTouch",
+                                      "-XX:+UnlockDiagnosticVMOptions", "-XX:ShenandoahGCHeuristics=aggressive"})
+    public static class Cycling extends ShenandoahAllocation {
+    }
+
+    @Fork(value = 3, jvmArgsAppend = {"-XX:+UseShenandoahGC", "-Xms4g", "-Xmx4g", "-XX:+AlwaysPreTouch",
+                                      "-XX:+UnlockExperimentalVMOptions", "-XX:ShenandoahGCMode=generational"})
+    public static class Generational extends ShenandoahAllocation {
+    }
+}
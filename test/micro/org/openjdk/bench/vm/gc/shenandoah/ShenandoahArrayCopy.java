@@ -0,0 +1,105 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package org.openjdk.bench.vm.gc.shenandoah;
+
+import org.openjdk.bench.vm.gc.shenandoah.ShenandoahHeapShape.Node;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Warmup;
+
+import java.util.Arrays;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Cost of the arraycopy barriers on reference arrays: the SATB pass over the
+ * destination, the forwarding pass over the source during evacuation, and the
+ * card marking of the destination in the generational flavors.
+ */
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.NANOSECONDS)
+@State(Scope.Thread)
+@Warmup(iterations = 5, time = 1)
+@Measurement(iterations = 5, time = 1)
+public abstract class ShenandoahArrayCopy {
+
+    @Param({"16", "1024", "65536"})
+    int size;
+
+    Object[] src;
+    Object[] dst;
+
+    @Setup
+    public void setup() {
+        ShenandoahHeapShape.retain();
+        src = new Object[size];
+        dst = new Object[size];
+        for (int i = 0; i < size; i++) {
+            src[i] = new Node();
+        }
+    }
+
+    @Benchmark
+    public Object[] arraycopy() {
+        System.arraycopy(src, 0, dst, 0, size);
+        return dst;
+    }
+
+    @Benchmark
+    public Object[] arraycopyOverlapping() {
+        System.arraycopy(dst, 0, dst, 1, size - 1);
+        return dst;
+    }
+
+    @Benchmark
+    public Object[] copyOf() {
+        return Arrays.copyOf(src, size);
+    }
+
+    @Benchmark
+    public Object[] cloneArray() {
+        return src.clone();
+    }
+
+    @Fork(value = 3, jvmArgsAppend = {"-XX:+UseShenandoahGC", "-Xms4g", "-Xmx4g", "-XX:+AlwaysPreTouch"})
+    public static class Idle extends ShenandoahArrayCopy {
+    }
+
+    @Fork(value = 3, jvmArgsAppend = {"-XX:+UseShenandoahGC", "-Xms4g", "-Xmx4g", "-XX:+AlwaysPreTouch",
+                                      "-XX:+UnlockDiagnosticVMOptions", "-XX:ShenandoahGCHeuristics=aggressive"})
+    public static class Cycling extends ShenandoahArrayCopy {
+    }
+
+    @Fork(value = 3, jvmArgsAppend = {"-XX:+UseShenandoahGC", "-Xms4g", "-Xmx4g", "-XX:+AlwaysPreTouch",
+                                      "-XX:+UnlockExperimentalVMOptions", "-XX:ShenandoahGCMode=generational",
+                                      "-XX:+UnlockDiagnosticVMOptions", "-XX:ShenandoahGCHeuristics=aggressive"})
+    public static class GenerationalCycling extends ShenandoahArrayCopy {
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package org.openjdk.bench.vm.gc.shenandoah;
+
+/**
+ * Heap shape shared by the Shenandoah benchmarks.
+ *
+ * Every benchmark comes in an Idle flavor, run with the default heuristics on a heap
+ * large enough that no cycle starts, and a Cycling flavor, run with the aggressive
+ * heuristics that start a new cycle as soon as the previous one completes. In the
+ * latter, barriers alternate between their marking and evacuation states, and the
+ * retained graph below keeps marking busy and gives evacuation something to forward.
+ * Benchmarks of barriers that differ in generational mode also come in Generational
+ * flavors. The flags of each flavor are on the @Fork of its nested class.
+ */
+public final class ShenandoahHeapShape {
+
+    public static final class Node {
+        public Node next;
+        public Object payload;
+    }
+
+    // About 250 MB of live objects, so that marking takes a while
+    private static final int RETAINED_NODES = 4 * 1024 * 1024;
+
+    private static Node[] retained;
+
+    /**
+     * Builds the retained graph once per fork.
+     */
+    public static synchronized void retain() {
+        if (retained != null) {
+            return;
+        }
+        Node[] nodes = new Node[RETAINED_NODES];
+        for (int i = 0; i < nodes.length; i++) {
+            nodes[i] = new Node();
+            nodes[i].payload = new long[2];
+        }
+        for (int i = 0; i < nodes.length; i++) {
+            nodes[i].next = nodes[(int) ((i * 2654435761L) % nodes.length)];
+        }
+        retained = nodes;
+    }
+
+    private ShenandoahHeapShape() {
+    }
+}
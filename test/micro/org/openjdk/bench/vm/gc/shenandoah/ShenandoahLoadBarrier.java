@@ -0,0 +1,125 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package org.openjdk.bench.vm.gc.shenandoah;
+
+import org.openjdk.bench.vm.gc.shenandoah.ShenandoahHeapShape.Node;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Warmup;
+import org.openjdk.jmh.infra.Blackhole;
+
+import java.lang.ref.SoftReference;
+import java.lang.ref.WeakReference;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Cost of the load reference barrier on field and array loads, and of the
+ * reference barriers on Reference.get.
+ */
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.NANOSECONDS)
+@State(Scope.Thread)
+@Warmup(iterations = 5, time = 1)
+@Measurement(iterations = 5, time = 1)
+public abstract class ShenandoahLoadBarrier {
+
+    static final int SIZE = 1024;
+
+    Node head;
+    Node[] nodes;
+    WeakReference<Object>[] weak;
+    SoftReference<Object>[] soft;
+
+    @Setup
+    @SuppressWarnings("unchecked")
+    public void setup() {
+        ShenandoahHeapShape.retain();
+        nodes = new Node[SIZE];
+        weak = new WeakReference[SIZE];
+        soft = new SoftReference[SIZE];
+        for (int i = 0; i < SIZE; i++) {
+            nodes[i] = new Node();
+            nodes[i].payload = new Object();
+            weak[i] = new WeakReference<>(nodes[i].payload);
+            soft[i] = new SoftReference<>(nodes[i].payload);
+        }
+        for (int i = 0; i < SIZE; i++) {
+            nodes[i].next = nodes[(i + 1) % SIZE];
+        }
+        head = nodes[0];
+    }
+
+    @Benchmark
+    public Node chaseFields() {
+        Node n = head;
+        for (int i = 0; i < SIZE; i++) {
+            n = n.next;
+        }
+        return n;
+    }
+
+    @Benchmark
+    public void loadFields(Blackhole bh) {
+        for (Node n : nodes) {
+            bh.consume(n.payload);
+        }
+    }
+
+    @Benchmark
+    public void loadArrayElements(Blackhole bh) {
+        Node[] a = nodes;
+        for (int i = 0; i < a.length; i++) {
+            bh.consume(a[i]);
+        }
+    }
+
+    @Benchmark
+    public void weakReferenceGet(Blackhole bh) {
+        for (WeakReference<Object> r : weak) {
+            bh.consume(r.get());
+        }
+    }
+
+    @Benchmark
+    public void softReferenceGet(Blackhole bh) {
+        for (SoftReference<Object> r : soft) {
+            bh.consume(r.get());
+        }
+    }
+
+    @Fork(value = 3, jvmArgsAppend = {"-XX:+UseShenandoahGC", "-Xms4g", "-Xmx4g", "-XX:+AlwaysPreTouch"})
+    public static class Idle extends ShenandoahLoadBarrier {
+    }
+
+    @Fork(value = 3, jvmArgsAppend = {"-XX:+UseShenandoahGC", "-Xms4g", "-Xmx4g", "-XX:+AlwaysPreTouch",
+                                      "-XX:+UnlockDiagnosticVMOptions", "-XX:ShenandoahGCHeuristics=aggressive"})
+    public static class Cycling extends ShenandoahLoadBarrier {
+    }
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright Amazon.com Inc. or its affiliates. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package org.openjdk.bench.vm.gc.shenandoah;
+
+import org.openjdk.bench.vm.gc.shenandoah.ShenandoahHeapShape.Node;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.Warmup;
+
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Cost of the SATB pre-write barrier on reference stores and, in the
+ * generational flavors, of the card marking post-write barrier.
+ *
+ * The nodes are allocated during setup, so in the generational flavors they
+ * are promoted to the old generation once a few young cycles have run. Stores
+ * into them then take the card barrier for young values.
+ */
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.NANOSECONDS)
+@State(Scope.Thread)
+@Warmup(iterations = 5, time = 1)
+@Measurement(iterations = 5, time = 1)
+public abstract class ShenandoahStoreBarrier {
+
+    static final int SIZE = 1024;
+
+    Node[] nodes;
+    Object[] values;
+
+    @Setup
+    public void setup() {
+        ShenandoahHeapShape.retain();
+        nodes = new Node[SIZE];
+        values = new Object[SIZE];
+        for (int i = 0; i < SIZE; i++) {
+            nodes[i] = new Node();
+            values[i] = new Object();
+        }
+    }
+
+    @Benchmark
+    public void storeFields() {
+        Node[] n = nodes;
+        Object[] v = values;
+        for (int i = 0; i < SIZE; i++) {
+            n[i].payload = v[(i + 1) & (SIZE - 1)];
+        }
+    }
+
+    @Benchmark
+    public void storeNullFields() {
+        for (Node n : nodes) {
+            n.payload = null;
+        }
+    }
+
+    @Benchmark
+    public void storeArrayElements() {
+        Object[] v = values;
+        for (int i = 0; i < SIZE; i++) {
+            v[i] = v[(i + 1) & (SIZE - 1)];
+        }
+    }
+
+    @Benchmark
+    public Node storeNewObjects() {
+        Node[] n = nodes;
+        for (int i = 0; i < SIZE; i++) {
+            n[i].next = new Node();
+        }
+        return n[0];
+    }
+
+    @Fork(value = 3, jvmArgsAppend = {"-XX:+UseShenandoahGC", "-Xms4g", "-Xmx4g", "-XX:+AlwaysPreTouch"})
+    public static class Idle extends ShenandoahStoreBarrier {
+    }
+
+    @Fork(value = 3, jvmArgsAppend = {"-XX:+UseShenandoahGC", "-Xms4g", "-Xmx4g", "-XX:+AlwaysPreTouch",
+                                      "-XX:+UnlockDiagnosticVMOptions", "-XX:ShenandoahGCHeuristics=aggressive"})
+    public static class Cycling extends ShenandoahStoreBarrier {
+    }
+
+    @Fork(value = 3, jvmArgsAppend = {"-XX:+UseShenandoahGC", "-Xms4g", "-Xmx4g", "-XX:+AlwaysPreTouch",
+                                      "-XX:+UnlockExperimentalVMOptions", "-XX:ShenandoahGCMode=generational"})
+    public static class GenerationalIdle extends ShenandoahStoreBarrier {
+    }
+
+    @Fork(value = 3, jvmArgsAppend = {"-XX:+UseShenandoahGC", "-Xms4g", "-Xmx4g", "-XX:+AlwaysPreTouch",
+                                      "-XX:+UnlockExperimentalVMOptions", "-XX:ShenandoahGCMode=generational",
+                                      "-XX:+UnlockDiagnosticVMOptions", "-XX:ShenandoahGCHeuristics=aggressive"})
+    public static class GenerationalCycling extends ShenandoahStoreBarrier {
+    }
+}